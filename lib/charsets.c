@@ -69,6 +69,15 @@ typedef struct
 
 static const char NO_TRANSLATION[] = N_ ("No translation");
 
+/* Converters kept open between calls: the conversion functions below run once
+ * per displayed file name, and an iconv open/close pair per call dominates the
+ * conversion itself. They are re-created whenever the codepage pair changes
+ * (init_translation_table) or when the cached codepage id goes stale. */
+static GIConv cached_conv_display = INVALID_CONV;    // cp_source -> display
+static GIConv cached_conv_input = INVALID_CONV;      // display -> cp_source
+static GIConv cached_conv_source = INVALID_CONV;     // conversions involving source_codepage
+static const char *cached_conv_source_id = NULL;     // codepage id cached_conv_source was made for
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -183,6 +192,37 @@ fail:
     fclose (f);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Drop the cached converters; they are re-created on the next use */
+
+static void
+flush_conv_cache (void)
+{
+    str_close_conv (cached_conv_display);
+    cached_conv_display = INVALID_CONV;
+    str_close_conv (cached_conv_input);
+    cached_conv_input = INVALID_CONV;
+    str_close_conv (cached_conv_source);
+    cached_conv_source = INVALID_CONV;
+    cached_conv_source_id = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Converter from the terminal codeset to the given codepage, cached between calls */
+
+static GIConv
+get_conv_to_codepage (const char *cp_id)
+{
+    if (cached_conv_source == INVALID_CONV || cached_conv_source_id != cp_id)
+    {
+        str_close_conv (cached_conv_source);
+        cached_conv_source = str_crt_conv_to (cp_id);
+        cached_conv_source_id = cp_id;
+    }
+
+    return cached_conv_source;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static char
@@ -235,6 +275,9 @@ load_codepages_list (void)
 void
 free_codepages_list (void)
 {
+    // cached_conv_source_id points into the list
+    flush_conv_cache ();
+
     g_ptr_array_free (codepages, TRUE);
     // NULL-ize pointer to make unit tests happy
     codepages = NULL;
@@ -302,6 +345,9 @@ init_translation_table (int cpsource, int cpdisplay)
     int i;
     GIConv cd;
 
+    // the codepage pair is about to change
+    flush_conv_cache ();
+
     // Fill input <-> display tables
 
     if (cpsource < 0 || cpdisplay < 0 || cpsource == cpdisplay)
@@ -359,7 +405,6 @@ GString *
 str_nconvert_to_display (const char *str, int len)
 {
     GString *buff;
-    GIConv conv;
 
     if (str == NULL)
         return NULL;
@@ -367,13 +412,13 @@ str_nconvert_to_display (const char *str, int len)
     if (cp_display == cp_source)
         return g_string_new (str);
 
-    conv = str_crt_conv_from (cp_source);
-    if (conv == INVALID_CONV)
+    if (cached_conv_display == INVALID_CONV)
+        cached_conv_display = str_crt_conv_from (cp_source);
+    if (cached_conv_display == INVALID_CONV)
         return g_string_new (str);
 
     buff = g_string_new ("");
-    str_nconvert (conv, str, len, buff);
-    str_close_conv (conv);
+    str_nconvert (cached_conv_display, str, len, buff);
     return buff;
 }
 
@@ -383,7 +428,6 @@ GString *
 str_nconvert_to_input (const char *str, int len)
 {
     GString *buff;
-    GIConv conv;
 
     if (str == NULL)
         return NULL;
@@ -391,13 +435,13 @@ str_nconvert_to_input (const char *str, int len)
     if (cp_display == cp_source)
         return g_string_new (str);
 
-    conv = str_crt_conv_to (cp_source);
-    if (conv == INVALID_CONV)
+    if (cached_conv_input == INVALID_CONV)
+        cached_conv_input = str_crt_conv_to (cp_source);
+    if (cached_conv_input == INVALID_CONV)
         return g_string_new (str);
 
     buff = g_string_new ("");
-    str_nconvert (conv, str, len, buff);
-    str_close_conv (conv);
+    str_nconvert (cached_conv_input, str, len, buff);
     return buff;
 }
 
@@ -415,7 +459,7 @@ convert_from_utf_to_current (const char *str)
         return '.';
 
     cp_to = get_codepage_id (mc_global.source_codepage);
-    conv = str_crt_conv_to (cp_to);
+    conv = get_conv_to_codepage (cp_to);
 
     if (conv != INVALID_CONV)
     {
@@ -431,7 +475,6 @@ convert_from_utf_to_current (const char *str)
         default:
             break;
         }
-        str_close_conv (conv);
     }
 
     return ch;
@@ -512,12 +555,9 @@ convert_from_8bit_to_utf_c2 (char input_char)
 
     cp_from = get_codepage_id (mc_global.source_codepage);
 
-    conv = str_crt_conv_to (cp_from);
+    conv = get_conv_to_codepage (cp_from);
     if (conv != INVALID_CONV)
-    {
         ch = convert_from_8bit_to_utf_c (input_char, conv);
-        str_close_conv (conv);
-    }
 
     return ch;
 }
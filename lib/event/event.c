@@ -42,6 +42,8 @@
 
 GTree *mc_event_grouplist = NULL;
 
+guint mc_event_generation = 0;
+
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
@@ -85,6 +87,7 @@ mc_event_deinit (GError **mcerror)
 
     g_tree_destroy (mc_event_grouplist);
     mc_event_grouplist = NULL;
+    mc_event_generation++;
     return TRUE;
 }
 
@@ -17,6 +17,10 @@ typedef struct mc_event_callback_struct
 
 extern GTree *mc_event_grouplist;
 
+/* Bumped whenever callback arrays may have been freed; invalidates the
+ * lookup memo in mc_event_raise() */
+extern guint mc_event_generation;
+
 /*** declarations of public functions **********************************/
 
 GTree *mc_event_get_event_group_by_name (const gchar *event_group_name, gboolean create_new,
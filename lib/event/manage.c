@@ -131,6 +131,7 @@ mc_event_destroy (const gchar *event_group_name, const gchar *event_name)
 
     event_group = mc_event_get_event_group_by_name (event_group_name, FALSE, NULL);
     g_tree_remove (event_group, (gconstpointer) event_name);
+    mc_event_generation++;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -140,7 +141,10 @@ mc_event_group_del (const gchar *event_group_name)
 {
 
     if (mc_event_grouplist != NULL && event_group_name != NULL)
+    {
         g_tree_remove (mc_event_grouplist, (gconstpointer) event_group_name);
+        mc_event_generation++;
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
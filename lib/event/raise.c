@@ -39,6 +39,16 @@
 
 /*** file scope variables ************************************************************************/
 
+/* One-slot lookup memo: dispatch is dominated by a handful of hot events
+ * (vfs_timestamp and friends) raised over and over, so remember which callback
+ * array the last name pair resolved to instead of walking both name trees
+ * every time. The memo is dropped when mc_event_generation changes, i.e. when
+ * callback arrays may have been freed. */
+static guint cached_generation = 0;
+static gchar *cached_group_name = NULL;
+static gchar *cached_event_name = NULL;
+static GPtrArray *cached_callbacks = NULL;
+
 /*** file scope functions ************************************************************************/
 
 /* --------------------------------------------------------------------------------------------- */
@@ -55,13 +65,27 @@ mc_event_raise (const gchar *event_group_name, const gchar *event_name, gpointer
     if (mc_event_grouplist == NULL || event_group_name == NULL || event_name == NULL)
         return FALSE;
 
-    event_group = mc_event_get_event_group_by_name (event_group_name, FALSE, NULL);
-    if (event_group == NULL)
-        return FALSE;
-
-    callbacks = mc_event_get_event_by_name (event_group, event_name, FALSE, NULL);
-    if (callbacks == NULL)
-        return FALSE;
+    if (cached_callbacks != NULL && cached_generation == mc_event_generation
+        && g_ascii_strcasecmp (cached_group_name, event_group_name) == 0
+        && g_ascii_strcasecmp (cached_event_name, event_name) == 0)
+        callbacks = cached_callbacks;
+    else
+    {
+        event_group = mc_event_get_event_group_by_name (event_group_name, FALSE, NULL);
+        if (event_group == NULL)
+            return FALSE;
+
+        callbacks = mc_event_get_event_by_name (event_group, event_name, FALSE, NULL);
+        if (callbacks == NULL)
+            return FALSE;
+
+        g_free (cached_group_name);
+        g_free (cached_event_name);
+        cached_group_name = g_strdup (event_group_name);
+        cached_event_name = g_strdup (event_name);
+        cached_callbacks = callbacks;
+        cached_generation = mc_event_generation;
+    }
 
     for (array_index = callbacks->len; array_index > 0; array_index--)
     {
@@ -27,6 +27,22 @@ typedef struct
     char *name_sort_key;
     // Key used for comparing extensions
     char *extension_sort_key;
+    // Length of fname without the file suffix, memoized for version sort;
+    // negative = not computed yet
+    ssize_t vers_prefixlen;
+
+    // File highlighting color memoized by mc_fhl_get_color();
+    // valid while fhl_serial matches the serial of the rule set, 0 = not computed
+    int fhl_color;
+    guint fhl_serial;
+
+    // Size column string memoized by the panel formatter; valid while the entry
+    // size, the column width and the SI/IEC base it was built with still match.
+    // size_str[0] == '\0' = not computed
+    char size_str[24];
+    uintmax_t size_str_size;     // st_size the string was formatted from
+    unsigned char size_str_len;  // column width it was formatted for
+    unsigned char size_str_si;   // non-zero = powers of 1000 were used
 
     // Flags
     struct
@@ -35,6 +51,10 @@ typedef struct
         unsigned int link_to_dir : 1;        // If this is a link, does it point to directory?
         unsigned int stale_link : 1;         // If this is a symlink and points to Charon's land
         unsigned int dir_size_computed : 1;  // Size of directory was computed with dirsizes_cmd
+        unsigned int fname_in_arena : 1;     // fname lives in the dir_list name arena,
+                                             // don't g_string_free() it individually
+        unsigned int filter_match : 1;       // cached panel filter verdict; valid while
+                                             // dir_list.verdict_filter names the filter
     } f;
 } file_entry_t;
 
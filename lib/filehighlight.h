@@ -14,6 +14,8 @@ typedef struct mc_fhl_struct
 {
     mc_config_t *config;
     GPtrArray *filters;
+    guint serial;  // bumped whenever the rule set changes; invalidates colors
+                   // cached in file_entry_t
 } mc_fhl_t;
 
 /*** global variables defined in .c file *********************************************************/
@@ -23,7 +25,7 @@ typedef struct mc_fhl_struct
 mc_fhl_t *mc_fhl_new (gboolean need_auto_fill);
 void mc_fhl_free (mc_fhl_t **fhl);
 
-int mc_fhl_get_color (const mc_fhl_t *fhl, const file_entry_t *fe);
+int mc_fhl_get_color (const mc_fhl_t *fhl, file_entry_t *fe);
 
 gboolean mc_fhl_read_ini_file (mc_fhl_t *fhl, const gchar *filename);
 gboolean mc_fhl_parse_ini_file (mc_fhl_t *fhl);
@@ -83,6 +83,9 @@ mc_fhl_new (gboolean need_auto_fill)
     if (fhl == NULL)
         return NULL;
 
+    // start at a non-zero serial: zero marks "no cached color" in file_entry_t
+    fhl->serial = 1;
+
     if (!need_auto_fill)
         return fhl;
 
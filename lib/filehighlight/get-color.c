@@ -276,14 +276,19 @@ mc_fhl_get_color_regexp (const mc_fhl_filter_t *mc_filter, const mc_fhl_t *fhl,
 /* --------------------------------------------------------------------------------------------- */
 
 int
-mc_fhl_get_color (const mc_fhl_t *fhl, const file_entry_t *fe)
+mc_fhl_get_color (const mc_fhl_t *fhl, file_entry_t *fe)
 {
     guint i;
     int ret;
+    int color = NORMAL_COLOR;
 
     if (fhl == NULL)
         return NORMAL_COLOR;
 
+    // the rule walk ran for this entry already and the rules haven't changed since
+    if (fe->fhl_serial == fhl->serial)
+        return fe->fhl_color;
+
     for (i = 0; i < fhl->filters->len; i++)
     {
         mc_fhl_filter_t *mc_filter;
@@ -294,19 +299,30 @@ mc_fhl_get_color (const mc_fhl_t *fhl, const file_entry_t *fe)
         case MC_FLHGH_T_FTYPE:
             ret = mc_fhl_get_color_filetype (mc_filter, fhl, fe);
             if (ret > 0)
-                return -ret;
+            {
+                color = -ret;
+                goto done;
+            }
             break;
         case MC_FLHGH_T_EXT:
         case MC_FLHGH_T_FREGEXP:
             ret = mc_fhl_get_color_regexp (mc_filter, fhl, fe);
             if (ret > 0)
-                return -ret;
+            {
+                color = -ret;
+                goto done;
+            }
             break;
         default:
             break;
         }
     }
-    return NORMAL_COLOR;
+
+done:
+    fe->fhl_color = color;
+    fe->fhl_serial = fhl->serial;
+
+    return color;
 }
 
 /* --------------------------------------------------------------------------------------------- */
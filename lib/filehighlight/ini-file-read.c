@@ -237,6 +237,11 @@ mc_fhl_parse_ini_file (mc_fhl_t *fhl)
     mc_fhl_array_free (fhl);
     fhl->filters = g_ptr_array_new_with_free_func (mc_fhl_filter_free);
 
+    // invalidate colors memoized from the previous rule set
+    fhl->serial++;
+    if (fhl->serial == 0)
+        fhl->serial = 1;
+
     orig_group_names = mc_config_get_groups (fhl->config, NULL);
     ok = (*orig_group_names != NULL);
 
@@ -245,6 +245,10 @@ static name_keymap_t command_names[] = {
     ADD_KEYMAP_NAME (SortByMTime),
     ADD_KEYMAP_NAME (CdParentSmart),
     ADD_KEYMAP_NAME (CycleListingFormat),
+    ADD_KEYMAP_NAME (PanelTabNew),
+    ADD_KEYMAP_NAME (PanelTabClose),
+    ADD_KEYMAP_NAME (PanelTabNext),
+    ADD_KEYMAP_NAME (PanelTabPrev),
 
     // dialog
     ADD_KEYMAP_NAME (Ok),
@@ -360,6 +364,8 @@ static name_keymap_t command_names[] = {
     ADD_KEYMAP_NAME (SearchForwardContinue),
     ADD_KEYMAP_NAME (SearchBackwardContinue),
     ADD_KEYMAP_NAME (SearchOppositeContinue),
+    ADD_KEYMAP_NAME (Stats),
+    ADD_KEYMAP_NAME (Follow),
 
 #ifdef USE_DIFF_VIEW
     // diff viewer
@@ -381,6 +387,11 @@ static name_keymap_t command_names[] = {
 
 static const size_t num_command_names = G_N_ELEMENTS (command_names) - 1;
 
+/* Lazily built lookup tables: keymap address -> (key -> command).
+ * The keymaps are filled once at startup and stay put until keymap_free() at exit,
+ * so the array address is a stable identity for the cache. */
+static GHashTable *keymap_command_caches = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -411,6 +422,36 @@ sort_command_names (void)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static GHashTable *
+keybind_get_command_cache (const global_keymap_t *keymap)
+{
+    GHashTable *cache;
+
+    if (keymap_command_caches == NULL)
+        keymap_command_caches = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                                       (GDestroyNotify) g_hash_table_destroy);
+
+    cache = g_hash_table_lookup (keymap_command_caches, keymap);
+    if (cache == NULL)
+    {
+        size_t i;
+
+        cache = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+        for (i = 0; keymap[i].key != 0; i++)
+            // as in the former linear scan, the first binding of a key wins
+            if (g_hash_table_lookup (cache, GSIZE_TO_POINTER ((gsize) keymap[i].key)) == NULL)
+                g_hash_table_insert (cache, GSIZE_TO_POINTER ((gsize) keymap[i].key),
+                                     GSIZE_TO_POINTER ((gsize) keymap[i].command));
+
+        g_hash_table_insert (keymap_command_caches, (gpointer) keymap, cache);
+    }
+
+    return cache;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 keymap_add (GArray *keymap, long key, long cmd, const char *caption)
 {
@@ -491,16 +532,28 @@ keybind_lookup_keymap_shortcut (const global_keymap_t *keymap, long action)
 long
 keybind_lookup_keymap_command (const global_keymap_t *keymap, long key)
 {
-    if (keymap != NULL)
-    {
-        size_t i;
+    gpointer command;
 
-        for (i = 0; keymap[i].key != 0; i++)
-            if (keymap[i].key == key)
-                return keymap[i].command;
-    }
+    if (keymap == NULL)
+        return CK_IgnoreKey;
 
-    return CK_IgnoreKey;
+    // an absent key yields NULL, which is CK_IgnoreKey; keymap_add() never stores that command
+    command = g_hash_table_lookup (keybind_get_command_cache (keymap),
+                                   GSIZE_TO_POINTER ((gsize) key));
+
+    return (long) GPOINTER_TO_SIZE (command);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+keybind_free_command_caches (void)
+{
+    if (keymap_command_caches != NULL)
+    {
+        g_hash_table_destroy (keymap_command_caches);
+        keymap_command_caches = NULL;
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -211,6 +211,10 @@ enum
     CK_ScrollHome,
     CK_ScrollEnd,
     CK_CycleListingFormat,
+    CK_PanelTabNew,
+    CK_PanelTabClose,
+    CK_PanelTabNext,
+    CK_PanelTabPrev,
 
     // dialog
     CK_Ok = 300L,
@@ -329,6 +333,8 @@ enum
     CK_SearchForwardContinue,
     CK_SearchBackwardContinue,
     CK_SearchOppositeContinue,
+    CK_Stats,
+    CK_Follow,
 
     // diff viewer
     CK_ShowSymbols = 700L,
@@ -363,6 +369,8 @@ long keybind_lookup_action (const char *name);
 const char *keybind_lookup_actionname (long action);
 const char *keybind_lookup_keymap_shortcut (const global_keymap_t *keymap, long action);
 long keybind_lookup_keymap_command (const global_keymap_t *keymap, long key);
+/* Drop the per-keymap lookup tables; call before the keymaps themselves are freed */
+void keybind_free_command_caches (void);
 
 /*** inline functions ****************************************************************************/
 
@@ -97,6 +97,12 @@ vfs_path_t *mc_config_get_full_vpath (const char *config_name);
 /* mcconfig/history.h */
 
 /* read history to the mc_config, but don't save config to file */
+mc_config_t *mc_config_history_open (void);
+
+void mc_config_history_flush (void);
+
+void mc_config_history_deinit (void);
+
 GList *mc_config_history_get (const char *name);
 /* read recent item from the history */
 char *mc_config_history_get_recent_item (const char *name);
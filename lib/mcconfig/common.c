@@ -123,11 +123,11 @@ mc_config_init (const gchar *ini_path, gboolean read_only)
     if (ini_path == NULL)
         return mc_config;
 
-    if (exist_file (ini_path))
     {
         vfs_path_t *vpath;
 
         vpath = vfs_path_from_str (ini_path);
+        // one stat answers both "does it exist" and "is it worth parsing"
         if (mc_stat (vpath, &st) == 0 && st.st_size != 0)
         {
             GKeyFileFlags flags = G_KEY_FILE_NONE;
@@ -89,7 +89,12 @@ gchar *
 mc_config_get_string (mc_config_t *mc_config, const gchar *group, const gchar *param,
                       const gchar *def)
 {
-    GIConv conv;
+    /* Conversion to the terminal encoding, kept open between calls: config reads come in
+     * batches (setup load, panel setup) and an iconv open/close pair per read is pure overhead.
+     * The terminal encoding is fixed at startup (str_init_strings), so the descriptor never
+     * goes stale. */
+    static GIConv conv = INVALID_CONV;
+
     GString *buffer;
     gchar *ret;
     estr_t conv_res;
@@ -99,13 +104,13 @@ mc_config_get_string (mc_config_t *mc_config, const gchar *group, const gchar *p
     if (mc_global.utf8_display)
         return ret;
 
-    conv = str_crt_conv_from ("UTF-8");
+    if (conv == INVALID_CONV)
+        conv = str_crt_conv_from ("UTF-8");
     if (conv == INVALID_CONV)
         return ret;
 
     buffer = g_string_new ("");
     conv_res = str_convert (conv, ret, buffer);
-    str_close_conv (conv);
 
     if (conv_res == ESTR_FAILURE)
     {
@@ -41,7 +41,8 @@
 
 #include "lib/fileloc.h"  // MC_HISTORY_FILE
 #include "lib/strutil.h"
-#include "lib/util.h"  // list_append_unique
+#include "lib/util.h"      // list_append_unique
+#include "lib/vfs/vfs.h"  // mc_stat
 
 #include "lib/mcconfig.h"
 
@@ -56,6 +57,11 @@ int num_history_items_recorded = 60;
 
 /*** file scope variables ************************************************************************/
 
+/* The parsed history file is cached between calls: every dialog reads the histories on open and
+ * writes them back on close, and re-parsing a possibly large file each time is a visible hitch. */
+static mc_config_t *history_cfg = NULL;
+static struct stat history_cfg_st;  // the file's stat when it was parsed
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -64,6 +70,84 @@ int num_history_items_recorded = 60;
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Get the parsed ${XDG_DATA_HOME}/mc/history file.
+ *
+ * The returned object is owned by this module and stays valid until the next call: don't
+ * deinit it. It is re-read from disk only when the file changes (e.g. written by another
+ * mc instance).
+ */
+
+mc_config_t *
+mc_config_history_open (void)
+{
+    char *profile;
+    vfs_path_t *vpath;
+    struct stat st;
+    gboolean exists;
+
+    profile = mc_config_get_full_path (MC_HISTORY_FILE);
+    vpath = vfs_path_from_str (profile);
+    exists = (mc_stat (vpath, &st) == 0);
+
+    // the (device, inode, mtime, size) quadruple is a good enough change detector
+    if (history_cfg == NULL || !exists || st.st_dev != history_cfg_st.st_dev
+        || st.st_ino != history_cfg_st.st_ino || st.st_mtime != history_cfg_st.st_mtime
+        || st.st_size != history_cfg_st.st_size)
+    {
+        mc_config_deinit (history_cfg);
+        history_cfg = mc_config_init (profile, FALSE);
+
+        if (exists)
+            history_cfg_st = st;
+        else
+            memset (&history_cfg_st, 0, sizeof (history_cfg_st));
+    }
+
+    vfs_path_free (vpath, TRUE);
+    g_free (profile);
+
+    return history_cfg;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Write the cached history config back to its file and keep the cache valid for the
+ * new contents.
+ */
+
+void
+mc_config_history_flush (void)
+{
+    vfs_path_t *vpath;
+
+    if (history_cfg == NULL)
+        return;
+
+    mc_config_save_file (history_cfg, NULL);
+
+    // remember the stat of what we've just written so the cache isn't invalidated by our own save
+    vpath = vfs_path_from_str (history_cfg->ini_path);
+    if (mc_stat (vpath, &history_cfg_st) != 0)
+        memset (&history_cfg_st, 0, sizeof (history_cfg_st));
+    vfs_path_free (vpath, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_config_history_deinit (void)
+{
+    if (history_cfg != NULL)
+    {
+        mc_config_deinit (history_cfg);
+        history_cfg = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /**
  * Load the history from the ${XDG_DATA_HOME}/mc/history file.
  * It is called with the widgets history name and returns the GList list.
@@ -72,24 +156,12 @@ int num_history_items_recorded = 60;
 GList *
 mc_config_history_get (const char *name)
 {
-    GList *hist = NULL;
-    char *profile;
-    mc_config_t *cfg;
-
     if (num_history_items_recorded == 0)  // this is how to disable
         return NULL;
     if (name == NULL || *name == '\0')
         return NULL;
 
-    profile = mc_config_get_full_path (MC_HISTORY_FILE);
-    cfg = mc_config_init (profile, TRUE);
-
-    hist = mc_config_history_load (cfg, name);
-
-    mc_config_deinit (cfg);
-    g_free (profile);
-
-    return hist;
+    return mc_config_history_load (mc_config_history_open (), name);
 }
 
 /* --------------------------------------------------------------------------------------------- */
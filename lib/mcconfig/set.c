@@ -44,21 +44,23 @@
 static gchar *
 mc_config_normalize_before_save (const gchar *value)
 {
-    GIConv conv;
+    // see the note on the cached converter in mc_config_get_string()
+    static GIConv conv = INVALID_CONV;
+
     GString *buffer;
     gboolean ok;
 
     if (mc_global.utf8_display)
         return g_strdup (value);
 
-    conv = str_crt_conv_to ("UTF-8");
+    if (conv == INVALID_CONV)
+        conv = str_crt_conv_to ("UTF-8");
     if (conv == INVALID_CONV)
         return g_strdup (value);
 
     buffer = g_string_new ("");
 
     ok = (str_convert (conv, value, buffer) != ESTR_FAILURE);
-    str_close_conv (conv);
 
     if (!ok)
     {
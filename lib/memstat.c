@@ -0,0 +1,92 @@
+/*
+   Per-subsystem allocation accounting.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file memstat.c
+ *  \brief Source: per-subsystem allocation accounting
+ */
+
+#include <config.h>
+
+#include "lib/global.h"
+
+#include "memstat.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+static mc_memstat_t memstats[MC_MEMSTAT_MAX];
+
+static const char *const memstat_names[MC_MEMSTAT_MAX] = { "panel", "editor", "viewer" };
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_memstat_alloc (mc_memstat_subsystem_t subsystem, guint64 bytes)
+{
+    mc_memstat_t *ms = &memstats[subsystem];
+
+    ms->current += bytes;
+    if (ms->current > ms->peak)
+        ms->peak = ms->current;
+    ms->allocs++;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_memstat_free (mc_memstat_subsystem_t subsystem, guint64 bytes)
+{
+    mc_memstat_t *ms = &memstats[subsystem];
+
+    ms->current -= MIN (ms->current, bytes);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+const mc_memstat_t *
+mc_memstat_get (mc_memstat_subsystem_t subsystem)
+{
+    return &memstats[subsystem];
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+const char *
+mc_memstat_name (mc_memstat_subsystem_t subsystem)
+{
+    return memstat_names[subsystem];
+}
+
+/* --------------------------------------------------------------------------------------------- */
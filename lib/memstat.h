@@ -0,0 +1,49 @@
+/** \file memstat.h
+ *  \brief Header: per-subsystem allocation accounting
+ */
+
+#ifndef MC_MEMSTAT_H
+#define MC_MEMSTAT_H
+
+/*
+   Coarse allocation accounting for the subsystems that hold the big buffers:
+   the panel name arenas, the editor page buffers and the viewer growing
+   buffer.  Allocations are recorded explicitly at the few places those blocks
+   are created and released, so the counters cost two additions per block and
+   can stay always-on.  The Core/memory_report event turns them into a
+   diagnostics dialog.
+ */
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+typedef enum
+{
+    MC_MEMSTAT_PANEL = 0,
+    MC_MEMSTAT_EDITOR,
+    MC_MEMSTAT_VIEWER,
+    MC_MEMSTAT_MAX
+} mc_memstat_subsystem_t;
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct
+{
+    guint64 current;  // bytes currently held
+    guint64 peak;     // highest value of current so far
+    guint64 allocs;   // number of blocks accounted since start
+} mc_memstat_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+void mc_memstat_alloc (mc_memstat_subsystem_t subsystem, guint64 bytes);
+void mc_memstat_free (mc_memstat_subsystem_t subsystem, guint64 bytes);
+const mc_memstat_t *mc_memstat_get (mc_memstat_subsystem_t subsystem);
+const char *mc_memstat_name (mc_memstat_subsystem_t subsystem);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -27,7 +27,9 @@ typedef enum
     MC_SEARCH_E_REGEX,
     MC_SEARCH_E_REGEX_REPLACE,
     MC_SEARCH_E_NOTFOUND,
-    MC_SEARCH_E_ABORT
+    MC_SEARCH_E_ABORT,
+    // mc_search_run_partial () exhausted its slice; call it again to continue
+    MC_SEARCH_E_CONTINUE
 } mc_search_error_t;
 
 typedef enum
@@ -81,6 +83,9 @@ typedef struct mc_search_struct
     // search entire string (from begin to end). Used only with GLOB search type
     gboolean is_entire_line;
 
+    // byte budget of one mc_search_run_partial () slice; 0 means no limit
+    off_t run_limit;
+
     // function, used for getting data. NULL if not used
     mc_search_fn search_fn;
 
@@ -95,6 +100,9 @@ typedef struct mc_search_struct
     // some data for normal
     off_t normal_offset;
 
+    // where an exhausted mc_search_run_partial () slice stopped
+    off_t resume_pos;
+
     off_t start_buffer;
     // some data for regexp
     int num_results;
@@ -150,6 +158,9 @@ gboolean mc_search_prepare (mc_search_t *mc_search);
 gboolean mc_search_run (mc_search_t *mc_search, const void *user_data, off_t start_search,
                         off_t end_search, gsize *found_len);
 
+gboolean mc_search_run_partial (mc_search_t *mc_search, const void *user_data, off_t *start_search,
+                                off_t end_search, off_t chunk_size, gsize *found_len);
+
 gboolean mc_search_is_type_avail (mc_search_type_t search_type);
 
 const mc_search_type_str_t *mc_search_types_list_get (size_t *num);
@@ -26,6 +26,8 @@
 
 #include <config.h>
 
+#include <string.h>
+
 #include "lib/global.h"
 #include "lib/strutil.h"
 #include "lib/search.h"
@@ -46,6 +48,140 @@
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Recognize the globs the panel filter and the select dialogs live on -- "*.o",
+ * "core*", "*~", "Makefile" -- so that matching them is a plain string compare
+ * instead of a trip through the regex engine per directory entry. The pattern
+ * qualifies when it is an anchored, metacharacter-free body with at most a
+ * leading and a trailing '*'.
+ */
+
+static void
+mc_search__glob_classify (mc_search_t *lc_mc_search, mc_search_cond_t *mc_search_cond)
+{
+    const char *str = mc_search_cond->str->str;
+    gsize len = mc_search_cond->str->len;
+    gboolean lead_star = FALSE;
+    gboolean trail_star = FALSE;
+    gsize loop;
+
+    // only the anchored form maps onto prefix/suffix/contains checks
+    if (!lc_mc_search->is_entire_line || lc_mc_search->whole_words)
+        return;
+
+    if (len != 0 && str[0] == '*')
+    {
+        lead_star = TRUE;
+        str++;
+        len--;
+    }
+    if (len != 0 && str[len - 1] == '*')
+    {
+        trail_star = TRUE;
+        len--;
+    }
+
+    for (loop = 0; loop < len; loop++)
+        switch (str[loop])
+        {
+        case '*':
+        case '?':
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case '|':
+        case '\\':
+            // glob metacharacter, character class or escape: regex territory
+            return;
+        default:
+            break;
+        }
+
+    // byte-wise case folding is only safe for ASCII
+    if (!lc_mc_search->is_case_sensitive && !mc_search__str_is_ascii (str, len))
+        return;
+
+    mc_search_cond->glob_body = g_string_new_len (str, len);
+    if (!lc_mc_search->is_case_sensitive)
+        g_string_ascii_down (mc_search_cond->glob_body);
+    mc_search_cond->glob_class = lead_star
+        ? (trail_star ? MC_SEARCH_GLOB__CONTAINS : MC_SEARCH_GLOB__SUFFIX)
+        : (trail_star ? MC_SEARCH_GLOB__PREFIX : MC_SEARCH_GLOB__EXACT);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+mc_search__glob_body_cmp (gboolean is_case_sensitive, const char *data, const GString *body)
+{
+    gsize loop;
+
+    if (is_case_sensitive)
+        return memcmp (data, body->str, body->len) == 0;
+
+    for (loop = 0; loop < body->len; loop++)
+        if (g_ascii_tolower (data[loop]) != body->str[loop])
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Match a classified glob against a single-line region. The anchored pattern
+ * matches the whole region or nothing, like the ^...$ regex it replaces.
+ */
+
+static gboolean
+mc_search__run_glob_simple (mc_search_t *lc_mc_search, const mc_search_cond_t *mc_search_cond,
+                            off_t start_search, const char *region, gsize region_len,
+                            gsize *found_len)
+{
+    const GString *body = mc_search_cond->glob_body;
+    gboolean found = FALSE;
+
+    switch (mc_search_cond->glob_class)
+    {
+    case MC_SEARCH_GLOB__EXACT:
+        found = region_len == body->len
+            && mc_search__glob_body_cmp (lc_mc_search->is_case_sensitive, region, body);
+        break;
+    case MC_SEARCH_GLOB__PREFIX:
+        found = region_len >= body->len
+            && mc_search__glob_body_cmp (lc_mc_search->is_case_sensitive, region, body);
+        break;
+    case MC_SEARCH_GLOB__SUFFIX:
+        found = region_len >= body->len
+            && mc_search__glob_body_cmp (lc_mc_search->is_case_sensitive,
+                                         region + region_len - body->len, body);
+        break;
+    case MC_SEARCH_GLOB__CONTAINS:
+        if (lc_mc_search->is_case_sensitive)
+            found = mc_search__memmem (region, region_len, body->str, body->len) != NULL;
+        else
+            found = mc_search__memcasemem (region, region_len, body->str, body->len) != NULL;
+        break;
+    default:
+        break;
+    }
+
+    if (!found)
+    {
+        MC_PTR_FREE (lc_mc_search->error_str);
+        lc_mc_search->error = MC_SEARCH_E_NOTFOUND;
+        return FALSE;
+    }
+
+    lc_mc_search->normal_offset = start_search;
+    if (found_len != NULL)
+        *found_len = region_len;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static GString *
 mc_search__glob_translate_to_regex (const GString *astr)
 {
@@ -171,6 +307,8 @@ mc_search__cond_struct_new_init_glob (const char *charset, mc_search_t *lc_mc_se
 {
     GString *tmp;
 
+    mc_search__glob_classify (lc_mc_search, mc_search_cond);
+
     tmp = mc_search__glob_translate_to_regex (mc_search_cond->str);
     g_string_free (mc_search_cond->str, TRUE);
 
@@ -190,6 +328,35 @@ gboolean
 mc_search__run_glob (mc_search_t *lc_mc_search, const void *user_data, off_t start_search,
                      off_t end_search, gsize *found_len)
 {
+    /* the simple matcher needs a contiguous buffer and a single condition;
+       searches fed through a callback, over several charsets or in partial
+       slices take the regex path */
+    if (lc_mc_search->search_fn == NULL && lc_mc_search->run_limit == 0
+        && lc_mc_search->prepared.conditions->len == 1 && end_search >= start_search)
+    {
+        const mc_search_cond_t *mc_search_cond;
+
+        mc_search_cond =
+            (const mc_search_cond_t *) g_ptr_array_index (lc_mc_search->prepared.conditions, 0);
+        if (mc_search_cond->glob_body != NULL)
+        {
+            const char *region = (const char *) user_data + start_search;
+            gsize region_len = (gsize) (end_search - start_search) + 1;
+
+            /* callers pass strlen () as the inclusive end, so the region
+               usually carries the terminating NUL; drop it like the regex
+               line walker, which stops there without matching it */
+            if (region_len != 0 && region[region_len - 1] == '\0')
+                region_len--;
+
+            // a multi-line or NUL-bearing region goes through the regex line walker
+            if (memchr (region, '\n', region_len) == NULL
+                && memchr (region, '\0', region_len) == NULL)
+                return mc_search__run_glob_simple (lc_mc_search, mc_search_cond, start_search,
+                                                   region, region_len, found_len);
+        }
+    }
+
     return mc_search__run_regex (lc_mc_search, user_data, start_search, end_search, found_len);
 }
 
@@ -38,6 +38,9 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* fetch size for callback-fed data in mc_search__run_hex_literal() */
+#define HEX_SEARCH_FETCH_BLOCK (64 * 1024)
+
 typedef enum
 {
     MC_SEARCH_HEX_E_OK,
@@ -57,16 +60,23 @@ typedef enum
 /* --------------------------------------------------------------------------------------------- */
 
 static GString *
-mc_search__hex_translate_to_regex (const GString *astr, mc_search_hex_parse_error_t *error_ptr,
-                                   int *error_pos_ptr)
+mc_search__hex_translate_to_regex (const GString *astr, GString **literal_ptr,
+                                   gboolean *has_letters_ptr,
+                                   mc_search_hex_parse_error_t *error_ptr, int *error_pos_ptr)
 {
     GString *buff;
+    GString *literal;
+    gboolean literal_ok = TRUE;
+    gboolean has_letters = FALSE;
     const char *str;
     gsize str_len;
     gsize loop = 0;
     mc_search_hex_parse_error_t error = MC_SEARCH_HEX_E_OK;
 
     buff = g_string_sized_new (64);
+    /* the pattern bytes themselves, collected for the literal matcher; dropped
+       when a quoted character would carry regex semantics (see below) */
+    literal = g_string_sized_new (64);
     str = astr->str;
     str_len = astr->len;
 
@@ -88,6 +98,7 @@ mc_search__hex_translate_to_regex (const GString *astr, mc_search_hex_parse_erro
             else
             {
                 g_string_append_printf (buff, "\\x%02X", val);
+                g_string_append_c (literal, (char) val);
                 loop += ptr;
             }
         }
@@ -104,6 +115,17 @@ mc_search__hex_translate_to_regex (const GString *astr, mc_search_hex_parse_erro
                 if (str[loop2] == '\\' && loop2 + 1 < str_len)
                     loop2++;
                 g_string_append_c (buff, str[loop2]);
+                /* quoted characters go into the regex verbatim, so a
+                   metacharacter keeps its regex meaning there -- such a
+                   pattern is not a plain byte sequence */
+                if (strchr ("\\^$.[]|()?*+{}", str[loop2]) != NULL)
+                    literal_ok = FALSE;
+                else
+                {
+                    g_string_append_c (literal, str[loop2]);
+                    if (g_ascii_isalpha (str[loop2]))
+                        has_letters = TRUE;
+                }
                 loop2++;
             }
 
@@ -119,6 +141,7 @@ mc_search__hex_translate_to_regex (const GString *astr, mc_search_hex_parse_erro
     if (error != MC_SEARCH_HEX_E_OK)
     {
         g_string_free (buff, TRUE);
+        g_string_free (literal, TRUE);
         if (error_ptr != NULL)
             *error_ptr = error;
         if (error_pos_ptr != NULL)
@@ -126,9 +149,171 @@ mc_search__hex_translate_to_regex (const GString *astr, mc_search_hex_parse_erro
         return NULL;
     }
 
+    if (!literal_ok || literal->len == 0)
+    {
+        g_string_free (literal, TRUE);
+        literal = NULL;
+    }
+
+    if (literal_ptr != NULL)
+        *literal_ptr = literal;
+    else if (literal != NULL)
+        g_string_free (literal, TRUE);
+    if (has_letters_ptr != NULL)
+        *has_letters_ptr = has_letters;
+
     return buff;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Literal matcher for hex patterns: find the byte sequence with plain memory
+ * scans (memchr on the leading byte, then verify) instead of the line-based
+ * regex engine. The data is treated as raw bytes: there is no line splitting
+ * and a NUL is a byte like any other, which is what hex-searching binary data
+ * wants. Error and budget semantics follow mc_search__run_literal() in
+ * normal.c.
+ */
+
+static gboolean
+mc_search__run_hex_literal (mc_search_t *lc_mc_search, const mc_search_cond_t *mc_search_cond,
+                            const void *user_data, off_t start_search, off_t end_search,
+                            gsize *found_len)
+{
+    const GString *literal = mc_search_cond->literal;
+    gboolean match = FALSE;
+    off_t found_at = 0;
+    gboolean aborted = FALSE;
+    gboolean out_of_budget = FALSE;
+
+    if (lc_mc_search->search_fn == NULL)
+    {
+        // contiguous buffer: one scan over the whole region
+        const char *region = (const char *) user_data + start_search;
+        gsize region_len = (gsize) (end_search - start_search) + 1;
+        const char *found;
+
+        /* budget of one mc_search_run_partial () slice: scan run_limit bytes
+           plus the overlap needed to catch a match straddling the cut */
+        if (lc_mc_search->run_limit != 0 && (off_t) region_len > lc_mc_search->run_limit)
+        {
+            const gsize limited = (gsize) lc_mc_search->run_limit + literal->len - 1;
+
+            if (limited < region_len)
+            {
+                region_len = limited;
+                out_of_budget = TRUE;
+            }
+        }
+
+        found = mc_search__memmem (region, region_len, literal->str, literal->len);
+        if (found != NULL)
+        {
+            match = TRUE;
+            found_at = start_search + (off_t) (found - region);
+        }
+    }
+    else
+    {
+        /* callback-fed data (the viewer): fetch fixed blocks and scan each
+           one, carrying a pattern-sized tail over to the next block so a
+           match straddling the cut is still seen */
+        char *block;
+        gsize fill = 0;
+        off_t block_base = start_search;
+        off_t pos = start_search;
+
+        block = g_malloc (HEX_SEARCH_FETCH_BLOCK);
+
+        while (!aborted && !match)
+        {
+            gsize got = fill;
+            const char *found;
+
+            while (got < HEX_SEARCH_FETCH_BLOCK && pos <= end_search)
+            {
+                int ch = 0;
+                mc_search_cbret_t ret;
+
+                ret = lc_mc_search->search_fn (user_data, pos, &ch);
+                if (ret == MC_SEARCH_CB_ABORT)
+                {
+                    aborted = TRUE;
+                    break;
+                }
+                if (ret != MC_SEARCH_CB_OK)
+                {
+                    /* MC_SEARCH_CB_SKIP/INVALID (nroff sequences) break the
+                       linear byte <-> offset mapping this scanner relies on;
+                       hand the whole search back to the generic engine */
+                    g_free (block);
+                    return mc_search__run_regex (lc_mc_search, user_data, start_search,
+                                                 end_search, found_len);
+                }
+                block[got++] = (char) ch;
+                pos++;
+            }
+
+            if (aborted)
+                break;
+
+            found = mc_search__memmem (block, got, literal->str, literal->len);
+            if (found != NULL)
+            {
+                match = TRUE;
+                found_at = block_base + (off_t) (found - block);
+                break;
+            }
+
+            if (pos > end_search)
+                break;
+
+            if (lc_mc_search->update_fn != NULL
+                && lc_mc_search->update_fn (user_data, pos) == MC_SEARCH_CB_ABORT)
+            {
+                aborted = TRUE;
+                break;
+            }
+
+            if (lc_mc_search->run_limit != 0 && pos - start_search >= lc_mc_search->run_limit)
+            {
+                out_of_budget = TRUE;
+                break;
+            }
+
+            // keep the tail that may be the head of a match crossing the cut
+            fill = literal->len - 1;
+            if (fill > got)
+                fill = got;
+            memmove (block, block + got - fill, fill);
+            block_base = pos - (off_t) fill;
+        }
+
+        g_free (block);
+    }
+
+    if (match)
+    {
+        lc_mc_search->normal_offset = found_at;
+        if (found_len != NULL)
+            *found_len = literal->len;
+        return TRUE;
+    }
+
+    MC_PTR_FREE (lc_mc_search->error_str);
+    if (aborted)
+        lc_mc_search->error = MC_SEARCH_E_ABORT;
+    else if (out_of_budget)
+    {
+        lc_mc_search->resume_pos = start_search + lc_mc_search->run_limit;
+        lc_mc_search->error = MC_SEARCH_E_CONTINUE;
+    }
+    else
+        lc_mc_search->error = MC_SEARCH_E_NOTFOUND;
+
+    return FALSE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -138,6 +323,8 @@ mc_search__cond_struct_new_init_hex (const char *charset, mc_search_t *lc_mc_sea
                                      mc_search_cond_t *mc_search_cond)
 {
     GString *tmp;
+    GString *literal = NULL;
+    gboolean has_letters = FALSE;
     mc_search_hex_parse_error_t error = MC_SEARCH_HEX_E_OK;
     int error_pos = 0;
 
@@ -177,9 +364,18 @@ mc_search__cond_struct_new_init_hex (const char *charset, mc_search_t *lc_mc_sea
     if (str_isutf8 (charset))
         charset = "ASCII";
 
-    tmp = mc_search__hex_translate_to_regex (mc_search_cond->str, &error, &error_pos);
+    tmp = mc_search__hex_translate_to_regex (mc_search_cond->str, &literal, &has_letters, &error,
+                                             &error_pos);
     if (tmp != NULL)
     {
+        /* Remember the raw bytes so mc_search__run_hex() can scan directly.
+           Quoted ASCII letters are matched case-insensitively by the regex
+           path when requested, which the exact byte matcher cannot do. */
+        if (literal != NULL && (lc_mc_search->is_case_sensitive || !has_letters))
+            mc_search_cond->literal = literal;
+        else if (literal != NULL)
+            g_string_free (literal, TRUE);
+
         g_string_free (mc_search_cond->str, TRUE);
         mc_search_cond->str = tmp;
         mc_search__cond_struct_new_init_regex (charset, lc_mc_search, mc_search_cond);
@@ -216,6 +412,19 @@ gboolean
 mc_search__run_hex (mc_search_t *lc_mc_search, const void *user_data, off_t start_search,
                     off_t end_search, gsize *found_len)
 {
+    /* a pattern that reduced to a plain byte sequence is matched by the block
+       scanner; several charsets or regex-flavoured quotes take the regex path */
+    if (lc_mc_search->prepared.conditions->len == 1 && end_search >= start_search)
+    {
+        const mc_search_cond_t *mc_search_cond;
+
+        mc_search_cond =
+            (const mc_search_cond_t *) g_ptr_array_index (lc_mc_search->prepared.conditions, 0);
+        if (mc_search_cond->literal != NULL)
+            return mc_search__run_hex_literal (lc_mc_search, mc_search_cond, user_data,
+                                               start_search, end_search, found_len);
+    }
+
     return mc_search__run_regex (lc_mc_search, user_data, start_search, end_search, found_len);
 }
 
@@ -15,6 +15,16 @@ typedef enum
     COND__FOUND_ERROR
 } mc_search__found_cond_t;
 
+/* how a simple glob maps onto plain string operations */
+typedef enum
+{
+    MC_SEARCH_GLOB__NONE = 0,  // pattern needs the regex engine
+    MC_SEARCH_GLOB__EXACT,     // body
+    MC_SEARCH_GLOB__PREFIX,    // body*
+    MC_SEARCH_GLOB__SUFFIX,    // *body
+    MC_SEARCH_GLOB__CONTAINS   // *body*
+} mc_search_glob_class_t;
+
 /*** structures declarations (and typedefs of structures)*****************************************/
 
 typedef struct mc_search_cond_struct
@@ -22,6 +32,19 @@ typedef struct mc_search_cond_struct
     GString *str;
     GString *upper;
     GString *lower;
+    /* raw pattern bytes for the literal fast path of the normal and hex engines;
+       lowercased for case insensitive normal searches, exact bytes for hex.
+       NULL if the fast path does not apply */
+    GString *literal;
+    /* a literal every match must contain, extracted from the regex pattern and used
+       to skip lines without running the regex; lowercased for case insensitive
+       searches. NULL if no such literal could be extracted */
+    GString *prefilter;
+    /* simple glob fast path: the pattern reduced to one metacharacter-free body
+       with optional leading/trailing '*', checked by plain string compares;
+       lowercased for case insensitive searches. NULL if the pattern is not that simple */
+    GString *glob_body;
+    mc_search_glob_class_t glob_class;
     GRegex *regex_handle;
     gchar *charset;
 } mc_search_cond_t;
@@ -38,6 +61,7 @@ GString *mc_search__get_one_symbol (const char *charset, const char *str, gsize
                                     gboolean *just_letters);
 GString *mc_search__tolower_case_str (const char *charset, const GString *str);
 GString *mc_search__toupper_case_str (const char *charset, const GString *str);
+gboolean mc_search__str_is_ascii (const char *str, gsize len);
 
 /* search/regex.c : */
 
@@ -49,6 +73,10 @@ GString *mc_search_regex_prepare_replace_str (mc_search_t *lc_mc_search, GString
 
 /* search/normal.c : */
 
+const char *mc_search__memmem (const char *haystack, gsize h_len, const char *needle, gsize n_len);
+const char *mc_search__memcasemem (const char *haystack, gsize h_len, const char *needle,
+                                   gsize n_len);
+
 void mc_search__cond_struct_new_init_normal (const char *charset, mc_search_t *lc_mc_search,
                                              mc_search_cond_t *mc_search_cond);
 gboolean mc_search__run_normal (mc_search_t *lc_mc_search, const void *user_data,
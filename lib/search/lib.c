@@ -176,6 +176,20 @@ mc_search__toupper_case_str (const char *charset, const GString *str)
 
 /* --------------------------------------------------------------------------------------------- */
 
+gboolean
+mc_search__str_is_ascii (const char *str, gsize len)
+{
+    gsize loop;
+
+    for (loop = 0; loop < len; loop++)
+        if ((unsigned char) str[loop] > 0x7F)
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 gchar **
 mc_search_get_types_strings_array (size_t *num)
 {
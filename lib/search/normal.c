@@ -26,6 +26,8 @@
 
 #include <config.h>
 
+#include <string.h>
+
 #include "lib/global.h"
 #include "lib/strutil.h"
 #include "lib/search.h"
@@ -46,6 +48,137 @@
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+const char *
+mc_search__memmem (const char *haystack, gsize h_len, const char *needle, gsize n_len)
+{
+    // an empty needle matches at the start, as in memmem(3)
+    if (n_len == 0)
+        return haystack;
+
+#ifdef HAVE_MEMMEM
+    return (const char *) memmem (haystack, h_len, needle, n_len);
+#else
+    const char *h = haystack;
+    const char *last;
+
+    if (n_len > h_len)
+        return NULL;
+
+    for (last = haystack + (h_len - n_len); h <= last; h++)
+    {
+        h = (const char *) memchr (h, needle[0], (gsize) (last - h) + 1);
+        if (h == NULL)
+            return NULL;
+        if (memcmp (h, needle, n_len) == 0)
+            return h;
+    }
+
+    return NULL;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Case insensitive counterpart of mc_search__memmem().
+ * The needle must already be lowercase and pure ASCII.
+ */
+
+const char *
+mc_search__memcasemem (const char *haystack, gsize h_len, const char *needle, gsize n_len)
+{
+    gsize loop;
+
+    // an empty needle matches at the start, as in memmem(3)
+    if (n_len == 0)
+        return haystack;
+
+    if (n_len > h_len)
+        return NULL;
+
+    for (loop = 0; loop + n_len <= h_len; loop++)
+        if (g_ascii_tolower (haystack[loop]) == needle[0])
+        {
+            gsize loop2;
+
+            for (loop2 = 1;
+                 loop2 < n_len && g_ascii_tolower (haystack[loop + loop2]) == needle[loop2];
+                 loop2++)
+                ;
+            if (loop2 == n_len)
+                return haystack + loop;
+        }
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Literal matcher: scan the buffer directly instead of going through the regex
+ * engine line by line. Semantics match mc_search__run_regex() for a literal
+ * pattern: the region is [start_search, end_search] and nothing past the first
+ * NUL byte can match, since the line walker of the regex engine stops there.
+ */
+
+static gboolean
+mc_search__run_literal (mc_search_t *lc_mc_search, const mc_search_cond_t *mc_search_cond,
+                        const void *user_data, off_t start_search, off_t end_search,
+                        gsize *found_len)
+{
+    const GString *literal = mc_search_cond->literal;
+    const char *region = (const char *) user_data + start_search;
+    gsize region_len;
+    const char *found;
+    gboolean out_of_budget = FALSE;
+
+    region_len = (gsize) (end_search - start_search) + 1;
+
+    /* budget of one mc_search_run_partial () slice: scan run_limit bytes plus
+       the overlap needed to catch a match straddling the cut */
+    if (lc_mc_search->run_limit != 0 && (off_t) region_len > lc_mc_search->run_limit)
+    {
+        const gsize limited = (gsize) lc_mc_search->run_limit + literal->len - 1;
+
+        if (limited < region_len)
+        {
+            region_len = limited;
+            out_of_budget = TRUE;
+        }
+    }
+
+    if (lc_mc_search->is_case_sensitive)
+        found = mc_search__memmem (region, region_len, literal->str, literal->len);
+    else
+        found = mc_search__memcasemem (region, region_len, literal->str, literal->len);
+
+    // a NUL byte before the match would have stopped the regex engine
+    if (found != NULL && memchr (region, '\0', (gsize) (found - region)) != NULL)
+        found = NULL;
+
+    if (found == NULL)
+    {
+        // nothing past a NUL can match, so a NUL in the slice ends the search
+        if (out_of_budget && memchr (region, '\0', region_len) == NULL)
+        {
+            lc_mc_search->resume_pos = start_search + lc_mc_search->run_limit;
+            MC_PTR_FREE (lc_mc_search->error_str);
+            lc_mc_search->error = MC_SEARCH_E_CONTINUE;
+            return FALSE;
+        }
+
+        MC_PTR_FREE (lc_mc_search->error_str);
+        lc_mc_search->error = MC_SEARCH_E_NOTFOUND;
+        return FALSE;
+    }
+
+    lc_mc_search->normal_offset = start_search + (off_t) (found - region);
+    if (found_len != NULL)
+        *found_len = literal->len;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 mc_search__normal_translate_to_regex (GString *str)
 {
@@ -86,6 +219,22 @@ void
 mc_search__cond_struct_new_init_normal (const char *charset, mc_search_t *lc_mc_search,
                                         mc_search_cond_t *mc_search_cond)
 {
+    /* A normal pattern is a literal by construction. When no regex feature is
+       involved -- no word boundaries, and case folding (if any) is byte-safe
+       because the pattern is pure ASCII -- remember the raw bytes so that
+       mc_search__run_normal() can bypass the regex engine. */
+    /* a pattern with a newline can never match through the regex engine, which splits
+       the buffer into lines first -- keep it away from the raw byte matcher, too */
+    if (!lc_mc_search->whole_words && mc_search_cond->str->len != 0
+        && memchr (mc_search_cond->str->str, '\n', mc_search_cond->str->len) == NULL
+        && (lc_mc_search->is_case_sensitive
+            || mc_search__str_is_ascii (mc_search_cond->str->str, mc_search_cond->str->len)))
+    {
+        mc_search_cond->literal = mc_g_string_dup (mc_search_cond->str);
+        if (!lc_mc_search->is_case_sensitive)
+            g_string_ascii_down (mc_search_cond->literal);
+    }
+
     mc_search__normal_translate_to_regex (mc_search_cond->str);
     mc_search__cond_struct_new_init_regex (charset, lc_mc_search, mc_search_cond);
 }
@@ -96,6 +245,20 @@ gboolean
 mc_search__run_normal (mc_search_t *lc_mc_search, const void *user_data, off_t start_search,
                        off_t end_search, gsize *found_len)
 {
+    /* the literal matcher needs a contiguous buffer and a single condition;
+       searches fed through a callback or over several charsets take the regex path */
+    if (lc_mc_search->search_fn == NULL && lc_mc_search->prepared.conditions->len == 1
+        && end_search >= start_search)
+    {
+        const mc_search_cond_t *mc_search_cond;
+
+        mc_search_cond =
+            (const mc_search_cond_t *) g_ptr_array_index (lc_mc_search->prepared.conditions, 0);
+        if (mc_search_cond->literal != NULL)
+            return mc_search__run_literal (lc_mc_search, mc_search_cond, user_data, start_search,
+                                           end_search, found_len);
+    }
+
     return mc_search__run_regex (lc_mc_search, user_data, start_search, end_search, found_len);
 }
 
@@ -45,6 +45,9 @@
 #define REPLACE_PREPARE_T_REPLACE_FLAG    -2
 #define REPLACE_PREPARE_T_ESCAPE_SEQ      -3
 
+/* shorter mandatory literals are not worth a prefilter pass over the line */
+#define PREFILTER_MIN_LEN                 3
+
 /*** file scope type declarations ****************************************************************/
 
 typedef enum
@@ -366,6 +369,21 @@ mc_search__regex_found_cond (mc_search_t *lc_mc_search, GString *search_str)
         if (!mc_search_cond->regex_handle)
             continue;
 
+        // a line without the mandatory literal cannot match: skip the regex
+        if (mc_search_cond->prefilter != NULL)
+        {
+            const GString *pf = mc_search_cond->prefilter;
+            const char *hit;
+
+            if (lc_mc_search->is_case_sensitive)
+                hit = mc_search__memmem (search_str->str, search_str->len, pf->str, pf->len);
+            else
+                hit = mc_search__memcasemem (search_str->str, search_str->len, pf->str, pf->len);
+
+            if (hit == NULL)
+                continue;
+        }
+
         ret = mc_search__regex_found_cond_one (lc_mc_search, mc_search_cond->regex_handle,
                                                search_str);
         if (ret != COND__NOT_FOUND)
@@ -766,6 +784,151 @@ mc_search_regex__process_escape_sequence (GString *dest_str, const char *from, g
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/* Drop the last character of a pending literal run: a quantifier makes the whole
+   preceding character optional, and for a multibyte UTF-8 character the
+   continuation bytes must go together with the lead byte. In a non-UTF-8 charset
+   this can strip more than one character, which only shortens the literal --
+   always safe for a prefilter. */
+
+static void
+mc_search__prefilter_drop_last_char (GString *str)
+{
+    gsize len = str->len;
+
+    while (len != 0 && ((unsigned char) str->str[len - 1] & 0xC0) == 0x80)
+        len--;
+    if (len != 0)
+        len--;
+    g_string_truncate (str, len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Extract the longest literal every match of the pattern must contain.
+ *
+ * The scan is conservative: runs of ordinary characters are collected, atoms that
+ * may repeat or disappear ('*', '?', '{...}', escapes, classes, '.') end the
+ * current run, and any grouping or alternation gives up altogether, since a
+ * completed run could then sit inside an optional branch.
+ *
+ * @param pattern the regex pattern (raw, before any wrapping or rewriting)
+ * @param fold_case TRUE for a case insensitive search: only ASCII runs are kept
+ *        and the result is lowercased
+ *
+ * @return the literal, or NULL if none of at least PREFILTER_MIN_LEN bytes exists
+ */
+
+static GString *
+mc_search__regex_extract_prefilter (const GString *pattern, gboolean fold_case)
+{
+    GString *best = NULL;
+    GString *current;
+    gsize loop;
+
+    current = g_string_sized_new (16);
+
+#define prefilter_end_run()                                                                        \
+    do                                                                                             \
+    {                                                                                              \
+        if (current->len != 0 && (best == NULL || current->len > best->len))                       \
+        {                                                                                          \
+            if (best != NULL)                                                                      \
+                g_string_free (best, TRUE);                                                        \
+            best = mc_g_string_dup (current);                                                      \
+        }                                                                                          \
+        g_string_truncate (current, 0);                                                            \
+    }                                                                                              \
+    while (FALSE)
+
+    for (loop = 0; loop < pattern->len; loop++)
+    {
+        const char c = pattern->str[loop];
+
+        switch (c)
+        {
+        case '|':
+        case '(':
+        case ')':
+            // give up: a run may belong to one branch of an alternation
+            // or to a group that repeats or is optional as a whole
+            g_string_free (current, TRUE);
+            if (best != NULL)
+                g_string_free (best, TRUE);
+            return NULL;
+
+        case '\\':
+            // the escaped atom may be a class or an anchor; treat it as a barrier
+            loop++;
+            prefilter_end_run ();
+            break;
+
+        case '[':
+            // skip the character class
+            loop++;
+            if (loop < pattern->len && pattern->str[loop] == '^')
+                loop++;
+            if (loop < pattern->len && pattern->str[loop] == ']')
+                loop++;  // a ']' right at the start is a literal one
+            for (; loop < pattern->len && pattern->str[loop] != ']'; loop++)
+                if (pattern->str[loop] == '\\')
+                    loop++;
+            prefilter_end_run ();
+            break;
+
+        case '*':
+        case '?':
+            // the previous character may be absent
+            mc_search__prefilter_drop_last_char (current);
+            prefilter_end_run ();
+            break;
+
+        case '{':
+            // counted repetition: the previous character may be absent or repeat
+            mc_search__prefilter_drop_last_char (current);
+            for (; loop < pattern->len && pattern->str[loop] != '}'; loop++)
+                ;
+            prefilter_end_run ();
+            break;
+
+        case '+':
+            // at least one occurrence is mandatory, but the run ends here
+            prefilter_end_run ();
+            break;
+
+        case '.':
+        case '^':
+        case '$':
+            prefilter_end_run ();
+            break;
+
+        default:
+            if (fold_case && (unsigned char) c > 0x7F)
+                prefilter_end_run ();  // byte-wise folding is only safe for ASCII
+            else
+                g_string_append_c (current, c);
+            break;
+        }
+    }
+
+    prefilter_end_run ();
+
+#undef prefilter_end_run
+
+    g_string_free (current, TRUE);
+
+    if (best != NULL && best->len < PREFILTER_MIN_LEN)
+    {
+        g_string_free (best, TRUE);
+        best = NULL;
+    }
+
+    if (best != NULL && fold_case)
+        g_string_ascii_down (best);
+
+    return best;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -774,6 +937,14 @@ void
 mc_search__cond_struct_new_init_regex (const char *charset, mc_search_t *lc_mc_search,
                                        mc_search_cond_t *mc_search_cond)
 {
+    /* Extract the prefilter literal before the pattern is wrapped or rewritten below.
+       With Unicode caseless matching a byte-wise folded literal could miss a hit
+       (e.g. "K" U+212A folds to "k"), so the caseless prefilter is limited to the
+       G_REGEX_RAW branch. */
+    if (lc_mc_search->is_case_sensitive || !(str_isutf8 (charset) && mc_global.utf8_display))
+        mc_search_cond->prefilter = mc_search__regex_extract_prefilter (
+            mc_search_cond->str, !lc_mc_search->is_case_sensitive);
+
     if (lc_mc_search->whole_words && !lc_mc_search->is_entire_line)
     {
         /* NOTE: \b as word boundary doesn't allow search
@@ -876,12 +1047,17 @@ mc_search__run_regex (mc_search_t *lc_mc_search, const void *user_data, off_t st
              *  where there is no MC_SEARCH_CB_INVALID or MC_SEARCH_CB_SKIP
              *  return codes, so we can copy line at regex buffer all at once
              */
+            gboolean nul_found = FALSE;
+
             while (TRUE)
             {
                 const char current_chr = ((const char *) user_data)[current_pos];
 
                 if (current_chr == '\0')
+                {
+                    nul_found = TRUE;
                     break;
+                }
 
                 current_pos++;
 
@@ -893,6 +1069,10 @@ mc_search__run_regex (mc_search_t *lc_mc_search, const void *user_data, off_t st
             g_string_append_len (lc_mc_search->regex_buffer, (const char *) user_data + virtual_pos,
                                  current_pos - virtual_pos);
             virtual_pos = current_pos;
+
+            /* walk on to the next line of the buffer; a NUL byte stops the
+               walk like the stop symbol does in the callback branch above */
+            ret = nul_found ? MC_SEARCH_CB_NOTFOUND : MC_SEARCH_CB_OK;
         }
 
         switch (mc_search__regex_found_cond (lc_mc_search, lc_mc_search->regex_buffer))
@@ -921,6 +1101,22 @@ mc_search__run_regex (mc_search_t *lc_mc_search, const void *user_data, off_t st
 
         if (ret == MC_SEARCH_CB_ABORT || ret == MC_SEARCH_CB_NOTFOUND)
             break;
+
+        /* out of budget for this mc_search_run_partial () slice; lines are the
+           only safe cut points, so an oversized line overruns the budget */
+        if (lc_mc_search->run_limit != 0 && virtual_pos <= end_search
+            && current_pos - start_search >= lc_mc_search->run_limit)
+        {
+            lc_mc_search->resume_pos = current_pos;
+
+            g_string_free (lc_mc_search->regex_buffer, TRUE);
+            lc_mc_search->regex_buffer = NULL;
+
+            MC_PTR_FREE (lc_mc_search->error_str);
+            lc_mc_search->error = MC_SEARCH_E_CONTINUE;
+
+            return FALSE;
+        }
     }
 
     g_string_free (lc_mc_search->regex_buffer, TRUE);
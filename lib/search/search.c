@@ -29,11 +29,13 @@
 
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include "lib/global.h"
 #include "lib/strutil.h"
 #include "lib/search.h"
+#include "lib/trace.h"
 #include "lib/util.h"
 #include "lib/charsets.h"
 
@@ -43,8 +45,29 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* slots in the compiled-pattern cache */
+#define SEARCH_COND_CACHE_SIZE 32
+
 /*** file scope type declarations ****************************************************************/
 
+/* One remembered compilation: everything that went into building the condition
+   array, and the array itself. The cache holds its own reference; searches that
+   hit the cache take another one, so eviction never pulls conditions out from
+   under a running search. */
+typedef struct
+{
+    char *pattern;  // original pattern bytes, pattern_len of them
+    gsize pattern_len;
+    char *charset;
+    mc_search_type_t search_type;
+    gboolean is_case_sensitive;
+    gboolean whole_words;
+    gboolean is_entire_line;
+    gboolean is_all_charsets;
+    GPtrArray *conditions;  // NULL = empty slot
+    guint64 stamp;          // recency for LRU eviction
+} mc_search_cond_cache_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -57,6 +80,15 @@ static const mc_search_type_str_t mc_search__list_types[] = {
     { NULL, MC_SEARCH_T_INVALID }
 };
 
+/* Process-wide cache of prepared condition arrays. The same handful of patterns
+   gets recompiled constantly -- reopened search dialogs, per-file searches during
+   "Find file", filter expressions -- and with is_all_charsets a single prepare
+   recodes and compiles the pattern once per known codepage. Guarded by a mutex:
+   the directory loader thread prepares filter searches lazily. */
+static GMutex mc_search_cond_cache_lock;
+static mc_search_cond_cache_t mc_search_cond_cache[SEARCH_COND_CACHE_SIZE];
+static guint64 mc_search_cond_cache_stamp = 0;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -103,6 +135,15 @@ mc_search__cond_struct_free (gpointer data)
     if (mc_search_cond->lower != NULL)
         g_string_free (mc_search_cond->lower, TRUE);
 
+    if (mc_search_cond->literal != NULL)
+        g_string_free (mc_search_cond->literal, TRUE);
+
+    if (mc_search_cond->prefilter != NULL)
+        g_string_free (mc_search_cond->prefilter, TRUE);
+
+    if (mc_search_cond->glob_body != NULL)
+        g_string_free (mc_search_cond->glob_body, TRUE);
+
     g_string_free (mc_search_cond->str, TRUE);
     g_free (mc_search_cond->charset);
 
@@ -112,6 +153,92 @@ mc_search__cond_struct_free (gpointer data)
     g_free (mc_search_cond);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+mc_search__cond_cache_matches (const mc_search_cond_cache_t *entry, const mc_search_t *lc_mc_search)
+{
+    return entry->conditions != NULL && entry->search_type == lc_mc_search->search_type
+        && entry->is_case_sensitive == lc_mc_search->is_case_sensitive
+        && entry->whole_words == lc_mc_search->whole_words
+        && entry->is_entire_line == lc_mc_search->is_entire_line
+        && entry->is_all_charsets == lc_mc_search->is_all_charsets
+        && entry->pattern_len == lc_mc_search->original.str->len
+        && memcmp (entry->pattern, lc_mc_search->original.str->str, entry->pattern_len) == 0
+        && strcmp (entry->charset, lc_mc_search->original.charset) == 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Look up a previously compiled condition array.
+ *
+ * @return a new reference to the cached array, or NULL on a miss
+ */
+
+static GPtrArray *
+mc_search__cond_cache_lookup (const mc_search_t *lc_mc_search)
+{
+    GPtrArray *conditions = NULL;
+    size_t i;
+
+    g_mutex_lock (&mc_search_cond_cache_lock);
+    for (i = 0; i < SEARCH_COND_CACHE_SIZE; i++)
+        if (mc_search__cond_cache_matches (&mc_search_cond_cache[i], lc_mc_search))
+        {
+            mc_search_cond_cache[i].stamp = ++mc_search_cond_cache_stamp;
+            conditions = g_ptr_array_ref (mc_search_cond_cache[i].conditions);
+            break;
+        }
+    g_mutex_unlock (&mc_search_cond_cache_lock);
+
+    return conditions;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Remember a freshly compiled condition array, evicting the least recently
+ * used slot. Only successful compilations are offered here.
+ */
+
+static void
+mc_search__cond_cache_insert (const mc_search_t *lc_mc_search, GPtrArray *conditions)
+{
+    mc_search_cond_cache_t *victim;
+    size_t i;
+
+    g_mutex_lock (&mc_search_cond_cache_lock);
+
+    /* another thread may have compiled the same pattern meanwhile; keeping
+       a duplicate slot is harmless, so don't bother rescanning */
+    victim = &mc_search_cond_cache[0];
+    for (i = 1; i < SEARCH_COND_CACHE_SIZE; i++)
+    {
+        if (victim->conditions == NULL)
+            break;
+        if (mc_search_cond_cache[i].conditions == NULL
+            || mc_search_cond_cache[i].stamp < victim->stamp)
+            victim = &mc_search_cond_cache[i];
+    }
+
+    if (victim->conditions != NULL)
+    {
+        g_free (victim->pattern);
+        g_free (victim->charset);
+        g_ptr_array_unref (victim->conditions);
+    }
+
+    victim->pattern = g_strndup (lc_mc_search->original.str->str, lc_mc_search->original.str->len);
+    victim->pattern_len = lc_mc_search->original.str->len;
+    victim->charset = g_strdup (lc_mc_search->original.charset);
+    victim->search_type = lc_mc_search->search_type;
+    victim->is_case_sensitive = lc_mc_search->is_case_sensitive;
+    victim->whole_words = lc_mc_search->whole_words;
+    victim->is_entire_line = lc_mc_search->is_entire_line;
+    victim->is_all_charsets = lc_mc_search->is_all_charsets;
+    victim->conditions = g_ptr_array_ref (conditions);
+    victim->stamp = ++mc_search_cond_cache_stamp;
+
+    g_mutex_unlock (&mc_search_cond_cache_lock);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -171,7 +298,8 @@ mc_search_free (mc_search_t *lc_mc_search)
     g_free (lc_mc_search->error_str);
 
     if (lc_mc_search->prepared.conditions != NULL)
-        g_ptr_array_free (lc_mc_search->prepared.conditions, TRUE);
+        // the array may still be shared with the compiled-pattern cache
+        g_ptr_array_unref (lc_mc_search->prepared.conditions);
 
     if (lc_mc_search->regex_match_info != NULL)
         g_match_info_free (lc_mc_search->regex_match_info);
@@ -192,6 +320,16 @@ mc_search_prepare (mc_search_t *lc_mc_search)
     if (lc_mc_search->prepared.conditions != NULL)
         return lc_mc_search->prepared.result;
 
+    /* conditions are immutable once built (runs keep their state on the
+       mc_search_t itself), so a compiled array can be shared freely */
+    ret = mc_search__cond_cache_lookup (lc_mc_search);
+    if (ret != NULL)
+    {
+        lc_mc_search->prepared.conditions = ret;
+        lc_mc_search->prepared.result = TRUE;
+        return TRUE;
+    }
+
     ret = g_ptr_array_new_with_free_func (mc_search__cond_struct_free);
     if (!lc_mc_search->is_all_charsets)
         g_ptr_array_add (ret,
@@ -199,33 +337,64 @@ mc_search_prepare (mc_search_t *lc_mc_search)
                                                      lc_mc_search->original.charset));
     else
     {
+        GPtrArray *seen_utf8;
+        GPtrArray *seen_raw;
         gsize loop1;
 
+        /* Most codepages cannot tell the pattern apart: an ASCII pattern
+           recodes to the very same bytes nearly everywhere, and a failed
+           conversion falls back to the original bytes as well.  Compiling
+           each copy multiplies setup cost by the size of the codepage table
+           for conditions that match exactly the same data, so keep one
+           condition per distinct pattern byte sequence.  UTF-8 and raw
+           regexes interpret those bytes differently ('.', case folding),
+           hence separate dedup lists per regex mode. */
+        seen_utf8 = g_ptr_array_new ();
+        seen_raw = g_ptr_array_new ();
+
         for (loop1 = 0; loop1 < codepages->len; loop1++)
         {
             const char *id = get_codepage_id (loop1);
+            GPtrArray *seen;
+            GString *buffer;
+            gboolean dup = FALSE;
+            gsize loop2;
 
             if (g_ascii_strcasecmp (id, lc_mc_search->original.charset) == 0)
-                g_ptr_array_add (ret,
-                                 mc_search__cond_struct_new (lc_mc_search,
-                                                             lc_mc_search->original.str,
-                                                             lc_mc_search->original.charset));
+                buffer = mc_g_string_dup (lc_mc_search->original.str);
             else
-            {
-                GString *buffer;
-
                 buffer = mc_search__recode_str (lc_mc_search->original.str->str,
                                                 lc_mc_search->original.str->len,
                                                 lc_mc_search->original.charset, id);
-                g_ptr_array_add (ret, mc_search__cond_struct_new (lc_mc_search, buffer, id));
+
+            seen = str_isutf8 (id) ? seen_utf8 : seen_raw;
+            for (loop2 = 0; loop2 < seen->len && !dup; loop2++)
+                dup = g_string_equal (buffer, (GString *) g_ptr_array_index (seen, loop2));
+
+            if (dup)
                 g_string_free (buffer, TRUE);
+            else
+            {
+                g_ptr_array_add (ret, mc_search__cond_struct_new (lc_mc_search, buffer, id));
+                g_ptr_array_add (seen, buffer);
             }
         }
+
+        for (loop1 = 0; loop1 < seen_utf8->len; loop1++)
+            g_string_free ((GString *) g_ptr_array_index (seen_utf8, loop1), TRUE);
+        g_ptr_array_free (seen_utf8, TRUE);
+        for (loop1 = 0; loop1 < seen_raw->len; loop1++)
+            g_string_free ((GString *) g_ptr_array_index (seen_raw, loop1), TRUE);
+        g_ptr_array_free (seen_raw, TRUE);
     }
 
     lc_mc_search->prepared.conditions = ret;
     lc_mc_search->prepared.result = (lc_mc_search->error == MC_SEARCH_E_OK);
 
+    // failed compilations carry an error message, not reusable state
+    if (lc_mc_search->prepared.result)
+        mc_search__cond_cache_insert (lc_mc_search, ret);
+
     return lc_mc_search->prepared.result;
 }
 
@@ -249,6 +418,7 @@ mc_search_run (mc_search_t *lc_mc_search, const void *user_data, off_t start_sea
                off_t end_search, gsize *found_len)
 {
     gboolean ret = FALSE;
+    const gint64 trace_start = mc_trace_begin ();
 
     if (lc_mc_search == NULL || user_data == NULL)
         return FALSE;
@@ -286,6 +456,41 @@ mc_search_run (mc_search_t *lc_mc_search, const void *user_data, off_t start_sea
     default:
         break;
     }
+
+    mc_trace_end ("mc_search_run", trace_start, (guint64) (end_search - start_search));
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Carries out one slice of a search.
+ *
+ * Like mc_search_run(), but returns after roughly @chunk_size bytes even
+ * without a verdict, so the caller can handle input between slices. On such an
+ * early return the result is FALSE, the error is MC_SEARCH_E_CONTINUE, and
+ * @start_search is advanced to the resume position: calling again continues
+ * the search where it stopped. Slices are cut at line boundaries only, so a
+ * single line longer than @chunk_size is still processed in one go.
+ */
+gboolean
+mc_search_run_partial (mc_search_t *lc_mc_search, const void *user_data, off_t *start_search,
+                       off_t end_search, off_t chunk_size, gsize *found_len)
+{
+    gboolean ret;
+
+    if (lc_mc_search == NULL || start_search == NULL)
+        return FALSE;
+
+    lc_mc_search->run_limit = chunk_size;
+    lc_mc_search->resume_pos = *start_search;
+    ret = mc_search_run (lc_mc_search, user_data, *start_search, end_search, found_len);
+    lc_mc_search->run_limit = 0;
+
+    if (!ret && lc_mc_search->error == MC_SEARCH_E_CONTINUE)
+        *start_search = lc_mc_search->resume_pos;
+
     return ret;
 }
 
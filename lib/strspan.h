@@ -0,0 +1,118 @@
+#ifndef MC_STRSPAN_H
+#define MC_STRSPAN_H
+
+#include "lib/global.h"  // include glib.h
+
+#include <string.h>
+
+/* A borrowed view into someone else's character buffer: pointer plus length,
+ * no ownership, no allocation and no NUL terminator requirement. Hot loops
+ * that today cut strings apart with g_strsplit()/g_strdup() only to free the
+ * pieces a moment later can walk spans over the original buffer instead.
+ *
+ * A span never outlives the buffer it points into; call str_span_dup() at the
+ * rare points where a copy really has to escape the loop.
+ */
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct
+{
+    const char *str;
+    size_t len;
+} str_span_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+/*** inline functions ****************************************************************************/
+
+static inline str_span_t
+str_span (const char *str, size_t len)
+{
+    const str_span_t span = { .str = str, .len = len };
+
+    return span;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline str_span_t
+str_span_from_str (const char *str)
+{
+    return str_span (str, str == NULL ? 0 : strlen (str));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline gboolean
+str_span_equal (str_span_t a, str_span_t b)
+{
+    return a.len == b.len && (a.len == 0 || memcmp (a.str, b.str, a.len) == 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline gboolean
+str_span_equal_str (str_span_t span, const char *str)
+{
+    return str_span_equal (span, str_span_from_str (str));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Cut the next @sep separated token off the front of @rest.
+ *
+ * Empty tokens (leading, trailing or doubled separators) are skipped, matching
+ * what path tokenization expects. Returns FALSE when @rest is exhausted;
+ * @token then stays untouched.
+ */
+
+static inline gboolean
+str_span_next_token (str_span_t *rest, char sep, str_span_t *token)
+{
+    while (rest->len != 0)
+    {
+        const char *cut;
+        str_span_t t;
+
+        cut = memchr (rest->str, sep, rest->len);
+        if (cut == NULL)
+        {
+            t = *rest;
+            rest->str += rest->len;
+            rest->len = 0;
+        }
+        else
+        {
+            t = str_span (rest->str, (size_t) (cut - rest->str));
+            rest->len -= t.len + 1;
+            rest->str = cut + 1;
+        }
+
+        if (t.len != 0)
+        {
+            *token = t;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** The escape hatch: a NUL terminated heap copy for the places that must own the bytes. */
+
+static inline char *
+str_span_dup (str_span_t span)
+{
+    return g_strndup (span.str, span.len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#endif
@@ -420,6 +420,12 @@ const char *str_term_substring (const char *text, int start, int width);
  */
 int str_term_width1 (const char *text);
 
+/* memoizing variant of str_term_width1 for the stable UI string corpus
+ * (widget labels, titles, menu entries); do not feed it unbounded dynamic data
+ * I
+ */
+int str_term_width1_memo (const char *text);
+
 /* return width, that will be text occupied on terminal
  * text is limited by width in characters
  * I
@@ -539,6 +545,18 @@ int str_verscmp (const char *s1, const char *s2);
  */
 int filenvercmp (char const *a, ssize_t alen, char const *b, ssize_t blen);
 
+/* Return the length of the prefix of the byte array s (of length len) that remains after
+   cutting the file suffix, for use with filenvercmp_prefix().
+ */
+ssize_t filevercmp_prefixlen (const char *s, ssize_t len);
+
+/* Like filenvercmp, except take the prefix lengths precomputed by filevercmp_prefixlen(),
+   so that sorting does not re-scan the suffixes on every comparison. alen and blen must
+   be nonnegative.
+ */
+int filenvercmp_prefix (const char *a, ssize_t alen, ssize_t aprefixlen, const char *b,
+                        ssize_t blen, ssize_t bprefixlen);
+
 /* return how many lines and columns will text occupy on terminal
  */
 void str_msg_term_size (const char *text, int *lines, int *columns);
@@ -182,52 +182,66 @@ verrevcmp (const char *s1, ssize_t s1_len, const char *s2, ssize_t s2_len)
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
-/* Compare version strings.
+/* Return the length of the prefix of @s that remains after cutting the file suffix,
+ * for use with filenvercmp_prefix().
  *
- * @param a first string to compare
- * @param alen length of @a or (-1)
- * @param b second string to compare
- * @param blen length of @b or (-1)
+ * @param s a char array
+ * @param len length of @s
  *
- * @return an integer less than, equal to, or greater than zero, if @s1 is <, == or > than @s2.
+ * @return length of @s without the file suffix
+ */
+ssize_t
+filevercmp_prefixlen (const char *s, ssize_t len)
+{
+    return file_prefixlen (s, &len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Compare version strings with precomputed suffix boundaries.
+ *
+ * Like filenvercmp(), but takes the prefix lengths computed by filevercmp_prefixlen(), so
+ * repeated comparisons of the same strings (typically while sorting) do not re-scan the
+ * suffixes every time.
+ *
+ * @param a first char array to compare
+ * @param alen length of @a
+ * @param aprefixlen length of @a without the file suffix
+ * @param b second char array to compare
+ * @param blen length of @b
+ * @param bprefixlen length of @b without the file suffix
+ *
+ * @return an integer less than, equal to, or greater than zero, if @a is <, == or > than @b.
  */
 int
-filenvercmp (const char *a, ssize_t alen, const char *b, ssize_t blen)
+filenvercmp_prefix (const char *a, ssize_t alen, ssize_t aprefixlen, const char *b, ssize_t blen,
+                    ssize_t bprefixlen)
 {
-    gboolean aempty, bempty;
-    ssize_t aprefixlen, bprefixlen;
     gboolean one_pass_only;
     int result;
 
     // Special case for empty versions.
-    aempty = alen < 0 ? a[0] == '\0' : alen == 0;
-    bempty = blen < 0 ? b[0] == '\0' : blen == 0;
-
-    if (aempty)
-        return (bempty ? 0 : -1);
-    if (bempty)
+    if (alen == 0)
+        return (blen == 0 ? 0 : -1);
+    if (blen == 0)
         return 1;
 
     /* Special cases for leading ".": "." sorts first, then "..", then other names with leading ".",
        then other names. */
     if (a[0] == '.')
     {
-        gboolean adot, bdot;
         gboolean adotdot, bdotdot;
 
         if (b[0] != '.')
             return (-1);
 
-        adot = alen < 0 ? a[1] == '\0' : alen == 1;
-        bdot = blen < 0 ? b[1] == '\0' : blen == 1;
-
-        if (adot)
-            return (bdot ? 0 : -1);
-        if (bdot)
+        if (alen == 1)
+            return (blen == 1 ? 0 : -1);
+        if (blen == 1)
             return 1;
 
-        adotdot = a[1] == '.' && (alen < 0 ? a[2] == '\0' : alen == 2);
-        bdotdot = b[1] == '.' && (blen < 0 ? b[2] == '\0' : blen == 2);
+        adotdot = a[1] == '.' && alen == 2;
+        bdotdot = b[1] == '.' && blen == 2;
         if (adotdot)
             return (bdotdot ? 0 : -1);
         if (bdotdot)
@@ -236,10 +250,6 @@ filenvercmp (const char *a, ssize_t alen, const char *b, ssize_t blen)
     else if (b[0] == '.')
         return 1;
 
-    // Cut file suffixes.
-    aprefixlen = file_prefixlen (a, &alen);
-    bprefixlen = file_prefixlen (b, &blen);
-
     // If both suffixes are empty, a second pass would return the same thing.
     one_pass_only = aprefixlen == alen && bprefixlen == blen;
 
@@ -251,3 +261,26 @@ filenvercmp (const char *a, ssize_t alen, const char *b, ssize_t blen)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+
+/* Compare version strings.
+ *
+ * @param a first string to compare
+ * @param alen length of @a or (-1)
+ * @param b second string to compare
+ * @param blen length of @b or (-1)
+ *
+ * @return an integer less than, equal to, or greater than zero, if @s1 is <, == or > than @s2.
+ */
+int
+filenvercmp (const char *a, ssize_t alen, const char *b, ssize_t blen)
+{
+    ssize_t aprefixlen, bprefixlen;
+
+    // Cut file suffixes; this also replaces negative lengths with the real ones.
+    aprefixlen = file_prefixlen (a, &alen);
+    bprefixlen = file_prefixlen (b, &blen);
+
+    return filenvercmp_prefix (a, alen, aprefixlen, b, blen, bprefixlen);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -107,8 +107,8 @@ static estr_t
 _str_convert (GIConv coder, const char *string, int size, GString *buffer)
 {
     estr_t state = ESTR_SUCCESS;
+    const char *string0;
     gssize left;
-    gsize bytes_read = 0;
     gsize bytes_written = 0;
 
     errno = 0;  // FIXME: is it really needed?
@@ -134,88 +134,63 @@ _str_convert (GIConv coder, const char *string, int size, GString *buffer)
             size = left;
     }
 
+    string0 = string;
     left = size;
     g_iconv (coder, NULL, NULL, NULL, NULL);
 
+    /* convert through a scratch buffer on the stack: the former
+     * g_convert_with_iconv () round trip allocated a temporary result for
+     * every string that was immediately copied into @buffer and freed */
     while (left != 0)
     {
-        gchar *tmp_buff;
-        GError *mcerror = NULL;
-
-        tmp_buff = g_convert_with_iconv ((const gchar *) string, left, coder, &bytes_read,
-                                         &bytes_written, &mcerror);
-        if (mcerror != NULL)
-        {
-            int code = mcerror->code;
-
-            g_error_free (mcerror);
-            mcerror = NULL;
-
-            switch (code)
+        char outbuf[BUF_LARGE];
+        gchar *inptr = (gchar *) string;
+        gchar *outptr = outbuf;
+        gsize inleft = left;
+        gsize outleft = sizeof (outbuf);
+        gboolean failed;
+
+        failed = g_iconv (coder, &inptr, &inleft, &outptr, &outleft) == (gsize) (-1);
+
+        g_string_append_len (buffer, outbuf, outptr - outbuf);
+        bytes_written += outptr - outbuf;
+        string = inptr;
+        left = inleft;
+
+        if (failed)
+            switch (errno)
             {
-            case G_CONVERT_ERROR_NO_CONVERSION:
-                // Conversion between the requested character sets is not supported.
-                g_free (tmp_buff);
-                mc_g_string_append_c_len (buffer, '?', strlen (string));
-                return ESTR_FAILURE;
+            case E2BIG:
+                // Scratch buffer full; the output is flushed, convert the rest.
+                break;
 
-            case G_CONVERT_ERROR_ILLEGAL_SEQUENCE:
+            case EILSEQ:
                 // Invalid byte sequence in conversion input.
-                if ((tmp_buff == NULL) && (bytes_read != 0))
-                    // recode valid byte sequence
-                    tmp_buff = g_convert_with_iconv ((const gchar *) string, bytes_read, coder,
-                                                     NULL, NULL, NULL);
-
-                if (tmp_buff != NULL)
-                {
-                    g_string_append (buffer, tmp_buff);
-                    g_free (tmp_buff);
-                }
-
-                if ((int) bytes_read >= left)
+                if (left == 0)
                     return ESTR_PROBLEM;
 
-                string += bytes_read + 1;
-                size -= (bytes_read + 1);
-                left -= (bytes_read + 1);
-                g_string_append_c (buffer, *(string - 1));
+                // keep the offending byte and resume after it
+                g_string_append_c (buffer, string[0]);
+                string++;
+                left--;
                 state = ESTR_PROBLEM;
                 break;
 
-            case G_CONVERT_ERROR_PARTIAL_INPUT:
+            case EINVAL:
                 // Partial character sequence at end of input.
-                g_string_append (buffer, tmp_buff);
-                g_free (tmp_buff);
-                if ((int) bytes_read < left)
-                    mc_g_string_append_c_len (buffer, '?', left - bytes_read);
+                mc_g_string_append_c_len (buffer, '?', left);
                 return ESTR_PROBLEM;
 
-            case G_CONVERT_ERROR_BAD_URI:            // Don't know how handle this error :(
-            case G_CONVERT_ERROR_NOT_ABSOLUTE_PATH:  // Don't know how handle this error :(
-            case G_CONVERT_ERROR_FAILED:             // Conversion failed for some reason.
             default:
-                g_free (tmp_buff);
                 return ESTR_FAILURE;
             }
-        }
-        else if (tmp_buff == NULL)
-        {
-            g_string_append (buffer, string);
-            return ESTR_PROBLEM;
-        }
-        else if (*tmp_buff == '\0')
-        {
-            g_free (tmp_buff);
-            g_string_append (buffer, string);
-            return state;
-        }
-        else
-        {
-            g_string_append (buffer, tmp_buff);
-            g_free (tmp_buff);
-            string += bytes_read;
-            left -= bytes_read;
-        }
+    }
+
+    if (bytes_written == 0 && size != 0 && state == ESTR_SUCCESS)
+    {
+        // an empty result for a nonempty input: hand the text over unconverted
+        g_string_append_len (buffer, string0, size);
+        return ESTR_PROBLEM;
     }
 
     return state;
@@ -661,6 +636,33 @@ str_term_width1 (const char *text)
 
 /* --------------------------------------------------------------------------------------------- */
 
+int
+str_term_width1_memo (const char *text)
+{
+    /* Widget labels are measured with a full character walk every time a dialog is
+       laid out, although they are the same few hundred translated strings for the
+       whole session and the terminal encoding is fixed at startup.  Remember the
+       widths; the cap only guards against misuse with unbounded dynamic data. */
+    static GHashTable *width_memo = NULL;
+    gpointer value;
+    int width;
+
+    if (width_memo == NULL)
+        width_memo = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    else if (g_hash_table_lookup_extended (width_memo, text, NULL, &value))
+        return GPOINTER_TO_INT (value);
+
+    width = str_term_width1 (text);
+
+    if (g_hash_table_size (width_memo) >= 1024)
+        g_hash_table_remove_all (width_memo);
+    g_hash_table_insert (width_memo, g_strdup (text), GINT_TO_POINTER (width));
+
+    return width;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 int
 str_term_width2 (const char *text, const ssize_t width)
 {
@@ -39,6 +39,19 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Flags of the per-character width class, see str_unichar_class().
+ * UNICHAR_CLASS_FILLED marks a classified table slot: a character that is
+ * neither printable, combining nor wide would be stored as zero otherwise
+ * and could not be told apart from a slot that was never filled */
+#define UNICHAR_CLASS_FILLED (1 << 0)
+#define UNICHAR_CLASS_PRINT (1 << 1)
+#define UNICHAR_CLASS_COMBINING (1 << 2)
+#define UNICHAR_CLASS_WIDE (1 << 3)
+
+#define UNICHAR_CLASS_PAGE_BITS 8
+#define UNICHAR_CLASS_PAGE_SIZE (1 << UNICHAR_CLASS_PAGE_BITS)
+#define UNICHAR_CLASS_PAGES (0x10000 >> UNICHAR_CLASS_PAGE_BITS)
+
 /*** file scope type declarations ****************************************************************/
 
 struct utf8_tool
@@ -63,6 +76,13 @@ struct term_form
 
 static const char replch[] = "\xEF\xBF\xBD";
 
+/* Two-level width class table over the BMP, filled lazily from the GLib
+ * Unicode properties. The paint loops below ask for printability, combining
+ * marks and double width of every character they emit; one table read
+ * replaces those three property lookups. Planes above the BMP are rare in
+ * terminal text and are classified on every call instead */
+static guint8 *unichar_class_pages[UNICHAR_CLASS_PAGES] = { NULL };
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -79,6 +99,57 @@ str_unichar_iscombiningmark (gunichar uni)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static guint8
+str_unichar_class_compute (gunichar uni)
+{
+    guint8 uclass = UNICHAR_CLASS_FILLED;
+
+    if (g_unichar_isprint (uni))
+        uclass |= UNICHAR_CLASS_PRINT;
+    if (str_unichar_iscombiningmark (uni))
+        uclass |= UNICHAR_CLASS_COMBINING;
+    if (g_unichar_iswide (uni))
+        uclass |= UNICHAR_CLASS_WIDE;
+
+    return uclass;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* return combination of UNICHAR_CLASS_* flags for a character */
+
+static guint8
+str_unichar_class (gunichar uni)
+{
+    guint8 *page;
+    guint8 uclass;
+
+    /* ASCII needs no table: the printable range is all there is to know */
+    if (uni < 0x80)
+        return (uni > 0x1F && uni != 0x7F)
+            ? (UNICHAR_CLASS_FILLED | UNICHAR_CLASS_PRINT) : UNICHAR_CLASS_FILLED;
+
+    if (uni >= 0x10000)
+        return str_unichar_class_compute (uni);
+
+    page = unichar_class_pages[uni >> UNICHAR_CLASS_PAGE_BITS];
+    if (page == NULL)
+    {
+        page = g_new0 (guint8, UNICHAR_CLASS_PAGE_SIZE);
+        unichar_class_pages[uni >> UNICHAR_CLASS_PAGE_BITS] = page;
+    }
+
+    uclass = page[uni & (UNICHAR_CLASS_PAGE_SIZE - 1)];
+    if (uclass == 0)
+    {
+        uclass = str_unichar_class_compute (uni);
+        page[uni & (UNICHAR_CLASS_PAGE_SIZE - 1)] = uclass;
+    }
+
+    return uclass;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 str_utf8_insert_replace_char (GString *buffer)
 {
@@ -475,16 +546,18 @@ str_utf8_make_make_term_form (const char *text, const ssize_t width)
         uni = g_utf8_get_char_validated (text, -1);
         if ((uni != (gunichar) (-1)) && (uni != (gunichar) (-2)))
         {
-            if (g_unichar_isprint (uni))
+            const guint8 uclass = str_unichar_class (uni);
+
+            if ((uclass & UNICHAR_CLASS_PRINT) != 0)
             {
                 left = g_unichar_to_utf8 (uni, actual);
                 actual += left;
-                if (str_unichar_iscombiningmark (uni))
+                if ((uclass & UNICHAR_CLASS_COMBINING) != 0)
                     result.compose = TRUE;
                 else
                 {
                     result.width++;
-                    if (g_unichar_iswide (uni))
+                    if ((uclass & UNICHAR_CLASS_WIDE) != 0)
                         result.width++;
                 }
             }
@@ -575,16 +648,18 @@ utf8_tool_copy_chars_to (struct utf8_tool *tool, int to_ident)
     while (tool->checked[0] != '\0')
     {
         gunichar uni;
+        guint8 uclass;
         size_t left;
         int w = 0;
 
         uni = g_utf8_get_char (tool->checked);
-        if (str_unichar_iscombiningmark (uni))
+        uclass = str_unichar_class (uni);
+        if ((uclass & UNICHAR_CLASS_COMBINING) != 0)
             tool->compose = TRUE;
         else
         {
             w = 1;
-            if (g_unichar_iswide (uni))
+            if ((uclass & UNICHAR_CLASS_WIDE) != 0)
                 w++;
             if (tool->ident + w > to_ident)
                 return TRUE;
@@ -646,11 +721,14 @@ utf8_tool_skip_chars_to (struct utf8_tool *tool, int to_ident)
 
     while (to_ident > tool->ident && tool->checked[0] != '\0')
     {
+        guint8 uclass;
+
         uni = g_utf8_get_char (tool->checked);
-        if (!str_unichar_iscombiningmark (uni))
+        uclass = str_unichar_class (uni);
+        if ((uclass & UNICHAR_CLASS_COMBINING) == 0)
         {
             tool->ident++;
-            if (g_unichar_iswide (uni))
+            if ((uclass & UNICHAR_CLASS_WIDE) != 0)
                 tool->ident++;
         }
         tool->checked = g_utf8_next_char (tool->checked);
@@ -824,10 +902,11 @@ str_utf8_term_width1 (const char *text)
 static int
 str_utf8_term_char_width (const char *text)
 {
-    gunichar uni;
+    guint8 uclass;
 
-    uni = g_utf8_get_char_validated (text, -1);
-    return (str_unichar_iscombiningmark (uni)) ? 0 : ((g_unichar_iswide (uni)) ? 2 : 1);
+    uclass = str_unichar_class (g_utf8_get_char_validated (text, -1));
+    return ((uclass & UNICHAR_CLASS_COMBINING) != 0)
+        ? 0 : (((uclass & UNICHAR_CLASS_WIDE) != 0) ? 2 : 1);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -933,12 +1012,14 @@ str_utf8_column_to_pos (const char *text, size_t pos)
         uni = g_utf8_get_char_validated (text, MB_LEN_MAX);
         if ((uni != (gunichar) (-1)) && (uni != (gunichar) (-2)))
         {
-            if (g_unichar_isprint (uni))
+            const guint8 uclass = str_unichar_class (uni);
+
+            if ((uclass & UNICHAR_CLASS_PRINT) != 0)
             {
-                if (!str_unichar_iscombiningmark (uni))
+                if ((uclass & UNICHAR_CLASS_COMBINING) == 0)
                 {
                     width++;
-                    if (g_unichar_iswide (uni))
+                    if ((uclass & UNICHAR_CLASS_WIDE) != 0)
                         width++;
                 }
             }
@@ -965,6 +1046,67 @@ str_utf8_column_to_pos (const char *text, size_t pos)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static gboolean
+str_utf8_is_ascii (const char *text)
+{
+    for (; *text != '\0'; text++)
+        if ((*text & 0x80) != 0)
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Substring search in an ASCII haystack with an ASCII needle.
+ *
+ * Case folding and normalization are no-ops on ASCII, so the match can be done
+ * on the original bytes without allocating a decomposed copy of the text.
+ */
+
+static const char *
+str_utf8_search_ascii (const char *text, const char *search, gboolean case_sen, gboolean find_last)
+{
+    const size_t search_len = strlen (search);
+    const size_t text_len = strlen (text);
+    const char *t;
+    const char *result = NULL;
+
+    if (search_len > text_len)
+        return NULL;
+
+    if (case_sen && !find_last)
+        return strstr (text, search);
+
+    for (t = text; t <= text + text_len - search_len; t++)
+    {
+        if (case_sen)
+        {
+            if (memcmp (t, search, search_len) != 0)
+                continue;
+        }
+        else
+        {
+            size_t i;
+
+            for (i = 0; i < search_len; i++)
+                if (g_ascii_tolower (t[i]) != g_ascii_tolower (search[i]))
+                    break;
+            if (i < search_len)
+                continue;
+        }
+
+        if (!find_last)
+            return t;
+
+        result = t;
+    }
+
+    return result;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static char *
 str_utf8_create_search_needle (const char *needle, gboolean case_sen)
 {
@@ -1001,6 +1143,9 @@ str_utf8_search_first (const char *text, const char *search, gboolean case_sen)
     const char *result = NULL;
     size_t search_len;
 
+    if (str_utf8_is_ascii (text) && str_utf8_is_ascii (search))
+        return str_utf8_search_ascii (text, search, case_sen, FALSE);
+
     if (case_sen)
         deco_text = g_utf8_normalize (text, -1, G_NORMALIZE_ALL);
     else
@@ -1053,6 +1198,9 @@ str_utf8_search_last (const char *text, const char *search, gboolean case_sen)
     const char *result = NULL;
     size_t search_len;
 
+    if (str_utf8_is_ascii (text) && str_utf8_is_ascii (search))
+        return str_utf8_search_ascii (text, search, case_sen, TRUE);
+
     if (case_sen)
         deco_text = g_utf8_normalize (text, -1, G_NORMALIZE_ALL);
     else
@@ -1169,6 +1317,11 @@ str_utf8_casefold_normalize (const char *text)
     const char *start;
     const char *end;
 
+    /* Case folding and normalization of ASCII is plain lowercasing; see the
+     * rationale in str_utf8_normalize () above. */
+    if (str_utf8_is_ascii (text))
+        return g_ascii_strdown (text, -1);
+
     fixed = g_string_sized_new (4);
 
     start = text;
@@ -0,0 +1,158 @@
+/*
+   Compiled-in trace points around the hot paths.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file trace.c
+ *  \brief Source: compiled-in trace points around the hot paths
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#endif
+
+#include "lib/global.h"
+#include "lib/mcconfig.h"
+
+#include "trace.h"
+
+/*** global variables ****************************************************************************/
+
+gboolean mc_trace_active = FALSE;
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* kept open while tracing is active: points are emitted far too often for an
+ * open/write/close cycle per line, unlike mc_log() */
+static FILE *trace_file = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+get_trace_filename (void)
+{
+    const char *env_filename;
+
+    env_filename = g_getenv ("MC_TRACE_FILE");
+    if (env_filename != NULL)
+        return g_strdup (env_filename);
+
+    return mc_config_get_full_path ("mc.trace");
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+trace_open (void)
+{
+    char *filename;
+
+    filename = get_trace_filename ();
+    if (filename != NULL)
+    {
+        trace_file = fopen (filename, "a");
+        g_free (filename);
+    }
+
+    mc_trace_active = (trace_file != NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+trace_close (void)
+{
+    mc_trace_active = FALSE;
+
+    if (trace_file != NULL)
+    {
+        (void) fclose (trace_file);
+        trace_file = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_trace_init (void)
+{
+    const char *env_is_enabled;
+
+    env_is_enabled = g_getenv ("MC_TRACE_ENABLE");
+    if (env_is_enabled != NULL
+        && (*env_is_enabled == '1' || g_ascii_strcasecmp (env_is_enabled, "true") == 0))
+        trace_open ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_trace_deinit (void)
+{
+    trace_close ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_trace_toggle (void)
+{
+    if (mc_trace_active)
+        trace_close ();
+    else
+        trace_open ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Write one trace record.  Called via mc_trace_end(), i.e. only when tracing
+ * was active when the point was opened.
+ *
+ * @param point name of the trace point
+ * @param duration_us wall time spent in the traced operation
+ * @param size operation payload: bytes copied, entries loaded, ... (0 if n/a)
+ */
+void
+mc_trace_emit (const char *point, gint64 duration_us, guint64 size)
+{
+#ifdef HAVE_SYS_SDT_H
+    DTRACE_PROBE3 (mc, hot_path, point, duration_us, size);
+#endif
+
+    if (trace_file != NULL)
+        fprintf (trace_file, "%" G_GINT64_FORMAT " %s %" G_GINT64_FORMAT " %" G_GUINT64_FORMAT "\n",
+                 g_get_monotonic_time (), point, duration_us, size);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,54 @@
+/** \file trace.h
+ *  \brief Header: compiled-in trace points around the hot paths
+ */
+
+#ifndef MC_TRACE_H
+#define MC_TRACE_H
+
+/*
+   Trace points record the duration and payload size of expensive operations
+   (directory load, file copy, search, VFS open, repaint) into a trace file.
+   They cost one branch when tracing is off; tracing is toggled at runtime by
+   raising the Core/trace_toggle event or via the MC_TRACE_ENABLE environment
+   variable.  On hosts with <sys/sdt.h> every emitted point also fires the
+   "mc:hot_path" USDT probe for perf/bpftrace.
+ */
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+extern gboolean mc_trace_active;
+
+/*** declarations of public functions ************************************************************/
+
+void mc_trace_init (void);
+void mc_trace_deinit (void);
+void mc_trace_toggle (void);
+void mc_trace_emit (const char *point, gint64 duration_us, guint64 size);
+
+/*** inline functions ****************************************************************************/
+
+/** Start timing a trace point; returns 0 (= "don't emit") when tracing is off. */
+static inline gint64
+mc_trace_begin (void)
+{
+    return mc_trace_active ? g_get_monotonic_time () : 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Finish timing: emit the point opened by mc_trace_begin(), if any. */
+static inline void
+mc_trace_end (const char *point, gint64 start, guint64 size)
+{
+    if (start != 0)
+        mc_trace_emit (point, g_get_monotonic_time () - start, size);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#endif
@@ -90,30 +90,42 @@ tty_color_free_temp_cb (gpointer key, gpointer value, gpointer user_data)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static gboolean
-tty_color_get_next_cpn_cb (gpointer key, gpointer value, gpointer user_data)
+static void
+tty_color_mark_used_cpn_cb (gpointer key, gpointer value, gpointer user_data)
 {
     tty_color_lib_pair_t *mc_color_pair = (tty_color_lib_pair_t *) value;
-    size_t cp = GPOINTER_TO_SIZE (user_data);
+    gboolean *used = (gboolean *) user_data;
 
     (void) key;
 
-    return (cp == mc_color_pair->pair_index);
+    // indexes at or past the table size cannot shadow a smaller free one
+    if (mc_color_pair->pair_index < g_hash_table_size (mc_tty_color__hashtable))
+        used[mc_color_pair->pair_index] = TRUE;
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Get the smallest pair number not used by any allocated pair.
+ *
+ * With n pairs there is always a free index in 0..n, so one marking pass over the
+ * hash is enough; probing each candidate index with a full hash scan made every
+ * allocation quadratic, which added up over a skin plus syntax highlighting.
+ */
 
 static size_t
 tty_color_get_next__color_pair_number (void)
 {
     size_t cp_count, cp;
+    gboolean *used;
 
     cp_count = g_hash_table_size (mc_tty_color__hashtable);
-    for (cp = 0; cp < cp_count; cp++)
-        if (g_hash_table_find (mc_tty_color__hashtable, tty_color_get_next_cpn_cb,
-                               GSIZE_TO_POINTER (cp))
-            == NULL)
-            break;
+    used = g_new0 (gboolean, cp_count + 1);
+    g_hash_table_foreach (mc_tty_color__hashtable, tty_color_mark_used_cpn_cb, used);
+
+    for (cp = 0; cp < cp_count && used[cp]; cp++)
+        ;
+
+    g_free (used);
 
     return cp;
 }
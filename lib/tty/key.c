@@ -224,6 +224,9 @@ const key_code_name_t key_name_conv_tab[] = {
 /* The maximum sequence length (32 + null terminator) */
 #define SEQ_BUFFER_LEN 33
 
+/* Decoded key codes queued during a paste burst (see key_ring_fill()) */
+#define KEY_RING_LEN 256
+
 /*** file scope type declarations ****************************************************************/
 
 /* Linux console keyboard modifiers */
@@ -276,6 +279,8 @@ typedef int (*ph_pqc_f) (unsigned short, PhCursorInfo_t *);
 
 /*** forward declarations (file scope functions) *************************************************/
 
+static int tty_get_event_real (struct Gpm_Event *event, gboolean redo_event, gboolean block);
+
 /*** file scope variables ************************************************************************/
 
 static key_define_t mc_default_keys[] = {
@@ -537,6 +542,26 @@ static int *seq_append = NULL;
 
 static int *pending_keys = NULL;
 
+/* Fixed ring of already-decoded key codes. During a bracketed paste the whole
+   buffered burst is decoded in one go, so the per-event select()/repaint
+   machinery in tty_get_event_real() runs once per burst instead of once per
+   pasted character; nothing on this path allocates. */
+static int key_ring[KEY_RING_LEN];
+static guint key_ring_head = 0;  // next slot to read
+static guint key_ring_tail = 0;  // next slot to write
+
+/* a paste marker that ended the drain, acted upon once the ring is empty */
+static int key_ring_marker = 0;
+static Gpm_Event key_ring_mouse;  // decoded payload when the drain hit a mouse code
+static gboolean key_ring_mouse_ready = FALSE;
+
+/* Input event recording and replay (MC_INPUT_RECORD / MC_INPUT_REPLAY), see tty_get_event() */
+static FILE *input_record_file = NULL;
+static FILE *input_replay_file = NULL;
+static gint64 input_record_prev_us = 0;
+static gint64 input_replay_start_us = 0;
+static guint64 input_replay_events = 0;
+
 #ifdef __QNXNTO__
 ph_dv_f ph_attach;
 ph_ov_f ph_input_group;
@@ -880,6 +905,58 @@ xmouse_get_event (Gpm_Event *ev, gboolean extended)
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Batch-decode a bracketed paste burst into the key ring.
+ *
+ * Called after the first pasted key has been read the usual way: every further
+ * key already buffered in the terminal is decoded now, and tty_get_event_real()
+ * hands them out one by one without going back to select(). A mouse code or a
+ * paste marker ends the drain and is parked: the mouse payload has to be
+ * consumed immediately, but neither may take effect while pasted keys are still
+ * queued, so both are delivered only once the ring is empty.
+ */
+
+static void
+key_ring_fill (void)
+{
+    key_ring_head = 0;
+    key_ring_tail = 0;
+
+    while (key_ring_tail < KEY_RING_LEN)
+    {
+        int c;
+
+        c = get_key_code (1);
+        if (c < 0)
+            break;
+
+        if (c == MCKEY_MOUSE || c == MCKEY_EXTENDED_MOUSE
+#ifdef KEY_MOUSE
+            || c == KEY_MOUSE
+#endif
+        )
+        {
+            gboolean extended = c == MCKEY_EXTENDED_MOUSE;
+
+#ifdef KEY_MOUSE
+            extended = extended || (c == KEY_MOUSE && ncurses_key_mouse_means_extended);
+#endif
+            xmouse_get_event (&key_ring_mouse, extended);
+            key_ring_mouse_ready = TRUE;
+            break;
+        }
+
+        if (c == MCKEY_BRACKETED_PASTING_START || c == MCKEY_BRACKETED_PASTING_END)
+        {
+            key_ring_marker = c;
+            break;
+        }
+
+        key_ring[key_ring_tail++] = c;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Get modifier state (shift, alt, ctrl) for the last key pressed.
@@ -1313,6 +1390,7 @@ void
 init_key (void)
 {
     const char *term;
+    const char *env;
 
     term = getenv ("TERM");
 
@@ -1338,6 +1416,18 @@ init_key (void)
        if we are running under the qansi-m terminal */
     if (term != NULL && (strncmp (term, "qansi-m", 7) == 0))
         define_sequences (qansi_key_defines);
+
+    // optional input event recording/replay for profiling, see tty_get_event()
+    env = getenv ("MC_INPUT_RECORD");
+    if (env != NULL && *env != '\0')
+    {
+        input_record_file = fopen (env, "w");
+        input_record_prev_us = g_get_monotonic_time ();
+    }
+
+    env = getenv ("MC_INPUT_REPLAY");
+    if (env != NULL && *env != '\0')
+        input_replay_file = fopen (env, "r");
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1361,6 +1451,18 @@ done_key (void)
     k_dispose (keys);
     g_slist_free_full (select_list, g_free);
 
+    if (input_record_file != NULL)
+    {
+        fclose (input_record_file);
+        input_record_file = NULL;
+    }
+
+    if (input_replay_file != NULL)
+    {
+        fclose (input_replay_file);
+        input_replay_file = NULL;
+    }
+
 #ifdef HAVE_TEXTMODE_X11_SUPPORT
     if (x11_display)
         mc_XCloseDisplay (x11_display);
@@ -1868,13 +1970,10 @@ done:
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/* Returns a character read from stdin with appropriate interpretation */
-/* Also takes care of generated mouse events */
-/* Returns EV_MOUSE if it is a mouse event */
-/* Returns EV_NONE  if non-blocking or interrupt set and nothing was done */
+/** Live part of tty_get_event(): reads from stdin and the mouse. */
 
-int
-tty_get_event (struct Gpm_Event *event, gboolean redo_event, gboolean block)
+static int
+tty_get_event_real (struct Gpm_Event *event, gboolean redo_event, gboolean block)
 {
     int c;
     int flag = 0;  // Return value from select
@@ -1885,6 +1984,24 @@ tty_get_event (struct Gpm_Event *event, gboolean redo_event, gboolean block)
     struct timeval *time_addr = NULL;
     static int dirty = 3;
 
+    // a paste burst is being handed out: no select(), no repaint, no allocation
+    if (key_ring_head != key_ring_tail)
+        return key_ring[key_ring_head++];
+
+    if (key_ring_mouse_ready)
+    {
+        key_ring_mouse_ready = FALSE;
+        *event = key_ring_mouse;
+        return key_ring_mouse.type != 0 ? EV_MOUSE : EV_NONE;
+    }
+
+    if (key_ring_marker != 0)
+    {
+        bracketed_pasting_in_progress = key_ring_marker == MCKEY_BRACKETED_PASTING_START;
+        key_ring_marker = 0;
+        return EV_NONE;
+    }
+
     if ((dirty == 3) || is_idle ())
     {
         mc_refresh ();
@@ -2086,6 +2203,84 @@ tty_get_event (struct Gpm_Event *event, gboolean redo_event, gboolean block)
         bracketed_pasting_in_progress = FALSE;
         c = EV_NONE;
     }
+    else if (c > 0 && bracketed_pasting_in_progress)
+        key_ring_fill ();  // decode the rest of the burst while it is hot
+
+    return c;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* Returns a character read from stdin with appropriate interpretation */
+/* Also takes care of generated mouse events */
+/* Returns EV_MOUSE if it is a mouse event */
+/* Returns EV_NONE  if non-blocking or interrupt set and nothing was done */
+/*
+ * With MC_INPUT_RECORD set, every delivered event is appended to the named file together
+ * with the time elapsed since the previous one.  With MC_INPUT_REPLAY set, events are fed
+ * back from such a file at full speed instead of reading the terminal; the screen is still
+ * repainted between events so that painting stays part of the measured work, and the total
+ * elapsed time is printed to stderr when the recording runs out.
+ */
+
+int
+tty_get_event (struct Gpm_Event *event, gboolean redo_event, gboolean block)
+{
+    int c;
+
+    if (input_replay_file != NULL)
+    {
+        gint64 delta_us;
+        int type, x, y, buttons;
+
+        if (input_replay_start_us == 0)
+            input_replay_start_us = g_get_monotonic_time ();
+
+        // repaint between events as the interactive loop would
+        mc_refresh ();
+
+        if (fscanf (input_replay_file, "%" G_GINT64_FORMAT " %d %d %d %d %d", &delta_us, &c, &type,
+                    &x, &y, &buttons)
+            == 6)
+        {
+            input_replay_events++;
+
+            if (c == EV_MOUSE)
+            {
+                event->type = type;
+                event->x = x;
+                event->y = y;
+                event->buttons = buttons;
+            }
+
+            return c;
+        }
+
+        // end of the recording: report the end-to-end time and fall back to live input
+        fclose (input_replay_file);
+        input_replay_file = NULL;
+        fprintf (stderr, "mc: replayed %" G_GUINT64_FORMAT " input events in %.3f s\n",
+                 input_replay_events,
+                 (double) (g_get_monotonic_time () - input_replay_start_us) / G_USEC_PER_SEC);
+    }
+
+    c = tty_get_event_real (event, redo_event, block);
+
+    if (input_record_file != NULL && c != EV_NONE)
+    {
+        const gint64 now_us = g_get_monotonic_time ();
+
+        if (c == EV_MOUSE)
+            fprintf (input_record_file, "%" G_GINT64_FORMAT " %d %d %d %d %d\n",
+                     now_us - input_record_prev_us, c, (int) event->type, event->x, event->y,
+                     event->buttons);
+        else
+            fprintf (input_record_file, "%" G_GINT64_FORMAT " %d 0 0 0 0\n",
+                     now_us - input_record_prev_us, c);
+
+        // keep the recording complete even if the session ends abnormally
+        fflush (input_record_file);
+        input_record_prev_us = now_us;
+    }
 
     return c;
 }
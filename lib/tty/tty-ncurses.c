@@ -75,6 +75,13 @@
 
 /*** file scope type declarations ****************************************************************/
 
+/* whole-screen snapshot handed out by tty_screen_save() */
+typedef struct
+{
+    int lines, cols;  // screen size the snapshot was taken at
+    WINDOW *win;      // copy of stdscr
+} tty_screen_snapshot_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -766,12 +773,60 @@ tty_tigetstr (const char *terminfo_cap, MC_UNUSED const char *termcap_cap)
 void
 tty_refresh (void)
 {
-    refresh ();
+    /* refresh() is wnoutrefresh(stdscr) + doupdate(); spell it out instead of following it
+     * with a second doupdate() that walks the screen again for nothing */
+    wnoutrefresh (stdscr);
     doupdate ();
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
+void *
+tty_screen_save (void)
+{
+    tty_screen_snapshot_t *snap;
+    WINDOW *win;
+
+    win = dupwin (stdscr);
+    if (win == NULL)
+        return NULL;
+
+    snap = g_new (tty_screen_snapshot_t, 1);
+    snap->lines = LINES;
+    snap->cols = COLS;
+    snap->win = win;
+    return snap;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+gboolean
+tty_screen_restore (void *snapshot)
+{
+    tty_screen_snapshot_t *snap = (tty_screen_snapshot_t *) snapshot;
+
+    if (snap == NULL || snap->lines != LINES || snap->cols != COLS)
+        return FALSE;
+
+    return overwrite (snap->win, stdscr) != ERR;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+tty_screen_free (void *snapshot)
+{
+    tty_screen_snapshot_t *snap = (tty_screen_snapshot_t *) snapshot;
+
+    if (snap != NULL)
+    {
+        delwin (snap->win);
+        g_free (snap);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 void
 tty_beep (void)
 {
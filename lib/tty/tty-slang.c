@@ -74,6 +74,13 @@ int reset_hp_softkeys = 0;
 
 /*** file scope type declarations ****************************************************************/
 
+/* whole-screen snapshot handed out by tty_screen_save() */
+typedef struct
+{
+    int lines, cols;         // screen size the snapshot was taken at
+    SLsmg_Char_Type *cells;  // lines x cols cell matrix
+} tty_screen_snapshot_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -796,6 +803,62 @@ tty_refresh (void)
 
 /* --------------------------------------------------------------------------------------------- */
 
+void *
+tty_screen_save (void)
+{
+    tty_screen_snapshot_t *snap;
+    int y;
+
+    snap = g_new (tty_screen_snapshot_t, 1);
+    snap->lines = LINES;
+    snap->cols = COLS;
+    snap->cells = g_new (SLsmg_Char_Type, (size_t) LINES * COLS);
+
+    for (y = 0; y < snap->lines; y++)
+    {
+        SLsmg_gotorc (y, 0);
+        SLsmg_read_raw (snap->cells + (size_t) y * snap->cols, (unsigned int) snap->cols);
+    }
+
+    return snap;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+gboolean
+tty_screen_restore (void *snapshot)
+{
+    tty_screen_snapshot_t *snap = (tty_screen_snapshot_t *) snapshot;
+    int y;
+
+    if (snap == NULL || snap->lines != LINES || snap->cols != COLS)
+        return FALSE;
+
+    for (y = 0; y < snap->lines; y++)
+    {
+        SLsmg_gotorc (y, 0);
+        SLsmg_write_raw (snap->cells + (size_t) y * snap->cols, (unsigned int) snap->cols);
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+tty_screen_free (void *snapshot)
+{
+    tty_screen_snapshot_t *snap = (tty_screen_snapshot_t *) snapshot;
+
+    if (snap != NULL)
+    {
+        g_free (snap->cells);
+        g_free (snap);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 void
 tty_beep (void)
 {
@@ -133,6 +133,14 @@ extern int tty_resize (int fd);
 extern void tty_refresh (void);
 extern void tty_change_screen_size (void);
 
+/* Snapshot of the whole virtual screen (the drawing buffer, not the terminal).
+   Dialog switching parks the image of a suspended screen and puts it back in
+   one write instead of repainting the widget tree. The handle is opaque:
+   each backend keeps its own cell representation. */
+extern void *tty_screen_save (void);
+extern gboolean tty_screen_restore (void *snapshot);  // FALSE: size mismatch, repaint instead
+extern void tty_screen_free (void *snapshot);
+
 /* Clear screen */
 extern void tty_clear_screen (void);
 
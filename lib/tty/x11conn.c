@@ -27,11 +27,18 @@
  *  \brief Source: X11 support
  *  \warning This code uses setjmp() and longjmp(). Before you modify _anything_ here,
  *  please read the relevant sections of the C standard.
+ *
+ *  All Xlib calls are executed on a private helper thread and the public
+ *  wrappers wait for the result with a deadline, so a DISPLAY pointing at a
+ *  dead forwarder stalls the helper instead of the UI. The jmp_buf below is
+ *  touched only from that thread.
  */
 
 #include <config.h>
 
 #include <setjmp.h>
+#include <string.h>
+
 #include <X11/Xlib.h>
 #ifdef HAVE_GMODULE
 #include <gmodule.h>
@@ -52,11 +59,39 @@
 #define func_XQueryPointer      XQueryPointer
 #endif
 
+/* how long the UI is willing to wait for the display connect */
+#define X11_OPEN_TIMEOUT (2 * G_USEC_PER_SEC)
+/* any other round trip; queries run per keypress, a healthy server answers instantly */
+#define X11_CALL_TIMEOUT (G_USEC_PER_SEC / 10)
+
 /*** file scope type declarations ****************************************************************/
 
 typedef int (*mc_XErrorHandler_callback) (Display *, XErrorEvent *);
 typedef int (*mc_XIOErrorHandler_callback) (Display *);
 
+typedef enum
+{
+    X11_REQ_NONE = 0,
+    X11_REQ_OPEN,
+    X11_REQ_QUERY,
+    X11_REQ_CLOSE  // the helper thread exits after serving this one
+} x11_req_type_t;
+
+/* one in-flight request at a time; both the arguments and the results live here */
+typedef struct
+{
+    x11_req_type_t type;
+    const char *displayname;  // X11_REQ_OPEN in
+    Display *display;         // X11_REQ_OPEN out, X11_REQ_QUERY/X11_REQ_CLOSE in
+    Window win;               // X11_REQ_QUERY in
+    Window root, child;       // X11_REQ_QUERY out ...
+    int root_x, root_y;
+    int win_x, win_y;
+    unsigned int mask;
+    Bool bool_result;
+    int int_result;
+} x11_req_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -82,6 +117,16 @@ static gboolean lost_connection = FALSE;
 static jmp_buf x11_exception;  // FIXME: get a better name
 static gboolean longjmp_allowed = FALSE;
 
+/* request hand-off between the UI and the helper thread */
+static GMutex x11_lock;
+static GCond x11_cond;
+static x11_req_t x11_req;
+static gboolean x11_pending = FALSE;    // a request has been submitted
+static gboolean x11_inflight = FALSE;   // the helper is executing it
+static gboolean x11_done = FALSE;       // results are ready to be consumed
+static gboolean x11_abandoned = FALSE;  // the submitter timed out and left
+static gboolean x11_thread_running = FALSE;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -172,50 +217,204 @@ cleanup:
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/*** public functions ****************************************************************************/
-/* --------------------------------------------------------------------------------------------- */
+/** Execute one Xlib request. Runs on the helper thread (or on the caller when
+ * no thread could be created); this is the only place the jmp_buf is armed. */
 
-Display *
-mc_XOpenDisplay (const char *displayname)
+static void
+x11_execute (x11_req_t *req)
 {
-    if (x11_available ())
+    switch (req->type)
     {
+    case X11_REQ_OPEN:
+        req->display = NULL;
         if (setjmp (x11_exception) == 0)
         {
-            Display *retval;
-
             longjmp_allowed = TRUE;
+            req->display = func_XOpenDisplay (req->displayname);
+            longjmp_allowed = FALSE;
+        }
+        break;
 
-            retval = func_XOpenDisplay (displayname);
+    case X11_REQ_QUERY:
+        req->bool_result = False;
+        if (setjmp (x11_exception) == 0)
+        {
+            longjmp_allowed = TRUE;
+            req->bool_result =
+                func_XQueryPointer (req->display, req->win, &req->root, &req->child, &req->root_x,
+                                    &req->root_y, &req->win_x, &req->win_y, &req->mask);
+            longjmp_allowed = FALSE;
+        }
+        break;
 
+    case X11_REQ_CLOSE:
+        req->int_result = 0;
+        if (setjmp (x11_exception) == 0)
+        {
+            longjmp_allowed = TRUE;
+            req->int_result = func_XCloseDisplay (req->display);
             longjmp_allowed = FALSE;
-            return retval;
         }
+        break;
+
+    default:
+        break;
     }
-    return NULL;
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
-int
-mc_XCloseDisplay (Display *display)
+static gpointer
+x11_thread (gpointer data)
 {
-    if (x11_available ())
+    (void) data;
+
+    g_mutex_lock (&x11_lock);
+
+    while (TRUE)
     {
-        if (setjmp (x11_exception) == 0)
+        x11_req_t req;
+        gboolean quit;
+
+        while (!x11_pending)
+            g_cond_wait (&x11_cond, &x11_lock);
+
+        x11_pending = FALSE;
+        x11_inflight = TRUE;
+        req = x11_req;
+        g_mutex_unlock (&x11_lock);
+
+        x11_execute (&req);
+
+        g_mutex_lock (&x11_lock);
+        x11_inflight = FALSE;
+        quit = (req.type == X11_REQ_CLOSE);
+
+        if (x11_abandoned)
         {
-            int retval;
+            /* nobody is waiting for these results anymore; a display that
+             * connected after the UI gave up would only leak - drop it */
+            if (req.type == X11_REQ_OPEN && req.display != NULL)
+                (void) func_XCloseDisplay (req.display);
+        }
+        else
+        {
+            x11_req = req;
+            x11_done = TRUE;
+            g_cond_broadcast (&x11_cond);
+        }
 
-            longjmp_allowed = TRUE;
+        if (quit)
+            break;
+    }
 
-            retval = func_XCloseDisplay (display);
+    x11_thread_running = FALSE;
+    g_mutex_unlock (&x11_lock);
 
-            longjmp_allowed = FALSE;
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Hand @req to the helper thread and wait at most @timeout for the answer.
+ * Returns TRUE and fills @req with the results on success; FALSE when the
+ * helper is still busy with an earlier (stuck) call or the deadline passed,
+ * in which case the caller must treat the call as failed. */
+
+static gboolean
+x11_submit (x11_req_t *req, gint64 timeout)
+{
+    gint64 deadline;
+    gboolean ok = TRUE;
+
+    g_mutex_lock (&x11_lock);
+
+    if (x11_pending || x11_inflight)
+    {
+        // an earlier call is still stuck in Xlib; don't pile up behind it
+        g_mutex_unlock (&x11_lock);
+        return FALSE;
+    }
 
-            return retval;
+    if (!x11_thread_running)
+    {
+        GThread *th;
+
+        th = g_thread_try_new ("x11", x11_thread, NULL, NULL);
+        if (th == NULL)
+        {
+            // no thread - execute synchronously, like the old code did
+            g_mutex_unlock (&x11_lock);
+            x11_execute (req);
+            return TRUE;
         }
+
+        x11_thread_running = TRUE;
+        g_thread_unref (th);
     }
-    return 0;
+
+    x11_req = *req;
+    x11_pending = TRUE;
+    x11_done = FALSE;
+    x11_abandoned = FALSE;
+    g_cond_broadcast (&x11_cond);
+
+    deadline = g_get_monotonic_time () + timeout;
+    while (!x11_done && ok)
+        ok = g_cond_wait_until (&x11_cond, &x11_lock, deadline);
+
+    if (x11_done)
+    {
+        *req = x11_req;
+        x11_done = FALSE;
+        ok = TRUE;
+    }
+    else
+        x11_abandoned = TRUE;
+
+    g_mutex_unlock (&x11_lock);
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+Display *
+mc_XOpenDisplay (const char *displayname)
+{
+    x11_req_t req;
+
+    if (!x11_available ())
+        return NULL;
+
+    memset (&req, 0, sizeof (req));
+    req.type = X11_REQ_OPEN;
+    req.displayname = displayname;
+
+    if (!x11_submit (&req, X11_OPEN_TIMEOUT))
+        return NULL;
+
+    return req.display;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+mc_XCloseDisplay (Display *display)
+{
+    x11_req_t req;
+
+    if (!x11_available ())
+        return 0;
+
+    memset (&req, 0, sizeof (req));
+    req.type = X11_REQ_CLOSE;
+    req.display = display;
+
+    if (!x11_submit (&req, X11_OPEN_TIMEOUT))
+        return 0;
+
+    return req.int_result;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -225,20 +424,25 @@ mc_XQueryPointer (Display *display, Window win, Window *root_return, Window *chi
                   int *root_x_return, int *root_y_return, int *win_x_return, int *win_y_return,
                   unsigned int *mask_return)
 {
-    Bool retval;
+    x11_req_t req;
 
     if (x11_available ())
     {
-        if (setjmp (x11_exception) == 0)
-        {
-            longjmp_allowed = TRUE;
-
-            retval = func_XQueryPointer (display, win, root_return, child_return, root_x_return,
-                                         root_y_return, win_x_return, win_y_return, mask_return);
+        memset (&req, 0, sizeof (req));
+        req.type = X11_REQ_QUERY;
+        req.display = display;
+        req.win = win;
 
-            longjmp_allowed = FALSE;
-
-            return retval;
+        if (x11_submit (&req, X11_CALL_TIMEOUT) && req.bool_result != False)
+        {
+            *root_return = req.root;
+            *child_return = req.child;
+            *root_x_return = req.root_x;
+            *root_y_return = req.root_y;
+            *win_x_return = req.win_x;
+            *win_y_return = req.win_y;
+            *mask_return = req.mask;
+            return req.bool_result;
         }
     }
     *root_return = None;
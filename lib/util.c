@@ -844,6 +844,43 @@ decompress_extension (int type)
     return 0;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Shell command that decompresses the given format from stdin to stdout,
+ * for streaming a compressed file instead of materializing it through
+ * decompress_extension(). The tools and flags match those in sfs.ini.
+ *
+ * Returns NULL for formats that are not a plain stream (zip archives).
+ */
+
+const char *
+decompress_command (int type)
+{
+    switch (type)
+    {
+    case COMPRESSION_GZIP:
+        return "gzip -cdf";
+    case COMPRESSION_BZIP:
+        return "bzip -d";
+    case COMPRESSION_BZIP2:
+        return "bzip2 -d";
+    case COMPRESSION_LZIP:
+        return "lzip -d";
+    case COMPRESSION_LZ4:
+        return "lz4 -d";
+    case COMPRESSION_LZMA:
+        return "lzma -d";
+    case COMPRESSION_LZO:
+        return "lzop -d";
+    case COMPRESSION_XZ:
+        return "xz -d";
+    case COMPRESSION_ZSTD:
+        return "zstd -d";
+    default:
+        return NULL;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
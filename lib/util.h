@@ -249,6 +249,7 @@ char *mc_realpath (const char *path, char *resolved_path);
  * compression type. Side effect: modifies the file position. */
 enum compression_type get_compression_type (int fd, const char *name);
 const char *decompress_extension (int type);
+const char *decompress_command (int type);
 
 GList *list_append_unique (GList *list, char *text);
 
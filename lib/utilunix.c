@@ -76,6 +76,11 @@ struct sigaction startup_handler;
 #define UID_CACHE_SIZE 200
 #define GID_CACHE_SIZE 30
 
+#define UID_NCACHE_SIZE 16
+#define GID_NCACHE_SIZE 16
+/* how long (seconds) a failed id lookup is believed */
+#define I_NCACHE_TTL 60
+
 /*** file scope type declarations ****************************************************************/
 
 typedef struct
@@ -84,6 +89,14 @@ typedef struct
     char *string;
 } int_cache;
 
+/* expiring entry of the negative id->name cache; text[0] == '\0' means unused */
+typedef struct
+{
+    int index;
+    time_t when;
+    char text[12];
+} i_neg_cache;
+
 typedef enum
 {
     FORK_ERROR = -1,
@@ -105,10 +118,46 @@ typedef struct
 static int_cache uid_cache[UID_CACHE_SIZE];
 static int_cache gid_cache[GID_CACHE_SIZE];
 
+/* Negative cache for ids that have no name. Without it every failed getpwuid()/
+   getgrgid() is retried on each repaint, which stalls the panel for hundreds of
+   milliseconds per unique id on NSS backends like LDAP. Entries expire so a user
+   created later still shows up by name. */
+static i_neg_cache uid_ncache[UID_NCACHE_SIZE];
+static i_neg_cache gid_ncache[GID_NCACHE_SIZE];
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static const char *
+i_neg_cache_match (int id, i_neg_cache *cache, int size)
+{
+    const time_t now = time (NULL);
+    int i;
+
+    for (i = 0; i < size; i++)
+        if (cache[i].text[0] != '\0' && cache[i].index == id && now - cache[i].when < I_NCACHE_TTL)
+            return cache[i].text;
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static const char *
+i_neg_cache_add (int id, i_neg_cache *cache, int size, int *last)
+{
+    i_neg_cache *ce = &cache[*last];
+
+    ce->index = id;
+    ce->when = time (NULL);
+    g_snprintf (ce->text, sizeof (ce->text), "%d", id);
+    *last = ((*last) + 1) % size;
+
+    return ce->text;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static char *
 i_cache_match (int id, int_cache *cache, int size)
 {
@@ -275,18 +324,23 @@ get_owner (uid_t uid)
     if (name != NULL)
         return name;
 
-    pwd = getpwuid (uid);
-    if (pwd != NULL)
     {
-        i_cache_add ((int) uid, uid_cache, UID_CACHE_SIZE, pwd->pw_name, (int *) &uid_last);
-        return pwd->pw_name;
-    }
-    else
-    {
-        static char ibuf[10];
+        static int uid_nlast = 0;
+        const char *num;
+
+        // a recent lookup already failed - show the numeric id without asking NSS again
+        num = i_neg_cache_match ((int) uid, uid_ncache, UID_NCACHE_SIZE);
+        if (num != NULL)
+            return num;
+
+        pwd = getpwuid (uid);
+        if (pwd != NULL)
+        {
+            i_cache_add ((int) uid, uid_cache, UID_CACHE_SIZE, pwd->pw_name, (int *) &uid_last);
+            return pwd->pw_name;
+        }
 
-        g_snprintf (ibuf, sizeof (ibuf), "%d", (int) uid);
-        return ibuf;
+        return i_neg_cache_add ((int) uid, uid_ncache, UID_NCACHE_SIZE, &uid_nlast);
     }
 }
 
@@ -303,18 +357,23 @@ get_group (gid_t gid)
     if (name != NULL)
         return name;
 
-    grp = getgrgid (gid);
-    if (grp != NULL)
-    {
-        i_cache_add ((int) gid, gid_cache, GID_CACHE_SIZE, grp->gr_name, (int *) &gid_last);
-        return grp->gr_name;
-    }
-    else
     {
-        static char gbuf[10];
+        static int gid_nlast = 0;
+        const char *num;
+
+        // a recent lookup already failed - show the numeric id without asking NSS again
+        num = i_neg_cache_match ((int) gid, gid_ncache, GID_NCACHE_SIZE);
+        if (num != NULL)
+            return num;
+
+        grp = getgrgid (gid);
+        if (grp != NULL)
+        {
+            i_cache_add ((int) gid, gid_cache, GID_CACHE_SIZE, grp->gr_name, (int *) &gid_last);
+            return grp->gr_name;
+        }
 
-        g_snprintf (gbuf, sizeof (gbuf), "%d", (int) gid);
-        return gbuf;
+        return i_neg_cache_add ((int) gid, gid_ncache, GID_NCACHE_SIZE, &gid_nlast);
     }
 }
 
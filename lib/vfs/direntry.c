@@ -70,7 +70,8 @@
 #include "lib/global.h"
 
 #include "lib/tty/tty.h"  // enable/disable interrupt key
-#include "lib/util.h"     // canonicalize_pathname_custom()
+#include "lib/trace.h"
+#include "lib/util.h"  // canonicalize_pathname_custom()
 #if 0
 #include "lib/widget.h"  // message()
 #endif
@@ -188,7 +189,7 @@ vfs_s_find_entry_tree (struct vfs_class *me, struct vfs_s_inode *root, const cha
 
     while (root != NULL)
     {
-        GList *iter;
+        char c;
 
         while (IS_PATH_SEP (*path)) /* Strip leading '/' */
             path++;
@@ -202,15 +203,11 @@ vfs_s_find_entry_tree (struct vfs_class *me, struct vfs_s_inode *root, const cha
         for (pseg = 0; path[pseg] != '\0' && !IS_PATH_SEP (path[pseg]); pseg++)
             ;
 
-        for (iter = g_queue_peek_head_link (root->subdir); iter != NULL; iter = g_list_next (iter))
-        {
-            ent = VFS_ENTRY (iter->data);
-            if (strlen (ent->name) == pseg && strncmp (ent->name, path, pseg) == 0)
-                // FOUND!
-                break;
-        }
-
-        ent = iter != NULL ? VFS_ENTRY (iter->data) : NULL;
+        // cut the segment out of our private copy for the duration of the lookup
+        c = path[pseg];
+        path[pseg] = '\0';
+        ent = VFS_ENTRY (g_hash_table_lookup (root->subdir_hash, path));
+        path[pseg] = c;
 
         if (ent == NULL && (flags & (FL_MKFILE | FL_MKDIR)) != 0)
             ent = vfs_s_automake (me, root, path, flags);
@@ -242,7 +239,6 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
 {
     struct vfs_s_entry *ent = NULL;
     char *const path = g_strdup (a_path);
-    GList *iter;
 
     if (root->super->root != root)
         vfs_die ("We have to use _real_ root. Always. Sorry.");
@@ -265,8 +261,7 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
         return ent;
     }
 
-    iter = g_queue_find_custom (root->subdir, path, (GCompareFunc) vfs_s_entry_compare);
-    ent = iter != NULL ? VFS_ENTRY (iter->data) : NULL;
+    ent = VFS_ENTRY (g_hash_table_lookup (root->subdir_hash, path));
 
     if (ent != NULL && !VFS_SUBCLASS (me)->dir_uptodate (me, ent->ino))
     {
@@ -292,8 +287,7 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
 
         vfs_s_insert_entry (me, root, ent);
 
-        iter = g_queue_find_custom (root->subdir, path, (GCompareFunc) vfs_s_entry_compare);
-        ent = iter != NULL ? VFS_ENTRY (iter->data) : NULL;
+        ent = VFS_ENTRY (g_hash_table_lookup (root->subdir_hash, path));
     }
     if (ent == NULL)
         vfs_die ("find_linear: success but directory is not there\n");
@@ -680,9 +674,12 @@ vfs_s_close (void *fh)
         else
         {
             res = sub->file_store (me, fh, s, file->ino->localname);
+
+            /* the stored file made only the listing of its own directory stale,
+               keep the rest of the cached tree */
+            vfs_s_invalidate_dir (me, super, s);
             g_free (s);
         }
-        vfs_s_invalidate (me, super);
     }
 
     if (file->handle != -1)
@@ -854,6 +851,14 @@ vfs_s_free (vfsid id)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static guint64
+vfs_s_memory_usage (vfsid id)
+{
+    return VFS_SUPER (id)->mem_usage;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static gboolean
 vfs_s_dir_uptodate (struct vfs_class *me, struct vfs_s_inode *ino)
 {
@@ -887,11 +892,13 @@ vfs_s_new_inode (struct vfs_class *me, struct vfs_s_super *super, struct stat *i
         ino->st = *initstat;
     ino->super = super;
     ino->subdir = g_queue_new ();
+    ino->subdir_hash = g_hash_table_new (g_str_hash, g_str_equal);
     ino->st.st_nlink = 0;
     ino->st.st_ino = VFS_SUBCLASS (me)->inode_counter++;
     ino->st.st_dev = VFS_SUBCLASS (me)->rdev;
 
     super->ino_usage++;
+    super->mem_usage += sizeof (*ino);
 
     CALL (init_inode) (me, ino);
 
@@ -923,6 +930,8 @@ vfs_s_free_inode (struct vfs_class *me, struct vfs_s_inode *ino)
 
     g_queue_free (ino->subdir);
     ino->subdir = NULL;
+    g_hash_table_destroy (ino->subdir_hash);
+    ino->subdir_hash = NULL;
 
     CALL (free_inode) (me, ino);
     g_free (ino->linkname);
@@ -932,6 +941,7 @@ vfs_s_free_inode (struct vfs_class *me, struct vfs_s_inode *ino)
         g_free (ino->localname);
     }
     ino->super->ino_usage--;
+    ino->super->mem_usage -= MIN (ino->super->mem_usage, sizeof (*ino));
     g_free (ino);
 }
 
@@ -947,6 +957,7 @@ vfs_s_new_entry (struct vfs_class *me, const char *name, struct vfs_s_inode *ino
     entry->name = g_strdup (name);
     entry->ino = inode;
     entry->ino->ent = entry;
+    inode->super->mem_usage += sizeof (*entry) + (name != NULL ? strlen (name) + 1 : 0);
     CALL (init_entry) (me, entry);
 
     return entry;
@@ -958,7 +969,30 @@ void
 vfs_s_free_entry (struct vfs_class *me, struct vfs_s_entry *ent)
 {
     if (ent->dir != NULL)
+    {
         g_queue_remove (ent->dir->subdir, ent);
+        if (g_hash_table_lookup (ent->dir->subdir_hash, ent->name) == ent)
+        {
+            GList *dup;
+
+            g_hash_table_remove (ent->dir->subdir_hash, ent->name);
+            // an identically named entry may still be queued; let it take over
+            dup = g_queue_find_custom (ent->dir->subdir, ent->name,
+                                       (GCompareFunc) vfs_s_entry_compare);
+            if (dup != NULL)
+                g_hash_table_insert (ent->dir->subdir_hash, VFS_ENTRY (dup->data)->name,
+                                     dup->data);
+        }
+    }
+
+    if (ent->ino != NULL)
+    {
+        struct vfs_s_super *super = ent->ino->super;
+        guint64 size;
+
+        size = sizeof (*ent) + (ent->name != NULL ? strlen (ent->name) + 1 : 0);
+        super->mem_usage -= MIN (super->mem_usage, size);
+    }
 
     MC_PTR_FREE (ent->name);
 
@@ -982,6 +1016,10 @@ vfs_s_insert_entry (struct vfs_class *me, struct vfs_s_inode *dir, struct vfs_s_
 
     ent->ino->st.st_nlink++;
     g_queue_push_tail (dir->subdir, ent);
+    /* of identically named entries the first one keeps winning the lookups,
+     * just as when the queue was searched from the head */
+    if (g_hash_table_lookup (dir->subdir_hash, ent->name) == NULL)
+        g_hash_table_insert (dir->subdir_hash, ent->name, ent);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1230,6 +1268,50 @@ vfs_s_invalidate (struct vfs_class *me, struct vfs_s_super *super)
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Invalidate the cached listing of the directory that contains @a a_path.
+ *
+ * Unlike vfs_s_invalidate(), which throws away the whole cached tree of the super, only the one
+ * listing that the operation on @a a_path made stale is expired, so everything else survives
+ * until its own timeout.  Only meaningful for subclasses that look entries up linearly (remote
+ * filesystems); for the others the whole tree is invalidated as before.
+ */
+
+void
+vfs_s_invalidate_dir (struct vfs_class *me, struct vfs_s_super *super, const char *a_path)
+{
+    char *path, *dirname;
+    struct vfs_s_entry *ent;
+
+    if (super->want_stale || super->root == NULL)
+        return;
+
+    if (VFS_SUBCLASS (me)->find_entry != vfs_s_find_entry_linear)
+    {
+        vfs_s_invalidate (me, super);
+        return;
+    }
+
+    path = g_strdup (a_path);
+    canonicalize_pathname_custom (path, CANON_PATH_ALL & (~CANON_PATH_REMDOUBLEDOTS));
+    dirname = g_path_get_dirname (path);
+
+    // the listing of the filesystem root is cached under the empty name
+    ent = VFS_ENTRY (
+        g_hash_table_lookup (super->root->subdir_hash, DIR_IS_DOT (dirname) ? "" : dirname));
+    if (ent != NULL)
+        ent->ino->timestamp = 0;  // expired: the next access re-reads the listing
+
+    // a removed or renamed directory may have a cached listing of its own
+    ent = VFS_ENTRY (g_hash_table_lookup (super->root->subdir_hash, path));
+    if (ent != NULL)
+        ent->ino->timestamp = 0;
+
+    g_free (dirname);
+    g_free (path);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 char *
@@ -1291,6 +1373,7 @@ vfs_s_open (const vfs_path_t *vpath, int flags, mode_t mode)
     struct vfs_s_inode *ino;
     struct vfs_class *me;
     struct vfs_s_subclass *s;
+    const gint64 trace_start = mc_trace_begin ();
 
     q = vfs_s_get_path (vpath, &super, 0);
     if (q == NULL)
@@ -1387,6 +1470,9 @@ vfs_s_open (const vfs_path_t *vpath, int flags, mode_t mode)
     vfs_rmstamp (me, (vfsid) super);
     super->fd_usage++;
     fh->ino->st.st_nlink++;
+
+    mc_trace_end ("vfs_s_open", trace_start, (guint64) fh->ino->st.st_size);
+
     return fh;
 }
 
@@ -1523,6 +1609,7 @@ vfs_init_class (struct vfs_class *vclass, const char *name, vfs_flags_t flags, c
     vclass->getid = vfs_s_getid;
     vclass->nothingisopen = vfs_s_nothingisopen;
     vclass->free = vfs_s_free;
+    vclass->memory_usage = vfs_s_memory_usage;
     vclass->setctl = vfs_s_setctl;
     if ((vclass->flags & VFSF_USETMP) != 0)
     {
@@ -1692,6 +1779,82 @@ vfs_s_get_line_interruptible (struct vfs_class *me, char *buffer, int size, int
 
     buffer[size - 1] = '\0';
 
+ret:
+    tty_disable_interrupt_key ();
+
+    return res;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+vfs_s_line_reader_init (vfs_s_line_reader_t *reader, int fd)
+{
+    reader->fd = fd;
+    reader->pos = 0;
+    reader->len = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get a line from the stream, reading ahead in large chunks.
+ *
+ * Same semantics as vfs_s_get_line_interruptible(), but reads through @a reader instead of one
+ * byte per read(2) call, so the parsing of a streamed listing keeps up with the remote side.
+ * The caller must drain the stream through the same reader up to its terminator.
+ *
+ * @param me     class structure (unused)
+ * @param reader buffered reader initialized with vfs_s_line_reader_init()
+ * @param buffer buffer for line
+ * @param size   size of buffer
+ * @return 1 if line read, EINTR if interrupted, 0 at end of stream
+ */
+
+int
+vfs_s_read_line_interruptible (struct vfs_class *me, vfs_s_line_reader_t *reader, char *buffer,
+                               int size)
+{
+    int i;
+    int res = 0;
+
+    (void) me;
+
+    tty_enable_interrupt_key ();
+
+    for (i = 0; i < size - 1; i++)
+    {
+        if (reader->pos == reader->len)
+        {
+            ssize_t n;
+
+            n = read (reader->fd, reader->buffer, sizeof (reader->buffer));
+            if (n == -1 && errno == EINTR)
+            {
+                buffer[i] = '\0';
+                res = EINTR;
+                goto ret;
+            }
+            if (n <= 0)
+            {
+                buffer[i] = '\0';
+                goto ret;
+            }
+
+            reader->pos = 0;
+            reader->len = (size_t) n;
+        }
+
+        buffer[i] = reader->buffer[reader->pos++];
+        if (buffer[i] == '\n')
+        {
+            buffer[i] = '\0';
+            res = 1;
+            goto ret;
+        }
+    }
+
+    buffer[size - 1] = '\0';
+
 ret:
     tty_disable_interrupt_key ();
 
@@ -1722,6 +1885,13 @@ vfs_s_normalize_filename_leading_spaces (struct vfs_s_inode *root_inode, size_t
             spacer = g_strnfill ((size_t) entry->leading_spaces - final_num_spaces, ' ');
             entry->name = g_strconcat (spacer, source_name, (char *) NULL);
             g_free (spacer);
+
+            // the lookup hash is keyed by the name just replaced
+            if (g_hash_table_lookup (root_inode->subdir_hash, source_name) == entry)
+            {
+                g_hash_table_remove (root_inode->subdir_hash, source_name);
+                g_hash_table_insert (root_inode->subdir_hash, entry->name, entry);
+            }
             g_free (source_name);
         }
 
@@ -84,7 +84,8 @@
 
 /*** global variables ****************************************************************************/
 
-int vfs_timeout = 60;  // VFS timeout in seconds
+int vfs_timeout = 60;       // VFS timeout in seconds
+int vfs_memory_limit = 256;  // memory budget of stale VFS in MiB; 0 - unlimited
 
 /*** file scope macro definitions ****************************************************************/
 
@@ -118,6 +119,58 @@ vfs_stamp_compare (gconstpointer a, gconstpointer b)
     return (vsa == NULL || vsb == NULL || (vsa->v == vsb->v && vsa->id == vsb->id)) ? 0 : 1;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Evict the least recently used stale filesystems until the memory budget is met.
+    Only filesystems that report their usage and have nothing open are candidates. */
+
+static void
+vfs_expire_over_budget (void)
+{
+    guint64 limit, total;
+    GSList *stamp;
+
+    if (vfs_memory_limit <= 0)
+        return;
+
+    total = vfs_memory_usage ();
+    limit = (guint64) vfs_memory_limit * 1024 * 1024;
+
+    while (total > limit)
+    {
+        struct vfs_stamping *oldest = NULL;
+        GSList *oldest_link = NULL;
+        guint64 size;
+
+        for (stamp = stamps; stamp != NULL; stamp = g_slist_next (stamp))
+        {
+            struct vfs_stamping *stamping = VFS_STAMPING (stamp->data);
+
+            if (stamping->v->memory_usage == NULL
+                || stamping->v->memory_usage (stamping->id) == 0)
+                continue;
+            if (stamping->v->nothingisopen != NULL && !stamping->v->nothingisopen (stamping->id))
+                continue;
+            if (oldest == NULL || stamping->time < oldest->time)
+            {
+                oldest = stamping;
+                oldest_link = stamp;
+            }
+        }
+
+        if (oldest == NULL)
+            break;
+
+        size = oldest->v->memory_usage (oldest->id);
+        if (oldest->v->free != NULL)
+            oldest->v->free (oldest->id);
+        total -= MIN (total, size);
+        g_free (oldest);
+        stamps = g_slist_delete_link (stamps, oldest_link);
+
+        vfs_stat_cache_invalidate ();
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void
@@ -138,6 +191,26 @@ vfs_addstamp (struct vfs_class *v, vfsid id)
 
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/** Sum the cached bytes of every stamped filesystem that reports its usage. */
+
+guint64
+vfs_memory_usage (void)
+{
+    guint64 total = 0;
+    GSList *stamp;
+
+    for (stamp = stamps; stamp != NULL; stamp = g_slist_next (stamp))
+    {
+        const struct vfs_stamping *stamping = VFS_STAMPING (stamp->data);
+
+        if (stamping->v->memory_usage != NULL)
+            total += stamping->v->memory_usage (stamping->id);
+    }
+
+    return total;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 gboolean
@@ -240,6 +313,7 @@ vfs_expire (gboolean now)
     static gboolean locked = FALSE;
     gint64 curr_time, exp_time;
     GSList *stamp;
+    gboolean freed_any = FALSE;
 
     /* Avoid recursive invocation, e.g. when one of the free functions
        calls message */
@@ -267,6 +341,7 @@ vfs_expire (gboolean now)
             if (stamping->v->free != NULL)
                 stamping->v->free (stamping->id);
             MC_PTR_FREE (stamp->data);
+            freed_any = TRUE;
         }
         else if (stamping->time <= exp_time)
         {
@@ -278,27 +353,61 @@ vfs_expire (gboolean now)
                 if (stamping->v->free != NULL)
                     stamping->v->free (stamping->id);
                 MC_PTR_FREE (stamp->data);
+                freed_any = TRUE;
             }
         }
+        else if (stamping->v->keepalive != NULL)
+        {
+            // keep the idle connection from being dropped by the peer
+            stamping->v->keepalive (stamping->id);
+        }
     }
 
     // then remove NULLized stamps
     stamps = g_slist_remove_all (stamps, NULL);
 
+    if (!now)
+        vfs_expire_over_budget ();
+
+    if (freed_any)
+        // cached stat results may belong to a filesystem that is gone now
+        vfs_stat_cache_invalidate ();
+
     locked = FALSE;
 }
 
 /* --------------------------------------------------------------------------------------------- */
 /*
- * Return the number of seconds remaining to the vfs timeout.
- * FIXME: The code should be improved to actually return the number of
- * seconds until the next item times out.
+ * Return the number of seconds until the next stamped VFS times out,
+ * i.e. how long the main loop may sleep before calling vfs_timeout_handler().
  */
 
 int
 vfs_timeouts (void)
 {
-    return stamps != NULL ? 10 : 0;
+    gint64 next_time = G_MAXINT64;
+    gint64 remaining;
+    GSList *stamp;
+
+    if (stamps == NULL)
+        return 0;
+
+    for (stamp = stamps; stamp != NULL; stamp = g_slist_next (stamp))
+    {
+        struct vfs_stamping *stamping = VFS_STAMPING (stamp->data);
+
+        // a connection with keepalive needs a steady pump even when nothing expires soon
+        if (stamping->v->keepalive != NULL)
+            return 10;
+
+        if (stamping->time < next_time)
+            next_time = stamping->time;
+    }
+
+    remaining = next_time + vfs_timeout * G_USEC_PER_SEC - g_get_monotonic_time ();
+
+    // round up so a wakeup does not land just before the expiry it was scheduled for
+    return CLAMP (remaining / G_USEC_PER_SEC + 1, 1, vfs_timeout > 0 ? vfs_timeout : 10);
 }
 
 /* --------------------------------------------------------------------------------------------- */
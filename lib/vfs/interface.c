@@ -68,12 +68,60 @@ extern struct vfs_dirent *mc_readdir_result;
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Size of the chunk requested from the backend once a handle is read sequentially,
+   see mc_read(). One large request overlaps the round trips that small reads would
+   otherwise pay one by one. */
+#define VFS_READAHEAD_SIZE      (64 * 1024)
+
+/* Number of consecutive small reads, with no seek or write in between,
+   after which a handle counts as sequential */
+#define VFS_READAHEAD_THRESHOLD 2
+
+/* Short-lived memo of stat results on non-local paths, see mc_stat()/mc_lstat():
+   one interaction stats the same remote path several times, each a round trip.
+   Entries die when the TTL runs out, when any mutating VFS call bumps the
+   generation, or when a virtual filesystem is freed. */
+#define VFS_STAT_CACHE_SIZE   64
+#define VFS_STAT_CACHE_TTL_US (G_USEC_PER_SEC / 2)
+
 /*** file scope type declarations ****************************************************************/
 
+/* readahead state of an open handle, see mc_read() */
+typedef struct
+{
+    char *buffer;            // data read ahead of the consumer
+    size_t len;              // bytes in buffer
+    size_t pos;              // first byte not yet handed out
+    unsigned int seq_reads;  // consecutive small reads without a seek or write
+} vfs_readahead_t;
+
+/* one memoized mc_stat()/mc_lstat() result */
+typedef struct
+{
+    char *path;          // NULL = empty slot
+    gboolean is_lstat;   // result of lstat rather than stat
+    struct stat st;
+    guint64 generation;  // only valid within the generation it was filled in
+    gint64 stamp;        // monotonic fill time, for the TTL
+} vfs_stat_cache_entry_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
+// open handle (int) -> vfs_readahead_t, created on the first sequential read
+static GHashTable *vfs_readahead_files = NULL;
+
+/* open handle (int) -> real file descriptor + 1, for classes that provide
+   fileno(): their data plane skips the dispatch table entirely */
+static GHashTable *vfs_direct_fds = NULL;
+
+/* The stat cache is shared with the directory loader thread, hence the lock */
+static GMutex vfs_stat_cache_lock;
+static vfs_stat_cache_entry_t vfs_stat_cache[VFS_STAT_CACHE_SIZE];
+static guint64 vfs_stat_cache_generation = 1;
+static size_t vfs_stat_cache_victim = 0;  // round-robin replacement
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -220,7 +268,30 @@ mc_open (const vfs_path_t *vpath, int flags, ...)
         if (info == NULL)
             errno = vfs_ferrno (me);
         else
+        {
             result = vfs_new_handle (me, info);
+
+            if (me->fileno != NULL)
+            {
+                int fd;
+
+                fd = me->fileno (info);
+                if (fd >= 0)
+                {
+                    if (vfs_direct_fds == NULL)
+                        vfs_direct_fds = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+                    /* stored shifted by one so that a missing entry (NULL)
+                       cannot be mistaken for descriptor 0 */
+                    g_hash_table_insert (vfs_direct_fds, GINT_TO_POINTER (result),
+                                         GINT_TO_POINTER (fd + 1));
+                }
+            }
+
+            // an open that can create or truncate changes what stat would report
+            if ((flags & (O_WRONLY | O_RDWR | O_CREAT | O_TRUNC | O_APPEND)) != 0)
+                vfs_stat_cache_invalidate ();
+        }
     }
     else
         errno = ENOTSUP;
@@ -249,16 +320,39 @@ mc_open (const vfs_path_t *vpath, int flags, ...)
         return result;                                                                             \
     }
 
-MC_NAMEOP (chmod, (const vfs_path_t *vpath, mode_t mode), (vpath, mode))
-MC_NAMEOP (chown, (const vfs_path_t *vpath, uid_t owner, gid_t group), (vpath, owner, group))
+/* As MC_NAMEOP, for operations that modify the file system: a success drops the
+   memoized stat results */
+#define MC_MUTATEOP(name, inarg, callarg)                                                          \
+    int mc_##name inarg                                                                            \
+    {                                                                                              \
+        int result;                                                                                \
+        struct vfs_class *me;                                                                      \
+                                                                                                   \
+        if (vpath == NULL)                                                                         \
+            return (-1);                                                                           \
+                                                                                                   \
+        me = VFS_CLASS (vfs_path_get_last_path_vfs (vpath));                                       \
+        if (me == NULL)                                                                            \
+            return (-1);                                                                           \
+                                                                                                   \
+        result = me->name != NULL ? me->name callarg : -1;                                         \
+        if (result == -1)                                                                          \
+            errno = me->name != NULL ? vfs_ferrno (me) : ENOTSUP;                                  \
+        else                                                                                       \
+            vfs_stat_cache_invalidate ();                                                          \
+        return result;                                                                             \
+    }
+
+MC_MUTATEOP (chmod, (const vfs_path_t *vpath, mode_t mode), (vpath, mode))
+MC_MUTATEOP (chown, (const vfs_path_t *vpath, uid_t owner, gid_t group), (vpath, owner, group))
 MC_NAMEOP (fgetflags, (const vfs_path_t *vpath, unsigned long *flags), (vpath, flags))
-MC_NAMEOP (fsetflags, (const vfs_path_t *vpath, unsigned long flags), (vpath, flags))
-MC_NAMEOP (utime, (const vfs_path_t *vpath, mc_timesbuf_t *times), (vpath, times))
+MC_MUTATEOP (fsetflags, (const vfs_path_t *vpath, unsigned long flags), (vpath, flags))
+MC_MUTATEOP (utime, (const vfs_path_t *vpath, mc_timesbuf_t *times), (vpath, times))
 MC_NAMEOP (readlink, (const vfs_path_t *vpath, char *buf, size_t bufsiz), (vpath, buf, bufsiz))
-MC_NAMEOP (unlink, (const vfs_path_t *vpath), (vpath))
-MC_NAMEOP (mkdir, (const vfs_path_t *vpath, mode_t mode), (vpath, mode))
-MC_NAMEOP (rmdir, (const vfs_path_t *vpath), (vpath))
-MC_NAMEOP (mknod, (const vfs_path_t *vpath, mode_t mode, dev_t dev), (vpath, mode, dev))
+MC_MUTATEOP (unlink, (const vfs_path_t *vpath), (vpath))
+MC_MUTATEOP (mkdir, (const vfs_path_t *vpath, mode_t mode), (vpath, mode))
+MC_MUTATEOP (rmdir, (const vfs_path_t *vpath), (vpath))
+MC_MUTATEOP (mknod, (const vfs_path_t *vpath, mode_t mode, dev_t dev), (vpath, mode, dev))
 
 /* --------------------------------------------------------------------------------------------- */
 
@@ -277,11 +371,137 @@ mc_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2)
             result = me->symlink != NULL ? me->symlink (vpath1, vpath2) : -1;
             if (result == -1)
                 errno = me->symlink != NULL ? vfs_ferrno (me) : ENOTSUP;
+            else
+                vfs_stat_cache_invalidate ();
         }
     }
     return result;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+static gboolean
+vfs_stat_cache_lookup (const vfs_path_t *vpath, gboolean is_lstat, struct stat *buf)
+{
+    const char *path = vfs_path_as_str (vpath);
+    const gint64 now = g_get_monotonic_time ();
+    gboolean found = FALSE;
+    size_t i;
+
+    g_mutex_lock (&vfs_stat_cache_lock);
+    for (i = 0; i < VFS_STAT_CACHE_SIZE; i++)
+    {
+        const vfs_stat_cache_entry_t *e = &vfs_stat_cache[i];
+
+        if (e->path != NULL && e->is_lstat == is_lstat
+            && e->generation == vfs_stat_cache_generation
+            && now - e->stamp <= VFS_STAT_CACHE_TTL_US && strcmp (e->path, path) == 0)
+        {
+            *buf = e->st;
+            found = TRUE;
+            break;
+        }
+    }
+    g_mutex_unlock (&vfs_stat_cache_lock);
+
+    return found;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+vfs_stat_cache_insert (const vfs_path_t *vpath, gboolean is_lstat, const struct stat *buf)
+{
+    const char *path = vfs_path_as_str (vpath);
+    vfs_stat_cache_entry_t *e;
+    size_t i;
+
+    g_mutex_lock (&vfs_stat_cache_lock);
+
+    // refresh a slot holding the same path, take the round-robin victim otherwise
+    for (i = 0; i < VFS_STAT_CACHE_SIZE; i++)
+        if (vfs_stat_cache[i].path != NULL && vfs_stat_cache[i].is_lstat == is_lstat
+            && strcmp (vfs_stat_cache[i].path, path) == 0)
+            break;
+    if (i == VFS_STAT_CACHE_SIZE)
+    {
+        i = vfs_stat_cache_victim;
+        vfs_stat_cache_victim = (vfs_stat_cache_victim + 1) % VFS_STAT_CACHE_SIZE;
+    }
+
+    e = &vfs_stat_cache[i];
+    g_free (e->path);
+    e->path = g_strdup (path);
+    e->is_lstat = is_lstat;
+    e->st = *buf;
+    e->generation = vfs_stat_cache_generation;
+    e->stamp = g_get_monotonic_time ();
+
+    g_mutex_unlock (&vfs_stat_cache_lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Drop all memoized stat results. Called by every VFS operation that changes
+ * the file system, and when a virtual filesystem is freed.
+ */
+
+void
+vfs_stat_cache_invalidate (void)
+{
+    g_mutex_lock (&vfs_stat_cache_lock);
+    vfs_stat_cache_generation++;
+    g_mutex_unlock (&vfs_stat_cache_lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Look up the readahead state of an open handle, if any.
+ */
+
+static vfs_readahead_t *
+vfs_readahead_find (int handle)
+{
+    if (vfs_readahead_files == NULL)
+        return NULL;
+
+    return (vfs_readahead_t *) g_hash_table_lookup (vfs_readahead_files, GINT_TO_POINTER (handle));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+vfs_readahead_free (gpointer data)
+{
+    vfs_readahead_t *ra = (vfs_readahead_t *) data;
+
+    g_free (ra->buffer);
+    g_free (ra);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+vfs_readahead_forget (int handle)
+{
+    if (vfs_readahead_files != NULL)
+        g_hash_table_remove (vfs_readahead_files, GINT_TO_POINTER (handle));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Return the real file descriptor behind @handle, or -1 if the handle
+ * has none and must go through the class dispatch.
+ */
+
+static int
+vfs_direct_fd (int handle)
+{
+    if (vfs_direct_fds == NULL)
+        return (-1);
+
+    return GPOINTER_TO_INT (g_hash_table_lookup (vfs_direct_fds, GINT_TO_POINTER (handle))) - 1;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 #define MC_HANDLEOP(rettype, name, inarg, callarg)                                                 \
@@ -304,12 +524,146 @@ mc_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2)
         return result;                                                                             \
     }
 
-MC_HANDLEOP (ssize_t, read, (int handle, void *buf, size_t count), (fsinfo, buf, count))
-MC_HANDLEOP (ssize_t, write, (int handle, const void *buf, size_t count), (fsinfo, buf, count))
 MC_HANDLEOP (int, fstat, (int handle, struct stat *buf), (fsinfo, buf))
 
 /* --------------------------------------------------------------------------------------------- */
 
+ssize_t
+mc_read (int handle, void *buf, size_t count)
+{
+    struct vfs_class *vfs;
+    void *fsinfo = NULL;
+    vfs_readahead_t *ra;
+    ssize_t result;
+    int fd;
+
+    if (handle == -1)
+        return (-1);
+
+    /* a handle backed by a real descriptor reads straight from the kernel;
+       the page cache makes readahead of our own pointless here */
+    fd = vfs_direct_fd (handle);
+    if (fd >= 0)
+    {
+        while ((result = read (fd, buf, count)) == -1 && (errno == EINTR || errno == EAGAIN))
+            ;
+        return result;
+    }
+
+    vfs = vfs_class_find_by_handle (handle, &fsinfo);
+    if (vfs == NULL)
+        return (-1);
+
+    if (vfs->read == NULL)
+    {
+        errno = ENOTSUP;
+        return (-1);
+    }
+
+    ra = vfs_readahead_find (handle);
+
+    // drain the data already read ahead of the consumer first
+    if (ra != NULL && ra->pos < ra->len)
+    {
+        count = MIN (count, ra->len - ra->pos);
+        memcpy (buf, ra->buffer + ra->pos, count);
+        ra->pos += count;
+        return (ssize_t) count;
+    }
+
+    /* The OS covers local files; a remote handle becomes a readahead candidate after
+       a few small reads with no seek or write in between -- the pattern of the viewer
+       and of copy loops, where every block otherwise pays the full round trip */
+    if ((vfs->flags & VFSF_LOCAL) == 0 && count != 0 && count < VFS_READAHEAD_SIZE)
+    {
+        if (ra == NULL)
+        {
+            if (vfs_readahead_files == NULL)
+                vfs_readahead_files =
+                    g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, vfs_readahead_free);
+
+            ra = g_new0 (vfs_readahead_t, 1);
+            g_hash_table_insert (vfs_readahead_files, GINT_TO_POINTER (handle), ra);
+        }
+
+        ra->seq_reads++;
+
+        if (ra->seq_reads > VFS_READAHEAD_THRESHOLD)
+        {
+            if (ra->buffer == NULL)
+                ra->buffer = g_malloc (VFS_READAHEAD_SIZE);
+
+            result = vfs->read (fsinfo, ra->buffer, VFS_READAHEAD_SIZE);
+            if (result <= 0)
+            {
+                if (result < 0)
+                    errno = vfs_ferrno (vfs);
+                return result;
+            }
+
+            ra->len = (size_t) result;
+            count = MIN (count, ra->len);
+            memcpy (buf, ra->buffer, count);
+            ra->pos = count;
+            return (ssize_t) count;
+        }
+    }
+
+    result = vfs->read (fsinfo, buf, count);
+    if (result == -1)
+        errno = vfs_ferrno (vfs);
+    return result;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+ssize_t
+mc_write (int handle, const void *buf, size_t count)
+{
+    struct vfs_class *vfs;
+    void *fsinfo = NULL;
+    vfs_readahead_t *ra;
+    ssize_t result;
+    int fd;
+
+    if (handle == -1)
+        return (-1);
+
+    /* direct-fd handles never accumulate readahead, so there is no
+       backend position to re-align before writing */
+    fd = vfs_direct_fd (handle);
+    if (fd >= 0)
+    {
+        while ((result = write (fd, buf, count)) == -1 && (errno == EINTR || errno == EAGAIN))
+            ;
+        if (result != -1)
+            vfs_stat_cache_invalidate ();
+        return result;
+    }
+
+    vfs = vfs_class_find_by_handle (handle, &fsinfo);
+    if (vfs == NULL)
+        return (-1);
+
+    ra = vfs_readahead_find (handle);
+    if (ra != NULL)
+    {
+        // the backend position is ahead of the consumer by the unconsumed readahead
+        if (ra->pos < ra->len && vfs->lseek != NULL)
+            (void) vfs->lseek (fsinfo, -(off_t) (ra->len - ra->pos), SEEK_CUR);
+        vfs_readahead_forget (handle);
+    }
+
+    result = vfs->write != NULL ? vfs->write (fsinfo, buf, count) : -1;
+    if (result == -1)
+        errno = vfs->write != NULL ? vfs_ferrno (vfs) : ENOTSUP;
+    else
+        vfs_stat_cache_invalidate ();
+    return result;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 #define MC_RENAMEOP(name)                                                                          \
     int mc_##name (const vfs_path_t *vpath1, const vfs_path_t *vpath2)                             \
     {                                                                                              \
@@ -331,6 +685,8 @@ MC_HANDLEOP (int, fstat, (int handle, struct stat *buf), (fsinfo, buf))
         result = me1->name != NULL ? me1->name (vpath1, vpath2) : -1;                              \
         if (result == -1)                                                                          \
             errno = me1->name != NULL ? vfs_ferrno (me1) : ENOTSUP;                                \
+        else                                                                                       \
+            vfs_stat_cache_invalidate ();                                                          \
         return result;                                                                             \
     }
 
@@ -345,6 +701,15 @@ mc_ctl (int handle, int ctlop, void *arg)
     struct vfs_class *vfs;
     void *fsinfo = NULL;
 
+    if (ctlop == VFS_CTL_IS_NOTREADY)
+    {
+        const vfs_readahead_t *ra = vfs_readahead_find (handle);
+
+        // data read ahead of the consumer is ready by definition
+        if (ra != NULL && ra->pos < ra->len)
+            return 0;
+    }
+
     vfs = vfs_class_find_by_handle (handle, &fsinfo);
 
     return (vfs == NULL || vfs->ctl == NULL) ? 0 : vfs->ctl (fsinfo, ctlop, arg);
@@ -389,10 +754,17 @@ mc_close (int handle)
 
     if (vfs->close == NULL)
         vfs_die ("VFS must support close.\n");
+    vfs_readahead_forget (handle);
+    if (vfs_direct_fds != NULL)
+        g_hash_table_remove (vfs_direct_fds, GINT_TO_POINTER (handle));
     result = vfs->close (fsinfo);
     vfs_free_handle (handle);
     if (result == -1)
         errno = vfs_ferrno (vfs);
+    else
+        /* remote backends may flush the file on close, so sizes and times
+           settle only now */
+        vfs_stat_cache_invalidate ();
 
     return result;
 }
@@ -514,7 +886,9 @@ mc_closedir (DIR *dirp)
 
 /* --------------------------------------------------------------------------------------------- */
 
-#define MC_STATOP(name)                                                                            \
+/* Local stats are cheap; only results from virtual filesystems, where each one
+   is a round trip, are worth memoizing. */
+#define MC_STATOP(name, lstat_flag)                                                                \
     int mc_##name (const vfs_path_t *vpath, struct stat *buf)                                      \
     {                                                                                              \
         int result = -1;                                                                           \
@@ -526,16 +900,23 @@ mc_closedir (DIR *dirp)
         me = VFS_CLASS (vfs_path_get_last_path_vfs (vpath));                                       \
         if (me != NULL)                                                                            \
         {                                                                                          \
+            const gboolean cacheable = (me->flags & VFSF_LOCAL) == 0;                              \
+                                                                                                   \
+            if (cacheable && vfs_stat_cache_lookup (vpath, lstat_flag, buf))                       \
+                return 0;                                                                          \
+                                                                                                   \
             result = me->name ? me->name (vpath, buf) : -1;                                        \
             if (result == -1)                                                                      \
                 errno = me->name ? vfs_ferrno (me) : ENOTSUP;                                      \
+            else if (cacheable)                                                                    \
+                vfs_stat_cache_insert (vpath, lstat_flag, buf);                                    \
         }                                                                                          \
                                                                                                    \
         return result;                                                                             \
     }
 
-MC_STATOP (stat)
-MC_STATOP (lstat)
+MC_STATOP (stat, FALSE)
+MC_STATOP (lstat, TRUE)
 
 /* --------------------------------------------------------------------------------------------- */
 
@@ -682,15 +1063,30 @@ mc_lseek (int fd, off_t offset, int whence)
 {
     struct vfs_class *vfs;
     void *fsinfo = NULL;
+    vfs_readahead_t *ra;
     off_t result;
+    int real_fd;
 
     if (fd == -1)
         return (-1);
 
+    real_fd = vfs_direct_fd (fd);
+    if (real_fd >= 0)
+        return lseek (real_fd, offset, whence);
+
     vfs = vfs_class_find_by_handle (fd, &fsinfo);
     if (vfs == NULL)
         return (-1);
 
+    ra = vfs_readahead_find (fd);
+    if (ra != NULL)
+    {
+        // the backend position is ahead of the consumer by the unconsumed readahead
+        if (whence == SEEK_CUR)
+            offset -= (off_t) (ra->len - ra->pos);
+        vfs_readahead_forget (fd);
+    }
+
     result = vfs->lseek ? vfs->lseek (fsinfo, offset, whence) : -1;
     if (result == -1)
         errno = vfs->lseek ? vfs_ferrno (vfs) : ENOTSUP;
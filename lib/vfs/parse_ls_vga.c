@@ -527,9 +527,19 @@ vfs_parse_filedate (int idx, time_t *t)
     time_t current_time;
     struct tm *local_time;
 
+    // localtime() is costly and its result changes at most once a second,
+    // while a big listing runs through here once per line
+    static time_t cached_time = (time_t) (-1);
+    static struct tm cached_tm;
+
     // Let's setup default time values
     current_time = time (NULL);
-    local_time = localtime (&current_time);
+    if (current_time != cached_time)
+    {
+        cached_time = current_time;
+        cached_tm = *localtime (&current_time);
+    }
+    local_time = &cached_tm;
     tim.tm_mday = local_time->tm_mday;
     tim.tm_mon = local_time->tm_mon;
     tim.tm_year = local_time->tm_year;
@@ -680,9 +690,11 @@ gboolean
 vfs_parse_ls_lga (const char *p, struct stat *s, char **filename, char **linkname,
                   size_t *num_spaces)
 {
+    // the buffer is reused between calls: one allocation per listing instead of one per line
+    static GString *p_copy = NULL;
+
     int idx, idx2, num_cols;
     int i;
-    char *p_copy = NULL;
     char *t = NULL;
     const char *line = p;
     size_t skipped;
@@ -690,6 +702,11 @@ vfs_parse_ls_lga (const char *p, struct stat *s, char **filename, char **linknam
     if (strncmp (p, "total", 5) == 0)
         return FALSE;
 
+    if (p_copy == NULL)
+        p_copy = g_string_sized_new (BUF_MEDIUM);
+    else
+        g_string_truncate (p_copy, 0);
+
     if (!vfs_parse_filetype (p, &skipped, &s->st_mode))
         goto error;
 
@@ -720,8 +737,8 @@ vfs_parse_ls_lga (const char *p, struct stat *s, char **filename, char **linknam
         s->st_mode |= perms;
     }
 
-    p_copy = g_strdup (p);
-    num_cols = vfs_split_text (p_copy);
+    g_string_assign (p_copy, p);
+    num_cols = vfs_split_text (p_copy->str);
 
     s->st_nlink = atol (columns[0]);
     if (s->st_nlink <= 0)
@@ -850,7 +867,6 @@ vfs_parse_ls_lga (const char *p, struct stat *s, char **filename, char **linknam
 
     str_rstrip_eol (t);
 
-    g_free (p_copy);
     return TRUE;
 
 error:
@@ -858,13 +874,11 @@ error:
     static int errorcount = 0;
 
     if (++errorcount < 5)
-        message (D_ERROR, _ ("Cannot parse:"), "%s",
-                 (p_copy != NULL && *p_copy != '\0') ? p_copy : line);
+        message (D_ERROR, _ ("Cannot parse:"), "%s", p_copy->str[0] != '\0' ? p_copy->str : line);
     else if (errorcount == 5)
         message (D_ERROR, MSG_ERROR, _ ("More parsing errors will be ignored."));
 }
 
-    g_free (p_copy);
     return FALSE;
 }
 
@@ -36,6 +36,7 @@
 #include <errno.h>
 
 #include "lib/global.h"
+#include "lib/strspan.h"
 #include "lib/strutil.h"
 #include "lib/util.h"  // mc_build_filename()
 #include "lib/serialize.h"
@@ -51,16 +52,30 @@ extern GPtrArray *vfs__classes_list;
 
 /*** file scope macro definitions ****************************************************************/
 
+/* the parse cache is flushed when it grows to this many distinct strings */
+#define VFS_PATH_CACHE_CAPACITY 512
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
+/* cache of parsed absolute paths: string -> private vfs_path_t, see vfs_path_from_str_flags() */
+static GHashTable *vfs_path_cache = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+vfs_path_cache_value_free (gpointer data)
+{
+    (void) vfs_path_free ((vfs_path_t *) data, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static gboolean
 path_magic (const char *path)
 {
@@ -686,10 +701,24 @@ vfs_path_from_str_flags (const char *path_str, vfs_path_flag_t flags)
 {
     vfs_path_t *vpath;
     char *path;
+    gboolean cacheable;
 
     if (path_str == NULL)
         return NULL;
 
+    /* Panels and file operations parse the same strings over and over; cloning a
+     * finished parse is much cheaper than canonicalizing and tokenizing again.
+     * Only plain absolute paths take part: relative ones (and "~") depend on the
+     * environment and non-default flags change the parse itself. */
+    cacheable = flags == VPF_NONE && IS_PATH_SEP (*path_str);
+
+    if (cacheable && vfs_path_cache != NULL)
+    {
+        vpath = g_hash_table_lookup (vfs_path_cache, path_str);
+        if (vpath != NULL)
+            return vfs_path_clone (vpath);
+    }
+
     if ((flags & VPF_NO_CANON) == 0)
         path = vfs_canon (path_str);
     else
@@ -706,6 +735,17 @@ vfs_path_from_str_flags (const char *path_str, vfs_path_flag_t flags)
     vpath->str = vfs_path_to_str_flags (vpath, 0, flags);
     g_free (path);
 
+    if (cacheable)
+    {
+        if (vfs_path_cache == NULL)
+            vfs_path_cache =
+                g_hash_table_new_full (g_str_hash, g_str_equal, g_free, vfs_path_cache_value_free);
+        else if (g_hash_table_size (vfs_path_cache) >= VFS_PATH_CACHE_CAPACITY)
+            g_hash_table_remove_all (vfs_path_cache);
+
+        g_hash_table_replace (vfs_path_cache, g_strdup (path_str), vfs_path_clone (vpath));
+    }
+
     return vpath;
 }
 
@@ -1341,20 +1381,11 @@ vfs_path_tokens_count (const vfs_path_t *vpath)
 
     for (element_index = 0; element_index < vfs_path_elements_count (vpath); element_index++)
     {
-        const vfs_path_element_t *element;
-        const char *token, *prev_token;
-
-        element = vfs_path_get_by_index (vpath, element_index);
+        str_span_t rest, token;
 
-        for (prev_token = element->path; (token = strchr (prev_token, PATH_SEP)) != NULL;
-             prev_token = token + 1)
-        {
-            // skip empty substring
-            if (token != prev_token)
-                count_tokens++;
-        }
+        rest = str_span_from_str (vfs_path_get_by_index (vpath, element_index)->path);
 
-        if (*prev_token != '\0')
+        while (str_span_next_token (&rest, PATH_SEP, &token))
             count_tokens++;
     }
 
@@ -1408,35 +1439,33 @@ vfs_path_tokens_get (const vfs_path_t *vpath, ssize_t start_position, ssize_t le
     for (element_index = 0; element_index < vfs_path_elements_count (vpath); element_index++)
     {
         const vfs_path_element_t *element;
-        char **path_tokens, **iterator;
+        str_span_t rest, token;
 
         g_string_assign (element_tokens, "");
         element = vfs_path_get_by_index (vpath, element_index);
-        path_tokens = g_strsplit (element->path, PATH_SEP_STR, -1);
 
-        for (iterator = path_tokens; *iterator != NULL; iterator++)
+        // walk the tokens in place, no per-call copies of the path
+        rest = str_span_from_str (element->path);
+
+        while (str_span_next_token (&rest, PATH_SEP, &token))
         {
-            if (**iterator != '\0')
+            if (start_position == 0)
             {
-                if (start_position == 0)
+                if (length == 0)
                 {
-                    if (length == 0)
-                    {
-                        vfs_path_tokens_add_class_info (element, ret_tokens, element_tokens);
-                        g_string_free (element_tokens, TRUE);
-                        g_strfreev (path_tokens);
-                        return g_string_free (ret_tokens, FALSE);
-                    }
-                    length--;
-                    if (element_tokens->len != 0)
-                        g_string_append_c (element_tokens, PATH_SEP);
-                    g_string_append (element_tokens, *iterator);
+                    vfs_path_tokens_add_class_info (element, ret_tokens, element_tokens);
+                    g_string_free (element_tokens, TRUE);
+                    return g_string_free (ret_tokens, FALSE);
                 }
-                else
-                    start_position--;
+                length--;
+                if (element_tokens->len != 0)
+                    g_string_append_c (element_tokens, PATH_SEP);
+                g_string_append_len (element_tokens, token.str, token.len);
             }
+            else
+                start_position--;
         }
-        g_strfreev (path_tokens);
+
         vfs_path_tokens_add_class_info (element, ret_tokens, element_tokens);
     }
 
@@ -1649,3 +1678,22 @@ vfs_path_to_absolute (const vfs_path_t *vpath)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Drop all cached parses.
+ *
+ * Called on VFS shutdown; cached objects hold pointers into the class registry
+ * and must not outlive it.
+ */
+
+void
+vfs_path_cache_flush (void)
+{
+    if (vfs_path_cache != NULL)
+    {
+        g_hash_table_destroy (vfs_path_cache);
+        vfs_path_cache = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -63,6 +63,7 @@ char *vfs_path_to_str_elements_count (const vfs_path_t *path, int elements_count
 char *vfs_path_to_str_flags (const vfs_path_t *vpath, int elements_count, vfs_path_flag_t flags);
 vfs_path_t *vfs_path_from_str (const char *path_str);
 vfs_path_t *vfs_path_from_str_flags (const char *path_str, vfs_path_flag_t flags);
+void vfs_path_cache_flush (void);
 vfs_path_t *vfs_path_build_filename (const char *first_element, ...);
 vfs_path_t *vfs_path_append_new (const vfs_path_t *vpath, const char *first_element, ...);
 vfs_path_t *vfs_path_append_vpath_new (const vfs_path_t *first_vpath, ...);
@@ -45,6 +45,7 @@
 
 #include <errno.h>
 #include <stdlib.h>
+#include <unistd.h>  // copy_file_range()
 
 #ifdef __linux__
 #ifdef HAVE_LINUX_FS_H
@@ -488,6 +489,9 @@ vfs_shut (void)
 
     vfs_set_raw_current_dir (NULL);
 
+    // cached paths hold pointers into vfs__classes_list
+    vfs_path_cache_flush ();
+
     for (i = 0; i < vfs__classes_list->len; i++)
     {
         struct vfs_class *vfs = VFS_CLASS (g_ptr_array_index (vfs__classes_list, i));
@@ -759,3 +763,93 @@ vfs_clone_file (int dest_vfs_fd, int src_vfs_fd)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy data between two open files inside the kernel, without passing it through
+ * a userspace buffer. Both files must live on the local file system; the copy
+ * starts at the current file offsets and advances them, so the caller can mix
+ * this with read/write on the same descriptors.
+ *
+ * @param dest_vfs_fd mc VFS file handler of the destination
+ * @param src_vfs_fd mc VFS file handler of the source
+ * @param len maximum number of bytes to copy
+ *
+ * @return number of bytes copied (0 on EOF), or -1 with errno set; ENOTSUP means
+ *         the descriptors cannot be served and the caller should fall back.
+ */
+
+ssize_t
+vfs_copy_file_range (int dest_vfs_fd, int src_vfs_fd, size_t len)
+{
+#ifdef HAVE_COPY_FILE_RANGE
+    void *dest_fd = NULL;
+    void *src_fd = NULL;
+    struct vfs_class *dest_class;
+    struct vfs_class *src_class;
+
+    dest_class = vfs_class_find_by_handle (dest_vfs_fd, &dest_fd);
+    if ((dest_class->flags & VFSF_LOCAL) == 0)
+    {
+        errno = ENOTSUP;
+        return (-1);
+    }
+    if (dest_fd == NULL)
+    {
+        errno = EBADF;
+        return (-1);
+    }
+
+    src_class = vfs_class_find_by_handle (src_vfs_fd, &src_fd);
+    if (src_fd == NULL)
+    {
+        errno = EBADF;
+        return (-1);
+    }
+
+    if ((src_class->flags & VFSF_LOCAL) == 0)
+    {
+        /* a virtual class may still keep the data as a contiguous range of a local
+           file -- a member of an uncompressed tar archive, for instance */
+        vfs_local_range_t range;
+        struct vfs_class *back_class;
+        void *back_fd = NULL;
+        off_t off_in;
+        ssize_t res;
+
+        if (src_class->ctl == NULL
+            || src_class->ctl (src_fd, VFS_CTL_GET_LOCAL_RANGE, &range) == 0)
+        {
+            errno = ENOTSUP;
+            return (-1);
+        }
+
+        back_class = vfs_class_find_by_handle (range.vfs_fd, &back_fd);
+        if (back_class == NULL || (back_class->flags & VFSF_LOCAL) == 0 || back_fd == NULL)
+        {
+            errno = ENOTSUP;
+            return (-1);
+        }
+
+        len = MIN ((off_t) len, range.len);
+        if (len == 0)
+            return 0;
+
+        off_in = range.offset;
+        res = copy_file_range (*(int *) back_fd, &off_in, *(int *) dest_fd, NULL, len, 0);
+        // keep the handle position in step for a possible read/write fallback
+        if (res > 0 && src_class->lseek != NULL)
+            (void) src_class->lseek (src_fd, res, SEEK_CUR);
+
+        return res;
+    }
+
+    return copy_file_range (*(int *) src_fd, NULL, *(int *) dest_fd, NULL, len, 0);
+#else
+    (void) dest_vfs_fd;
+    (void) src_vfs_fd;
+    (void) len;
+    errno = ENOTSUP;
+    return (-1);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
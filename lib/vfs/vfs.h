@@ -117,9 +117,23 @@ typedef enum
 /* Operations for mc_ctl - on open file */
 enum
 {
-    VFS_CTL_IS_NOTREADY
+    VFS_CTL_IS_NOTREADY,
+
+    /* Fill in a vfs_local_range_t with the backing file and the range the next
+       sequential read would come from.  Returns non-zero only if the remaining
+       data is stored contiguously in a file of another (ideally local) class,
+       so the caller may move it inside the kernel. */
+    VFS_CTL_GET_LOCAL_RANGE
 };
 
+/* Answer of VFS_CTL_GET_LOCAL_RANGE */
+typedef struct
+{
+    int vfs_fd;    // VFS handle of the backing file (e.g. the archive)
+    off_t offset;  // position of the handle's current byte in that file
+    off_t len;     // contiguous bytes stored there from offset on
+} vfs_local_range_t;
+
 /* Operations for mc_setctl - on path */
 enum
 {
@@ -172,6 +186,14 @@ typedef struct vfs_class
     int (*lstat) (const vfs_path_t *vpath, struct stat *buf);
     int (*fstat) (void *vfs_info, struct stat *buf);
 
+    /**
+     * The optional fileno() method shall return the real file descriptor
+     * behind an open file, or -1 if there is none.  Classes whose data
+     * plane is a plain local file provide it so that per-chunk reads and
+     * writes can go straight to the kernel instead of through this table.
+     */
+    int (*fileno) (void *vfs_info);
+
     int (*chmod) (const vfs_path_t *vpath, mode_t mode);
     int (*chown) (const vfs_path_t *vpath, uid_t owner, gid_t group);
 
@@ -195,6 +217,22 @@ typedef struct vfs_class
     gboolean (*nothingisopen) (vfsid id);
     void (*free) (vfsid id);
 
+    /**
+     * The optional keepalive() method is called periodically for every
+     * stamped filesystem that has not expired yet, so that remote
+     * filesystems can keep their idle connections from being dropped
+     * by the peer before the VFS timeout frees them.
+     */
+    void (*keepalive) (vfsid id);
+
+    /**
+     * The optional memory_usage() method returns the approximate number of
+     * bytes the filesystem holds for its cached data.  The garbage collector
+     * uses it to evict stale filesystems over the vfs_memory_limit budget
+     * before their timeout.
+     */
+    guint64 (*memory_usage) (vfsid id);
+
     vfs_path_t *(*getlocalcopy) (const vfs_path_t *vpath);
     int (*ungetlocalcopy) (const vfs_path_t *vpath, const vfs_path_t *local_vpath,
                            gboolean has_changed);
@@ -224,6 +262,7 @@ struct vfs_dirent
 /*** global variables defined in .c file *********************************************************/
 
 extern int vfs_timeout;
+extern int vfs_memory_limit;
 
 #ifdef ENABLE_VFS_NET
 extern int use_netrc;
@@ -255,6 +294,7 @@ void vfs_setup_work_dir (void);
 void vfs_timeout_handler (void);
 int vfs_timeouts (void);
 void vfs_expire (gboolean now);
+guint64 vfs_memory_usage (void);
 
 const char *vfs_get_current_dir (void);
 char *vfs_get_current_dir_n (void);
@@ -302,6 +342,8 @@ int vfs_preallocate (int dest_desc, off_t src_fsize, off_t dest_fsize);
 
 int vfs_clone_file (int dest_vfs_fd, int src_vfs_fd);
 
+ssize_t vfs_copy_file_range (int dest_vfs_fd, int src_vfs_fd, size_t len);
+
 /**
  * Interface functions described in interface.c
  */
@@ -314,6 +356,9 @@ off_t mc_lseek (int fd, off_t offset, int whence);
 DIR *mc_opendir (const vfs_path_t *vpath);
 struct vfs_dirent *mc_readdir (DIR *dirp);
 int mc_closedir (DIR *dir);
+/* drop the short-lived mc_stat()/mc_lstat() memo for virtual filesystems;
+ * called by mutating VFS operations and when a filesystem is freed */
+void vfs_stat_cache_invalidate (void);
 MC_MOCKABLE int mc_stat (const vfs_path_t *vpath, struct stat *buf);
 int mc_mknod (const vfs_path_t *vpath, mode_t mode, dev_t dev);
 int mc_link (const vfs_path_t *vpath1, const vfs_path_t *vpath2);
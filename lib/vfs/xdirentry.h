@@ -69,6 +69,7 @@ struct vfs_s_super
     char *name;           // My name, whatever it means
     int fd_usage;         // Number of open files
     int ino_usage;        // Usage count of this superblock
+    guint64 mem_usage;    // Approximate bytes held by inodes and entries
     gboolean want_stale;  // If set, we do not flush cache properly
 #ifdef ENABLE_VFS_NET
     vfs_path_element_t *path_element;
@@ -95,6 +96,7 @@ struct vfs_s_inode
                                    use only for directories because they
                                    cannot be hardlinked */
     GQueue *subdir;             // If this is a directory, its entry. List of vfs_s_entry
+    GHashTable *subdir_hash;    // name -> vfs_s_entry mirror of subdir for O(1) lookups
     struct stat st;             // Parameters of this inode
     char *linkname;             // Symlink's contents
     char *localname;            // Filename of local file, if we have one
@@ -113,6 +115,17 @@ typedef struct
     vfs_linear_state_t linear;  // Is that file open with O_LINEAR?
 } vfs_file_handler_t;
 
+/* Buffered line reader for streamed listings, see vfs_s_read_line_interruptible().
+   Only to be used where the stream up to and including its terminator belongs to
+   the reader: bytes read ahead of the last returned line are discarded. */
+typedef struct
+{
+    int fd;
+    size_t pos;  // read position in buffer
+    size_t len;  // occupied part of buffer
+    char buffer[BUF_8K];
+} vfs_s_line_reader_t;
+
 /*
  * One of our subclasses (tar, cpio, shell, ftpfs) with data and methods.
  * Extends vfs_class.
@@ -144,7 +157,12 @@ struct vfs_s_subclass
 
     struct vfs_s_entry *(*find_entry) (struct vfs_class *me, struct vfs_s_inode *root,
                                        const char *path, int follow, int flags);
+    /* Fill 'ino' with the complete listing of 'path' in one remote operation.
+     * Callers stat every returned entry right away (panels, copy/move), and those stats
+     * are served from the entries built here, so the listing must carry full stat data;
+     * a names-only load would turn each of them into an extra remote round trip. */
     int (*dir_load) (struct vfs_class *me, struct vfs_s_inode *ino, const char *path);
+    // Whether the listing of 'ino' may still serve lookups, or dir_load must run again
     gboolean (*dir_uptodate) (struct vfs_class *me, struct vfs_s_inode *ino);
     int (*file_store) (struct vfs_class *me, vfs_file_handler_t *fh, char *path, char *localname);
 
@@ -182,6 +200,7 @@ const char *vfs_s_get_path (const vfs_path_t *vpath, struct vfs_s_super **archiv
 struct vfs_s_super *vfs_get_super_by_vpath (const vfs_path_t *vpath);
 
 void vfs_s_invalidate (struct vfs_class *me, struct vfs_s_super *super);
+void vfs_s_invalidate_dir (struct vfs_class *me, struct vfs_s_super *super, const char *a_path);
 char *vfs_s_fullpath (struct vfs_class *me, struct vfs_s_inode *ino);
 
 void vfs_s_init_fh (vfs_file_handler_t *fh, struct vfs_s_inode *ino, gboolean changed);
@@ -190,6 +209,9 @@ void vfs_s_init_fh (vfs_file_handler_t *fh, struct vfs_s_inode *ino, gboolean ch
 int vfs_s_select_on_two (int fd1, int fd2);
 int vfs_s_get_line (struct vfs_class *me, int sock, char *buf, int buf_len, char term);
 int vfs_s_get_line_interruptible (struct vfs_class *me, char *buffer, int size, int fd);
+void vfs_s_line_reader_init (vfs_s_line_reader_t *reader, int fd);
+int vfs_s_read_line_interruptible (struct vfs_class *me, vfs_s_line_reader_t *reader, char *buffer,
+                                   int size);
 /* misc */
 int vfs_s_retrieve_file (struct vfs_class *me, struct vfs_s_inode *ino);
 
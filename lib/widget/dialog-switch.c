@@ -35,6 +35,8 @@
 #include "lib/global.h"
 #include "lib/tty/tty.h"    // LINES, COLS
 #include "lib/tty/color.h"  // tty_set_normal_attrs()
+#include "lib/skin.h"       // NORMAL_COLOR
+#include "lib/trace.h"
 #include "lib/widget.h"
 #include "lib/event.h"
 
@@ -52,6 +54,9 @@ WDialog *filemanager = NULL;
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Default slow-operation watchdog threshold, microseconds */
+#define PERF_WATCHDOG_DEFAULT_US (100 * 1000)
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -65,10 +70,54 @@ static GList *mc_current = NULL;
 /* Is there any dialogs that we have to run after returning to the manager from another dialog */
 static gboolean dialog_switch_pending = FALSE;
 
+/* Frame-time HUD: set from the MC_PERF_HUD environment variable or toggled at
+ * runtime; shows the previous repaint and event dispatch times in the top
+ * right corner of the screen */
+static gboolean perf_hud_active = FALSE;
+static gboolean perf_initialized = FALSE;
+static gint64 perf_last_repaint_us = 0;
+static gint64 perf_last_dispatch_us = 0;
+static gint64 perf_watchdog_us = PERF_WATCHDOG_DEFAULT_US;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+perf_init (void)
+{
+    const char *env;
+
+    if (perf_initialized)
+        return;
+    perf_initialized = TRUE;
+
+    env = g_getenv ("MC_PERF_HUD");
+    perf_hud_active = env != NULL && (*env == '1' || g_ascii_strcasecmp (env, "true") == 0);
+
+    env = g_getenv ("MC_SLOW_OP_MS");
+    if (env != NULL)
+        perf_watchdog_us = g_ascii_strtoll (env, NULL, 10) * 1000;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Put the timings of the previous cycle into the top right corner of the screen. */
+
+static void
+perf_hud_draw (void)
+{
+    char buf[BUF_SMALL];
+    int len;
+
+    len = g_snprintf (buf, sizeof (buf), " paint %5.1f ms | op %6.1f ms ",
+                      perf_last_repaint_us / 1000.0, perf_last_dispatch_us / 1000.0);
+    tty_setcolor (NORMAL_COLOR);
+    tty_gotoyx (0, COLS - len);
+    tty_print_string (buf);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static unsigned char
 get_hotkey (int n)
 {
@@ -106,6 +155,10 @@ dialog_switch_goto (GList *dlg)
         else
         {
             // switch from editor, viewer, etc to another dialog
+            /* the screen still shows it whole: park the image so coming back
+               is one buffer write instead of a widget-tree repaint. The panels
+               are not parked - they are refreshed on return anyway */
+            dialog_switch_save_screen (old);
             widget_set_state (WIDGET (old), WST_SUSPENDED, TRUE);
 
             if (DIALOG (dlg->data) != filemanager)
@@ -181,6 +234,63 @@ dialog_switch_remove (WDialog *h)
         widget_set_state (WIDGET (mc_current->data), WST_ACTIVE, TRUE);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Park the current screen image on @h. Call at the moment the screen still
+ * shows the dialog whole, right before suspending it. */
+
+void
+dialog_switch_save_screen (WDialog *h)
+{
+    dialog_switch_drop_screen (h);
+    h->switch_snapshot = tty_screen_save ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Try to put the parked screen image of @h back. Returns TRUE when the screen
+ * was restored and no repaint is needed; the snapshot is consumed either way,
+ * from now on the dialog paints itself again. */
+
+gboolean
+dialog_switch_restore_screen (WDialog *h)
+{
+    gboolean ok = FALSE;
+
+    if (h->switch_snapshot != NULL)
+    {
+        // a pending resize means the saved image no longer matches the widgets
+        ok = !GROUP (h)->winch_pending && tty_screen_restore (h->switch_snapshot);
+        tty_screen_free (h->switch_snapshot);
+        h->switch_snapshot = NULL;
+    }
+
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+dialog_switch_drop_screen (WDialog *h)
+{
+    if (h->switch_snapshot != NULL)
+    {
+        tty_screen_free (h->switch_snapshot);
+        h->switch_snapshot = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Drop every parked screen image, e.g. after a skin change: the saved cells
+ * carry the old colors. */
+
+void
+dialog_switch_drop_all_screens (void)
+{
+    GList *dlg;
+
+    for (dlg = mc_dialogs; dlg != NULL; dlg = g_list_next (dlg))
+        dialog_switch_drop_screen (DIALOG (dlg->data));
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 size_t
@@ -315,7 +425,11 @@ dialog_switch_got_winch (void)
 
     for (dlg = mc_dialogs; dlg != NULL; dlg = g_list_next (dlg))
         if (dlg != mc_current)
+        {
             GROUP (dlg->data)->winch_pending = TRUE;
+            // the parked screen image does not fit the new size
+            dialog_switch_drop_screen (DIALOG (dlg->data));
+        }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -376,11 +490,21 @@ repaint_screen (void)
 void
 mc_refresh (void)
 {
+    const gint64 trace_start = mc_trace_begin ();
+    gint64 t0 = 0;
+
 #ifdef ENABLE_BACKGROUND
     if (mc_global.we_are_background)
         return;
 #endif
 
+    perf_init ();
+    if (perf_hud_active)
+    {
+        perf_hud_draw ();
+        t0 = g_get_monotonic_time ();
+    }
+
     if (!tty_got_winch ())
         tty_refresh ();
     else
@@ -389,6 +513,39 @@ mc_refresh (void)
            reposition/resize all */
         dialog_change_screen_size ();
     }
+
+    if (t0 != 0)
+        perf_last_repaint_us = g_get_monotonic_time () - t0;
+
+    mc_trace_end ("mc_refresh", trace_start, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_perf_hud_toggle (void)
+{
+    perf_init ();
+    perf_hud_active = !perf_hud_active;
+    repaint_screen ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Record the duration of one event dispatch of the dialog run loop.  Feeds the
+ * HUD and, when the duration exceeds the watchdog threshold (MC_SLOW_OP_MS,
+ * default 100; 0 disables), emits a "slow_op" trace point carrying the key
+ * code that triggered the slow operation.
+ */
+
+void
+mc_perf_record_dispatch (int key, gint64 duration_us)
+{
+    perf_init ();
+    perf_last_dispatch_us = duration_us;
+
+    if (perf_watchdog_us > 0 && duration_us >= perf_watchdog_us)
+        mc_trace_emit ("slow_op", duration_us, (guint64) key);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -22,6 +22,10 @@ extern WDialog *filemanager;
 
 void dialog_switch_add (WDialog *h);
 void dialog_switch_remove (WDialog *h);
+void dialog_switch_save_screen (WDialog *h);
+gboolean dialog_switch_restore_screen (WDialog *h);
+void dialog_switch_drop_screen (WDialog *h);
+void dialog_switch_drop_all_screens (void);
 size_t dialog_switch_num (void);
 
 void dialog_switch_next (void);
@@ -39,6 +43,10 @@ void repaint_screen (void);
 MC_MOCKABLE void mc_refresh (void);
 void dialog_change_screen_size (void);
 
+/* Frame-time HUD and slow-operation watchdog */
+void mc_perf_hud_toggle (void);
+void mc_perf_record_dispatch (int key, gint64 duration_us);
+
 /*** inline functions ****************************************************************************/
 
 #endif
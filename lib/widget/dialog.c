@@ -88,21 +88,16 @@ dlg_default_get_colors (const Widget *w)
 static void
 dlg_read_history (WDialog *h)
 {
-    char *profile;
     ev_history_load_save_t event_data;
 
     if (num_history_items_recorded == 0)  // this is how to disable
         return;
 
-    profile = mc_config_get_full_path (MC_HISTORY_FILE);
-    event_data.cfg = mc_config_init (profile, TRUE);
+    event_data.cfg = mc_config_history_open ();
     event_data.receiver = NULL;
 
     // create all histories in dialog
     mc_event_raise (h->event_group, MCEVENT_HISTORY_LOAD, &event_data);
-
-    mc_config_deinit (event_data.cfg);
-    g_free (profile);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -295,6 +290,7 @@ frontend_dlg_run (WDialog *h)
     while (widget_get_state (wh, WST_ACTIVE))
     {
         int d_key;
+        gint64 dispatch_start;
 
         if (tty_got_winch ())
             dialog_change_screen_size ();
@@ -318,7 +314,9 @@ frontend_dlg_run (WDialog *h)
         tty_got_interrupt ();
         d_key = tty_get_event (&event, GROUP (h)->mouse_status == MOU_REPEAT, TRUE);
 
+        dispatch_start = g_get_monotonic_time ();
         dlg_process_event (h, d_key, &event);
+        mc_perf_record_dispatch (d_key, g_get_monotonic_time () - dispatch_start);
 
         if (widget_get_state (wh, WST_CLOSED))
             send_message (h, NULL, MSG_VALIDATE, 0, NULL);
@@ -334,6 +332,7 @@ dlg_default_destroy (Widget *w)
 
     // if some widgets have history, save all histories at one moment here
     dlg_save_history (h);
+    dialog_switch_drop_screen (h);
     group_default_callback (w, NULL, MSG_DESTROY, 0, NULL);
     send_message (w, NULL, MSG_DESTROY, 0, NULL);
     mc_event_group_del (h->event_group);
@@ -510,7 +509,11 @@ dlg_init (WDialog *h)
         group_set_current_widget_next (g);
 
     widget_set_state (wh, WST_ACTIVE, TRUE);
-    widget_draw (wh);
+
+    /* a screen image parked by dialog_switch is still valid: put it back
+       instead of repainting the whole widget tree */
+    if (!dialog_switch_restore_screen (h))
+        widget_draw (wh);
 
     h->ret_value = 0;
 }
@@ -599,14 +602,13 @@ dlg_save_history (WDialog *h)
     {
         ev_history_load_save_t event_data;
 
-        event_data.cfg = mc_config_init (profile, FALSE);
+        event_data.cfg = mc_config_history_open ();
         event_data.receiver = NULL;
 
         // get all histories in dialog
         mc_event_raise (h->event_group, MCEVENT_HISTORY_SAVE, &event_data);
 
-        mc_config_save_file (event_data.cfg, NULL);
-        mc_config_deinit (event_data.cfg);
+        mc_config_history_flush ();
     }
 
     g_free (profile);
@@ -81,6 +81,10 @@ struct WDialog
 
     dlg_shortcut_str get_shortcut;  // Shortcut string
     dlg_title_str get_title;        // useless for modal dialogs
+
+    /* Screen image parked by dialog_switch when the dialog was suspended;
+       switching back restores it instead of repainting the widget tree */
+    void *switch_snapshot;
 };
 
 /*** global variables defined in .c file *********************************************************/
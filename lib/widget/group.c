@@ -468,6 +468,14 @@ group_default_resize (WGroup *g, WRect *r)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Redraw the whole group.
+ *
+ * This full pass runs only on explicit invalidation -- dialog open/close and switch,
+ * resize, ^L -- not per event: input events redraw just the widget that handled them.
+ * Unchanged children repainted here cost no terminal output either, since the tty
+ * backends diff the virtual screen against what is already displayed.
+ */
 
 static void
 group_draw (WGroup *g)
@@ -195,6 +195,7 @@ history_descriptor_init (history_descriptor_t *hd, int y, int x, GList *history,
     hd->text = NULL;
     hd->max_width = 0;
     hd->listbox = listbox_new (1, 1, 2, 2, TRUE, NULL);
+    hd->listbox->typeahead = TRUE;
     // in most cases history list contains string only and no any other data
     hd->create = history_create_item;
     hd->release = history_release_item;
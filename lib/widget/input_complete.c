@@ -85,6 +85,16 @@ typedef struct
     input_complete_t flags;
 } try_complete_automation_state_t;
 
+/* An entry of the cached directory enumeration used by filename_completion_function() */
+typedef struct
+{
+    char *name;
+    size_t len;
+    gboolean checked;  // isdir/isexec already looked up?
+    gboolean isdir;
+    gboolean isexec;
+} dir_cache_entry_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 MC_MOCKABLE GPtrArray *try_complete (char *text, int *lc_start, int *lc_end,
@@ -98,6 +108,13 @@ static int min_end;
 static int start = 0;
 static int end = 0;
 
+/* Filename completion keeps the enumeration of the last completed directory around, so that
+ * repeated Tab presses and prefix refinements match in memory instead of re-reading (and
+ * re-statting) the directory on every keystroke. */
+static char *dir_cache_name = NULL;  // directory the cache was built for
+static struct stat dir_cache_stat;   // its stat at enumeration time
+static GPtrArray *dir_cache = NULL;  // dir_cache_entry_t items
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -125,18 +142,142 @@ show_c_flags (input_complete_t flags)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+dir_cache_entry_free (gpointer data)
+{
+    dir_cache_entry_t *e = data;
+
+    g_free (e->name);
+    g_free (e);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_cache_invalidate (void)
+{
+    MC_PTR_FREE (dir_cache_name);
+    if (dir_cache != NULL)
+    {
+        g_ptr_array_free (dir_cache, TRUE);
+        dir_cache = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Reuse the cached enumeration if it is still for @dirname and the directory hasn't changed,
+ * otherwise re-read the directory. Entry types are not looked up here: they are filled in
+ * lazily by dir_cache_check_entry(), so building the cache costs one readdir() pass only.
+ */
+static void
+dir_cache_refresh (const char *dirname, const vfs_path_t *dirname_vpath)
+{
+    struct stat dirstat;
+    DIR *directory;
+    struct vfs_dirent *entry;
+
+    if (mc_stat (dirname_vpath, &dirstat) != 0)
+    {
+        dir_cache_invalidate ();
+        return;
+    }
+
+    // the (device, inode, mtime, size) quadruple is a good enough change detector
+    if (dir_cache_name != NULL && strcmp (dir_cache_name, dirname) == 0
+        && dir_cache_stat.st_dev == dirstat.st_dev && dir_cache_stat.st_ino == dirstat.st_ino
+        && dir_cache_stat.st_mtime == dirstat.st_mtime
+        && dir_cache_stat.st_size == dirstat.st_size)
+        return;
+
+    dir_cache_invalidate ();
+
+    directory = mc_opendir (dirname_vpath);
+    if (directory == NULL)
+        return;
+
+    dir_cache = g_ptr_array_new_with_free_func (dir_cache_entry_free);
+
+    while ((entry = mc_readdir (directory)) != NULL)
+    {
+        dir_cache_entry_t *e;
+
+        if (!str_is_valid_string (entry->d_name))
+            continue;
+
+        e = g_new (dir_cache_entry_t, 1);
+        e->name = g_strndup (entry->d_name, entry->d_len);
+        e->len = entry->d_len;
+        e->checked = FALSE;
+        e->isdir = TRUE;
+        e->isexec = FALSE;
+        g_ptr_array_add (dir_cache, e);
+    }
+
+    mc_closedir (directory);
+
+    dir_cache_name = g_strdup (dirname);
+    dir_cache_stat = dirstat;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/** Look up the type of a cached entry on first use; later completion rounds reuse the result. */
+static void
+dir_cache_check_entry (dir_cache_entry_t *e, const char *dirname)
+{
+    struct stat tempstat;
+    vfs_path_t *tmp_vpath;
+
+    if (e->checked)
+        return;
+
+    e->checked = TRUE;
+
+    tmp_vpath = vfs_path_build_filename (dirname, e->name, (char *) NULL);
+
+    // Unix version
+    if (mc_stat (tmp_vpath, &tempstat) == 0)
+    {
+        uid_t my_uid;
+        gid_t my_gid;
+
+        my_uid = getuid ();
+        my_gid = getgid ();
+
+        if (!S_ISDIR (tempstat.st_mode))
+        {
+            e->isdir = FALSE;
+
+            if ((my_uid == 0 && (tempstat.st_mode & 0111) != 0)
+                || (my_uid == tempstat.st_uid && (tempstat.st_mode & 0100) != 0)
+                || (my_gid == tempstat.st_gid && (tempstat.st_mode & 0010) != 0)
+                || (tempstat.st_mode & 0001) != 0)
+                e->isexec = TRUE;
+        }
+    }
+    else
+    {
+        // stat failed, strange. not a dir in any case
+        e->isdir = FALSE;
+    }
+    vfs_path_free (tmp_vpath, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static char *
 filename_completion_function (const char *text, int state, input_complete_t flags)
 {
-    static DIR *directory = NULL;
     static char *filename = NULL;
     static char *dirname = NULL;
     static char *users_dirname = NULL;
     static size_t filename_len = 0;
     static vfs_path_t *dirname_vpath = NULL;
+    static unsigned int dir_cache_p = 0;
 
-    gboolean isdir = TRUE, isexec = FALSE;
-    struct vfs_dirent *entry = NULL;
+    dir_cache_entry_t *found = NULL;
 
     SHOW_C_CTX ("filename_completion_function");
 
@@ -190,85 +331,52 @@ filename_completion_function (const char *text, int state, input_complete_t flag
            and `command`.
            Maybe a dream - UNIMPLEMENTED yet. */
 
-        directory = mc_opendir (dirname_vpath);
+        dir_cache_refresh (dirname, dirname_vpath);
+        dir_cache_p = 0;
         filename_len = strlen (filename);
     }
 
-    // Now that we have some state, we can read the directory.
-
-    while (directory != NULL && (entry = mc_readdir (directory)) != NULL)
-    {
-        if (!str_is_valid_string (entry->d_name))
-            continue;
+    // Now that we have some state, we can scan the cached directory listing.
 
-        /* Special case for no filename.
-           All entries except "." and ".." match. */
-        if (filename_len == 0)
+    if (dir_cache != NULL)
+        for (; dir_cache_p < dir_cache->len; dir_cache_p++)
         {
-            if (DIR_IS_DOT (entry->d_name) || DIR_IS_DOTDOT (entry->d_name))
-                continue;
-        }
-        else
-        {
-            /* Otherwise, if these match up to the length of filename, then
-               it may be a match. */
-            if (entry->d_name[0] != filename[0] || entry->d_len < filename_len
-                || strncmp (filename, entry->d_name, filename_len) != 0)
-                continue;
-        }
-
-        isdir = TRUE;
-        isexec = FALSE;
+            dir_cache_entry_t *e = g_ptr_array_index (dir_cache, dir_cache_p);
 
-        {
-            struct stat tempstat;
-            vfs_path_t *tmp_vpath;
-
-            tmp_vpath = vfs_path_build_filename (dirname, entry->d_name, (char *) NULL);
-
-            // Unix version
-            if (mc_stat (tmp_vpath, &tempstat) == 0)
+            /* Special case for no filename.
+               All entries except "." and ".." match. */
+            if (filename_len == 0)
             {
-                uid_t my_uid;
-                gid_t my_gid;
-
-                my_uid = getuid ();
-                my_gid = getgid ();
-
-                if (!S_ISDIR (tempstat.st_mode))
-                {
-                    isdir = FALSE;
-
-                    if ((my_uid == 0 && (tempstat.st_mode & 0111) != 0)
-                        || (my_uid == tempstat.st_uid && (tempstat.st_mode & 0100) != 0)
-                        || (my_gid == tempstat.st_gid && (tempstat.st_mode & 0010) != 0)
-                        || (tempstat.st_mode & 0001) != 0)
-                        isexec = TRUE;
-                }
+                if (DIR_IS_DOT (e->name) || DIR_IS_DOTDOT (e->name))
+                    continue;
             }
             else
             {
-                // stat failed, strange. not a dir in any case
-                isdir = FALSE;
+                /* Otherwise, if these match up to the length of filename, then
+                   it may be a match. */
+                if (e->name[0] != filename[0] || e->len < filename_len
+                    || strncmp (filename, e->name, filename_len) != 0)
+                    continue;
             }
-            vfs_path_free (tmp_vpath, TRUE);
+
+            dir_cache_check_entry (e, dirname);
+
+            if ((flags & INPUT_COMPLETE_COMMANDS) != 0 && (e->isexec || e->isdir))
+                break;
+            if ((flags & INPUT_COMPLETE_CD) != 0 && e->isdir)
+                break;
+            if ((flags & INPUT_COMPLETE_FILENAMES) != 0)
+                break;
         }
 
-        if ((flags & INPUT_COMPLETE_COMMANDS) != 0 && (isexec || isdir))
-            break;
-        if ((flags & INPUT_COMPLETE_CD) != 0 && isdir)
-            break;
-        if ((flags & INPUT_COMPLETE_FILENAMES) != 0)
-            break;
+    if (dir_cache != NULL && dir_cache_p < dir_cache->len)
+    {
+        found = g_ptr_array_index (dir_cache, dir_cache_p);
+        dir_cache_p++;
     }
 
-    if (entry == NULL)
+    if (found == NULL)
     {
-        if (directory != NULL)
-        {
-            mc_closedir (directory);
-            directory = NULL;
-        }
         MC_PTR_FREE (dirname);
         vfs_path_free (dirname_vpath, TRUE);
         dirname_vpath = NULL;
@@ -290,8 +398,8 @@ filename_completion_function (const char *text, int state, input_complete_t flag
             if (!IS_PATH_SEP (temp->str[temp->len - 1]))
                 g_string_append_c (temp, PATH_SEP);
         }
-        g_string_append_len (temp, entry->d_name, entry->d_len);
-        if (isdir)
+        g_string_append_len (temp, found->name, found->len);
+        if (found->isdir)
             g_string_append_c (temp, PATH_SEP);
 
         return g_string_free (temp, FALSE);
@@ -53,8 +53,18 @@ const global_keymap_t *listbox_map = NULL;
 /* Gives the position of the last item. */
 #define LISTBOX_LAST(l) (listbox_is_empty (l) ? 0 : (int) g_queue_get_length ((l)->list) - 1)
 
+/* Pause after which the collected type-ahead prefix is forgotten */
+#define LISTBOX_TYPEAHEAD_TIMEOUT G_USEC_PER_SEC
+
 /*** file scope type declarations ****************************************************************/
 
+/* one slot of the type-ahead prefix index */
+typedef struct
+{
+    char *key;  // entry text with ASCII letters lowercased
+    int pos;    // position of the entry in the list
+} listbox_index_entry_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -89,6 +99,193 @@ listbox_entry_free (void *data)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Return the link at @pos, walking from the nearest known point: the head, the tail, or the
+ * cached last accessed link. Consecutive accesses (cursor movement, redraws of the visible
+ * window) thus cost a few link hops instead of a scan from the head of a possibly huge list.
+ */
+static GList *
+listbox_get_link (WListbox *l, int pos)
+{
+    int length;
+    int le_pos;
+    GList *le;
+
+    if (l->list == NULL)
+        return NULL;
+
+    length = (int) g_queue_get_length (l->list);
+    if (pos < 0 || pos >= length)
+        return NULL;
+
+    le = g_queue_peek_head_link (l->list);
+    le_pos = 0;
+
+    if (length - 1 - pos < pos)
+    {
+        le = g_queue_peek_tail_link (l->list);
+        le_pos = length - 1;
+    }
+
+    if (l->cache_le != NULL && ABS (l->cache_pos - pos) < ABS (le_pos - pos))
+    {
+        le = l->cache_le;
+        le_pos = l->cache_pos;
+    }
+
+    for (; le_pos < pos; le_pos++)
+        le = g_list_next (le);
+    for (; le_pos > pos; le_pos--)
+        le = g_list_previous (le);
+
+    l->cache_le = le;
+    l->cache_pos = pos;
+
+    return le;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Any change of the list contents makes both keys and positions stale. */
+static void
+listbox_typeahead_invalidate (WListbox *l)
+{
+    if (l->typeahead_index != NULL)
+    {
+        guint i;
+
+        for (i = 0; i < l->typeahead_index->len; i++)
+            g_free (g_array_index (l->typeahead_index, listbox_index_entry_t, i).key);
+        g_array_free (l->typeahead_index, TRUE);
+        l->typeahead_index = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+listbox_index_entry_cmp (gconstpointer a, gconstpointer b)
+{
+    return strcmp (((const listbox_index_entry_t *) a)->key,
+                   ((const listbox_index_entry_t *) b)->key);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+listbox_typeahead_index_build (WListbox *l)
+{
+    GList *le;
+    int i;
+
+    l->typeahead_index = g_array_sized_new (FALSE, FALSE, sizeof (listbox_index_entry_t),
+                                            g_queue_get_length (l->list));
+
+    for (i = 0, le = g_queue_peek_head_link (l->list); le != NULL; i++, le = g_list_next (le))
+    {
+        listbox_index_entry_t ie;
+
+        ie.key = g_ascii_strdown (LENTRY (le->data)->text, -1);
+        ie.pos = i;
+        g_array_append_val (l->typeahead_index, ie);
+    }
+
+    g_array_sort (l->typeahead_index, listbox_index_entry_cmp);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Binary search for the alphabetically first entry whose key starts with @prefix. */
+static int
+listbox_typeahead_lookup (const WListbox *l, const char *prefix, gsize len)
+{
+    guint lo = 0;
+    guint hi = l->typeahead_index->len;
+    const listbox_index_entry_t *ie;
+
+    while (lo < hi)
+    {
+        const guint mid = lo + (hi - lo) / 2;
+
+        ie = &g_array_index (l->typeahead_index, listbox_index_entry_t, mid);
+        if (strncmp (ie->key, prefix, len) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == l->typeahead_index->len)
+        return (-1);
+
+    ie = &g_array_index (l->typeahead_index, listbox_index_entry_t, lo);
+    return strncmp (ie->key, prefix, len) == 0 ? ie->pos : -1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Incremental type-ahead: printable keys accumulate into a prefix and the selection jumps to
+ * the first item starting with it (ASCII-case-insensitively), Backspace widens it again.
+ * Dialog and entry hotkeys keep precedence, since the group dispatches MSG_HOTKEY before the
+ * focused widget sees MSG_KEY.
+ */
+static cb_ret_t
+listbox_typeahead_key (WListbox *l, int key)
+{
+    gint64 now;
+    char *folded;
+    int pos;
+
+    if (!l->typeahead || listbox_is_empty (l))
+        return MSG_NOT_HANDLED;
+
+    now = g_get_monotonic_time ();
+    if (l->typeahead_prefix == NULL)
+        l->typeahead_prefix = g_string_new ("");
+    else if (now - l->typeahead_time > LISTBOX_TYPEAHEAD_TIMEOUT)
+        g_string_set_size (l->typeahead_prefix, 0);
+
+    if (key == KEY_BACKSPACE)
+    {
+        if (l->typeahead_prefix->len == 0)
+            return MSG_NOT_HANDLED;
+
+        g_string_truncate (l->typeahead_prefix, l->typeahead_prefix->len - 1);
+        l->typeahead_time = now;
+        return MSG_HANDLED;
+    }
+
+    // skip ascii control characters, anything else can be a valid character in some encoding
+    if (key < 32 || key >= 256)
+        return MSG_NOT_HANDLED;
+
+    if (l->typeahead_index == NULL)
+        listbox_typeahead_index_build (l);
+
+    g_string_append_c (l->typeahead_prefix, (char) key);
+    folded = g_ascii_strdown (l->typeahead_prefix->str, (gssize) l->typeahead_prefix->len);
+    pos = listbox_typeahead_lookup (l, folded, l->typeahead_prefix->len);
+    g_free (folded);
+
+    if (pos < 0)
+    {
+        // no item starts with the extended prefix: don't extend it
+        g_string_truncate (l->typeahead_prefix, l->typeahead_prefix->len - 1);
+        if (l->typeahead_prefix->len == 0)
+            return MSG_NOT_HANDLED;
+
+        // narrowing is in progress: swallow the typo instead of triggering something else
+        l->typeahead_time = now;
+        return MSG_HANDLED;
+    }
+
+    l->typeahead_time = now;
+    listbox_set_current (l, pos);
+    return MSG_HANDLED;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 listbox_drawscroll (const WListbox *l)
 {
@@ -153,7 +350,7 @@ listbox_draw (WListbox *l, gboolean focused)
     if (l->list != NULL)
     {
         length = g_queue_get_length (l->list);
-        le = g_queue_peek_nth_link (l->list, (guint) l->top);
+        le = listbox_get_link (l, l->top);
     }
 
     //    pos = (le == NULL) ? 0 : g_list_position (l->list, le);
@@ -350,6 +547,9 @@ listbox_key (WListbox *l, int key)
     if (l->list == NULL)
         return MSG_NOT_HANDLED;
 
+    if (listbox_typeahead_key (l, key) == MSG_HANDLED)
+        return MSG_HANDLED;
+
     // focus on listbox item N by '0'..'9' keys
     if (key >= '0' && key <= '9')
     {
@@ -369,6 +569,8 @@ listbox_key (WListbox *l, int key)
 static inline void
 listbox_add_entry (WListbox *l, WLEntry *e, listbox_append_t pos)
 {
+    listbox_typeahead_invalidate (l);
+
     if (l->list == NULL)
     {
         l->list = g_queue_new ();
@@ -378,19 +580,23 @@ listbox_add_entry (WListbox *l, WLEntry *e, listbox_append_t pos)
     switch (pos)
     {
     case LISTBOX_APPEND_AT_END:
+        // appending doesn't move any existing link: the lookup cache stays valid
         g_queue_push_tail (l->list, e);
         break;
 
     case LISTBOX_APPEND_BEFORE:
-        g_queue_insert_before (l->list, g_queue_peek_nth_link (l->list, (guint) l->current), e);
+        g_queue_insert_before (l->list, listbox_get_link (l, l->current), e);
+        l->cache_le = NULL;
         break;
 
     case LISTBOX_APPEND_AFTER:
-        g_queue_insert_after (l->list, g_queue_peek_nth_link (l->list, (guint) l->current), e);
+        g_queue_insert_after (l->list, listbox_get_link (l, l->current), e);
+        l->cache_le = NULL;
         break;
 
     case LISTBOX_APPEND_SORTED:
         g_queue_insert_sorted (l->list, e, (GCompareDataFunc) listbox_entry_cmp, NULL);
+        l->cache_le = NULL;
         break;
 
     default:
@@ -448,6 +654,12 @@ static inline void
 listbox_destroy (WListbox *l)
 {
     listbox_remove_list (l);
+
+    if (l->typeahead_prefix != NULL)
+    {
+        g_string_free (l->typeahead_prefix, TRUE);
+        l->typeahead_prefix = NULL;
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -567,10 +779,16 @@ listbox_new (int y, int x, int height, int width, gboolean deletable, lcback_fn
 
     l->list = NULL;
     l->top = l->current = 0;
+    l->cache_le = NULL;
+    l->cache_pos = 0;
     l->deletable = deletable;
     l->callback = callback;
     l->allow_duplicates = TRUE;
     l->scrollbar = !mc_global.tty.slow_terminal;
+    l->typeahead = FALSE;
+    l->typeahead_prefix = NULL;
+    l->typeahead_time = 0;
+    l->typeahead_index = NULL;
 
     return l;
 }
@@ -654,37 +872,26 @@ listbox_select_last (WListbox *l)
 void
 listbox_set_current (WListbox *l, int dest)
 {
-    GList *le;
-    int pos;
-    gboolean top_seen = FALSE;
-
     if (listbox_is_empty (l) || dest < 0)
         return;
 
-    // Special case
-    for (pos = 0, le = g_queue_peek_head_link (l->list); le != NULL; pos++, le = g_list_next (le))
+    if (dest >= listbox_get_length (l))
     {
-        if (pos == l->top)
-            top_seen = TRUE;
-
-        if (pos == dest)
-        {
-            l->current = dest;
-            if (!top_seen)
-                l->top = l->current;
-            else
-            {
-                int lines = WIDGET (l)->rect.lines;
-
-                if (l->current - l->top >= lines)
-                    l->top = l->current - lines + 1;
-            }
-            return;
-        }
+        // If we are unable to find it, set decent values
+        l->current = l->top = 0;
+        return;
     }
 
-    // If we are unable to find it, set decent values
-    l->current = l->top = 0;
+    l->current = dest;
+    if (l->top > dest)
+        l->top = l->current;
+    else
+    {
+        int lines = WIDGET (l)->rect.lines;
+
+        if (l->current - l->top >= lines)
+            l->top = l->current - lines + 1;
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -719,13 +926,13 @@ listbox_get_current (WListbox *l, char **string, void **extra)
 /* --------------------------------------------------------------------------------------------- */
 
 WLEntry *
-listbox_get_nth_entry (const WListbox *l, int pos)
+listbox_get_nth_entry (WListbox *l, int pos)
 {
-    if (!listbox_is_empty (l) && pos >= 0)
+    if (!listbox_is_empty (l))
     {
         GList *item;
 
-        item = g_queue_peek_nth_link (l->list, (guint) pos);
+        item = listbox_get_link (l, pos);
         if (item != NULL)
             return LENTRY (item->data);
     }
@@ -751,9 +958,11 @@ listbox_remove_current (WListbox *l)
         GList *current;
         int length;
 
-        current = g_queue_peek_nth_link (l->list, (guint) l->current);
+        current = listbox_get_link (l, l->current);
         listbox_entry_free (current->data);
         g_queue_delete_link (l->list, current);
+        l->cache_le = NULL;
+        listbox_typeahead_invalidate (l);
 
         length = g_queue_get_length (l->list);
 
@@ -803,6 +1012,9 @@ listbox_remove_list (WListbox *l)
         }
 
         l->current = l->top = 0;
+        l->cache_le = NULL;
+        l->cache_pos = 0;
+        listbox_typeahead_invalidate (l);
     }
 }
 
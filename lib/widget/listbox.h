@@ -52,6 +52,12 @@ typedef struct WListbox
     gboolean deletable;         // Can list entries be deleted?
     lcback_fn callback;         // The callback function
     int cursor_x, cursor_y;     // Cache the values
+    GList *cache_le;            // Last accessed link, or NULL (lookup cache)
+    int cache_pos;              // Position of cache_le in the list
+    gboolean typeahead;         // Jump to items by typing a prefix of their text
+    GString *typeahead_prefix;  // Collected type-ahead prefix, or NULL
+    gint64 typeahead_time;      // Time of the last type-ahead key, for the reset timeout
+    GArray *typeahead_index;    // Entry texts sorted for prefix lookup, or NULL (stale)
 } WListbox;
 
 /*** global variables defined in .c file *********************************************************/
@@ -68,7 +74,7 @@ void listbox_select_last (WListbox *l);
 void listbox_set_current (WListbox *l, int dest);
 int listbox_get_length (const WListbox *l);
 void listbox_get_current (WListbox *l, char **string, void **extra);
-WLEntry *listbox_get_nth_entry (const WListbox *l, int pos);
+WLEntry *listbox_get_nth_entry (WListbox *l, int pos);
 GList *listbox_get_first_link (const WListbox *l);
 void listbox_remove_current (WListbox *l);
 gboolean listbox_is_empty (const WListbox *l);
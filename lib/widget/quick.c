@@ -187,7 +187,7 @@ quick_dialog_skip (quick_dialog_t *quick_dlg, int nskip)
     GList *input_labels = NULL;  // Widgets not directly requested by the user.
     int return_val;
 
-    len = str_term_width1 (I18N (quick_dlg->title)) + 6;
+    len = str_term_width1_memo (I18N (quick_dlg->title)) + 6;
     quick_dlg->rect.cols = MAX (quick_dlg->rect.cols, len);
 
     y = 1;
@@ -296,7 +296,7 @@ quick_dialog_skip (quick_dialog_t *quick_dlg, int nskip)
 
         case quick_start_groupbox:
             I18N (quick_widget->u.groupbox.title);
-            len = str_term_width1 (quick_widget->u.groupbox.title);
+            len = str_term_width1_memo (quick_widget->u.groupbox.title);
             g = groupbox_new (++y, x, 1, len + 4, quick_widget->u.groupbox.title);
             item.widget = WIDGET (g);
             g_array_append_val (widgets, item);
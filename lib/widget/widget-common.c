@@ -241,9 +241,9 @@ hotkey_width (const hotkey_t hotkey)
 {
     int result;
 
-    result = str_term_width1 (hotkey.start);
-    result += (hotkey.hotkey != NULL) ? str_term_width1 (hotkey.hotkey) : 0;
-    result += (hotkey.end != NULL) ? str_term_width1 (hotkey.end) : 0;
+    result = str_term_width1_memo (hotkey.start);
+    result += (hotkey.hotkey != NULL) ? str_term_width1_memo (hotkey.hotkey) : 0;
+    result += (hotkey.end != NULL) ? str_term_width1_memo (hotkey.end) : 0;
     return result;
 }
 
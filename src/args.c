@@ -57,6 +57,9 @@ gboolean mc_args__force_colors = FALSE;
 /* Don't load keymap from file and use default one */
 gboolean mc_args__nokeymap = FALSE;
 
+/* Report per-phase startup timing on exit */
+gboolean mc_args__profile_startup = FALSE;
+
 char *mc_args__last_wd_file = NULL;
 
 /* when enabled NETCODE, use following file as logfile */
@@ -176,7 +179,17 @@ static const GOptionEntry argument_main_table[] = {
     },
 #endif
 
-// debug options
+    // debug options
+    {
+        "profile-startup",
+        '\0',
+        G_OPTION_FLAG_IN_MAIN,
+        G_OPTION_ARG_NONE,
+        &mc_args__profile_startup,
+        N_ ("Report per-phase startup timing on exit"),
+        NULL,
+    },
+
 #ifdef ENABLE_VFS_FTP
     {
         "ftplog",
@@ -29,9 +29,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 
 #include "lib/global.h"
 #include "lib/fileloc.h"
+#include "lib/unixcompat.h"  // ESC_STR
 #include "lib/mcconfig.h"
 #include "lib/util.h"
 #include "lib/event.h"
@@ -48,8 +50,17 @@
 char *clipboard_store_path = NULL;
 char *clipboard_paste_path = NULL;
 
+/* also announce copies to the terminal via OSC 52, so remote sessions reach
+ * the local clipboard without any utility or X connection */
+gboolean clipboard_osc52 = FALSE;
+
 /*** file scope macro definitions ****************************************************************/
 
+/* xterm truncates OSC 52 answers at 100000 bytes by default; a silently cut-off
+ * clipboard is worse than leaving it to the external utility, so payloads whose
+ * base64 form would not fit are not emitted at all */
+#define OSC52_RAW_LIMIT 74800
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -62,6 +73,47 @@ static const mode_t clip_open_mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
+/** Stream the clip file to the terminal as an OSC 52 sequence. The payload is
+ * base64-encoded chunk by chunk, so no copy of the whole block is ever built
+ * in memory. */
+
+static void
+clipboard_file_to_osc52 (const char *fname)
+{
+    FILE *f;
+    char inbuf[BUF_LARGE];
+    // base64 worst case for one input chunk, see g_base64_encode_step()
+    gchar outbuf[(BUF_LARGE / 3 + 1) * 4 + 4];
+    gint state = 0;
+    gint save = 0;
+    size_t nread;
+    gsize n;
+    struct stat st;
+
+    if (stat (fname, &st) != 0 || !S_ISREG (st.st_mode) || st.st_size == 0
+        || st.st_size > OSC52_RAW_LIMIT)
+        return;
+
+    f = fopen (fname, "rb");
+    if (f == NULL)
+        return;
+
+    fputs (ESC_STR "]52;c;", stdout);
+
+    while ((nread = fread (inbuf, 1, sizeof (inbuf), f)) > 0)
+    {
+        n = g_base64_encode_step ((const guchar *) inbuf, nread, FALSE, outbuf, &state, &save);
+        (void) fwrite (outbuf, 1, n, stdout);
+    }
+
+    n = g_base64_encode_close (FALSE, outbuf, &state, &save);
+    (void) fwrite (outbuf, 1, n, stdout);
+
+    fputs (ESC_STR "\\", stdout);
+    (void) fflush (stdout);
+
+    fclose (f);
+}
 
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
@@ -72,23 +124,32 @@ gboolean
 clipboard_file_to_ext_clip (const gchar *event_group_name, const gchar *event_name,
                             gpointer init_data, gpointer data)
 {
-    char *tmp, *cmd;
+    char *tmp;
 
     (void) event_group_name;
     (void) event_name;
     (void) init_data;
     (void) data;
 
-    if (clipboard_store_path == NULL || clipboard_store_path[0] == '\0')
-        return TRUE;
-
     tmp = mc_config_get_full_path (EDIT_HOME_CLIP_FILE);
-    cmd = g_strconcat (clipboard_store_path, " ", tmp, " 2>/dev/null", (char *) NULL);
 
-    if (cmd != NULL)
-        my_system (EXECUTE_AS_SHELL, mc_global.shell->path, cmd);
+    if (clipboard_osc52 && mc_global.tty.xterm_flag)
+        clipboard_file_to_osc52 (tmp);
+
+    if (clipboard_store_path != NULL && clipboard_store_path[0] != '\0')
+    {
+        char *cmd;
+
+        /* the utility keeps serving the selection after it returns, there is
+         * nothing to wait for: detach it so large blocks don't stall the UI */
+        cmd = g_strconcat (clipboard_store_path, " ", tmp, " 2>/dev/null &", (char *) NULL);
+
+        if (cmd != NULL)
+            my_system (EXECUTE_AS_SHELL, mc_global.shell->path, cmd);
+
+        g_free (cmd);
+    }
 
-    g_free (cmd);
     g_free (tmp);
     return TRUE;
 }
@@ -15,6 +15,7 @@
 
 extern char *clipboard_store_path;
 extern char *clipboard_paste_path;
+extern gboolean clipboard_osc52;
 
 /*** declarations of public functions ************************************************************/
 
@@ -32,6 +32,7 @@
 #include <errno.h>
 #include <stddef.h>  // ptrdiff_t
 #include <stdlib.h>
+#include <string.h>  // memchr()
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -69,6 +70,10 @@
 #define FILE_READ_BUF  4096
 #define FILE_FLAG_TEMP (1 << 0)
 
+/* above this combined input size the line text is paged in from the original
+ * files on demand instead of being copied into memory line by line */
+#define FILE_INCORE_LIMIT (64 * 1024 * 1024)
+
 #define ADD_CH         '+'
 #define DEL_CH         '-'
 #define CHG_CH         '*'
@@ -77,6 +82,11 @@
 #define HDIFF_ENABLE   1
 #define HDIFF_MINCTX   5
 #define HDIFF_DEPTH    10
+/* cap on the m*n cost of one common-substring search; beyond it the changed region
+ * is highlighted as a whole instead of burning CPU on pathologically long lines */
+#define HDIFF_COST_LIMIT (256 * 1024)
+/* marks an hdiff slot whose horizontal diff was computed but yielded nothing usable */
+#define HDIFF_NONE (&hdiff_no_result)
 
 #define FILE_DIRTY(fs)                                                                             \
     do                                                                                             \
@@ -94,10 +104,36 @@ typedef enum
     FROM_RIGHT_TO_LEFT
 } action_direction_t;
 
+/* built-in diff engine: one line of an input file. Only the offset of the line within
+ * the mapping and a 64-bit hash of its canonical form are kept - 16 bytes per line no
+ * matter how long the lines are; the length is recovered from the following record */
+typedef struct
+{
+    guint64 off;
+    guint64 hash;
+} DLINE;
+
+/* built-in diff engine: one side of the comparison */
+typedef struct
+{
+    const char *buf;  // mapped file contents
+    guint64 size;
+    GArray *lines;  // DLINE records plus one sentinel at the end
+} DFILE;
+
+/* built-in diff engine: occurrences of one line within the region being diffed */
+typedef struct
+{
+    int count[DIFF_COUNT];
+    int idx[DIFF_COUNT];
+} LNOCC;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
+static GArray hdiff_no_result;  // only its address is used, see HDIFF_NONE
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -779,6 +815,456 @@ scan_diff (FBUF *f, GArray *ops)
     return ops->len;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/* built-in diff engine ***************************************************** */
+
+/**
+ * Get the next byte of a line as the active comparison options see it.
+ *
+ * Whitespace and case options of diff(1) only ever change which lines count as equal,
+ * so instead of keeping normalized copies of every line the engine compares and hashes
+ * lines through this little iterator.
+ *
+ * @param p line text
+ * @param len line length
+ * @param ip in/out: current position within the line
+ * @param dview view with the active comparison options
+ *
+ * @return next canonical byte, or -1 at the end of the line
+ */
+
+static int
+dff_canon_byte (const char *p, size_t len, size_t *ip, const WDiff *dview)
+{
+    size_t i = *ip;
+
+    while (i < len)
+    {
+        const unsigned char c = (unsigned char) p[i];
+
+        if (c == ' ' || c == '\t')
+        {
+            if (dview->opt.ignore_all_space)
+            {
+                i++;
+                continue;
+            }
+            if (dview->opt.ignore_space_change)
+            {
+                // a run of blanks counts as one space, a trailing run counts as nothing
+                while (i < len && (p[i] == ' ' || p[i] == '\t'))
+                    i++;
+                if (i == len)
+                    break;
+                *ip = i;
+                return ' ';
+            }
+        }
+
+        *ip = i + 1;
+        return dview->opt.ignore_case ? g_ascii_tolower ((gchar) c) : (int) c;
+    }
+
+    *ip = i;
+    return -1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Get the text of a line back from the mapping.
+ *
+ * @param df one side of the comparison
+ * @param i line index
+ * @param dview view with the active comparison options
+ * @param len out: line length without the terminating newline
+ * @param nonl out: TRUE for a last line with no terminating newline
+ *
+ * @return pointer to the line text within the mapping
+ */
+
+static const char *
+dff_line_text (const DFILE *df, int i, const WDiff *dview, size_t *len, gboolean *nonl)
+{
+    const guint64 off = g_array_index (df->lines, DLINE, i).off;
+    const guint64 next = g_array_index (df->lines, DLINE, i + 1).off;
+
+    // the sentinel of a file with no final newline sits one byte past the mapping
+    *nonl = next > df->size;
+    *len = (size_t) (next - off - 1);
+
+    if (dview->opt.strip_trailing_cr && *len != 0 && df->buf[off + *len - 1] == '\r')
+        (*len)--;
+
+    return df->buf + off;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static guint64
+dff_line_hash (const char *p, size_t len, gboolean nonl, const WDiff *dview)
+{
+    guint64 h = G_GUINT64_CONSTANT (14695981039346656037);  // FNV-1a
+    size_t i = 0;
+    int c;
+
+    while ((c = dff_canon_byte (p, len, &i, dview)) >= 0)
+    {
+        h ^= (unsigned char) c;
+        h *= G_GUINT64_CONSTANT (1099511628211);
+    }
+
+    return nonl ? h ^ 1 : h;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dff_line_equal (const DFILE *a, int ai, const DFILE *b, int bi, const WDiff *dview)
+{
+    const char *pa, *pb;
+    size_t la, lb;
+    gboolean nla, nlb;
+    size_t i = 0;
+    size_t j = 0;
+    int ca, cb;
+
+    if (g_array_index (a->lines, DLINE, ai).hash != g_array_index (b->lines, DLINE, bi).hash)
+        return FALSE;
+
+    pa = dff_line_text (a, ai, dview, &la, &nla);
+    pb = dff_line_text (b, bi, dview, &lb, &nlb);
+    if (nla != nlb)
+        return FALSE;
+
+    do
+    {
+        ca = dff_canon_byte (pa, la, &i, dview);
+        cb = dff_canon_byte (pb, lb, &j, dview);
+        if (ca != cb)
+            return FALSE;
+    }
+    while (ca >= 0);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Split a mapped file into line records. Nothing is copied: each record is the offset of
+ * the line and the hash of its canonical form, and a sentinel record marks the end.
+ */
+
+static void
+dff_load_file (DFILE *df, GMappedFile *map, const WDiff *dview)
+{
+    guint64 i = 0;
+
+    df->buf = g_mapped_file_get_contents (map);
+    df->size = g_mapped_file_get_length (map);
+    df->lines = g_array_new (FALSE, FALSE, sizeof (DLINE));
+
+    while (i < df->size)
+    {
+        DLINE ln;
+        const char *nl;
+        size_t len;
+        gboolean nonl;
+
+        nl = memchr (df->buf + i, '\n', df->size - i);
+        nonl = (nl == NULL);
+        len = (nl != NULL ? (guint64) (nl - df->buf) : df->size) - i;
+
+        ln.off = i;
+        i += len + 1;
+
+        if (dview->opt.strip_trailing_cr && len != 0 && df->buf[ln.off + len - 1] == '\r')
+            len--;
+
+        ln.hash = dff_line_hash (df->buf + ln.off, len, nonl, dview);
+        g_array_append_val (df->lines, ln);
+    }
+
+    // the sentinel: one byte past the last (possibly virtual) newline
+    {
+        DLINE ln;
+
+        ln.off = i > df->size ? i : df->size;
+        ln.hash = 0;
+        g_array_append_val (df->lines, ln);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Append one diff statement for the 0-based half-open ranges [l1,h1) x [l2,h2),
+ * using the same encoding that scan_line() produces from diff(1) output.
+ */
+
+static void
+dff_emit_op (GArray *ops, int l1, int h1, int l2, int h2)
+{
+    DIFFCMD op;
+
+    if (l1 == h1 && l2 == h2)
+        return;
+
+    if (l1 == h1)
+    {
+        op.cmd = 'a';
+        op.a[0][0] = l1;
+        op.a[0][1] = l1;
+        op.a[1][0] = l2 + 1;
+        op.a[1][1] = h2;
+    }
+    else if (l2 == h2)
+    {
+        op.cmd = 'd';
+        op.a[0][0] = l1 + 1;
+        op.a[0][1] = h1;
+        op.a[1][0] = l2;
+        op.a[1][1] = l2;
+    }
+    else
+    {
+        op.cmd = 'c';
+        op.a[0][0] = l1 + 1;
+        op.a[0][1] = h1;
+        op.a[1][0] = l2 + 1;
+        op.a[1][1] = h2;
+    }
+
+    g_array_append_val (ops, op);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Patience diff: match up the lines that are unique within both sides of the region,
+ * keep the longest chain of such matches that is in order on both sides, and recurse
+ * into the gaps between them. Runs in linear space and close to linear time; the result
+ * may occasionally be a slightly larger edit script than diff(1)'s minimal one, but it
+ * is always a correct one, and on big machine-generated files it is dramatically faster.
+ *
+ * @param a lines of the first file
+ * @param b lines of the second file
+ * @param l1, h1 0-based half-open region within a
+ * @param l2, h2 0-based half-open region within b
+ * @param ops list of diff statements to fill
+ * @param dview view with the active comparison options
+ */
+
+static void
+dff_patience (const DFILE *a, const DFILE *b, int l1, int h1, int l2, int h2, GArray *ops,
+              const WDiff *dview)
+{
+    GHashTable *occur;
+    GArray *pairs;
+    int i;
+
+    // strip the common prefix and suffix
+    while (l1 < h1 && l2 < h2 && dff_line_equal (a, l1, b, l2, dview))
+    {
+        l1++;
+        l2++;
+    }
+    while (h1 > l1 && h2 > l2 && dff_line_equal (a, h1 - 1, b, h2 - 1, dview))
+    {
+        h1--;
+        h2--;
+    }
+
+    if (l1 == h1 && l2 == h2)
+        return;
+
+    if (l1 == h1 || l2 == h2)
+    {
+        dff_emit_op (ops, l1, h1, l2, h2);
+        return;
+    }
+
+    /* Count the occurrences of every line of the region on both sides. The table is
+     * keyed by the canonical hash alone: a collision can merge two distinct lines and
+     * thus lose a potential anchor, but the verification below makes sure it can never
+     * produce a wrong match. */
+    occur = g_hash_table_new_full (g_int64_hash, g_int64_equal, NULL, g_free);
+
+    for (i = l1; i < h1; i++)
+    {
+        guint64 *hash = &g_array_index (a->lines, DLINE, i).hash;
+        LNOCC *oc;
+
+        oc = g_hash_table_lookup (occur, hash);
+        if (oc == NULL)
+        {
+            oc = g_new0 (LNOCC, 1);
+            g_hash_table_insert (occur, hash, oc);
+        }
+        oc->count[DIFF_LEFT]++;
+        oc->idx[DIFF_LEFT] = i;
+    }
+
+    for (i = l2; i < h2; i++)
+    {
+        guint64 *hash = &g_array_index (b->lines, DLINE, i).hash;
+        LNOCC *oc;
+
+        oc = g_hash_table_lookup (occur, hash);
+        if (oc != NULL)
+        {
+            oc->count[DIFF_RIGHT]++;
+            oc->idx[DIFF_RIGHT] = i;
+        }
+    }
+
+    // pair up the lines that are unique on both sides, in left file order
+    pairs = g_array_new (FALSE, FALSE, sizeof (PAIR));
+
+    for (i = l1; i < h1; i++)
+    {
+        const LNOCC *oc;
+
+        oc = g_hash_table_lookup (occur, &g_array_index (a->lines, DLINE, i).hash);
+        if (oc->count[DIFF_LEFT] == 1 && oc->count[DIFF_RIGHT] == 1
+            && dff_line_equal (a, i, b, oc->idx[DIFF_RIGHT], dview))
+        {
+            PAIR p;
+
+            p[DIFF_LEFT] = i;
+            p[DIFF_RIGHT] = oc->idx[DIFF_RIGHT];
+            g_array_append_val (pairs, p);
+        }
+    }
+
+    g_hash_table_destroy (occur);
+
+    if (pairs->len == 0)
+        // no anchors at all: report the whole region as changed
+        dff_emit_op (ops, l1, h1, l2, h2);
+    else
+    {
+        int *tails;
+        int *prev;
+        int ntail = 0;
+        int k;
+
+        /* patience sorting: the longest subsequence of pairs that is ascending on the
+         * right side too (the left side is ascending by construction) */
+        tails = g_new (int, pairs->len);
+        prev = g_new (int, pairs->len);
+
+        for (i = 0; i < (int) pairs->len; i++)
+        {
+            const int ri = g_array_index (pairs, PAIR, i)[DIFF_RIGHT];
+            int lo = 0;
+            int hi = ntail;
+
+            while (lo < hi)
+            {
+                const int mid = (lo + hi) / 2;
+
+                if (g_array_index (pairs, PAIR, tails[mid])[DIFF_RIGHT] < ri)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+
+            prev[i] = lo > 0 ? tails[lo - 1] : -1;
+            tails[lo] = i;
+            if (lo == ntail)
+                ntail++;
+        }
+
+        // reuse tails[] to hold the chain of anchors in ascending order
+        i = ntail;
+        for (k = tails[ntail - 1]; k >= 0; k = prev[k])
+            tails[--i] = k;
+
+        // recurse into the gaps between consecutive anchors
+        {
+            int prev1 = l1;
+            int prev2 = l2;
+
+            for (k = 0; k < ntail; k++)
+            {
+                const int *m = g_array_index (pairs, PAIR, tails[k]);
+
+                dff_patience (a, b, prev1, m[DIFF_LEFT], prev2, m[DIFF_RIGHT], ops, dview);
+                prev1 = m[DIFF_LEFT] + 1;
+                prev2 = m[DIFF_RIGHT] + 1;
+            }
+
+            dff_patience (a, b, prev1, h1, prev2, h2, ops, dview);
+        }
+
+        g_free (prev);
+        g_free (tails);
+    }
+
+    g_array_free (pairs, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Compare the two files with the built-in patience engine and extract diff statements.
+ *
+ * The files are mapped, not read: the line table holds offsets into the mappings and
+ * nothing is copied, so memory use stays at a few words per line even for huge inputs.
+ *
+ * @param dview view with the file names and comparison options
+ * @param ops list of diff statements to fill
+ *
+ * @return non-negative number of hunks on success, negative if the caller should run
+ *         diff(1) instead (unsupported option, unreadable or non-regular file, ...)
+ */
+
+static int
+dff_compute (const WDiff *dview, GArray *ops)
+{
+    GMappedFile *map[DIFF_COUNT] = { NULL, NULL };
+    DFILE df[DIFF_COUNT];
+    diff_place_t ord;
+    int rv = -1;
+
+    df[DIFF_LEFT].lines = NULL;
+    df[DIFF_RIGHT].lines = NULL;
+
+    /* "Minimal" quality explicitly asks for diff(1)'s minimal edit script, and tab
+     * expansion has no canonical per-line form to hash; leave those to diff(1).
+     * Likewise any extra arguments beyond the usual "treat as text". */
+    if (dview->opt.quality != 0 || dview->opt.ignore_tab_expansion
+        || strcmp (dview->args, "-a") != 0)
+        return -1;
+
+    for (ord = DIFF_LEFT; ord < DIFF_COUNT; ord++)
+    {
+        map[ord] = g_mapped_file_new (dview->file[ord], FALSE, NULL);
+        if (map[ord] == NULL)
+            goto done;
+    }
+
+    for (ord = DIFF_LEFT; ord < DIFF_COUNT; ord++)
+        dff_load_file (&df[ord], map[ord], dview);
+
+    dff_patience (&df[DIFF_LEFT], &df[DIFF_RIGHT], 0, (int) df[DIFF_LEFT].lines->len - 1, 0,
+                  (int) df[DIFF_RIGHT].lines->len - 1, ops, dview);
+    rv = (int) ops->len;
+
+done:
+    for (ord = DIFF_LEFT; ord < DIFF_COUNT; ord++)
+    {
+        if (df[ord].lines != NULL)
+            g_array_free (df[ord].lines, TRUE);
+        if (map[ord] != NULL)
+            g_mapped_file_unref (map[ord]);
+    }
+
+    return rv;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 /**
@@ -1000,6 +1486,10 @@ lcsubstr (const char *s, int m, const char *t, int n, GArray *ret, int min)
         return 0;
     }
 
+    // degrade to a whole-region highlight instead of an unbounded quadratic search
+    if ((size_t) m * (size_t) n > HDIFF_COST_LIMIT)
+        return 0;
+
     Lprev = g_try_new0 (int, n + 1);
     if (Lprev == NULL)
         return -1;
@@ -1185,6 +1675,50 @@ hdiff_scan (const char *s, int m, const char *t, int n, int min, GArray *hdiff,
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Get the horizontal diff of one line pair, computing and caching it on first use.
+ *
+ * Only the pairs that actually make it onto the screen are ever computed; the cache
+ * lives until the files are rediffed.
+ *
+ * @param dview view with the line arrays and the cache
+ * @param i index of the line pair
+ *
+ * @return list of horizontal diff ranges, or NULL for plain whole-line highlight
+ */
+
+static GArray *
+hdiff_get (const WDiff *dview, size_t i)
+{
+    GArray *h;
+
+    h = g_ptr_array_index (dview->hdiff, i);
+    if (h == NULL)
+    {
+        const DIFFLN *p = &g_array_index (dview->a[DIFF_LEFT], DIFFLN, i);
+        const DIFFLN *q = &g_array_index (dview->a[DIFF_RIGHT], DIFFLN, i);
+
+        h = HDIFF_NONE;
+
+        if (p->line != 0 && q->line != 0 && p->ch == CHG_CH)
+        {
+            GArray *ranges;
+
+            ranges = g_array_new (FALSE, FALSE, sizeof (BRACKET));
+            if (hdiff_scan (p->p, p->u.len, q->p, q->u.len, HDIFF_MINCTX, ranges, HDIFF_DEPTH))
+                h = ranges;
+            else
+                g_array_free (ranges, TRUE);
+        }
+
+        g_ptr_array_index (dview->hdiff, i) = h;
+    }
+
+    return h != HDIFF_NONE ? h : NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /* read line **************************************************************** */
 
 /**
@@ -1695,7 +2229,14 @@ redo_diff (WDiff *dview)
     }
 
     ops = g_array_new (FALSE, FALSE, sizeof (DIFFCMD));
-    ndiff = dff_execute (dview->args, extra, dview->file[DIFF_LEFT], dview->file[DIFF_RIGHT], ops);
+    // the built-in engine covers the common options; anything else runs diff(1)
+    ndiff = dff_compute (dview, ops);
+    if (ndiff < 0)
+    {
+        g_array_set_size (ops, 0);
+        ndiff =
+            dff_execute (dview->args, extra, dview->file[DIFF_LEFT], dview->file[DIFF_RIGHT], ops);
+    }
     if (ndiff < 0)
     {
         if (ops != NULL)
@@ -1726,35 +2267,10 @@ redo_diff (WDiff *dview)
 
     if (dview->dsrc == DATA_SRC_MEM && HDIFF_ENABLE)
     {
-        size_t i;
-
+        /* the slots start out empty; hdiff_get() fills each one the first time its
+         * line pair is displayed */
         dview->hdiff = g_ptr_array_new ();
-
-        for (i = 0; i < dview->a[DIFF_LEFT]->len; i++)
-        {
-            GArray *h = NULL;
-            const DIFFLN *p;
-            const DIFFLN *q;
-
-            p = &g_array_index (dview->a[DIFF_LEFT], DIFFLN, i);
-            q = &g_array_index (dview->a[DIFF_RIGHT], DIFFLN, i);
-            if (p->line != 0 && q->line != 0 && p->ch == CHG_CH)
-            {
-                gboolean runresult;
-
-                h = g_array_new (FALSE, FALSE, sizeof (BRACKET));
-
-                runresult =
-                    hdiff_scan (p->p, p->u.len, q->p, q->u.len, HDIFF_MINCTX, h, HDIFF_DEPTH);
-                if (!runresult)
-                {
-                    g_array_free (h, TRUE);
-                    h = NULL;
-                }
-            }
-
-            g_ptr_array_add (dview->hdiff, h);
-        }
+        g_ptr_array_set_size (dview->hdiff, dview->a[DIFF_LEFT]->len);
     }
     return ndiff;
 }
@@ -1776,7 +2292,7 @@ destroy_hdiff (WDiff *dview)
             GArray *h;
 
             h = (GArray *) g_ptr_array_index (dview->hdiff, i);
-            if (h != NULL)
+            if (h != NULL && h != HDIFF_NONE)
                 g_array_free (h, TRUE);
         }
         g_ptr_array_free (dview->hdiff, TRUE);
@@ -2546,9 +3062,14 @@ dview_display_file (const WDiff *dview, diff_place_t ord, int r, int c, int heig
                 tty_setcolor (DFF_CHG_COLOR);
             if (f == NULL)
             {
+                GArray *h = NULL;
+
+                if (dview->hdiff != NULL)
+                    h = hdiff_get (dview, i);
+
                 if (i == (size_t) dview->search.last_found_line)
                     tty_setcolor (MARKED_SELECTED_COLOR);
-                else if (dview->hdiff != NULL && g_ptr_array_index (dview->hdiff, i) != NULL)
+                else if (h != NULL)
                 {
                     char att[BUFSIZ];
 
@@ -2557,8 +3078,7 @@ dview_display_file (const WDiff *dview, diff_place_t ord, int r, int c, int heig
                     else
                         k = width;
 
-                    cvt_mgeta (p->p, p->u.len, buf, k, skip, tab_size, show_cr,
-                               g_ptr_array_index (dview->hdiff, i), ord, att);
+                    cvt_mgeta (p->p, p->u.len, buf, k, skip, tab_size, show_cr, h, ord, att);
                     tty_gotoyx (r + j, c);
 
                     for (size_t cnt = 0; cnt < strlen (buf) && cnt < (size_t) width; cnt++)
@@ -3313,6 +3833,15 @@ diff_view (const char *file1, const char *file2, const char *label1, const char
     Widget *dw;
     WRect r;
     WGroup *g;
+    DSRC dsrc = DATA_SRC_MEM;
+    struct stat st1, st2;
+
+    /* Huge pairs are viewed without materializing every line in memory: the line table
+     * keeps only file offsets and the text of the visible lines is read back on demand.
+     * Intra-line change highlighting needs in-core lines and is skipped in that case. */
+    if (stat (file1, &st1) == 0 && stat (file2, &st2) == 0
+        && st1.st_size + st2.st_size > FILE_INCORE_LIMIT)
+        dsrc = DATA_SRC_ORG;
 
     // Create dialog and widgets, put them on the dialog
     dview_dlg = dlg_create (FALSE, 0, 0, 1, 1, WPOS_FULLSCREEN, FALSE, NULL, dview_dialog_callback,
@@ -3336,8 +3865,7 @@ diff_view (const char *file1, const char *file2, const char *label1, const char
 
     dview_dlg->get_title = dview_get_title;
 
-    error =
-        dview_init (dview, "-a", file1, file2, label1, label2, DATA_SRC_MEM);  // XXX binary diff?
+    error = dview_init (dview, "-a", file1, file2, label1, label2, dsrc);  // XXX binary diff?
     if (error >= 0)
         error = redo_diff (dview);
     if (error >= 0)
@@ -0,0 +1,263 @@
+/*
+   Editor autosave journal.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ *  \brief Source: editor autosave journal
+ *
+ *  Instead of periodically rewriting the whole file, unsaved changes are appended
+ *  to a journal in the cache directory as they are made: one short record per
+ *  inserted or deleted byte.  A successful save (or a clean close) removes the
+ *  journal; one left behind by a crashed session is offered for replay the next
+ *  time the file is opened, as long as the file on disk is still the base the
+ *  journal was recorded against.  The cost per edit is a few buffered bytes, so
+ *  safety persistence stays affordable for very large files.
+ */
+
+#include <config.h>
+
+#include <inttypes.h>  // uintmax_t
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/fileloc.h"   // EDIT_HOME_DIR
+#include "lib/mcconfig.h"  // mc_config_get_cache_path()
+#include "lib/util.h"      // mc_build_filename()
+#include "lib/vfs/vfs.h"   // mc_stat()
+#include "lib/widget.h"    // query_dialog()
+
+#include "edit-impl.h"
+#include "editwidget.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* The journal header carries the size and mtime of the file the records apply to */
+#define AUTOSAVE_MAGIC           "mcedit-autosave 1"
+
+/* Flush the journal after this many buffered records ... */
+#define AUTOSAVE_FLUSH_RECORDS   64
+
+/* ... or once this many seconds have passed since the last flush */
+#define AUTOSAVE_FLUSH_SECONDS   2
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* set while a journal is being replayed so the replay itself is not re-recorded */
+static gboolean autosave_replaying = FALSE;
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/** Journal location for the given editor: derived from the full file name. */
+
+static char *
+edit_autosave_journal_path (const WEdit *edit)
+{
+    const char *path = vfs_path_as_str (edit->filename_vpath);
+    char name[BUF_SMALL];
+
+    g_snprintf (name, sizeof (name), "autosave-%08x", g_str_hash (path));
+    return mc_build_filename (mc_config_get_cache_path (), EDIT_HOME_DIR, name, (char *) NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start a fresh journal for the current on-disk state of the file.
+ *
+ * @return FALSE if the journal cannot be created; recording is then skipped.
+ */
+
+static gboolean
+edit_autosave_begin (WEdit *edit)
+{
+    struct stat st;
+
+    // a file that does not exist yet has no base state to journal against
+    if (mc_stat (edit->filename_vpath, &st) != 0)
+        return FALSE;
+
+    edit->autosave_path = edit_autosave_journal_path (edit);
+    edit->autosave_file = fopen (edit->autosave_path, "w");
+    if (edit->autosave_file == NULL)
+    {
+        MC_PTR_FREE (edit->autosave_path);
+        return FALSE;
+    }
+
+    fprintf (edit->autosave_file, AUTOSAVE_MAGIC " %" PRIuMAX " %" PRIuMAX "\n",
+             (uintmax_t) st.st_size, (uintmax_t) st.st_mtime);
+    edit->autosave_flushed = time (NULL);
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Append one change to the journal.  Called from the byte-level editing primitives;
+ * op is 'i' for an inserted byte c at offset, 'd' for the byte deleted at offset.
+ */
+
+void
+edit_autosave_record (WEdit *edit, int op, off_t offset, int c)
+{
+    if (autosave_replaying || edit->loading_done == 0 || edit->filename_vpath == NULL)
+        return;
+
+    if (edit->autosave_file == NULL && !edit_autosave_begin (edit))
+        return;
+
+    if (op == 'i')
+        fprintf (edit->autosave_file, "i %" PRIuMAX " %d\n", (uintmax_t) offset, c);
+    else
+        fprintf (edit->autosave_file, "d %" PRIuMAX "\n", (uintmax_t) offset);
+
+    edit->autosave_pending++;
+    if (edit->autosave_pending >= AUTOSAVE_FLUSH_RECORDS
+        || time (NULL) >= edit->autosave_flushed + AUTOSAVE_FLUSH_SECONDS)
+    {
+        fflush (edit->autosave_file);
+        edit->autosave_pending = 0;
+        edit->autosave_flushed = time (NULL);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Discard the journal: the buffer was saved in full, or the changes were abandoned. */
+
+void
+edit_autosave_reset (WEdit *edit)
+{
+    if (edit->autosave_file != NULL)
+    {
+        fclose (edit->autosave_file);
+        edit->autosave_file = NULL;
+    }
+
+    if (edit->autosave_path != NULL)
+    {
+        unlink (edit->autosave_path);
+        MC_PTR_FREE (edit->autosave_path);
+    }
+
+    edit->autosave_pending = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Offer to replay a journal left behind by a crashed session.  Called once after the
+ * file has been loaded; on replay the journal stays in place and further changes are
+ * appended to it, so the recovered buffer remains protected until the next full save.
+ */
+
+void
+edit_autosave_recover (WEdit *edit)
+{
+    char *path;
+    FILE *f;
+    struct stat st;
+    uintmax_t size, mtime;
+    char line[BUF_MEDIUM];
+
+    if (edit->filename_vpath == NULL)
+        return;
+
+    path = edit_autosave_journal_path (edit);
+    f = fopen (path, "r");
+    if (f == NULL)
+    {
+        g_free (path);
+        return;
+    }
+
+    // the journal only makes sense against the exact base it was recorded from
+    if (fgets (line, sizeof (line), f) == NULL
+        || sscanf (line, AUTOSAVE_MAGIC " %" SCNuMAX " %" SCNuMAX, &size, &mtime) != 2
+        || mc_stat (edit->filename_vpath, &st) != 0 || (uintmax_t) st.st_size != size
+        || (uintmax_t) st.st_mtime != mtime)
+    {
+        fclose (f);
+        unlink (path);
+        g_free (path);
+        return;
+    }
+
+    if (edit_query_dialog2 (_ ("Recover file"),
+                            _ ("This file has an autosave journal from an interrupted "
+                               "session.\nReplay the unsaved changes?"),
+                            _ ("&Recover"), _ ("&Discard"))
+        != 0)
+    {
+        fclose (f);
+        unlink (path);
+        g_free (path);
+        return;
+    }
+
+    autosave_replaying = TRUE;
+    edit->undo_stack_disable = 1;  // the replayed changes are not undoable keystrokes
+
+    while (fgets (line, sizeof (line), f) != NULL)
+    {
+        uintmax_t offset;
+        int c;
+
+        if (sscanf (line, "i %" SCNuMAX " %d", &offset, &c) == 2)
+        {
+            edit_cursor_move (edit, (off_t) offset - edit->buffer.curs1);
+            edit_insert (edit, c);
+        }
+        else if (sscanf (line, "d %" SCNuMAX, &offset) == 1)
+        {
+            edit_cursor_move (edit, (off_t) offset - edit->buffer.curs1);
+            edit_delete (edit, TRUE);
+        }
+        else
+            break;  // a torn trailing record from the crash; everything before it applied
+    }
+
+    edit->undo_stack_disable = 0;
+    autosave_replaying = FALSE;
+    fclose (f);
+
+    // keep journaling on top of the recovered state
+    edit->autosave_path = path;
+    edit->autosave_file = fopen (path, "a");
+    if (edit->autosave_file == NULL)
+        MC_PTR_FREE (edit->autosave_path);
+    else
+        edit->autosave_flushed = time (NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
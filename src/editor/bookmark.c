@@ -27,6 +27,12 @@
  *  \brief Source: editor book mark handling
  *  \author Paul Sheer
  *  \date 1996, 1997
+ *
+ *  Book marks live in an array sorted by line, so the per-paint-line color query
+ *  is a binary search.  Line insertions and deletions do not renumber the marks
+ *  one by one: consecutive shifts are coalesced into a single pending offset that
+ *  is applied to the tail of the array in one pass before the next lookup, which
+ *  keeps macro-driven bulk edits cheap even with many thousands of marks.
  */
 
 #include <config.h>
@@ -50,6 +56,8 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+#define BOOK_MARK_AT(edit, i) g_array_index ((edit)->book_mark, edit_book_mark_t, i)
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -59,82 +67,56 @@
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
+/** index of the first mark on or after this line (or the array length) */
 
-/** note, if there is more than one bookmark on a line, then they are
-   appended after each other and the last one is always the one found
-   by book_mark_found() i.e. last in is the one seen */
-
-static edit_book_mark_t *
-double_marks (WEdit *edit, edit_book_mark_t *p)
+static guint
+book_mark_lower_bound (const WEdit *edit, long line)
 {
-    (void) edit;
+    guint lo = 0;
+    guint hi = edit->book_mark->len;
 
-    if (p->next != NULL)
-        while (p->next->line == p->line)
-            p = p->next;
-    return p;
+    while (lo < hi)
+    {
+        const guint mid = (lo + hi) / 2;
+
+        if (BOOK_MARK_AT (edit, mid).line < line)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/** returns the first bookmark on or before this line */
+/**
+ * Apply the pending renumber offset: marks after the remembered line are shifted as a
+ * block.  Marks that sat on since-deleted lines are clamped onto the line of deletion,
+ * matching what one-at-a-time renumbering used to produce.
+ */
 
-edit_book_mark_t *
-book_mark_find (WEdit *edit, long line)
+static void
+book_mark_apply_shift (WEdit *edit)
 {
-    edit_book_mark_t *p;
+    long line, delta;
+    guint i;
 
-    if (edit->book_mark == NULL)
-    {
-        // must have an imaginary top bookmark at line -1 to make things less complicated
-        edit->book_mark = g_new0 (edit_book_mark_t, 1);
-        edit->book_mark->line = -1;
-        return edit->book_mark;
-    }
+    delta = edit->book_mark_shift_delta;
+    if (delta == 0)
+        return;
 
-    for (p = edit->book_mark; p != NULL; p = p->next)
-    {
-        if (p->line > line)
-            break;  // gone past it going downward
+    line = edit->book_mark_shift_line;
+    edit->book_mark_shift_delta = 0;
 
-        if (p->next != NULL)
-        {
-            if (p->next->line > line)
-            {
-                edit->book_mark = p;
-                return double_marks (edit, p);
-            }
-        }
-        else
-        {
-            edit->book_mark = p;
-            return double_marks (edit, p);
-        }
-    }
+    if (edit->book_mark == NULL)
+        return;
 
-    for (p = edit->book_mark; p != NULL; p = p->prev)
+    for (i = book_mark_lower_bound (edit, line + 1); i < edit->book_mark->len; i++)
     {
-        if (p->next != NULL && p->next->line <= line)
-            break;  // gone past it going upward
+        edit_book_mark_t *m = &BOOK_MARK_AT (edit, i);
 
-        if (p->line <= line)
-        {
-            if (p->next != NULL)
-            {
-                if (p->next->line > line)
-                {
-                    edit->book_mark = p;
-                    return double_marks (edit, p);
-                }
-            }
-            else
-            {
-                edit->book_mark = p;
-                return double_marks (edit, p);
-            }
-        }
+        m->line = MAX (line, m->line + delta);
     }
-
-    return NULL;  // can't get here
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -155,51 +137,73 @@ book_mark_query_color (WEdit *edit, long line, int c)
 {
     if (edit->book_mark != NULL)
     {
-        edit_book_mark_t *p;
+        guint i;
 
-        for (p = book_mark_find (edit, line); p != NULL; p = p->prev)
-        {
-            if (p->line != line)
-                return FALSE;
-            if (p->c == c)
+        book_mark_apply_shift (edit);
+
+        for (i = book_mark_lower_bound (edit, line);
+             i < edit->book_mark->len && BOOK_MARK_AT (edit, i).line == line; i++)
+            if (BOOK_MARK_AT (edit, i).c == c)
                 return TRUE;
-        }
     }
 
     return FALSE;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** line of the nearest bookmark after this line, or -1 if there is none */
+
+long
+book_mark_get_next (WEdit *edit, long line)
+{
+    guint i;
+
+    if (edit->book_mark == NULL)
+        return -1;
+
+    book_mark_apply_shift (edit);
+
+    i = book_mark_lower_bound (edit, line + 1);
+    return i < edit->book_mark->len ? BOOK_MARK_AT (edit, i).line : -1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** line of the nearest bookmark before this line, or -1 if there is none */
+
+long
+book_mark_get_prev (WEdit *edit, long line)
+{
+    guint i;
+
+    if (edit->book_mark == NULL)
+        return -1;
+
+    book_mark_apply_shift (edit);
+
+    i = book_mark_lower_bound (edit, line);
+    return i != 0 ? BOOK_MARK_AT (edit, i - 1).line : -1;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /** insert a bookmark at this line */
 
 void
 book_mark_insert (WEdit *edit, long line, int c)
 {
-    edit_book_mark_t *p, *q;
+    edit_book_mark_t m;
+    guint i;
 
-    p = book_mark_find (edit, line);
-#if 0
-    if (p->line == line)
-    {
-        // already exists, so just change the color 
-        if (p->c != c)
-        {
-            p->c = c;
-            edit->force |= REDRAW_LINE;
-        }
-        return;
-    }
-#endif
-    // create list entry
-    q = g_new (edit_book_mark_t, 1);
-    q->line = line;
-    q->c = c;
-    q->next = p->next;
-    // insert into list
-    q->prev = p;
-    if (p->next != NULL)
-        p->next->prev = q;
-    p->next = q;
+    if (edit->book_mark == NULL)
+        edit->book_mark = g_array_new (FALSE, FALSE, sizeof (edit_book_mark_t));
+
+    book_mark_apply_shift (edit);
+
+    m.line = line;
+    m.c = c;
+
+    // append after any marks already on the line: last in is the one seen
+    i = book_mark_lower_bound (edit, line + 1);
+    g_array_insert_val (edit->book_mark, i, m);
 
     edit->force |= REDRAW_LINE;
 }
@@ -217,30 +221,33 @@ book_mark_insert (WEdit *edit, long line, int c)
 gboolean
 book_mark_clear (WEdit *edit, long line, int c)
 {
-    edit_book_mark_t *p, *q;
+    guint i;
     gboolean r = FALSE;
 
     if (edit->book_mark == NULL)
         return r;
 
-    for (p = book_mark_find (edit, line); p != NULL; p = q)
+    book_mark_apply_shift (edit);
+
+    i = book_mark_lower_bound (edit, line + 1);
+    while (i != 0 && BOOK_MARK_AT (edit, i - 1).line == line)
     {
-        q = p->prev;
-        if (p->line == line && (p->c == c || c == -1))
+        i--;
+        if (BOOK_MARK_AT (edit, i).c == c || c == -1)
         {
-            r = TRUE;
-            edit->book_mark = p->prev;
-            p->prev->next = p->next;
-            if (p->next != NULL)
-                p->next->prev = p->prev;
-            g_free (p);
+            g_array_remove_index (edit->book_mark, i);
             edit->force |= REDRAW_LINE;
-            break;
+            r = TRUE;
+            if (c != -1)
+                break;  // remove the most recent mark of that color only
         }
     }
-    // if there is only our dummy book mark left, clear it for speed
-    if (edit->book_mark->line == -1 && edit->book_mark->next == NULL)
-        MC_PTR_FREE (edit->book_mark);
+
+    if (edit->book_mark->len == 0)
+    {
+        g_array_free (edit->book_mark, TRUE);
+        edit->book_mark = NULL;
+    }
 
     return r;
 }
@@ -251,27 +258,22 @@ book_mark_clear (WEdit *edit, long line, int c)
 void
 book_mark_flush (WEdit *edit, int c)
 {
-    edit_book_mark_t *p, *q;
+    guint i;
 
     if (edit->book_mark == NULL)
         return;
 
-    while (edit->book_mark->prev != NULL)
-        edit->book_mark = edit->book_mark->prev;
+    edit->book_mark_shift_delta = 0;  // whole-array removal makes the pending shift moot
 
-    for (q = edit->book_mark->next; q != NULL; q = p)
+    for (i = edit->book_mark->len; i != 0; i--)
+        if (BOOK_MARK_AT (edit, i - 1).c == c || c == -1)
+            g_array_remove_index (edit->book_mark, i - 1);
+
+    if (edit->book_mark->len == 0)
     {
-        p = q->next;
-        if (q->c == c || c == -1)
-        {
-            q->prev->next = q->next;
-            if (p != NULL)
-                p->prev = q->prev;
-            g_free (q);
-        }
+        g_array_free (edit->book_mark, TRUE);
+        edit->book_mark = NULL;
     }
-    if (edit->book_mark->next == NULL)
-        MC_PTR_FREE (edit->book_mark);
 
     edit->force |= REDRAW_PAGE;
 }
@@ -282,14 +284,21 @@ book_mark_flush (WEdit *edit, int c)
 void
 book_mark_inc (WEdit *edit, long line)
 {
-    if (edit->book_mark != NULL)
-    {
-        edit_book_mark_t *p;
+    if (edit->book_mark == NULL)
+        return;
 
-        p = book_mark_find (edit, line);
-        for (p = p->next; p != NULL; p = p->next)
-            p->line++;
+    /* an insertion anywhere inside the block already covered by a pending downward
+       shift moves the very same tail of marks, so the two shifts coalesce */
+    if (edit->book_mark_shift_delta > 0 && line >= edit->book_mark_shift_line
+        && line <= edit->book_mark_shift_line + edit->book_mark_shift_delta)
+    {
+        edit->book_mark_shift_delta++;
+        return;
     }
+
+    book_mark_apply_shift (edit);
+    edit->book_mark_shift_line = line;
+    edit->book_mark_shift_delta = 1;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -298,14 +307,19 @@ book_mark_inc (WEdit *edit, long line)
 void
 book_mark_dec (WEdit *edit, long line)
 {
-    if (edit->book_mark != NULL)
-    {
-        edit_book_mark_t *p;
+    if (edit->book_mark == NULL)
+        return;
 
-        p = book_mark_find (edit, line);
-        for (p = p->next; p != NULL; p = p->next)
-            p->line--;
+    // deleting line after line at the same spot deepens the pending upward shift
+    if (edit->book_mark_shift_delta < 0 && line == edit->book_mark_shift_line)
+    {
+        edit->book_mark_shift_delta--;
+        return;
     }
+
+    book_mark_apply_shift (edit);
+    edit->book_mark_shift_line = line;
+    edit->book_mark_shift_delta = -1;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -319,15 +333,21 @@ book_mark_serialize (WEdit *edit, int color)
 
     if (edit->book_mark != NULL)
     {
-        edit_book_mark_t *p;
+        guint i;
+
+        book_mark_apply_shift (edit);
 
         if (edit->serialized_bookmarks == NULL)
             edit->serialized_bookmarks =
                 g_array_sized_new (FALSE, FALSE, sizeof (size_t), MAX_SAVED_BOOKMARKS);
 
-        for (p = book_mark_find (edit, 0); p != NULL; p = p->next)
-            if (p->c == color && p->line >= 0)
-                g_array_append_val (edit->serialized_bookmarks, p->line);
+        for (i = 0; i < edit->book_mark->len; i++)
+        {
+            const edit_book_mark_t *m = &BOOK_MARK_AT (edit, i);
+
+            if (m->c == color && m->line >= 0)
+                g_array_append_val (edit->serialized_bookmarks, m->line);
+        }
     }
 }
 
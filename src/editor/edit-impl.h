@@ -135,6 +135,8 @@ long edit_get_col (const WEdit *edit);
 void edit_update_curs_row (WEdit *edit);
 void edit_update_curs_col (WEdit *edit);
 void edit_find_bracket (WEdit *edit);
+void edit_replay_cmd_begin (void);
+void edit_replay_cmd_end (WEdit *edit);
 gboolean edit_reload_line (WEdit *edit, const edit_arg_t *arg);
 void edit_set_codeset (WEdit *edit);
 
@@ -171,6 +173,11 @@ void edit_mark_current_line_cmd (WEdit *edit);
 void edit_set_markers (WEdit *edit, off_t m1, off_t m2, long c1, long c2);
 void edit_push_markers (WEdit *edit);
 
+/* autosave.c */
+void edit_autosave_record (WEdit *edit, int op, off_t offset, int c);
+void edit_autosave_reset (WEdit *edit);
+void edit_autosave_recover (WEdit *edit);
+
 gboolean edit_save_block (WEdit *edit, const char *filename, off_t start, off_t finish);
 gboolean edit_save_block_cmd (WEdit *edit);
 gboolean edit_insert_file_cmd (WEdit *edit);
@@ -212,12 +219,14 @@ void edit_set_filename (WEdit *edit, const vfs_path_t *name_vpath);
 
 MC_MOCKABLE void edit_load_syntax (WEdit *edit, GPtrArray *pnames, const char *type);
 void edit_free_syntax_rules (WEdit *edit);
+void edit_syntax_invalidate (WEdit *edit);
 MC_MOCKABLE int edit_get_syntax_color (WEdit *edit, off_t byte_index);
 void edit_syntax_dialog (WEdit *edit);
 
 void book_mark_insert (WEdit *edit, long line, int c);
 gboolean book_mark_query_color (WEdit *edit, long line, int c);
-struct edit_book_mark_t *book_mark_find (WEdit *edit, long line);
+long book_mark_get_next (WEdit *edit, long line);
+long book_mark_get_prev (WEdit *edit, long line);
 gboolean book_mark_clear (WEdit *edit, long line, int c);
 void book_mark_flush (WEdit *edit, int c);
 void book_mark_inc (WEdit *edit, long line);
@@ -53,6 +53,7 @@
 #include "lib/strutil.h"  // utf string functions
 #include "lib/util.h"     // load_file_position(), save_file_position()
 #include "lib/timefmt.h"  // time formatting
+#include "lib/trace.h"
 #include "lib/lock.h"
 #include "lib/widget.h"
 #include "lib/charsets.h"  // get_codepage_id
@@ -146,6 +147,10 @@ static const struct edit_filters
 
 static const off_t filesize_default_threshold = 64 * 1024 * 1024;  // 64 MB
 
+/* Set while commands replay back to back (macros, bursts of printed text): per-keystroke
+   finishing work that only feeds the display is skipped until the replay ends. */
+static gboolean edit_replaying = FALSE;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -195,6 +200,10 @@ edit_load_file_fast (edit_buffer_t *buf, const vfs_path_t *filename_vpath)
     edit_buffer_read_file_status_msg_t rsm;
     gboolean aborted;
 
+    // try a zero-copy lazy load of a local file first
+    if (edit_buffer_mmap_file (buf, filename_vpath))
+        return TRUE;
+
     file = mc_open (filename_vpath, O_RDONLY | O_BINARY);
     if (file < 0)
     {
@@ -530,12 +539,26 @@ edit_purge_widget (WEdit *edit)
    then the file should be as it was when he loaded up. Then set edit->modified to 0.
  */
 
+/**
+ * Pop the topmost group of identical actions from the undo stack.
+ *
+ * Repeated actions are stored as a [c, -n] run-length pair; the whole pair is
+ * popped at once so the caller can replay the group in bulk instead of one
+ * action per call.
+ *
+ * @param edit  editor object
+ * @param count number of identical actions popped, at least 1
+ * @return code of the action
+ */
+
 static long
-edit_pop_undo_action (WEdit *edit)
+edit_pop_undo_action (WEdit *edit, long *count)
 {
     long c;
     unsigned long sp = edit->undo_stack_pointer;
 
+    *count = 1;
+
     if (sp == edit->undo_stack_bottom)
         return STACK_BOTTOM;
 
@@ -551,14 +574,9 @@ edit_pop_undo_action (WEdit *edit)
     if (sp == edit->undo_stack_bottom)
         return STACK_BOTTOM;
 
-    c = edit->undo_stack[(sp - 1) & edit->undo_stack_size_mask];
-    if (edit->undo_stack[sp] == -2)
-    {
-        //      edit->undo_stack[sp] = '@';
-        edit->undo_stack_pointer = sp;
-    }
-    else
-        edit->undo_stack[sp]++;
+    *count = -c;
+    edit->undo_stack_pointer = (sp - 1) & edit->undo_stack_size_mask;
+    c = edit->undo_stack[edit->undo_stack_pointer];
 
     return c;
 }
@@ -566,11 +584,13 @@ edit_pop_undo_action (WEdit *edit)
 /* --------------------------------------------------------------------------------------------- */
 
 static long
-edit_pop_redo_action (WEdit *edit)
+edit_pop_redo_action (WEdit *edit, long *count)
 {
     long c;
     unsigned long sp = edit->redo_stack_pointer;
 
+    *count = 1;
+
     if (sp == edit->redo_stack_bottom)
         return STACK_BOTTOM;
 
@@ -585,11 +605,9 @@ edit_pop_redo_action (WEdit *edit)
     if (sp == edit->redo_stack_bottom)
         return STACK_BOTTOM;
 
-    c = edit->redo_stack[(sp - 1) & edit->redo_stack_size_mask];
-    if (edit->redo_stack[sp] == -2)
-        edit->redo_stack_pointer = sp;
-    else
-        edit->redo_stack[sp]++;
+    *count = -c;
+    edit->redo_stack_pointer = (sp - 1) & edit->redo_stack_size_mask;
+    c = edit->redo_stack[edit->redo_stack_pointer];
 
     return c;
 }
@@ -1154,32 +1172,36 @@ static void
 edit_do_undo (WEdit *edit)
 {
     long ac;
+    long n = 0;
     long count = 0;
 
     edit->undo_stack_disable = 1;  // don't record undo's onto undo stack!
     edit->over_col = 0;
 
-    while ((ac = edit_pop_undo_action (edit)) < KEY_PRESS)
+    while ((ac = edit_pop_undo_action (edit, &n)) < KEY_PRESS)
     {
         off_t b;
+        long i;
 
         switch ((int) ac)
         {
         case STACK_BOTTOM:
             goto done_undo;
         case CURS_RIGHT:
-            edit_cursor_move (edit, 1);
+            edit_cursor_move (edit, n);
             break;
         case CURS_LEFT:
-            edit_cursor_move (edit, -1);
+            edit_cursor_move (edit, -n);
             break;
         case BACKSPACE:
         case BACKSPACE_BR:
-            edit_backspace (edit, TRUE);
+            for (i = 0; i < n; i++)
+                edit_backspace (edit, TRUE);
             break;
         case DELCHAR:
         case DELCHAR_BR:
-            edit_delete (edit, TRUE);
+            for (i = 0; i < n; i++)
+                edit_delete (edit, TRUE);
             break;
         case COLUMN_ON:
             edit->column_highlight = 1;
@@ -1191,9 +1213,11 @@ edit_do_undo (WEdit *edit)
             break;
         }
         if (ac >= 256 && ac < 512)
-            edit_insert_ahead (edit, ac - 256);
+            for (i = 0; i < n; i++)
+                edit_insert_ahead (edit, ac - 256);
         if (ac >= 0 && ac < 256)
-            edit_insert (edit, ac);
+            for (i = 0; i < n; i++)
+                edit_insert (edit, ac);
 
         if (ac >= MARK_1 - 2 && ac < MARK_2 - 2)
         {
@@ -1211,7 +1235,8 @@ edit_do_undo (WEdit *edit)
         {
             edit->end_mark_curs = ac - MARK_CURS;
         }
-        if (count++)
+        count += n;
+        if (count > 1)
             edit->force |= REDRAW_PAGE;  // more than one pop usually means something big
     }
 
@@ -1240,6 +1265,7 @@ static void
 edit_do_redo (WEdit *edit)
 {
     long ac;
+    long n = 0;
     long count = 0;
 
     if (edit->redo_stack_reset)
@@ -1247,25 +1273,28 @@ edit_do_redo (WEdit *edit)
 
     edit->over_col = 0;
 
-    while ((ac = edit_pop_redo_action (edit)) < KEY_PRESS)
+    while ((ac = edit_pop_redo_action (edit, &n)) < KEY_PRESS)
     {
         off_t b;
+        long i;
 
         switch ((int) ac)
         {
         case STACK_BOTTOM:
             goto done_redo;
         case CURS_RIGHT:
-            edit_cursor_move (edit, 1);
+            edit_cursor_move (edit, n);
             break;
         case CURS_LEFT:
-            edit_cursor_move (edit, -1);
+            edit_cursor_move (edit, -n);
             break;
         case BACKSPACE:
-            edit_backspace (edit, TRUE);
+            for (i = 0; i < n; i++)
+                edit_backspace (edit, TRUE);
             break;
         case DELCHAR:
-            edit_delete (edit, TRUE);
+            for (i = 0; i < n; i++)
+                edit_delete (edit, TRUE);
             break;
         case COLUMN_ON:
             edit->column_highlight = 1;
@@ -1277,9 +1306,11 @@ edit_do_redo (WEdit *edit)
             break;
         }
         if (ac >= 256 && ac < 512)
-            edit_insert_ahead (edit, ac - 256);
+            for (i = 0; i < n; i++)
+                edit_insert_ahead (edit, ac - 256);
         if (ac >= 0 && ac < 256)
-            edit_insert (edit, ac);
+            for (i = 0; i < n; i++)
+                edit_insert (edit, ac);
 
         if (ac >= MARK_1 - 2 && ac < MARK_2 - 2)
         {
@@ -1293,8 +1324,9 @@ edit_do_redo (WEdit *edit)
             b = edit_buffer_get_bol (&edit->buffer, edit->mark2);
             edit->column2 = (long) edit_move_forward3 (edit, b, 0, edit->mark2);
         }
+        count += n;
         // more than one pop usually means something big
-        if (count++ != 0)
+        if (count > 1)
             edit->force |= REDRAW_PAGE;
     }
 
@@ -1685,8 +1717,10 @@ edit_print_string (WEdit *e, const char *s)
 {
     size_t i;
 
+    edit_replay_cmd_begin ();
     for (i = 0; s[i] != '\0'; i++)
         edit_execute_cmd (e, CK_InsertChar, (unsigned char) s[i]);
+    edit_replay_cmd_end (e);
     e->force |= REDRAW_COMPLETELY;
     edit_update_screen (e);
     return i;
@@ -1973,6 +2007,7 @@ edit_insert_file (WEdit *edit, const vfs_path_t *filename_vpath)
     char *p;
     off_t current;
     off_t ins_len = 0;
+    const gint64 trace_start = mc_trace_begin ();
 
     p = edit_get_filter (filename_vpath);
     current = edit->buffer.curs1;
@@ -2076,6 +2111,8 @@ edit_insert_file (WEdit *edit, const vfs_path_t *filename_vpath)
             ins_len = 0;
     }
 
+    mc_trace_end ("edit_insert_file", trace_start, ins_len > 0 ? (guint64) ins_len : 0);
+
     return ins_len;
 }
 
@@ -2180,6 +2217,7 @@ edit_init (WEdit *edit, const WRect *r, const edit_arg_t *arg)
     edit->loading_done = 1;
     edit->modified = 0;
     edit->locked = 0;
+    edit_autosave_recover (edit);
     edit_load_syntax (edit, NULL, NULL);
     edit_get_syntax_color (edit, -1);
 
@@ -2223,6 +2261,9 @@ edit_clean (WEdit *edit)
     if (edit->delete_file != 0)
         unlink (vfs_path_get_last_path_str (edit->filename_vpath));
 
+    // remaining changes were either saved or consciously abandoned
+    edit_autosave_reset (edit);
+
     edit_free_syntax_rules (edit);
     book_mark_flush (edit, -1);
 
@@ -2558,8 +2599,9 @@ edit_insert (WEdit *edit, int c)
     // update markers
     edit->mark1 += (edit->mark1 > edit->buffer.curs1) ? 1 : 0;
     edit->mark2 += (edit->mark2 > edit->buffer.curs1) ? 1 : 0;
-    edit->last_get_rule += (edit->last_get_rule > edit->buffer.curs1) ? 1 : 0;
+    edit_syntax_invalidate (edit);
 
+    edit_autosave_record (edit, 'i', edit->buffer.curs1, c);
     edit_buffer_insert (&edit->buffer, c);
 }
 
@@ -2590,8 +2632,9 @@ edit_insert_ahead (WEdit *edit, int c)
 
     edit->mark1 += (edit->mark1 >= edit->buffer.curs1) ? 1 : 0;
     edit->mark2 += (edit->mark2 >= edit->buffer.curs1) ? 1 : 0;
-    edit->last_get_rule += (edit->last_get_rule >= edit->buffer.curs1) ? 1 : 0;
+    edit_syntax_invalidate (edit);
 
+    edit_autosave_record (edit, 'i', edit->buffer.curs1, c);
     edit_buffer_insert_ahead (&edit->buffer, c);
 }
 
@@ -2640,11 +2683,11 @@ edit_delete (WEdit *edit, gboolean byte_delete)
         }
         if (edit->mark2 > edit->buffer.curs1)
             edit->mark2--;
-        if (edit->last_get_rule > edit->buffer.curs1)
-            edit->last_get_rule--;
+        edit_syntax_invalidate (edit);
 
         p = edit_buffer_delete (&edit->buffer);
 
+        edit_autosave_record (edit, 'd', edit->buffer.curs1, 0);
         edit_push_undo_action (edit, p + 256);
     }
 
@@ -2696,11 +2739,11 @@ edit_backspace (WEdit *edit, gboolean byte_delete)
         }
         if (edit->mark2 >= edit->buffer.curs1)
             edit->mark2--;
-        if (edit->last_get_rule >= edit->buffer.curs1)
-            edit->last_get_rule--;
+        edit_syntax_invalidate (edit);
 
         p = edit_buffer_backspace (&edit->buffer);
 
+        edit_autosave_record (edit, 'd', edit->buffer.curs1, 0);
         edit_push_undo_action (edit, p);
     }
     edit_modification (edit);
@@ -2722,46 +2765,82 @@ edit_backspace (WEdit *edit, gboolean byte_delete)
     return p;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Push the same undo action several times. The repetitions are folded into the
+ * run-length counter of the undo stack directly, so a long cursor move costs
+ * a handful of stack operations rather than one call per byte. The resulting
+ * stack content is the same as n plain edit_push_undo_action() calls would
+ * leave behind.
+ */
+
+static void
+edit_push_undo_action_multiple (WEdit *edit, long c, off_t n)
+{
+    while (n > 0)
+    {
+        unsigned long sp, spm1;
+
+        edit_push_undo_action (edit, c);
+        n--;
+
+        if (n == 0 || edit->undo_stack_disable)
+            continue;
+
+        sp = edit->undo_stack_pointer;
+        spm1 = (sp - 1) & edit->undo_stack_size_mask;
+        if (edit->undo_stack[spm1] < 0
+            && edit->undo_stack[(sp - 2) & edit->undo_stack_size_mask] == c)
+        {
+            long take;
+
+            // the counter must stay above the -1000000000 floor
+            take = (long) MIN (n, (off_t) (edit->undo_stack[spm1] + 1000000000));
+            if (take > 0)
+            {
+                edit->undo_stack[spm1] -= take;
+                n -= take;
+            }
+        }
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /** moves the cursor right or left: increment positive or negative respectively */
 
 void
 edit_cursor_move (WEdit *edit, off_t increment)
 {
+    long lines;
+
     if (increment < 0)
     {
-        for (; increment < 0 && edit->buffer.curs1 != 0; increment++)
-        {
-            int c;
+        increment = MIN (-increment, edit->buffer.curs1);
+        if (increment <= 0)
+            return;
 
-            edit_push_undo_action (edit, CURS_RIGHT);
+        edit_push_undo_action_multiple (edit, CURS_RIGHT, increment);
 
-            c = edit_buffer_get_previous_byte (&edit->buffer);
-            edit_buffer_insert_ahead (&edit->buffer, c);
-            c = edit_buffer_backspace (&edit->buffer);
-            if (c == '\n')
-            {
-                edit->buffer.curs_line--;
-                edit->force |= REDRAW_LINE_BELOW;
-            }
+        lines = edit_buffer_move_cursor (&edit->buffer, -increment);
+        if (lines != 0)
+        {
+            edit->buffer.curs_line -= lines;
+            edit->force |= REDRAW_LINE_BELOW;
         }
     }
     else
     {
-        for (; increment > 0 && edit->buffer.curs2 != 0; increment--)
-        {
-            int c;
+        increment = MIN (increment, edit->buffer.curs2);
+        if (increment <= 0)
+            return;
 
-            edit_push_undo_action (edit, CURS_LEFT);
+        edit_push_undo_action_multiple (edit, CURS_LEFT, increment);
 
-            c = edit_buffer_get_current_byte (&edit->buffer);
-            edit_buffer_insert (&edit->buffer, c);
-            c = edit_buffer_delete (&edit->buffer);
-            if (c == '\n')
-            {
-                edit->buffer.curs_line++;
-                edit->force |= REDRAW_LINE_ABOVE;
-            }
+        lines = edit_buffer_move_cursor (&edit->buffer, increment);
+        if (lines != 0)
+        {
+            edit->buffer.curs_line += lines;
+            edit->force |= REDRAW_LINE_ABOVE;
         }
     }
 }
@@ -3267,6 +3346,29 @@ edit_find_bracket (WEdit *edit)
     edit->last_bracket = edit->bracket;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Enter replay mode: commands are about to be executed back to back with no chance
+ * for the user to see the intermediate states, so the bracket highlighting scan that
+ * edit_execute_cmd() runs after every command is pointless until the replay is over.
+ */
+
+void
+edit_replay_cmd_begin (void)
+{
+    edit_replaying = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Leave replay mode and run the per-keystroke finishing work once for the final state. */
+
+void
+edit_replay_cmd_end (WEdit *edit)
+{
+    edit_replaying = FALSE;
+    edit_find_bracket (edit);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * This executes a command as though the user initiated it through a key
@@ -3475,7 +3577,8 @@ edit_execute_cmd (WEdit *edit, long command, int char_for_insertion)
         edit->found_len = 0;
         edit->prev_col = edit_get_col (edit);
         edit->search_start = edit->buffer.curs1;
-        edit_find_bracket (edit);
+        if (!edit_replaying)
+            edit_find_bracket (edit);
         return;
     }
 
@@ -3812,34 +3915,28 @@ edit_execute_cmd (WEdit *edit, long command, int char_for_insertion)
         edit->force |= REDRAW_PAGE;
         break;
     case CK_BookmarkNext:
-        if (edit->book_mark != NULL)
         {
-            edit_book_mark_t *p;
+            long line;
 
-            p = book_mark_find (edit, edit->buffer.curs_line);
-            if (p->next != NULL)
+            line = book_mark_get_next (edit, edit->buffer.curs_line);
+            if (line >= 0)
             {
-                p = p->next;
-                if (p->line >= edit->start_line + w->lines || p->line < edit->start_line)
-                    edit_move_display (edit, p->line - w->lines / 2);
-                edit_move_to_line (edit, p->line);
+                if (line >= edit->start_line + w->lines || line < edit->start_line)
+                    edit_move_display (edit, line - w->lines / 2);
+                edit_move_to_line (edit, line);
             }
         }
         break;
     case CK_BookmarkPrev:
-        if (edit->book_mark != NULL)
         {
-            edit_book_mark_t *p;
+            long line;
 
-            p = book_mark_find (edit, edit->buffer.curs_line);
-            while (p->line == edit->buffer.curs_line)
-                if (p->prev != NULL)
-                    p = p->prev;
-            if (p->line >= 0)
+            line = book_mark_get_prev (edit, edit->buffer.curs_line);
+            if (line >= 0)
             {
-                if (p->line >= edit->start_line + w->lines || p->line < edit->start_line)
-                    edit_move_display (edit, p->line - w->lines / 2);
-                edit_move_to_line (edit, p->line);
+                if (line >= edit->start_line + w->lines || line < edit->start_line)
+                    edit_move_display (edit, line - w->lines / 2);
+                edit_move_to_line (edit, line);
             }
         }
         break;
@@ -4063,7 +4160,8 @@ edit_execute_cmd (WEdit *edit, long command, int char_for_insertion)
         edit->prev_col = edit_get_col (edit);
         edit->search_start = edit->buffer.curs1;
     }
-    edit_find_bracket (edit);
+    if (!edit_replaying)
+        edit_find_bracket (edit);
 
     if (edit_options.auto_para_formatting)
     {
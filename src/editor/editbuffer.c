@@ -32,12 +32,17 @@
 #include <config.h>
 
 #include <ctype.h>  // isdigit()
+#include <fcntl.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include "lib/global.h"
 
+#include "lib/memstat.h"
 #include "lib/vfs/vfs.h"
 
 #include "edit-impl.h"
@@ -104,6 +109,33 @@
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/** Allocate one buffer page, accounted against the editor subsystem. */
+
+static void *
+edit_buffer_alloc_page (void)
+{
+    mc_memstat_alloc (MC_MEMSTAT_EDITOR, EDIT_BUF_SIZE);
+    return g_malloc0 (EDIT_BUF_SIZE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Free one buffer page.  Element destroy function of b1/b2: slots holding
+ * memory-mapped file content are set to NULL before removal and must not be
+ * accounted or freed.
+ */
+
+static void
+edit_buffer_free_page (gpointer page)
+{
+    if (page != NULL)
+    {
+        mc_memstat_free (MC_MEMSTAT_EDITOR, EDIT_BUF_SIZE);
+        g_free (page);
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Get pointer to byte at specified index
@@ -134,6 +166,129 @@ edit_buffer_get_byte_ptr (const edit_buffer_t *buf, off_t byte_index)
     return (char *) b + (byte_index & M_EDIT_BUF_SIZE);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get the longest contiguous run of bytes starting at the specified index, bounded by
+ * the page and the gap.
+ *
+ * @param buf pointer to editor buffer
+ * @param byte_index byte index the run starts at; must be valid
+ * @param data returns the address of the byte at byte_index
+ *
+ * @return number of contiguous bytes available from byte_index on
+ */
+
+static off_t
+edit_buffer_get_forward_run (const edit_buffer_t *buf, off_t byte_index, const char **data)
+{
+    off_t run;
+
+    *data = edit_buffer_get_byte_ptr (buf, byte_index);
+
+    if (byte_index >= buf->curs1)
+    {
+        off_t p;
+
+        p = buf->curs1 + buf->curs2 - byte_index - 1;
+        run = (p & M_EDIT_BUF_SIZE) + 1;  // rest of this b2 page
+    }
+    else
+    {
+        run = EDIT_BUF_SIZE - (byte_index & M_EDIT_BUF_SIZE);  // rest of this b1 page
+        run = MIN (run, buf->curs1 - byte_index);              // do not cross the gap
+    }
+
+    return MIN (run, buf->curs1 + buf->curs2 - byte_index);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get the longest contiguous run of bytes ending at the specified index, bounded by
+ * the page and the gap.
+ *
+ * @param buf pointer to editor buffer
+ * @param byte_index byte index the run ends at (inclusive); must be valid
+ * @param data returns the address of the first (lowest) byte of the run
+ *
+ * @return number of contiguous bytes available up to and including byte_index
+ */
+
+static off_t
+edit_buffer_get_backward_run (const edit_buffer_t *buf, off_t byte_index, const char **data)
+{
+    off_t run;
+
+    if (byte_index >= buf->curs1)
+    {
+        off_t p;
+
+        p = buf->curs1 + buf->curs2 - byte_index - 1;
+        run = EDIT_BUF_SIZE - (p & M_EDIT_BUF_SIZE);      // rest of this b2 page
+        run = MIN (run, byte_index - buf->curs1 + 1);     // do not cross the gap
+    }
+    else
+        run = (byte_index & M_EDIT_BUF_SIZE) + 1;  // rest of this b1 page
+
+    *data = edit_buffer_get_byte_ptr (buf, byte_index) - (run - 1);
+
+    return run;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Materialize the last page of b2 in heap memory if it still points into the memory-mapped
+ * file content, so that it becomes writable
+ *
+ * @param buf pointer to editor buffer
+ */
+
+static void
+edit_buffer_own_last_page (edit_buffer_t *buf)
+{
+    guint j;
+    char *b, *copy;
+    off_t data_size;
+
+    if (buf->b2->len == 0 || buf->b2->len > buf->mmap_pages)
+        return;
+
+    j = buf->b2->len - 1;
+    b = g_ptr_array_index (buf->b2, j);
+
+    // only the addresses still covered by curs2 hold valid data
+    data_size = ((buf->curs2 - 1) & M_EDIT_BUF_SIZE) + 1;
+
+    copy = edit_buffer_alloc_page ();
+    memcpy (copy + EDIT_BUF_SIZE - data_size, b + EDIT_BUF_SIZE - data_size, data_size);
+
+    g_ptr_array_index (buf->b2, j) = copy;
+    buf->mmap_pages = j;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove the last page of b2. Pages still pointing into the memory-mapped file content
+ * must not be passed to the free function of the array.
+ *
+ * @param buf pointer to editor buffer
+ */
+
+static void
+edit_buffer_remove_last_b2_page (edit_buffer_t *buf)
+{
+    guint j;
+
+    j = buf->b2->len - 1;
+
+    if (buf->b2->len <= buf->mmap_pages)
+    {
+        buf->mmap_pages = j;
+        g_ptr_array_index (buf->b2, j) = NULL;
+    }
+
+    g_ptr_array_remove_index (buf->b2, j);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -146,14 +301,18 @@ edit_buffer_get_byte_ptr (const edit_buffer_t *buf, off_t byte_index)
 void
 edit_buffer_init (edit_buffer_t *buf, off_t size)
 {
-    buf->b1 = g_ptr_array_new_full (32, g_free);
-    buf->b2 = g_ptr_array_new_full (32, g_free);
+    buf->b1 = g_ptr_array_new_full (32, edit_buffer_free_page);
+    buf->b2 = g_ptr_array_new_full (32, edit_buffer_free_page);
 
     buf->curs1 = 0;
     buf->curs2 = 0;
 
     buf->size = size;
     buf->lines = 0;
+
+    buf->mmap_begin = NULL;
+    buf->mmap_size = 0;
+    buf->mmap_pages = 0;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -170,7 +329,23 @@ edit_buffer_clean (edit_buffer_t *buf)
         g_ptr_array_free (buf->b1, TRUE);
 
     if (buf->b2 != NULL)
+    {
+        guint i;
+
+        // pages still pointing into the mapped file content must not be freed
+        for (i = 0; i < buf->mmap_pages; i++)
+            g_ptr_array_index (buf->b2, i) = NULL;
+
         g_ptr_array_free (buf->b2, TRUE);
+    }
+
+    if (buf->mmap_begin != NULL)
+    {
+        munmap (buf->mmap_begin, buf->mmap_size);
+        buf->mmap_begin = NULL;
+        buf->mmap_size = 0;
+        buf->mmap_pages = 0;
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -328,10 +503,24 @@ edit_buffer_count_lines (const edit_buffer_t *buf, off_t first, off_t last)
     first = MAX (first, 0);
     last = MIN (last, buf->size);
 
+    /* walk page-contiguous spans and let memchr() do the counting instead of
+       looking every byte up through edit_buffer_get_byte() */
     while (first < last)
-        if (edit_buffer_get_byte (buf, first++) == '\n')
+    {
+        const char *data;
+        const char *nl;
+        off_t run;
+
+        run = edit_buffer_get_forward_run (buf, first, &data);
+        run = MIN (run, last - first);
+
+        for (nl = memchr (data, '\n', run); nl != NULL;
+             nl = memchr (nl + 1, '\n', run - (nl + 1 - data)))
             lines++;
 
+        first += run;
+    }
+
     return lines;
 }
 
@@ -348,13 +537,24 @@ edit_buffer_count_lines (const edit_buffer_t *buf, off_t first, off_t last)
 off_t
 edit_buffer_get_bol (const edit_buffer_t *buf, off_t current)
 {
-    if (current <= 0)
-        return 0;
+    current = MIN (current, buf->size);
 
-    for (; edit_buffer_get_byte (buf, current - 1) != '\n'; current--)
-        ;
+    // scan page-contiguous spans backwards instead of looking up every byte
+    while (current > 0)
+    {
+        const char *data;
+        off_t run, j;
 
-    return current;
+        run = edit_buffer_get_backward_run (buf, current - 1, &data);
+
+        for (j = run; j > 0; j--)
+            if (data[j - 1] == '\n')
+                return current - run + j;
+
+        current -= run;
+    }
+
+    return 0;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -370,13 +570,25 @@ edit_buffer_get_bol (const edit_buffer_t *buf, off_t current)
 off_t
 edit_buffer_get_eol (const edit_buffer_t *buf, off_t current)
 {
-    if (current >= buf->size)
-        return buf->size;
+    current = MAX (current, 0);
 
-    for (; edit_buffer_get_byte (buf, current) != '\n'; current++)
-        ;
+    // scan page-contiguous spans with memchr() instead of looking up every byte
+    while (current < buf->size)
+    {
+        const char *data;
+        const char *nl;
+        off_t run;
 
-    return current;
+        run = edit_buffer_get_forward_run (buf, current, &data);
+
+        nl = memchr (data, '\n', run);
+        if (nl != NULL)
+            return current + (nl - data);
+
+        current += run;
+    }
+
+    return buf->size;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -495,7 +707,7 @@ edit_buffer_insert (edit_buffer_t *buf, int c)
 
     // add a new buffer if we've reached the end of the last one
     if (i == 0)
-        g_ptr_array_add (buf->b1, g_malloc0 (EDIT_BUF_SIZE));
+        g_ptr_array_add (buf->b1, edit_buffer_alloc_page ());
 
     // perform the insertion
     b = g_ptr_array_index (buf->b1, buf->curs1 >> S_EDIT_BUF_SIZE);
@@ -527,7 +739,9 @@ edit_buffer_insert_ahead (edit_buffer_t *buf, int c)
 
     // add a new buffer if we've reached the end of the last one
     if (i == 0)
-        g_ptr_array_add (buf->b2, g_malloc0 (EDIT_BUF_SIZE));
+        g_ptr_array_add (buf->b2, edit_buffer_alloc_page ());
+    else
+        edit_buffer_own_last_page (buf);
 
     // perform the insertion
     b = g_ptr_array_index (buf->b2, buf->curs2 >> S_EDIT_BUF_SIZE);
@@ -564,13 +778,7 @@ edit_buffer_delete (edit_buffer_t *buf)
     c = *((unsigned char *) b + EDIT_BUF_SIZE - 1 - i);
 
     if (i == 0)
-    {
-        guint j;
-
-        j = buf->b2->len - 1;
-        b = g_ptr_array_index (buf->b2, j);
-        g_ptr_array_remove_index (buf->b2, j);
-    }
+        edit_buffer_remove_last_b2_page (buf);
 
     buf->curs2 = prev;
 
@@ -620,6 +828,103 @@ edit_buffer_backspace (edit_buffer_t *buf)
     return c;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Move the cursor (the gap) by the specified offset, transferring whole
+ * page-contiguous runs between both buffer arrays instead of single bytes.
+ *
+ * @param buf pointer to editor buffer
+ * @param offset move distance; positive moves right, negative moves left
+ *
+ * @return number of newlines crossed
+ */
+
+long
+edit_buffer_move_cursor (edit_buffer_t *buf, off_t offset)
+{
+    long lines = 0;
+
+    while (offset > 0 && buf->curs2 != 0)
+    {
+        void *b;
+        const char *src;
+        const char *nl;
+        off_t p, i1, n;
+
+        i1 = buf->curs1 & M_EDIT_BUF_SIZE;
+
+        // add a new buffer if we've reached the end of the last one
+        if (i1 == 0)
+            g_ptr_array_add (buf->b1, edit_buffer_alloc_page ());
+
+        p = buf->curs2 - 1;
+
+        n = MIN (offset, buf->curs2);
+        n = MIN (n, EDIT_BUF_SIZE - i1);                 // room in the b1 page
+        n = MIN (n, (p & M_EDIT_BUF_SIZE) + 1);          // run in the b2 page
+
+        b = g_ptr_array_index (buf->b2, p >> S_EDIT_BUF_SIZE);
+        src = (const char *) b + EDIT_BUF_SIZE - 1 - (p & M_EDIT_BUF_SIZE);
+        b = g_ptr_array_index (buf->b1, buf->curs1 >> S_EDIT_BUF_SIZE);
+        memcpy ((char *) b + i1, src, n);
+
+        for (nl = memchr (src, '\n', n); nl != NULL;
+             nl = memchr (nl + 1, '\n', n - (nl + 1 - src)))
+            lines++;
+
+        // the source page is empty when its whole run was taken
+        if (n == (p & M_EDIT_BUF_SIZE) + 1)
+            edit_buffer_remove_last_b2_page (buf);
+
+        buf->curs1 += n;
+        buf->curs2 -= n;
+        offset -= n;
+    }
+
+    while (offset < 0 && buf->curs1 != 0)
+    {
+        void *b;
+        const char *src;
+        const char *nl;
+        off_t p, i2, n;
+
+        i2 = buf->curs2 & M_EDIT_BUF_SIZE;
+
+        // add a new buffer if we've reached the end of the last one
+        if (i2 == 0)
+            g_ptr_array_add (buf->b2, edit_buffer_alloc_page ());
+        else
+            edit_buffer_own_last_page (buf);
+
+        p = buf->curs1 - 1;
+
+        n = MIN (-offset, buf->curs1);
+        n = MIN (n, EDIT_BUF_SIZE - i2);                 // room in the b2 page
+        n = MIN (n, (p & M_EDIT_BUF_SIZE) + 1);          // run in the b1 page
+
+        /* within one page both arrays store consecutive logical bytes at
+           ascending addresses, so the run is copied without reversal */
+        b = g_ptr_array_index (buf->b1, p >> S_EDIT_BUF_SIZE);
+        src = (const char *) b + (p & M_EDIT_BUF_SIZE) - n + 1;
+        b = g_ptr_array_index (buf->b2, buf->curs2 >> S_EDIT_BUF_SIZE);
+        memcpy ((char *) b + EDIT_BUF_SIZE - i2 - n, src, n);
+
+        for (nl = memchr (src, '\n', n); nl != NULL;
+             nl = memchr (nl + 1, '\n', n - (nl + 1 - src)))
+            lines++;
+
+        // the source page is empty when its whole run was taken
+        if (n == (p & M_EDIT_BUF_SIZE) + 1)
+            g_ptr_array_remove_index (buf->b1, buf->b1->len - 1);
+
+        buf->curs1 -= n;
+        buf->curs2 += n;
+        offset += n;
+    }
+
+    return lines;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Calculate forward offset with specified number of lines.
@@ -678,6 +983,110 @@ edit_buffer_get_backward_offset (const edit_buffer_t *buf, off_t current, long l
     return current;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Load file into editor buffer lazily: map the file content read-only and let the b2 pages
+ * point into the mapping. Pages are materialized in heap memory only when they are modified,
+ * so opening a large file costs no read and no copy. The mapping is released
+ * in edit_buffer_clean().
+ *
+ * @param buf pointer to editor buffer with the file size already set
+ * @param filename_vpath file name
+ *
+ * @return TRUE on success, FALSE if the file cannot be mapped and must be read instead
+ */
+
+gboolean
+edit_buffer_mmap_file (edit_buffer_t *buf, const vfs_path_t *filename_vpath)
+{
+    int fd;
+    struct stat st;
+    void *map;
+    off_t i;
+    const char *nl;
+
+    if (buf->size == 0 || !vfs_file_is_local (filename_vpath))
+        return FALSE;
+
+    fd = open (vfs_path_get_last_path_str (filename_vpath), O_RDONLY | O_BINARY);
+    if (fd < 0)
+        return FALSE;
+
+    if (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode) || st.st_size != buf->size)
+    {
+        close (fd);
+        return FALSE;
+    }
+
+    map = mmap (NULL, buf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);  // the mapping keeps the file referenced
+    if (map == MAP_FAILED)
+        return FALSE;
+
+    buf->mmap_begin = (char *) map;
+    buf->mmap_size = buf->size;
+
+    buf->curs2 = buf->size;
+
+    /* b2 holds the file back to front: page 0 is the file end and the top page covers
+       the file start. The top page is filled from its high addresses down, so its pointer
+       may lie up to one page before the mapping; only addresses inside the mapping
+       are ever dereferenced */
+    for (i = 0; i * EDIT_BUF_SIZE < buf->size; i++)
+        g_ptr_array_add (buf->b2, buf->mmap_begin + buf->size - (i + 1) * EDIT_BUF_SIZE);
+
+    buf->mmap_pages = buf->b2->len;
+
+    // count lines in one pass over the mapping
+    buf->lines = 0;
+    for (nl = memchr (map, '\n', buf->size); nl != NULL;
+         nl = memchr (nl + 1, '\n', buf->size - (nl + 1 - (const char *) map)))
+        buf->lines++;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Materialize all pages that still point into the memory-mapped file content and release
+ * the mapping. Must be called before the mapped file itself is rewritten in place:
+ * truncating a mapped file invalidates its pages.
+ *
+ * @param buf pointer to editor buffer
+ */
+
+void
+edit_buffer_materialize (edit_buffer_t *buf)
+{
+    guint i;
+
+    if (buf->mmap_begin == NULL)
+        return;
+
+    for (i = 0; i < buf->mmap_pages; i++)
+    {
+        const char *b;
+        char *copy;
+        off_t data_size;
+
+        b = g_ptr_array_index (buf->b2, i);
+
+        // the top page of b2 may be only partially covered by curs2
+        data_size = EDIT_BUF_SIZE;
+        if (i == buf->b2->len - 1)
+            data_size = ((buf->curs2 - 1) & M_EDIT_BUF_SIZE) + 1;
+
+        copy = edit_buffer_alloc_page ();
+        memcpy (copy + EDIT_BUF_SIZE - data_size, b + EDIT_BUF_SIZE - data_size, data_size);
+        g_ptr_array_index (buf->b2, i) = copy;
+    }
+
+    buf->mmap_pages = 0;
+    munmap (buf->mmap_begin, buf->mmap_size);
+    buf->mmap_begin = NULL;
+    buf->mmap_size = 0;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Load file into editor buffer
@@ -710,7 +1119,7 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
     data_size = buf->curs2 & M_EDIT_BUF_SIZE;
     if (data_size != 0)
     {
-        b = g_malloc0 (EDIT_BUF_SIZE);
+        b = edit_buffer_alloc_page ();
         g_ptr_array_add (buf->b2, b);
         b = (char *) b + EDIT_BUF_SIZE - data_size;
         ret = mc_read (fd, b, data_size);
@@ -730,7 +1139,7 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
     {
         off_t sz;
 
-        b = g_malloc0 (data_size);
+        b = edit_buffer_alloc_page ();
         g_ptr_array_add (buf->b2, b);
         sz = mc_read (fd, b, data_size);
         if (sz >= 0)
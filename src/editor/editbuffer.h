@@ -20,6 +20,10 @@ typedef struct edit_buffer_struct
     off_t size;      // file size
     long lines;      // total lines in the file
     long curs_line;  // line number of the cursor.
+
+    char *mmap_begin;  // mmap'ed file content if the file was loaded lazily, NULL otherwise
+    off_t mmap_size;   // length of the mapping
+    guint mmap_pages;  // pages of b2 below this index still point into the mapping
 } edit_buffer_t;
 
 typedef struct edit_buffer_read_file_status_msg_struct
@@ -52,11 +56,14 @@ void edit_buffer_insert (edit_buffer_t *buf, int c);
 void edit_buffer_insert_ahead (edit_buffer_t *buf, int c);
 int edit_buffer_delete (edit_buffer_t *buf);
 int edit_buffer_backspace (edit_buffer_t *buf);
+long edit_buffer_move_cursor (edit_buffer_t *buf, off_t offset);
 
 off_t edit_buffer_get_forward_offset (const edit_buffer_t *buf, off_t current, long lines,
                                       off_t upto);
 off_t edit_buffer_get_backward_offset (const edit_buffer_t *buf, off_t current, long lines);
 
+gboolean edit_buffer_mmap_file (edit_buffer_t *buf, const vfs_path_t *filename_vpath);
+void edit_buffer_materialize (edit_buffer_t *buf);
 off_t edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
                              edit_buffer_read_file_status_msg_t *sm, gboolean *aborted);
 off_t edit_buffer_write_file (edit_buffer_t *buf, int fd);
@@ -238,6 +238,11 @@ edit_save_file (WEdit *edit, const vfs_path_t *filename_vpath)
     if (edit->attrs_ok)
         (void) mc_fsetflags (savename_vpath, edit->attrs);
 
+    /* quick save rewrites the file in place; if the buffer still points into a mapping
+       of that file, the pages must be copied out before the file is truncated */
+    if (this_save_mode == EDIT_QUICK_SAVE)
+        edit_buffer_materialize (&edit->buffer);
+
     fd = mc_open (savename_vpath, O_CREAT | O_WRONLY | O_TRUNC | O_BINARY, edit->stat1.st_mode);
     if (fd == -1)
         goto error_save;
@@ -444,6 +449,7 @@ edit_save_cmd (WEdit *edit)
     {
         edit->delete_file = 0;
         edit->modified = 0;
+        edit_autosave_reset (edit);
     }
 
     edit->force |= REDRAW_COMPLETELY;
@@ -1022,6 +1028,7 @@ edit_save_as_cmd (WEdit *edit)
                 edit_reload (edit, exp_vpath);
             edit->modified = 0;
             edit->delete_file = 0;
+            edit_autosave_reset (edit);
             if (different_filename)
                 edit_load_syntax (edit, NULL, edit->syntax_type);
             ret = TRUE;
@@ -103,10 +103,10 @@ edit_collect_completions_get_current_word (edit_search_status_msg_t *esm, mc_sea
  */
 
 static void
-edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl, mc_search_t *srch,
+edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl,
+                                         GHashTable *added, mc_search_t *srch,
                                          edit_search_status_msg_t *esm, off_t word_start,
-                                         gsize word_len, off_t last_byte, GString *current_word,
-                                         int *max_width)
+                                         off_t last_byte, GString *current_word, int *max_width)
 {
     GString *temp = NULL;
     gsize len = 0;
@@ -116,6 +116,7 @@ edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl,
     {
         gsize i;
         int width;
+        char *key;
 
         if (temp == NULL)
             temp = g_string_sized_new (8);
@@ -152,16 +153,8 @@ edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl,
         {
             GList *l;
 
-            for (l = g_queue_peek_head_link (*compl); l != NULL; l = g_list_next (l))
-            {
-                GString *s = (GString *) l->data;
-
-                // skip if already added
-                if (strncmp (s->str + word_len, temp->str + word_len, MAX (len, s->len) - word_len)
-                    == 0)
-                    break;
-            }
-
+            // skip if already added
+            l = g_hash_table_lookup (added, temp->str);
             if (l != NULL)
             {
                 /* resort completion in main buffer only:
@@ -177,6 +170,9 @@ edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl,
             }
         }
 
+        // the word is remembered as it was collected, before recoding for display
+        key = g_strndup (temp->str, temp->len);
+
         {
             GString *recoded;
 
@@ -191,9 +187,15 @@ edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl,
         }
 
         if (active_buffer)
+        {
             g_queue_push_tail (*compl, temp);
+            g_hash_table_insert (added, key, g_queue_peek_tail_link (*compl));
+        }
         else
+        {
             g_queue_push_head (*compl, temp);
+            g_hash_table_insert (added, key, g_queue_peek_head_link (*compl));
+        }
 
         start += len;
 
@@ -214,10 +216,10 @@ edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl,
  */
 
 static GQueue *
-edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const char *match_expr,
-                          int *max_width)
+edit_collect_completions (WEdit *edit, off_t word_start, const char *match_expr, int *max_width)
 {
     GQueue *compl = NULL;
+    GHashTable *added;
     mc_search_t *srch;
     off_t last_byte;
     GString *current_word;
@@ -228,6 +230,9 @@ edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const c
     if (srch == NULL)
         return NULL;
 
+    // collected word -> its GList link in compl, to find duplicates without walking the queue
+    added = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
     entire_file = mc_config_get_bool (mc_global.main_config, CONFIG_APP_SECTION,
                                       "editor_wordcompletion_collect_entire_file", FALSE);
 
@@ -250,8 +255,8 @@ edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const c
     *max_width = 0;
 
     // collect completions from current buffer at first
-    edit_collect_completion_from_one_buffer (TRUE, &compl, srch, &esm, word_start, word_len,
-                                             last_byte, current_word, max_width);
+    edit_collect_completion_from_one_buffer (TRUE, &compl, added, srch, &esm, word_start, last_byte,
+                                             current_word, max_width);
 
     // collect completions from other buffers
     all_files = mc_config_get_bool (mc_global.main_config, CONFIG_APP_SECTION,
@@ -285,8 +290,8 @@ edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const c
             esm.edit = e;
             esm.offset = 0;
 
-            edit_collect_completion_from_one_buffer (FALSE, &compl, srch, &esm, word_start,
-                                                     word_len, last_byte, current_word, max_width);
+            edit_collect_completion_from_one_buffer (FALSE, &compl, added, srch, &esm, word_start,
+                                                     last_byte, current_word, max_width);
         }
 
         verbose = saved_verbose;
@@ -294,6 +299,7 @@ edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const c
 
     status_msg_deinit (STATUS_MSG (&esm));
     mc_search_free (srch);
+    g_hash_table_destroy (added);
     if (current_word != NULL)
         g_string_free (current_word, TRUE);
 
@@ -432,7 +438,7 @@ edit_complete_word_cmd (WEdit *edit)
         "[^\\s\\.=\\+\\[\\]\\(\\)\\,\\;\\:\\\"\\'\\-\\?\\/\\|\\\\\\{\\}\\*\\&\\^\\%%\\$#@\\!]+");
 
     // collect possible completions
-    compl = edit_collect_completions (edit, word_start, word_len, match_expr->str, &max_width);
+    compl = edit_collect_completions (edit, word_start, match_expr->str, &max_width);
 
     g_string_free (match_expr, TRUE);
 
@@ -41,6 +41,9 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* While a macro replays, refresh the screen at most this often to show progress */
+#define MACRO_UPDATE_INTERVAL_US (G_USEC_PER_SEC / 10)
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -357,9 +360,11 @@ edit_repeat_macro_cmd (WEdit *edit)
         edit_push_undo_action (edit, KEY_PRESS + edit->start_display);
         edit->force |= REDRAW_PAGE;
 
+        edit_replay_cmd_begin ();
         for (j = 0; j < count_repeat; j++)
             for (i = 0; i < macro_index; i++)
                 edit_execute_cmd (edit, record_macro_buf[i].action, record_macro_buf[i].ch);
+        edit_replay_cmd_end (edit);
 
         edit_update_screen (edit);
     }
@@ -388,9 +393,13 @@ edit_execute_macro (WEdit *edit, int hotkey)
             if (macros->macro->len != 0)
             {
                 guint i;
+                gint64 next_update;
 
                 edit->force |= REDRAW_PAGE;
 
+                edit_replay_cmd_begin ();
+                next_update = g_get_monotonic_time () + MACRO_UPDATE_INTERVAL_US;
+
                 for (i = 0; i < macros->macro->len; i++)
                 {
                     const macro_action_t *m_act;
@@ -398,7 +407,16 @@ edit_execute_macro (WEdit *edit, int hotkey)
                     m_act = &g_array_index (macros->macro, struct macro_action_t, i);
                     edit_execute_cmd (edit, m_act->action, m_act->ch);
                     res = TRUE;
+
+                    // long replays still give an occasional sign of life
+                    if (g_get_monotonic_time () >= next_update)
+                    {
+                        edit_update_screen (edit);
+                        next_update = g_get_monotonic_time () + MACRO_UPDATE_INTERVAL_US;
+                    }
                 }
+
+                edit_replay_cmd_end (edit);
             }
         }
     }
@@ -56,6 +56,9 @@ edit_search_options_t edit_search_options = {
 
 /*** file scope macro definitions ****************************************************************/
 
+// bytes handed to one mc_search_run_partial () slice of a buffer scan
+#define EDIT_SEARCH_CHUNK (1 << 20)
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -280,6 +283,46 @@ edit_search_fix_search_start_if_selection (WEdit *edit)
         edit->search_start = edit_search_options.backwards ? end_mark : start_mark;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Run the search engine over a buffer range in bounded slices.
+ *
+ * A whole-file scan can spend a long time inside the engine without hitting its
+ * update callback (a fixed string that never matches, for instance).  Feeding the
+ * engine EDIT_SEARCH_CHUNK bytes at a time guarantees that the progress dialog
+ * repaints and a queued abort takes effect at least once per slice, however the
+ * pattern behaves.
+ *
+ * @param edit         editor object
+ * @param esm          status message storage
+ * @param search_start first offset to scan
+ * @param search_end   offset to stop the scan at
+ * @param len          length of the found string
+ * @return TRUE if found, FALSE on "not found", abort or error
+ */
+
+static gboolean
+edit_search_run (WEdit *edit, edit_search_status_msg_t *esm, off_t search_start, off_t search_end,
+                 gsize *len)
+{
+    while (TRUE)
+    {
+        gboolean ok;
+
+        ok = mc_search_run_partial (edit->search, (void *) esm, &search_start, search_end,
+                                    EDIT_SEARCH_CHUNK, len);
+        if (ok || edit->search->error != MC_SEARCH_E_CONTINUE)
+            return ok;
+
+        if (edit->search->update_fn != NULL
+            && edit->search->update_fn (esm, search_start) == MC_SEARCH_CB_ABORT)
+        {
+            mc_search_set_error (edit->search, MC_SEARCH_E_ABORT, NULL);
+            return FALSE;
+        }
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static gboolean
@@ -355,7 +398,7 @@ edit_find (edit_search_status_msg_t *esm, gsize *len)
                 && mc_search_is_fixed_search_str (edit->search))
                 search_end = search_start + edit->search->original.str->len;
 
-            ok = mc_search_run (edit->search, (void *) esm, search_start, search_end, len);
+            ok = edit_search_run (edit, esm, search_start, search_end, len);
 
             if (ok && edit->search->normal_offset == search_start)
                 return TRUE;
@@ -403,7 +446,7 @@ edit_find (edit_search_status_msg_t *esm, gsize *len)
         return FALSE;
     }
 
-    return mc_search_run (edit->search, (void *) esm, search_start, end_mark, len);
+    return edit_search_run (edit, esm, search_start, end_mark, len);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -482,7 +525,7 @@ edit_do_search (WEdit *edit)
         search_create_bookmark = FALSE;
         book_mark_flush (edit, -1);
 
-        while (mc_search_run (edit->search, (void *) &esm, q, edit->buffer.size, &len))
+        while (edit_search_run (edit, &esm, q, edit->buffer.size, &len))
         {
             if (!found)
                 edit->search_start = edit->search->normal_offset;
@@ -26,8 +26,6 @@ struct edit_book_mark_t
 {
     long line;  // line number
     int c;      // color
-    edit_book_mark_t *next;
-    edit_book_mark_t *prev;
 };
 
 typedef struct edit_syntax_rule_t edit_syntax_rule_t;
@@ -118,9 +116,17 @@ struct WEdit
     long line_numbers[N_LINE_CACHES];
     off_t line_offsets[N_LINE_CACHES];
 
-    edit_book_mark_t *book_mark;
+    GArray *book_mark;           // book marks sorted by line (edit_book_mark_t), or NULL
+    long book_mark_shift_line;   // pending batch renumber: marks after this line ...
+    long book_mark_shift_delta;  // ... are offset by this many lines; 0 when none pending
     GArray *serialized_bookmarks;
 
+    // autosave journal (autosave.c)
+    FILE *autosave_file;      // open journal of unsaved changes, or NULL
+    char *autosave_path;      // journal location under the cache directory
+    int autosave_pending;     // records buffered since the last flush
+    time_t autosave_flushed;  // when the journal was last flushed to disk
+
     // undo stack and pointers
     unsigned long undo_stack_pointer;
     long *undo_stack;
@@ -146,6 +152,7 @@ struct WEdit
     GSList *syntax_marker;
     GPtrArray *rules;
     off_t last_get_rule;
+    off_t syntax_token_max;  // longest keyword or context delimiter of the loaded rules
     edit_syntax_rule_t rule;
     char *syntax_type;             // description of syntax highlighting type being used
     GTree *defines;                // List of defines
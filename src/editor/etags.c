@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include "lib/global.h"
 #include "lib/fileloc.h"  // TAGS_NAME
@@ -53,12 +54,32 @@
 
 /*** file scope type declarations ****************************************************************/
 
+typedef struct
+{
+    const char *filename;  // owned by etags_index_t::filenames
+    const char *define;    // points into etags_index_t::content
+} etags_record_t;
+
+typedef struct
+{
+    char *tagfile;  // path the index was built from
+    time_t mtime;   // st_mtime of the tag file when it was read
+    off_t size;     // st_size of the tag file when it was read
+
+    char *content;         // the whole tag file, lines NUL-terminated in place
+    GPtrArray *filenames;  // file names mentioned in the tag file
+    GPtrArray *records;    // etags_record_t, in tag file order
+} etags_index_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
 static int def_max_width;
 
+/* parsed tag file, kept between lookups and rebuilt when the file changes on disk */
+static etags_index_t *etags_index = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -191,8 +212,32 @@ parse_define (const char *buf, char **long_name, char **short_name, long *line)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static GPtrArray *
-etags_set_definition_hash (const char *tagfile, const char *start_path, const char *match_func)
+static void
+etags_index_free (void)
+{
+    if (etags_index != NULL)
+    {
+        g_ptr_array_free (etags_index->records, TRUE);
+        g_ptr_array_free (etags_index->filenames, TRUE);
+        g_free (etags_index->content);
+        g_free (etags_index->tagfile);
+        MC_PTR_FREE (etags_index);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make sure the in-memory index matches the tag file on disk.
+ *
+ * The tag file is read and split into records once; subsequent lookups reuse
+ * the index as long as the file path, size and mtime stay the same.
+ *
+ * @param tagfile path of the tag file
+ * @return TRUE if the index is usable
+ */
+
+static gboolean
+etags_index_load (const char *tagfile)
 {
     enum
     {
@@ -201,87 +246,138 @@ etags_set_definition_hash (const char *tagfile, const char *start_path, const ch
         in_define
     } state = start;
 
-    FILE *f;
-    char buf[BUF_LARGE];
-    char *filename = NULL;
-    GPtrArray *ret = NULL;
+    struct stat st;
+    char *content = NULL;
+    char *p;
+    const char *filename = NULL;
 
-    if (match_func == NULL || tagfile == NULL)
-        return NULL;
+    if (stat (tagfile, &st) != 0)
+        return FALSE;
 
-    // open file with positions
-    f = fopen (tagfile, "r");
-    if (f == NULL)
-        return NULL;
+    if (etags_index != NULL && strcmp (etags_index->tagfile, tagfile) == 0
+        && etags_index->mtime == st.st_mtime && etags_index->size == st.st_size)
+        return TRUE;
+
+    etags_index_free ();
+
+    if (!g_file_get_contents (tagfile, &content, NULL, NULL))
+        return FALSE;
+
+    etags_index = g_new0 (etags_index_t, 1);
+    etags_index->tagfile = g_strdup (tagfile);
+    etags_index->mtime = st.st_mtime;
+    etags_index->size = st.st_size;
+    etags_index->content = content;
+    etags_index->filenames = g_ptr_array_new_with_free_func (g_free);
+    etags_index->records = g_ptr_array_new_with_free_func (g_free);
+
+    for (p = content; *p != '\0';)
+    {
+        char *line = p;
+        char *nl;
+
+        nl = strchr (p, '\n');
+        if (nl != NULL)
+        {
+            *nl = '\0';
+            p = nl + 1;
+        }
+        else
+            p = strchr (p, '\0');
 
-    while (fgets (buf, sizeof (buf), f) != NULL)
         switch (state)
         {
         case start:
-            if (buf[0] == 0x0C)
+            if (line[0] == 0x0C)
                 state = in_filename;
             break;
 
         case in_filename:
         {
-            size_t pos;
+            char *name;
 
-            pos = strcspn (buf, ",");
-            g_free (filename);
-            filename = g_strndup (buf, pos);
+            name = g_strndup (line, strcspn (line, ","));
+            g_ptr_array_add (etags_index->filenames, name);
+            filename = name;
             state = in_define;
             break;
         }
 
         case in_define:
-            if (buf[0] == 0x0C)
+            if (line[0] == 0x0C)
                 state = in_filename;
             else
             {
-                char *chekedstr;
+                etags_record_t *rec;
 
-                // check if the filename matches the define pos
-                chekedstr = strstr (buf, match_func);
-                if (chekedstr != NULL)
-                {
-                    char *longname = NULL;
-                    char *shortname = NULL;
-                    etags_hash_t *def_hash;
+                rec = g_new (etags_record_t, 1);
+                rec->filename = filename;
+                rec->define = line;
+                g_ptr_array_add (etags_index->records, rec);
+            }
+            break;
 
-                    def_hash = g_new (etags_hash_t, 1);
+        default:
+            break;
+        }
+    }
 
-                    def_hash->fullpath = mc_build_filename (start_path, filename, (char *) NULL);
-                    def_hash->filename = g_strdup (filename);
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
 
-                    def_hash->line = 0;
+static GPtrArray *
+etags_set_definition_hash (const char *tagfile, const char *start_path, const char *match_func)
+{
+    GPtrArray *ret = NULL;
+    guint i;
 
-                    parse_define (chekedstr, &longname, &shortname, &def_hash->line);
+    if (match_func == NULL || tagfile == NULL)
+        return NULL;
 
-                    if (shortname != NULL && *shortname != '\0')
-                    {
-                        def_hash->short_define = shortname;
-                        g_free (longname);
-                    }
-                    else
-                    {
-                        def_hash->short_define = longname;
-                        g_free (shortname);
-                    }
+    if (!etags_index_load (tagfile))
+        return NULL;
 
-                    if (ret == NULL)
-                        ret = g_ptr_array_new_with_free_func (etags_hash_free);
+    for (i = 0; i < etags_index->records->len; i++)
+    {
+        const etags_record_t *rec = g_ptr_array_index (etags_index->records, i);
+        const char *chekedstr;
 
-                    g_ptr_array_add (ret, def_hash);
-                }
+        // check if the filename matches the define pos
+        chekedstr = strstr (rec->define, match_func);
+        if (chekedstr != NULL)
+        {
+            char *longname = NULL;
+            char *shortname = NULL;
+            etags_hash_t *def_hash;
+
+            def_hash = g_new (etags_hash_t, 1);
+
+            def_hash->fullpath = mc_build_filename (start_path, rec->filename, (char *) NULL);
+            def_hash->filename = g_strdup (rec->filename);
+
+            def_hash->line = 0;
+
+            parse_define (chekedstr, &longname, &shortname, &def_hash->line);
+
+            if (shortname != NULL && *shortname != '\0')
+            {
+                def_hash->short_define = shortname;
+                g_free (longname);
+            }
+            else
+            {
+                def_hash->short_define = longname;
+                g_free (shortname);
             }
-            break;
 
-        default:
-            break;
-        }
+            if (ret == NULL)
+                ret = g_ptr_array_new_with_free_func (etags_hash_free);
 
-    g_free (filename);
-    fclose (f);
+            g_ptr_array_add (ret, def_hash);
+        }
+    }
 
     return ret;
 }
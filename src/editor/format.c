@@ -517,7 +517,32 @@ format_paragraph (WEdit *edit, gboolean force)
 
     t2 = (unsigned char *) g_string_free (t, FALSE);
     format_this (t2, q - p, indent, edit->utf8);
-    put_paragraph (edit, t2, p, indent, size);
+
+    /* Formatting never changes the length of an unindented paragraph: newlines and
+       spaces only trade places.  The reformatted text can therefore be diffed against
+       the buffer byte for byte, and only the span between the first and the last
+       difference needs to be touched -- for the common one-word edit that span is a
+       line or two instead of the whole paragraph, and the unchanged head and tail
+       produce no undo records at all. */
+    if (indent == 0)
+    {
+        off_t head, tail;
+
+        for (head = 0; head < size && edit_buffer_get_byte (&edit->buffer, p + head) == t2[head];
+             head++)
+            ;
+
+        for (tail = 0; tail < size - head
+             && edit_buffer_get_byte (&edit->buffer, p + size - 1 - tail) == t2[size - 1 - tail];
+             tail++)
+            ;
+
+        if (head != size)  // anything to do at all?
+            put_paragraph (edit, t2 + head, p + head, 0, size - head - tail);
+    }
+    else
+        put_paragraph (edit, t2, p, indent, size);
+
     g_free ((char *) t2);
 
     // Scroll left as much as possible to show the formatted paragraph
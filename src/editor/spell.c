@@ -67,6 +67,9 @@ typedef struct aspell_struct
 static GModule *spell_module = NULL;
 static spell_t *global_speller = NULL;
 
+// verdicts of words already passed to the speller: word -> GINT_TO_POINTER (verdict)
+static GHashTable *spell_check_cache = NULL;
+
 static AspellConfig *(*mc_new_aspell_config) (void);
 static int (*mc_aspell_config_replace) (AspellConfig *ths, const char *key, const char *value);
 static AspellCanHaveError *(*mc_new_aspell_speller) (AspellConfig *config);
@@ -257,6 +260,22 @@ aspell_get_lang_list (GPtrArray *lang_list)
     return i;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Forget cached verdicts. Must be called whenever the dictionary they were
+ * obtained from changes: on language switch and on adding a word.
+ */
+
+static void
+spell_check_cache_clear (void)
+{
+    if (spell_check_cache != NULL)
+    {
+        g_hash_table_destroy (spell_check_cache);
+        spell_check_cache = NULL;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Set the language.
@@ -276,6 +295,8 @@ aspell_set_lang (const char *lang)
         g_free (spell_language);
         spell_language = g_strdup (lang);
 
+        spell_check_cache_clear ();
+
         if (mc_global.source_codepage > 0)
             spell_codeset = get_codepage_id (mc_global.source_codepage);
         else
@@ -411,6 +432,8 @@ spell_dialog_spell_suggest_show (WEdit *edit, const char *word, char **new_word,
 static gboolean
 aspell_add_to_dict (const char *word, int word_size)
 {
+    spell_check_cache_clear ();
+
     mc_aspell_speller_add_to_personal (global_speller->speller, word, word_size);
 
     if (mc_aspell_speller_error (global_speller->speller) != 0)
@@ -480,6 +503,10 @@ aspell_suggest (GPtrArray *suggest, const char *word, const int word_size)
 /**
  * Check word.
  *
+ * Verdicts are cached so that re-checking a word already seen in this
+ * dictionary costs a hash lookup instead of a speller query; in prose most
+ * words repeat, which keeps whole-file runs off the aspell hot path.
+ *
  * @param word Word for spell check
  * @param word_size Word size (in bytes)
  * @return FALSE if word is not in the dictionary
@@ -491,7 +518,18 @@ aspell_check (const char *word, const int word_size)
     int res = 0;
 
     if (word != NULL && global_speller != NULL && global_speller->speller != NULL)
+    {
+        gpointer verdict;
+
+        if (spell_check_cache == NULL)
+            spell_check_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+        else if (g_hash_table_lookup_extended (spell_check_cache, word, NULL, &verdict))
+            return (GPOINTER_TO_INT (verdict) == 1);
+
         res = mc_aspell_speller_check (global_speller->speller, word, word_size);
+        g_hash_table_insert (spell_check_cache, g_strndup (word, word_size),
+                             GINT_TO_POINTER (res));
+    }
 
     return (res == 1);
 }
@@ -564,6 +602,8 @@ aspell_init (void)
 void
 aspell_clean (void)
 {
+    spell_check_cache_clear ();
+
     if (global_speller == NULL)
         return;
 
@@ -137,7 +137,14 @@ typedef struct
     gboolean between_delimiters;
     char *whole_word_chars_left;
     char *whole_word_chars_right;
-    char *keyword_first_chars;
+    // keyword lookup table compiled at load time: the index of the first keyword starting
+    // with the given character, and per keyword the next one sharing its first character;
+    // 0 terminates a chain
+    guint keyword_chain_first[256];
+    guint *keyword_chain_next;
+    // first keyword starting with a wildcard token; such keywords must be tried
+    // whatever the current character is
+    guint keyword_wild_first;
     gboolean spelling;
     // first word is word[1]
     GPtrArray *keyword;
@@ -149,12 +156,36 @@ typedef struct
     edit_syntax_rule_t rule;
 } syntax_marker_t;
 
+typedef struct
+{
+    char *file_name;
+    time_t mtime;  // at parse time; a later change invalidates the whole rule set
+} syntax_source_t;
+
+/* A compiled rule set shared by all editor windows displaying the same language.
+   The cache holds one reference; every attached WEdit holds another one. */
+typedef struct
+{
+    int refcount;
+    char *name;  // rule set name, as given on the "file" line of the Syntax file
+    gboolean is_case_insensitive;
+    GPtrArray *rules;    // of context_rule_t
+    GPtrArray *sources;  // of syntax_source_t: every file the rules were parsed from
+} syntax_rule_set_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
 static char *error_file_name = NULL;
 
+/* compiled rule sets, keyed by rule set name; shared between editor windows */
+static GHashTable *syntax_rule_cache = NULL;
+/* all live rule sets, including ones already evicted from the cache */
+static GSList *syntax_rule_sets = NULL;
+/* while a rule set is being parsed: the files it is being read from */
+static GPtrArray *syntax_parse_sources = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -181,7 +212,7 @@ context_rule_free (gpointer rule)
     g_string_free (r->right, TRUE);
     g_free (r->whole_word_chars_left);
     g_free (r->whole_word_chars_right);
-    g_free (r->keyword_first_chars);
+    g_free (r->keyword_chain_next);
 
     if (r->keyword != NULL)
         g_ptr_array_free (r->keyword, TRUE);
@@ -191,6 +222,148 @@ context_rule_free (gpointer rule)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+syntax_source_free (gpointer data)
+{
+    syntax_source_t *source = (syntax_source_t *) data;
+
+    g_free (source->file_name);
+    g_free (source);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static time_t
+syntax_source_mtime (const char *file_name)
+{
+    struct stat st;
+
+    return stat (file_name, &st) == 0 ? st.st_mtime : 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Remember a file the rule set currently being parsed is read from. */
+
+static void
+syntax_parse_source_record (const char *file_name)
+{
+    if (syntax_parse_sources != NULL)
+        g_ptr_array_add (syntax_parse_sources, g_strdup (file_name));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+syntax_rule_set_unref (gpointer data)
+{
+    syntax_rule_set_t *set = (syntax_rule_set_t *) data;
+
+    if (--set->refcount != 0)
+        return;
+
+    syntax_rule_sets = g_slist_remove (syntax_rule_sets, set);
+    g_free (set->name);
+    g_ptr_array_free (set->rules, TRUE);
+    g_ptr_array_free (set->sources, TRUE);
+    g_free (set);
+    tty_color_free_temp ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Find the shared rule set owning the given rule array, if there is one. */
+
+static syntax_rule_set_t *
+syntax_rule_set_find (const GPtrArray *rules)
+{
+    GSList *l;
+
+    for (l = syntax_rule_sets; l != NULL; l = g_slist_next (l))
+        if (((syntax_rule_set_t *) l->data)->rules == rules)
+            return (syntax_rule_set_t *) l->data;
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+syntax_rule_set_is_stale (const syntax_rule_set_t *set)
+{
+    size_t i;
+
+    for (i = 0; i < set->sources->len; i++)
+    {
+        const syntax_source_t *source;
+
+        source = (const syntax_source_t *) g_ptr_array_index (set->sources, i);
+        if (syntax_source_mtime (source->file_name) != source->mtime)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Look up an up-to-date compiled rule set; stale entries are dropped for re-parsing. */
+
+static syntax_rule_set_t *
+syntax_rule_cache_get (const char *name)
+{
+    syntax_rule_set_t *set;
+
+    if (syntax_rule_cache == NULL)
+        return NULL;
+
+    set = (syntax_rule_set_t *) g_hash_table_lookup (syntax_rule_cache, name);
+    if (set == NULL)
+        return NULL;
+
+    if (syntax_rule_set_is_stale (set))
+    {
+        // the Syntax file or one of its includes was edited: force a re-parse
+        g_hash_table_remove (syntax_rule_cache, name);
+        return NULL;
+    }
+
+    return set;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Put the rules just compiled into edit into the cache, shared with later windows. */
+
+static void
+syntax_rule_cache_put (WEdit *edit, const char *name)
+{
+    syntax_rule_set_t *set;
+    size_t i;
+
+    set = g_new0 (syntax_rule_set_t, 1);
+    set->refcount = 2;  // the cache and this editor
+    set->name = g_strdup (name);
+    set->is_case_insensitive = edit->is_case_insensitive;
+    set->rules = edit->rules;
+    set->sources = g_ptr_array_new_with_free_func (syntax_source_free);
+
+    for (i = 0; i < syntax_parse_sources->len; i++)
+    {
+        syntax_source_t *source;
+
+        source = g_new (syntax_source_t, 1);
+        source->file_name = g_strdup (g_ptr_array_index (syntax_parse_sources, i));
+        source->mtime = syntax_source_mtime (source->file_name);
+        g_ptr_array_add (set->sources, source);
+    }
+
+    syntax_rule_sets = g_slist_prepend (syntax_rule_sets, set);
+
+    if (syntax_rule_cache == NULL)
+        syntax_rule_cache =
+            g_hash_table_new_full (g_str_hash, g_str_equal, NULL, syntax_rule_set_unref);
+    g_hash_table_replace (syntax_rule_cache, set->name, set);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static gint
 mc_defines_destroy (gpointer key, gpointer value, gpointer data)
 {
@@ -381,17 +554,6 @@ compare_word_to_right (const WEdit *edit, off_t i, const GString *text, const ch
 
 /* --------------------------------------------------------------------------------------------- */
 
-static const char *
-xx_strchr (const WEdit *edit, const unsigned char *s, int char_byte)
-{
-    while (*s >= '\005' && xx_tolower (edit, *s) != char_byte)
-        s++;
-
-    return (const char *) s;
-}
-
-/* --------------------------------------------------------------------------------------------- */
-
 static void
 apply_rules_going_right (WEdit *edit, off_t i)
 {
@@ -460,20 +622,34 @@ apply_rules_going_right (WEdit *edit, off_t i)
     // check to turn on a keyword
     if (_rule.keyword == 0)
     {
-        const char *p;
+        guint count, wild_count;
 
         r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule.context));
-        p = r->keyword_first_chars;
 
-        if (p != NULL)
-            while (*(p = xx_strchr (edit, (const unsigned char *) p + 1, c)) != '\0')
+        if (r->keyword_chain_next != NULL)
+        {
+            count = r->keyword_chain_first[(unsigned char) c];
+            wild_count = r->keyword_wild_first;
+
+            // merge the two chains to try the candidate keywords in definition order
+            while (count != 0 || wild_count != 0)
             {
                 syntax_keyword_t *k;
-                int count;
+                guint cur;
                 off_t e = -1;
 
-                count = p - r->keyword_first_chars;
-                k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
+                if (count != 0 && (wild_count == 0 || count < wild_count))
+                {
+                    cur = count;
+                    count = r->keyword_chain_next[cur];
+                }
+                else
+                {
+                    cur = wild_count;
+                    wild_count = r->keyword_chain_next[cur];
+                }
+
+                k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, cur));
                 if (k->keyword != 0)
                     e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
                                                k->whole_word_chars_right, k->line_start);
@@ -492,11 +668,12 @@ apply_rules_going_right (WEdit *edit, off_t i)
 
                     end = e;
                     _rule.end = e;
-                    _rule.keyword = count;
+                    _rule.keyword = cur;
                     keyword_foundright = TRUE;
                     break;
                 }
             }
+        }
     }
 
     // check to turn on a context
@@ -575,28 +752,43 @@ apply_rules_going_right (WEdit *edit, off_t i)
     // check again to turn on a keyword if the context switched
     if (contextchanged && _rule.keyword == 0)
     {
-        const char *p;
+        guint count, wild_count;
 
         r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule.context));
-        p = r->keyword_first_chars;
 
-        while (*(p = xx_strchr (edit, (const unsigned char *) p + 1, c)) != '\0')
+        if (r->keyword_chain_next != NULL)
         {
-            syntax_keyword_t *k;
-            int count;
-            off_t e = -1;
-
-            count = p - r->keyword_first_chars;
-            k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
+            count = r->keyword_chain_first[(unsigned char) c];
+            wild_count = r->keyword_wild_first;
 
-            if (k->keyword->len != 0)
-                e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
-                                           k->whole_word_chars_right, k->line_start);
-            if (e > 0)
+            while (count != 0 || wild_count != 0)
             {
-                _rule.end = e;
-                _rule.keyword = count;
-                break;
+                syntax_keyword_t *k;
+                guint cur;
+                off_t e = -1;
+
+                if (count != 0 && (wild_count == 0 || count < wild_count))
+                {
+                    cur = count;
+                    count = r->keyword_chain_next[cur];
+                }
+                else
+                {
+                    cur = wild_count;
+                    wild_count = r->keyword_chain_next[cur];
+                }
+
+                k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, cur));
+
+                if (k->keyword->len != 0)
+                    e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
+                                               k->whole_word_chars_right, k->line_start);
+                if (e > 0)
+                {
+                    _rule.end = e;
+                    _rule.keyword = cur;
+                    break;
+                }
             }
         }
     }
@@ -609,59 +801,96 @@ apply_rules_going_right (WEdit *edit, off_t i)
 static void
 edit_get_rule (WEdit *edit, off_t byte_index)
 {
+    GSList *l;
+    const syntax_marker_t *s;
     off_t i;
 
-    if (byte_index > edit->last_get_rule)
+    if (byte_index == edit->last_get_rule)
+        return;
+
+    /* find the nearest saved state at or below byte_index; the states above it are
+       kept — the text has not changed and they stay valid. Saved states are only
+       dropped in edit_syntax_invalidate () when the text is modified */
+    for (l = edit->syntax_marker; l != NULL; l = g_slist_next (l))
+        if (((const syntax_marker_t *) l->data)->offset <= byte_index)
+            break;
+    s = l != NULL ? (const syntax_marker_t *) l->data : NULL;
+
+    if (byte_index > edit->last_get_rule && (s == NULL || s->offset <= edit->last_get_rule))
+        i = edit->last_get_rule + 1;  // just continue from the current state
+    else if (s != NULL)
     {
-        for (i = edit->last_get_rule + 1; i <= byte_index; i++)
-        {
-            off_t d = SYNTAX_MARKER_DENSITY;
+        edit->rule = s->rule;
+        i = s->offset + 1;
+    }
+    else
+    {
+        memset (&edit->rule, 0, sizeof (edit->rule));
+        i = -1;  // re-derive the state from the very beginning
+    }
 
-            apply_rules_going_right (edit, i);
+    for (; i <= byte_index; i++)
+    {
+        off_t d = SYNTAX_MARKER_DENSITY;
 
-            if (edit->syntax_marker != NULL)
-                d += ((syntax_marker_t *) edit->syntax_marker->data)->offset;
+        apply_rules_going_right (edit, i);
 
-            if (i > d)
-            {
-                syntax_marker_t *s;
+        if (edit->syntax_marker != NULL)
+            d += ((syntax_marker_t *) edit->syntax_marker->data)->offset;
 
-                s = g_new (syntax_marker_t, 1);
-                s->offset = i;
-                s->rule = edit->rule;
-                edit->syntax_marker = g_slist_prepend (edit->syntax_marker, s);
-            }
+        if (i > d)
+        {
+            syntax_marker_t *m;
+
+            m = g_new (syntax_marker_t, 1);
+            m->offset = i;
+            m->rule = edit->rule;
+            edit->syntax_marker = g_slist_prepend (edit->syntax_marker, m);
         }
     }
-    else if (byte_index < edit->last_get_rule)
+
+    edit->last_get_rule = byte_index;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Compute the length of the longest keyword or context delimiter of the loaded rules.
+ * Rule comparisons never look ahead farther than that, which bounds how far below
+ * a modification the saved syntax states can be affected.
+ */
+
+static void
+edit_syntax_update_token_max (WEdit *edit)
+{
+    size_t i;
+    off_t token_max = 0;
+
+    for (i = 0; i < edit->rules->len; i++)
     {
-        while (TRUE)
-        {
-            syntax_marker_t *s;
+        const context_rule_t *r;
+        size_t j;
 
-            if (edit->syntax_marker == NULL)
-            {
-                memset (&edit->rule, 0, sizeof (edit->rule));
-                for (i = -1; i <= byte_index; i++)
-                    apply_rules_going_right (edit, i);
-                break;
-            }
+        r = CONTEXT_RULE (g_ptr_array_index (edit->rules, i));
+        if (r == NULL)
+            continue;
 
-            s = (syntax_marker_t *) edit->syntax_marker->data;
+        if (r->left != NULL)
+            token_max = MAX (token_max, (off_t) r->left->len);
+        if (r->right != NULL)
+            token_max = MAX (token_max, (off_t) r->right->len);
 
-            if (byte_index >= s->offset)
+        if (r->keyword != NULL)
+            for (j = 0; j < r->keyword->len; j++)
             {
-                edit->rule = s->rule;
-                for (i = s->offset + 1; i <= byte_index; i++)
-                    apply_rules_going_right (edit, i);
-                break;
-            }
+                const syntax_keyword_t *k;
 
-            g_free (s);
-            edit->syntax_marker = g_slist_delete_link (edit->syntax_marker, edit->syntax_marker);
-        }
+                k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, j));
+                if (k != NULL && k->keyword != NULL)
+                    token_max = MAX (token_max, (off_t) k->keyword->len);
+            }
     }
-    edit->last_get_rule = byte_index;
+
+    edit->syntax_token_max = token_max;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1049,6 +1278,7 @@ edit_read_syntax_rules (WEdit *edit, FILE *f, char **args, int args_size)
                 result = line;
                 break;
             }
+            syntax_parse_source_record (error_file_name);
             save_line = line;
             line = 0;
         }
@@ -1272,34 +1502,51 @@ edit_read_syntax_rules (WEdit *edit, FILE *f, char **args, int args_size)
     if (result == 0)
     {
         size_t i;
-        GString *first_chars;
 
         if (edit->rules == NULL)
             return line;
 
-        first_chars = g_string_sized_new (32);
-
-        // collect first character of keywords
+        // compile the keyword lookup chains, indexed by the first keyword character
         for (i = 0; i < edit->rules->len; i++)
         {
+            guint last[256];
+            guint wild_last = 0;
             size_t j;
 
-            g_string_set_size (first_chars, 0);
             c = CONTEXT_RULE (g_ptr_array_index (edit->rules, i));
 
-            g_string_append_c (first_chars, (char) 1);
+            c->keyword_chain_next = g_new0 (guint, c->keyword->len);
+            memset (last, 0, sizeof (last));
+
             for (j = 1; j < c->keyword->len; j++)
             {
                 syntax_keyword_t *k;
+                unsigned char ch;
 
                 k = SYNTAX_KEYWORD (g_ptr_array_index (c->keyword, j));
-                g_string_append_c (first_chars, k->keyword->str[0]);
-            }
+                ch = (unsigned char) k->keyword->str[0];
 
-            c->keyword_first_chars = g_strndup (first_chars->str, first_chars->len);
-        }
+                if (ch < '\005')
+                {
+                    // starts with a wildcard token: a candidate for every character
+                    if (wild_last == 0)
+                        c->keyword_wild_first = j;
+                    else
+                        c->keyword_chain_next[wild_last] = j;
+                    wild_last = j;
+                }
+                else
+                {
+                    ch = (unsigned char) xx_tolower (edit, ch);
 
-        g_string_free (first_chars, TRUE);
+                    if (last[ch] == 0)
+                        c->keyword_chain_first[ch] = j;
+                    else
+                        c->keyword_chain_next[last[ch]] = j;
+                    last[ch] = j;
+                }
+            }
+        }
     }
 
     return result;
@@ -1319,14 +1566,20 @@ edit_read_syntax_file (WEdit *edit, GPtrArray *pnames, const char *syntax_file,
     int result = 0;
     gboolean found = FALSE;
 
+    syntax_parse_sources = g_ptr_array_new_with_free_func (g_free);
+
     f = fopen (syntax_file, "r");
-    if (f == NULL)
+    if (f != NULL)
+        syntax_parse_source_record (syntax_file);
+    else
     {
         char *global_syntax_file;
 
         global_syntax_file =
             g_build_filename (mc_global.share_data_dir, EDIT_SYNTAX_FILE, (char *) NULL);
         f = fopen (global_syntax_file, "r");
+        if (f != NULL)
+            syntax_parse_source_record (global_syntax_file);
         g_free (global_syntax_file);
         if (f == NULL)
         {
@@ -1336,13 +1589,19 @@ edit_read_syntax_file (WEdit *edit, GPtrArray *pnames, const char *syntax_file,
                 global_syntax_file =
                     g_build_filename (candidates[i], EDIT_SYNTAX_FILE, (char *) NULL);
                 f = fopen (global_syntax_file, "r");
+                if (f != NULL)
+                    syntax_parse_source_record (global_syntax_file);
                 g_free (global_syntax_file);
                 if (f != NULL)
                     break;
             }
 
             if (f == NULL)
+            {
+                g_ptr_array_free (syntax_parse_sources, TRUE);
+                syntax_parse_sources = NULL;
                 return -1;
+            }
         }
     }
 
@@ -1365,6 +1624,7 @@ edit_read_syntax_file (WEdit *edit, GPtrArray *pnames, const char *syntax_file,
                 result = line;
                 break;
             }
+            syntax_parse_source_record (error_file_name);
             goto found_type;
         }
 
@@ -1408,32 +1668,53 @@ edit_read_syntax_file (WEdit *edit, GPtrArray *pnames, const char *syntax_file,
             {
                 int line_error;
                 char *syntax_type;
+                syntax_rule_set_t *set;
 
             found_type:
                 syntax_type = args[2];
-                line_error = edit_read_syntax_rules (edit, g ? g : f, args, ARGS_LEN - 1);
-                if (line_error != 0)
+
+                set = (edit != NULL && syntax_type != NULL) ? syntax_rule_cache_get (syntax_type)
+                                                            : NULL;
+                if (set != NULL)
                 {
-                    if (error_file_name == NULL)  // an included file
-                        result = line + line_error;
-                    else
-                        result = line_error;
+                    // another window already compiled this language: share its rules
+                    set->refcount++;
+                    edit->rules = set->rules;
+                    edit->is_case_insensitive = set->is_case_insensitive;
+                    g_free (edit->syntax_type);
+                    edit->syntax_type = g_strdup (syntax_type);
                 }
                 else
                 {
-                    g_free (edit->syntax_type);
-                    edit->syntax_type = g_strdup (syntax_type);
-                    // if there are no rules then turn off syntax highlighting for speed
-                    if (g == NULL && edit->rules->len == 1)
+                    line_error = edit_read_syntax_rules (edit, g ? g : f, args, ARGS_LEN - 1);
+                    if (line_error != 0)
                     {
-                        context_rule_t *r0;
+                        if (error_file_name == NULL)  // an included file
+                            result = line + line_error;
+                        else
+                            result = line_error;
+                    }
+                    else
+                    {
+                        gboolean keep_rules = TRUE;
 
-                        r0 = CONTEXT_RULE (g_ptr_array_index (edit->rules, 0));
-                        if (r0->keyword->len == 1 && !r0->spelling)
+                        g_free (edit->syntax_type);
+                        edit->syntax_type = g_strdup (syntax_type);
+                        // if there are no rules then turn off syntax highlighting for speed
+                        if (g == NULL && edit->rules->len == 1)
                         {
-                            edit_free_syntax_rules (edit);
-                            break;
+                            context_rule_t *r0;
+
+                            r0 = CONTEXT_RULE (g_ptr_array_index (edit->rules, 0));
+                            if (r0->keyword->len == 1 && !r0->spelling)
+                            {
+                                edit_free_syntax_rules (edit);
+                                keep_rules = FALSE;
+                            }
                         }
+
+                        if (keep_rules && syntax_type != NULL)
+                            syntax_rule_cache_put (edit, syntax_type);
                     }
                 }
 
@@ -1447,6 +1728,8 @@ edit_read_syntax_file (WEdit *edit, GPtrArray *pnames, const char *syntax_file,
     }
     g_free (l);
     fclose (f);
+    g_ptr_array_free (syntax_parse_sources, TRUE);
+    syntax_parse_sources = NULL;
     return result;
 }
 
@@ -1532,11 +1815,55 @@ edit_get_syntax_color (WEdit *edit, off_t byte_index)
     return EDITOR_NORMAL_COLOR;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Drop the syntax states saved at or beyond the cursor: the text there is about to change.
+ * States safely below the cursor are kept, so a modification deep in a file never forces
+ * re-deriving the highlighting context from the very beginning.
+ *
+ * @param edit editor object
+ */
+
+void
+edit_syntax_invalidate (WEdit *edit)
+{
+    off_t bound;
+
+    /* rule comparisons look ahead as far as the longest keyword or delimiter, so states
+       within that distance below the cursor may depend on the changed text too */
+    bound = edit->buffer.curs1 - edit->syntax_token_max - 2;
+
+    while (edit->syntax_marker != NULL
+           && ((syntax_marker_t *) edit->syntax_marker->data)->offset >= bound)
+    {
+        g_free (edit->syntax_marker->data);
+        edit->syntax_marker = g_slist_delete_link (edit->syntax_marker, edit->syntax_marker);
+    }
+
+    if (edit->last_get_rule >= bound)
+    {
+        if (edit->syntax_marker != NULL)
+        {
+            const syntax_marker_t *s = (const syntax_marker_t *) edit->syntax_marker->data;
+
+            edit->rule = s->rule;
+            edit->last_get_rule = s->offset;
+        }
+        else
+        {
+            memset (&edit->rule, 0, sizeof (edit->rule));
+            edit->last_get_rule = -1;
+        }
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
 edit_free_syntax_rules (WEdit *edit)
 {
+    syntax_rule_set_t *set;
+
     if (edit == NULL)
         return;
 
@@ -1549,10 +1876,18 @@ edit_free_syntax_rules (WEdit *edit)
     edit_get_rule (edit, -1);
     MC_PTR_FREE (edit->syntax_type);
 
-    g_ptr_array_free (edit->rules, TRUE);
+    set = syntax_rule_set_find (edit->rules);
+    if (set != NULL)
+        syntax_rule_set_unref (set);
+    else
+    {
+        // rules that never made it into the cache: parse errors, degenerate sets
+        g_ptr_array_free (edit->rules, TRUE);
+        tty_color_free_temp ();
+    }
     edit->rules = NULL;
+    edit->syntax_token_max = 0;
     g_clear_slist (&edit->syntax_marker, g_free);
-    tty_color_free_temp ();
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1608,6 +1943,8 @@ edit_load_syntax (WEdit *edit, GPtrArray *pnames, const char *type)
                  error_file_name != NULL ? error_file_name : f, r);
         MC_PTR_FREE (error_file_name);
     }
+    else if (edit != NULL && edit->rules != NULL)
+        edit_syntax_update_token_max (edit);
 
     g_free (f);
 }
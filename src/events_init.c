@@ -28,6 +28,10 @@
 #include "lib/global.h"
 
 #include "lib/event.h"
+#include "lib/memstat.h"
+#include "lib/trace.h"
+#include "lib/vfs/vfs.h"  // vfs_memory_usage()
+#include "lib/widget.h"   // message()
 
 #ifdef ENABLE_BACKGROUND
 #include "background.h"  // (background_parent_call), background_parent_call_string()
@@ -49,6 +53,72 @@
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static gboolean
+trace_toggle_event (const gchar *event_group_name, const gchar *event_name, gpointer init_data,
+                    gpointer data)
+{
+    (void) event_group_name;
+    (void) event_name;
+    (void) init_data;
+    (void) data;
+
+    mc_trace_toggle ();
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+perf_hud_toggle_event (const gchar *event_group_name, const gchar *event_name, gpointer init_data,
+                       gpointer data)
+{
+    (void) event_group_name;
+    (void) event_name;
+    (void) init_data;
+    (void) data;
+
+    mc_perf_hud_toggle ();
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+memory_report_event (const gchar *event_group_name, const gchar *event_name, gpointer init_data,
+                     gpointer data)
+{
+    GString *report;
+    int i;
+
+    (void) event_group_name;
+    (void) event_name;
+    (void) init_data;
+    (void) data;
+
+    report = g_string_new ("subsystem      current         peak       blocks\n");
+
+    for (i = 0; i < MC_MEMSTAT_MAX; i++)
+    {
+        const mc_memstat_t *ms = mc_memstat_get ((mc_memstat_subsystem_t) i);
+
+        g_string_append_printf (report,
+                                "%-9s %12" G_GUINT64_FORMAT " %12" G_GUINT64_FORMAT
+                                " %12" G_GUINT64_FORMAT "\n",
+                                mc_memstat_name ((mc_memstat_subsystem_t) i), ms->current, ms->peak,
+                                ms->allocs);
+        // mirror the counters into the trace log, if one is being written
+        mc_trace_emit (mc_memstat_name ((mc_memstat_subsystem_t) i), 0, ms->current);
+    }
+
+    g_string_append_printf (report, "%-9s %12" G_GUINT64_FORMAT " (cached)", "vfs",
+                            vfs_memory_usage ());
+    mc_trace_emit ("vfs_cache", 0, vfs_memory_usage ());
+
+    message (D_NORMAL, _ ("Memory usage"), "%s", report->str);
+    g_string_free (report, TRUE);
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -64,6 +134,9 @@ events_init (GError **mcerror)
 
         { MCEVENT_GROUP_CORE, "help", help_interactive_display, NULL },
         { MCEVENT_GROUP_CORE, "suspend", execute_suspend, NULL },
+        { MCEVENT_GROUP_CORE, "trace_toggle", trace_toggle_event, NULL },
+        { MCEVENT_GROUP_CORE, "memory_report", memory_report_event, NULL },
+        { MCEVENT_GROUP_CORE, "perf_hud_toggle", perf_hud_toggle_event, NULL },
 
 #ifdef ENABLE_BACKGROUND
         { MCEVENT_GROUP_CORE, "background_parent_call", background_parent_call, NULL },
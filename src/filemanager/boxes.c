@@ -160,6 +160,8 @@ skin_apply (const gchar *skin_override)
         command_set_default_colors ();
     panel_deinit ();
     panel_init ();
+    // screen images parked by dialog_switch carry the old colors
+    dialog_switch_drop_all_screens ();
     repaint_screen ();
 
     mc_error_message (&mcerror, NULL);
@@ -575,6 +577,7 @@ configure_box (void)
                 QUICK_START_GROUPBOX (N_ ("File operations")),
                     QUICK_CHECKBOX (N_ ("&Verbose operation"), &verbose, NULL),
                     QUICK_CHECKBOX (N_ ("Compute tota&ls"), &file_op_compute_totals, NULL),
+                    QUICK_CHECKBOX (N_ ("Pre-scan con&flicts"), &file_op_prescan_conflicts, NULL),
                     QUICK_CHECKBOX (N_ ("Classic pro&gressbar"), &classic_progressbar, NULL),
                     QUICK_CHECKBOX (N_ ("Mkdi&r autoname"), &auto_fill_mkdir_name, NULL),
                     QUICK_CHECKBOX (N_ ("&Preallocate space"), &mc_global.vfs.preallocate_space,
@@ -50,6 +50,7 @@
 #include "src/util.h"    // file_error_message()
 
 #include "cmd.h"  // chattr_cmd(), chattr_get_as_str()
+#include "massop.h"
 
 /*** global variables ****************************************************************************/
 
@@ -1120,55 +1121,29 @@ try_chattr (const vfs_path_t *p, unsigned long m)
 /* --------------------------------------------------------------------------------------------- */
 
 static gboolean
-do_chattr (WPanel *panel, const vfs_path_t *p, unsigned long m)
+chattr_apply_cb (const vfs_path_t *vpath, void *data)
 {
-    gboolean ret;
+    unsigned long m;
 
-    m &= and_mask;
-    m |= or_mask;
+    (void) data;
 
-    ret = try_chattr (p, m);
+    // if current file was deleted outside mc -- try next file
+    if (mc_fgetflags (vpath, &m) != 0)
+        return TRUE;
 
-    do_file_mark (panel, current_file, 0);
+    flags = m;
+    m &= and_mask;
+    m |= or_mask;
 
-    return ret;
+    return try_chattr (vpath, m);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-chattr_apply_mask (WPanel *panel, vfs_path_t *vpath, unsigned long m)
+chattr_apply_mask (WPanel *panel)
 {
-    gboolean ok;
-
-    if (!do_chattr (panel, vpath, m))
-        return;
-
-    do
-    {
-        const GString *fname;
-
-        fname = panel_find_marked_file (panel, &current_file);
-        vpath = vfs_path_from_str (fname->str);
-        ok = (mc_fgetflags (vpath, &m) == 0);
-
-        if (!ok)
-        {
-            // if current file was deleted outside mc -- try next file
-            // decrease panel->marked
-            do_file_mark (panel, current_file, 0);
-
-            // try next file
-            ok = TRUE;
-        }
-        else
-        {
-            flags = m;
-            ok = do_chattr (panel, vpath, m);
-            vfs_path_free (vpath, TRUE);
-        }
-    }
-    while (ok && panel->marked != 0);
+    massop_apply_marked (panel, chattr_apply_cb, NULL);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1259,7 +1234,7 @@ chattr_cmd (WPanel *panel)
                         and_mask &= ~check_attr[i].flags;
                 }
 
-            chattr_apply_mask (panel, vpath, flags);
+            chattr_apply_mask (panel);
             need_update = TRUE;
             end_chattr = TRUE;
             break;
@@ -1272,7 +1247,7 @@ chattr_cmd (WPanel *panel)
                 if (chattr_is_modifiable (i) && check_attr[i].selected)
                     or_mask |= check_attr[i].flags;
 
-            chattr_apply_mask (panel, vpath, flags);
+            chattr_apply_mask (panel);
             need_update = TRUE;
             end_chattr = TRUE;
             break;
@@ -1285,7 +1260,7 @@ chattr_cmd (WPanel *panel)
                 if (chattr_is_modifiable (i) && check_attr[i].selected)
                     and_mask &= ~check_attr[i].flags;
 
-            chattr_apply_mask (panel, vpath, flags);
+            chattr_apply_mask (panel);
             need_update = TRUE;
             end_chattr = TRUE;
             break;
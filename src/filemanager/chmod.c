@@ -43,6 +43,7 @@
 #include "src/util.h"  // file_error_message()
 
 #include "cmd.h"  // chmod_cmd()
+#include "massop.h"
 
 /*** global variables ****************************************************************************/
 
@@ -430,57 +431,29 @@ try_chmod (const vfs_path_t *p, mode_t m)
 /* --------------------------------------------------------------------------------------------- */
 
 static gboolean
-do_chmod (WPanel *panel, const vfs_path_t *p, struct stat *sf)
+chmod_apply_cb (const vfs_path_t *vpath, void *data)
 {
-    gboolean ret;
+    struct stat sf;
 
-    sf->st_mode &= and_mask;
-    sf->st_mode |= or_mask;
+    (void) data;
 
-    ret = try_chmod (p, sf->st_mode);
+    // if current file was deleted outside mc -- try next file
+    if (mc_stat (vpath, &sf) != 0)
+        return TRUE;
 
-    do_file_mark (panel, current_file, 0);
+    ch_mode = sf.st_mode;
+    sf.st_mode &= and_mask;
+    sf.st_mode |= or_mask;
 
-    return ret;
+    return try_chmod (vpath, sf.st_mode);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-apply_mask (WPanel *panel, vfs_path_t *vpath, struct stat *sf)
+apply_mask (WPanel *panel)
 {
-    gboolean ok;
-
-    if (!do_chmod (panel, vpath, sf))
-        return;
-
-    do
-    {
-        const GString *fname;
-
-        fname = panel_find_marked_file (panel, &current_file);
-        vpath = vfs_path_from_str (fname->str);
-        ok = (mc_stat (vpath, sf) == 0);
-
-        if (!ok)
-        {
-            // if current file was deleted outside mc -- try next file
-            // decrease panel->marked
-            do_file_mark (panel, current_file, 0);
-
-            // try next file
-            ok = TRUE;
-        }
-        else
-        {
-            ch_mode = sf->st_mode;
-
-            ok = do_chmod (panel, vpath, sf);
-        }
-
-        vfs_path_free (vpath, TRUE);
-    }
-    while (ok && panel->marked != 0);
+    massop_apply_marked (panel, chmod_apply_cb, NULL);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -569,7 +542,7 @@ chmod_cmd (WPanel *panel)
                         and_mask &= ~check_perm[i].mode;
                 }
 
-            apply_mask (panel, vpath, &sf_stat);
+            apply_mask (panel);
             need_update = TRUE;
             end_chmod = TRUE;
             break;
@@ -582,7 +555,7 @@ chmod_cmd (WPanel *panel)
                 if (check_perm[i].selected)
                     or_mask |= check_perm[i].mode;
 
-            apply_mask (panel, vpath, &sf_stat);
+            apply_mask (panel);
             need_update = TRUE;
             end_chmod = TRUE;
             break;
@@ -595,7 +568,7 @@ chmod_cmd (WPanel *panel)
                 if (check_perm[i].selected)
                     and_mask &= ~check_perm[i].mode;
 
-            apply_mask (panel, vpath, &sf_stat);
+            apply_mask (panel);
             need_update = TRUE;
             end_chmod = TRUE;
             break;
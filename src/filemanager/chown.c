@@ -48,6 +48,7 @@
 #include "src/util.h"   // file_error_message()
 
 #include "cmd.h"  // chown_cmd()
+#include "massop.h"
 
 /*** global variables ****************************************************************************/
 
@@ -68,6 +69,13 @@
 
 /*** file scope type declarations ****************************************************************/
 
+/* owner/group pair handed to chown_apply_cb through the mass applier */
+typedef struct
+{
+    uid_t u;
+    gid_t g;
+} chown_pair_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -307,51 +315,29 @@ try_chown (const vfs_path_t *p, uid_t u, gid_t g)
 /* --------------------------------------------------------------------------------------------- */
 
 static gboolean
-do_chown (WPanel *panel, const vfs_path_t *p, uid_t u, gid_t g)
+chown_apply_cb (const vfs_path_t *vpath, void *data)
 {
-    gboolean ret;
-
-    ret = try_chown (p, u, g);
+    const chown_pair_t *own = (const chown_pair_t *) data;
+    struct stat sf;
 
-    do_file_mark (panel, current_file, 0);
+    // if current file was deleted outside mc -- try next file
+    if (mc_stat (vpath, &sf) != 0)
+        return TRUE;
 
-    return ret;
+    return try_chown (vpath, own->u, own->g);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-apply_chowns (WPanel *panel, vfs_path_t *vpath, uid_t u, gid_t g)
+apply_chowns (WPanel *panel, uid_t u, gid_t g)
 {
-    gboolean ok;
-
-    if (!do_chown (panel, vpath, u, g))
-        return;
-
-    do
-    {
-        const GString *fname;
-        struct stat sf;
+    chown_pair_t own;
 
-        fname = panel_find_marked_file (panel, &current_file);
-        vpath = vfs_path_from_str (fname->str);
-        ok = (mc_stat (vpath, &sf) == 0);
+    own.u = u;
+    own.g = g;
 
-        if (!ok)
-        {
-            // if current file was deleted outside mc -- try next file
-            // decrease panel->marked
-            do_file_mark (panel, current_file, 0);
-
-            // try next file
-            ok = TRUE;
-        }
-        else
-            ok = do_chown (panel, vpath, u, g);
-
-        vfs_path_free (vpath, TRUE);
-    }
-    while (ok && panel->marked != 0);
+    massop_apply_marked (panel, chown_apply_cb, &own);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -451,7 +437,7 @@ chown_cmd (WPanel *panel)
             }
             else
             {
-                apply_chowns (panel, vpath, new_user, new_group);
+                apply_chowns (panel, new_user, new_group);
                 end_chown = TRUE;
             }
 
@@ -469,7 +455,7 @@ chown_cmd (WPanel *panel)
             if (user != NULL)
             {
                 new_user = user->pw_uid;
-                apply_chowns (panel, vpath, new_user, new_group);
+                apply_chowns (panel, new_user, new_group);
                 need_update = TRUE;
                 end_chown = TRUE;
             }
@@ -486,7 +472,7 @@ chown_cmd (WPanel *panel)
             if (grp != NULL)
             {
                 new_group = grp->gr_gid;
-                apply_chowns (panel, vpath, new_user, new_group);
+                apply_chowns (panel, new_user, new_group);
                 need_update = TRUE;
                 end_chown = TRUE;
             }
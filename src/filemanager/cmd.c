@@ -95,15 +95,32 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Persistent content checksums for the "Checksums" directory compare, kept in the
+   cache directory. When the table outgrows the cap, entries not touched by the
+   current comparison are dropped on save. */
+#define CHECKSUM_CACHE_FILE        "mc.compare.checksums"
+#define CHECKSUM_CACHE_MAX_ENTRIES 200000
+
 /*** file scope type declarations ****************************************************************/
 
 enum CompareMode
 {
     compare_quick = 0,
     compare_size_only,
-    compare_thourough
+    compare_thourough,
+    compare_checksum
 };
 
+/* A cached file checksum, valid as long as the dev/inode key still carries the
+   recorded size and mtime */
+typedef struct
+{
+    uintmax_t size;
+    time_t mtime;
+    gboolean used;  // looked up or computed during this comparison
+    char hash[65];  // SHA-256, hex, NUL-terminated
+} checksum_cache_entry_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -166,6 +183,170 @@ do_edit (const vfs_path_t *what_vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static GHashTable *
+checksum_cache_load (void)
+{
+    GHashTable *cache;
+    char *path;
+    char *contents = NULL;
+
+    cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    path = g_build_filename (mc_config_get_cache_path (), CHECKSUM_CACHE_FILE, (char *) NULL);
+    if (g_file_get_contents (path, &contents, NULL, NULL))
+    {
+        char **lines;
+        size_t i;
+
+        lines = g_strsplit (contents, "\n", -1);
+        for (i = 0; lines[i] != NULL; i++)
+        {
+            char key[64];
+            uintmax_t size;
+            long long mtime;
+            char hash[65];
+            checksum_cache_entry_t *e;
+
+            if (sscanf (lines[i], "%63s %ju %lld %64s", key, &size, &mtime, hash) != 4)
+                continue;
+
+            e = g_new0 (checksum_cache_entry_t, 1);
+            e->size = size;
+            e->mtime = (time_t) mtime;
+            g_strlcpy (e->hash, hash, sizeof (e->hash));
+            g_hash_table_replace (cache, g_strdup (key), e);
+        }
+        g_strfreev (lines);
+        g_free (contents);
+    }
+    g_free (path);
+
+    return cache;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+checksum_cache_save (GHashTable *cache)
+{
+    GString *out;
+    GHashTableIter iter;
+    gpointer k, v;
+    char *path;
+    const gboolean evict = g_hash_table_size (cache) > CHECKSUM_CACHE_MAX_ENTRIES;
+
+    out = g_string_sized_new (g_hash_table_size (cache) * 96);
+
+    g_hash_table_iter_init (&iter, cache);
+    while (g_hash_table_iter_next (&iter, &k, &v))
+    {
+        const checksum_cache_entry_t *e = (const checksum_cache_entry_t *) v;
+
+        if (evict && !e->used)
+            continue;
+
+        g_string_append_printf (out, "%s %ju %lld %s\n", (const char *) k, e->size,
+                                (long long) e->mtime, e->hash);
+    }
+
+    path = g_build_filename (mc_config_get_cache_path (), CHECKSUM_CACHE_FILE, (char *) NULL);
+    g_file_set_contents (path, out->str, (gssize) out->len, NULL);
+    g_free (path);
+
+    g_string_free (out, TRUE);
+    g_hash_table_destroy (cache);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get the content checksum of a file, from the cache when its dev/inode still
+ * carries the recorded size and mtime, by reading it otherwise. Symlinks are
+ * always read: their own mtime says nothing about the content behind them.
+ *
+ * @param cache checksum cache
+ * @param vpath file to hash
+ * @param st the panel's stat of the file, source of the cache key
+ * @param hash output, at least 65 bytes
+ *
+ * @return TRUE if hash was filled in, FALSE if the file could not be read
+ */
+
+static gboolean
+compare_checksum_get (GHashTable *cache, const vfs_path_t *vpath, const struct stat *st,
+                      char *hash)
+{
+    const gboolean cacheable = !S_ISLNK (st->st_mode);
+    char *key;
+    checksum_cache_entry_t *e;
+    int fd;
+    GChecksum *sum;
+    char buf[IO_BUFSIZE];
+    ssize_t n;
+
+    key = g_strdup_printf ("%ju:%ju", (uintmax_t) st->st_dev, (uintmax_t) st->st_ino);
+
+    if (cacheable)
+    {
+        e = g_hash_table_lookup (cache, key);
+        if (e != NULL && e->size == (uintmax_t) st->st_size && e->mtime == st->st_mtime)
+        {
+            e->used = TRUE;
+            memcpy (hash, e->hash, sizeof (e->hash));
+            g_free (key);
+            return TRUE;
+        }
+    }
+
+    fd = open (vfs_path_as_str (vpath), O_RDONLY);
+    if (fd < 0)
+    {
+        g_free (key);
+        return FALSE;
+    }
+
+    sum = g_checksum_new (G_CHECKSUM_SHA256);
+
+    rotate_dash (TRUE);
+    while ((n = read (fd, buf, sizeof (buf))) != 0)
+    {
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        g_checksum_update (sum, (const guchar *) buf, (gssize) n);
+    }
+    rotate_dash (FALSE);
+    close (fd);
+
+    if (n != 0)
+    {
+        g_checksum_free (sum);
+        g_free (key);
+        return FALSE;
+    }
+
+    g_strlcpy (hash, g_checksum_get_string (sum), 65);
+    g_checksum_free (sum);
+
+    if (cacheable)
+    {
+        e = g_new0 (checksum_cache_entry_t, 1);
+        e->size = (uintmax_t) st->st_size;
+        e->mtime = st->st_mtime;
+        e->used = TRUE;
+        memcpy (e->hash, hash, sizeof (e->hash));
+        g_hash_table_replace (cache, key, e);
+    }
+    else
+        g_free (key);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 compare_files (const vfs_path_t *vpath1, const vfs_path_t *vpath2, off_t size)
 {
@@ -209,8 +390,9 @@ compare_files (const vfs_path_t *vpath1, const vfs_path_t *vpath2, off_t size)
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-compare_dir (WPanel *panel, const WPanel *other, enum CompareMode mode)
+compare_dir (WPanel *panel, const WPanel *other, enum CompareMode mode, GHashTable *checksums)
 {
+    GHashTable *others;
     int i, j;
 
     // No marks by default
@@ -218,11 +400,25 @@ compare_dir (WPanel *panel, const WPanel *other, enum CompareMode mode)
     panel->total = 0;
     panel->dirs_marked = 0;
 
+    // Index the other panel once instead of searching it linearly for every file
+    others = g_hash_table_new (g_str_hash, g_str_equal);
+    for (j = 0; j < other->dir.len; j++)
+    {
+        const char *other_fname;
+
+        other_fname = other->dir.list[j].fname->str;
+        if (other->is_panelized)
+            other_fname = x_basename (other_fname);
+
+        g_hash_table_insert (others, (gpointer) other_fname, &other->dir.list[j]);
+    }
+
     // Handle all files in the panel
     for (i = 0; i < panel->dir.len; i++)
     {
         file_entry_t *source = &panel->dir.list[i];
         const char *source_fname;
+        file_entry_t *target;
 
         // Default: unmarked
         file_mark (panel, i, 0);
@@ -236,26 +432,14 @@ compare_dir (WPanel *panel, const WPanel *other, enum CompareMode mode)
             source_fname = x_basename (source_fname);
 
         // Search the corresponding entry from the other panel
-        for (j = 0; j < other->dir.len; j++)
-        {
-            const char *other_fname;
-
-            other_fname = other->dir.list[j].fname->str;
-            if (other->is_panelized)
-                other_fname = x_basename (other_fname);
+        target = g_hash_table_lookup (others, source_fname);
 
-            if (strcmp (source_fname, other_fname) == 0)
-                break;
-        }
-
-        if (j >= other->dir.len)
+        if (target == NULL)
             // Not found -> mark
             do_file_mark (panel, i, 1);
         else
         {
             // Found
-            file_entry_t *target = &other->dir.list[j];
-
             if (mode != compare_size_only)
                 // Older version is not marked
                 if (source->st.st_mtime < target->st.st_mtime)
@@ -281,6 +465,13 @@ compare_dir (WPanel *panel, const WPanel *other, enum CompareMode mode)
                 continue;
             }
 
+            /* Same size and same time stamp: take the pair as identical without reading
+             * it. This is what makes the thorough compare of large mostly-equal trees
+             * bearable; a touched but unchanged file still reads as equal, it is just
+             * found the expensive way. */
+            if (source->st.st_mtime == target->st.st_mtime)
+                continue;
+
             // Thorough compare on, do byte-by-byte comparison
             {
                 vfs_path_t *src_name, *dst_name;
@@ -289,13 +480,26 @@ compare_dir (WPanel *panel, const WPanel *other, enum CompareMode mode)
                     vfs_path_append_new (panel->cwd_vpath, source->fname->str, (char *) NULL);
                 dst_name =
                     vfs_path_append_new (other->cwd_vpath, target->fname->str, (char *) NULL);
-                if (compare_files (src_name, dst_name, source->st.st_size))
+                if (mode == compare_checksum)
+                {
+                    char h1[65], h2[65];
+
+                    /* content equality via cached checksums: only files whose
+                       dev/inode/size/mtime key is not known yet get read */
+                    if (!compare_checksum_get (checksums, src_name, &source->st, h1)
+                        || !compare_checksum_get (checksums, dst_name, &target->st, h2)
+                        || strcmp (h1, h2) != 0)
+                        do_file_mark (panel, i, 1);
+                }
+                else if (compare_files (src_name, dst_name, source->st.st_size))
                     do_file_mark (panel, i, 1);
                 vfs_path_free (src_name, TRUE);
                 vfs_path_free (dst_name, TRUE);
             }
         }
     }  // for (i ...)
+
+    g_hash_table_destroy (others);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1004,18 +1208,28 @@ compare_dirs_cmd (void)
     int choice;
     enum CompareMode thorough_flag;
 
-    choice = query_dialog (_ ("Compare directories"), _ ("Select compare method:"), D_NORMAL, 4,
-                           _ ("&Quick"), _ ("&Size only"), _ ("&Thorough"), _ ("&Cancel"));
+    choice =
+        query_dialog (_ ("Compare directories"), _ ("Select compare method:"), D_NORMAL, 5,
+                      _ ("&Quick"), _ ("&Size only"), _ ("&Thorough"), _ ("Chec&ksums"),
+                      _ ("&Cancel"));
 
-    if (choice < 0 || choice > 2)
+    if (choice < 0 || choice > 3)
         return;
 
     thorough_flag = choice;
 
     if (get_current_type () == view_listing && get_other_type () == view_listing)
     {
-        compare_dir (current_panel, other_panel, thorough_flag);
-        compare_dir (other_panel, current_panel, thorough_flag);
+        GHashTable *checksums = NULL;
+
+        if (thorough_flag == compare_checksum)
+            checksums = checksum_cache_load ();
+
+        compare_dir (current_panel, other_panel, thorough_flag, checksums);
+        compare_dir (other_panel, current_panel, thorough_flag, checksums);
+
+        if (checksums != NULL)
+            checksum_cache_save (checksums);
     }
     else
         message (D_ERROR, MSG_ERROR,
@@ -1256,6 +1470,8 @@ single_dirsize_cmd (WPanel *panel)
         {
             entry->st.st_size = (off_t) total;
             entry->f.dir_size_computed = 1;
+            // the size column of the row changed behind the display cache
+            panel_format_cache_invalidate (panel);
         }
 
         vfs_path_free (p, TRUE);
@@ -1271,7 +1487,7 @@ single_dirsize_cmd (WPanel *panel)
     if (panel->sort_field->sort_routine == (GCompareFunc) sort_size)
         panel_re_sort (panel);
 
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1309,13 +1525,14 @@ dirsizes_cmd (WPanel *panel)
         }
 
     status_msg_deinit (STATUS_MSG (&dsm));
+    panel_format_cache_invalidate (panel);
 
     recalculate_panel_summary (panel);
 
     if (panel->sort_field->sort_routine == (GCompareFunc) sort_size)
         panel_re_sort (panel);
 
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -30,6 +30,7 @@
 
 #include <config.h>
 
+#include <dirent.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,7 +41,11 @@
 #include "lib/search.h"
 #include "lib/vfs/vfs.h"
 #include "lib/fs.h"
+#include "lib/memstat.h"
+#include "lib/strspan.h"
 #include "lib/strutil.h"
+#include "lib/trace.h"
+#include "lib/unixcompat.h"  // makedev()
 #include "lib/util.h"
 
 #include "src/setup.h"  // panels_options
@@ -53,6 +58,15 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Size of one name arena block; see dir_list_intern_name() */
+#define DIR_NAME_ARENA_BLOCK_SIZE (1024 * 1024)
+
+/* Minimum number of entries before dir_list_sort() spreads the work over threads */
+#define DIR_PARALLEL_SORT_THRESHOLD 65536
+
+/* Upper bound on sort worker threads; merging more chunks stops paying off */
+#define DIR_PARALLEL_SORT_MAX_THREADS 8
+
 #define MY_ISDIR(x)                                                                                \
     ((is_exe (x->st.st_mode) && !(S_ISDIR (x->st.st_mode) || link_isdir (x)) && exec_first)        \
          ? 1                                                                                       \
@@ -60,6 +74,31 @@
 
 /*** file scope type declarations ****************************************************************/
 
+/* One directory entry produced by the background loader thread */
+typedef struct
+{
+    char *d_name;
+    size_t d_len;
+    struct stat st;         // lstat() result; zeroed if lstat() failed
+    struct stat target_st;  // stat() result for a symlink target
+    gboolean target_valid;  // stat() of symlink target succeeded
+} dir_load_item_t;
+
+/* Shared state of the background loader thread */
+typedef struct
+{
+    char *path;          // local directory being read
+    GAsyncQueue *queue;  // queue of dir_load_item_t, terminated by &dir_load_eof
+} dir_load_thread_ctx_t;
+
+/* One chunk of the list handed to a sort worker thread */
+typedef struct
+{
+    file_entry_t *base;
+    size_t len;
+    GCompareFunc sort;
+} dir_sort_chunk_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -73,7 +112,35 @@ static gboolean case_sensitive = OS_SORT_CASE_SENSITIVE_DEFAULT;
 /* Are the exec_bit files top in list */
 static gboolean exec_first = TRUE;
 
-static dir_list dir_copy = { NULL, 0, 0, NULL };
+static dir_list dir_copy = { NULL, 0, 0, NULL, NULL, NULL, 0 };
+
+/* End-of-stream marker pushed by the loader thread; only its address is used */
+static dir_load_item_t dir_load_eof;
+
+/* Parked snapshots of recently shown directories: leaving a directory moves the whole
+   dir_list here instead of freeing it, and coming back revives it after one stat. */
+/* With directory tabs a handful of contexts per panel is common, so keep
+   more than the two-panels-plus-history worth of snapshots */
+#define DIR_CACHE_SIZE        8
+#define DIR_CACHE_PATCH_AFTER (10 * G_USEC_PER_SEC)  // older revivals re-stat their entries
+
+typedef struct
+{
+    dir_list list;  // parked content; list.load_path doubles as the cache key
+    gint64 parked;  // when it was parked (monotonic), for the re-stat decision
+    guint64 stamp;  // recency, for LRU eviction
+} dir_cache_slot_t;
+
+static dir_cache_slot_t dir_cache[DIR_CACHE_SIZE];
+static guint64 dir_cache_stamp = 0;
+
+#ifdef HAVE_STATX
+/* Only the fields file_entry_t actually displays; keeps statx() from forcing
+   attribute refreshes (e.g. on NFS) for data we never show */
+#define DIR_LOAD_STATX_MASK                                                                        \
+    (STATX_TYPE | STATX_MODE | STATX_NLINK | STATX_UID | STATX_GID | STATX_INO | STATX_SIZE        \
+     | STATX_ATIME | STATX_MTIME | STATX_CTIME)
+#endif
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
@@ -122,44 +189,96 @@ compare_by_names (file_entry_t *a, file_entry_t *b)
 
 /* --------------------------------------------------------------------------------------------- */
 /**
- * clear keys, should be call after sorting is finished.
+ * Release the collation keys cached in the entries. Called when the keys become stale
+ * (case sensitivity changed) or when the list content goes away; between sorts the keys
+ * stay in place so a sort-order toggle does not re-derive them.
  */
 
 static void
-clean_sort_keys (dir_list *list, int start, int count)
+dir_list_release_sort_keys (dir_list *list)
 {
     int i;
 
-    for (i = 0; i < count; i++)
+    if (!list->have_sort_keys)
+        return;
+
+    for (i = 0; i < list->len; i++)
     {
         file_entry_t *fentry;
 
-        fentry = &list->list[i + start];
-        str_release_key (fentry->name_sort_key, case_sensitive);
+        fentry = &list->list[i];
+        str_release_key (fentry->name_sort_key, list->sort_keys_case_sen);
         fentry->name_sort_key = NULL;
-        str_release_key (fentry->extension_sort_key, case_sensitive);
+        str_release_key (fentry->extension_sort_key, list->sort_keys_case_sen);
         fentry->extension_sort_key = NULL;
     }
+
+    // parked entries may carry keys from the time they were visible
+    for (i = 0; i < list->hidden_len; i++)
+    {
+        file_entry_t *fentry;
+
+        fentry = &list->hidden[i];
+        str_release_key (fentry->name_sort_key, list->sort_keys_case_sen);
+        fentry->name_sort_key = NULL;
+        str_release_key (fentry->extension_sort_key, list->sort_keys_case_sen);
+        fentry->extension_sort_key = NULL;
+    }
+
+    list->have_sort_keys = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Visibility of a directory entry name under the current panel options. */
+
+static gboolean
+dir_name_visible (str_span_t name)
+{
+    if (!panels_options.show_dot_files && name.str[0] == '.')
+        return FALSE;
+    if (!panels_options.show_backups && name.str[name.len - 1] == '~')
+        return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Run the panel filter over one entry. Directories pass without matching when the filter
+ * applies to files only. The name verdict is what the dir_list hidden/verdict machinery
+ * caches; the flags are applied anew on every call.
+ */
+
+static gboolean
+dir_entry_passes_filter (const file_filter_t *filter, const char *name, size_t len,
+                         const struct stat *st, gboolean link_to_dir)
+{
+    if (filter == NULL || filter->handler == NULL)
+        return TRUE;
+
+    if ((filter->flags & SELECT_FILES_ONLY) != 0 && (S_ISDIR (st->st_mode) || link_to_dir))
+        return TRUE;
+
+    return mc_search_run (filter->handler, name, 0, len, NULL);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 /**
  * If you change handle_dirent then check also handle_path.
+ * Filtering is not done here - see dir_entry_passes_filter() - so that the caller can
+ * park rejected entries instead of dropping them.
  * @return FALSE = don't add, TRUE = add to the list
  */
 
 static gboolean
-handle_dirent (struct vfs_dirent *dp, const file_filter_t *filter, struct stat *buf1,
-               gboolean *link_to_dir, gboolean *stale_link)
+handle_dirent (struct vfs_dirent *dp, struct stat *buf1, gboolean *link_to_dir,
+               gboolean *stale_link)
 {
     vfs_path_t *vpath;
-    gboolean ok = TRUE;
 
     if (DIR_IS_DOT (dp->d_name) || DIR_IS_DOTDOT (dp->d_name))
         return FALSE;
-    if (!panels_options.show_dot_files && (dp->d_name[0] == '.'))
-        return FALSE;
-    if (!panels_options.show_backups && dp->d_name[dp->d_len - 1] == '~')
+    if (!dir_name_visible (str_span (dp->d_name, dp->d_len)))
         return FALSE;
 
     vpath = vfs_path_from_str (dp->d_name);
@@ -181,15 +300,308 @@ handle_dirent (struct vfs_dirent *dp, const file_filter_t *filter, struct stat *
 
     vfs_path_free (vpath, TRUE);
 
-    if (filter != NULL && filter->handler != NULL)
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Allocate an entry name from the list's arena. The GString header and the characters are
+ * laid out together in large blocks, so a million-entry listing costs a handful of
+ * allocations, sorting walks contiguous memory, and dir_list_clean() frees everything at
+ * once. Strings returned here must never be passed to g_string_free(); callers are
+ * expected to check file_entry_t.f.fname_in_arena.
+ */
+
+static GString *
+dir_list_intern_name (dir_list *list, const char *fname)
+{
+    GString *gs;
+    char *p;
+    size_t len, need;
+
+    len = strlen (fname);
+    need = sizeof (GString) + len + 1;
+    // keep GString headers pointer-aligned within the block
+    need = (need + sizeof (void *) - 1) & ~(sizeof (void *) - 1);
+
+    if (need > list->name_block_avail)
+    {
+        const size_t block_size = MAX (need, (size_t) DIR_NAME_ARENA_BLOCK_SIZE);
+
+        list->name_blocks = g_slist_prepend (list->name_blocks, g_malloc (block_size));
+        list->name_block_free = (char *) list->name_blocks->data;
+        list->name_block_avail = block_size;
+        list->name_blocks_bytes += block_size;
+        mc_memstat_alloc (MC_MEMSTAT_PANEL, block_size);
+    }
+
+    p = list->name_block_free;
+    list->name_block_free += need;
+    list->name_block_avail -= need;
+
+    gs = (GString *) p;
+    gs->str = p + sizeof (GString);
+    gs->len = len;
+    gs->allocated_len = len + 1;
+    memcpy (gs->str, fname, len + 1);
+
+    return gs;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Drop all arena blocks of the list at once. */
+
+static void
+dir_list_free_arena (dir_list *list)
+{
+    g_slist_free_full (list->name_blocks, g_free);
+    list->name_blocks = NULL;
+    list->name_block_free = NULL;
+    list->name_block_avail = 0;
+    mc_memstat_free (MC_MEMSTAT_PANEL, list->name_blocks_bytes);
+    list->name_blocks_bytes = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Park an entry rejected by the panel filter. The name is interned in the same arena as
+ * the visible entries, so dir_list_refilter() can move entries between .list and .hidden
+ * by plain struct copies when the filter changes.
+ */
+
+static gboolean
+dir_list_hidden_append (dir_list *list, const char *fname, const struct stat *st,
+                        gboolean link_to_dir, gboolean stale_link)
+{
+    file_entry_t *fentry;
+
+    // Need to grow the parking array?
+    if (list->hidden_len == list->hidden_size)
+    {
+        file_entry_t *fe;
+        const int size = list->hidden_size + DIR_LIST_RESIZE_STEP;
+
+        fe = g_try_renew (file_entry_t, list->hidden, size);
+        if (fe == NULL)
+            return FALSE;
+
+        list->hidden = fe;
+        list->hidden_size = size;
+    }
+
+    fentry = &list->hidden[list->hidden_len];
+    fentry->fname = dir_list_intern_name (list, fname);
+    fentry->f.marked = 0;
+    fentry->f.link_to_dir = link_to_dir ? 1 : 0;
+    fentry->f.stale_link = stale_link ? 1 : 0;
+    fentry->f.dir_size_computed = 0;
+    fentry->f.fname_in_arena = 1;
+    fentry->f.filter_match = 0;
+    fentry->st = *st;
+    fentry->name_sort_key = NULL;
+    fentry->extension_sort_key = NULL;
+    fentry->vers_prefixlen = -1;
+    fentry->fhl_serial = 0;
+    fentry->size_str[0] = '\0';
+
+    list->hidden_len++;
+
+    return TRUE;
+}
+
+#ifdef HAVE_STATX
+/* --------------------------------------------------------------------------------------------- */
+/** Convert a statx() result to the struct stat layout the rest of the panel code expects. */
+
+static void
+dir_load_statx_to_stat (const struct statx *stx, struct stat *st)
+{
+    memset (st, 0, sizeof (*st));
+    st->st_dev = makedev (stx->stx_dev_major, stx->stx_dev_minor);
+    st->st_ino = stx->stx_ino;
+    st->st_mode = stx->stx_mode;
+    st->st_nlink = stx->stx_nlink;
+    st->st_uid = stx->stx_uid;
+    st->st_gid = stx->stx_gid;
+    st->st_rdev = makedev (stx->stx_rdev_major, stx->stx_rdev_minor);
+    st->st_size = stx->stx_size;
+    st->st_blksize = stx->stx_blksize;
+    st->st_blocks = stx->stx_blocks;
+    st->st_atime = stx->stx_atime.tv_sec;
+    st->st_mtime = stx->stx_mtime.tv_sec;
+    st->st_ctime = stx->stx_ctime.tv_sec;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    st->st_atim.tv_nsec = stx->stx_atime.tv_nsec;
+    st->st_mtim.tv_nsec = stx->stx_mtime.tv_nsec;
+    st->st_ctim.tv_nsec = stx->stx_ctime.tv_nsec;
+#endif
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Background loader thread: read a local directory with plain readdir()/lstat() and stream
+ * the results into a queue. All syscalls happen here so that the UI thread only consumes
+ * ready-made entries. No VFS or UI calls are allowed in this function.
+ */
+
+static gpointer
+dir_load_thread (gpointer data)
+{
+    dir_load_thread_ctx_t *ctx = (dir_load_thread_ctx_t *) data;
+    DIR *dirp;
+
+    dirp = opendir (ctx->path);
+    if (dirp != NULL)
     {
-        gboolean files_only = (filter->flags & SELECT_FILES_ONLY) != 0;
+        struct dirent *d;
+#ifdef HAVE_STATX
+        const int dir_fd = dirfd (dirp);
+#endif
+
+        while ((d = readdir (dirp)) != NULL)
+        {
+            dir_load_item_t *item;
+
+            item = g_new0 (dir_load_item_t, 1);
+            item->d_len = strlen (d->d_name);
+            item->d_name = g_strndup (d->d_name, item->d_len);
+
+#ifdef HAVE_STATX
+            /* statx() relative to the directory fd: no path assembly, and a mask limited
+               to the fields we show. readdir() above already pulls whole getdents64 blocks
+               from the same fd, so the kernel serves both from a warm dcache. */
+            {
+                struct statx stx;
+
+                if (statx (dir_fd, d->d_name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+                           DIR_LOAD_STATX_MASK, &stx)
+                    != 0)
+                    memset (&item->st, 0, sizeof (item->st));
+                else
+                {
+                    dir_load_statx_to_stat (&stx, &item->st);
+                    if (S_ISLNK (item->st.st_mode)
+                        && statx (dir_fd, d->d_name, AT_NO_AUTOMOUNT, STATX_TYPE, &stx) == 0)
+                    {
+                        item->target_valid = TRUE;
+                        item->target_st.st_mode = stx.stx_mode;
+                    }
+                }
+            }
+#else
+            {
+                char *full_name;
+
+                full_name = g_build_filename (ctx->path, d->d_name, (char *) NULL);
+                if (lstat (full_name, &item->st) != 0)
+                    memset (&item->st, 0, sizeof (item->st));
+                else if (S_ISLNK (item->st.st_mode))
+                    item->target_valid = (stat (full_name, &item->target_st) == 0);
+                g_free (full_name);
+            }
+#endif
+
+            g_async_queue_push (ctx->queue, item);
+        }
 
-        ok = ((S_ISDIR (buf1->st_mode) || *link_to_dir) && files_only)
-            || mc_search_run (filter->handler, dp->d_name, 0, dp->d_len, NULL);
+        closedir (dirp);
     }
 
-    return ok;
+    g_async_queue_push (ctx->queue, &dir_load_eof);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Counterpart of handle_dirent() for entries produced by dir_load_thread(). The stat info
+ * is already in the item, so only visibility and tree store bookkeeping are done here.
+ * If you change handle_load_item then check also handle_dirent.
+ *
+ * @return FALSE = don't add, TRUE = add to the list
+ */
+
+static gboolean
+handle_load_item (const dir_load_item_t *item, struct stat *buf1, gboolean *link_to_dir,
+                  gboolean *stale_link)
+{
+    if (DIR_IS_DOT (item->d_name) || DIR_IS_DOTDOT (item->d_name))
+        return FALSE;
+    if (!dir_name_visible (str_span (item->d_name, item->d_len)))
+        return FALSE;
+
+    *buf1 = item->st;
+
+    if (S_ISDIR (buf1->st_mode))
+        tree_store_mark_checked (item->d_name);
+
+    // A link to a file or a directory?
+    *link_to_dir = FALSE;
+    *stale_link = FALSE;
+    if (S_ISLNK (buf1->st_mode))
+    {
+        *stale_link = !item->target_valid;
+        if (item->target_valid)
+            *link_to_dir = S_ISDIR (item->target_st.st_mode) != 0;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Fill @list from a queue served by dir_load_thread(). Entries are appended in batches
+ * between callback invocations, so the panel can keep its load indicator alive while
+ * the thread is still issuing lstat() calls.
+ */
+
+static gboolean
+dir_list_load_from_thread (dir_list *list, const vfs_path_t *vpath, const file_filter_t *filter)
+{
+    dir_load_thread_ctx_t ctx;
+    GThread *thread;
+    dir_load_item_t *item;
+    struct stat st;
+    gboolean ret = TRUE;
+
+    ctx.path = g_strdup (vfs_path_get_last_path_str (vpath));
+    ctx.queue = g_async_queue_new ();
+
+    thread = g_thread_new ("dir-load", dir_load_thread, &ctx);
+
+    while ((item = g_async_queue_pop (ctx.queue)) != &dir_load_eof)
+    {
+        gboolean link_to_dir, stale_link;
+
+        if (ret)
+        {
+            if (list->callback != NULL)
+                list->callback (DIR_READ, NULL);
+
+            if (handle_load_item (item, &st, &link_to_dir, &stale_link))
+            {
+                if (!dir_entry_passes_filter (filter, item->d_name, item->d_len, &st, link_to_dir))
+                {
+                    if (!dir_list_hidden_append (list, item->d_name, &st, link_to_dir, stale_link))
+                        ret = FALSE;
+                }
+                else if (!dir_list_append (list, item->d_name, &st, link_to_dir, stale_link))
+                    ret = FALSE;
+                else if (filter != NULL && filter->handler != NULL)
+                    list->list[list->len - 1].f.filter_match = 1;
+            }
+        }
+
+        g_free (item->d_name);
+        g_free (item);
+    }
+
+    g_thread_join (thread);
+    g_async_queue_unref (ctx.queue);
+    g_free (ctx.path);
+
+    return ret;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -218,6 +630,177 @@ dir_get_dotdot_stat (const vfs_path_t *vpath, struct stat *st)
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Remember which directory (and filter) the list was filled from, for the reload fast path. */
+
+static void
+dir_list_remember_load (dir_list *list, const vfs_path_t *vpath, const file_filter_t *filter)
+{
+    struct stat st;
+
+    g_free (list->load_path);
+    list->load_path = NULL;
+    g_free (list->load_filter);
+    list->load_filter = NULL;
+
+    if (mc_stat (vpath, &st) != 0)
+        return;
+
+    list->load_path = g_strdup (vfs_path_as_str (vpath));
+    if (filter != NULL && filter->handler != NULL)
+    {
+        list->load_filter = g_strdup (filter->value);
+        /* the entries were just split by this filter, so their f.filter_match bits
+           answer for it; with no filter active any cached verdicts are left alone */
+        g_free (list->verdict_filter);
+        list->verdict_filter = g_strdup (filter->value);
+        list->verdict_flags = filter->flags;
+    }
+    list->load_mtime = st.st_mtime;
+    list->load_time = time (NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * In-place reload: the set of names is unchanged (directory mtime is stable), so skip
+ * readdir() and the whole rebuild and only refresh the stat info of the entries we
+ * already have. Marks, cached collation keys and the name arena all stay intact.
+ */
+
+static void
+dir_list_patch_entries (dir_list *list, const vfs_path_t *vpath)
+{
+    int i;
+
+    if (list->callback != NULL)
+        list->callback (DIR_OPEN, (void *) vpath);
+
+    for (i = 0; i < list->len; i++)
+    {
+        file_entry_t *fentry;
+        vfs_path_t *entry_vpath;
+        struct stat st;
+
+        fentry = &list->list[i];
+        if (DIR_IS_DOTDOT (fentry->fname->str))
+            continue;
+
+        if (list->callback != NULL)
+            list->callback (DIR_READ, NULL);
+
+        entry_vpath = vfs_path_from_str (fentry->fname->str);
+        if (mc_lstat (entry_vpath, &st) == 0)
+        {
+            fentry->st = st;
+            if (S_ISLNK (st.st_mode))
+            {
+                gboolean stale_link = FALSE;
+
+                fentry->f.link_to_dir =
+                    file_is_symlink_to_dir (entry_vpath, &fentry->st, &stale_link) ? 1 : 0;
+                fentry->f.stale_link = stale_link ? 1 : 0;
+            }
+        }
+        vfs_path_free (entry_vpath, TRUE);
+    }
+
+    if (list->callback != NULL)
+        list->callback (DIR_CLOSE, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Re-derive the visible list from the retained superset (.list plus .hidden) after a
+ * filter change. The compiled pattern runs in one tight pass over the interned names -
+ * no directory I/O - and the verdicts stay in the entries' f.filter_match bits, so
+ * toggling the same filter off and back on re-splits without matching at all.
+ *
+ * @return FALSE if memory for the split could not be reserved; the caller then falls
+ *         back to a full reload
+ */
+
+static gboolean
+dir_list_refilter (dir_list *list, const file_filter_t *filter)
+{
+    file_entry_t *all;
+    int all_len, i;
+    gboolean have_verdicts;
+
+    all_len = list->len + list->hidden_len;
+    if (all_len == 0)
+        return TRUE;
+
+    // reserve room for the worst-case split before anything is moved
+    if (list->size < all_len && !dir_list_grow (list, all_len - list->size))
+        return FALSE;
+    if (filter != NULL && filter->handler != NULL && list->hidden_size < all_len)
+    {
+        file_entry_t *fe;
+
+        fe = g_try_renew (file_entry_t, list->hidden, all_len);
+        if (fe == NULL)
+            return FALSE;
+
+        list->hidden = fe;
+        list->hidden_size = all_len;
+    }
+
+    all = g_try_new (file_entry_t, all_len);
+    if (all == NULL)
+        return FALSE;
+
+    memcpy (all, list->list, list->len * sizeof (*all));
+    memcpy (all + list->len, list->hidden, list->hidden_len * sizeof (*all));
+    list->len = 0;
+    list->hidden_len = 0;
+
+    if (filter == NULL || filter->handler == NULL)
+    {
+        /* no filter: everything becomes visible again; the verdict bits are kept for
+           the next time this filter is switched back on */
+        memcpy (list->list, all, all_len * sizeof (*all));
+        list->len = all_len;
+        g_free (all);
+        return TRUE;
+    }
+
+    have_verdicts = list->verdict_filter != NULL
+        && strcmp (list->verdict_filter, filter->value) == 0
+        && list->verdict_flags == filter->flags;
+
+    if (!have_verdicts)
+    {
+        for (i = 0; i < all_len; i++)
+        {
+            file_entry_t *fe = &all[i];
+
+            fe->f.filter_match = dir_entry_passes_filter (filter, fe->fname->str, fe->fname->len,
+                                                          &fe->st, fe->f.link_to_dir != 0)
+                ? 1
+                : 0;
+        }
+
+        g_free (list->verdict_filter);
+        list->verdict_filter = g_strdup (filter->value);
+        list->verdict_flags = filter->flags;
+    }
+
+    // ".." is pinned visible and sits first in the merged set, so it stays first here
+    for (i = 0; i < all_len; i++)
+    {
+        file_entry_t *fe = &all[i];
+
+        if (fe->f.filter_match != 0 || DIR_IS_DOTDOT (fe->fname->str))
+            list->list[list->len++] = *fe;
+        else
+            list->hidden[list->hidden_len++] = *fe;
+    }
+
+    g_free (all);
+
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void
@@ -306,14 +889,19 @@ dir_list_append (dir_list *list, const char *fname, const struct stat *st, gbool
         return FALSE;
 
     fentry = &list->list[list->len];
-    fentry->fname = g_string_new (fname);
+    fentry->fname = dir_list_intern_name (list, fname);
     fentry->f.marked = 0;
     fentry->f.link_to_dir = link_to_dir ? 1 : 0;
     fentry->f.stale_link = stale_link ? 1 : 0;
     fentry->f.dir_size_computed = 0;
+    fentry->f.fname_in_arena = 1;
+    fentry->f.filter_match = 0;
     fentry->st = *st;
     fentry->name_sort_key = NULL;
     fentry->extension_sort_key = NULL;
+    fentry->vers_prefixlen = -1;
+    fentry->fhl_serial = 0;  // no memoized highlight color yet
+    fentry->size_str[0] = '\0';
 
     list->len++;
 
@@ -357,7 +945,13 @@ sort_vers (file_entry_t *a, file_entry_t *b)
     {
         int result;
 
-        result = filevercmp (a->fname->str, b->fname->str);
+        if (a->vers_prefixlen < 0)
+            a->vers_prefixlen = filevercmp_prefixlen (a->fname->str, (ssize_t) a->fname->len);
+        if (b->vers_prefixlen < 0)
+            b->vers_prefixlen = filevercmp_prefixlen (b->fname->str, (ssize_t) b->fname->len);
+
+        result = filenvercmp_prefix (a->fname->str, (ssize_t) a->fname->len, a->vers_prefixlen,
+                                     b->fname->str, (ssize_t) b->fname->len, b->vers_prefixlen);
         if (result != 0)
             return result * reverse;
 
@@ -492,6 +1086,150 @@ sort_size (file_entry_t *a, file_entry_t *b)
     return bd - ad;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create collation keys up front. The comparators build them lazily, but the lazy path
+ * must not run concurrently: the active codeset backend may keep static conversion
+ * buffers. With the keys in place the comparators are pure and thread-safe.
+ */
+
+static void
+make_sort_keys (dir_list *list, int start, int count, gboolean extensions, gboolean versions)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        file_entry_t *fentry;
+
+        fentry = &list->list[i + start];
+        if (fentry->name_sort_key == NULL)
+            fentry->name_sort_key = str_create_key_for_filename (fentry->fname->str,
+                                                                 case_sensitive);
+        if (extensions && fentry->extension_sort_key == NULL)
+            fentry->extension_sort_key =
+                str_create_key (extension (fentry->fname->str), case_sensitive);
+        if (versions && fentry->vers_prefixlen < 0)
+            fentry->vers_prefixlen =
+                filevercmp_prefixlen (fentry->fname->str, (ssize_t) fentry->fname->len);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gpointer
+dir_sort_chunk_thread (gpointer data)
+{
+    dir_sort_chunk_t *chunk = (dir_sort_chunk_t *) data;
+
+    qsort (chunk->base, chunk->len, sizeof (file_entry_t), chunk->sort);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Merge two adjacent sorted runs into @dst. */
+
+static void
+dir_sort_merge_runs (file_entry_t *dst, const file_entry_t *a, size_t alen,
+                     const file_entry_t *b, size_t blen, GCompareFunc sort)
+{
+    int (*cmp) (const void *, const void *) = (int (*) (const void *, const void *)) sort;
+
+    while (alen != 0 && blen != 0)
+        if (cmp (a, b) <= 0)
+        {
+            *dst++ = *a++;
+            alen--;
+        }
+        else
+        {
+            *dst++ = *b++;
+            blen--;
+        }
+
+    if (alen != 0)
+        memcpy (dst, a, alen * sizeof (*dst));
+    if (blen != 0)
+        memcpy (dst, b, blen * sizeof (*dst));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Parallel merge sort: qsort() disjoint chunks in worker threads, then merge the sorted
+ * runs pairwise. Comparison keys are created beforehand by the caller, so the workers
+ * only read shared state.
+ */
+
+static void
+dir_list_sort_parallel (file_entry_t *base, size_t len, GCompareFunc sort)
+{
+    dir_sort_chunk_t chunks[DIR_PARALLEL_SORT_MAX_THREADS];
+    GThread *threads[DIR_PARALLEL_SORT_MAX_THREADS];
+    size_t runs[DIR_PARALLEL_SORT_MAX_THREADS];
+    file_entry_t *scratch, *cur, *other;
+    size_t n_runs, i, chunk_len;
+
+    n_runs = MIN ((size_t) g_get_num_processors (), (size_t) DIR_PARALLEL_SORT_MAX_THREADS);
+    chunk_len = (len + n_runs - 1) / n_runs;
+
+    for (i = 0; i < n_runs; i++)
+    {
+        const size_t offset = i * chunk_len;
+
+        chunks[i].base = base + offset;
+        chunks[i].len = MIN (chunk_len, len - offset);
+        chunks[i].sort = sort;
+        runs[i] = chunks[i].len;
+        threads[i] = g_thread_new ("dir-sort", dir_sort_chunk_thread, &chunks[i]);
+    }
+
+    for (i = 0; i < n_runs; i++)
+        g_thread_join (threads[i]);
+
+    /* The sorted runs partition the list contiguously; merge them pairwise,
+       ping-ponging between the list and a scratch buffer. */
+    scratch = g_new (file_entry_t, len);
+    cur = base;
+    other = scratch;
+
+    while (n_runs > 1)
+    {
+        size_t n_out = 0;
+        size_t offset = 0;
+
+        for (i = 0; i < n_runs; i += 2)
+        {
+            if (i + 1 < n_runs)
+            {
+                dir_sort_merge_runs (other + offset, cur + offset, runs[i],
+                                     cur + offset + runs[i], runs[i + 1], sort);
+                runs[n_out] = runs[i] + runs[i + 1];
+            }
+            else
+            {
+                memcpy (other + offset, cur + offset, runs[i] * sizeof (*cur));
+                runs[n_out] = runs[i];
+            }
+
+            offset += runs[n_out];
+            n_out++;
+        }
+
+        {
+            file_entry_t *tmp = cur;
+
+            cur = other;
+            other = tmp;
+        }
+        n_runs = n_out;
+    }
+
+    if (cur != base)
+        memcpy (base, cur, len * sizeof (*base));
+    g_free (scratch);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -501,17 +1239,33 @@ dir_list_sort (dir_list *list, GCompareFunc sort, const dir_sort_options_t *sort
     {
         file_entry_t *fentry = &list->list[0];
         int dot_dot_found;
+        int count;
 
         /* If there is an ".." entry the caller must take care to
            ensure that it occupies the first list element. */
         dot_dot_found = DIR_IS_DOTDOT (fentry->fname->str) ? 1 : 0;
+        count = list->len - dot_dot_found;
+
+        // cached keys were built for a different case sensitivity - drop them
+        if (list->have_sort_keys && list->sort_keys_case_sen != sort_op->case_sensitive)
+            dir_list_release_sort_keys (list);
+
         reverse = sort_op->reverse ? -1 : 1;
         case_sensitive = sort_op->case_sensitive ? 1 : 0;
         exec_first = sort_op->exec_first;
-        qsort (&(list->list)[dot_dot_found], list->len - dot_dot_found, sizeof (file_entry_t),
-               sort);
 
-        clean_sort_keys (list, dot_dot_found, list->len - dot_dot_found);
+        if (count >= DIR_PARALLEL_SORT_THRESHOLD && g_get_num_processors () > 1)
+        {
+            make_sort_keys (list, dot_dot_found, count, sort == (GCompareFunc) sort_ext,
+                            sort == (GCompareFunc) sort_vers);
+            dir_list_sort_parallel (&(list->list)[dot_dot_found], (size_t) count, sort);
+        }
+        else
+            qsort (&(list->list)[dot_dot_found], count, sizeof (file_entry_t), sort);
+
+        // keep the keys for the next re-sort
+        list->have_sort_keys = TRUE;
+        list->sort_keys_case_sen = sort_op->case_sensitive;
     }
 }
 
@@ -522,15 +1276,40 @@ dir_list_clean (dir_list *list)
 {
     int i;
 
+    dir_list_release_sort_keys (list);
+
     for (i = 0; i < list->len; i++)
     {
         file_entry_t *fentry;
 
         fentry = &list->list[i];
-        g_string_free (fentry->fname, TRUE);
+        if (fentry->f.fname_in_arena == 0)
+            g_string_free (fentry->fname, TRUE);
         fentry->fname = NULL;
     }
 
+    for (i = 0; i < list->hidden_len; i++)
+    {
+        file_entry_t *fentry;
+
+        fentry = &list->hidden[i];
+        if (fentry->f.fname_in_arena == 0)
+            g_string_free (fentry->fname, TRUE);
+        fentry->fname = NULL;
+    }
+
+    dir_list_free_arena (list);
+
+    MC_PTR_FREE (list->hidden);
+    list->hidden_size = 0;
+    list->hidden_len = 0;
+    MC_PTR_FREE (list->verdict_filter);
+
+    /* the load snapshot describes entries that are gone now; forget it so neither the
+       reload fast path nor the snapshot cache can act on replacement content */
+    MC_PTR_FREE (list->load_path);
+    MC_PTR_FREE (list->load_filter);
+
     list->len = 0;
     // reduce memory usage
     dir_list_grow (list, DIR_LIST_MIN_SIZE - list->size);
@@ -543,14 +1322,36 @@ dir_list_free_list (dir_list *list)
 {
     int i;
 
+    dir_list_release_sort_keys (list);
+
     for (i = 0; i < list->len; i++)
     {
         file_entry_t *fentry;
 
         fentry = &list->list[i];
-        g_string_free (fentry->fname, TRUE);
+        if (fentry->f.fname_in_arena == 0)
+            g_string_free (fentry->fname, TRUE);
+    }
+
+    for (i = 0; i < list->hidden_len; i++)
+    {
+        file_entry_t *fentry;
+
+        fentry = &list->hidden[i];
+        if (fentry->f.fname_in_arena == 0)
+            g_string_free (fentry->fname, TRUE);
     }
 
+    dir_list_free_arena (list);
+
+    MC_PTR_FREE (list->load_path);
+    MC_PTR_FREE (list->load_filter);
+
+    MC_PTR_FREE (list->hidden);
+    list->hidden_size = 0;
+    list->hidden_len = 0;
+    MC_PTR_FREE (list->verdict_filter);
+
     MC_PTR_FREE (list->list);
     list->len = 0;
     list->size = 0;
@@ -580,6 +1381,9 @@ dir_list_init (dir_list *list)
     fentry->f.marked = 0;
     fentry->st.st_mode = 040755;
     list->len = 1;
+    // starting over: any parked entries and cached filter verdicts are meaningless now
+    list->hidden_len = 0;
+    MC_PTR_FREE (list->verdict_filter);
     return TRUE;
 }
 
@@ -628,6 +1432,144 @@ handle_path (const char *path, struct stat *buf1, gboolean *link_to_dir, gboolea
     return TRUE;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Park the content of @list in the snapshot cache instead of freeing it, so that coming
+ * back to the same directory can revive it without re-reading. Lists without a usable
+ * load snapshot are simply freed. @list itself is left empty either way.
+ */
+
+void
+dir_list_cache_park (dir_list *list)
+{
+    dir_cache_slot_t *slot = NULL;
+    dir_list_cb_fn callback;
+    int i;
+
+    /* only lists with a known origin and a trustworthy mtime check are worth keeping;
+       see dir_list_is_fresh() for the mtime/load_time reasoning */
+    if (list->load_path == NULL || list->load_mtime >= list->load_time || list->len == 0)
+    {
+        dir_list_free_list (list);
+        return;
+    }
+
+    // an older copy of the same directory is replaced
+    for (i = 0; i < DIR_CACHE_SIZE; i++)
+        if (dir_cache[i].list.load_path != NULL
+            && strcmp (dir_cache[i].list.load_path, list->load_path) == 0)
+        {
+            slot = &dir_cache[i];
+            break;
+        }
+
+    if (slot == NULL)
+        for (i = 0; i < DIR_CACHE_SIZE; i++)
+            if (dir_cache[i].list.load_path == NULL)
+            {
+                slot = &dir_cache[i];
+                break;
+            }
+
+    if (slot == NULL)
+    {
+        slot = &dir_cache[0];
+        for (i = 1; i < DIR_CACHE_SIZE; i++)
+            if (dir_cache[i].stamp < slot->stamp)
+                slot = &dir_cache[i];
+    }
+
+    if (slot->list.load_path != NULL)
+        dir_list_free_list (&slot->list);
+
+    // marks belong to the visit, not to the directory
+    for (i = 0; i < list->len; i++)
+        list->list[i].f.marked = 0;
+
+    slot->list = *list;
+    slot->list.callback = NULL;
+    slot->parked = g_get_monotonic_time ();
+    slot->stamp = ++dir_cache_stamp;
+
+    // detach the source without freeing what it no longer owns
+    callback = list->callback;
+    memset (list, 0, sizeof (*list));
+    list->callback = callback;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Revive a parked snapshot of @vpath into @list, validated by a single stat of the
+ * directory itself. Snapshots parked a while ago additionally refresh their entries'
+ * stat info in place; a filter different from the parked one re-splits the retained
+ * superset in memory. Either way no readdir() happens.
+ *
+ * @return TRUE if @list now holds the directory; FALSE if there was no valid snapshot
+ *         and the caller should load normally
+ */
+
+gboolean
+dir_list_cache_take (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
+                     const dir_sort_options_t *sort_op, const file_filter_t *filter)
+{
+    const char *path_str = vfs_path_as_str (vpath);
+    dir_cache_slot_t *slot = NULL;
+    struct stat st;
+    dir_list_cb_fn callback;
+    const char *filter_value = NULL;
+    gboolean filter_same;
+    gboolean stale;
+    int i;
+
+    for (i = 0; i < DIR_CACHE_SIZE; i++)
+        if (dir_cache[i].list.load_path != NULL
+            && strcmp (dir_cache[i].list.load_path, path_str) == 0)
+        {
+            slot = &dir_cache[i];
+            break;
+        }
+
+    if (slot == NULL)
+        return FALSE;
+
+    // one stat decides whether the parked name set is still what is on disk
+    if (mc_stat (vpath, &st) != 0 || st.st_mtime != slot->list.load_mtime)
+    {
+        dir_list_free_list (&slot->list);
+        memset (slot, 0, sizeof (*slot));
+        return FALSE;
+    }
+
+    callback = list->callback;
+    dir_list_free_list (list);
+    *list = slot->list;
+    list->callback = callback;
+
+    stale = g_get_monotonic_time () - slot->parked >= DIR_CACHE_PATCH_AFTER;
+    memset (slot, 0, sizeof (*slot));
+
+    if (filter != NULL && filter->handler != NULL)
+        filter_value = filter->value;
+
+    filter_same = g_strcmp0 (filter_value, list->load_filter) == 0
+        && (filter_value == NULL || list->verdict_flags == filter->flags);
+
+    if (!filter_same && !dir_list_refilter (list, filter))
+    {
+        // could not re-split in memory; hand a clean list back for a full load
+        dir_list_clean (list);
+        return FALSE;
+    }
+
+    if (stale)
+        dir_list_patch_entries (list, vpath);
+
+    dir_list_sort (list, sort, sort_op);
+    dir_list_remember_load (list, vpath, filter);
+
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 gboolean
@@ -640,6 +1582,7 @@ dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     file_entry_t *fentry;
     const char *vpath_str;
     gboolean ret = TRUE;
+    const gint64 trace_start = mc_trace_begin ();
 
     // ".." (if any) must be the first entry in the list
     if (!dir_list_init (list))
@@ -662,19 +1605,32 @@ dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     if (IS_PATH_SEP (vpath_str[0]) && vpath_str[1] == '\0')
         dir_list_clean (list);
 
-    while (ret && (dp = mc_readdir (dirp)) != NULL)
-    {
-        gboolean link_to_dir, stale_link;
-
-        if (list->callback != NULL)
-            list->callback (DIR_READ, dp);
-
-        if (!handle_dirent (dp, filter, &st, &link_to_dir, &stale_link))
-            continue;
-
-        if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
-            ret = FALSE;
-    }
+    /* Local directories are read by a background thread so that the readdir()/lstat()
+       syscalls overlap with filtering and list building; the VFS layer is not
+       thread-safe, so remote directories keep the serial path. */
+    if (vfs_file_is_local (vpath))
+        ret = dir_list_load_from_thread (list, vpath, filter);
+    else
+        while (ret && (dp = mc_readdir (dirp)) != NULL)
+        {
+            gboolean link_to_dir, stale_link;
+
+            if (list->callback != NULL)
+                list->callback (DIR_READ, dp);
+
+            if (!handle_dirent (dp, &st, &link_to_dir, &stale_link))
+                continue;
+
+            if (!dir_entry_passes_filter (filter, dp->d_name, dp->d_len, &st, link_to_dir))
+            {
+                if (!dir_list_hidden_append (list, dp->d_name, &st, link_to_dir, stale_link))
+                    ret = FALSE;
+            }
+            else if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
+                ret = FALSE;
+            else if (filter != NULL && filter->handler != NULL)
+                list->list[list->len - 1].f.filter_match = 1;
+        }
 
     if (ret)
         dir_list_sort (list, sort, sort_op);
@@ -684,6 +1640,11 @@ dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     mc_closedir (dirp);
     tree_store_end_check ();
 
+    if (ret)
+        dir_list_remember_load (list, vpath, filter);
+
+    mc_trace_end ("dir_list_load", trace_start, (guint64) list->len);
+
     return ret;
 }
 
@@ -700,6 +1661,24 @@ if_link_is_exe (const vfs_path_t *full_name_vpath, const file_entry_t *file)
     return TRUE;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether the set of names on disk can still match the last (re)load: same
+ * directory and a directory mtime that has not moved since then. An mtime equal to the
+ * load time itself is not trusted - the directory may have changed again within the
+ * same second.
+ */
+
+gboolean
+dir_list_is_fresh (const dir_list *list, const vfs_path_t *vpath)
+{
+    struct stat st;
+
+    return list->load_path != NULL && strcmp (list->load_path, vfs_path_as_str (vpath)) == 0
+        && list->load_mtime < list->load_time && mc_stat (vpath, &st) == 0
+        && st.st_mtime == list->load_mtime;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /** If filter is null, then it is a match */
 
@@ -716,6 +1695,30 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     const char *tmp_path;
     gboolean ret = TRUE;
 
+    /* Nothing was created, deleted or renamed in the directory since the last load:
+       refresh the entries we have instead of rebuilding the whole list. If only the
+       filter changed, re-split the retained superset in memory - no readdir() either
+       way. */
+    if (dir_list_is_fresh (list, vpath))
+    {
+        const char *filter_value = NULL;
+        gboolean filter_same;
+
+        if (filter != NULL && filter->handler != NULL)
+            filter_value = filter->value;
+
+        filter_same = g_strcmp0 (filter_value, list->load_filter) == 0
+            && (filter_value == NULL || list->verdict_flags == filter->flags);
+
+        if (filter_same || dir_list_refilter (list, filter))
+        {
+            dir_list_patch_entries (list, vpath);
+            dir_list_sort (list, sort, sort_op);
+            dir_list_remember_load (list, vpath, filter);
+            return TRUE;
+        }
+    }
+
     if (list->callback != NULL)
         list->callback (DIR_OPEN, (void *) vpath);
     dirp = mc_opendir (vpath);
@@ -742,8 +1745,11 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
         dfentry->f.dir_size_computed = fentry->f.dir_size_computed;
         dfentry->f.link_to_dir = fentry->f.link_to_dir;
         dfentry->f.stale_link = fentry->f.stale_link;
+        dfentry->f.fname_in_arena = 0;  // the copy is an ordinary heap string
         dfentry->name_sort_key = NULL;
         dfentry->extension_sort_key = NULL;
+        dfentry->vers_prefixlen = fentry->vers_prefixlen;
+        dfentry->fhl_serial = 0;
         if (fentry->f.marked != 0)
         {
             g_hash_table_insert (marked_files, dfentry->fname->str, dfentry);
@@ -788,10 +1794,15 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
         if (list->callback != NULL)
             list->callback (DIR_READ, dp);
 
-        if (!handle_dirent (dp, filter, &st, &link_to_dir, &stale_link))
+        if (!handle_dirent (dp, &st, &link_to_dir, &stale_link))
             continue;
 
-        if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
+        if (!dir_entry_passes_filter (filter, dp->d_name, dp->d_len, &st, link_to_dir))
+        {
+            if (!dir_list_hidden_append (list, dp->d_name, &st, link_to_dir, stale_link))
+                ret = FALSE;
+        }
+        else if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
             ret = FALSE;
         else
         {
@@ -799,6 +1810,9 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
 
             fentry = &list->list[list->len - 1];
 
+            if (filter != NULL && filter->handler != NULL)
+                fentry->f.filter_match = 1;
+
             /*
              * If we have marked files in the copy, scan through the copy
              * to find matching file.  Decrease number of remaining marks if
@@ -822,9 +1836,171 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     g_hash_table_destroy (marked_files);
     dir_list_free_list (&dir_copy);
 
+    if (ret)
+        dir_list_remember_load (list, vpath, filter);
+
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Apply a known set of changed names to the list instead of rebuilding it. Used by the
+ * directory watcher: each name is stat'ed once and the entry is updated, inserted or
+ * removed accordingly, then the list is re-sorted (cheap - collation keys are cached).
+ *
+ * @param list directory list
+ * @param vpath directory the names live in; must be the directory the list was loaded from
+ * @param names changed file names (no duplicates expected)
+ * @param sort sort function
+ * @param sort_op sort options
+ * @param filter file filter
+ *
+ * @return FALSE if the list could not be patched and a full reload is required
+ */
+
+gboolean
+dir_list_update_names (dir_list *list, const vfs_path_t *vpath, GPtrArray *names,
+                       GCompareFunc sort, const dir_sort_options_t *sort_op,
+                       const file_filter_t *filter)
+{
+    GHashTable *name_index;
+    guint n;
+    int i, j;
+
+    if (list->load_path == NULL || strcmp (list->load_path, vfs_path_as_str (vpath)) != 0)
+        return FALSE;
+
+    /* entry lookup by name; indexes stay valid because removal only clears fname here.
+       Visible entries are coded as i+1, parked ones as -(i+1), absent names as 0. */
+    name_index = g_hash_table_new (g_str_hash, g_str_equal);
+    for (i = 0; i < list->len; i++)
+        g_hash_table_insert (name_index, list->list[i].fname->str, GINT_TO_POINTER (i + 1));
+    for (i = 0; i < list->hidden_len; i++)
+        g_hash_table_insert (name_index, list->hidden[i].fname->str, GINT_TO_POINTER (-(i + 1)));
+
+    for (n = 0; n < names->len; n++)
+    {
+        const char *name = g_ptr_array_index (names, n);
+        const size_t name_len = strlen (name);
+        vfs_path_t *entry_vpath;
+        struct stat st;
+        gboolean exists;
+        file_entry_t *fentry = NULL;
+        int code;
+
+        if (DIR_IS_DOT (name) || DIR_IS_DOTDOT (name))
+            continue;
+
+        code = GPOINTER_TO_INT (g_hash_table_lookup (name_index, name));
+        if (code > 0)
+            fentry = &list->list[code - 1];
+        else if (code < 0)
+            fentry = &list->hidden[-code - 1];
+
+        entry_vpath = vfs_path_from_str (name);
+        exists = mc_lstat (entry_vpath, &st) == 0;
+
+        if (!exists)
+        {
+            // the file is gone - drop its entry, the hole is compacted below
+            if (fentry != NULL)
+            {
+                if (list->have_sort_keys)
+                {
+                    str_release_key (fentry->name_sort_key, list->sort_keys_case_sen);
+                    fentry->name_sort_key = NULL;
+                    str_release_key (fentry->extension_sort_key, list->sort_keys_case_sen);
+                    fentry->extension_sort_key = NULL;
+                }
+                if (fentry->f.fname_in_arena == 0)
+                    g_string_free (fentry->fname, TRUE);
+                fentry->fname = NULL;
+            }
+        }
+        else if (fentry != NULL)
+        {
+            // known entry (visible or parked): refresh stat info and symlink state
+            fentry->st = st;
+            fentry->fhl_serial = 0;
+            if (S_ISLNK (st.st_mode))
+            {
+                gboolean stale_link = FALSE;
+
+                fentry->f.link_to_dir =
+                    file_is_symlink_to_dir (entry_vpath, &fentry->st, &stale_link) ? 1 : 0;
+                fentry->f.stale_link = stale_link ? 1 : 0;
+            }
+            else
+            {
+                fentry->f.link_to_dir = 0;
+                fentry->f.stale_link = 0;
+            }
+        }
+        else
+        {
+            // new entry: same visibility rules as handle_dirent()
+            gboolean link_to_dir = FALSE, stale_link = FALSE;
+
+            if (dir_name_visible (str_span (name, name_len)))
+            {
+                if (S_ISDIR (st.st_mode))
+                    tree_store_mark_checked (name);
+
+                link_to_dir = file_is_symlink_to_dir (entry_vpath, &st, &stale_link);
+
+                if (!dir_entry_passes_filter (filter, name, name_len, &st, link_to_dir))
+                {
+                    if (dir_list_hidden_append (list, name, &st, link_to_dir, stale_link))
+                        g_hash_table_insert (name_index,
+                                             list->hidden[list->hidden_len - 1].fname->str,
+                                             GINT_TO_POINTER (-list->hidden_len));
+                }
+                else if (dir_list_append (list, name, &st, link_to_dir, stale_link))
+                {
+                    if (filter != NULL && filter->handler != NULL)
+                        list->list[list->len - 1].f.filter_match = 1;
+                    else
+                        /* with no filter active the new entry's filter_match bit was
+                           not computed against the remembered verdict filter: drop
+                           the cached verdicts so that switching that filter back on
+                           re-evaluates instead of parking the entry hidden */
+                        MC_PTR_FREE (list->verdict_filter);
+                    g_hash_table_insert (name_index, list->list[list->len - 1].fname->str,
+                                         GINT_TO_POINTER (list->len));
+                }
+            }
+        }
+
+        vfs_path_free (entry_vpath, TRUE);
+    }
+
+    g_hash_table_destroy (name_index);
+
+    // compact the holes left by removed entries
+    for (i = j = 0; i < list->len; i++)
+        if (list->list[i].fname != NULL)
+        {
+            if (j != i)
+                list->list[j] = list->list[i];
+            j++;
+        }
+    list->len = j;
+
+    for (i = j = 0; i < list->hidden_len; i++)
+        if (list->hidden[i].fname != NULL)
+        {
+            if (j != i)
+                list->hidden[j] = list->hidden[i];
+            j++;
+        }
+    list->hidden_len = j;
+
+    dir_list_sort (list, sort, sort_op);
+    dir_list_remember_load (list, vpath, filter);
+
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -50,6 +50,32 @@ typedef struct
     int size;                 // number of allocated elements in list (capacity)
     int len;                  // number of used elements in list
     dir_list_cb_fn callback;  // callback to visualize of directory read
+    /* Arena for entry names: a few large blocks instead of one allocation per name.
+       Entries allocated here carry f.fname_in_arena and are freed all at once. */
+    GSList *name_blocks;      // list of arena blocks, newest first
+    char *name_block_free;    // next free byte in the newest block
+    size_t name_block_avail;  // bytes still free in the newest block
+    size_t name_blocks_bytes;  // total size of all blocks, for allocation accounting
+    /* Collation keys survive the sort that created them, so toggling the sort order
+       re-sorts without re-deriving a key per entry. */
+    gboolean have_sort_keys;      // entries may hold cached collation keys
+    gboolean sort_keys_case_sen;  // case sensitivity the cached keys were built with
+    /* Snapshot of the last (re)load; lets dir_list_reload() patch the list in place
+       when the directory itself has not changed. */
+    char *load_path;    // directory the list was loaded from
+    char *load_filter;  // filter value active during that load, NULL = none
+    time_t load_mtime;  // directory mtime observed after reading it
+    time_t load_time;   // when the load happened; mtime equal to it is not trusted
+    /* Entries rejected by the panel filter are parked here instead of being thrown away,
+       so a filter change over an unchanged directory re-splits the retained set in
+       memory instead of re-reading it. Their names live in the same arena. */
+    file_entry_t *hidden;  // entries filtered out of .list during the last (re)load
+    int hidden_size;       // number of allocated elements in hidden
+    int hidden_len;        // number of used elements in hidden
+    /* Filter the entries' f.filter_match bits were computed for; toggling the same
+       filter off and back on re-splits by the bits without matching again. */
+    char *verdict_filter;          // filter value, NULL = no cached verdicts
+    select_flags_t verdict_flags;  // filter flags in effect at that time
 } dir_list;
 
 /**
@@ -78,10 +104,17 @@ gboolean dir_list_grow (dir_list *list, int delta);
 gboolean dir_list_append (dir_list *list, const char *fname, const struct stat *st,
                           gboolean link_to_dir, gboolean stale_link);
 
+void dir_list_cache_park (dir_list *list);
+gboolean dir_list_cache_take (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
+                              const dir_sort_options_t *sort_op, const file_filter_t *filter);
 gboolean dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
                         const dir_sort_options_t *sort_op, const file_filter_t *filter);
 gboolean dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
                           const dir_sort_options_t *sort_op, const file_filter_t *filter);
+gboolean dir_list_is_fresh (const dir_list *list, const vfs_path_t *vpath);
+gboolean dir_list_update_names (dir_list *list, const vfs_path_t *vpath, GPtrArray *names,
+                                GCompareFunc sort, const dir_sort_options_t *sort_op,
+                                const file_filter_t *filter);
 void dir_list_sort (dir_list *list, GCompareFunc sort, const dir_sort_options_t *sort_op);
 gboolean dir_list_init (dir_list *list);
 void dir_list_clean (dir_list *list);
@@ -39,7 +39,8 @@
 
 #include "filemanager.h"  // left_panel/right_panel/current_panel
 #include "panel.h"
-#include "layout.h"  // dynamic_file_list_debounce_sec
+#include "layout.h"     // dynamic_file_list_debounce_sec
+#include "treestore.h"  // keep the directory tree in sync with events
 #include "lib/widget/dialog-switch.h"  // do_refresh()
 
 #ifdef __linux__
@@ -55,6 +56,15 @@ static gboolean watcher_enabled = FALSE;
 static gboolean watcher_quiet = FALSE;
 static gboolean pending_left = FALSE;
 static gboolean pending_right = FALSE;
+/* Names collected from events since the last refresh; NULL set or the overflow
+ * flag means "too much changed, do a full reload". */
+static GHashTable *names_left = NULL;
+static GHashTable *names_right = NULL;
+static gboolean full_left = FALSE;
+static gboolean full_right = FALSE;
+
+/* Above this many distinct names a full reload is cheaper than patching. */
+#define DW_MAX_PENDING_NAMES 128
 /* default debounce interval in milliseconds */
 /* debouncing interval comes from layout setting */
 
@@ -62,6 +72,98 @@ static const uint32_t DW_MASK =
     IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ATTRIB |
     IN_MODIFY | IN_CLOSE_WRITE;
 
+static void dirwatch_clear_pending_names (gboolean left, gboolean right)
+{
+    if (left)
+    {
+        if (names_left != NULL)
+            g_hash_table_remove_all (names_left);
+        full_left = FALSE;
+    }
+    if (right)
+    {
+        if (names_right != NULL)
+            g_hash_table_remove_all (names_right);
+        full_right = FALSE;
+    }
+}
+
+static void dirwatch_add_pending_name (gboolean left, const struct inotify_event *ev)
+{
+    GHashTable **set = left ? &names_left : &names_right;
+    gboolean *full = left ? &full_left : &full_right;
+
+    if (*full)
+        return;
+
+    /* events without a name (watched dir itself changed) and queue overflows
+     * can't be mapped to entries */
+    if (ev->len == 0 || (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_Q_OVERFLOW)) != 0)
+    {
+        *full = TRUE;
+        return;
+    }
+
+    if (*set == NULL)
+        *set = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    g_hash_table_add (*set, g_strdup (ev->name));
+    if (g_hash_table_size (*set) > DW_MAX_PENDING_NAMES)
+        *full = TRUE;
+}
+
+/* Patch the tree store from a directory event so that stale nodes do not
+ * linger until a manual rescan: a subdirectory removed or renamed away takes
+ * its stored subtree with it, a new one drops the parent's "scanned" mark so
+ * the next tree visit rescans just that directory. */
+static void dirwatch_update_tree_store (const char *dir_path, const struct inotify_event *ev)
+{
+    vfs_path_t *vpath;
+
+    if (dir_path == NULL)
+        return;
+
+    if ((ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0)
+    {
+        // the watched directory itself is gone
+        vpath = vfs_path_from_str (dir_path);
+        tree_store_remove_entry (vpath);
+        vfs_path_free (vpath, TRUE);
+        return;
+    }
+
+    if ((ev->mask & IN_ISDIR) == 0 || ev->len == 0)
+        return;
+
+    if ((ev->mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+    {
+        vpath = vfs_path_build_filename (dir_path, ev->name, (char *) NULL);
+        tree_store_remove_entry (vpath);
+        vfs_path_free (vpath, TRUE);
+    }
+    else if ((ev->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+    {
+        vpath = vfs_path_from_str (dir_path);
+        tree_store_invalidate (vpath);
+        vfs_path_free (vpath, TRUE);
+    }
+}
+
+/* GLib 2.32-compatible replacement for g_hash_table_get_keys_as_ptr_array() */
+static GPtrArray *dirwatch_pending_names_array (GHashTable *set)
+{
+    GPtrArray *names;
+    GHashTableIter iter;
+    gpointer key;
+
+    names = g_ptr_array_new ();
+    g_hash_table_iter_init (&iter, set);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+        g_ptr_array_add (names, key);
+
+    return names;
+}
+
 static void dirwatch_reset_paths (void)
 {
     g_free (left_path);
@@ -150,6 +252,7 @@ static void dirwatch_update_watches (void)
                 wd_left = inotify_add_watch (inotify_fd, path, DW_MASK);
                 g_free (left_path);
                 left_path = g_strdup (path);
+                dirwatch_clear_pending_names (TRUE, FALSE);
             }
         }
         else if (wd_left >= 0)
@@ -158,6 +261,7 @@ static void dirwatch_update_watches (void)
             wd_left = -1;
             g_free (left_path);
             left_path = NULL;
+            dirwatch_clear_pending_names (TRUE, FALSE);
         }
     }
 
@@ -173,6 +277,7 @@ static void dirwatch_update_watches (void)
                 wd_right = inotify_add_watch (inotify_fd, path, DW_MASK);
                 g_free (right_path);
                 right_path = g_strdup (path);
+                dirwatch_clear_pending_names (FALSE, TRUE);
             }
         }
         else if (wd_right >= 0)
@@ -181,6 +286,7 @@ static void dirwatch_update_watches (void)
             wd_right = -1;
             g_free (right_path);
             right_path = NULL;
+            dirwatch_clear_pending_names (FALSE, TRUE);
         }
     }
 }
@@ -208,9 +314,19 @@ static int dirwatch_callback (int fd, void *info)
              * on the same inotify fd. Check both independently so both
              * panels can be marked for reload when wd_left == wd_right. */
             if (ev->wd == wd_left)
+            {
                 need_left = TRUE;
+                dirwatch_add_pending_name (TRUE, ev);
+                dirwatch_update_tree_store (left_path, ev);
+            }
             if (ev->wd == wd_right)
+            {
                 need_right = TRUE;
+                dirwatch_add_pending_name (FALSE, ev);
+                // both watches on the same path: the first update already did it
+                if (wd_right != wd_left)
+                    dirwatch_update_tree_store (right_path, ev);
+            }
             ptr += sizeof (struct inotify_event) + ev->len;
         }
     }
@@ -237,12 +353,43 @@ dirwatch_apply_pending (void)
     pending_left = pending_right = FALSE;
 
     if (do_left && left_panel != NULL)
-        panel_reload (left_panel, TRUE);
+    {
+        (void) mc_chdir (left_panel->cwd_vpath);
+        if (!full_left && names_left != NULL && g_hash_table_size (names_left) > 0)
+        {
+            /* O(changes): refresh only the entries named in the events */
+            GPtrArray *names;
+
+            names = dirwatch_pending_names_array (names_left);
+            panel_reload_names (left_panel, names);
+            g_ptr_array_free (names, TRUE);
+        }
+        else
+            panel_reload (left_panel, TRUE);
+    }
     if (do_right && right_panel != NULL)
-        panel_reload (right_panel, TRUE);
+    {
+        (void) mc_chdir (right_panel->cwd_vpath);
+        if (!full_right && names_right != NULL && g_hash_table_size (names_right) > 0)
+        {
+            GPtrArray *names;
+
+            names = dirwatch_pending_names_array (names_right);
+            panel_reload_names (right_panel, names);
+            g_ptr_array_free (names, TRUE);
+        }
+        else
+            panel_reload (right_panel, TRUE);
+    }
+
+    dirwatch_clear_pending_names (do_left, do_right);
 
     if (do_left || do_right)
+    {
+        if (current_panel != NULL)
+            (void) mc_chdir (current_panel->cwd_vpath);
         repaint_screen ();
+    }
 
     /* disarm until new events arrive */
     dirwatch_disarm_timer ();
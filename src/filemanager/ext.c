@@ -74,12 +74,51 @@
 #else
 #define FILE_CMD "file -z " FILE_S FILE_L
 #endif
+
+#define FILE_TYPE_CACHE_SIZE 64
 #endif
 
 /*** file scope type declarations ****************************************************************/
 
 typedef char *(*quote_func_t) (const char *name, gboolean quote_percent);
 
+/* A single [group] of the bindings file with its match conditions compiled.
+ * The conditions are compiled once and reused for every file: re-reading the
+ * key file and re-compiling the patterns on each invocation is what made
+ * opening files in big panels slow. */
+typedef struct
+{
+    const gchar *group;  // group name; owned by ext_ini_groups
+
+    /* The "Directory" parameter is a special case: if it's present then
+       "Type", "Regex", and "Shell" parameters are ignored */
+    gboolean has_directory;
+    mc_search_t *directory;  // compiled "Directory" regex (full path), may be NULL
+
+#ifdef USE_FILE_CMD
+    gboolean has_type;
+    mc_search_t *type;  // compiled "Type" regex ("file" output), may be NULL
+#endif
+
+    gboolean has_regex;
+    mc_search_t *regex;  // compiled "Regex" (base name), may be NULL
+
+    gchar *shell;  // "Shell" pattern (suffix or whole base name), or NULL
+    size_t shell_len;
+    gboolean shell_ignore_case;
+} ext_rule_t;
+
+#ifdef USE_FILE_CMD
+/* Cached result of the "file" (and "enca") commands for one file */
+typedef struct
+{
+    time_t mtime;
+    off_t size;
+    int codepage;   // codepage detected by "enca", or -1
+    char *content;  // first line of the "file" output, past the file name
+} file_type_cache_entry_t;
+#endif
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -90,6 +129,10 @@ typedef char *(*quote_func_t) (const char *name, gboolean quote_percent);
  */
 static mc_config_t *ext_ini = NULL;
 static gchar **ext_ini_groups = NULL;
+static GPtrArray *ext_rules = NULL;  // ext_rule_t, in the order of ext_ini_groups
+#ifdef USE_FILE_CMD
+static GHashTable *file_type_cache = NULL;  // path -> file_type_cache_entry_t
+#endif
 static vfs_path_t *localfilecopy_vpath = NULL;
 static char buffer[BUF_1K];
 
@@ -637,17 +680,33 @@ get_file_encoding_local (const vfs_path_t *filename_vpath, char *buf, int buflen
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+file_type_cache_entry_free (gpointer data)
+{
+    file_type_cache_entry_t *entry = (file_type_cache_entry_t *) data;
+
+    g_free (entry->content);
+    g_free (entry);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
- * Invoke the "file" command on the file and match its output against PTR.
- * have_type is a flag that is set if we already have tried to determine
- * the type of that file.
+ * Invoke the "file" command on the file and match its output against the
+ * compiled "Type" regex. have_type is a flag that is set if we already have
+ * tried to determine the type of that file.
+ *
+ * The "file" (and "enca") results are remembered across calls keyed by path
+ * and validated by (mtime, size), so a repeated Enter on the same file does
+ * not fork the subprocesses again.
+ *
  * Return TRUE for match, FALSE otherwise.
  */
 
 static gboolean
-regex_check_type (const vfs_path_t *filename_vpath, const char *ptr, gboolean case_insense,
-                  gboolean *have_type, GError **mcerror)
+regex_check_type (const vfs_path_t *filename_vpath, mc_search_t *search, gboolean *have_type,
+                  GError **mcerror)
 {
     gboolean found = FALSE;
 
@@ -660,82 +719,124 @@ regex_check_type (const vfs_path_t *filename_vpath, const char *ptr, gboolean ca
 
     if (!*have_type)
     {
-        vfs_path_t *localfile_vpath;
-
-        static char encoding_id[21];  // CSISO51INISCYRILLIC -- 20
-        int got_encoding_data;
+        const char *path_str = vfs_path_as_str (filename_vpath);
+        file_type_cache_entry_t *entry = NULL;
+        struct stat st;
+        gboolean stat_ok;
 
         // Don't repeate even unsuccessful checks
         *have_type = TRUE;
 
-        localfile_vpath = mc_getlocalcopy (filename_vpath);
-        if (localfile_vpath == NULL)
+        if (file_type_cache == NULL)
+            file_type_cache =
+                g_hash_table_new_full (g_str_hash, g_str_equal, g_free, file_type_cache_entry_free);
+
+        stat_ok = mc_stat (filename_vpath, &st) == 0;
+        if (stat_ok)
+            entry = g_hash_table_lookup (file_type_cache, path_str);
+
+        if (entry != NULL && entry->mtime == st.st_mtime && entry->size == st.st_size)
         {
-            mc_propagate_error (mcerror, 0, _ ("Cannot fetch a local copy of %s"),
-                                vfs_path_as_str (filename_vpath));
-            return FALSE;
+            g_strlcpy (content_string, entry->content, sizeof (content_string));
+            content_shift = 0;
+            got_data = 1;
+
+            if (entry->codepage >= 0)
+                do_set_codepage (entry->codepage);
         }
+        else
+        {
+            vfs_path_t *localfile_vpath;
 
-        got_encoding_data = is_autodetect_codeset_enabled
-            ? get_file_encoding_local (localfile_vpath, encoding_id, sizeof (encoding_id))
-            : 0;
+            static char encoding_id[21];  // CSISO51INISCYRILLIC -- 20
+            int got_encoding_data;
+            int detected_codepage = -1;
 
-        if (got_encoding_data > 0)
-        {
-            char *pp;
-            int cp_id;
+            localfile_vpath = mc_getlocalcopy (filename_vpath);
+            if (localfile_vpath == NULL)
+            {
+                mc_propagate_error (mcerror, 0, _ ("Cannot fetch a local copy of %s"),
+                                    vfs_path_as_str (filename_vpath));
+                return FALSE;
+            }
 
-            pp = strchr (encoding_id, '\n');
-            if (pp != NULL)
-                *pp = '\0';
+            got_encoding_data = is_autodetect_codeset_enabled
+                ? get_file_encoding_local (localfile_vpath, encoding_id, sizeof (encoding_id))
+                : 0;
 
-            cp_id = get_codepage_index (encoding_id);
-            if (cp_id == -1)
-                cp_id = default_source_codepage;
+            if (got_encoding_data > 0)
+            {
+                char *pp;
+                int cp_id;
 
-            do_set_codepage (cp_id);
-        }
+                pp = strchr (encoding_id, '\n');
+                if (pp != NULL)
+                    *pp = '\0';
+
+                cp_id = get_codepage_index (encoding_id);
+                if (cp_id == -1)
+                    cp_id = default_source_codepage;
 
-        got_data = get_file_type_local (localfile_vpath, content_string, sizeof (content_string));
+                do_set_codepage (cp_id);
+                detected_codepage = cp_id;
+            }
 
-        mc_ungetlocalcopy (filename_vpath, localfile_vpath, FALSE);
+            got_data =
+                get_file_type_local (localfile_vpath, content_string, sizeof (content_string));
 
-        if (got_data > 0)
-        {
-            char *pp;
+            mc_ungetlocalcopy (filename_vpath, localfile_vpath, FALSE);
 
-            pp = strchr (content_string, '\n');
-            if (pp != NULL)
-                *pp = '\0';
+            if (got_data > 0)
+            {
+                char *pp;
+
+                pp = strchr (content_string, '\n');
+                if (pp != NULL)
+                    *pp = '\0';
 
 #ifndef FILE_B
-            {
-                const char *real_name;  // name used with "file"
-                size_t real_len;
+                {
+                    const char *real_name;  // name used with "file"
+                    size_t real_len;
+
+                    real_name = vfs_path_get_last_path_str (localfile_vpath);
+                    real_len = strlen (real_name);
 
-                real_name = vfs_path_get_last_path_str (localfile_vpath);
-                real_len = strlen (real_name);
+                    if (strncmp (content_string, real_name, real_len) == 0)
+                    {
+                        // Skip "real_name: "
+                        content_shift = real_len;
+
+                        // Solaris' file prints tab(s) after ':'
+                        if (content_string[content_shift] == ':')
+                            for (content_shift++; whitespace (content_string[content_shift]);
+                                 content_shift++)
+                                ;
+                    }
+                }
+#endif
 
-                if (strncmp (content_string, real_name, real_len) == 0)
+                if (stat_ok)
                 {
-                    // Skip "real_name: "
-                    content_shift = real_len;
-
-                    // Solaris' file prints tab(s) after ':'
-                    if (content_string[content_shift] == ':')
-                        for (content_shift++; whitespace (content_string[content_shift]);
-                             content_shift++)
-                            ;
+                    // keep the cache small: drop everything when it overflows
+                    if (g_hash_table_size (file_type_cache) >= FILE_TYPE_CACHE_SIZE)
+                        g_hash_table_remove_all (file_type_cache);
+
+                    entry = g_new (file_type_cache_entry_t, 1);
+                    entry->mtime = st.st_mtime;
+                    entry->size = st.st_size;
+                    entry->codepage = detected_codepage;
+                    entry->content = g_strdup (content_string + content_shift);
+                    g_hash_table_replace (file_type_cache, g_strdup (path_str), entry);
                 }
             }
-#endif
-        }
-        else
-        {
-            // No data
-            content_string[0] = '\0';
+            else
+            {
+                // No data
+                content_string[0] = '\0';
+            }
+            vfs_path_free (localfile_vpath, TRUE);
         }
-        vfs_path_free (localfile_vpath, TRUE);
     }
 
     if (got_data == -1)
@@ -746,21 +847,11 @@ regex_check_type (const vfs_path_t *filename_vpath, const char *ptr, gboolean ca
 
     if (content_string[0] != '\0')
     {
-        mc_search_t *search;
-
-        search = mc_search_new (ptr, NULL);
         if (search != NULL)
-        {
-            search->search_type = MC_SEARCH_T_REGEX;
-            search->is_case_sensitive = !case_insense;
             found = mc_search_run (search, content_string + content_shift, 0,
                                    sizeof (content_string) - 1, NULL);
-            mc_search_free (search);
-        }
         else
-        {
             mc_propagate_error (mcerror, 0, "%s", _ ("Regular expression error"));
-        }
     }
 
     return found;
@@ -769,6 +860,114 @@ regex_check_type (const vfs_path_t *filename_vpath, const char *ptr, gboolean ca
 
 /* --------------------------------------------------------------------------------------------- */
 
+static mc_search_t *
+ext_rule_compile_regex (const char *pattern, gboolean ignore_case)
+{
+    mc_search_t *search;
+
+    search = mc_search_new (pattern, NULL);
+    if (search != NULL)
+    {
+        search->search_type = MC_SEARCH_T_REGEX;
+        search->is_case_sensitive = !ignore_case;
+    }
+
+    return search;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+ext_rule_free (gpointer data)
+{
+    ext_rule_t *rule = (ext_rule_t *) data;
+
+    if (rule->directory != NULL)
+        mc_search_free (rule->directory);
+#ifdef USE_FILE_CMD
+    if (rule->type != NULL)
+        mc_search_free (rule->type);
+#endif
+    if (rule->regex != NULL)
+        mc_search_free (rule->regex);
+    g_free (rule->shell);
+    g_free (rule);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Compile the match conditions of all groups of the bindings file into ext_rules */
+
+static void
+ext_rules_compile (void)
+{
+    char **group_iter;
+
+    if (ext_ini_groups == NULL)
+        ext_ini_groups = mc_config_get_groups (ext_ini, NULL);
+
+    ext_rules = g_ptr_array_new_with_free_func (ext_rule_free);
+
+    for (group_iter = ext_ini_groups; *group_iter != NULL; group_iter++)
+    {
+        const gchar *g = *group_iter;
+        ext_rule_t *rule;
+        gchar *pattern;
+        gboolean ignore_case;
+
+        if (strcmp (g, descr_group) == 0 || strncmp (g, "Include/", 8) == 0
+            || strcmp (g, default_group) == 0)
+            continue;
+
+        rule = g_new0 (ext_rule_t, 1);
+        rule->group = g;
+
+        /* The "Directory" parameter is a special case: if it's present then
+           "Type", "Regex", and "Shell" parameters are ignored */
+        pattern = mc_config_get_string_raw (ext_ini, g, "Directory", NULL);
+        if (pattern != NULL)
+        {
+            rule->has_directory = TRUE;
+            rule->directory = ext_rule_compile_regex (pattern, FALSE);
+            g_free (pattern);
+            g_ptr_array_add (ext_rules, rule);
+            continue;
+        }
+
+#ifdef USE_FILE_CMD
+        pattern = mc_config_get_string_raw (ext_ini, g, "Type", NULL);
+        if (pattern != NULL)
+        {
+            ignore_case = mc_config_get_bool (ext_ini, g, "TypeIgnoreCase", FALSE);
+            rule->has_type = TRUE;
+            rule->type = ext_rule_compile_regex (pattern, ignore_case);
+            g_free (pattern);
+        }
+#endif
+
+        pattern = mc_config_get_string_raw (ext_ini, g, "Regex", NULL);
+        if (pattern != NULL)
+        {
+            ignore_case = mc_config_get_bool (ext_ini, g, "RegexIgnoreCase", FALSE);
+            rule->has_regex = TRUE;
+            rule->regex = ext_rule_compile_regex (pattern, ignore_case);
+            g_free (pattern);
+        }
+        else
+        {
+            rule->shell = mc_config_get_string_raw (ext_ini, g, "Shell", NULL);
+            if (rule->shell != NULL)
+            {
+                rule->shell_len = strlen (rule->shell);
+                rule->shell_ignore_case = mc_config_get_bool (ext_ini, g, "ShellIgnoreCase", FALSE);
+            }
+        }
+
+        g_ptr_array_add (ext_rules, rule);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 check_old_extension_file (void)
 {
@@ -860,6 +1059,13 @@ load_extension_file (void)
 void
 flush_extension_file (void)
 {
+    // the rules point into ext_ini_groups, drop them first
+    if (ext_rules != NULL)
+    {
+        g_ptr_array_free (ext_rules, TRUE);
+        ext_rules = NULL;
+    }
+
     g_strfreev (ext_ini_groups);
     ext_ini_groups = NULL;
 
@@ -896,7 +1102,8 @@ regex_command_for (void *target, const vfs_path_t *filename_vpath, const char *a
 #ifdef USE_FILE_CMD
     gboolean have_type = FALSE;  // Flag used by regex_check_type()
 #endif
-    char **group_iter;
+    const ext_rule_t *rule = NULL;
+    size_t rule_i;
     char *include_group = NULL;
     const char *current_group;
 
@@ -922,11 +1129,11 @@ regex_command_for (void *target, const vfs_path_t *filename_vpath, const char *a
     filename = x_basename (filename);
     filename_len = strlen (filename);
 
-    if (ext_ini_groups == NULL)
-        ext_ini_groups = mc_config_get_groups (ext_ini, NULL);
+    if (ext_rules == NULL)
+        ext_rules_compile ();
 
     // find matched type, regex or shell pattern
-    for (group_iter = ext_ini_groups; *group_iter != NULL && !found; group_iter++)
+    for (rule_i = 0; rule_i < ext_rules->len && !found; rule_i++)
     {
         enum
         {
@@ -935,95 +1142,60 @@ regex_command_for (void *target, const vfs_path_t *filename_vpath, const char *a
             TYPE_FOUND
         } type_state = TYPE_UNUSED;
 
-        const gchar *g = *group_iter;
-        gchar *pattern;
-        gboolean ignore_case;
-
-        if (strcmp (g, descr_group) == 0 || strncmp (g, "Include/", 8) == 0
-            || strcmp (g, default_group) == 0)
-            continue;
+        rule = g_ptr_array_index (ext_rules, rule_i);
 
-        /* The "Directory" parameter is a special case: if it's present then
-           "Type", "Regex", and "Shell" parameters are ignored */
-        pattern = mc_config_get_string_raw (ext_ini, g, "Directory", NULL);
-        if (pattern != NULL)
+        if (rule->has_directory)
         {
-            found = S_ISDIR (mystat.st_mode)
-                && mc_search (pattern, NULL, vfs_path_as_str (filename_vpath), MC_SEARCH_T_REGEX);
-            g_free (pattern);
+            const char *path_str = vfs_path_as_str (filename_vpath);
+
+            found = S_ISDIR (mystat.st_mode) && rule->directory != NULL
+                && mc_search_run (rule->directory, path_str, 0, strlen (path_str), NULL);
 
             continue;  // stop if found
         }
 
 #ifdef USE_FILE_CMD
-        if (use_file_to_check_type)
+        if (use_file_to_check_type && rule->has_type)
         {
-            pattern = mc_config_get_string_raw (ext_ini, g, "Type", NULL);
-            if (pattern != NULL)
-            {
-                GError *mcerror = NULL;
+            GError *mcerror = NULL;
 
-                ignore_case = mc_config_get_bool (ext_ini, g, "TypeIgnoreCase", FALSE);
-                type_state =
-                    regex_check_type (filename_vpath, pattern, ignore_case, &have_type, &mcerror)
-                    ? TYPE_FOUND
-                    : TYPE_NOT_FOUND;
-                g_free (pattern);
+            type_state = regex_check_type (filename_vpath, rule->type, &have_type, &mcerror)
+                ? TYPE_FOUND
+                : TYPE_NOT_FOUND;
 
-                if (mc_error_message (&mcerror, NULL))
-                    error_flag = TRUE;  // leave it if file cannot be opened
+            if (mc_error_message (&mcerror, NULL))
+                error_flag = TRUE;  // leave it if file cannot be opened
 
-                if (type_state == TYPE_NOT_FOUND)
-                    continue;
-            }
+            if (type_state == TYPE_NOT_FOUND)
+                continue;
         }
 #endif
 
-        pattern = mc_config_get_string_raw (ext_ini, g, "Regex", NULL);
-        if (pattern != NULL)
+        if (rule->has_regex)
         {
-            mc_search_t *search;
-
-            ignore_case = mc_config_get_bool (ext_ini, g, "RegexIgnoreCase", FALSE);
-            search = mc_search_new (pattern, NULL);
-            g_free (pattern);
-
-            if (search != NULL)
-            {
-                search->search_type = MC_SEARCH_T_REGEX;
-                search->is_case_sensitive = !ignore_case;
-                found = mc_search_run (search, filename, 0, filename_len, NULL);
-                mc_search_free (search);
-            }
+            if (rule->regex != NULL)
+                found = mc_search_run (rule->regex, filename, 0, filename_len, NULL);
 
             found = found && (type_state == TYPE_UNUSED || type_state == TYPE_FOUND);
         }
-        else
+        else if (rule->shell != NULL)
         {
-            pattern = mc_config_get_string_raw (ext_ini, g, "Shell", NULL);
-            if (pattern != NULL)
-            {
-                int (*cmp_func) (const char *s1, const char *s2, size_t n);
-                size_t pattern_len;
-
-                ignore_case = mc_config_get_bool (ext_ini, g, "ShellIgnoreCase", FALSE);
-                cmp_func = ignore_case ? strncasecmp : strncmp;
-                pattern_len = strlen (pattern);
-
-                if (*pattern == '.' && filename_len >= pattern_len)
-                    found =
-                        cmp_func (pattern, filename + filename_len - pattern_len, pattern_len) == 0;
-                else
-                    found = pattern_len == filename_len
-                        && cmp_func (pattern, filename, filename_len) == 0;
+            int (*cmp_func) (const char *s1, const char *s2, size_t n);
+            size_t pattern_len = rule->shell_len;
 
-                g_free (pattern);
+            cmp_func = rule->shell_ignore_case ? strncasecmp : strncmp;
 
-                found = found && (type_state == TYPE_UNUSED || type_state == TYPE_FOUND);
-            }
+            if (rule->shell[0] == '.' && filename_len >= pattern_len)
+                found =
+                    cmp_func (rule->shell, filename + filename_len - pattern_len, pattern_len) == 0;
             else
-                found = type_state == TYPE_FOUND;
+                found =
+                    pattern_len == filename_len && cmp_func (rule->shell, filename, filename_len) == 0;
+
+            found = found && (type_state == TYPE_UNUSED || type_state == TYPE_FOUND);
         }
+        else
+            found = type_state == TYPE_FOUND;
     }
 
     // group is found, process actions
@@ -1031,10 +1203,8 @@ regex_command_for (void *target, const vfs_path_t *filename_vpath, const char *a
     {
         char *include_value;
 
-        group_iter--;
-
         // "Include" parameter has the highest priority over any actions
-        include_value = mc_config_get_string_raw (ext_ini, *group_iter, "Include", NULL);
+        include_value = mc_config_get_string_raw (ext_ini, rule->group, "Include", NULL);
         if (include_value != NULL)
         {
             // find "Include/include_value" group
@@ -1045,7 +1215,7 @@ regex_command_for (void *target, const vfs_path_t *filename_vpath, const char *a
     }
 
     if (found)
-        current_group = include_group != NULL ? include_group : *group_iter;
+        current_group = include_group != NULL ? include_group : rule->group;
     else
     {
         current_group = default_group;
@@ -52,7 +52,9 @@
 #include <config.h>
 
 #include <ctype.h>
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -61,10 +63,12 @@
 #include <unistd.h>
 
 #include "lib/global.h"
+#include "lib/mcconfig.h"  // mc_config_get_cache_path()
 #include "lib/tty/tty.h"
 #include "lib/tty/key.h"
 #include "lib/search.h"
 #include "lib/strutil.h"
+#include "lib/trace.h"
 #include "lib/util.h"
 #include "lib/vfs/vfs.h"
 #include "lib/vfs/utilvfs.h"
@@ -105,6 +109,24 @@ const char *op_names[3] = {
 #define FILEOP_UPDATE_INTERVAL_US   (FILEOP_UPDATE_INTERVAL * G_USEC_PER_SEC)
 #define FILEOP_STALLING_INTERVAL_US (FILEOP_STALLING_INTERVAL * G_USEC_PER_SEC)
 
+/* parallel copy of small local files in copy_dir_dir() */
+#define COPY_POOL_THREADS         4
+#define COPY_POOL_SMALL_FILE_SIZE (1 << 20)
+#define COPY_POOL_MAX_PENDING     (COPY_POOL_THREADS * 16)
+#define COPY_POOL_BUF_SIZE        (128 * 1024)
+
+/* parallel directory size computation on local file systems */
+#define DU_SCAN_MAX_THREADS 4
+
+/* resume journal for interrupted copy operations, kept in the cache directory */
+#define FILEOP_JOURNAL_FILE "mc.fileop.journal"
+
+/* adaptive copy buffer: double the block size after this many consecutive full
+   transfers, up to the cap; fast streams reach big blocks quickly while slow or
+   interactive streams keep the small probe size from io_blksize() */
+#define IO_BLK_GROW_AFTER 4
+#define IO_BLK_MAX        (16 * 1024 * 1024)
+
 /*** file scope type declarations ****************************************************************/
 
 /* This is a hard link cache */
@@ -128,6 +150,40 @@ typedef enum
     DEST_FULL           // Created, fully copied
 } dest_status_t;
 
+/* Shared state of a parallel directory size scan: a work queue of subdirectory
+   paths served by a few threads, all bookkeeping under one lock */
+typedef struct
+{
+    GQueue *dirs;          // char* paths waiting to be scanned
+    GMutex lock;
+    GCond cond;
+    int outstanding;       // paths queued plus paths being scanned right now
+    gboolean follow;       // follow symlinks when classifying entries
+    gboolean cancelled;    // set by the main thread on user request
+    size_t dir_count;
+    size_t marked;
+    uintmax_t total;
+} du_scan_t;
+
+/* A small local regular file handed over to the parallel copy pool */
+typedef struct
+{
+    char *src_path;  // plain local paths: workers bypass the VFS layer
+    char *dst_path;
+    struct stat src_stat;
+    gboolean preserve;        // snapshot of ctx->preserve at dispatch time
+    gboolean preserve_uidgid;  // snapshot of ctx->preserve_uidgid
+    mode_t umask_kill;        // snapshot of ctx->umask_kill
+    gboolean done;            // TRUE if the worker copied the file completely
+} copy_pool_job_t;
+
+/* A directory entry captured by the inode-order copy schedule in copy_dir_dir() */
+typedef struct
+{
+    char *name;      // entry name inside the directory being copied
+    struct stat st;  // stat taken during the prescan, reused by the copy loop
+} copy_sched_entry_t;
+
 /* Status of hard link creation */
 typedef enum
 {
@@ -176,10 +232,13 @@ static const char *prompt_parts[] = {
 
 /*** forward declarations (file scope functions) *************************************************/
 
+static void fileop_journal_record (const char *dst_path);
+
 /*** file scope variables ************************************************************************/
 
-/* the hard link cache */
-static GSList *linklist = NULL;
+/* the hard link cache: link_t entries hashed by (vfs, device, inode) so that trees
+   with very many hardlinks are looked up in constant time instead of a list scan */
+static GHashTable *hardlink_cache = NULL;
 
 /* the files-to-be-erased list */
 static GQueue *erase_list = NULL;
@@ -190,6 +249,17 @@ static GQueue *erase_list = NULL;
  */
 static GSList *dest_dirs = NULL;
 
+/* worker pool copying small local files while the main thread keeps walking the tree;
+   finished jobs come back through copy_pool_done */
+static GThreadPool *copy_pool = NULL;
+static GAsyncQueue *copy_pool_done = NULL;
+static int copy_pool_pending = 0;
+
+/* journal of the running copy operation, and the destinations a previous
+   interrupted run of the same operation already finished */
+static FILE *fileop_journal = NULL;
+static GHashTable *fileop_journal_done = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -330,6 +400,38 @@ free_linklist (GSList *lp)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static guint
+hardlink_hash (gconstpointer data)
+{
+    const link_t *lnk = (const link_t *) data;
+
+    return g_direct_hash (lnk->vfs) ^ (guint) lnk->ino ^ ((guint) lnk->dev << 16);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+hardlink_equal (gconstpointer a, gconstpointer b)
+{
+    const link_t *la = (const link_t *) a;
+    const link_t *lb = (const link_t *) b;
+
+    return la->vfs == lb->vfs && la->ino == lb->ino && la->dev == lb->dev;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline void *
+free_hardlink_cache (GHashTable *cache)
+{
+    if (cache != NULL)
+        g_hash_table_destroy (cache);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static const link_t *
 is_in_linklist (const GSList *lp, const vfs_path_t *vpath, const struct stat *sb)
 {
@@ -371,7 +473,18 @@ check_hardlinks (file_op_context_t *ctx, const vfs_path_t *src_vpath, const stru
     if ((vfs_file_class_flags (src_vpath) & VFSF_NOLINKS) != 0)
         return HARDLINK_UNSUPPORTED;
 
-    lnk = (link_t *) is_in_linklist (linklist, src_vpath, src_stat);
+    if (hardlink_cache != NULL)
+    {
+        link_t probe;
+
+        probe.vfs = vfs_path_get_last_path_vfs (src_vpath);
+        probe.dev = dev;
+        probe.ino = ino;
+        lnk = (link_t *) g_hash_table_lookup (hardlink_cache, &probe);
+    }
+    else
+        lnk = NULL;
+
     if (lnk != NULL)
     {
         int stat_result;
@@ -479,7 +592,11 @@ check_hardlinks (file_op_context_t *ctx, const vfs_path_t *src_vpath, const stru
         lnk->src_vpath = vfs_path_clone (src_vpath);
         lnk->dst_vpath = vfs_path_clone (dst_vpath);
 
-        linklist = g_slist_prepend (linklist, lnk);
+        if (hardlink_cache == NULL)
+            hardlink_cache = g_hash_table_new_full (hardlink_hash, hardlink_equal, NULL, free_link);
+
+        // the entry is its own key; the value destructor owns it
+        g_hash_table_insert (hardlink_cache, lnk, lnk);
     }
 
     return HARDLINK_CACHED;
@@ -615,6 +732,163 @@ ret:
     return return_status;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Size scan worker: take directories from the shared queue, sum up their entries with
+ * plain syscalls and queue the subdirectories back for whichever thread is free.
+ */
+
+static gpointer
+du_scan_thread (gpointer data)
+{
+    du_scan_t *du = (du_scan_t *) data;
+
+    while (TRUE)
+    {
+        char *path;
+        DIR *dir;
+        size_t marked = 0;
+        uintmax_t total = 0;
+        GSList *subdirs = NULL;
+
+        g_mutex_lock (&du->lock);
+        while (g_queue_is_empty (du->dirs) && du->outstanding > 0 && !du->cancelled)
+            g_cond_wait (&du->cond, &du->lock);
+        if (du->outstanding == 0 || du->cancelled)
+        {
+            g_mutex_unlock (&du->lock);
+            return NULL;
+        }
+        path = (char *) g_queue_pop_head (du->dirs);
+        du->dir_count++;
+        g_mutex_unlock (&du->lock);
+
+        dir = opendir (path);
+        if (dir != NULL)
+        {
+            const int dfd = dirfd (dir);
+            struct dirent *d;
+
+            while ((d = readdir (dir)) != NULL)
+            {
+                struct stat st;
+
+                if (DIR_IS_DOT (d->d_name) || DIR_IS_DOTDOT (d->d_name))
+                    continue;
+
+                if (fstatat (dfd, d->d_name, &st, du->follow ? 0 : AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+
+                if (S_ISDIR (st.st_mode))
+                    subdirs = g_slist_prepend (
+                        subdirs, g_build_filename (path, d->d_name, (char *) NULL));
+                else
+                {
+                    marked++;
+                    total += (uintmax_t) st.st_size;
+                }
+            }
+            closedir (dir);
+        }
+
+        g_mutex_lock (&du->lock);
+        du->marked += marked;
+        du->total += total;
+        for (; subdirs != NULL; subdirs = g_slist_delete_link (subdirs, subdirs))
+        {
+            g_queue_push_tail (du->dirs, subdirs->data);
+            du->outstanding++;
+        }
+        du->outstanding--;
+        g_cond_broadcast (&du->cond);
+        g_mutex_unlock (&du->lock);
+
+        g_free (path);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Multi-threaded variant of do_compute_dir_size() for local trees. The scan threads
+ * never touch the VFS or the UI; the calling thread keeps the status dialog alive
+ * and watches for the abort and skip buttons.
+ */
+
+static FileProgressStatus
+do_compute_dir_size_parallel (const vfs_path_t *dirname_vpath, dirsize_status_msg_t *dsm,
+                              size_t *dir_count, size_t *ret_marked, uintmax_t *ret_total,
+                              gboolean follow_symlinks)
+{
+    status_msg_t *sm = STATUS_MSG (dsm);
+    du_scan_t du;
+    GThread *threads[DU_SCAN_MAX_THREADS];
+    size_t i, n_threads;
+    FileProgressStatus ret = FILE_CONT;
+
+    du.dirs = g_queue_new ();
+    g_mutex_init (&du.lock);
+    g_cond_init (&du.cond);
+    du.outstanding = 1;
+    du.follow = follow_symlinks;
+    du.cancelled = FALSE;
+    du.dir_count = 0;
+    du.marked = 0;
+    du.total = 0;
+
+    g_queue_push_tail (du.dirs, g_strdup (vfs_path_as_str (dirname_vpath)));
+
+    n_threads = MIN ((size_t) g_get_num_processors (), (size_t) DU_SCAN_MAX_THREADS);
+
+    for (i = 0; i < n_threads; i++)
+        threads[i] = g_thread_new ("du-scan", du_scan_thread, &du);
+
+    while (TRUE)
+    {
+        gboolean done;
+
+        g_mutex_lock (&du.lock);
+        done = (du.outstanding == 0);
+        dsm->dir_count = du.dir_count;
+        dsm->total_size = du.total;
+        g_mutex_unlock (&du.lock);
+
+        if (done)
+            break;
+
+        if (sm->update != NULL)
+        {
+            dsm->dirname_vpath = dirname_vpath;
+            ret = sm->update (sm);
+            dsm->dirname_vpath = NULL;
+
+            if (ret != FILE_CONT)
+            {
+                g_mutex_lock (&du.lock);
+                du.cancelled = TRUE;
+                g_cond_broadcast (&du.cond);
+                g_mutex_unlock (&du.lock);
+                break;
+            }
+        }
+
+        // refresh the dialog with the same cadence as the serial scan
+        g_usleep (G_USEC_PER_SEC / 25);
+    }
+
+    for (i = 0; i < n_threads; i++)
+        g_thread_join (threads[i]);
+
+    *dir_count += du.dir_count;
+    *ret_marked += du.marked;
+    *ret_total += du.total;
+
+    g_queue_free_full (du.dirs, g_free);
+    g_mutex_clear (&du.lock);
+    g_cond_clear (&du.cond);
+
+    return ret;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * do_compute_dir_size:
@@ -626,6 +900,11 @@ static FileProgressStatus
 do_compute_dir_size (const vfs_path_t *dirname_vpath, dirsize_status_msg_t *dsm, size_t *dir_count,
                      size_t *ret_marked, uintmax_t *ret_total, mc_stat_fn stat_func)
 {
+    // a local tree can be scanned by several threads using plain syscalls
+    if (vfs_file_is_local (dirname_vpath))
+        return do_compute_dir_size_parallel (dirname_vpath, dsm, dir_count, ret_marked, ret_total,
+                                             stat_func == mc_stat);
+
     static gint64 timestamp = 0;
     // update with 25 FPS rate
     static const gint64 delay = G_USEC_PER_SEC / 25;
@@ -833,6 +1112,325 @@ progress_update_one (gboolean success, file_op_context_t *ctx, off_t add)
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Pool worker: copy one small local file with plain syscalls.
+ *
+ * Workers must not touch the VFS layer or the UI -- neither is thread-safe. Any failure
+ * leaves job->done FALSE and the main thread replays the file through copy_file_file(),
+ * which owns all the error dialogs. O_EXCL makes an existing destination such a failure,
+ * so overwrite confirmation also stays on the main thread.
+ */
+
+static void
+copy_pool_worker (gpointer data, gpointer user_data)
+{
+    copy_pool_job_t *job = (copy_pool_job_t *) data;
+    int src_fd;
+
+    (void) user_data;
+
+    src_fd = open (job->src_path, O_RDONLY);
+    if (src_fd >= 0)
+    {
+        int dst_fd;
+
+        dst_fd = open (job->dst_path, O_WRONLY | O_CREAT | O_EXCL,
+                       job->preserve ? (job->src_stat.st_mode & 07777) : 0666);
+        if (dst_fd >= 0)
+        {
+            gboolean ok = TRUE;
+            char *buf;
+
+            buf = g_malloc (COPY_POOL_BUF_SIZE);
+
+            while (ok)
+            {
+                ssize_t n_read;
+
+                n_read = read (src_fd, buf, COPY_POOL_BUF_SIZE);
+                if (n_read == 0)
+                    break;
+                if (n_read < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    ok = FALSE;
+                    break;
+                }
+
+                for (const char *t = buf; n_read > 0;)
+                {
+                    ssize_t n_written;
+
+                    n_written = write (dst_fd, t, (size_t) n_read);
+                    if (n_written < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        ok = FALSE;
+                        break;
+                    }
+                    t += n_written;
+                    n_read -= n_written;
+                }
+            }
+
+            g_free (buf);
+
+            if (ok && job->preserve_uidgid)
+                ok = fchown (dst_fd, job->src_stat.st_uid, job->src_stat.st_gid) == 0;
+            if (ok && job->preserve)
+                ok = fchmod (dst_fd, job->src_stat.st_mode & job->umask_kill) == 0;
+            if (close (dst_fd) != 0)
+                ok = FALSE;
+
+            if (!ok)
+                unlink (job->dst_path);
+            else
+            {
+                mc_timesbuf_t times;
+
+                vfs_get_timesbuf_from_stat (&job->src_stat, &times);
+                (void) vfs_utime (job->dst_path, &times);
+                job->done = TRUE;
+            }
+        }
+        close (src_fd);
+    }
+
+    g_async_queue_push (copy_pool_done, job);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Try to hand a file over to the copy pool.
+ *
+ * Only small local regular files qualify; anything that needs the hardlink cache,
+ * an overwrite dialog or the VFS goes through copy_file_file() as before. When the
+ * pool is saturated the caller copies synchronously, which throttles the walk.
+ *
+ * @return TRUE if the file was dispatched
+ */
+
+static gboolean
+copy_pool_dispatch (file_op_context_t *ctx, const char *src_path, const char *dst_path,
+                    const struct stat *src_stat)
+{
+    copy_pool_job_t *job;
+
+#ifdef ENABLE_BACKGROUND
+    /* A background operation runs in a fork()ed child: worker threads do not survive
+       the fork, so an inherited pool would queue jobs nobody serves. The child copies
+       serially, as it always has. */
+    if (mc_global.we_are_background)
+        return FALSE;
+#endif
+
+    if (!S_ISREG (src_stat->st_mode) || src_stat->st_size > COPY_POOL_SMALL_FILE_SIZE)
+        return FALSE;
+
+    // hard-linked files must go through the hardlink cache in copy_file_file()
+    if (ctx->preserve && src_stat->st_nlink > 1)
+        return FALSE;
+
+    if (copy_pool_pending >= COPY_POOL_MAX_PENDING)
+        return FALSE;
+
+    if (copy_pool == NULL)
+    {
+        copy_pool = g_thread_pool_new (copy_pool_worker, NULL, COPY_POOL_THREADS, FALSE, NULL);
+        if (copy_pool == NULL)
+            return FALSE;
+
+        copy_pool_done = g_async_queue_new ();
+    }
+
+    job = g_new0 (copy_pool_job_t, 1);
+    job->src_path = g_strdup (src_path);
+    job->dst_path = g_strdup (dst_path);
+    job->src_stat = *src_stat;
+    job->preserve = ctx->preserve;
+    job->preserve_uidgid = ctx->preserve_uidgid;
+    job->umask_kill = ctx->umask_kill;
+
+    g_thread_pool_push (copy_pool, job, NULL);
+    copy_pool_pending++;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Account finished pool jobs and replay the failed ones.
+ *
+ * @param ctx file operation context
+ * @param wait_all if TRUE, block until every outstanding job has come back
+ *
+ * @return FILE_CONT on success, the worst replay status otherwise
+ */
+
+static FileProgressStatus
+copy_pool_collect (file_op_context_t *ctx, gboolean wait_all)
+{
+    FileProgressStatus return_status = FILE_CONT;
+
+    while (copy_pool_pending > 0)
+    {
+        copy_pool_job_t *job;
+
+        if (wait_all)
+            job = g_async_queue_pop (copy_pool_done);
+        else
+        {
+            job = g_async_queue_try_pop (copy_pool_done);
+            if (job == NULL)
+                break;
+        }
+
+        copy_pool_pending--;
+
+        if (job->done)
+        {
+            fileop_journal_record (job->dst_path);
+            progress_update_one (TRUE, ctx, job->src_stat.st_size);
+        }
+        else if (return_status != FILE_ABORT)
+        {
+            // the worker could not handle it cleanly: redo it with full error handling
+            FileProgressStatus status;
+
+            status = copy_file_file (ctx, job->src_path, job->dst_path);
+            if (status != FILE_CONT)
+                return_status = status;
+        }
+
+        g_free (job->src_path);
+        g_free (job->dst_path);
+        g_free (job);
+    }
+
+    if (return_status == FILE_CONT)
+        return_status = file_progress_check_buttons (ctx);
+
+    return return_status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Open the resume journal for a copy operation.
+ *
+ * The first line identifies the operation by source and destination. If the cache
+ * still holds a journal with the same header, a previous run of this very operation
+ * was interrupted: its completed destinations are loaded so the copy can skip them,
+ * and new completions are appended. Otherwise the journal is started afresh.
+ *
+ * @param src_id source side of the operation (file or panel directory)
+ * @param dst_id destination as entered by the user
+ */
+
+static void
+fileop_journal_start (const char *src_id, const char *dst_id)
+{
+    char *path, *header;
+    FILE *old;
+
+    path = g_build_filename (mc_config_get_cache_path (), FILEOP_JOURNAL_FILE, (char *) NULL);
+    header = g_strdup_printf ("op %s -> %s\n", src_id, dst_id);
+
+    old = fopen (path, "r");
+    if (old != NULL)
+    {
+        char line[MC_MAXPATHLEN + 16];
+
+        if (fgets (line, sizeof (line), old) != NULL && strcmp (line, header) == 0)
+        {
+            fileop_journal_done = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+            while (fgets (line, sizeof (line), old) != NULL)
+            {
+                size_t len;
+
+                len = strlen (line);
+                if (len > 6 && strncmp (line, "done ", 5) == 0 && line[len - 1] == '\n')
+                {
+                    line[len - 1] = '\0';
+                    g_hash_table_add (fileop_journal_done, g_strdup (line + 5));
+                }
+            }
+        }
+        fclose (old);
+    }
+
+    fileop_journal = fopen (path, fileop_journal_done != NULL ? "a" : "w");
+    if (fileop_journal != NULL && fileop_journal_done == NULL)
+    {
+        fputs (header, fileop_journal);
+        fflush (fileop_journal);
+    }
+
+    g_free (header);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Whether a previous interrupted run already copied this destination completely.
+ */
+
+static gboolean
+fileop_journal_is_done (const char *dst_path)
+{
+    return fileop_journal_done != NULL && g_hash_table_contains (fileop_journal_done, dst_path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Append a completed destination to the journal.
+ */
+
+static void
+fileop_journal_record (const char *dst_path)
+{
+    if (fileop_journal != NULL)
+    {
+        fprintf (fileop_journal, "done %s\n", dst_path);
+        fflush (fileop_journal);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Close the journal; a journal of an operation that ran to its end is removed,
+ * one of an aborted operation stays for the next attempt.
+ */
+
+static void
+fileop_journal_finish (gboolean completed)
+{
+    if (fileop_journal != NULL)
+    {
+        fclose (fileop_journal);
+        fileop_journal = NULL;
+
+        if (completed)
+        {
+            char *path;
+
+            path = g_build_filename (mc_config_get_cache_path (), FILEOP_JOURNAL_FILE,
+                                     (char *) NULL);
+            unlink (path);
+            g_free (path);
+        }
+    }
+
+    if (fileop_journal_done != NULL)
+    {
+        g_hash_table_destroy (fileop_journal_done);
+        fileop_journal_done = NULL;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static FileProgressStatus
@@ -1201,6 +1799,37 @@ try_remove_file (file_op_context_t *ctx, const vfs_path_t *vpath, FileProgressSt
 
 /* {{{ Move routines */
 
+/**
+ * Check whether two local paths live on the same underlying file system, e.g. one
+ * volume exposed through different bind mounts. rename() still fails with EXDEV
+ * then, but the in-kernel clone/copy paths apply, which makes the copy+delete
+ * fallback cheap.
+ *
+ * @param src_vpath existing source
+ * @param dst_vpath destination (judged by its parent directory)
+ *
+ * @return TRUE if both sides are backed by the same device
+ */
+static gboolean
+same_file_system (const vfs_path_t *src_vpath, const vfs_path_t *dst_vpath)
+{
+    struct stat src_st, dst_st;
+    char *dst_dir;
+    gboolean ret;
+
+    if (!vfs_file_is_local (src_vpath) || !vfs_file_is_local (dst_vpath))
+        return FALSE;
+
+    // the destination usually does not exist yet: judge by its parent directory
+    dst_dir = g_path_get_dirname (vfs_path_as_str (dst_vpath));
+    ret = stat (vfs_path_as_str (src_vpath), &src_st) == 0 && stat (dst_dir, &dst_st) == 0
+        && src_st.st_dev == dst_st.st_dev;
+    g_free (dst_dir);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
 /**
  * Move single file or one of many files from one location to another.
  *
@@ -1211,6 +1840,7 @@ try_remove_file (file_op_context_t *ctx, const vfs_path_t *vpath, FileProgressSt
  *
  * @return operation result
  */
+
 static FileProgressStatus
 move_file_file (const WPanel *panel, file_op_context_t *ctx, const char *s, const char *d)
 {
@@ -1219,6 +1849,10 @@ move_file_file (const WPanel *panel, file_op_context_t *ctx, const char *s, cons
     gboolean copy_done = FALSE;
     gboolean old_ask_overwrite;
     vfs_path_t *src_vpath, *dst_vpath;
+    // take the hint right away so an early return cannot leak it onto another file
+    const gboolean src_stat_hinted = ctx->src_stat_hint_set;
+
+    ctx->src_stat_hint_set = FALSE;
 
     src_vpath = vfs_path_from_str (s);
     dst_vpath = vfs_path_from_str (d);
@@ -1235,21 +1869,25 @@ move_file_file (const WPanel *panel, file_op_context_t *ctx, const char *s, cons
 
     mc_refresh ();
 
-    while (mc_lstat (src_vpath, &src_stat) != 0)
-    {
-        // Source doesn't exist
-        if (ctx->ignore_all)
-            return_status = FILE_IGNORE_ALL;
-        else
+    if (src_stat_hinted)
+        // the caller holds a fresh lstat: skip one round trip to the source
+        src_stat = ctx->src_stat_hint;
+    else
+        while (mc_lstat (src_vpath, &src_stat) != 0)
         {
-            return_status = file_error (ctx, TRUE, _ ("Cannot stat file\n%s"), s);
-            if (return_status == FILE_IGNORE_ALL)
-                ctx->ignore_all = TRUE;
-        }
+            // Source doesn't exist
+            if (ctx->ignore_all)
+                return_status = FILE_IGNORE_ALL;
+            else
+            {
+                return_status = file_error (ctx, TRUE, _ ("Cannot stat file\n%s"), s);
+                if (return_status == FILE_IGNORE_ALL)
+                    ctx->ignore_all = TRUE;
+            }
 
-        if (return_status != FILE_RETRY)
-            goto ret;
-    }
+            if (return_status != FILE_RETRY)
+                goto ret;
+        }
 
     if (mc_lstat (dst_vpath, &dst_stat) == 0)
     {
@@ -1333,6 +1971,13 @@ move_file_file (const WPanel *panel, file_op_context_t *ctx, const char *s, cons
 
     old_ask_overwrite = ctx->ask_overwrite;
     ctx->ask_overwrite = FALSE;
+    // src_stat is still current; for a non-link stat and lstat agree, so spare
+    // copy_file_file a second source stat
+    if (!S_ISLNK (src_stat.st_mode))
+    {
+        ctx->src_stat_hint = src_stat;
+        ctx->src_stat_hint_set = TRUE;
+    }
     return_status = copy_file_file (ctx, s, d);
     ctx->ask_overwrite = old_ask_overwrite;
     if (return_status != FILE_CONT)
@@ -1435,6 +2080,82 @@ try_erase_dir (file_op_context_t *ctx, const vfs_path_t *vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Depth-first removal of a local tree over directory fds: every unlinkat() names just
+ * one component, so the kernel does not re-resolve the path prefix for each entry.
+ *
+ * Progress is sampled through the already rate-limited deleting display, with the
+ * tree root as the shown name. Errors raise no dialogs here; any entry that cannot
+ * be removed clears *ok and the caller redoes the tree with the dialog-aware walk.
+ *
+ * @param ctx file operation context
+ * @param dfd directory fd, consumed by this function
+ * @param root_vpath tree root, for the progress display only
+ * @param ok cleared if some entry survived
+ *
+ * @return FILE_ABORT if the user gave up, FILE_CONT otherwise
+ */
+static FileProgressStatus
+erase_tree_local (file_op_context_t *ctx, int dfd, const vfs_path_t *root_vpath, gboolean *ok)
+{
+    DIR *dir;
+    struct dirent *d;
+    FileProgressStatus return_status = FILE_CONT;
+
+    dir = fdopendir (dfd);
+    if (dir == NULL)
+    {
+        close (dfd);
+        *ok = FALSE;
+        return FILE_CONT;
+    }
+
+    while (return_status != FILE_ABORT && (d = readdir (dir)) != NULL)
+    {
+        struct stat st;
+
+        if (DIR_IS_DOT (d->d_name) || DIR_IS_DOTDOT (d->d_name))
+            continue;
+
+        if (fstatat (dirfd (dir), d->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            *ok = FALSE;
+            continue;
+        }
+
+        if (S_ISDIR (st.st_mode))
+        {
+            int sub_fd;
+
+            sub_fd = openat (dirfd (dir), d->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+            if (sub_fd < 0)
+            {
+                *ok = FALSE;
+                continue;
+            }
+
+            return_status = erase_tree_local (ctx, sub_fd, root_vpath, ok);
+            if (return_status != FILE_ABORT && unlinkat (dirfd (dir), d->d_name, AT_REMOVEDIR) != 0)
+                *ok = FALSE;
+        }
+        else if (unlinkat (dirfd (dir), d->d_name, 0) != 0)
+            *ok = FALSE;
+        else if (file_progress_show_deleting (ctx, root_vpath, &ctx->total_progress_count))
+        {
+            file_progress_show_count (ctx);
+            if (file_progress_check_buttons (ctx) == FILE_ABORT)
+                return_status = FILE_ABORT;
+            else
+                mc_refresh ();
+        }
+    }
+
+    closedir (dir);
+    return return_status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /**
   Recursive removal of files
   abort -> cancel stack
@@ -1448,6 +2169,35 @@ recursive_erase (file_op_context_t *ctx, const vfs_path_t *vpath)
     DIR *reading;
     FileProgressStatus return_status = FILE_CONT;
 
+    // fast path for local trees: walk and unlink relative to directory fds
+    if (vfs_file_is_local (vpath))
+    {
+        int dfd;
+
+        dfd = open (vfs_path_as_str (vpath), O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+        if (dfd >= 0)
+        {
+            gboolean ok = TRUE;
+
+            return_status = erase_tree_local (ctx, dfd, vpath, &ok);
+            if (return_status == FILE_ABORT)
+                return return_status;
+
+            if (ok)
+            {
+                file_progress_show_deleting (ctx, vpath, NULL);
+                file_progress_show_count (ctx);
+                if (file_progress_check_buttons (ctx) == FILE_ABORT)
+                    return FILE_ABORT;
+
+                mc_refresh ();
+
+                return try_erase_dir (ctx, vpath);
+            }
+            // something was left behind: redo with the walk that can raise dialogs
+        }
+    }
+
     reading = mc_opendir (vpath);
     if (reading == NULL)
         return FILE_RETRY;
@@ -1723,9 +2473,13 @@ retry_rename:
     if (panel != NULL)
     {
         /* In case of single directory, calculate totals. In case of many directories,
-           totals are calculated already. */
-        return_status = panel_operate_init_totals (panel, src_vpath, &src_stat, ctx, TRUE,
-                                                   FILEGUI_DIALOG_MULTI_ITEM);
+           totals are calculated already. A mount boundary over the same device (bind
+           mounts) is served by in-kernel clones, so don't walk the tree for totals
+           that would take longer than the move itself. */
+        return_status =
+            panel_operate_init_totals (panel, src_vpath, &src_stat, ctx,
+                                       !same_file_system (src_vpath, dst_vpath),
+                                       FILEGUI_DIALOG_MULTI_ITEM);
         if (return_status != FILE_CONT)
             goto ret;
     }
@@ -2033,6 +2787,79 @@ do_confirm_erase (const WPanel *panel, const char *source, struct stat *src_stat
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Stat the destinations of all marked files before a copy/move starts and settle the
+ * overwrite policy in one consolidated dialog, so the transfer itself never stops on
+ * an overwrite query. Only top-level non-directories are checked: directory merges
+ * resolve their inner conflicts through the policy chosen here.
+ *
+ * @return FILE_CONT to proceed (with ctx->replace_policy set), FILE_ABORT to cancel
+ */
+
+static FileProgressStatus
+panel_operate_prescan_conflicts (const WPanel *panel, file_op_context_t *ctx, const char *dest)
+{
+    size_t conflicts = 0;
+    size_t checked = 0;
+    int i;
+    char fmd_buf[BUF_MEDIUM];
+
+    for (i = 0; i < panel->dir.len; i++)
+    {
+        const file_entry_t *fe = &panel->dir.list[i];
+        char *temp;
+        FileProgressStatus status;
+
+        if (fe->f.marked == 0 || S_ISDIR (fe->st.st_mode))
+            continue;
+
+        temp = build_dest (ctx, fe->fname->str, dest, &status);
+        if (temp != NULL)
+        {
+            vfs_path_t *dst_vpath;
+            struct stat dst_stat;
+
+            checked++;
+
+            dst_vpath = vfs_path_from_str (temp);
+            if (mc_stat (dst_vpath, &dst_stat) == 0 && !S_ISDIR (dst_stat.st_mode))
+                conflicts++;
+            vfs_path_free (dst_vpath, TRUE);
+            g_free (temp);
+        }
+    }
+
+    if (conflicts == 0)
+        return FILE_CONT;
+
+    g_snprintf (fmd_buf, sizeof (fmd_buf),
+                _ ("%zu of %zu files already exist in the target directory"), conflicts, checked);
+
+    switch (query_dialog (op_names[ctx->operation], fmd_buf, D_NORMAL, 5, _ ("&Overwrite all"),
+                          _ ("Overwrite o&lder"), _ ("&Skip existing"), _ ("&Ask each"),
+                          _ ("Abo&rt")))
+    {
+    case 0:
+        ctx->replace_policy = REPLACE_POLICY_OVERWRITE;
+        break;
+    case 1:
+        ctx->replace_policy = REPLACE_POLICY_OVERWRITE_OLDER;
+        break;
+    case 2:
+        ctx->replace_policy = REPLACE_POLICY_SKIP;
+        break;
+    case 3:
+        // keep asking on each conflict, as without the pre-scan
+        break;
+    default:
+        return FILE_ABORT;
+    }
+
+    return FILE_CONT;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static FileProgressStatus
 operate_single_file (const WPanel *panel, file_op_context_t *ctx, const char *src,
                      struct stat *src_stat, const char *dest, filegui_dialog_type_t dialog_type)
@@ -2099,7 +2926,12 @@ operate_single_file (const WPanel *panel, file_op_context_t *ctx, const char *sr
                     }
 
                     if (is_file)
+                    {
+                        // pass the stat along so copy_file_file() does not repeat it
+                        ctx->src_stat_hint = *src_stat;
+                        ctx->src_stat_hint_set = TRUE;
                         value = copy_file_file (ctx, src, dest);
+                    }
                     else
                         value = copy_dir_dir (ctx, src, dest, TRUE, FALSE, FALSE, NULL);
                 }
@@ -2136,7 +2968,7 @@ operate_single_file (const WPanel *panel, file_op_context_t *ctx, const char *sr
 
 static FileProgressStatus
 operate_one_file (const WPanel *panel, file_op_context_t *ctx, const char *src,
-                  struct stat *src_stat, const char *dest)
+                  struct stat *src_stat, const char *dest, gboolean src_stat_fresh)
 {
     FileProgressStatus value = FILE_CONT;
     vfs_path_t *src_vpath;
@@ -2170,12 +3002,19 @@ operate_one_file (const WPanel *panel, file_op_context_t *ctx, const char *src,
             switch (ctx->operation)
             {
             case OP_COPY:
-                // we use file_mask_op_follow_links only with OP_COPY
-                ctx->stat_func (src_vpath, src_stat);
+                /* we use file_mask_op_follow_links only with OP_COPY;
+                   the panel entry holds an lstat, which only disagrees with
+                   stat_func's answer for a symlink */
+                if (!src_stat_fresh || (ctx->stat_func != mc_lstat && S_ISLNK (src_stat->st_mode)))
+                    ctx->stat_func (src_vpath, src_stat);
                 is_file = !S_ISDIR (src_stat->st_mode);
 
                 if (is_file)
+                {
+                    ctx->src_stat_hint = *src_stat;
+                    ctx->src_stat_hint_set = TRUE;
                     value = copy_file_file (ctx, src, dest);
+                }
                 else
                     value = copy_dir_dir (ctx, src, dest, TRUE, FALSE, FALSE, NULL);
                 dest_dirs = free_linklist (dest_dirs);
@@ -2183,7 +3022,15 @@ operate_one_file (const WPanel *panel, file_op_context_t *ctx, const char *src,
 
             case OP_MOVE:
                 if (is_file)
+                {
+                    if (src_stat_fresh)
+                    {
+                        // the panel entry already holds the lstat move_file_file() wants
+                        ctx->src_stat_hint = *src_stat;
+                        ctx->src_stat_hint_set = TRUE;
+                    }
                     value = move_file_file (NULL, ctx, src, dest);
+                }
                 else
                     value = do_move_dir_dir (NULL, ctx, src, dest);
                 break;
@@ -2233,6 +3080,130 @@ attrs_ignore_error (const int e)
             || e == ELOOP || e == ENXIO);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Whether a buffer contains nothing but zero bytes. */
+
+static gboolean
+copy_buf_is_zero (const char *buf, size_t len)
+{
+    return len == 0 || (buf[0] == '\0' && memcmp (buf, buf + 1, len - 1) == 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Pace the transfer to ctx->bps_limit with a token bucket: tokens accrue at the
+ * limit rate up to one second's worth of burst, each chunk spends its size, and
+ * a deficit is slept off. The limit is re-read on every call, so changing it
+ * from the progress dialog takes effect mid-file.
+ */
+
+static void
+copy_throttle (file_op_context_t *ctx, size_t bytes)
+{
+    if (ctx->bps_limit <= 0)
+        return;
+
+    const gint64 now = g_get_monotonic_time ();
+
+    if (ctx->throttle_stamp == 0)
+        // first throttled chunk of the operation: start with a full bucket
+        ctx->throttle_tokens = (double) ctx->bps_limit;
+    else
+        ctx->throttle_tokens +=
+            (double) (now - ctx->throttle_stamp) * ctx->bps_limit / G_USEC_PER_SEC;
+
+    if (ctx->throttle_tokens > (double) ctx->bps_limit)
+        ctx->throttle_tokens = (double) ctx->bps_limit;
+
+    ctx->throttle_stamp = now;
+    ctx->throttle_tokens -= (double) bytes;
+
+    if (ctx->throttle_tokens < 0.0)
+        g_usleep ((gulong) (-ctx->throttle_tokens * G_USEC_PER_SEC / ctx->bps_limit));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+copy_sched_entry_free (gpointer data)
+{
+    copy_sched_entry_t *ce = (copy_sched_entry_t *) data;
+
+    g_free (ce->name);
+    g_free (ce);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Order directory entries by inode number. On local file systems that
+ * approximates the physical layout, so reading the files in this order turns
+ * random access into mostly sequential access on rotational storage.
+ */
+
+static gint
+copy_sched_entry_ino_cmp (gconstpointer a, gconstpointer b)
+{
+    const copy_sched_entry_t *ea = *(const copy_sched_entry_t *const *) a;
+    const copy_sched_entry_t *eb = *(const copy_sched_entry_t *const *) b;
+
+    if (ea->st.st_ino < eb->st.st_ino)
+        return -1;
+    return ea->st.st_ino > eb->st.st_ino ? 1 : 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read a freshly copied target back and compare its SHA-256 against the digest
+ * collected from the source blocks while they passed through the copy buffer.
+ *
+ * @param dst_vpath target file
+ * @param src_sum digest of the source; read out here, the caller still frees it
+ * @param bufsize read block size
+ *
+ * @return TRUE if the target content matches the source
+ */
+
+static gboolean
+copy_file_verify_checksum (const vfs_path_t *dst_vpath, GChecksum *src_sum, size_t bufsize)
+{
+    GChecksum *dst_sum;
+    char *buf;
+    int fd;
+    gboolean read_ok = TRUE;
+    gboolean match;
+
+    fd = mc_open (dst_vpath, O_RDONLY);
+    if (fd < 0)
+        return FALSE;
+
+    dst_sum = g_checksum_new (G_CHECKSUM_SHA256);
+    buf = g_malloc (bufsize);
+
+    while (TRUE)
+    {
+        const ssize_t n_read = mc_read (fd, buf, bufsize);
+
+        if (n_read == 0)
+            break;
+        if (n_read < 0)
+        {
+            read_ok = FALSE;
+            break;
+        }
+
+        g_checksum_update (dst_sum, (const guchar *) buf, (gssize) n_read);
+    }
+
+    mc_close (fd);
+    g_free (buf);
+
+    match = read_ok
+        && strcmp (g_checksum_get_string (src_sum), g_checksum_get_string (dst_sum)) == 0;
+    g_checksum_free (dst_sum);
+
+    return match;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -2292,12 +3263,19 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
     unsigned long attrs = 0;
     gboolean attrs_ok = copymove_persistent_ext2_attr;
     gboolean dst_exists = FALSE, appending = FALSE;
+    gboolean sparse_copy = FALSE;
     off_t file_size = -1;
     FileProgressStatus return_status, temp_status;
     dest_status_t dst_status = DEST_NONE;
     int open_flags;
     vfs_path_t *src_vpath = NULL, *dst_vpath = NULL;
     char *buf = NULL;
+    GChecksum *src_sum = NULL;
+    const gint64 trace_start = mc_trace_begin ();
+    // take the hint right away so an early return cannot leak it onto another file
+    const gboolean src_stat_hinted = ctx->src_stat_hint_set;
+
+    ctx->src_stat_hint_set = FALSE;
 
     /* Keep the non-default value applied in chain of calls:
        move_file_file() -> file_progress_real_query_replace()
@@ -2343,24 +3321,28 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
         break;
     }
 
-    while ((*ctx->stat_func) (src_vpath, &src_stat) != 0)
-    {
-        if (ctx->ignore_all)
-            return_status = FILE_IGNORE_ALL;
-        else
+    if (src_stat_hinted)
+        // the caller holds a fresh stat: skip one round trip to the source
+        src_stat = ctx->src_stat_hint;
+    else
+        while ((*ctx->stat_func) (src_vpath, &src_stat) != 0)
         {
-            return_status = file_error (ctx, TRUE, _ ("Cannot stat source file\n%s"), src_path);
-            if (return_status == FILE_IGNORE_ALL)
-                ctx->ignore_all = TRUE;
-        }
+            if (ctx->ignore_all)
+                return_status = FILE_IGNORE_ALL;
+            else
+            {
+                return_status = file_error (ctx, TRUE, _ ("Cannot stat source file\n%s"), src_path);
+                if (return_status == FILE_IGNORE_ALL)
+                    ctx->ignore_all = TRUE;
+            }
 
-        if (return_status != FILE_RETRY)
-        {
-            // unknown size
-            progress_update_one (FALSE, ctx, 0);
-            goto ret_fast;
+            if (return_status != FILE_RETRY)
+            {
+                // unknown size
+                progress_update_one (FALSE, ctx, 0);
+                goto ret_fast;
+            }
         }
-    }
 
     // After ctx->stat_func()
     src_mode = src_stat.st_mode;
@@ -2368,6 +3350,14 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
     src_gid = src_stat.st_gid;
     file_size = src_stat.st_size;
 
+    // a journalled restart: this file was fully copied before the interruption
+    if (dst_exists && fileop_journal_is_done (dst_path))
+    {
+        progress_update_one (TRUE, ctx, file_size);
+        return_status = FILE_CONT;
+        goto ret_fast;
+    }
+
     while (attrs_ok && mc_fgetflags (src_vpath, &attrs) != 0)
     {
         attrs_ok = FALSE;
@@ -2628,6 +3618,11 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
     appending = ctx->do_append;
     ctx->do_append = FALSE;
 
+    /* Holes can only be kept when the target is written from scratch through the
+       buffer: appending or regetting lands mid-file. A clone below shares the
+       source's extents anyway, holes included. */
+    sparse_copy = copymove_preserve_sparse && !appending && ctx->do_reget == 0;
+
     // Try clone the file first.
     if (vfs_clone_file (dest_desc, src_desc) == 0)
     {
@@ -2653,7 +3648,8 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
     }
 
     // try preallocate space; if fail, try copy anyway
-    while (mc_global.vfs.preallocate_space
+    // (not when keeping holes - preallocation would fill them back in)
+    while (mc_global.vfs.preallocate_space && !sparse_copy
            && vfs_preallocate (dest_desc, file_size, appending ? dst_stat.st_size : 0) != 0)
     {
         if (ctx->ignore_all)
@@ -2708,16 +3704,42 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
         gint64 tv_last_update = ctx->transfer_start;
         gint64 tv_last_input = 0;
         gboolean is_first_time = TRUE;
+        /* Prefer moving data inside the kernel; the first failure (remote VFS,
+           appending destination, old kernel, ...) drops to the read/write loop,
+           which picks up at the same file offsets. Sparse copying detects zero
+           runs in the buffer itself, so it starts there directly. */
+        gboolean use_copy_range = !appending && !sparse_copy;
+        gboolean dst_ends_in_hole = FALSE;
+
+        /* Verification hashes the source as it passes through the buffer, so the
+           in-kernel shortcut must stay off: it never surfaces the data here. */
+        if (copymove_verify_checksum && !appending && ctx->do_reget == 0)
+        {
+            src_sum = g_checksum_new (G_CHECKSUM_SHA256);
+            use_copy_range = FALSE;
+        }
+
+        size_t bufsize = io_blksize (dst_stat);
+        unsigned int full_transfers = 0;
 
-        const size_t bufsize = io_blksize (dst_stat);
         buf = g_malloc (bufsize);
 
         while (TRUE)
         {
             ssize_t n_read = -1;
+            gboolean in_kernel = FALSE;
+
+            if (use_copy_range)
+            {
+                n_read = vfs_copy_file_range (dest_desc, src_desc, bufsize);
+                if (n_read >= 0)
+                    in_kernel = TRUE;
+                else
+                    use_copy_range = FALSE;
+            }
 
             // src_read
-            if (mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
+            if (!in_kernel && mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
                 while ((n_read = mc_read (src_desc, buf, bufsize)) < 0 && !ctx->ignore_all)
                 {
                     return_status =
@@ -2732,19 +3754,43 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
             if (n_read == 0)
                 break;
 
+            if (n_read > 0)
+                copy_throttle (ctx, (size_t) n_read);
+
             const gint64 tv_current = g_get_monotonic_time ();
 
-            if (n_read > 0)
+            if (in_kernel && n_read > 0)
+            {
+                // the data went straight to the destination; only account it
+                file_part += n_read;
+                tv_last_input = tv_current;
+            }
+            else if (n_read > 0)
             {
                 ssize_t n_written;
                 char *t = buf;
+                gboolean is_hole = FALSE;
+
+                if (src_sum != NULL)
+                    g_checksum_update (src_sum, (const guchar *) buf, (gssize) n_read);
 
                 file_part += n_read;
 
                 tv_last_input = tv_current;
 
+                /* an all-zero chunk becomes a hole: seek over it instead of writing;
+                   a target that cannot seek gets plain writes from here on */
+                if (sparse_copy && copy_buf_is_zero (buf, (size_t) n_read))
+                {
+                    if (mc_lseek (dest_desc, (off_t) n_read, SEEK_CUR) >= 0)
+                        is_hole = TRUE;
+                    else
+                        sparse_copy = FALSE;
+                }
+                dst_ends_in_hole = is_hole;
+
                 // dst_write
-                while ((n_written = mc_write (dest_desc, t, (size_t) n_read)) < n_read)
+                while (!is_hole && (n_written = mc_write (dest_desc, t, (size_t) n_read)) < n_read)
                 {
                     gboolean write_errno_nospace;
 
@@ -2780,6 +3826,20 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
                 }
             }
 
+            // a stream that keeps the buffer full earns a bigger one
+            if (n_read > 0 && (size_t) n_read == bufsize && bufsize < IO_BLK_MAX)
+            {
+                full_transfers++;
+                if (full_transfers >= IO_BLK_GROW_AFTER)
+                {
+                    bufsize *= 2;
+                    buf = g_realloc (buf, bufsize);
+                    full_transfers = 0;
+                }
+            }
+            else
+                full_transfers = 0;
+
             ctx->progress_bytes = file_part + ctx->do_reget;
 
             const gint64 usecs = tv_current - tv_last_update;
@@ -2846,12 +3906,45 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
             }
         }
 
+        /* seeking alone leaves the file short when it ends in a hole: put the
+           final zero byte down for real to give the target its full size */
+        if (dst_ends_in_hole)
+            while (mc_lseek (dest_desc, (off_t) (file_part - 1), SEEK_SET) < 0
+                   || mc_write (dest_desc, "", 1) != 1)
+            {
+                if (ctx->ignore_all)
+                    return_status = FILE_IGNORE_ALL;
+                else
+                    return_status =
+                        file_error (ctx, TRUE, _ ("Cannot write target file\n%s"), dst_path);
+                if (return_status == FILE_IGNORE_ALL)
+                    ctx->ignore_all = TRUE;
+                if (return_status != FILE_RETRY)
+                    goto ret;
+            }
+
         // copy successful
         dst_status = DEST_FULL;
+
+        if (src_sum != NULL && !copy_file_verify_checksum (dst_vpath, src_sum, bufsize))
+        {
+            if (query_dialog (Q_ ("DialogTitle|Copy"),
+                              _ ("Checksum mismatch between source and target file"), D_ERROR, 2,
+                              _ ("&Delete"), _ ("&Keep"))
+                == 0)
+                dst_status = DEST_SHORT_DELETE;
+            else
+                dst_status = DEST_SHORT_KEEP;
+        }
     }
 
 ret:
     g_free (buf);
+    if (src_sum != NULL)
+    {
+        g_checksum_free (src_sum);
+        src_sum = NULL;
+    }
 
     rotate_dash (FALSE);
     while (src_desc != -1 && mc_close (src_desc) < 0 && !ctx->ignore_all)
@@ -2982,6 +4075,9 @@ ret:
     if (dst_status == DEST_FULL || dst_status == DEST_SHORT_KEEP)
         mc_utime (dst_vpath, &times);
 
+    if (dst_status == DEST_FULL && return_status == FILE_CONT)
+        fileop_journal_record (dst_path);
+
     progress_update_one (return_status == FILE_CONT, ctx, file_size);
     if (return_status == FILE_CONT)
         return_status = file_progress_check_buttons (ctx);
@@ -2989,6 +4085,7 @@ ret:
 ret_fast:
     vfs_path_free (src_vpath, TRUE);
     vfs_path_free (dst_vpath, TRUE);
+    mc_trace_end ("copy_file_file", trace_start, file_size < 0 ? 0 : (guint64) file_size);
     return return_status;
 }
 
@@ -3216,27 +4313,84 @@ retry_dst_stat:
     if (reading == NULL)
         goto ret;
 
-    while ((next = mc_readdir (reading)) && return_status != FILE_ABORT)
+    /* Plain copies between local file systems may fan small files out to the copy
+       pool; moves keep the strict copy-then-erase ordering of the serial path. */
+    const gboolean local_pair =
+        !do_delete && vfs_file_is_local (src_vpath) && vfs_file_is_local (dst_vpath);
+
+    GPtrArray *sched = NULL;
+    guint sched_i = 0;
+
+    /* Inode numbers only mean anything locally; the prescan pays one stat per
+       entry, which the loop below would have done anyway. */
+    if (copymove_inode_order && vfs_file_is_local (src_vpath))
+    {
+        sched = g_ptr_array_new_with_free_func (copy_sched_entry_free);
+
+        while ((next = mc_readdir (reading)) != NULL)
+            if (!DIR_IS_DOT (next->d_name) && !DIR_IS_DOTDOT (next->d_name))
+            {
+                copy_sched_entry_t *ce;
+                char *path;
+                vfs_path_t *tmp_vpath;
+
+                ce = g_new0 (copy_sched_entry_t, 1);
+                ce->name = g_strdup (next->d_name);
+
+                path = mc_build_filename (s, next->d_name, (char *) NULL);
+                tmp_vpath = vfs_path_from_str (path);
+                (*ctx->stat_func) (tmp_vpath, &ce->st);
+                vfs_path_free (tmp_vpath, TRUE);
+                g_free (path);
+
+                g_ptr_array_add (sched, ce);
+            }
+
+        g_ptr_array_sort (sched, copy_sched_entry_ino_cmp);
+    }
+
+    while (return_status != FILE_ABORT)
     {
+        const char *entry_name;
         char *path;
         vfs_path_t *tmp_vpath;
 
-        /*
-         * Now, we don't want '.' and '..' to be created / copied at any time
-         */
-        if (DIR_IS_DOT (next->d_name) || DIR_IS_DOTDOT (next->d_name))
-            continue;
+        if (sched != NULL)
+        {
+            if (sched_i == sched->len)
+                break;
+
+            const copy_sched_entry_t *ce = g_ptr_array_index (sched, sched_i++);
+
+            entry_name = ce->name;
+            dst_stat = ce->st;
+        }
+        else
+        {
+            next = mc_readdir (reading);
+            if (next == NULL)
+                break;
+
+            /*
+             * Now, we don't want '.' and '..' to be created / copied at any time
+             */
+            if (DIR_IS_DOT (next->d_name) || DIR_IS_DOTDOT (next->d_name))
+                continue;
+
+            entry_name = next->d_name;
+        }
 
         // get the filename and add it to the src directory
-        path = mc_build_filename (s, next->d_name, (char *) NULL);
+        path = mc_build_filename (s, entry_name, (char *) NULL);
         tmp_vpath = vfs_path_from_str (path);
 
-        (*ctx->stat_func) (tmp_vpath, &dst_stat);
+        if (sched == NULL)
+            (*ctx->stat_func) (tmp_vpath, &dst_stat);
         if (S_ISDIR (dst_stat.st_mode))
         {
             char *mdpath;
 
-            mdpath = mc_build_filename (d, next->d_name, (char *) NULL);
+            mdpath = mc_build_filename (d, entry_name, (char *) NULL);
             /*
              * From here, we just intend to recursively copy subdirs, not
              * the double functionality of copying different when the target
@@ -3251,7 +4405,13 @@ retry_dst_stat:
             char *dest_file;
 
             dest_file = mc_build_filename (d, x_basename (path), (char *) NULL);
-            return_status = copy_file_file (ctx, path, dest_file);
+            /* destinations finished by an interrupted run take the serial path,
+               which skips them after the journal check */
+            if (local_pair && !fileop_journal_is_done (dest_file)
+                && copy_pool_dispatch (ctx, path, dest_file, &dst_stat))
+                return_status = copy_pool_collect (ctx, FALSE);
+            else
+                return_status = copy_file_file (ctx, path, dest_file);
             g_free (dest_file);
         }
 
@@ -3277,8 +4437,19 @@ retry_dst_stat:
         }
         vfs_path_free (tmp_vpath, TRUE);
     }
+    if (sched != NULL)
+        g_ptr_array_free (sched, TRUE);
     mc_closedir (reading);
 
+    // settle outstanding pool jobs before stamping mode and times on the directory
+    if (copy_pool_pending > 0)
+    {
+        const FileProgressStatus pool_status = copy_pool_collect (ctx, TRUE);
+
+        if (return_status != FILE_ABORT)
+            return_status = pool_status;
+    }
+
     if (ctx->preserve)
     {
         mc_timesbuf_t times;
@@ -3456,7 +4627,7 @@ dirsize_status_deinit_cb (status_msg_t *sm)
 
     // schedule to update passive panel
     if (get_other_type () == view_listing)
-        other_panel->dirty = TRUE;
+        panel_set_dirty (other_panel);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -3502,14 +4673,14 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
     struct stat src_stat;
     gboolean ret_val = TRUE;
     int i;
-    FileProgressStatus value;
+    FileProgressStatus value = FILE_CONT;
     file_op_context_t *ctx;
     filegui_dialog_type_t dialog_type = FILEGUI_DIALOG_ONE_ITEM;
 
     gboolean do_bg = FALSE;  // do background operation?
     gboolean dirwatch_quiet = FALSE;  // did we silence dynamic list updates?
 
-    linklist = free_linklist (linklist);
+    hardlink_cache = free_hardlink_cache (hardlink_cache);
     dest_dirs = free_linklist (dest_dirs);
 
     save_cwds_stat ();
@@ -3542,6 +4713,18 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
         goto ret_fast;
     }
 
+    /* Optionally settle name conflicts in one dialog before the transfer starts.
+       This runs before the background fork so the chosen policy travels into
+       background jobs, which otherwise stall on their first overwrite query. */
+    if (file_op_prescan_conflicts && operation != OP_DELETE && !single_entry && confirm_overwrite
+        && ctx->ask_overwrite
+        && panel_operate_prescan_conflicts (panel, ctx, dest) == FILE_ABORT)
+    {
+        value = FILE_ABORT;
+        ret_val = FALSE;
+        goto clean_up;
+    }
+
     ctx->total_transfer_start = g_get_monotonic_time ();
 
 #ifdef ENABLE_BACKGROUND
@@ -3600,6 +4783,25 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
         && (mc_setctl (panel->cwd_vpath, VFS_SETCTL_STALE_DATA, GUINT_TO_POINTER (1)) != 0))
         save_cwd = vfs_path_clone (panel->cwd_vpath);
 
+    /* Keep a resume journal for copies: if this process dies mid-operation, the
+       next identical copy skips everything recorded as finished. This runs after
+       the background fork, so only the process doing the work journals. */
+    if (operation == OP_COPY && dest != NULL)
+    {
+        if (single_entry)
+        {
+            /* the journal id must name the source uniquely; the bare basename
+               would also match a same-named file copied from elsewhere */
+            vfs_path_t *src_vpath;
+
+            src_vpath = vfs_path_append_new (panel->cwd_vpath, source, (char *) NULL);
+            fileop_journal_start (vfs_path_as_str (src_vpath), dest);
+            vfs_path_free (src_vpath, TRUE);
+        }
+        else
+            fileop_journal_start (vfs_path_as_str (panel->cwd_vpath), dest);
+    }
+
     // Now, let's do the job
 
     // This code is only called by the tree and panel code
@@ -3656,6 +4858,15 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
         value =
             panel_operate_init_totals (panel, NULL, NULL, ctx, file_op_compute_totals, dialog_type);
         if (value == FILE_CONT)
+        {
+            gboolean src_stat_fresh;
+
+            /* One stat of the directory decides whether the panel's cached entry stats
+               can be reused for every marked file; re-statting each source costs
+               a round trip per file on a remote VFS. */
+            src_stat_fresh =
+                !panel->is_panelized && dir_list_is_fresh (&panel->dir, panel->cwd_vpath);
+
             // Loop for every file, perform the actual copy operation
             for (i = 0; i < panel->dir.len; i++)
             {
@@ -3667,7 +4878,7 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
                 source2 = panel->dir.list[i].fname->str;
                 src_stat = panel->dir.list[i].st;
 
-                value = operate_one_file (panel, ctx, source2, &src_stat, dest);
+                value = operate_one_file (panel, ctx, source2, &src_stat, dest, src_stat_fresh);
                 if (value == FILE_ABORT)
                     break;
 
@@ -3676,9 +4887,13 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
 
                 mc_refresh ();
             }  // Loop for every file
+        }
     }  // Many entries
 
 clean_up:
+    // An aborted operation keeps its journal around for the next attempt
+    fileop_journal_finish (value != FILE_ABORT);
+
     // Clean up
     if (save_cwd != NULL)
     {
@@ -3692,7 +4907,7 @@ clean_up:
         vfs_path_free (save_dest, TRUE);
     }
 
-    linklist = free_linklist (linklist);
+    hardlink_cache = free_hardlink_cache (hardlink_cache);
     dest_dirs = free_linklist (dest_dirs);
     g_free (dest);
     vfs_path_free (dest_vpath, TRUE);
@@ -163,6 +163,18 @@ gboolean classic_progressbar = TRUE;
 
 #define truncFileStringSecure(dlg, s) path_trunc (s, WIDGET (dlg)->rect.cols - 10)
 
+/* Destination filesystem probe: how long a result stays fresh, and how long a
+   first-time query waits for the probe before going optimistic */
+#define FS_PROBE_TTL                  (10 * G_USEC_PER_SEC)
+#define FS_PROBE_GRACE                (G_USEC_PER_SEC / 5)
+
+/* Live bandwidth limit ('-'/'+' in the progress dialog): the floor, the value a
+   first '-' falls back to when the current rate is unknown, and the point past
+   which '+' means unlimited again */
+#define BPS_LIMIT_MIN   (8 * 1024)
+#define BPS_LIMIT_START (1024 * 1024)
+#define BPS_LIMIT_MAX   (1024L * 1024 * 1024)
+
 /*** file scope type declarations ****************************************************************/
 
 typedef enum
@@ -191,6 +203,16 @@ typedef enum
     REPLACE_ABORT
 } replace_action_t;
 
+/* One probed destination filesystem (see filegui__fs_probe_thread) */
+typedef struct
+{
+    char *fs_path;
+    gboolean attrs_ok;     // the fs can hold permissions and timestamps
+    uintmax_t free_bytes;  // available bytes at probe time, 0 = unknown
+    gint64 timestamp;      // monotonic time the values were read, 0 = never
+    gboolean running;      // a probe thread is (re)filling this entry
+} fs_probe_t;
+
 // UI and internal data required by a file operation context.
 typedef struct
 {
@@ -242,6 +264,13 @@ static struct
     { NULL, FILE_ABORT, N_ ("&Abort"), NORMAL_BUTTON, -1 },
 };
 
+/* Destination filesystem probe state, all guarded by fs_probe_lock */
+static GMutex fs_probe_lock;
+static GCond fs_probe_cond;
+static GHashTable *fs_probe_cache = NULL;  // fs_path -> fs_probe_t, keyed by the entry's own path
+static char *fs_probe_dest = NULL;         // destination of the operation in progress
+static gboolean fs_probe_space_warned = FALSE;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -270,18 +299,24 @@ statvfs_works (void)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static gboolean
-filegui__check_attrs_on_fs (const char *fs_path)
+static int
+filegui__statfs (const char *fs_path, STRUCT_STATVFS *stfs)
 {
-    STRUCT_STATVFS stfs;
-
 #if defined(USE_STATVFS) && defined(STAT_STATVFS)
-    if (statvfs_works () && statvfs (fs_path, &stfs) != 0)
-        return TRUE;
-#else
-    if (STATFS (fs_path, &stfs) != 0)
-        return TRUE;
+    if (!statvfs_works ())
+        return -1;
 #endif
+    return STATFS (fs_path, stfs);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+filegui__fs_supports_attrs (const STRUCT_STATVFS *stfs_arg)
+{
+    const STRUCT_STATVFS stfs = *stfs_arg;
+
+    (void) stfs;
 
 #if (defined(USE_STATVFS) && defined(HAVE_STRUCT_STATVFS_F_TYPE))                                  \
     || (!defined(USE_STATVFS) && defined(HAVE_STRUCT_STATFS_F_TYPE))
@@ -319,6 +354,207 @@ filegui__check_attrs_on_fs (const char *fs_path)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static uintmax_t
+filegui__fs_free_bytes (const STRUCT_STATVFS *stfs)
+{
+#if defined(USE_STATVFS)
+    const uintmax_t frsize = (uintmax_t) (stfs->f_frsize != 0 ? stfs->f_frsize : stfs->f_bsize);
+
+    return (uintmax_t) stfs->f_bavail * frsize;
+#elif !defined(HAVE_OS_H)
+    return (uintmax_t) stfs->f_bavail * (uintmax_t) stfs->f_bsize;
+#else
+    (void) stfs;
+    return 0;  // unknown; the space check stays silent
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+fs_probe_free (gpointer data)
+{
+    fs_probe_t *probe = (fs_probe_t *) data;
+
+    g_free (probe->fs_path);
+    g_free (probe);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * The destination filesystem probe runs in a thread of its own: a statfs of an
+ * autofs or hard-mounted network path can block for seconds, and it used to do
+ * so on the UI thread before the copy dialog even appeared. Results are cached
+ * per path for the lifetime of the process and re-verified in the background
+ * whenever they are consulted past their TTL, so the dialogs always answer
+ * immediately from the last known state.
+ */
+
+static gpointer
+filegui__fs_probe_thread (gpointer data)
+{
+    char *fs_path = (char *) data;
+    STRUCT_STATVFS stfs;
+    gboolean statfs_ok;
+    fs_probe_t *probe;
+
+    statfs_ok = (filegui__statfs (fs_path, &stfs) == 0);
+
+    g_mutex_lock (&fs_probe_lock);
+
+    probe = (fs_probe_t *) g_hash_table_lookup (fs_probe_cache, fs_path);
+    if (probe != NULL)
+    {
+        // a failed statfs keeps the optimistic default, as the sync check did
+        probe->attrs_ok = !statfs_ok || filegui__fs_supports_attrs (&stfs);
+        probe->free_bytes = statfs_ok ? filegui__fs_free_bytes (&stfs) : 0;
+        probe->timestamp = g_get_monotonic_time ();
+        probe->running = FALSE;
+        g_cond_broadcast (&fs_probe_cond);
+    }
+
+    g_mutex_unlock (&fs_probe_lock);
+
+    g_free (fs_path);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Make sure a cache entry for @fs_path exists and is being (re)filled if missing
+ * or older than the TTL. Must be called with fs_probe_lock held.
+ *
+ * @return the (possibly still unfilled) cache entry
+ */
+
+static fs_probe_t *
+filegui__fs_probe_start (const char *fs_path)
+{
+    fs_probe_t *probe;
+
+    if (fs_probe_cache == NULL)
+        fs_probe_cache = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, fs_probe_free);
+
+    probe = (fs_probe_t *) g_hash_table_lookup (fs_probe_cache, fs_path);
+    if (probe == NULL)
+    {
+        probe = g_new0 (fs_probe_t, 1);
+        probe->fs_path = g_strdup (fs_path);
+        probe->attrs_ok = TRUE;  // optimistic until the first probe lands
+        g_hash_table_insert (fs_probe_cache, probe->fs_path, probe);
+    }
+
+    if (!probe->running
+        && (probe->timestamp == 0
+            || g_get_monotonic_time () - probe->timestamp >= FS_PROBE_TTL))
+    {
+        GThread *th;
+
+        th = g_thread_try_new ("fs-probe", filegui__fs_probe_thread, g_strdup (fs_path), NULL);
+        if (th != NULL)
+        {
+            probe->running = TRUE;
+            g_thread_unref (th);
+        }
+    }
+
+    return probe;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Whether the filesystem holding @fs_path supports attributes, answered from the
+ * probe cache. A path seen for the first time gets a short grace period for the
+ * probe to land; after that the answer is the optimistic default and the probe
+ * keeps running in the background.
+ */
+
+static gboolean
+filegui__check_attrs_on_fs (const char *fs_path)
+{
+    gboolean ret = TRUE;
+    fs_probe_t *probe;
+
+    g_mutex_lock (&fs_probe_lock);
+
+    probe = filegui__fs_probe_start (fs_path);
+    if (probe->timestamp == 0 && probe->running)
+    {
+        const gint64 deadline = g_get_monotonic_time () + FS_PROBE_GRACE;
+
+        while (probe->timestamp == 0 && probe->running)
+            if (!g_cond_wait_until (&fs_probe_cond, &fs_probe_lock, deadline))
+                break;
+    }
+
+    if (probe->timestamp != 0)
+        ret = probe->attrs_ok;
+
+    g_mutex_unlock (&fs_probe_lock);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Remember the destination of the operation being set up and kick off a fresh
+ * space probe for it; file_progress_check_buttons() consults the result while
+ * the transfer is already running.
+ */
+
+static void
+filegui__track_dest_space (const char *dest)
+{
+    g_mutex_lock (&fs_probe_lock);
+
+    g_free (fs_probe_dest);
+    fs_probe_dest = g_strdup (dest);
+    fs_probe_space_warned = FALSE;
+    filegui__fs_probe_start (dest);
+
+    g_mutex_unlock (&fs_probe_lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * TRUE once per operation when the async probe of the destination reports less
+ * free space than the bytes still to be transferred.
+ */
+
+static gboolean
+filegui__dest_space_short (const file_op_context_t *ctx)
+{
+    gboolean ret = FALSE;
+
+    g_mutex_lock (&fs_probe_lock);
+
+    if (!fs_probe_space_warned && fs_probe_dest != NULL && fs_probe_cache != NULL)
+    {
+        const fs_probe_t *probe;
+
+        probe = (const fs_probe_t *) g_hash_table_lookup (fs_probe_cache, fs_probe_dest);
+        if (probe != NULL && probe->timestamp != 0 && probe->free_bytes != 0
+            && ctx->total_bytes > ctx->total_progress_bytes
+            && ctx->total_bytes - ctx->total_progress_bytes > probe->free_bytes)
+        {
+            fs_probe_space_warned = TRUE;  // ask once per operation
+            ret = TRUE;
+        }
+    }
+
+    g_mutex_unlock (&fs_probe_lock);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 file_frmt_time (char *buffer, double eta_secs)
 {
@@ -827,12 +1063,47 @@ file_progress_check_buttons (file_op_context_t *ctx)
 
     const file_progress_ui_t *ui = ctx->ui;
 
+    /* Abort early if the async destination probe reports less free space than
+       the bytes still to go, instead of running into ENOSPC much later */
+    if (ctx->operation != OP_DELETE && ctx->totals_computed && filegui__dest_space_short (ctx)
+        && query_dialog (op_names[ctx->operation],
+                         _ ("Not enough free space on the target filesystem\nContinue anyway?"),
+                         D_ERROR, 2, _ ("&Yes"), _ ("&No"))
+            != 0)
+        return FILE_ABORT;
+
 get_event:
     event.x = -1;  // Don't show the GPM cursor
     c = tty_get_event (&event, FALSE, ctx->suspended);
     if (c == EV_NONE)
         return FILE_CONT;
 
+    /* Live bandwidth limit: '-' throttles (halving from the measured rate at
+       first), '+' relaxes and finally lifts the limit. Takes effect on the next
+       chunk; see copy_throttle(). */
+    if (c == '-')
+    {
+        if (ctx->bps_limit > 0)
+            ctx->bps_limit /= 2;
+        else
+            ctx->bps_limit = ctx->bps > 0 ? ctx->bps / 2 : BPS_LIMIT_START;
+        ctx->bps_limit = MAX (ctx->bps_limit, BPS_LIMIT_MIN);
+
+        if (ctx->suspended)
+            goto get_event;
+        return FILE_CONT;
+    }
+    if (c == '+' && ctx->bps_limit > 0)
+    {
+        ctx->bps_limit *= 2;
+        if (ctx->bps_limit >= BPS_LIMIT_MAX)
+            ctx->bps_limit = 0;  // unlimited again
+
+        if (ctx->suspended)
+            goto get_event;
+        return FILE_CONT;
+    }
+
     // Reinitialize to avoid old values after events other than selecting a button
     ui->op_dlg->ret_value = FILE_CONT;
 
@@ -897,7 +1168,24 @@ file_progress_ui_create (file_op_context_t *ctx, gboolean with_eta,
     ctx->ui = g_new0 (file_progress_ui_t, 1);
 
     ui = ctx->ui;
-    ui->replace_result = REPLACE_YES;
+
+    /* A policy settled by the conflict pre-scan resolves all overwrite queries
+       up front; without one, the first conflict pops the dialog as before */
+    switch (ctx->replace_policy)
+    {
+    case REPLACE_POLICY_OVERWRITE:
+        ui->replace_result = REPLACE_ALL;
+        break;
+    case REPLACE_POLICY_OVERWRITE_OLDER:
+        ui->replace_result = REPLACE_OLDER;
+        break;
+    case REPLACE_POLICY_SKIP:
+        ui->replace_result = REPLACE_NONE;
+        break;
+    default:
+        ui->replace_result = REPLACE_YES;
+        break;
+    }
 
     ui->op_dlg = dlg_create (TRUE, 0, 0, dlg_height, dlg_width, WPOS_CENTER, FALSE, dialog_colors,
                              file_ui_op_dlg_callback, NULL, NULL, op_names[ctx->operation]);
@@ -1044,6 +1332,17 @@ file_progress_show (file_op_context_t *ctx, off_t done, off_t total, const char
         return;
     }
 
+    if (!force_update)
+    {
+        static gint64 timestamp = 0;
+        const gint64 delay = G_USEC_PER_SEC / 25;  // update with 25 FPS rate
+
+        /* the copy loop gets here once per block; repainting the gauge more often
+           than the terminal shows it only slows the copy down */
+        if (!mc_time_elapsed (&timestamp, delay))
+            return;
+    }
+
     gauge_set_value (ui->progress_file_gauge, 1024, (int) (1024 * done / total));
     gauge_show (ui->progress_file_gauge, TRUE);
 
@@ -1064,7 +1363,18 @@ file_progress_show (file_op_context_t *ctx, off_t done, off_t total, const char
             char buffer3[BUF_TINY];
 
             file_bps_prepare_for_show (buffer3, ctx->bps);
-            label_set_textv (ui->progress_file_label, "%s (%s) %s", buffer2, buffer3, stalled_msg);
+            if (ctx->bps_limit == 0)
+                label_set_textv (ui->progress_file_label, "%s (%s) %s", buffer2, buffer3,
+                                 stalled_msg);
+            else
+            {
+                char buffer4[BUF_TINY];
+
+                file_bps_prepare_for_show (buffer4, ctx->bps_limit);
+                // TRANSLATORS: current copy rate and the bandwidth limit set by the user
+                label_set_textv (ui->progress_file_label, _ ("%s (%s of %s) %s"), buffer2, buffer3,
+                                 buffer4, stalled_msg);
+            }
         }
     }
 }
@@ -1074,6 +1384,9 @@ file_progress_show (file_op_context_t *ctx, off_t done, off_t total, const char
 void
 file_progress_show_count (file_op_context_t *ctx)
 {
+    static gint64 timestamp = 0;
+    const gint64 delay = G_USEC_PER_SEC / 25;  // update with 25 FPS rate
+
     if (ctx == NULL || ctx->ui == NULL)
         return;
 
@@ -1082,6 +1395,10 @@ file_progress_show_count (file_op_context_t *ctx)
     if (ui->total_files_processed_label == NULL)
         return;
 
+    // called once per processed file; batch the label updates
+    if (!mc_time_elapsed (&timestamp, delay))
+        return;
+
     if (ctx->totals_computed)
         label_set_textv (ui->total_files_processed_label, _ ("Files processed: %zu / %zu"),
                          ctx->total_progress_count, ctx->total_count);
@@ -1175,6 +1492,13 @@ file_progress_show_source (file_op_context_t *ctx, const vfs_path_t *vpath)
 
     if (vpath != NULL)
     {
+        static gint64 timestamp = 0;
+        const gint64 delay = G_USEC_PER_SEC / 25;  // update with 25 FPS rate
+
+        // with many small files the names change faster than the screen can show them
+        if (!mc_time_elapsed (&timestamp, delay))
+            return;
+
         label_set_text (ui->src_file_label, _ ("Source"));
         label_set_text (ui->src_file, truncFileStringSecure (ui->op_dlg, vfs_path_as_str (vpath)));
     }
@@ -1197,6 +1521,12 @@ file_progress_show_target (file_op_context_t *ctx, const vfs_path_t *vpath)
 
     if (vpath != NULL)
     {
+        static gint64 timestamp = 0;
+        const gint64 delay = G_USEC_PER_SEC / 25;  // update with 25 FPS rate
+
+        if (!mc_time_elapsed (&timestamp, delay))
+            return;
+
         label_set_text (ui->tgt_file_label, _ ("Target"));
         label_set_text (ui->tgt_file, truncFileStringSecure (ui->op_dlg, vfs_path_as_str (vpath)));
     }
@@ -1404,12 +1734,14 @@ file_mask_dialog (file_op_context_t *ctx, gboolean only_one, const char *format,
             QUICK_START_COLUMNS,
                 QUICK_CHECKBOX (N_ ("Follow &links"), &ctx->follow_links, NULL),
                 QUICK_CHECKBOX (N_ ("Preserve &attributes"), &preserve, NULL),
+                QUICK_CHECKBOX (N_ ("Preserve s&parseness"), &copymove_preserve_sparse, NULL),
 #ifdef ENABLE_EXT2FS_ATTR
                 QUICK_CHECKBOX (N_ ("Preserve e&xt2 attributes"), &copymove_persistent_ext2_attr, NULL),
 #endif
             QUICK_NEXT_COLUMN,
                 QUICK_CHECKBOX (N_ ("Di&ve into subdir if exists"), &ctx->dive_into_subdirs, NULL),
                 QUICK_CHECKBOX (N_ ("&Stable symlinks"), &ctx->stable_symlinks, NULL),
+                QUICK_CHECKBOX (N_ ("Verify checksu&m"), &copymove_verify_checksum, NULL),
             QUICK_STOP_COLUMNS,
             QUICK_START_BUTTONS (TRUE, TRUE),
                 QUICK_BUTTON (N_ ("&OK"), B_ENTER, NULL, NULL),
@@ -1520,6 +1852,9 @@ file_mask_dialog (file_op_context_t *ctx, gboolean only_one, const char *format,
 
         vfs_path_free (vpath, TRUE);
 
+        // the transfer starts optimistically; the probe result is checked on the fly
+        filegui__track_dest_space (dest_dir);
+
         if (val == B_USER)
             *do_bg = TRUE;
     }
@@ -53,6 +53,15 @@ typedef enum
     FILE_SUSPEND
 } FileProgressStatus;
 
+/* Overwrite policy settled before the transfer starts (conflict pre-scan) */
+typedef enum
+{
+    REPLACE_POLICY_ASK = 0,  // resolve each conflict with a dialog (historic behavior)
+    REPLACE_POLICY_OVERWRITE,
+    REPLACE_POLICY_OVERWRITE_OLDER,
+    REPLACE_POLICY_SKIP
+} replace_policy_t;
+
 /* First argument passed to real functions */
 enum OperationMode
 {
@@ -107,6 +116,11 @@ typedef struct
 
     // Pointer to the stat function we will use
     mc_stat_fn stat_func;
+    /* Source stat the caller already holds (fresh panel data): the next
+       copy_file_file()/move_file_file() uses it instead of re-statting the source
+       over the possibly remote VFS. Consumed by that call, set per file. */
+    struct stat src_stat_hint;
+    gboolean src_stat_hint_set;
     // search handler
     struct mc_search_struct *search_handle;
     // toggle if all errors should be ignored
@@ -114,6 +128,9 @@ typedef struct
     // Whether the file operation is in pause
     gboolean suspended;
     gboolean ask_overwrite;
+    /* Conflict policy chosen up front by the pre-scan; seeds the overwrite query
+       result when the progress UI is created, so the transfer never stops to ask */
+    replace_policy_t replace_policy;
     // Result from the recursive query
     FileCopyMode recursive_result;
 
@@ -129,6 +146,13 @@ typedef struct
     double eta_secs;
     // Transferred bytes per second
     long bps;
+    /* I/O bandwidth ceiling in bytes per second, 0 = unlimited. Adjusted live
+     * from the progress dialog with '-' and '+', enforced by a token bucket
+     * around the transfer loop. */
+    long bps_limit;
+    // Token bucket state of the bandwidth limiter
+    double throttle_tokens;
+    gint64 throttle_stamp;
 
     // Total statuses
     // Whether the panel total has been computed
@@ -1077,11 +1077,11 @@ quit_cmd (void)
 static void
 update_dirty_panels (void)
 {
-    if (get_current_type () == view_listing && current_panel->dirty)
-        widget_draw (WIDGET (current_panel));
+    if (get_current_type () == view_listing)
+        panel_repaint_dirty (current_panel);
 
-    if (get_other_type () == view_listing && other_panel->dirty)
-        widget_draw (WIDGET (other_panel));
+    if (get_other_type () == view_listing)
+        panel_repaint_dirty (other_panel);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1550,7 +1550,7 @@ midnight_callback (Widget *w, Widget *sender, widget_msg_t msg, int parm, void *
     case MSG_HOTKEY_HANDLED:
         if ((get_current_type () == view_listing) && current_panel->quick_search.active)
         {
-            current_panel->dirty = TRUE;  // FIXME: unneeded?
+            panel_set_dirty (current_panel);  // FIXME: unneeded?
             send_message (current_panel, NULL, MSG_ACTION, CK_SearchStop, NULL);
         }
         return MSG_HANDLED;
@@ -1629,61 +1629,76 @@ get_random_hint (gboolean force)
 {
     static const gint64 update_period = 60 * G_USEC_PER_SEC;
     static gint64 tv = 0;
-
-    char *data, *result, *eop;
-    size_t len, start;
-    GIConv conv;
+    static GPtrArray *hints = NULL;  // hint entries, already in terminal encoding
+    static gboolean hints_loaded = FALSE;
 
     // Do not change hints more often than one minute
     if (!force && !mc_time_elapsed (&tv, update_period))
         return g_strdup ("");
 
-    data = load_mc_home_file (mc_global.share_data_dir, MC_HINT, NULL, &len);
-    if (data == NULL)
-        return NULL;
+    /* Read and convert the hints file once: every rotation used to re-read it
+       from disk just to pick one paragraph */
+    if (!hints_loaded)
+    {
+        char *data;
 
-    // get a random entry
-    srand ((unsigned int) (tv / G_USEC_PER_SEC));
-    start = ((size_t) rand ()) % (len - 1);
+        hints_loaded = TRUE;
 
-    // Search the start of paragraph
-    for (; start != 0; start--)
-        if (data[start] == '\n' && data[start + 1] == '\n')
+        data = load_mc_home_file (mc_global.share_data_dir, MC_HINT, NULL, NULL);
+        if (data != NULL)
         {
-            start += 2;
-            break;
-        }
+            GIConv conv;
+            char **paragraphs, **par;
 
-    // Search the end of paragraph
-    for (eop = data + start; *eop != '\0'; eop++)
-    {
-        if (*eop == '\n' && *(eop + 1) == '\n')
-        {
-            *eop = '\0';
-            break;
-        }
-        if (*eop == '\n')
-            *eop = ' ';
-    }
+            // hint files are stored in utf-8
+            // try convert hint file from utf-8 to terminal encoding
+            conv = str_crt_conv_from ("UTF-8");
 
-    // hint files are stored in utf-8
-    // try convert hint file from utf-8 to terminal encoding
-    conv = str_crt_conv_from ("UTF-8");
-    if (conv == INVALID_CONV)
-        result = g_strndup (data + start, len - start);
-    else
-    {
-        GString *buffer;
-        gboolean nok;
+            hints = g_ptr_array_new_with_free_func (g_free);
+            paragraphs = g_strsplit (data, "\n\n", -1);
+
+            for (par = paragraphs; *par != NULL; par++)
+            {
+                char *q;
+
+                // hints are displayed on one line
+                for (q = *par; *q != '\0'; q++)
+                    if (*q == '\n')
+                        *q = ' ';
+
+                if (**par == '\0')
+                    continue;
+
+                if (conv == INVALID_CONV)
+                    g_ptr_array_add (hints, g_strdup (*par));
+                else
+                {
+                    GString *buffer;
+
+                    buffer = g_string_sized_new (strlen (*par) + 1);
+                    if (str_convert (conv, *par, buffer) != ESTR_FAILURE)
+                        g_ptr_array_add (hints, g_string_free (buffer, FALSE));
+                    else
+                    {
+                        g_string_free (buffer, TRUE);
+                        g_ptr_array_add (hints, g_strdup (*par));
+                    }
+                }
+            }
 
-        buffer = g_string_sized_new (len - start);
-        nok = (str_convert (conv, data + start, buffer) == ESTR_FAILURE);
-        result = g_string_free (buffer, nok);
-        str_close_conv (conv);
+            g_strfreev (paragraphs);
+            if (conv != INVALID_CONV)
+                str_close_conv (conv);
+            g_free (data);
+        }
     }
 
-    g_free (data);
-    return result;
+    if (hints == NULL || hints->len == 0)
+        return NULL;
+
+    // get a random entry
+    srand ((unsigned int) (tv / G_USEC_PER_SEC));
+    return g_strdup (g_ptr_array_index (hints, ((size_t) rand ()) % hints->len));
 }
 
 /* --------------------------------------------------------------------------------------------- */
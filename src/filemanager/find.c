@@ -32,10 +32,13 @@
 #include <config.h>
 
 #include <ctype.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "lib/global.h"
 
@@ -55,6 +58,7 @@
 #include "dir.h"
 #include "cmd.h"  // find_cmd(), view_file_at_line()
 #include "boxes.h"
+#include "findindex.h"
 #include "panelize.h"
 
 /*** global variables ****************************************************************************/
@@ -64,6 +68,16 @@
 #define MAX_REFRESH_INTERVAL  (G_USEC_PER_SEC / 20)  // 50 ms
 #define MIN_REFRESH_FILE_SIZE (256 * 1024)           // 256 KB
 
+/* content search worker pool (local file systems only) */
+#define GREP_POOL_THREADS     4
+#define GREP_POOL_MAX_PENDING (GREP_POOL_THREADS * 16)
+
+/* how much of a mapped file is scanned between two event checks */
+#define GREP_MAP_SLICE        (1 << 20)
+
+/* longest matched-line snippet shown next to a result */
+#define FIND_CONTEXT_LEN      96
+
 /*** file scope type declarations ****************************************************************/
 
 /* A couple of extra messages we need */
@@ -100,6 +114,14 @@ typedef struct
     gboolean content_first_hit;
     gboolean content_whole_words;
     gboolean content_all_charsets;
+    // don't grep files with a NUL byte in the first block
+    gboolean content_skip_binary;
+    // don't grep files larger than this many MiB; 0 means no limit
+    int content_max_file_size;
+    // shortlist files through the persistent trigram index (literal searches only)
+    gboolean content_use_index;
+    // capture the matched line of every hit and show it in the results list
+    gboolean content_context;
 
     // whether use ignore dirs or not
     gboolean ignore_dirs_enable;
@@ -110,10 +132,46 @@ typedef struct
 typedef struct
 {
     char *dir;
+    char *filename;  // into find_dir_pool; shared by all matches in the file
+    int line;        // 1-based; 0 when there was no content search
     gsize start;
     gsize end;
 } find_match_location_t;
 
+/* one match found by a grep pool worker */
+typedef struct
+{
+    int line;
+    gsize start;
+    gsize len;
+    char *context;  // matched line snippet, or NULL when not captured
+} grep_pool_match_t;
+
+/* one file handed over to the grep pool */
+typedef struct
+{
+    char *directory;  // owned by the job
+    char *filename;   // owned by the job
+    GArray *matches;  // of grep_pool_match_t; NULL if nothing was found
+} grep_pool_job_t;
+
+/* one file listed by the previous completed search */
+typedef struct
+{
+    char *dir;
+    char *name;
+} find_prev_file_t;
+
+/* the previous completed search: its parameters and the files it listed */
+typedef struct
+{
+    char *start_dir;
+    char *file_pattern;
+    char *content_pattern;        // NULL if the content field was empty
+    find_file_options_t options;  // ignore_dirs is deep-copied
+    GPtrArray *files;             // of find_prev_file_t, in result order
+} find_prev_search_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /* button callbacks */
@@ -141,6 +199,8 @@ static WCheck *content_case_sens_cbox;    // "case sensitive" checkbox
 static WCheck *content_regexp_cbox;       // "find regular expression" checkbox
 static WCheck *content_first_hit_cbox;    // "First hit" checkbox"
 static WCheck *content_whole_words_cbox;  // "whole words" checkbox
+static WCheck *content_skip_binary_cbox;  // "Skip binary files" checkbox
+static WCheck *content_context_cbox;      // "Show match context" checkbox
 static WCheck *file_all_charsets_cbox;
 static WCheck *content_all_charsets_cbox;
 static WCheck *ignore_dirs_cbox;
@@ -155,6 +215,18 @@ static gboolean is_start = FALSE;         // Status of the start/stop toggle but
 static char *old_dir = NULL;
 
 static gint64 last_refresh;
+static gint64 last_listbox_refresh;
+
+/* append-only pool for the directory and file name strings the match locations
+   point into; equal strings are stored once (g_string_chunk_insert_const) */
+static GStringChunk *find_dir_pool = NULL;
+
+/* result set of the last completed search, replayed on narrowing re-searches */
+static find_prev_search_t *prev_search = NULL;
+static GPtrArray *cur_hits = NULL;         // files listed by the running search
+static gboolean replay_prev = FALSE;       // walk prev_search->files instead of the tree
+static guint replay_pos = 0;
+static gboolean search_completed = FALSE;  // the last run finished without interruption
 
 /* Where did we stop */
 static gboolean resuming;
@@ -162,6 +234,8 @@ static int last_line;
 static int last_pos;
 static off_t last_off;
 static int last_i;
+static gboolean resuming_mapped;  // the suspended scan was a mapped one
+static off_t last_map_off;        // resume offset of the mapped scan
 
 static size_t ignore_count = 0;
 
@@ -199,7 +273,8 @@ static const size_t quit_button = 4;  // index of "Quit" button
 static WListbox *find_list;  // Listbox with the file list
 
 static find_file_options_t options = {
-    TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE, NULL,
+    TRUE,  TRUE,  TRUE, FALSE, FALSE, FALSE, TRUE, FALSE,
+    FALSE, FALSE, FALSE, FALSE, 0,    FALSE, FALSE, NULL,
 };
 
 static char *in_start_dir = INPUT_LAST_TEXT;
@@ -207,6 +282,14 @@ static char *in_start_dir = INPUT_LAST_TEXT;
 static mc_search_t *search_file_handle = NULL;
 static mc_search_t *search_content_handle = NULL;
 
+/* trigram index shortlist of the running content search, NULL when not used */
+static find_index_query_t *content_index_query = NULL;
+
+/* content search worker pool */
+static GThreadPool *grep_pool = NULL;
+static GAsyncQueue *grep_pool_done = NULL;  // of grep_pool_job_t *
+static int grep_pool_pending = 0;           // jobs dispatched but not yet collected
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -298,6 +381,14 @@ find_load_options (void)
         mc_config_get_bool (mc_global.main_config, "FindFile", "content_whole_words", FALSE);
     options.content_all_charsets =
         mc_config_get_bool (mc_global.main_config, "FindFile", "content_all_charsets", FALSE);
+    options.content_skip_binary =
+        mc_config_get_bool (mc_global.main_config, "FindFile", "content_skip_binary", FALSE);
+    options.content_max_file_size =
+        mc_config_get_int (mc_global.main_config, "FindFile", "content_max_file_size", 0);
+    options.content_use_index =
+        mc_config_get_bool (mc_global.main_config, "FindFile", "content_use_index", FALSE);
+    options.content_context =
+        mc_config_get_bool (mc_global.main_config, "FindFile", "content_context", FALSE);
     options.ignore_dirs_enable =
         mc_config_get_bool (mc_global.main_config, "FindFile", "ignore_dirs_enable", TRUE);
     options.ignore_dirs =
@@ -332,6 +423,14 @@ find_save_options (void)
                         options.content_whole_words);
     mc_config_set_bool (mc_global.main_config, "FindFile", "content_all_charsets",
                         options.content_all_charsets);
+    mc_config_set_bool (mc_global.main_config, "FindFile", "content_skip_binary",
+                        options.content_skip_binary);
+    mc_config_set_int (mc_global.main_config, "FindFile", "content_max_file_size",
+                       options.content_max_file_size);
+    mc_config_set_bool (mc_global.main_config, "FindFile", "content_use_index",
+                        options.content_use_index);
+    mc_config_set_bool (mc_global.main_config, "FindFile", "content_context",
+                        options.content_context);
     mc_config_set_bool (mc_global.main_config, "FindFile", "ignore_dirs_enable",
                         options.ignore_dirs_enable);
     mc_config_set_string (mc_global.main_config, "FindFile", "ignore_dirs", options.ignore_dirs);
@@ -387,6 +486,10 @@ get_list_info (char **file, char **dir, gsize *start, gsize *end)
     listbox_get_current (find_list, file, (void **) &location);
     if (location != NULL)
     {
+        /* a match row: report the bare file name, not the display text
+           (which may carry a "line:" prefix and a context snippet) */
+        if (file != NULL)
+            *file = location->filename;
         if (dir != NULL)
             *dir = location->dir;
         if (start != NULL)
@@ -452,6 +555,8 @@ find_toggle_enable_content (void)
     widget_disable (WIDGET (content_all_charsets_cbox), content_is_empty);
     widget_disable (WIDGET (content_whole_words_cbox), content_is_empty);
     widget_disable (WIDGET (content_first_hit_cbox), content_is_empty);
+    widget_disable (WIDGET (content_skip_binary_cbox), content_is_empty);
+    widget_disable (WIDGET (content_context_cbox), content_is_empty);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -567,7 +672,7 @@ find_parameters (WPanel *panel, char **start_dir, ssize_t *start_dir_len, char *
     WGroup *g;
 
     // Size of the find parameters window
-    const int lines = 19;
+    const int lines = 20;
     int cols = 68;
 
     gboolean return_value;
@@ -589,6 +694,8 @@ find_parameters (WPanel *panel, char **start_dir, ssize_t *start_dir_len, char *
     const char *content_all_charsets_label = N_ ("A&ll charsets");
     const char *content_whole_words_label = N_ ("&Whole words");
     const char *content_first_hit_label = N_ ("Fir&st hit");
+    const char *content_skip_binary_label = N_ ("Skip &binary files");
+    const char *content_context_label = N_ ("Show match conte&xt");
 
     const char *buts[] = {
         N_ ("&Tree"),
@@ -622,6 +729,8 @@ find_parameters (WPanel *panel, char **start_dir, ssize_t *start_dir_len, char *
         content_all_charsets_label = _ (content_all_charsets_label);
         content_whole_words_label = _ (content_whole_words_label);
         content_first_hit_label = _ (content_first_hit_label);
+        content_skip_binary_label = _ (content_skip_binary_label);
+        content_context_label = _ (content_context_label);
 
         for (i = 0; i < G_N_ELEMENTS (buts); i++)
             buts[i] = _ (buts[i]);
@@ -646,6 +755,8 @@ find_parameters (WPanel *panel, char **start_dir, ssize_t *start_dir_len, char *
     cw = max (cw, str_term_width1 (content_all_charsets_label) + 4);
     cw = max (cw, str_term_width1 (content_whole_words_label) + 4);
     cw = max (cw, str_term_width1 (content_first_hit_label) + 4);
+    cw = max (cw, str_term_width1 (content_skip_binary_label) + 4);
+    cw = max (cw, str_term_width1 (content_context_label) + 4);
 
     // button width
     b0 = str_term_width1 (buts[0]) + 3;
@@ -742,6 +853,13 @@ find_parameters (WPanel *panel, char **start_dir, ssize_t *start_dir_len, char *
         check_new (y2++, x2, options.content_first_hit, content_first_hit_label);
     group_add_widget (g, content_first_hit_cbox);
 
+    content_skip_binary_cbox =
+        check_new (y2++, x2, options.content_skip_binary, content_skip_binary_label);
+    group_add_widget (g, content_skip_binary_cbox);
+
+    content_context_cbox = check_new (y2++, x2, options.content_context, content_context_label);
+    group_add_widget (g, content_context_cbox);
+
     // buttons
     y1 = max (y1, y2);
     x1 = (cols - b12) / 2;
@@ -791,6 +909,8 @@ find_par_start:
         options.content_regexp = content_regexp_cbox->state;
         options.content_first_hit = content_first_hit_cbox->state;
         options.content_whole_words = content_whole_words_cbox->state;
+        options.content_skip_binary = content_skip_binary_cbox->state;
+        options.content_context = content_context_cbox->state;
         options.find_recurs = recursively_cbox->state;
         options.follow_symlinks = follow_sym_cbox->state;
         options.file_pattern = file_pattern_cbox->state;
@@ -900,33 +1020,79 @@ clear_stack (void)
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-insert_file (const char *dir, const char *file, gsize start, gsize end)
+find_prev_file_free (gpointer data)
+{
+    find_prev_file_t *f = (find_prev_file_t *) data;
+
+    g_free (f->dir);
+    g_free (f->name);
+    g_free (f);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Remember a file of the running search, for a later narrowing re-search */
+
+static void
+find_prev_record (const char *dir, const char *file)
+{
+    find_prev_file_t *f;
+    const char *name = file;
+
+    if (cur_hits == NULL)
+        return;
+
+    // content matches carry a "line:" prefix
+    if (content_pattern != NULL)
+        name = strchr (file, ':') + 1;
+
+    if (cur_hits->len != 0)
+    {
+        f = g_ptr_array_index (cur_hits, cur_hits->len - 1);
+        if (strcmp (f->name, name) == 0 && strcmp (f->dir, dir) == 0)
+            return;  // another match in the same file
+    }
+
+    f = g_new (find_prev_file_t, 1);
+    f->dir = g_strdup (dir);
+    f->name = g_strdup (name);
+    g_ptr_array_add (cur_hits, f);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+insert_file (const char *dir, const char *file, gsize start, gsize end, const char *context)
 {
     char *tmp_name;
-    static char *dirname = NULL;
     find_match_location_t *location;
+    const char *fname = file;
+    int line = 0;
 
     while (IS_PATH_SEP (dir[0]) && IS_PATH_SEP (dir[1]))
         dir++;
 
-    if (old_dir != NULL)
+    if (old_dir == NULL || strcmp (old_dir, dir) != 0)
     {
-        if (strcmp (old_dir, dir) != 0)
-        {
-            g_free (old_dir);
-            old_dir = g_strdup (dir);
-            dirname = add_to_list (dir, NULL);
-        }
+        g_free (old_dir);
+        old_dir = g_strdup (dir);
+        add_to_list (dir, NULL);
     }
-    else
+
+    // content matches carry a "line:" prefix
+    if (content_pattern != NULL)
     {
-        old_dir = g_strdup (dir);
-        dirname = add_to_list (dir, NULL);
+        fname = strchr (file, ':') + 1;
+        line = atoi (file);
     }
 
-    tmp_name = g_strdup_printf ("    %s", file);
+    if (context != NULL)
+        tmp_name = g_strdup_printf ("    %s: %s", file, context);
+    else
+        tmp_name = g_strdup_printf ("    %s", file);
     location = g_malloc (sizeof (*location));
-    location->dir = dirname;
+    location->dir = g_string_chunk_insert_const (find_dir_pool, dir);
+    location->filename = g_string_chunk_insert_const (find_dir_pool, fname);
+    location->line = line;
     location->start = start;
     location->end = end;
     add_to_list_take (tmp_name, location);
@@ -935,17 +1101,30 @@ insert_file (const char *dir, const char *file, gsize start, gsize end)
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-find_add_match (const char *dir, const char *file, gsize start, gsize end)
+find_add_match (const char *dir, const char *file, gsize start, gsize end, const char *context)
 {
-    insert_file (dir, file, start, end);
+    gint64 tv;
+
+    find_prev_record (dir, file);
+    insert_file (dir, file, start, end, context);
 
     // Don't scroll
     if (matches == 0)
         listbox_select_first (find_list);
-    widget_draw (WIDGET (find_list));
 
-    matches++;
-    found_num_update ();
+    /* A repaint per match freezes million-hit searches. Only the visible rows
+       matter: redraw the listbox and the counter at most every
+       MAX_REFRESH_INTERVAL; the "Finished" path repaints them a last time. */
+    tv = g_get_monotonic_time ();
+    if (matches == 0 || tv - last_listbox_refresh > MAX_REFRESH_INTERVAL)
+    {
+        widget_draw (WIDGET (find_list));
+        last_listbox_refresh = tv;
+        matches++;
+        found_num_update ();
+    }
+    else
+        matches++;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -977,6 +1156,271 @@ check_find_events (WDialog *h)
     return FIND_CONT;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Cut the matched line out of a scanned buffer, for display next to the result.
+ *
+ * The snippet runs from the start of the line the match begins on (backed up at
+ * most FIND_CONTEXT_LEN / 2 bytes, so the match itself stays visible) to the
+ * end of the line, capped at FIND_CONTEXT_LEN bytes in total. Control bytes are
+ * blanked out: the listbox is a single line per entry.
+ *
+ * @return newly allocated snippet, or NULL when match_start is out of range
+ */
+
+static char *
+find_context_snippet (const char *data, size_t size, size_t match_start)
+{
+    const char *begin, *end;
+    char *snippet;
+    size_t i;
+
+    if (match_start > size)
+        return NULL;
+
+    begin = data + match_start;
+    while (begin > data && begin[-1] != '\n'
+           && (size_t) (data + match_start - begin) < FIND_CONTEXT_LEN / 2)
+        begin--;
+
+    end = memchr (data + match_start, '\n', size - match_start);
+    if (end == NULL)
+        end = data + size;
+    if ((size_t) (end - begin) > FIND_CONTEXT_LEN)
+        end = begin + FIND_CONTEXT_LEN;
+
+    snippet = g_strndup (begin, (gsize) (end - begin));
+
+    for (i = 0; snippet[i] != '\0'; i++)
+        if ((unsigned char) snippet[i] < ' ')
+            snippet[i] = ' ';
+
+    return snippet;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Scan part of a mapped file window and collect the matches.
+ *
+ * Whole NUL-terminated segments are handed to mc_search_run(), which splits them
+ * into lines internally; there is no per-byte line assembly here. Line numbers
+ * are recovered by counting newlines between consecutive matches. Like the
+ * buffered scan in search_content(), at most one match per line is recorded.
+ *
+ * @param search search handle to run
+ * @param data start of the mapped file
+ * @param window_end scan no further than this offset
+ * @param pos in: scan start; out: where the scan stopped
+ * @param line in/out: line number at *pos
+ * @param counted in/out: offset up to which newlines have been counted
+ * @param matches in/out: collected matches; created on first hit
+ */
+
+static void
+grep_scan_window (mc_search_t *search, const char *data, size_t window_end, size_t *pos, int *line,
+                  size_t *counted, GArray **matches)
+{
+    while (*pos < window_end)
+    {
+        const char *p;
+        size_t seg_end, start;
+        gsize found_len;
+        grep_pool_match_t m;
+
+        // the line walker in mc_search_run() stops at the first NUL: feed it one segment
+        p = memchr (data + *pos, '\0', window_end - *pos);
+        seg_end = (p == NULL) ? window_end : (size_t) (p - data);
+
+        if (seg_end == *pos)
+        {
+            (*pos)++;  // skip the NUL, stay on the same line
+            continue;
+        }
+
+        if (!mc_search_run (search, (const void *) data, *pos, seg_end - 1, &found_len))
+        {
+            *pos = seg_end;
+            continue;
+        }
+
+        start = (size_t) search->normal_offset;
+
+        // recover the line number of the match
+        for (p = data + *counted; p < data + start; p++)
+        {
+            p = memchr (p, '\n', (size_t) (data + start - p));
+            if (p == NULL)
+                break;
+            (*line)++;
+        }
+        *counted = start;
+
+        m.line = *line;
+        m.start = start + 1;  // off by one: ticket 3280
+        m.len = found_len;
+        // windows end on line boundaries, so the matched line is fully visible here
+        m.context =
+            options.content_context ? find_context_snippet (data, window_end, start) : NULL;
+        if (*matches == NULL)
+            *matches = g_array_new (FALSE, FALSE, sizeof (grep_pool_match_t));
+        g_array_append_val (*matches, m);
+
+        if (options.content_first_hit)
+        {
+            *pos = window_end;
+            break;
+        }
+
+        // one match per line: continue past this line's newline
+        p = memchr (data + start, '\n', window_end - start);
+        if (p == NULL)
+        {
+            *pos = window_end;
+            break;
+        }
+        *pos = (size_t) (p - data) + 1;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Grep a local file through a memory map.
+ *
+ * The file is scanned in ~1 MiB slices (extended to a line boundary) so that
+ * check_find_events() keeps running between slices; suspension remembers the
+ * resume offset in last_map_off.
+ *
+ * @return TRUE if the file was handled here (*ret_val is set as for
+ *         search_content()), FALSE to fall back to the buffered scan
+ */
+
+static gboolean
+search_content_mapped (WDialog *h, const char *directory, const char *filename,
+                       gboolean status_updated, gboolean *ret_val)
+{
+    char *path;
+    int fd;
+    struct stat s;
+    char *data;
+    size_t size, pos, counted, slice_end;
+    int line;
+    GArray *matches = NULL;
+    gboolean stop = FALSE;
+
+    path = g_build_filename (directory, filename, (char *) NULL);
+    fd = open (path, O_RDONLY);
+    g_free (path);
+
+    if (fd == -1)
+        return FALSE;
+
+    if (fstat (fd, &s) != 0 || !S_ISREG (s.st_mode))
+    {
+        close (fd);
+        return FALSE;
+    }
+
+    if (s.st_size == 0)
+    {
+        // nothing to scan
+        close (fd);
+        return TRUE;
+    }
+
+    data = mmap (NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);  // the mapping keeps the file referenced
+    if (data == MAP_FAILED)
+        return FALSE;
+
+#ifdef POSIX_MADV_SEQUENTIAL
+    (void) posix_madvise (data, s.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+
+    size = (size_t) s.st_size;
+    pos = 0;
+    counted = 0;
+    line = 1;
+
+    if (resuming)
+    {
+        // We've been previously suspended, start from the previous position
+        resuming = FALSE;
+        resuming_mapped = FALSE;
+        line = last_line;
+        pos = (size_t) last_map_off;
+        counted = pos;
+    }
+
+    while (pos < size && !stop)
+    {
+        slice_end = MIN (pos + GREP_MAP_SLICE, size);
+        if (slice_end < size)
+        {
+            const char *nl;
+
+            nl = memchr (data + slice_end, '\n', size - slice_end);
+            slice_end = (nl == NULL) ? size : (size_t) (nl - data) + 1;
+        }
+
+        grep_scan_window (search_content_handle, data, slice_end, &pos, &line, &counted, &matches);
+
+        if (matches != NULL && matches->len != 0)
+        {
+            guint k;
+            char result[BUF_MEDIUM];
+
+            if (!status_updated)
+            {
+                /* if we add results for a file, we have to ensure that
+                   name of this file is shown in status bar */
+                g_snprintf (result, sizeof (result), _ ("Grepping in %s"), filename);
+                status_update (str_trunc (result, WIDGET (h)->rect.cols - 8));
+                mc_refresh ();
+                status_updated = TRUE;
+            }
+
+            for (k = 0; k < matches->len; k++)
+            {
+                grep_pool_match_t *m = &g_array_index (matches, grep_pool_match_t, k);
+
+                g_snprintf (result, sizeof (result), "%d:%s", m->line, filename);
+                find_add_match (directory, result, m->start, m->start + m->len, m->context);
+                g_free (m->context);
+            }
+
+            g_array_set_size (matches, 0);
+
+            if (options.content_first_hit)
+                break;
+        }
+
+        if (pos < size)
+            switch (check_find_events (h))
+            {
+            case FIND_ABORT:
+                stop_idle (h);
+                *ret_val = TRUE;
+                stop = TRUE;
+                break;
+            case FIND_SUSPEND:
+                resuming = TRUE;
+                resuming_mapped = TRUE;
+                last_line = line;
+                last_map_off = (off_t) pos;
+                *ret_val = TRUE;
+                stop = TRUE;
+                break;
+            default:
+                break;
+            }
+    }
+
+    if (matches != NULL)
+        g_array_free (matches, TRUE);
+    munmap (data, s.st_size);
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * search_content:
@@ -998,12 +1442,14 @@ search_content (WDialog *h, const char *directory, const char *filename)
     vfs_path_t *vpath;
     gint64 tv;
     gboolean status_updated = FALSE;
+    gboolean is_local;
 
     vpath = vfs_path_build_filename (directory, filename, (char *) NULL);
 
     if (mc_stat (vpath, &s) == 0 && S_ISREG (s.st_mode))
         file_fd = mc_open (vpath, O_RDONLY);
 
+    is_local = vfs_file_is_local (vpath);
     vfs_path_free (vpath, TRUE);
 
     if (file_fd == -1)
@@ -1024,6 +1470,16 @@ search_content (WDialog *h, const char *directory, const char *filename)
     tty_enable_interrupt_key ();
     tty_got_interrupt ();
 
+    /* Local files are scanned through a memory map: whole windows go to
+       mc_search_run() and the per-byte line assembly below is skipped. */
+    if (is_local && (!resuming || resuming_mapped)
+        && search_content_mapped (h, directory, filename, status_updated, &ret_val))
+    {
+        tty_disable_interrupt_key ();
+        mc_close (file_fd);
+        return ret_val;
+    }
+
     {
         int line = 1;
         int pos = 0;
@@ -1038,10 +1494,15 @@ search_content (WDialog *h, const char *directory, const char *filename)
         {
             // We've been previously suspended, start from the previous position
             resuming = FALSE;
-            line = last_line;
-            pos = last_pos;
-            off = last_off;
-            i = last_i;
+            if (resuming_mapped)
+                resuming_mapped = FALSE;  // the map is gone: restart the file
+            else
+            {
+                line = last_line;
+                pos = last_pos;
+                off = last_off;
+                i = last_i;
+            }
         }
 
         while (!ret_val)
@@ -1119,7 +1580,19 @@ search_content (WDialog *h, const char *directory, const char *filename)
                 g_snprintf (result, sizeof (result), "%d:%s", line, filename);
                 found_start =
                     off + search_content_handle->normal_offset + 1;  // off by one: ticket 3280
-                find_add_match (directory, result, found_start, found_start + found_len);
+                if (options.content_context)
+                {
+                    char *context;
+
+                    // strbuf holds exactly the matched line
+                    context = find_context_snippet (
+                        strbuf, (size_t) i, (size_t) search_content_handle->normal_offset);
+                    find_add_match (directory, result, found_start, found_start + found_len,
+                                    context);
+                    g_free (context);
+                }
+                else
+                    find_add_match (directory, result, found_start, found_start + found_len, NULL);
                 found = TRUE;
             }
 
@@ -1166,6 +1639,325 @@ search_content (WDialog *h, const char *directory, const char *filename)
     return ret_val;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Grep one local file with a private search handle and collect the matches.
+ *
+ * This is the worker-side counterpart of search_content(): mapped scanning when
+ * possible, the same byte-by-byte line assembly as a fallback, but plain file
+ * descriptors instead of the VFS and no UI access at all -- matches are stored
+ * in the job and delivered to the listbox by grep_pool_collect() on the main
+ * thread.
+ */
+
+static void
+grep_pool_scan_file (mc_search_t *search, grep_pool_job_t *job)
+{
+    struct stat s;
+    char buffer[BUF_4K];  // raw input buffer
+    char *path;
+    int file_fd;
+    int line = 1;
+    int pos = 0;
+    int n_read = 0;
+    off_t off = 0;  // file_fd's offset corresponding to strbuf[0]
+    gboolean found = FALSE;
+    char *strbuf = NULL;  // buffer for fetched string
+    int strbuf_size = 0;
+    int i = -1;  // compensate for a newline we'll add when we first enter the loop
+
+    path = g_build_filename (job->directory, job->filename, (char *) NULL);
+    file_fd = open (path, O_RDONLY);
+    g_free (path);
+
+    if (file_fd == -1)
+        return;
+
+    if (fstat (file_fd, &s) != 0 || !S_ISREG (s.st_mode))
+    {
+        close (file_fd);
+        return;
+    }
+
+    // map the file if possible and hand whole windows to mc_search_run()
+    if (s.st_size > 0)
+    {
+        char *data;
+
+        data = mmap (NULL, s.st_size, PROT_READ, MAP_PRIVATE, file_fd, 0);
+        if (data != MAP_FAILED)
+        {
+            size_t map_pos = 0;
+            size_t counted = 0;
+
+#ifdef POSIX_MADV_SEQUENTIAL
+            (void) posix_madvise (data, s.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+            grep_scan_window (search, data, (size_t) s.st_size, &map_pos, &line, &counted,
+                              &job->matches);
+            munmap (data, s.st_size);
+            close (file_fd);
+            return;
+        }
+    }
+
+    // fall back to buffered reads
+    while (TRUE)
+    {
+        char ch = '\0';
+        gsize found_len;
+
+        off += i + 1;  // the previous line, plus a newline character
+        i = 0;
+
+        // read to buffer and get line from there
+        while (TRUE)
+        {
+            if (pos >= n_read)
+            {
+                pos = 0;
+                n_read = read (file_fd, buffer, sizeof (buffer));
+                if (n_read <= 0)
+                    break;
+            }
+
+            ch = buffer[pos++];
+            if (ch == '\0')
+            {
+                // skip possible leading zero(s)
+                if (i == 0)
+                {
+                    off++;
+                    continue;
+                }
+                break;
+            }
+
+            if (i >= strbuf_size - 1)
+            {
+                strbuf_size += 128;
+                strbuf = g_realloc (strbuf, strbuf_size);
+            }
+
+            // Strip newline
+            if (ch == '\n')
+                break;
+
+            strbuf[i++] = ch;
+        }
+
+        if (i == 0)
+        {
+            if (ch == '\0')
+                break;
+
+            // if (ch == '\n'): do not search in empty strings
+            goto skip_search;
+        }
+
+        strbuf[i] = '\0';
+
+        if (!found  // Search in binary line once
+            && mc_search_run (search, (const void *) strbuf, 0, i, &found_len))
+        {
+            grep_pool_match_t m;
+
+            m.line = line;
+            m.start = off + search->normal_offset + 1;  // off by one: ticket 3280
+            m.len = found_len;
+            m.context = options.content_context
+                ? find_context_snippet (strbuf, (size_t) i, (size_t) search->normal_offset)
+                : NULL;
+
+            if (job->matches == NULL)
+                job->matches = g_array_new (FALSE, FALSE, sizeof (grep_pool_match_t));
+            g_array_append_val (job->matches, m);
+            found = TRUE;
+        }
+
+        if (found && options.content_first_hit)
+            break;
+
+        if (ch == '\n')
+        {
+        skip_search:
+            found = FALSE;
+            line++;
+        }
+    }
+
+    g_free (strbuf);
+    close (file_fd);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+grep_pool_worker (gpointer data, gpointer user_data)
+{
+    grep_pool_job_t *job = (grep_pool_job_t *) data;
+    mc_search_t *search;
+
+    (void) user_data;
+
+    /* Each job gets a private handle: mc_search_t carries per-run state (normal_offset,
+       compiled regex match data) and must not be shared between threads. */
+    search = mc_search_new (content_pattern, NULL);
+    if (search != NULL)
+    {
+        search->search_type = options.content_regexp ? MC_SEARCH_T_REGEX : MC_SEARCH_T_NORMAL;
+        search->is_case_sensitive = options.content_case_sens;
+        search->whole_words = options.content_whole_words;
+
+        grep_pool_scan_file (search, job);
+        mc_search_free (search);
+    }
+
+    g_async_queue_push (grep_pool_done, job);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Try to hand a file over to the grep pool.
+ *
+ * Only local files qualify, and only when the search doesn't use the charset
+ * conversion tables ("All charsets"), which are not thread-safe. When the pool
+ * is saturated the caller greps synchronously, which throttles the walk.
+ *
+ * @return TRUE if the file was dispatched
+ */
+
+static gboolean
+grep_pool_dispatch (const char *dir, const char *filename)
+{
+    grep_pool_job_t *job;
+    vfs_path_t *vpath;
+    gboolean is_local;
+
+    if (options.content_all_charsets)
+        return FALSE;
+
+    if (grep_pool_pending >= GREP_POOL_MAX_PENDING)
+        return FALSE;
+
+    vpath = vfs_path_from_str (dir);
+    is_local = vfs_file_is_local (vpath);
+    vfs_path_free (vpath, TRUE);
+
+    if (!is_local)
+        return FALSE;
+
+    if (grep_pool == NULL)
+    {
+        grep_pool = g_thread_pool_new (grep_pool_worker, NULL, GREP_POOL_THREADS, FALSE, NULL);
+        if (grep_pool == NULL)
+            return FALSE;
+
+        grep_pool_done = g_async_queue_new ();
+    }
+
+    job = g_new0 (grep_pool_job_t, 1);
+    job->directory = g_strdup (dir);
+    job->filename = g_strdup (filename);
+
+    g_thread_pool_push (grep_pool, job, NULL);
+    grep_pool_pending++;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Deliver finished grep jobs to the listbox.
+ *
+ * Runs on the main thread. With wait_all, blocks until every dispatched job has
+ * come back -- do_search() does that before leaving a directory, so the listbox
+ * keeps its matches grouped per directory even though files finish out of order.
+ */
+
+static void
+grep_pool_collect (gboolean wait_all)
+{
+    while (grep_pool_pending > 0)
+    {
+        grep_pool_job_t *job;
+
+        if (wait_all)
+            job = (grep_pool_job_t *) g_async_queue_pop (grep_pool_done);
+        else
+        {
+            job = (grep_pool_job_t *) g_async_queue_try_pop (grep_pool_done);
+            if (job == NULL)
+                break;
+        }
+
+        grep_pool_pending--;
+
+        if (job->matches != NULL)
+        {
+            guint k;
+
+            for (k = 0; k < job->matches->len; k++)
+            {
+                grep_pool_match_t *m = &g_array_index (job->matches, grep_pool_match_t, k);
+                char result[BUF_MEDIUM];
+
+                g_snprintf (result, sizeof (result), "%d:%s", m->line, job->filename);
+                find_add_match (job->directory, result, m->start, m->start + m->len, m->context);
+                g_free (m->context);
+            }
+
+            g_array_free (job->matches, TRUE);
+        }
+
+        g_free (job->directory);
+        g_free (job->filename);
+        g_free (job);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for outstanding grep jobs, throw their results away and free the pool.
+ * Used when the search is torn down: content_pattern must outlive the workers.
+ */
+
+static void
+grep_pool_shutdown (void)
+{
+    while (grep_pool_pending > 0)
+    {
+        grep_pool_job_t *job;
+
+        job = (grep_pool_job_t *) g_async_queue_pop (grep_pool_done);
+        grep_pool_pending--;
+
+        if (job->matches != NULL)
+        {
+            guint k;
+
+            for (k = 0; k < job->matches->len; k++)
+                g_free (g_array_index (job->matches, grep_pool_match_t, k).context);
+            g_array_free (job->matches, TRUE);
+        }
+        g_free (job->directory);
+        g_free (job->filename);
+        g_free (job);
+    }
+
+    if (grep_pool != NULL)
+    {
+        g_thread_pool_free (grep_pool, FALSE, TRUE);
+        grep_pool = NULL;
+    }
+
+    if (grep_pool_done != NULL)
+    {
+        g_async_queue_unref (grep_pool_done);
+        grep_pool_done = NULL;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 /**
@@ -1244,6 +2036,241 @@ find_rotate_dash (const WDialog *h, gboolean show)
     mc_refresh ();
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Reject a candidate file before grepping its content.
+ *
+ * Applies the optional size cap and the binary sniff (a NUL byte in the first
+ * block) configured in the Find File dialog. Both checks are off by default.
+ */
+
+static gboolean
+find_content_is_unwanted (const char *directory, const char *filename)
+{
+    struct stat s;
+    vfs_path_t *vpath;
+    gboolean unwanted = FALSE;
+
+    if (!options.content_skip_binary && options.content_max_file_size == 0)
+        return FALSE;
+
+    vpath = vfs_path_build_filename (directory, filename, (char *) NULL);
+
+    if (mc_stat (vpath, &s) == 0 && S_ISREG (s.st_mode))
+    {
+        if (options.content_max_file_size > 0
+            && s.st_size > (off_t) options.content_max_file_size * 1024 * 1024)
+            unwanted = TRUE;
+        else if (options.content_skip_binary)
+        {
+            int file_fd;
+
+            file_fd = mc_open (vpath, O_RDONLY);
+            if (file_fd != -1)
+            {
+                char buffer[BUF_4K];
+                ssize_t n_read;
+
+                n_read = mc_read (file_fd, buffer, sizeof (buffer));
+                unwanted = n_read > 0 && memchr (buffer, '\0', n_read) != NULL;
+                mc_close (file_fd);
+            }
+        }
+    }
+
+    vfs_path_free (vpath, TRUE);
+
+    return unwanted;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_prev_search_free (find_prev_search_t *p)
+{
+    if (p == NULL)
+        return;
+
+    g_free (p->start_dir);
+    g_free (p->file_pattern);
+    g_free (p->content_pattern);
+    g_free (p->options.ignore_dirs);
+    g_ptr_array_free (p->files, TRUE);
+    g_free (p);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Whether the new content literal provably matches a subset of the previous one */
+
+static gboolean
+find_prev_content_narrows (const char *prev_pattern)
+{
+    char *lc_prev, *lc_cur;
+    const char *p;
+    gboolean ret;
+
+    if (options.content_case_sens)
+        return strstr (content_pattern, prev_pattern) != NULL;
+
+    // caseless containment is only decided for pure ASCII patterns
+    for (p = prev_pattern; *p != '\0'; p++)
+        if ((unsigned char) *p >= 0x80)
+            return FALSE;
+    for (p = content_pattern; *p != '\0'; p++)
+        if ((unsigned char) *p >= 0x80)
+            return FALSE;
+
+    lc_prev = g_ascii_strdown (prev_pattern, -1);
+    lc_cur = g_ascii_strdown (content_pattern, -1);
+    ret = strstr (lc_cur, lc_prev) != NULL;
+    g_free (lc_prev);
+    g_free (lc_cur);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Whether the new search provably selects a subset of the previous completed one,
+ * so that re-scanning the previous hits cannot lose a match.
+ */
+
+static gboolean
+find_prev_can_replay (const char *start_dir)
+{
+    const find_file_options_t *po;
+
+    if (prev_search == NULL || strcmp (prev_search->start_dir, start_dir) != 0)
+        return FALSE;
+
+    po = &prev_search->options;
+
+    /* the walk must have been configured identically, or files the previous
+       search never visited could match now */
+    if (po->file_case_sens != options.file_case_sens || po->file_pattern != options.file_pattern
+        || po->find_recurs != options.find_recurs
+        || po->follow_symlinks != options.follow_symlinks
+        || po->skip_hidden != options.skip_hidden
+        || po->file_all_charsets != options.file_all_charsets
+        || po->ignore_dirs_enable != options.ignore_dirs_enable
+        || g_strcmp0 (po->ignore_dirs, options.ignore_dirs) != 0)
+        return FALSE;
+
+    // the new name pattern must select a subset of the previous one
+    if (strcmp (prev_search->file_pattern, find_pattern) != 0
+        && !(po->file_pattern && strcmp (prev_search->file_pattern, "*") == 0))
+        return FALSE;
+
+    // a search without content listed every file the name pattern selected
+    if (prev_search->content_pattern == NULL)
+        return TRUE;
+
+    if (content_pattern == NULL)
+        return FALSE;
+
+    /* both literal, same charset handling, and the new literal containing the
+       previous one: every new hit is a previous hit */
+    if (po->content_regexp || options.content_regexp || po->content_whole_words
+        || po->content_case_sens != options.content_case_sens
+        || po->content_all_charsets != options.content_all_charsets)
+        return FALSE;
+
+    // files the previous search refused to grep are not in its list
+    if ((po->content_skip_binary && !options.content_skip_binary)
+        || (po->content_max_file_size != 0
+            && (options.content_max_file_size == 0
+                || options.content_max_file_size > po->content_max_file_size)))
+        return FALSE;
+
+    return find_prev_content_narrows (prev_search->content_pattern);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Keep the result set of a completed search as the base of the next narrowing
+ * re-search; an interrupted one is discarded as incomplete.
+ */
+
+static void
+find_prev_commit (const char *start_dir)
+{
+    if (cur_hits == NULL)
+        return;
+
+    if (!search_completed)
+    {
+        g_ptr_array_free (cur_hits, TRUE);
+        cur_hits = NULL;
+        return;
+    }
+
+    find_prev_search_free (prev_search);
+
+    prev_search = g_new0 (find_prev_search_t, 1);
+    prev_search->start_dir = g_strdup (start_dir);
+    prev_search->file_pattern = g_strdup (find_pattern);
+    prev_search->content_pattern = g_strdup (content_pattern);
+    prev_search->options = options;
+    prev_search->options.ignore_dirs = g_strdup (options.ignore_dirs);
+    prev_search->files = cur_hits;
+    cur_hits = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Re-scan only the hits of the previous search instead of walking the tree */
+
+static int
+do_search_prev (WDialog *h)
+{
+    unsigned short count;
+
+    for (count = 0; count < 32; count++)
+    {
+        find_prev_file_t *f;
+        gsize bytes_found;
+
+        if (replay_pos >= prev_search->files->len)
+        {
+            running = FALSE;
+            search_completed = TRUE;
+            status_update (_ ("Finished"));
+            if (verbose)
+                find_rotate_dash (h, FALSE);
+            widget_draw (WIDGET (find_list));
+            found_num_update ();
+            stop_idle (h);
+            return 0;
+        }
+
+        f = g_ptr_array_index (prev_search->files, replay_pos);
+
+        if (verbose
+            && (replay_pos == 0
+                || strcmp (((find_prev_file_t *) g_ptr_array_index (prev_search->files,
+                                                                    replay_pos - 1))
+                               ->dir,
+                           f->dir)
+                    != 0))
+            status_update (str_trunc (f->dir, WIDGET (h)->rect.cols - 8));
+
+        if (mc_search_run (search_file_handle, f->name, 0, strlen (f->name), &bytes_found))
+        {
+            if (content_pattern == NULL)
+                find_add_match (f->dir, f->name, 0, 0, NULL);
+            else if (!find_content_is_unwanted (f->dir, f->name)
+                     && search_content (h, f->dir, f->name))
+                return 1;  // suspended or aborted inside this file; do not advance
+        }
+
+        replay_pos++;
+    }
+
+    if (verbose)
+        find_rotate_dash (h, TRUE);
+
+    return 1;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static int
@@ -1259,6 +2286,7 @@ do_search (WDialog *h)
 
     if (h == NULL)
     {  // someone forces me to close dirp
+        grep_pool_shutdown ();
         if (dirp != NULL)
         {
             mc_closedir (dirp);
@@ -1270,6 +2298,9 @@ do_search (WDialog *h)
         return 1;
     }
 
+    if (replay_prev)
+        return do_search_prev (h);
+
     for (count = 0; count < 32; count++)
     {
         while (dp == NULL)
@@ -1278,6 +2309,10 @@ do_search (WDialog *h)
             {
                 mc_closedir (dirp);
                 dirp = NULL;
+
+                /* deliver this directory's grep results before entering the next one,
+                   so the listbox stays grouped by directory */
+                grep_pool_collect (TRUE);
             }
 
             while (dirp == NULL)
@@ -1292,6 +2327,7 @@ do_search (WDialog *h)
                     if (tmp_vpath == NULL)
                     {
                         running = FALSE;
+                        search_completed = TRUE;
                         if (ignore_count == 0)
                             status_update (_ ("Finished"));
                         else
@@ -1307,6 +2343,9 @@ do_search (WDialog *h)
                         }
                         if (verbose)
                             find_rotate_dash (h, FALSE);
+                        // deliver the matches a throttled find_add_match left unpainted
+                        widget_draw (WIDGET (find_list));
+                        found_num_update ();
                         stop_idle (h);
                         return 0;
                     }
@@ -1391,7 +2430,15 @@ do_search (WDialog *h)
             if (search_ok)
             {
                 if (content_pattern == NULL)
-                    find_add_match (directory, dp->d_name, 0, 0);
+                    find_add_match (directory, dp->d_name, 0, 0, NULL);
+                else if (content_index_query != NULL
+                         && !find_index_query_may_match (content_index_query, directory,
+                                                         dp->d_name))
+                    ;  // the index proves the literal is not in this file
+                else if (find_content_is_unwanted (directory, dp->d_name))
+                    ;  // rejected by the size cap or the binary sniff
+                else if (grep_pool_dispatch (directory, dp->d_name))
+                    grep_pool_collect (FALSE);  // a worker greps it
                 else if (search_content (h, directory, dp->d_name))
                     return 1;
             }
@@ -1427,30 +2474,16 @@ init_find_vars (void)
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-find_do_view_edit (gboolean unparsed_view, gboolean edit, char *dir, char *file, off_t search_start,
-                   off_t search_end)
+find_do_view_edit (gboolean unparsed_view, gboolean edit, const find_match_location_t *location)
 {
-    const char *filename = NULL;
-    int line;
     vfs_path_t *fullname_vpath;
 
-    if (content_pattern != NULL)
-    {
-        filename = strchr (file + 4, ':') + 1;
-        line = atoi (file + 4);
-    }
-    else
-    {
-        filename = file + 4;
-        line = 0;
-    }
-
-    fullname_vpath = vfs_path_build_filename (dir, filename, (char *) NULL);
+    fullname_vpath = vfs_path_build_filename (location->dir, location->filename, (char *) NULL);
     if (edit)
-        edit_file_at_line (fullname_vpath, use_internal_edit, line);
+        edit_file_at_line (fullname_vpath, use_internal_edit, location->line);
     else
-        view_file_at_line (fullname_vpath, unparsed_view, use_internal_view, line, search_start,
-                           search_end);
+        view_file_at_line (fullname_vpath, unparsed_view, use_internal_view, location->line,
+                           location->start, location->end);
     vfs_path_free (fullname_vpath, TRUE);
 }
 
@@ -1467,7 +2500,7 @@ view_edit_currently_selected_file (gboolean unparsed_view, gboolean edit)
     if ((text == NULL) || (location == NULL) || (location->dir == NULL))
         return MSG_NOT_HANDLED;
 
-    find_do_view_edit (unparsed_view, edit, location->dir, text, location->start, location->end);
+    find_do_view_edit (unparsed_view, edit, location);
     return MSG_HANDLED;
 }
 
@@ -1680,6 +2713,7 @@ setup_gui (void)
 
     y = 2;
     find_list = listbox_new (y, 2, lines - 10, cols - 4, FALSE, NULL);
+    find_list->typeahead = TRUE;
     group_add_widget_autopos (g, find_list, WPOS_KEEP_ALL, NULL);
     y += WIDGET (find_list)->rect.lines;
 
@@ -1734,6 +2768,7 @@ run_process (void)
     search_file_handle->is_entire_line = options.file_pattern;
 
     resuming = FALSE;
+    resuming_mapped = FALSE;
 
     widget_idle (WIDGET (find_dlg), TRUE);
     ret = dlg_run (find_dlg);
@@ -1759,6 +2794,18 @@ kill_gui (void)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static gboolean
+find_pattern_is_ascii (const char *str)
+{
+    for (; *str != '\0'; str++)
+        if ((unsigned char) *str > 0x7F)
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 do_find (WPanel *panel, const char *start_dir, ssize_t start_dir_len, const char *ignore_dirs,
          char **dirname, char **filename)
@@ -1768,12 +2815,50 @@ do_find (WPanel *panel, const char *start_dir, ssize_t start_dir_len, const char
 
     setup_gui ();
 
+    /* the pool must outlive the listbox entries pointing into it,
+       so it is released only at the end of this function */
+    find_dir_pool = g_string_chunk_new (MC_MAXPATHLEN);
+
     init_find_vars ();
     parse_ignore_dirs (ignore_dirs);
     push_directory (vfs_path_from_str (start_dir));
 
+    /* A provably narrowed repeat of the previous completed search only
+       re-scans its hits instead of walking the tree again. */
+    replay_prev = find_prev_can_replay (start_dir);
+    replay_pos = 0;
+    search_completed = FALSE;
+    cur_hits = g_ptr_array_new_with_free_func (find_prev_file_free);
+
+    /* Literal content searches may shortlist files through the trigram index;
+       a missing index is kicked off in the background for next time.
+       The index folds case per ASCII byte, so a case-insensitive non-ASCII
+       literal could be ruled out wrongly -- same guard as the literal fast
+       path in lib/search/normal.c. */
+    if (!replay_prev && options.content_use_index && content_pattern != NULL
+        && !options.content_regexp && !options.content_all_charsets
+        && (options.content_case_sens || find_pattern_is_ascii (content_pattern)))
+    {
+        vfs_path_t *start_vpath;
+
+        start_vpath = vfs_path_from_str (start_dir);
+        if (vfs_file_is_local (start_vpath))
+        {
+            content_index_query = find_index_query_new (start_dir, content_pattern);
+            if (content_index_query == NULL)
+                find_index_build_async (start_dir);
+        }
+        vfs_path_free (start_vpath, TRUE);
+    }
+
     return_value = run_process ();
 
+    find_index_query_free (content_index_query);
+    content_index_query = NULL;
+
+    find_prev_commit (start_dir);
+    replay_prev = FALSE;
+
     // Clear variables
     init_find_vars ();
 
@@ -1798,7 +2883,6 @@ do_find (WPanel *panel, const char *start_dir, ssize_t start_dir_len, const char
         for (entry = listbox_get_first_link (find_list); entry != NULL && ok;
              entry = g_list_next (entry))
         {
-            const char *lc_filename;
             WLEntry *le = LENTRY (entry->data);
             find_match_location_t *location = le->data;
             char *p;
@@ -1807,12 +2891,7 @@ do_find (WPanel *panel, const char *start_dir, ssize_t start_dir_len, const char
             if ((le->text == NULL) || (location == NULL) || (location->dir == NULL))
                 continue;
 
-            if (!content_is_empty)
-                lc_filename = strchr (le->text + 4, ':') + 1;
-            else
-                lc_filename = le->text + 4;
-
-            name = mc_build_filename (location->dir, lc_filename, (char *) NULL);
+            name = mc_build_filename (location->dir, location->filename, (char *) NULL);
             // skip initial start dir
             p = name;
             if (start_dir_len > 0)
@@ -1864,6 +2943,8 @@ do_find (WPanel *panel, const char *start_dir, ssize_t start_dir_len, const char
 
     kill_gui ();
     do_search (NULL);  // force do_search to release resources
+    g_string_chunk_free (find_dir_pool);
+    find_dir_pool = NULL;
     MC_PTR_FREE (old_dir);
     rotate_dash (FALSE);
 
@@ -1918,16 +2999,7 @@ find_cmd (WPanel *panel)
                 vfs_path_free (dirname_vpath, TRUE);
 
                 if (filename != NULL)
-                {
-                    size_t offset;
-
-                    if (content_pattern == NULL)
-                        offset = 4;
-                    else
-                        offset = strchr (filename + 4, ':') - filename + 1;
-
-                    panel_set_current_by_name (panel, filename + offset);
-                }
+                    panel_set_current_by_name (panel, filename);
             }
             else if (filename != NULL)
             {
@@ -0,0 +1,597 @@
+/*
+   Persistent trigram index for the Find File content search.
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file findindex.c
+ *  \brief Source: persistent trigram index for the Find File content search
+ *
+ *  One index file per tree, stored under the mc cache directory. It records,
+ *  for every indexed file, its mtime and size and the set of lowercased byte
+ *  trigrams of its content, hashed into 2^20 buckets with posting lists of
+ *  file ids. A query intersects the posting lists of the trigrams of the
+ *  searched literal: indexed and unchanged files outside the intersection
+ *  cannot contain the literal and are skipped without being opened. Files
+ *  unknown to the index, or whose mtime or size changed, are always scanned,
+ *  so a stale index costs speed, never correctness.
+ *
+ *  The index is built by a background thread with plain file system calls:
+ *  only local trees are indexed.
+ */
+
+#include <config.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/mcconfig.h"  // mc_config_get_cache_path()
+#include "lib/util.h"
+
+#include "findindex.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define FIND_INDEX_DIR           "findindex"
+#define FIND_INDEX_MAGIC         "mc findindex 1"
+
+/* files larger than this are not indexed and therefore always scanned */
+#define FIND_INDEX_MAX_FILE_SIZE (1 << 20)
+
+/* a NUL byte in the first block marks a binary file; those are not indexed */
+#define FIND_INDEX_SNIFF_SIZE    4096
+
+/* rebuild an existing index no more often than this */
+#define FIND_INDEX_MAX_AGE       (24 * 60 * 60)
+
+/* number of trigram buckets (2^20) */
+#define FIND_INDEX_BUCKET_BITS   20
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    guint32 id;
+    gint64 mtime;
+    gint64 size;
+} find_index_file_rec_t;
+
+struct find_index_query_t
+{
+    char *root;
+    gsize root_len;
+    GHashTable *files;       // relpath -> find_index_file_rec_t *
+    GHashTable *candidates;  // set of file ids that may contain the literal
+};
+
+/* build state carried through the tree walk */
+typedef struct
+{
+    GPtrArray *file_lines;  // formatted "F <mtime> <size> <relpath>" records
+    GHashTable *postings;   // bucket -> GArray of guint32 file ids
+    GHashTable *seen;       // per-file trigram dedup, reused between files
+} find_index_builder_t;
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* a build is running in the background */
+static volatile gint find_index_build_running = 0;
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static guint32
+find_index_trigram_bucket (const char *p)
+{
+    guint32 v;
+
+    v = ((guint32) (unsigned char) g_ascii_tolower (p[0]) << 16)
+        | ((guint32) (unsigned char) g_ascii_tolower (p[1]) << 8)
+        | (guint32) (unsigned char) g_ascii_tolower (p[2]);
+
+    // Knuth multiplicative hash, keep the top FIND_INDEX_BUCKET_BITS bits
+    return (v * 2654435761U) >> (32 - FIND_INDEX_BUCKET_BITS);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Path of the index file of a tree: one file per root under the cache directory,
+ * named after a hash of the root path.
+ */
+
+static char *
+find_index_file_path (const char *root)
+{
+    char *checksum, *name, *path;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, root, -1);
+    checksum[24] = '\0';
+    name = g_strconcat (checksum, ".idx", (char *) NULL);
+    path = g_build_filename (mc_config_get_cache_path (), FIND_INDEX_DIR, name, (char *) NULL);
+    g_free (name);
+    g_free (checksum);
+
+    return path;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Index the content of one regular file: record its trigrams in the posting lists.
+ * Binary and oversized files are left out and therefore always scanned.
+ */
+
+static void
+find_index_build_add_file (find_index_builder_t *builder, const char *path, const char *relpath,
+                           const struct stat *st)
+{
+    char *content = NULL;
+    gsize length = 0;
+    guint32 id;
+    gsize loop;
+
+    if (st->st_size > FIND_INDEX_MAX_FILE_SIZE || strchr (relpath, '\n') != NULL)
+        return;
+
+    if (!g_file_get_contents (path, &content, &length, NULL))
+        return;
+
+    if (memchr (content, '\0', MIN (length, (gsize) FIND_INDEX_SNIFF_SIZE)) != NULL)
+    {
+        g_free (content);
+        return;
+    }
+
+    id = builder->file_lines->len;
+    g_ptr_array_add (builder->file_lines,
+                     g_strdup_printf ("F %lld %lld %s", (long long) st->st_mtime,
+                                      (long long) st->st_size, relpath));
+
+    g_hash_table_remove_all (builder->seen);
+
+    for (loop = 0; length >= 3 && loop <= length - 3; loop++)
+    {
+        const guint32 bucket = find_index_trigram_bucket (content + loop);
+        gpointer key = GUINT_TO_POINTER (bucket + 1);
+        GArray *ids;
+
+        if (!g_hash_table_add (builder->seen, key))
+            continue;  // already recorded for this file
+
+        ids = (GArray *) g_hash_table_lookup (builder->postings, key);
+        if (ids == NULL)
+        {
+            ids = g_array_new (FALSE, FALSE, sizeof (guint32));
+            g_hash_table_insert (builder->postings, key, ids);
+        }
+        g_array_append_val (ids, id);
+    }
+
+    g_free (content);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_index_build_walk (find_index_builder_t *builder, const char *root, const char *subdir)
+{
+    char *dir_path;
+    DIR *dirp;
+    struct dirent *dp;
+
+    dir_path = subdir == NULL ? g_strdup (root) : g_build_filename (root, subdir, (char *) NULL);
+    dirp = opendir (dir_path);
+
+    while (dirp != NULL && (dp = readdir (dirp)) != NULL)
+    {
+        char *path, *relpath;
+        struct stat st;
+
+        if (DIR_IS_DOT (dp->d_name) || DIR_IS_DOTDOT (dp->d_name))
+            continue;
+
+        path = g_build_filename (dir_path, dp->d_name, (char *) NULL);
+        relpath =
+            subdir == NULL ? g_strdup (dp->d_name) : g_build_filename (subdir, dp->d_name, NULL);
+
+        // symlinks are neither followed nor indexed
+        if (lstat (path, &st) == 0)
+        {
+            if (S_ISDIR (st.st_mode))
+                find_index_build_walk (builder, root, relpath);
+            else if (S_ISREG (st.st_mode))
+                find_index_build_add_file (builder, path, relpath, &st);
+        }
+
+        g_free (relpath);
+        g_free (path);
+    }
+
+    if (dirp != NULL)
+        closedir (dirp);
+    g_free (dir_path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Write the collected records to a temporary file and move it into place,
+ * so a concurrent query never sees a half-written index.
+ */
+
+static void
+find_index_build_write (find_index_builder_t *builder, const char *root)
+{
+    char *path, *tmp_path;
+    FILE *f;
+    guint loop;
+    GHashTableIter iter;
+    gpointer key, value;
+    gboolean ok = TRUE;
+
+    path = find_index_file_path (root);
+    tmp_path = g_strconcat (path, ".tmp", (char *) NULL);
+
+    {
+        char *dir_path;
+
+        dir_path = g_path_get_dirname (path);
+        g_mkdir_with_parents (dir_path, 0700);
+        g_free (dir_path);
+    }
+
+    f = fopen (tmp_path, "w");
+    if (f == NULL)
+    {
+        g_free (tmp_path);
+        g_free (path);
+        return;
+    }
+
+    fprintf (f, "%s\n%s\n", FIND_INDEX_MAGIC, root);
+
+    for (loop = 0; loop < builder->file_lines->len; loop++)
+        fprintf (f, "%s\n", (const char *) g_ptr_array_index (builder->file_lines, loop));
+
+    g_hash_table_iter_init (&iter, builder->postings);
+    while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+        const GArray *ids = (const GArray *) value;
+        guint loop2;
+
+        fprintf (f, "T %x", GPOINTER_TO_UINT (key) - 1);
+        for (loop2 = 0; loop2 < ids->len; loop2++)
+            fprintf (f, " %u", g_array_index (ids, guint32, loop2));
+        fputc ('\n', f);
+    }
+
+    if (fclose (f) != 0)
+        ok = FALSE;
+
+    if (ok)
+        ok = rename (tmp_path, path) == 0;
+    if (!ok)
+        unlink (tmp_path);
+
+    g_free (tmp_path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_index_posting_free (gpointer data)
+{
+    g_array_free ((GArray *) data, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gpointer
+find_index_build_thread (gpointer data)
+{
+    char *root = (char *) data;
+    find_index_builder_t builder;
+
+    builder.file_lines = g_ptr_array_new_with_free_func (g_free);
+    builder.postings = g_hash_table_new_full (NULL, NULL, NULL, find_index_posting_free);
+    builder.seen = g_hash_table_new (NULL, NULL);
+
+    find_index_build_walk (&builder, root, NULL);
+    find_index_build_write (&builder, root);
+
+    g_hash_table_destroy (builder.seen);
+    g_hash_table_destroy (builder.postings);
+    g_ptr_array_free (builder.file_lines, TRUE);
+    g_free (root);
+
+    g_atomic_int_set (&find_index_build_running, 0);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Collect the trigram buckets of the literal.
+ *
+ * @return set of buckets, or NULL if the literal is too short to be indexed
+ */
+
+static GHashTable *
+find_index_literal_buckets (const char *literal)
+{
+    GHashTable *needed;
+    size_t len, loop;
+
+    len = strlen (literal);
+    if (len < 3)
+        return NULL;
+
+    needed = g_hash_table_new (NULL, NULL);
+    for (loop = 0; loop <= len - 3; loop++)
+        g_hash_table_add (needed,
+                          GUINT_TO_POINTER (find_index_trigram_bucket (literal + loop) + 1));
+
+    return needed;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Drop the ids of the running intersection that a posting line doesn't confirm.
+ */
+
+static gboolean
+find_index_candidate_absent (gpointer key, gpointer value, gpointer user_data)
+{
+    (void) value;
+
+    return !g_hash_table_contains ((GHashTable *) user_data, key);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+find_index_query_t *
+find_index_query_new (const char *root, const char *literal)
+{
+    GHashTable *needed;
+    guint matched_buckets = 0;
+    char *index_path, *content = NULL;
+    char *line, *next;
+    find_index_query_t *q = NULL;
+    guint32 next_id = 0;
+    gboolean ok = TRUE;
+
+    needed = find_index_literal_buckets (literal);
+    if (needed == NULL)
+        return NULL;
+
+    index_path = find_index_file_path (root);
+    if (!g_file_get_contents (index_path, &content, NULL, NULL))
+    {
+        g_free (index_path);
+        g_hash_table_destroy (needed);
+        return NULL;
+    }
+    g_free (index_path);
+
+    // header: magic and the root the index was built for
+    line = content;
+    next = strchr (line, '\n');
+    if (next == NULL || strncmp (line, FIND_INDEX_MAGIC, (size_t) (next - line)) != 0)
+        ok = FALSE;
+    else
+    {
+        line = next + 1;
+        next = strchr (line, '\n');
+        if (next == NULL || strncmp (line, root, (size_t) (next - line)) != 0
+            || root[next - line] != '\0')
+            ok = FALSE;
+    }
+
+    if (ok)
+    {
+        q = g_new0 (find_index_query_t, 1);
+        q->root = g_strdup (root);
+        q->root_len = strlen (root);
+        q->files = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+        q->candidates = NULL;
+    }
+
+    for (line = ok ? next + 1 : NULL; ok && *line != '\0'; line = next + 1)
+    {
+        next = strchr (line, '\n');
+        if (next == NULL)
+            break;  // ignore a truncated last line
+        *next = '\0';
+
+        if (line[0] == 'F' && line[1] == ' ')
+        {
+            find_index_file_rec_t *rec;
+            long long mtime, size;
+            int consumed = 0;
+
+            if (sscanf (line + 2, "%lld %lld %n", &mtime, &size, &consumed) != 2 || consumed == 0)
+            {
+                ok = FALSE;
+                break;
+            }
+
+            rec = g_new (find_index_file_rec_t, 1);
+            rec->id = next_id++;
+            rec->mtime = mtime;
+            rec->size = size;
+            g_hash_table_insert (q->files, g_strdup (line + 2 + consumed), rec);
+        }
+        else if (line[0] == 'T' && line[1] == ' ')
+        {
+            guint32 bucket;
+            char *p = line + 2;
+            char *end = NULL;
+
+            bucket = (guint32) strtoul (p, &end, 16);
+            if (end == p)
+            {
+                ok = FALSE;
+                break;
+            }
+
+            if (g_hash_table_contains (needed, GUINT_TO_POINTER (bucket + 1)))
+            {
+                GHashTable *ids;
+
+                // parse the posting list into a set
+                ids = g_hash_table_new (NULL, NULL);
+                for (p = end; *p == ' '; p = end)
+                {
+                    const guint32 id = (guint32) strtoul (p + 1, &end, 10);
+
+                    if (end == p + 1)
+                        break;
+                    g_hash_table_add (ids, GUINT_TO_POINTER (id + 1));
+                }
+
+                // intersect with the candidates collected so far
+                if (q->candidates == NULL)
+                    q->candidates = ids;
+                else
+                {
+                    g_hash_table_foreach_remove (q->candidates, find_index_candidate_absent, ids);
+                    g_hash_table_destroy (ids);
+                }
+                matched_buckets++;
+            }
+        }
+        else
+        {
+            ok = FALSE;
+            break;
+        }
+    }
+
+    // a needed trigram missing from the index means no indexed file can match
+    if (ok && matched_buckets != g_hash_table_size (needed))
+    {
+        if (q->candidates != NULL)
+            g_hash_table_remove_all (q->candidates);
+        else
+            q->candidates = g_hash_table_new (NULL, NULL);
+    }
+    if (ok && q->candidates == NULL)
+        q->candidates = g_hash_table_new (NULL, NULL);
+
+    if (!ok && q != NULL)
+    {
+        find_index_query_free (q);
+        q = NULL;
+    }
+
+    g_hash_table_destroy (needed);
+    g_free (content);
+
+    return q;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+gboolean
+find_index_query_may_match (const find_index_query_t *q, const char *directory,
+                            const char *filename)
+{
+    char *path;
+    const char *relpath;
+    const find_index_file_rec_t *rec;
+    struct stat st;
+    gboolean may_match = TRUE;
+
+    path = g_build_filename (directory, filename, (char *) NULL);
+
+    if (strncmp (path, q->root, q->root_len) != 0 || !IS_PATH_SEP (path[q->root_len]))
+    {
+        g_free (path);
+        return TRUE;  // outside the indexed tree
+    }
+
+    relpath = path + q->root_len + 1;
+    rec = (const find_index_file_rec_t *) g_hash_table_lookup (q->files, relpath);
+
+    /* only a file the index knows in its current state can be skipped;
+       anything unknown or changed is scanned as usual */
+    if (rec != NULL && lstat (path, &st) == 0 && S_ISREG (st.st_mode)
+        && (gint64) st.st_mtime == rec->mtime && (gint64) st.st_size == rec->size)
+        may_match = g_hash_table_contains (q->candidates, GUINT_TO_POINTER (rec->id + 1));
+
+    g_free (path);
+
+    return may_match;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+find_index_query_free (find_index_query_t *q)
+{
+    if (q == NULL)
+        return;
+
+    if (q->candidates != NULL)
+        g_hash_table_destroy (q->candidates);
+    g_hash_table_destroy (q->files);
+    g_free (q->root);
+    g_free (q);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+find_index_build_async (const char *root)
+{
+    char *index_path;
+    struct stat st;
+    GThread *thread;
+
+    // an existing fresh index is kept; per-file mtime checks handle small drift
+    index_path = find_index_file_path (root);
+    if (stat (index_path, &st) == 0 && time (NULL) - st.st_mtime < FIND_INDEX_MAX_AGE)
+    {
+        g_free (index_path);
+        return;
+    }
+    g_free (index_path);
+
+    if (!g_atomic_int_compare_and_exchange (&find_index_build_running, 0, 1))
+        return;  // a build is already running
+
+    thread = g_thread_new ("find-index", find_index_build_thread, g_strdup (root));
+    g_thread_unref (thread);
+}
+
+/* --------------------------------------------------------------------------------------------- */
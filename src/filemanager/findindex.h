@@ -0,0 +1,39 @@
+/** \file findindex.h
+ *  \brief Header: persistent trigram index for the Find File content search
+ */
+
+#ifndef MC__FINDINDEX_H
+#define MC__FINDINDEX_H
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/* a loaded index restricted to the files that may contain one literal */
+typedef struct find_index_query_t find_index_query_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+/* Load the index of a tree and shortlist the files that may contain the literal.
+ * Returns NULL if there is no usable index (too short a literal, no index file). */
+find_index_query_t *find_index_query_new (const char *root, const char *literal);
+
+/* Whether a file still has to be scanned: unknown, changed and shortlisted files do. */
+gboolean find_index_query_may_match (const find_index_query_t *q, const char *directory,
+                                     const char *filename);
+
+void find_index_query_free (find_index_query_t *q);
+
+/* (Re)build the index of a tree in a background thread. A build already
+ * in progress makes this a no-op. */
+void find_index_build_async (const char *root);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -211,6 +211,11 @@ static time_t hotlist_file_mtime;
 
 static int list_level = 0;
 
+/* Quick search in the list dialogs (Ctrl-s / Alt-s, like in panels): while active,
+ * printable keys are consumed before they can reach the button hotkeys */
+static GString *hotlist_search_pattern = NULL;
+static gboolean hotlist_search_active = FALSE;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -252,7 +257,12 @@ update_path_name (void)
         }
     }
 
-    p = g_strconcat (" ", current_group->label, " ", (char *) NULL);
+    // echo the quick search pattern in the group title while the search is active
+    if (hotlist_search_active)
+        p = g_strconcat (" ", current_group->label, " [", hotlist_search_pattern->str, "] ",
+                         (char *) NULL);
+    else
+        p = g_strconcat (" ", current_group->label, " ", (char *) NULL);
     if (hotlist_state.moving)
         groupbox_set_title (movelist_group, str_trunc (p, w->rect.cols - 2));
     else
@@ -342,6 +352,7 @@ hotlist_run_cmd (int action)
         hotlist_state.moving = TRUE;
         ret = dlg_run (movelist_dlg);
         hotlist_state.moving = FALSE;
+        hotlist_search_active = FALSE;
         listbox_get_current (l_movelist, NULL, (void **) &moveto_item);
         moveto_group = current_group;
         widget_destroy (WIDGET (movelist_dlg));
@@ -484,6 +495,101 @@ hotlist_button_callback (WButton *button, int action)
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Move the selection to the next entry matching the quick search pattern.
+ *
+ * The scan starts at @from and wraps around. Matching is a case insensitive substring
+ * search over the labels of the current group; an empty pattern matches everything.
+ */
+
+static gboolean
+hotlist_search_select (int from)
+{
+    WListbox *list = hotlist_state.moving ? l_movelist : l_hotlist;
+    const int len = listbox_get_length (list);
+    int i;
+
+    if (hotlist_search_pattern->len == 0)
+        return TRUE;
+
+    for (i = 0; i < len; i++)
+    {
+        WLEntry *e;
+        int pos;
+
+        pos = (from + i) % len;
+        e = listbox_get_nth_entry (list, pos);
+        if (e != NULL && str_search_first (e->text, hotlist_search_pattern->str, FALSE) != NULL)
+        {
+            listbox_set_current (list, pos);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Quick search mode: grab keys at the dialog level, before the button hotkeys see them */
+
+static cb_ret_t
+hotlist_search_handle_key (int key)
+{
+    WListbox *list = hotlist_state.moving ? l_movelist : l_hotlist;
+
+    if (!hotlist_search_active)
+        return MSG_NOT_HANDLED;
+
+    if (key == XCTRL ('s') || key == ALT ('s'))
+    {
+        // jump to the next match
+        hotlist_search_select (list->current + 1);
+        update_path_name ();
+        return MSG_HANDLED;
+    }
+
+    if (key == KEY_BACKSPACE || key == '\b')
+    {
+        if (hotlist_search_pattern->len != 0)
+        {
+            const char *last;
+
+            last = hotlist_search_pattern->str + hotlist_search_pattern->len;
+            str_cprev_char_safe (&last);
+            g_string_truncate (hotlist_search_pattern, last - hotlist_search_pattern->str);
+            hotlist_search_select (list->current);
+        }
+        update_path_name ();
+        return MSG_HANDLED;
+    }
+
+    if (key > 31 && key < 256)
+    {
+        g_string_append_c (hotlist_search_pattern, (gchar) key);
+        /* a multibyte character arrives one byte per key event: search only when the
+         * pattern is complete, and drop the last character again if nothing matches */
+        if (str_is_valid_string (hotlist_search_pattern->str)
+            && !hotlist_search_select (list->current))
+        {
+            const char *last;
+
+            last = hotlist_search_pattern->str + hotlist_search_pattern->len;
+            str_cprev_char_safe (&last);
+            g_string_truncate (hotlist_search_pattern, last - hotlist_search_pattern->str);
+        }
+        update_path_name ();
+        return MSG_HANDLED;
+    }
+
+    // any other key finishes the search...
+    hotlist_search_active = FALSE;
+    update_path_name ();
+
+    // ... and Esc is eaten up, while the rest acts as usual
+    return key == ESC_CHAR ? MSG_HANDLED : MSG_NOT_HANDLED;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static inline cb_ret_t
@@ -521,6 +627,17 @@ hotlist_handle_key (WDialog *h, int key)
         hotlist_button_callback (NULL, B_REMOVE);
         return MSG_HANDLED;
 
+    case XCTRL ('s'):
+    case ALT ('s'):
+        // start the quick search
+        if (hotlist_search_pattern == NULL)
+            hotlist_search_pattern = g_string_new ("");
+        else
+            g_string_truncate (hotlist_search_pattern, 0);
+        hotlist_search_active = TRUE;
+        update_path_name ();
+        return MSG_HANDLED;
+
     l1:
     case ALT ('\n'):
     case ALT ('\r'):
@@ -567,6 +684,10 @@ hotlist_callback (Widget *w, Widget *sender, widget_msg_t msg, int parm, void *d
         update_path_name ();
         return MSG_HANDLED;
 
+    case MSG_KEY:
+        // the quick search owns the keyboard while it is active
+        return hotlist_search_handle_key (parm);
+
     case MSG_UNHANDLED_KEY:
         return hotlist_handle_key (h, parm);
 
@@ -756,6 +877,8 @@ init_hotlist (hotlist_t list_type)
 
     do_refresh ();
 
+    hotlist_search_active = FALSE;
+
     lines = LINES - 2;
     cols = init_i18n_stuff (list_type, COLS - 6);
 
@@ -784,6 +907,8 @@ init_hotlist (hotlist_t list_type)
 
     l_hotlist = listbox_new (y + 1, UX + 1, hotlist_widget->rect.lines - 2,
                              hotlist_widget->rect.cols - 2, FALSE, hotlist_listbox_callback);
+    // entry hotkeys keep precedence over type-ahead
+    l_hotlist->typeahead = TRUE;
 
     // Fill the hotlist with the active VFS or the hotlist
 #ifdef ENABLE_VFS
@@ -836,6 +961,8 @@ init_movelist (struct hotlist *item)
 
     do_refresh ();
 
+    hotlist_search_active = FALSE;
+
     lines = LINES - 6;
     cols = init_i18n_stuff (LIST_MOVELIST, COLS - 6);
 
@@ -854,6 +981,7 @@ init_movelist (struct hotlist *item)
 
     l_movelist = listbox_new (y + 1, UX + 1, movelist_widget->rect.lines - 2,
                               movelist_widget->rect.cols - 2, FALSE, hotlist_listbox_callback);
+    l_movelist->typeahead = TRUE;
     fill_listbox (l_movelist);
     // insert before groupbox to view scrollbar
     group_add_widget_autopos (g, l_movelist, WPOS_KEEP_ALL, NULL);
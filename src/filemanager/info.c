@@ -60,6 +60,11 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Period between my_statfs() polls of the same directory.  Free space changes slowly,
+   but a statfs per repaint makes every cursor movement wait for the filesystem on
+   slow network mounts */
+#define INFO_FS_STATS_TTL (10 * G_USEC_PER_SEC)
+
 /*** file scope type declarations ****************************************************************/
 
 struct WInfo
@@ -73,6 +78,9 @@ struct WInfo
 /*** file scope variables ************************************************************************/
 
 static struct my_statfs myfs_stats;
+// Directory the cached myfs_stats were taken for and the time of the last poll
+static char *myfs_stats_path = NULL;
+static gint64 myfs_stats_timestamp = 0;
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
@@ -135,7 +143,16 @@ info_show_info (WInfo *info)
     if (p_rp_cwd == NULL)
         p_rp_cwd = vfs_path_as_str (current_panel->cwd_vpath);
 
-    my_statfs (&myfs_stats, p_rp_cwd);
+    // Reuse the cached filesystem stats while the directory stays the same
+    if (myfs_stats_path == NULL || strcmp (myfs_stats_path, p_rp_cwd) != 0)
+    {
+        g_free (myfs_stats_path);
+        myfs_stats_path = g_strdup (p_rp_cwd);
+        myfs_stats_timestamp = 0;  // force a poll below
+    }
+
+    if (mc_time_elapsed (&myfs_stats_timestamp, INFO_FS_STATS_TTL))
+        my_statfs (&myfs_stats, p_rp_cwd);
 
     fe = panel_current_entry (current_panel);
     if (fe == NULL)
@@ -351,6 +368,8 @@ info_callback (Widget *w, Widget *sender, widget_msg_t msg, int parm, void *data
     case MSG_DESTROY:
         delete_hook (&select_file_hook, info_hook);
         free_my_statfs ();
+        MC_PTR_FREE (myfs_stats_path);
+        myfs_stats_timestamp = 0;
         return MSG_HANDLED;
 
     default:
@@ -0,0 +1,120 @@
+/*
+   Batched applier shared by the mass attribute dialogs (chmod, chown, chattr)
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file massop.c
+ *  \brief Source: batched applier shared by the mass attribute dialogs
+ *
+ *  The chmod, chown and chattr dialogs used to run their own near-identical
+ *  "apply to all marked files" loops, each redrawing the panel after every
+ *  file. This engine walks the marked set once, hands every entry to the
+ *  dialog's operation callback and samples the screen update: the panel is
+ *  redrawn at most at the dash rotation rate, so applying an attribute
+ *  change to a large marked set is dominated by the VFS calls themselves.
+ */
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "lib/global.h"
+#include "lib/util.h"    // mc_time_elapsed()
+#include "lib/widget.h"
+#include "lib/vfs/vfs.h"
+
+#include "layout.h"  // rotate_dash()
+#include "panel.h"
+
+#include "massop.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Apply an operation to every marked entry of the panel.
+ *
+ * Entries are unmarked as they are processed; an operation that fails a file but wants
+ * the batch to continue (ignore) simply returns TRUE. Screen updates are sampled instead
+ * of performed per file.
+ *
+ * @param panel WPanel object
+ * @param op    operation applied to each entry
+ * @param data  opaque pointer handed to @op
+ */
+
+void
+massop_apply_marked (WPanel *panel, massop_fn op, void *data)
+{
+    int current = 0;
+    size_t done = 0;
+    gint64 draw_timestamp = 0;
+
+    while (panel->marked != 0)
+    {
+        const GString *fname;
+        vfs_path_t *vpath;
+        gboolean ok;
+
+        fname = panel_find_marked_file (panel, &current);
+        if (fname == NULL)
+            break;
+
+        vpath = vfs_path_from_str (fname->str);
+        ok = op (vpath, data);
+        vfs_path_free (vpath, TRUE);
+
+        if (!ok)
+            break;
+
+        do_file_mark (panel, current, 0);
+
+        if ((++done & 31) == 0)
+        {
+            if (mc_time_elapsed (&draw_timestamp, G_USEC_PER_SEC / 10))
+            {
+                widget_draw (WIDGET (panel));
+                mc_refresh ();
+            }
+
+            rotate_dash (TRUE);
+        }
+    }
+
+    rotate_dash (FALSE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
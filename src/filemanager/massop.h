@@ -0,0 +1,31 @@
+/** \file massop.h
+ *  \brief Header: batched applier shared by the mass attribute dialogs
+ */
+
+#ifndef MC__MASSOP_H
+#define MC__MASSOP_H
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"
+
+#include "panel.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/* Operation applied to one marked entry. Return TRUE to go on with the next entry
+   (the processed one loses its mark), FALSE to stop the batch keeping the mark. */
+typedef gboolean (*massop_fn) (const vfs_path_t *vpath, void *data);
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+void massop_apply_marked (WPanel *panel, massop_fn op, void *data);
+
+/*** inline functions ****************************************************************************/
+
+#endif
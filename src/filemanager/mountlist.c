@@ -332,7 +332,11 @@ struct fs_usage
 /*** file scope variables ************************************************************************/
 
 #ifdef HAVE_INFOMOUNT_LIST
+/* How long a parsed mount list stays fresh, in microseconds */
+#define MOUNT_LIST_MAX_AGE (10 * G_USEC_PER_SEC)
+
 static GSList *mc_mount_list = NULL;
+static gint64 mc_mount_list_timestamp = 0;  // monotonic time of the last read
 #endif
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1666,8 +1670,19 @@ void
 init_my_statfs (void)
 {
 #ifdef HAVE_INFOMOUNT_LIST
+    gint64 now;
+
+    /* Panels call this on every directory change. Re-reading and re-parsing the whole mount
+       table each time is costly on hosts with thousands of (auto)mounts and can block on dead
+       network mounts, while the table itself changes rarely — so keep the parsed list around
+       for a while. free_my_statfs() still forces a fresh read. */
+    now = g_get_monotonic_time ();
+    if (mc_mount_list != NULL && now - mc_mount_list_timestamp < MOUNT_LIST_MAX_AGE)
+        return;
+
     free_my_statfs ();
     mc_mount_list = read_file_system_list ();
+    mc_mount_list_timestamp = now;
 #endif
 }
 
@@ -141,6 +141,20 @@ typedef enum
     FILENAME_SCROLL_RIGHT = 4
 } filename_scroll_flag_t;
 
+/* One memoized display row: the per-column strings format_file() produced for
+   a file entry, valid as long as the entry, the row width and the horizontal
+   shift stay the same */
+typedef struct
+{
+    int width;                   // row width the cells were fitted to
+    unsigned int shift;          // panel->content_shift the cells were built with
+    int field_length;            // saved format_file() output parameter
+    unsigned int name_len_diff;  // the row's contribution to panel->max_shift
+    filename_scroll_flag_t res;  // saved format_file() return value
+    guint n_cells;
+    char **cells;  // one string per format item; NULL for separators
+} format_cache_row_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 static const char *string_file_name (const file_entry_t *fe, int len);
@@ -403,6 +417,7 @@ static const char *
 string_file_size (const file_entry_t *fe, int len)
 {
     static char buffer[BUF_TINY];
+    file_entry_t *ufe;
 
     // Don't ever show size of ".." since we don't calculate it
     if (DIR_IS_DOTDOT (fe->fname->str))
@@ -410,12 +425,34 @@ string_file_size (const file_entry_t *fe, int len)
 
 #ifdef HAVE_STRUCT_STAT_ST_RDEV
     if (S_ISBLK (fe->st.st_mode) || S_ISCHR (fe->st.st_mode))
+    {
         format_device_number (buffer, len + 1, fe->st.st_rdev);
-    else
+        return buffer;
+    }
 #endif
+
+    if (len + 1 > (int) sizeof (fe->size_str))
+    {
+        // column too wide for the memo (not a layout mc itself produces)
         size_trunc_len (buffer, (unsigned int) len, fe->st.st_size, 0, panels_options.kilobyte_si);
+        return buffer;
+    }
 
-    return buffer;
+    // memo write-back: entries are formatted far more often than they change
+    ufe = (file_entry_t *) fe;
+
+    if (ufe->size_str[0] == '\0' || ufe->size_str_size != (uintmax_t) fe->st.st_size
+        || ufe->size_str_len != (unsigned char) len
+        || ufe->size_str_si != (unsigned char) (panels_options.kilobyte_si ? 1 : 0))
+    {
+        size_trunc_len (ufe->size_str, (unsigned int) len, fe->st.st_size, 0,
+                        panels_options.kilobyte_si);
+        ufe->size_str_size = (uintmax_t) fe->st.st_size;
+        ufe->size_str_len = (unsigned char) len;
+        ufe->size_str_si = (unsigned char) (panels_options.kilobyte_si ? 1 : 0);
+    }
+
+    return ufe->size_str;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -681,6 +718,37 @@ panel_items (const WPanel *p)
     return panel_lines (p) * p->list_cols;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+format_cache_row_free (gpointer data)
+{
+    format_cache_row_t *row = (format_cache_row_t *) data;
+
+    if (row != NULL)
+    {
+        guint i;
+
+        for (i = 0; i < row->n_cells; i++)
+            g_free (row->cells[i]);
+        g_free (row->cells);
+        g_free (row);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Drop the memoized display row of a single file entry */
+
+static void
+format_cache_drop (WPanel *panel, int file_index)
+{
+    if (panel->format_cache != NULL && (guint) file_index < panel->format_cache->len)
+    {
+        format_cache_row_free (g_ptr_array_index (panel->format_cache, file_index));
+        g_ptr_array_index (panel->format_cache, file_index) = NULL;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /** Formats the file number file_index of panel in the buffer dest */
 
@@ -692,6 +760,9 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
     int length = 0;
     GSList *format, *home;
     file_entry_t *fe = NULL;
+    format_cache_row_t *row = NULL;
+    gboolean row_valid = FALSE;
+    guint cell_i = 0;
     filename_scroll_flag_t res = FILENAME_NOSCROLL;
 
     *field_length = 0;
@@ -704,7 +775,41 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
 
     home = isstatus ? panel->status_format : panel->format;
 
-    for (format = home; format != NULL && length != width; format = g_slist_next (format))
+    /* The status line is transient, but file rows repeat on every repaint:
+       memoize their formatted cells and replay them while the row content,
+       the width and the horizontal shift stay the same. Attributes are not
+       part of the key - they only affect colors, which are applied below
+       either way */
+    if (!isstatus && fe != NULL)
+    {
+        if (panel->format_cache == NULL)
+            panel->format_cache = g_ptr_array_new_with_free_func (format_cache_row_free);
+        while (panel->format_cache->len <= (guint) file_index)
+            g_ptr_array_add (panel->format_cache, NULL);
+
+        row = g_ptr_array_index (panel->format_cache, file_index);
+        row_valid = row != NULL && row->width == width && row->shift == panel->content_shift;
+
+        if (row_valid)
+        {
+            // max_shift is recomputed from scratch on every full repaint
+            panel->max_shift = MAX (panel->max_shift, row->name_len_diff);
+            *field_length = row->field_length;
+            res = row->res;
+        }
+        else
+        {
+            format_cache_row_free (row);
+            row = g_new0 (format_cache_row_t, 1);
+            row->width = width;
+            row->shift = panel->content_shift;
+            row->n_cells = g_slist_length (home);
+            row->cells = g_new0 (char *, row->n_cells);
+            g_ptr_array_index (panel->format_cache, file_index) = row;
+        }
+    }
+
+    for (format = home; format != NULL && length != width; format = g_slist_next (format), cell_i++)
     {
         format_item_t *fi = (format_item_t *) format->data;
 
@@ -715,35 +820,53 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
             const char *prepared_text;
             int name_offset = 0;
 
-            if (fe != NULL)
-                txt = fi->string_fn (fe, fi->field_len);
-
             len = fi->field_len;
             if (len + length > width)
                 len = width - length;
             if (len <= 0)
                 break;
 
-            if (!isstatus && strcmp (fi->id, "name") == 0)
+            if (row_valid)
+                /* a replayed row breaks out of the loop at the same cell the
+                   original did, so every cell reached here is filled in */
+                prepared_text = row->cells[cell_i];
+            else
             {
-                const int str_len = str_length (txt);
-                const unsigned int len_diff = (unsigned int) DOZ (str_len, len);
+                if (fe != NULL)
+                    txt = fi->string_fn (fe, fi->field_len);
 
-                *field_length = len + 1;
+                if (!isstatus && strcmp (fi->id, "name") == 0)
+                {
+                    const int str_len = str_length (txt);
+                    const unsigned int len_diff = (unsigned int) DOZ (str_len, len);
 
-                panel->max_shift = MAX (panel->max_shift, len_diff);
+                    *field_length = len + 1;
 
-                if (len_diff != 0)
-                {
-                    const unsigned int shift = MIN (panel->content_shift, len_diff);
+                    panel->max_shift = MAX (panel->max_shift, len_diff);
+                    if (row != NULL)
+                        row->name_len_diff = len_diff;
 
-                    if (shift != 0)
-                        res |= FILENAME_SCROLL_LEFT;
+                    if (len_diff != 0)
+                    {
+                        const unsigned int shift = MIN (panel->content_shift, len_diff);
 
-                    name_offset = str_offset_to_pos (txt, shift);
-                    if (str_length (txt + name_offset) > len)
-                        res |= FILENAME_SCROLL_RIGHT;
+                        if (shift != 0)
+                            res |= FILENAME_SCROLL_LEFT;
+
+                        name_offset = str_offset_to_pos (txt, shift);
+                        if (str_length (txt + name_offset) > len)
+                            res |= FILENAME_SCROLL_RIGHT;
+                    }
                 }
+
+                if (!isstatus)
+                    prepared_text =
+                        str_fit_to_term (txt + name_offset, len, HIDE_FIT (fi->just_mode));
+                else
+                    prepared_text = str_fit_to_term (txt, len, fi->just_mode);
+
+                if (row != NULL)
+                    prepared_text = row->cells[cell_i] = g_strdup (prepared_text);
             }
 
             if (panels_options.permission_mode)
@@ -759,11 +882,6 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
             else
                 tty_lowlevel_setcolor (-color);
 
-            if (!isstatus)
-                prepared_text = str_fit_to_term (txt + name_offset, len, HIDE_FIT (fi->just_mode));
-            else
-                prepared_text = str_fit_to_term (txt, len, fi->just_mode);
-
             if (perm != 0 && fe != NULL)
                 add_permission_string (prepared_text, fi->field_len, fe, attr, color, perm != 1);
             else
@@ -782,6 +900,12 @@ format_file (WPanel *panel, int file_index, int width, file_attr_t attr, gboolea
         }
     }
 
+    if (row != NULL && !row_valid)
+    {
+        row->field_length = *field_length;
+        row->res = res;
+    }
+
     if (length < width)
     {
         int y, x;
@@ -965,6 +1089,31 @@ display_mini_info (WPanel *panel)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Accumulate a dirty file row. If the panel is already scheduled for a full redraw the
+ * range is ignored; otherwise the redraw in panel_repaint_dirty() is narrowed to the
+ * dirty rows and the mini status line.
+ */
+
+static void
+panel_dirty_file (WPanel *panel, int file_index)
+{
+    if (!panel->dirty)
+    {
+        panel->dirty = TRUE;
+        panel->dirty_rows_only = TRUE;
+        panel->dirty_first = file_index;
+        panel->dirty_last = file_index;
+    }
+    else if (panel->dirty_rows_only)
+    {
+        panel->dirty_first = MIN (panel->dirty_first, file_index);
+        panel->dirty_last = MAX (panel->dirty_last, file_index);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 paint_dir (WPanel *panel)
 {
@@ -998,6 +1147,40 @@ paint_dir (WPanel *panel)
     tty_set_normal_attrs ();
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Repaint only the rows recorded by panel_dirty_file(), plus the mini status line. */
+
+static void
+panel_paint_dirty_rows (WPanel *panel)
+{
+    const int items = panel_items (panel);
+    int first, last, n;
+
+    first = MAX (panel->dirty_first, panel->top);
+    last = MIN (panel->dirty_last, panel->top + items - 1);
+
+    for (n = first; n <= last; n++)
+    {
+        file_attr_t attr = FATTR_NORMAL;  // Color value of the line
+
+        if (n < panel->dir.len)
+        {
+            const gboolean marked = (panel->dir.list[n].f.marked != 0);
+
+            if (panel->current == n && panel->active)
+                attr = marked ? FATTR_MARKED_CURRENT : FATTR_CURRENT;
+            else if (marked)
+                attr = FATTR_MARKED;
+        }
+
+        repaint_file (panel, n, attr);
+    }
+
+    tty_set_normal_attrs ();
+    // marked totals live in the mini status - keep it in sync
+    display_mini_info (panel);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void
@@ -1231,6 +1414,9 @@ show_dir (const WPanel *panel)
         }
     }
 
+    if (panel->tabs != NULL && panel->tabs->len > 1)
+        tty_printf (" %u/%u ", panel->tab_current + 1, panel->tabs->len);
+
     if (panel->active)
         tty_setcolor (REVERSE_COLOR);
 
@@ -1426,9 +1612,16 @@ panel_destroy (WPanel *p)
         g_free (p->user_status_format[i]);
 
     g_free (p->name);
+    g_free (p->saved_current_file);
 
     panelized_descr_free (p->panelized_descr);
 
+    if (p->format_cache != NULL)
+        g_ptr_array_free (p->format_cache, TRUE);
+
+    if (p->tabs != NULL)
+        g_ptr_array_free (p->tabs, TRUE);
+
     g_string_free (p->quick_search.buffer, TRUE);
     g_string_free (p->quick_search.prev_buffer, TRUE);
 
@@ -1771,7 +1964,7 @@ use_display_format (WPanel *panel, const char *format, char **error, gboolean is
     if (*error != NULL)
         return NULL;
 
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
 
     usable_columns = WIDGET (panel)->rect.cols - 2;
     // Status needn't to be split
@@ -2037,7 +2230,7 @@ panel_set_current (WPanel *panel, int i)
 {
     if (i != panel->current)
     {
-        panel->dirty = TRUE;
+        panel_set_dirty (panel);
         panel->current = i;
         panel->top = panel->current - (WIDGET (panel)->rect.lines - 2) / 2;
         if (panel->top < 0)
@@ -2616,28 +2809,48 @@ panel_select_unselect_files (WPanel *panel, const char *title, const char *histo
                              const char *help_section, gboolean do_select)
 {
     mc_search_t *search;
+    char *reg_exp = NULL;
     gboolean files_only;
+    gboolean literal;
     int i;
 
     search = panel_select_unselect_files_dialog (&panels_options.select_flags, title, history_name,
-                                                 help_section, NULL);
+                                                 help_section, &reg_exp);
     if (search == NULL || search == SELECT_RESET || search == SELECT_ERROR)
+    {
+        g_free (reg_exp);
         return;
+    }
 
     files_only = (panels_options.select_flags & SELECT_FILES_ONLY) != 0;
 
+    /* A shell pattern without metacharacters can only match the name itself: compare
+       directly and keep the regex engine out of the loop. Case-insensitive matching
+       stays with the engine, which knows about multibyte case folding */
+    literal = (panels_options.select_flags & SELECT_SHELL_PATTERNS) != 0
+        && (panels_options.select_flags & SELECT_MATCH_CASE) != 0
+        && strpbrk (reg_exp, "*?,{}[]|\\") == NULL;
+
     for (i = 0; i < panel->dir.len; i++)
     {
+        gboolean found;
+
         if (DIR_IS_DOTDOT (panel->dir.list[i].fname->str))
             continue;
         if (S_ISDIR (panel->dir.list[i].st.st_mode) && files_only)
             continue;
 
-        if (mc_search_run (search, panel->dir.list[i].fname->str, 0, panel->dir.list[i].fname->len,
-                           NULL))
+        if (literal)
+            found = strcmp (panel->dir.list[i].fname->str, reg_exp) == 0;
+        else
+            found = mc_search_run (search, panel->dir.list[i].fname->str, 0,
+                                   panel->dir.list[i].fname->len, NULL);
+
+        if (found)
             do_file_mark (panel, i, do_select ? 1 : 0);
     }
 
+    g_free (reg_exp);
     mc_search_free (search);
 }
 
@@ -3062,6 +3275,135 @@ panel_sync_other (const WPanel *panel)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+panel_tab_free (gpointer data)
+{
+    panel_tab_t *tab = (panel_tab_t *) data;
+
+    vfs_path_free (tab->dir_vpath, TRUE);
+    g_free (tab->current_file);
+    g_free (tab);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Refresh the current tab slot from the live panel state */
+
+static void
+panel_tab_store (WPanel *panel)
+{
+    panel_tab_t *tab;
+    const file_entry_t *fe;
+
+    if (panel->tabs == NULL)
+        return;
+
+    tab = g_ptr_array_index (panel->tabs, panel->tab_current);
+    vfs_path_free (tab->dir_vpath, TRUE);
+    tab->dir_vpath = vfs_path_clone (panel->cwd_vpath);
+
+    MC_PTR_FREE (tab->current_file);
+    fe = panel_current_entry (panel);
+    if (fe != NULL)
+        tab->current_file = g_strndup (fe->fname->str, fe->fname->len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Switch the panel to tab @idx. The listing of the left directory is parked in
+ * the dir_list snapshot cache on the way out and the target one is revived
+ * from there, so switching between recently shown directories does not rescan.
+ */
+
+static void
+panel_tab_go (WPanel *panel, guint idx)
+{
+    const panel_tab_t *tab;
+
+    if (panel->tabs == NULL || idx >= panel->tabs->len || idx == panel->tab_current)
+        return;
+
+    panel_tab_store (panel);
+    panel->tab_current = idx;
+
+    tab = g_ptr_array_index (panel->tabs, idx);
+    if (!panel_do_cd (panel, tab->dir_vpath, cd_exact))
+        cd_error_message (vfs_path_as_str (tab->dir_vpath));
+    else if (tab->current_file != NULL)
+        panel_set_current_by_name (panel, tab->current_file);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Open a new tab showing the current directory and switch to it */
+
+static void
+panel_tab_new (WPanel *panel)
+{
+    panel_tab_t *tab;
+
+    if (panel->tabs == NULL)
+    {
+        // the first slot stands for the directory shown so far
+        panel->tabs = g_ptr_array_new_with_free_func (panel_tab_free);
+        g_ptr_array_add (panel->tabs, g_new0 (panel_tab_t, 1));
+        panel->tab_current = 0;
+    }
+
+    panel_tab_store (panel);
+
+    tab = g_new0 (panel_tab_t, 1);
+    tab->dir_vpath = vfs_path_clone (panel->cwd_vpath);
+    g_ptr_array_insert (panel->tabs, (gint) panel->tab_current + 1, tab);
+    panel->tab_current++;
+
+    panel_tab_store (panel);
+    // only the header changes - the new tab shows the same listing
+    panel_set_dirty (panel);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+panel_tab_close (WPanel *panel)
+{
+    if (panel->tabs == NULL || panel->tabs->len < 2)
+        return;
+
+    g_ptr_array_remove_index (panel->tabs, panel->tab_current);
+    if (panel->tab_current >= panel->tabs->len)
+        panel->tab_current = panel->tabs->len - 1;
+
+    {
+        const panel_tab_t *tab = g_ptr_array_index (panel->tabs, panel->tab_current);
+
+        if (!panel_do_cd (panel, tab->dir_vpath, cd_exact))
+            cd_error_message (vfs_path_as_str (tab->dir_vpath));
+        else if (tab->current_file != NULL)
+            panel_set_current_by_name (panel, tab->current_file);
+    }
+
+    panel_set_dirty (panel);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+panel_tab_next (WPanel *panel)
+{
+    if (panel->tabs != NULL && panel->tabs->len > 1)
+        panel_tab_go (panel, (panel->tab_current + 1) % panel->tabs->len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+panel_tab_prev (WPanel *panel)
+{
+    if (panel->tabs != NULL && panel->tabs->len > 1)
+        panel_tab_go (panel, (panel->tab_current + panel->tabs->len - 1) % panel->tabs->len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 chdir_to_readlink (WPanel *panel)
 {
@@ -3437,11 +3779,13 @@ panel_do_cd_int (WPanel *panel, const vfs_path_t *new_dir_vpath, enum cd_enum cd
     subshell_chdir (panel->cwd_vpath);
 #endif
 
-    // Reload current panel
+    // Reload current panel; a snapshot parked on the way out comes back instantly
     panel_clean_dir (panel);
 
-    if (!dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
-                        &panel->sort_info, &panel->filter))
+    if (!dir_list_cache_take (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
+                              &panel->sort_info, &panel->filter)
+        && !dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
+                           &panel->sort_info, &panel->filter))
         message (D_ERROR, MSG_ERROR, _ ("Cannot read directory contents"));
 
     if (panel->dir.len == 0)
@@ -3450,7 +3794,7 @@ panel_do_cd_int (WPanel *panel, const vfs_path_t *new_dir_vpath, enum cd_enum cd
     panel_set_current_by_name (panel, get_parent_dir_name (panel->cwd_vpath, olddir_vpath));
 
     load_hint (FALSE);
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
     update_xterm_title_path ();
     update_terminal_cwd ();
 
@@ -3732,6 +4076,18 @@ panel_execute_cmd (WPanel *panel, long command)
     case CK_PanelOtherSync:
         panel_sync_other (panel);
         break;
+    case CK_PanelTabNew:
+        panel_tab_new (panel);
+        break;
+    case CK_PanelTabClose:
+        panel_tab_close (panel);
+        break;
+    case CK_PanelTabNext:
+        panel_tab_next (panel);
+        break;
+    case CK_PanelTabPrev:
+        panel_tab_prev (panel);
+        break;
     case CK_Sort:
         panel_select_sort_order (panel);
         break;
@@ -3835,6 +4191,7 @@ panel_callback (Widget *w, Widget *sender, widget_msg_t msg, int parm, void *dat
         mini_info_separator (panel);
         display_mini_info (panel);
         panel->dirty = FALSE;
+        panel->dirty_rows_only = FALSE;
         return MSG_HANDLED;
 
     case MSG_FOCUS:
@@ -4175,8 +4532,7 @@ panel_mouse_callback (Widget *w, mouse_msg_t msg, mouse_event_t *event)
         break;
     }
 
-    if (panel->dirty)
-        widget_draw (w);
+    panel_repaint_dirty (panel);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -4196,7 +4552,16 @@ reload_panelized (WPanel *panel)
 
         vpath = vfs_path_from_str (list->list[i].fname->str);
         if (mc_lstat (vpath, &list->list[i].st) != 0)
-            g_string_free (list->list[i].fname, TRUE);
+        {
+            // arena-backed names are freed with the whole list, not one by one
+            if (list->list[i].f.fname_in_arena == 0)
+                g_string_free (list->list[i].fname, TRUE);
+            if (list->have_sort_keys)
+            {
+                str_release_key (list->list[i].name_sort_key, list->sort_keys_case_sen);
+                str_release_key (list->list[i].extension_sort_key, list->sort_keys_case_sen);
+            }
+        }
         else
         {
             if (j != i)
@@ -4210,6 +4575,7 @@ reload_panelized (WPanel *panel)
     else
         list->len = j;
 
+    panel_format_cache_invalidate (panel);
     recalculate_panel_summary (panel);
 
     if (panel != current_panel)
@@ -4250,7 +4616,7 @@ update_one_panel_widget (WPanel *panel, panel_update_flags_t flags, const char *
         panel_reload (panel, FALSE);
 
     panel_set_current_by_name (panel, current_file);
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
 
     if (free_pointer)
         g_free (my_current_file);
@@ -4472,6 +4838,23 @@ panel_set_current_by_name (WPanel *panel, const char *name)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Throw away all memoized display rows of the panel. Must be called whenever
+ * the file list content changes outside of file_mark(): reload, sort, format
+ * change, panelization, in-place entry updates.
+ *
+ * @param panel WPanel object
+ */
+
+void
+panel_format_cache_invalidate (WPanel *panel)
+{
+    if (panel->format_cache != NULL)
+        g_ptr_array_set_size (panel->format_cache, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 void
 panel_clean_dir (WPanel *panel)
 {
@@ -4482,11 +4865,13 @@ panel_clean_dir (WPanel *panel)
     panel->total = 0;
     panel->quick_search.active = FALSE;
     panel->is_panelized = FALSE;
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
     panel->content_shift = 0;
     panel->max_shift = 0;
+    panel_format_cache_invalidate (panel);
 
-    dir_list_free_list (&panel->dir);
+    // keep the old content around: coming back to that directory revives it
+    dir_list_cache_park (&panel->dir);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -4556,7 +4941,7 @@ panel_sized_empty_new (const char *panel_name, const WRect *r)
 
     panel->list_cols = 1;
     panel->brief_cols = 2;
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
     panel->content_shift = 0;
     panel->max_shift = 0;
 
@@ -4656,13 +5041,20 @@ panel_sized_with_dir_new (const char *panel_name, const WRect *r, const vfs_path
         panel->cwd_vpath = vfs_path_clone (vfs_get_raw_current_dir ());
     }
 
-    // Load the default format
-    if (!dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
-                        &panel->sort_info, &panel->filter))
+    // Load the default format; a snapshot parked by a previous panel incarnation counts
+    if (!dir_list_cache_take (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
+                              &panel->sort_info, &panel->filter)
+        && !dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
+                           &panel->sort_info, &panel->filter))
         message (D_ERROR, MSG_ERROR, _ ("Cannot read directory contents"));
 
     if (panel->dir.len == 0)
         panel_set_current (panel, -1);
+    else if (panel->saved_current_file != NULL)
+        // put the cursor where the previous session left it
+        panel_set_current_by_name (panel, panel->saved_current_file);
+
+    MC_PTR_FREE (panel->saved_current_file);
 
     // Restore old right path
     if (curdir != NULL)
@@ -4713,7 +5105,40 @@ panel_reload (WPanel *panel, gboolean force_reload)
                           &panel->sort_info, &panel->filter))
         message (D_ERROR, MSG_ERROR, _ ("Cannot read directory contents"));
 
-    panel->dirty = TRUE;
+    panel_format_cache_invalidate (panel);
+    panel_set_dirty (panel);
+
+    if (panel->dir.len == 0)
+        panel_set_current (panel, -1);
+    else if (panel->current >= panel->dir.len)
+        panel_set_current (panel, panel->dir.len - 1);
+
+    recalculate_panel_summary (panel);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Refresh only the given file names in the panel. Used by the directory watcher, which
+ * knows from the change events which entries are affected; falls back to a full reload
+ * if the list cannot be patched in place.
+ *
+ * @param panel WPanel object
+ * @param names changed file names relative to the panel directory
+ */
+
+void
+panel_reload_names (WPanel *panel, GPtrArray *names)
+{
+    if (!dir_list_update_names (&panel->dir, panel->cwd_vpath, names,
+                                panel->sort_field->sort_routine, &panel->sort_info,
+                                &panel->filter))
+    {
+        panel_reload (panel, TRUE);
+        return;
+    }
+
+    panel_format_cache_invalidate (panel);
+    panel_set_dirty (panel);
 
     if (panel->dir.len == 0)
         panel_set_current (panel, -1);
@@ -4765,6 +5190,7 @@ set_panel_formats (WPanel *p)
     }
 
     panel_update_cols (WIDGET (p), p->frame_size);
+    panel_format_cache_invalidate (p);
 
     if (retcode != 0)
         message (D_ERROR, _ ("Warning"),
@@ -4807,7 +5233,7 @@ select_item (WPanel *panel)
 {
     adjust_top_file (panel);
 
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
 
     execute_hooks (select_file_hook);
 }
@@ -4916,13 +5342,40 @@ panel_do_cd (WPanel *panel, const vfs_path_t *new_dir_vpath, enum cd_enum cd_typ
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Redraw a panel flagged as dirty. When only file rows changed (marking), repaint just
+ * those rows instead of erasing and rebuilding the whole panel.
+ *
+ * @param panel WPanel object
+ */
+
+void
+panel_repaint_dirty (WPanel *panel)
+{
+    if (!panel->dirty)
+        return;
+
+    if (panel->dirty_rows_only)
+    {
+        panel_paint_dirty_rows (panel);
+        panel->dirty = FALSE;
+        panel->dirty_rows_only = FALSE;
+    }
+    else
+        widget_draw (WIDGET (panel));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 void
 file_mark (WPanel *panel, int lc_index, int val)
 {
     if (panel->dir.list[lc_index].f.marked != val)
     {
         panel->dir.list[lc_index].f.marked = val;
-        panel->dirty = TRUE;
+        // the mark may be a display column of its own ("marked"), not just a color
+        format_cache_drop (panel, lc_index);
+        panel_dirty_file (panel, lc_index);
     }
 }
 
@@ -4990,6 +5443,7 @@ panel_re_sort (WPanel *panel)
     filename = g_strndup (fe->fname->str, fe->fname->len);
     unselect_item (panel);
     dir_list_sort (&panel->dir, panel->sort_field->sort_routine, &panel->sort_info);
+    panel_format_cache_invalidate (panel);
     panel->current = -1;
 
     for (i = panel->dir.len; i != 0; i--)
@@ -5002,7 +5456,7 @@ panel_re_sort (WPanel *panel)
     g_free (filename);
     panel->top = panel->current - panel_items (panel) / 2;
     select_item (panel);
-    panel->dirty = TRUE;
+    panel_set_dirty (panel);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -5356,12 +5810,17 @@ panel_panelize_restore (void)
         list->list[i].f.stale_link = plist->list[i].f.stale_link;
         list->list[i].f.dir_size_computed = plist->list[i].f.dir_size_computed;
         list->list[i].f.marked = plist->list[i].f.marked;
+        list->list[i].f.fname_in_arena = 0;
         list->list[i].st = plist->list[i].st;
-        list->list[i].name_sort_key = plist->list[i].name_sort_key;
-        list->list[i].extension_sort_key = plist->list[i].extension_sort_key;
+        // don't alias cached collation keys - they belong to the source list
+        list->list[i].name_sort_key = NULL;
+        list->list[i].extension_sort_key = NULL;
+        list->list[i].vers_prefixlen = -1;  // the name may have been absolutized above
+        list->list[i].fhl_serial = 0;
     }
 
     panel->is_panelized = TRUE;
+    panel_format_cache_invalidate (panel);
     panel_panelize_absolutize_if_needed (panel);
 
     panel_set_current_by_name (panel, NULL);
@@ -5456,9 +5915,13 @@ panel_panelize_save (WPanel *panel)
         plist->list[i].f.stale_link = list->list[i].f.stale_link;
         plist->list[i].f.dir_size_computed = list->list[i].f.dir_size_computed;
         plist->list[i].f.marked = list->list[i].f.marked;
+        plist->list[i].f.fname_in_arena = 0;
         plist->list[i].st = list->list[i].st;
-        plist->list[i].name_sort_key = list->list[i].name_sort_key;
-        plist->list[i].extension_sort_key = list->list[i].extension_sort_key;
+        // don't alias cached collation keys - they belong to the source list
+        plist->list[i].name_sort_key = NULL;
+        plist->list[i].extension_sort_key = NULL;
+        plist->list[i].vers_prefixlen = list->list[i].vers_prefixlen;
+        plist->list[i].fhl_serial = 0;
     }
 }
 
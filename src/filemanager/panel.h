@@ -77,6 +77,15 @@ typedef struct
     vfs_path_t *root_vpath;
 } panelized_descr_t;
 
+/* One directory tab of a panel: only the context is stored here - the listing
+   itself lives in the shared dir_list snapshot cache, so a directory shown in
+   several tabs (or both panels) is kept in memory only once */
+typedef struct
+{
+    vfs_path_t *dir_vpath;  // directory shown in the tab
+    char *current_file;     // cursor position to restore when switching back
+} panel_tab_t;
+
 typedef struct
 {
     Widget widget;
@@ -88,6 +97,13 @@ typedef struct
     gboolean active;  // If panel is currently selected
     gboolean dirty;   // Should we redisplay the panel?
 
+    /* When only file rows changed (marking), the redraw can be narrowed to this
+       inclusive range of file indexes instead of erasing the whole panel. Any
+       state change that touches the frame resets dirty_rows_only. */
+    gboolean dirty_rows_only;
+    int dirty_first;
+    int dirty_last;
+
     gboolean is_panelized;               // Panelization: special mode, can't reload the file list
     panelized_descr_t *panelized_descr;  // Panelization descriptor
 
@@ -121,6 +137,9 @@ typedef struct
 
     file_filter_t filter;  // File name filter
 
+    // Cursor position read from panels.ini; consumed by the first listing load
+    char *saved_current_file;
+
     struct
     {
         char *name;      // Directory history name for history file
@@ -139,6 +158,14 @@ typedef struct
 
     unsigned int content_shift;  // Number of characters of filename need to skip from left side
     unsigned int max_shift;      // Max shift for visible part of current panel
+
+    /* Memoized display rows: the formatted cell strings of painted file rows,
+       replayed on repaint until the row content changes. Created lazily, one
+       slot per file index */
+    GPtrArray *format_cache;
+
+    guint tab_current;  // index of the shown tab in ->tabs
+    GPtrArray *tabs;    // panel_tab_t ring; NULL until a second tab is opened
 } WPanel;
 
 /*** global variables defined in .c file *********************************************************/
@@ -155,6 +182,8 @@ WPanel *panel_sized_with_dir_new (const char *panel_name, const WRect *r, const
 void panel_clean_dir (WPanel *panel);
 
 void panel_reload (WPanel *panel, gboolean force_reload);
+void panel_reload_names (WPanel *panel, GPtrArray *names);
+void panel_format_cache_invalidate (WPanel *panel);
 void panel_set_sort_order (WPanel *panel, const panel_field_t *sort_order);
 void panel_re_sort (WPanel *panel);
 
@@ -173,6 +202,7 @@ void unmark_files (WPanel *panel);
 void select_item (WPanel *panel);
 
 void recalculate_panel_summary (WPanel *panel);
+void panel_repaint_dirty (WPanel *panel);
 void file_mark (WPanel *panel, int idx, int val);
 void do_file_mark (WPanel *panel, int idx, int val);
 const GString *panel_find_marked_file (const WPanel *panel, int *current_file);
@@ -202,6 +232,20 @@ void panel_deinit (void);
 
 /* --------------------------------------------------------------------------------------------- */
 /*** inline functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Request a full panel redraw (frame, header, rows and mini status).
+ *
+ * @param panel panel object
+ */
+
+static inline void
+panel_set_dirty (WPanel *panel)
+{
+    panel->dirty = TRUE;
+    panel->dirty_rows_only = FALSE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Empty panel creation.
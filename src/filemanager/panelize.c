@@ -303,6 +303,7 @@ do_external_panelize (const char *command)
     mc_pipe_t *external;
     GError *error = NULL;
     GString *remain_file_name = NULL;
+    gint64 draw_timestamp = 0;
 
     external = mc_popen (command, TRUE, TRUE, &error);
     if (external == NULL)
@@ -409,7 +410,17 @@ do_external_panelize (const char *command)
                     file_mark (current_panel, list->len - 1, 0);
 
                     if ((list->len & 31) == 0)
+                    {
+                        /* Show the entries collected so far (in arrival order, the final
+                           sort happens below), at most at the dash rotation rate */
+                        if (mc_time_elapsed (&draw_timestamp, G_USEC_PER_SEC / 10))
+                        {
+                            widget_draw (WIDGET (current_panel));
+                            mc_refresh ();
+                        }
+
                         rotate_dash (TRUE);
+                    }
                 }
             }
 
@@ -586,6 +586,18 @@ tree_move_to_bottom (WTree *tree)
 static void
 tree_chdir_sel (WTree *tree)
 {
+    if (tree->selected_ptr == NULL)
+        return;
+
+    /* The stored entry may be stale: a directory removed or renamed outside
+       mc is dropped here (the remove hook moves the selection off it) instead
+       of failing the chdir below */
+    if (tree_store_validate_entry (tree->selected_ptr->name) == NULL)
+    {
+        show_tree (tree);
+        return;
+    }
+
     if (tree->is_panel)
     {
         WPanel *p;
@@ -300,6 +300,9 @@ tree_store_load_from (const char *name)
         }
 
         fclose (file);
+
+        // what we've just read is what's on disk: no need to write it back unchanged
+        tree_store_dirty (FALSE);
     }
 
     // Nothing loaded, we add some standard directories
@@ -393,10 +396,19 @@ tree_store_add_entry (const vfs_path_t *name)
     if (ts.tree_last != NULL && ts.tree_last->next != NULL)
         abort ();
 
-    // Search for the correct place
-    for (current = ts.tree_first; current != NULL && (flag = pathcmp (current->name, name)) < 0;
-         current = current->next)
-        old = current;
+    /* Names usually arrive in sorted order — tree_store_load_from() reads a sorted file and
+       rescans walk directories alphabetically — so check the tail first: appending this way
+       costs one comparison instead of a walk over the whole list. */
+    if (ts.tree_last != NULL && pathcmp (ts.tree_last->name, name) < 0)
+    {
+        old = ts.tree_last;
+        current = NULL;
+    }
+    else
+        // Search for the correct place
+        for (current = ts.tree_first; current != NULL && (flag = pathcmp (current->name, name)) < 0;
+             current = current->next)
+            old = current;
 
     if (flag == 0)
         return current;  // Already in the list
@@ -653,6 +665,9 @@ tree_store_save (void)
     char *name;
     int retval;
 
+    if (!ts.dirty)
+        return 0;
+
     name = mc_config_get_full_path (MC_TREESTORE_FILE);
     mc_util_make_backup_if_possible (name, ".tmp");
 
@@ -940,3 +955,63 @@ tree_store_rescan (const vfs_path_t *vpath)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Validate a stored directory against the file system before it is used. A
+ * directory that vanished outside mc is dropped from the store together with
+ * its subtree; one whose content was invalidated by the directory watcher is
+ * rescanned, bounded to its direct children.
+ *
+ * @param vpath directory to validate
+ *
+ * @return the (possibly refreshed) entry, or NULL if the directory is gone
+ */
+
+tree_entry *
+tree_store_validate_entry (const vfs_path_t *vpath)
+{
+    tree_entry *entry;
+    struct stat st;
+
+    entry = tree_store_whereis (vpath);
+    if (entry == NULL)
+        return NULL;
+
+    // only local directories can be checked without a round trip
+    if (!vfs_file_is_local (vpath))
+        return entry;
+
+    if (mc_lstat (vpath, &st) != 0 || !S_ISDIR (st.st_mode))
+    {
+        tree_store_remove_entry (vpath);
+        return NULL;
+    }
+
+    if (!entry->scanned)
+        entry = tree_store_rescan (vpath);
+
+    return entry;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Note a change inside @vpath reported by the directory watcher: drop the
+ * "scanned" mark so that the next visit rescans just this directory instead
+ * of trusting the stored children. No file system access happens here.
+ *
+ * @param vpath directory the change was reported for
+ */
+
+void
+tree_store_invalidate (const vfs_path_t *vpath)
+{
+    tree_entry *entry;
+
+    entry = tree_store_whereis (vpath);
+    if (entry != NULL && entry->scanned)
+    {
+        entry->scanned = FALSE;
+        tree_store_dirty (TRUE);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
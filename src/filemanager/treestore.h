@@ -55,6 +55,8 @@ void tree_store_mark_checked (const char *subname);
 void tree_store_end_check (void);
 tree_entry *tree_store_whereis (const vfs_path_t *name);
 tree_entry *tree_store_rescan (const vfs_path_t *vpath);
+tree_entry *tree_store_validate_entry (const vfs_path_t *vpath);
+void tree_store_invalidate (const vfs_path_t *vpath);
 
 void tree_store_add_entry_remove_hook (tree_store_remove_fn callback, void *data);
 void tree_store_remove_entry_remove_hook (tree_store_remove_fn callback);
@@ -88,11 +88,25 @@ typedef struct Link_Area
     const char *link_name;
 } Link_Area;
 
+/* One painted run of the laid-out help screen */
+typedef struct
+{
+    int y, x;               // content coordinates, without the dialog frame
+    int color;              // color the run was laid out with
+    int acs_char;           // alternate character set: character to draw, -1 = text run
+    const char *link_name;  // runs inside a link: its CHAR_LINK_START position
+    GString *text;          // text to print; NULL for acs runs
+} help_run_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
 static char *fdata = NULL;             // Pointer to the loaded data file
+static char *fdata_request = NULL;     // Which file was requested for fdata ("" for the default)
+static char *fdata_path = NULL;        // Path of the file fdata was read from
+static time_t fdata_mtime = 0;         // Its mtime at load time
+static GHashTable *node_index = NULL;  // Node name -> position in fdata
 static int help_lines;                 // Lines in help viewer
 static int history_ptr = 0;            // For the history queue
 static const char *main_node;          // The main node
@@ -110,8 +124,16 @@ static struct
     const char *link;  // Pointer to the selected link
 } history[HISTORY_SIZE];
 
-static GSList *link_area = NULL;
-static gboolean inside_link_area = FALSE;
+/* Layout of the screen starting at layout_start: wrapping the node text and
+   building the link areas is redone only when the start position or the window
+   height changes; repaints (including link selection changes) just replay the
+   cached runs */
+static GArray *layout_runs = NULL;       // help_run_t items in paint order
+static GArray *layout_links = NULL;      // Link_Area items in document order
+static const char *layout_start = NULL;  // paint start the layout was computed for, NULL = none
+static int layout_lines = 0;             // help_lines at that time
+static const char *layout_last_shown = NULL;
+static gboolean layout_end_of_node = FALSE;
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
@@ -154,6 +176,33 @@ search_string (const char *start, const char *text)
     return result;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Looks up a node ("[Name]") in the loaded help file.
+ *
+ * Node positions never change while fdata is loaded, so the results of the
+ * linear search are memoized: topic jumps resolve the same few nodes over
+ * and over again.
+ */
+
+static const char *
+help_find_node (const char *node)
+{
+    const char *p;
+
+    if (node_index == NULL)
+        node_index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    p = g_hash_table_lookup (node_index, node);
+    if (p == NULL)
+    {
+        p = search_string (fdata, node);
+        if (p != NULL)
+            g_hash_table_insert (node_index, g_strdup (node), (gpointer) p);
+    }
+
+    return p;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /** Searches text in the buffer pointed by start.  Search ends
  * if the CHAR_NODE_END is found in the text.
@@ -313,7 +362,7 @@ help_follow_link (const char *start, const char *lc_selected_item)
             link_name[i++] = *++p;
         link_name[i - 1] = ']';
         link_name[i] = '\0';
-        p = search_string (fdata, link_name);
+        p = help_find_node (link_name);
         if (p != NULL)
         {
             p += 1;  // Skip the newline following the start of the node
@@ -355,53 +404,61 @@ select_prev_link (const char *current_link)
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-start_link_area (int x, int y, const char *link_name)
+help_run_clear (gpointer data)
 {
-    Link_Area *la;
+    help_run_t *run = (help_run_t *) data;
 
-    if (inside_link_area)
-        message (D_NORMAL, _ ("Warning"), "%s", _ ("Internal bug: Double start of link area"));
+    if (run->text != NULL)
+        g_string_free (run->text, TRUE);
+}
 
-    // Allocate memory for a new link area
-    la = g_new (Link_Area, 1);
-    // Save the beginning coordinates of the link area
-    la->x1 = x;
-    la->y1 = y;
-    // Save the name of the destination anchor
-    la->link_name = link_name;
-    link_area = g_slist_prepend (link_area, la);
+/* --------------------------------------------------------------------------------------------- */
 
-    inside_link_area = TRUE;
+static void
+help_layout_invalidate (void)
+{
+    layout_start = NULL;
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-end_link_area (int x, int y)
+help_layout_add_text (int y, int x, int color, const char *link_name, const char *text)
 {
-    if (inside_link_area)
-    {
-        Link_Area *la = (Link_Area *) link_area->data;
-        // Save the end coordinates of the link area
-        la->x2 = x;
-        la->y2 = y;
-        inside_link_area = FALSE;
-    }
+    help_run_t run;
+
+    run.y = y;
+    run.x = x;
+    run.color = color;
+    run.acs_char = -1;
+    run.link_name = link_name;
+    run.text = g_string_new (text);
+    g_array_append_val (layout_runs, run);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
 static void
-clear_link_areas (void)
+help_layout_add_acs (int y, int x, int color, int c)
 {
-    g_clear_slist (&link_area, g_free);
-    inside_link_area = FALSE;
+    help_run_t run;
+
+    run.y = y;
+    run.x = x;
+    run.color = color;
+    run.acs_char = c;
+    run.link_name = NULL;
+    run.text = NULL;
+    g_array_append_val (layout_runs, run);
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/** Place the accumulated word, wrapping to the next line when it does not fit.
+ * Same arithmetic help_print_word() used when layout and painting were one pass. */
 
 static void
-help_print_word (WDialog *h, GString *word, int *col, int *line, gboolean add_space)
+help_layout_word (GString *word, int *col, int *line, gboolean add_space, int color,
+                  const char *link_name)
 {
     if (*line >= help_lines)
         g_string_set_size (word, 0);
@@ -420,8 +477,8 @@ help_print_word (WDialog *h, GString *word, int *col, int *line, gboolean add_sp
             g_string_set_size (word, 0);
         else
         {
-            widget_gotoyx (h, *line + 2, *col + 2);
-            tty_print_string (word->str);
+            if (word->len != 0)
+                help_layout_add_text (*line, *col, color, link_name, word->str);
             g_string_set_size (word, 0);
             *col += w;
         }
@@ -431,7 +488,8 @@ help_print_word (WDialog *h, GString *word, int *col, int *line, gboolean add_sp
     {
         if (*col < HELP_WINDOW_WIDTH - 1)
         {
-            tty_print_char (' ');
+            if (*line < help_lines)
+                help_layout_add_text (*line, *col, color, link_name, " ");
             (*col)++;
         }
         else
@@ -443,163 +501,213 @@ help_print_word (WDialog *h, GString *word, int *col, int *line, gboolean add_sp
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/** Lay out one screen of the node text starting at @paint_start: wrap words,
+ * record the resulting runs and link areas. Painting-independent, so the result
+ * stays valid until the start position or the window height changes. */
 
 static void
-help_show (WDialog *h, const char *paint_start)
+help_layout_compute (const char *paint_start)
 {
     gboolean painting = TRUE;
-    gboolean repeat_paint;
-    int active_col, active_line;  // Active link position
+    gboolean acs = FALSE;  // Flag: Is alternate character set active?
+    gboolean in_link = FALSE;
+    int line = 0;
+    int col = 0;
+    int color = HELP_NORMAL_COLOR;
+    const char *link_name = NULL;
     char buff[MB_LEN_MAX + 1];
     GString *word;
+    const char *p, *n;
+    Link_Area la = { 0, 0, 0, 0, NULL };
 
-    word = g_string_sized_new (32);
-
-    tty_setcolor (HELP_NORMAL_COLOR);
-    do
+    if (layout_runs == NULL)
     {
-        int line = 0;
-        int col = 0;
-        gboolean acs = FALSE;  // Flag: Is alternate character set active?
-        const char *p, *n;
+        layout_runs = g_array_new (FALSE, FALSE, sizeof (help_run_t));
+        g_array_set_clear_func (layout_runs, help_run_clear);
+        layout_links = g_array_new (FALSE, FALSE, sizeof (Link_Area));
+    }
+    g_array_set_size (layout_runs, 0);
+    g_array_set_size (layout_links, 0);
 
-        active_col = 0;
-        active_line = 0;
+    word = g_string_sized_new (32);
 
-        repeat_paint = FALSE;
+    p = paint_start;
+    n = paint_start;
+    while ((n[0] != '\0') && (n[0] != CHAR_NODE_END) && (line < help_lines))
+    {
+        int c;
 
-        clear_link_areas ();
-        if ((int) (selected_item - paint_start) < 0)
-            selected_item = NULL;
+        p = n;
+        n = str_cget_next_char (p);
+        memcpy (buff, p, n - p);
+        buff[n - p] = '\0';
 
-        p = paint_start;
-        n = paint_start;
-        while ((n[0] != '\0') && (n[0] != CHAR_NODE_END) && (line < help_lines))
+        c = (unsigned char) buff[0];
+        switch (c)
         {
-            int c;
-
-            p = n;
-            n = str_cget_next_char (p);
-            memcpy (buff, p, n - p);
-            buff[n - p] = '\0';
-
-            c = (unsigned char) buff[0];
-            switch (c)
+        case CHAR_LINK_START:
+            link_name = p;
+            la.x1 = col;
+            la.y1 = line;
+            la.link_name = p;
+            in_link = TRUE;
+            break;
+        case CHAR_LINK_POINTER:
+            painting = FALSE;
+            break;
+        case CHAR_LINK_END:
+            painting = TRUE;
+            help_layout_word (word, &col, &line, FALSE, color, link_name);
+            if (in_link)
             {
-            case CHAR_LINK_START:
-                if (selected_item == NULL)
-                    selected_item = p;
-                if (p != selected_item)
-                    tty_setcolor (HELP_LINK_COLOR);
-                else
-                {
-                    tty_setcolor (HELP_SLINK_COLOR);
-
-                    // Store the coordinates of the link
-                    active_col = col + 2;
-                    active_line = line + 2;
-                }
-                start_link_area (col, line, p);
-                break;
-            case CHAR_LINK_POINTER:
-                painting = FALSE;
-                break;
-            case CHAR_LINK_END:
-                painting = TRUE;
-                help_print_word (h, word, &col, &line, FALSE);
-                end_link_area (col - 1, line);
-                tty_setcolor (HELP_NORMAL_COLOR);
-                break;
-            case CHAR_ALTERNATE:
-                acs = TRUE;
-                break;
-            case CHAR_NORMAL:
-                acs = FALSE;
-                break;
-            case CHAR_VERSION:
-                widget_gotoyx (h, line + 2, col + 2);
-                tty_print_string (mc_global.mc_version);
-                col += str_term_width1 (mc_global.mc_version);
-                break;
-            case CHAR_FONT_BOLD:
-                tty_setcolor (HELP_BOLD_COLOR);
-                break;
-            case CHAR_FONT_ITALIC:
-                tty_setcolor (HELP_ITALIC_COLOR);
-                break;
-            case CHAR_FONT_NORMAL:
-                help_print_word (h, word, &col, &line, FALSE);
-                tty_setcolor (HELP_NORMAL_COLOR);
-                break;
-            case '\n':
-                if (painting)
-                    help_print_word (h, word, &col, &line, FALSE);
-                line++;
-                col = 0;
-                break;
-            case ' ':
-            case '\t':
-                // word delimiter
-                if (painting)
+                la.x2 = col - 1;
+                la.y2 = line;
+                g_array_append_val (layout_links, la);
+                in_link = FALSE;
+            }
+            link_name = NULL;
+            color = HELP_NORMAL_COLOR;
+            break;
+        case CHAR_ALTERNATE:
+            acs = TRUE;
+            break;
+        case CHAR_NORMAL:
+            acs = FALSE;
+            break;
+        case CHAR_VERSION:
+            help_layout_add_text (line, col, color, link_name, mc_global.mc_version);
+            col += str_term_width1 (mc_global.mc_version);
+            break;
+        case CHAR_FONT_BOLD:
+            color = HELP_BOLD_COLOR;
+            break;
+        case CHAR_FONT_ITALIC:
+            color = HELP_ITALIC_COLOR;
+            break;
+        case CHAR_FONT_NORMAL:
+            help_layout_word (word, &col, &line, FALSE, color, link_name);
+            color = HELP_NORMAL_COLOR;
+            break;
+        case '\n':
+            if (painting)
+                help_layout_word (word, &col, &line, FALSE, color, link_name);
+            line++;
+            col = 0;
+            break;
+        case ' ':
+        case '\t':
+            // word delimiter
+            if (painting)
+            {
+                help_layout_word (word, &col, &line, c == ' ', color, link_name);
+                if (c == '\t')
                 {
-                    help_print_word (h, word, &col, &line, c == ' ');
-                    if (c == '\t')
+                    col = (col / 8 + 1) * 8;
+                    if (col >= HELP_WINDOW_WIDTH)
                     {
-                        col = (col / 8 + 1) * 8;
-                        if (col >= HELP_WINDOW_WIDTH)
-                        {
-                            line++;
-                            col = 8;
-                        }
+                        line++;
+                        col = 8;
                     }
                 }
-                break;
-            default:
-                if (painting && (line < help_lines))
+            }
+            break;
+        default:
+            if (painting && (line < help_lines))
+            {
+                if (!acs)
+                    // accumulate symbols in a word
+                    g_string_append (word, buff);
+                else if (col < HELP_WINDOW_WIDTH)
                 {
-                    if (!acs)
-                        // accumulate symbols in a word
-                        g_string_append (word, buff);
-                    else if (col < HELP_WINDOW_WIDTH)
-                    {
-                        widget_gotoyx (h, line + 2, col + 2);
-
-                        if ((c == ' ') || (c == '.'))
-                            tty_print_char (c);
-                        else
-#ifndef HAVE_SLANG
-                            tty_print_char (acs_map[c]);
-#else
-                            SLsmg_draw_object (WIDGET (h)->rect.y + line + 2,
-                                               WIDGET (h)->rect.x + col + 2, c);
-#endif
-                        col++;
-                    }
+                    if ((c == ' ') || (c == '.'))
+                        help_layout_add_text (line, col, color, link_name, buff);
+                    else
+                        help_layout_add_acs (line, col, color, c);
+                    col++;
                 }
             }
         }
+    }
 
-        // print last word
-        if (n[0] == CHAR_NODE_END)
-            help_print_word (h, word, &col, &line, FALSE);
+    // place the last word
+    if (n[0] == CHAR_NODE_END)
+        help_layout_word (word, &col, &line, FALSE, color, link_name);
 
-        last_shown = p;
-        end_of_node = line < help_lines;
-        tty_setcolor (HELP_NORMAL_COLOR);
-        if ((int) (selected_item - last_shown) >= 0)
+    g_string_free (word, TRUE);
+
+    layout_start = paint_start;
+    layout_lines = help_lines;
+    layout_last_shown = p;
+    layout_end_of_node = line < help_lines;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+help_show (WDialog *h, const char *paint_start)
+{
+    int active_col = 0, active_line = 0;  // Active link position
+    guint i;
+
+    if (layout_start != paint_start || layout_lines != help_lines)
+        help_layout_compute (paint_start);
+
+    /* decide which link is selected; the painter used to do this on the fly,
+       repainting the whole screen when the choice turned out wrong */
+    if (selected_item != NULL && (int) (selected_item - paint_start) < 0)
+        selected_item = NULL;
+    if (selected_item == NULL && layout_links->len != 0)
+        selected_item = g_array_index (layout_links, Link_Area, 0).link_name;
+    if (selected_item != NULL && (int) (selected_item - layout_last_shown) >= 0)
+        selected_item = layout_links->len == 0
+            ? NULL
+            : g_array_index (layout_links, Link_Area, layout_links->len - 1).link_name;
+
+    tty_setcolor (HELP_NORMAL_COLOR);
+
+    for (i = 0; i < layout_runs->len; i++)
+    {
+        const help_run_t *run = &g_array_index (layout_runs, help_run_t, i);
+
+        if (run->link_name != NULL)
         {
-            if ((link_area == NULL) || (link_area->data == NULL))
-                selected_item = NULL;
+            if (run->link_name != selected_item)
+                tty_setcolor (HELP_LINK_COLOR);
             else
             {
-                selected_item = ((Link_Area *) link_area->data)->link_name;
-                repeat_paint = TRUE;
+                tty_setcolor (HELP_SLINK_COLOR);
+
+                // Store the coordinates of the link
+                if (active_col == 0)
+                {
+                    active_col = run->x + 2;
+                    active_line = run->y + 2;
+                }
             }
         }
+        else
+            tty_setcolor (run->color);
+
+        if (run->text != NULL)
+        {
+            widget_gotoyx (h, run->y + 2, run->x + 2);
+            tty_print_string (run->text->str);
+        }
+        else
+        {
+#ifndef HAVE_SLANG
+            widget_gotoyx (h, run->y + 2, run->x + 2);
+            tty_print_char (acs_map[run->acs_char]);
+#else
+            SLsmg_draw_object (WIDGET (h)->rect.y + run->y + 2, WIDGET (h)->rect.x + run->x + 2,
+                               run->acs_char);
+#endif
+        }
     }
-    while (repeat_paint);
 
-    g_string_free (word, TRUE);
+    last_shown = layout_last_shown;
+    end_of_node = layout_end_of_node;
+    tty_setcolor (HELP_NORMAL_COLOR);
 
     // Position the cursor over a nice link
     if (active_col != 0)
@@ -618,7 +726,7 @@ help_help (WDialog *h)
     history[history_ptr].page = currentpoint;
     history[history_ptr].link = selected_item;
 
-    p = search_string (fdata, "[How to use help]");
+    p = help_find_node ("[How to use help]");
     if (p != NULL)
     {
         currentpoint = p + 1;  // Skip the newline following the start of the node
@@ -634,7 +742,7 @@ help_index (WDialog *h)
 {
     const char *new_item;
 
-    new_item = search_string (fdata, "[Contents]");
+    new_item = help_find_node ("[Contents]");
 
     if (new_item == NULL)
         message (D_ERROR, MSG_ERROR, _ ("Cannot find node %s in help file"), "[Contents]");
@@ -702,8 +810,9 @@ help_prev_link (gboolean move_up)
     {
         if (move_up)
             move_backward (1);
-        else if ((link_area != NULL) && (link_area->data != NULL))
-            selected_item = ((Link_Area *) link_area->data)->link_name;
+        else if (layout_links != NULL && layout_links->len != 0)
+            selected_item =
+                g_array_index (layout_links, Link_Area, layout_links->len - 1).link_name;
         else
             selected_item = NULL;
     }
@@ -937,7 +1046,8 @@ help_callback (Widget *w, Widget *sender, widget_msg_t msg, int parm, void *data
 static void
 interactive_display_finish (void)
 {
-    clear_link_areas ();
+    // screen coordinates in the cached layout belong to the closed dialog
+    help_layout_invalidate ();
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -988,7 +1098,8 @@ static void
 help_mouse_callback (Widget *w, mouse_msg_t msg, mouse_event_t *event)
 {
     int x, y;
-    GSList *current_area;
+    const Link_Area *found = NULL;
+    guint i;
 
     if (msg != MSG_MOUSE_CLICK)
         return;
@@ -1007,34 +1118,29 @@ help_mouse_callback (Widget *w, mouse_msg_t msg, mouse_event_t *event)
     y = event->y - 1;
 
     // Test whether the mouse click is inside one of the link areas
-    for (current_area = link_area; current_area != NULL; current_area = g_slist_next (current_area))
-    {
-        Link_Area *la = (Link_Area *) current_area->data;
-
-        // Test one line link area
-        if (y == la->y1 && x >= la->x1 && y == la->y2 && x <= la->x2)
-            break;
-
-        // Test two line link area
-        if (la->y1 + 1 == la->y2)
+    if (layout_links != NULL)
+        for (i = 0; i < layout_links->len && found == NULL; i++)
         {
-            // The first line || The second line
-            if ((y == la->y1 && x >= la->x1) || (y == la->y2 && x <= la->x2))
-                break;
+            const Link_Area *la = &g_array_index (layout_links, Link_Area, i);
+
+            // Test one line link area
+            if (y == la->y1 && x >= la->x1 && y == la->y2 && x <= la->x2)
+                found = la;
+            /* Test two line link area: the first line || the second line.
+               Mouse will not work with link areas of more than two lines */
+            else if (la->y1 + 1 == la->y2
+                     && ((y == la->y1 && x >= la->x1) || (y == la->y2 && x <= la->x2)))
+                found = la;
         }
-        // Mouse will not work with link areas of more than two lines
-    }
 
     // Test whether a link area was found
-    if (current_area != NULL)
+    if (found != NULL)
     {
-        Link_Area *la = (Link_Area *) current_area->data;
-
         // The click was inside a link area -> follow the link
         history_ptr = (history_ptr + 1) % HISTORY_SIZE;
         history[history_ptr].page = currentpoint;
-        history[history_ptr].link = la->link_name;
-        currentpoint = help_follow_link (currentpoint, la->link_name);
+        history[history_ptr].link = found->link_name;
+        currentpoint = help_follow_link (currentpoint, found->link_name);
         selected_item = NULL;
     }
     else if (y < 0)
@@ -1086,7 +1192,9 @@ help_interactive_display (const gchar *event_group_name, const gchar *event_name
     WButtonBar *help_bar;
     Widget *md;
     char *hlpfile = NULL;
-    char *filedata;
+    char *filedata = NULL;
+    const char *request;
+    struct stat st;
     ev_help_t *event_data = (ev_help_t *) data;
     WRect r = { 1, 1, 1, 1 };
     int i;
@@ -1095,38 +1203,63 @@ help_interactive_display (const gchar *event_group_name, const gchar *event_name
     (void) event_name;
     (void) init_data;
 
-    if (event_data->filename != NULL)
-        g_file_get_contents (event_data->filename, &filedata, NULL, NULL);
-    else
-        filedata = load_mc_home_file (mc_global.share_data_dir, MC_HELP, &hlpfile, NULL);
+    /* Reuse the translated help data if the same file is still requested and hasn't
+       changed on disk: re-reading and re-converting it on every invocation is
+       expensive, especially on network homes */
+    request = event_data->filename != NULL ? event_data->filename : "";
 
-    if (filedata == NULL)
-        file_error_message (_ ("Cannot open file\n%s"),
-                            event_data->filename ? event_data->filename : hlpfile);
+    if (fdata == NULL || fdata_request == NULL || strcmp (fdata_request, request) != 0
+        || stat (fdata_path, &st) != 0 || st.st_mtime != fdata_mtime)
+    {
+        if (event_data->filename != NULL)
+        {
+            g_file_get_contents (event_data->filename, &filedata, NULL, NULL);
+            hlpfile = g_strdup (event_data->filename);
+        }
+        else
+            filedata = load_mc_home_file (mc_global.share_data_dir, MC_HELP, &hlpfile, NULL);
 
-    g_free (hlpfile);
+        if (filedata == NULL)
+        {
+            file_error_message (_ ("Cannot open file\n%s"),
+                                event_data->filename ? event_data->filename : hlpfile);
+            g_free (hlpfile);
+            return TRUE;
+        }
 
-    if (filedata == NULL)
-        return TRUE;
+        translate_file (filedata);
 
-    translate_file (filedata);
+        g_free (filedata);
 
-    g_free (filedata);
+        if (fdata == NULL)
+        {
+            g_free (hlpfile);
+            return TRUE;
+        }
+
+        g_free (fdata_request);
+        fdata_request = g_strdup (request);
+        g_free (fdata_path);
+        fdata_path = hlpfile;  // takes ownership
+        fdata_mtime = stat (fdata_path, &st) == 0 ? st.st_mtime : 0;
 
-    if (fdata == NULL)
-        return TRUE;
+        // positions of the old load are invalid now
+        if (node_index != NULL)
+            g_hash_table_remove_all (node_index);
+        help_layout_invalidate ();
+    }
 
     if ((event_data->node == NULL) || (*event_data->node == '\0'))
         event_data->node = "[main]";
 
-    main_node = search_string (fdata, event_data->node);
+    main_node = help_find_node (event_data->node);
 
     if (main_node == NULL)
     {
         message (D_ERROR, MSG_ERROR, _ ("Cannot find node %s in help file"), event_data->node);
 
         // Fallback to [main], return if it also cannot be found
-        main_node = search_string (fdata, "[main]");
+        main_node = help_find_node ("[main]");
         if (main_node == NULL)
         {
             interactive_display_finish ();
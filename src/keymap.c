@@ -227,6 +227,10 @@ static const global_keymap_ini_t default_panel_keymap[] = {
     { "SelectCodepage", "alt-e" },
     { "Search", "ctrl-s; alt-s" },
     { "PanelOtherSync", "alt-i" },
+    { "PanelTabNew", "alt-shift-t" },
+    { "PanelTabClose", "alt-shift-w" },
+    { "PanelTabNext", "alt-pgdn" },
+    { "PanelTabPrev", "alt-pgup" },
     {
         NULL,
         NULL,
@@ -557,6 +561,8 @@ static const global_keymap_ini_t default_viewer_keymap[] = {
     { "SelectCodepage", "alt-e" },
     { "Shell", "ctrl-o" },
     { "Ruler", "alt-r" },
+    { "Stats", "alt-s" },
+    { "Follow", "shift-f" },
     { "SearchForward", "slash" },
     { "SearchBackward", "question" },
     { "SearchForwardContinue", "ctrl-s" },
@@ -990,6 +996,8 @@ keymap_free (void)
     if (km##_keymap != NULL)                                                                       \
     g_array_free (km##_keymap, TRUE)
 
+    keybind_free_command_caches ();
+
     FREE_KEYMAP (filemanager);
     FREE_KEYMAP (filemanager_x);
     FREE_KEYMAP (panel);
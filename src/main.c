@@ -51,6 +51,7 @@
 #include "lib/filehighlight.h"
 #include "lib/fileloc.h"
 #include "lib/strutil.h"
+#include "lib/trace.h"  // mc_trace_init()
 #include "lib/util.h"
 #include "lib/vfs/vfs.h"  // vfs_init(), vfs_shut()
 
@@ -91,10 +92,37 @@
 
 /*** file scope variables ************************************************************************/
 
+/* Collected by startup_profile_phase () for --profile-startup */
+static GString *startup_profile_report = NULL;
+static gint64 startup_profile_mark = 0;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+/** Record the time spent in the startup phase that just finished.
+ * The report is printed to stderr at exit, when the terminal is restored.
+ */
+static void
+startup_profile_phase (const char *phase)
+{
+    gint64 now;
+
+    if (!mc_args__profile_startup)
+        return;
+
+    now = g_get_monotonic_time ();
+
+    if (startup_profile_report == NULL)
+        startup_profile_report = g_string_new ("");
+
+    g_string_append_printf (startup_profile_report, "%10.3f ms  %s\n",
+                            (now - startup_profile_mark) / 1000.0, phase);
+    startup_profile_mark = now;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /** POSIX version.  The only version we support.  */
 static void
 OS_Setup (void)
@@ -234,6 +262,8 @@ main (int argc, char *argv[])
     (void) bindtextdomain (PACKAGE, LOCALEDIR);
     (void) textdomain (PACKAGE);
 
+    startup_profile_mark = g_get_monotonic_time ();
+
     // do this before args parsing
     str_init_strings (NULL);
 
@@ -284,11 +314,18 @@ main (int argc, char *argv[])
         goto startup_exit_falure;
     }
 
+    startup_profile_phase ("command line and environment");
+
     vfs_init ();
     vfs_plugins_init ();
 
+    startup_profile_phase ("VFS initialization");
+
     load_setup ();
 
+    // needs the config paths for the default trace file location
+    mc_trace_init ();
+
     // Must be done after load_setup because depends on mc_global.vfs.cd_symlinks
     vfs_setup_work_dir ();
 
@@ -329,6 +366,8 @@ main (int argc, char *argv[])
         vfs_path_free (vpath, TRUE);
     }
 
+    startup_profile_phase ("configuration load");
+
     /* NOTE: This has to be called before tty_init or whatever routine
        calls any define_sequence */
     init_key ();
@@ -360,6 +399,8 @@ main (int argc, char *argv[])
 
     keymap_load (!mc_args__nokeymap);
 
+    startup_profile_phase ("terminal and keymap initialization");
+
 #ifdef USE_INTERNAL_EDIT
     macros_list = g_array_new (TRUE, FALSE, sizeof (macros_t));
 #endif
@@ -374,6 +415,8 @@ main (int argc, char *argv[])
 
     mc_error_message (&mcerror, NULL);
 
+    startup_profile_phase ("skin and colors");
+
 #ifdef ENABLE_SUBSHELL
     // Done here to ensure that the subshell doesn't
     // inherit the file descriptors opened below, etc
@@ -399,6 +442,8 @@ main (int argc, char *argv[])
 
     if (mc_global.tty.use_subshell)
         init_subshell ();
+
+    startup_profile_phase ("subshell spawn");
 #endif
 
     if (!mc_global.midnight_shutdown)
@@ -422,6 +467,8 @@ main (int argc, char *argv[])
         mc_prompt = g_strdup ((geteuid () == 0) ? "# " : "$ ");
     }
 
+    startup_profile_phase ("main loop entry");
+
     // Program main loop
     if (mc_global.midnight_shutdown)
         exit_code = EXIT_SUCCESS;
@@ -454,6 +501,14 @@ main (int argc, char *argv[])
 
     tty_shutdown ();
 
+    // the terminal is restored - the startup report can go to stderr now
+    if (startup_profile_report != NULL)
+    {
+        fprintf (stderr, "%s:\n%s", _ ("Startup profile"), startup_profile_report->str);
+        g_string_free (startup_profile_report, TRUE);
+        startup_profile_report = NULL;
+    }
+
     done_setup ();
 
     if (mc_global.tty.console_flag != '\0' && (quit & SUBSHELL_EXIT) == 0)
@@ -513,6 +568,9 @@ main (int argc, char *argv[])
     g_free (mc_run_param1);
     g_free (saved_other_dir);
 
+    mc_trace_deinit ();
+
+    mc_config_history_deinit ();
     mc_config_deinit_config_paths ();
 
     (void) mc_event_deinit (&mcerror);
@@ -49,6 +49,9 @@
 #ifdef ENABLE_VFS_SHELL
 #include "src/vfs/shell/shell.h"
 #endif
+#ifdef ENABLE_VFS_SFS
+#include "src/vfs/sfs/sfs.h"
+#endif
 
 #include "filemanager/dir.h"
 #include "filemanager/filemanager.h"
@@ -111,6 +114,13 @@ panel_view_mode_t startup_left_mode;
 panel_view_mode_t startup_right_mode;
 
 gboolean copymove_persistent_attr = TRUE;
+/* Verify copies by checksumming the source in flight and reading the target back */
+gboolean copymove_verify_checksum = FALSE;
+/* Keep zero runs in copied files as holes instead of writing them out */
+gboolean copymove_preserve_sparse = FALSE;
+/* Copy directory entries in inode order rather than readdir order; cuts seeking
+ * on rotational storage, no effect on the result */
+gboolean copymove_inode_order = FALSE;
 #ifdef ENABLE_EXT2FS_ATTR
 gboolean copymove_persistent_ext2_attr = TRUE;
 #else
@@ -176,6 +186,12 @@ gboolean verbose = TRUE;
  */
 gboolean file_op_compute_totals = TRUE;
 
+/*
+ * Whether copy/move operations stat all destinations up front and settle
+ * name conflicts in one consolidated dialog before any data is transferred
+ */
+gboolean file_op_prescan_conflicts = FALSE;
+
 /* If true use the internal viewer */
 gboolean use_internal_view = TRUE;
 /* If set, use the builtin editor */
@@ -325,6 +341,7 @@ static const struct
     { "show_output_starts_shell", &output_starts_shell },
     { "xtree_mode", &xtree_mode },
     { "file_op_compute_totals", &file_op_compute_totals },
+    { "file_op_prescan_conflicts", &file_op_prescan_conflicts },
     { "classic_progressbar", &classic_progressbar },
 #ifdef ENABLE_VFS
 #ifdef ENABLE_VFS_FTP
@@ -362,10 +379,14 @@ static const struct
 #endif
     { "editor_ask_filename_before_edit", &editor_ask_filename_before_edit },
     { "nice_rotating_dash", &nice_rotating_dash },
+    { "clipboard_osc52", &clipboard_osc52 },
     { "shadows", &mc_global.tty.shadows },
     { "mcview_remember_file_position", &mcview_remember_file_position },
     { "auto_fill_mkdir_name", &auto_fill_mkdir_name },
     { "copymove_persistent_attr", &copymove_persistent_attr },
+    { "copymove_verify_checksum", &copymove_verify_checksum },
+    { "copymove_preserve_sparse", &copymove_preserve_sparse },
+    { "copymove_inode_order", &copymove_inode_order },
 #ifdef ENABLE_EXT2FS_ATTR
     { "copymove_persistent_ext2_attr", &copymove_persistent_ext2_attr },
 #endif
@@ -389,6 +410,7 @@ static const struct
 
 #ifdef ENABLE_VFS
     { "vfs_timeout", &vfs_timeout },
+    { "vfs_memory_limit", &vfs_memory_limit },
 #ifdef ENABLE_VFS_FTP
     { "ftpfs_directory_timeout", &ftpfs_directory_timeout },
     { "ftpfs_retry_seconds", &ftpfs_retry_seconds },
@@ -396,6 +418,9 @@ static const struct
 #ifdef ENABLE_VFS_SHELL
     { "shell_directory_timeout", &shell_directory_timeout },
 #endif
+#ifdef ENABLE_VFS_SFS
+    { "sfs_cache_limit", &sfs_cache_limit },
+#endif
 #endif
 
     // option_tab_spacing is used in internal viewer
@@ -1193,6 +1218,11 @@ panel_load_setup (WPanel *panel, const char *section)
         mc_config_get_string (mc_global.panels_config, section, "filter_value", NULL);
     panel->filter.flags = mc_config_get_int (mc_global.panels_config, section, "filter_flags",
                                              (int) FILE_FILTER_DEFAULT_FLAGS);
+
+    // the cursor position of the previous session, restored after the listing is loaded
+    g_free (panel->saved_current_file);
+    panel->saved_current_file =
+        mc_config_get_string (mc_global.panels_config, section, "current_file", NULL);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1233,6 +1263,18 @@ panel_save_setup (WPanel *panel, const char *section)
     mc_config_set_bool (mc_global.panels_config, section, "user_mini_status",
                         panel->user_mini_status);
 
+    {
+        const file_entry_t *fe;
+
+        // remember the cursor position for the next session
+        fe = panel_current_entry (panel);
+        if (fe != NULL)
+            mc_config_set_string (mc_global.panels_config, section, "current_file",
+                                  fe->fname->str);
+        else
+            mc_config_del_key (mc_global.panels_config, section, "current_file");
+    }
+
     // do not save the default filter
     if (panel->filter.handler != NULL)
         mc_config_set_string (mc_global.panels_config, section, "filter_value",
@@ -89,6 +89,9 @@ extern gboolean auto_menu;
 extern gboolean drop_menus;
 extern gboolean verbose;
 extern gboolean copymove_persistent_attr;
+extern gboolean copymove_verify_checksum;
+extern gboolean copymove_preserve_sparse;
+extern gboolean copymove_inode_order;
 extern gboolean copymove_persistent_ext2_attr;
 extern gboolean classic_progressbar;
 extern gboolean easy_patterns;
@@ -102,6 +105,7 @@ extern gboolean output_starts_shell;
 extern gboolean use_file_to_check_type;
 #endif
 extern gboolean file_op_compute_totals;
+extern gboolean file_op_prescan_conflicts;
 extern gboolean editor_ask_filename_before_edit;
 
 extern panels_options_t panels_options;
@@ -830,7 +830,13 @@ peek_subshell_switch_key (const char *buffer, size_t len)
 }
 
 /* --------------------------------------------------------------------------------------------- */
-/** Feed the subshell our keyboard input until it says it's finished */
+/** Feed the subshell our keyboard input until it says it's finished.
+ *
+ * Synchronization with the shell is event driven, not polled: the shell's precmd hook writes
+ * its cwd to subshell_pipe and stops itself, the select() below wakes up on that write, and
+ * synchronize() resumes the shell with SIGCONT once the SIGCHLD handler has seen the stop.
+ * The timeout below is only a safety net for a shell that never reaches precmd.
+ */
 
 static gboolean
 feed_subshell (int how, gboolean fail_on_error)
@@ -1416,29 +1422,37 @@ do_subshell_chdir (const vfs_path_t *vpath, gboolean update_prompt)
         feed_subshell (QUIETLY, TRUE);
     }
 
-    /* The initial space keeps this out of the command history (in bash
-       because we set "HISTCONTROL=ignorespace") */
-    write_all (mc_global.tty.subshell_pty, " cd ", 4);
-
-    if (vpath == NULL)
-        write_all (mc_global.tty.subshell_pty, "/", 1);
-    else
     {
-        const char *translate = vfs_translate_path (vfs_path_as_str (vpath));
+        GString *cd_cmd;
+
+        /* The initial space keeps this out of the command history (in bash
+           because we set "HISTCONTROL=ignorespace") */
+        cd_cmd = g_string_new (" cd ");
 
-        if (translate == NULL)
-            write_all (mc_global.tty.subshell_pty, ".", 1);
+        if (vpath == NULL)
+            g_string_append_c (cd_cmd, '/');
         else
         {
-            GString *temp;
+            const char *translate = vfs_translate_path (vfs_path_as_str (vpath));
+
+            if (translate == NULL)
+                g_string_append_c (cd_cmd, '.');
+            else
+            {
+                GString *temp;
 
-            temp = subshell_name_quote (translate);
-            write_all (mc_global.tty.subshell_pty, temp->str, temp->len);
-            g_string_free (temp, TRUE);
+                temp = subshell_name_quote (translate);
+                g_string_append_len (cd_cmd, temp->str, temp->len);
+                g_string_free (temp, TRUE);
+            }
         }
-    }
 
-    write_all (mc_global.tty.subshell_pty, "\n", 1);
+        g_string_append_c (cd_cmd, '\n');
+
+        // send the whole command in one write: every pty write wakes the shell up
+        write_all (mc_global.tty.subshell_pty, cd_cmd->str, cd_cmd->len);
+        g_string_free (cd_cmd, TRUE);
+    }
 
     subshell_state = RUNNING_COMMAND;
     if (!feed_subshell (QUIETLY, TRUE))
@@ -77,6 +77,15 @@ static gboolean debug_flag = FALSE;
 static gboolean debug_error = FALSE;
 static char *menu = NULL;
 
+/* Contents of the last used menu file, validated by mtime and size, so that
+ * F2 doesn't re-read the file every time: the entry conditions have to be
+ * re-evaluated on each invocation anyway, but the read is what hurts on
+ * network homes */
+static char *menu_cache_path = NULL;
+static char *menu_cache_data = NULL;
+static time_t menu_cache_mtime = 0;
+static off_t menu_cache_size = 0;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -1053,11 +1062,30 @@ user_menu_cmd (const Widget *edit_widget, const char *menu_file, int selected_en
         }
     }
 
-    if (!g_file_get_contents (menu, &data, NULL, NULL))
     {
-        file_error_message (_ ("Cannot open file\n%s"), menu);
-        MC_PTR_FREE (menu);
-        return FALSE;
+        struct stat st;
+        gboolean stat_ok;
+
+        stat_ok = stat (menu, &st) == 0;
+
+        if (stat_ok && menu_cache_path != NULL && strcmp (menu_cache_path, menu) == 0
+            && st.st_mtime == menu_cache_mtime && st.st_size == menu_cache_size)
+            data = g_strdup (menu_cache_data);
+        else if (!g_file_get_contents (menu, &data, NULL, NULL))
+        {
+            file_error_message (_ ("Cannot open file\n%s"), menu);
+            MC_PTR_FREE (menu);
+            return FALSE;
+        }
+        else if (stat_ok)
+        {
+            g_free (menu_cache_path);
+            menu_cache_path = g_strdup (menu);
+            g_free (menu_cache_data);
+            menu_cache_data = g_strdup (data);
+            menu_cache_mtime = st.st_mtime;
+            menu_cache_size = st.st_size;
+        }
     }
 
     old_patterns = easy_patterns;
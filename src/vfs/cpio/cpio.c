@@ -58,10 +58,10 @@
 /* If some time reentrancy should be needed change it to */
 /* #define CPIO_POS(super) (super)->u.arch.fd */
 
-#define CPIO_SEEK_SET(super, where)                                                                \
-    mc_lseek (CPIO_SUPER (super)->fd, CPIO_POS (super) = (where), SEEK_SET)
-#define CPIO_SEEK_CUR(super, where)                                                                \
-    mc_lseek (CPIO_SUPER (super)->fd, CPIO_POS (super) += (where), SEEK_SET)
+#define CPIO_SEEK_SET(super, where) cpio_sseek (super, CPIO_POS (super) = (where))
+#define CPIO_SEEK_CUR(super, where) cpio_sseek (super, CPIO_POS (super) += (where))
+
+#define CPIO_SCAN_BUF_SIZE (64 * 1024)
 
 #define MAGIC_LENGTH (6)  // How many bytes we have to read ahead
 #define SEEKBACK     CPIO_SEEK_CUR (super, ptr - top)
@@ -139,6 +139,12 @@ typedef struct
     struct stat st;
     int type;          // Type of the archive
     GSList *deferred;  // List of inodes for which another entries may appear
+
+    // Read-ahead for the scan; used by cpio_sread()/cpio_sseek() during cpio_open_archive() only
+    char *rbuf;
+    size_t rbuf_pos;   // Next unconsumed byte in rbuf
+    size_t rbuf_len;   // Bytes stored in rbuf
+    off_t rbuf_start;  // Archive offset of rbuf[0]
 } cpio_super_t;
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -168,6 +174,84 @@ cpio_defer_find (const void *a, const void *b)
     return (a1->inumber == b1->inumber && a1->device == b1->device) ? 0 : 1;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Buffered read for the archive scan.
+ *
+ * The open path issues a separate request for every header, name and run of padding; pushing
+ * each of them through the VFS layer dominates the open time of archives with many members.
+ * Serve the scan from one read-ahead buffer instead and touch the descriptor only to refill
+ * it or when a seek leaves the buffered window.
+ */
+
+static ssize_t
+cpio_sread (struct vfs_s_super *super, void *buf, size_t count)
+{
+    cpio_super_t *arch = CPIO_SUPER (super);
+    size_t done = 0;
+
+    while (done < count)
+    {
+        size_t avail = arch->rbuf_len - arch->rbuf_pos;
+        ssize_t res;
+
+        if (avail != 0)
+        {
+            size_t chunk = MIN (avail, count - done);
+
+            memcpy ((char *) buf + done, arch->rbuf + arch->rbuf_pos, chunk);
+            arch->rbuf_pos += chunk;
+            done += chunk;
+            continue;
+        }
+
+        // the buffer is drained, so the descriptor stands right past the buffered window
+        arch->rbuf_start += (off_t) arch->rbuf_len;
+        arch->rbuf_pos = 0;
+        arch->rbuf_len = 0;
+
+        if (count - done >= CPIO_SCAN_BUF_SIZE)
+        {
+            // a request this large gains nothing from being staged in the buffer
+            res = mc_read (arch->fd, (char *) buf + done, count - done);
+            if (res > 0)
+                arch->rbuf_start += res;
+        }
+        else
+        {
+            res = mc_read (arch->fd, arch->rbuf, CPIO_SCAN_BUF_SIZE);
+            if (res > 0)
+                arch->rbuf_len = (size_t) res;
+        }
+
+        if (res <= 0)
+            return done != 0 ? (ssize_t) done : res;
+    }
+
+    return (ssize_t) done;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static off_t
+cpio_sseek (struct vfs_s_super *super, off_t pos)
+{
+    cpio_super_t *arch = CPIO_SUPER (super);
+
+    // a target inside the buffered window (short skips, the seekback of cpio_find_head)
+    // is just a cursor move
+    if (pos >= arch->rbuf_start && pos <= arch->rbuf_start + (off_t) arch->rbuf_len)
+    {
+        arch->rbuf_pos = (size_t) (pos - arch->rbuf_start);
+        return pos;
+    }
+
+    arch->rbuf_start = pos;
+    arch->rbuf_pos = 0;
+    arch->rbuf_len = 0;
+
+    return mc_lseek (arch->fd, pos, SEEK_SET);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static ssize_t
@@ -219,6 +303,7 @@ cpio_free_archive (struct vfs_class *me, struct vfs_s_super *super)
         arch->fd = -1;
     }
 
+    MC_PTR_FREE (arch->rbuf);
     g_clear_slist (&arch->deferred, g_free);
 }
 
@@ -267,6 +352,7 @@ cpio_open_cpio_file (struct vfs_class *me, struct vfs_s_super *super, const vfs_
     }
 
     arch->fd = fd;
+    arch->rbuf = g_malloc (CPIO_SCAN_BUF_SIZE);
     mode = arch->st.st_mode & 07777;
     mode |= (mode & 0444) >> 2;  // set eXec where Read is
     mode |= S_IFDIR;
@@ -318,7 +404,7 @@ cpio_find_head (struct vfs_class *me, struct vfs_s_super *super)
     ssize_t top;
     ssize_t tmp;
 
-    top = mc_read (arch->fd, buf, sizeof (buf));
+    top = cpio_sread (super, buf, sizeof (buf));
     if (top > 0)
         CPIO_POS (super) += top;
 
@@ -332,7 +418,7 @@ cpio_find_head (struct vfs_class *me, struct vfs_s_super *super)
                 ptr -= top - sizeof (buf) / 2;
                 top = sizeof (buf) / 2;
             }
-            tmp = mc_read (arch->fd, buf, top);
+            tmp = cpio_sread (super, buf, top);
             if (tmp == 0 || tmp == -1)
             {
                 message (D_ERROR, MSG_ERROR, _ ("Premature end of cpio archive\n%s"), super->name);
@@ -520,7 +606,7 @@ cpio_create_entry (struct vfs_class *me, struct vfs_s_super *super, struct stat
 
                 inode->linkname = g_malloc (st->st_size + 1);
 
-                if (mc_read (arch->fd, inode->linkname, st->st_size) < st->st_size)
+                if (cpio_sread (super, inode->linkname, st->st_size) < st->st_size)
                 {
                     inode->linkname[0] = '\0';
                     return STATUS_EOF;
@@ -553,7 +639,7 @@ cpio_read_bin_head (struct vfs_class *me, struct vfs_s_super *super)
     char *name;
     struct stat st;
 
-    len = mc_read (arch->fd, (char *) &u.buf, HEAD_LENGTH);
+    len = cpio_sread (super, (char *) &u.buf, HEAD_LENGTH);
     if (len < HEAD_LENGTH)
         return STATUS_EOF;
     CPIO_POS (super) += len;
@@ -571,7 +657,7 @@ cpio_read_bin_head (struct vfs_class *me, struct vfs_s_super *super)
         return STATUS_FAIL;
     }
     name = g_malloc (u.buf.c_namesize);
-    len = mc_read (arch->fd, name, u.buf.c_namesize);
+    len = cpio_sread (super, name, u.buf.c_namesize);
     if (len < u.buf.c_namesize)
     {
         g_free (name);
@@ -624,7 +710,7 @@ cpio_read_oldc_head (struct vfs_class *me, struct vfs_s_super *super)
     ssize_t len;
     char *name;
 
-    if (mc_read (arch->fd, u.buf, HEAD_LENGTH) != HEAD_LENGTH)
+    if (cpio_sread (super, u.buf, HEAD_LENGTH) != HEAD_LENGTH)
         return STATUS_EOF;
     CPIO_POS (super) += HEAD_LENGTH;
     u.buf[HEAD_LENGTH] = 0;
@@ -645,7 +731,7 @@ cpio_read_oldc_head (struct vfs_class *me, struct vfs_s_super *super)
         return STATUS_FAIL;
     }
     name = g_malloc (hd.c_namesize);
-    len = mc_read (arch->fd, name, hd.c_namesize);
+    len = cpio_sread (super, name, hd.c_namesize);
     if ((len == -1) || ((unsigned long) len < hd.c_namesize))
     {
         g_free (name);
@@ -696,7 +782,7 @@ cpio_read_crc_head (struct vfs_class *me, struct vfs_s_super *super)
     ssize_t len;
     char *name;
 
-    if (mc_read (arch->fd, u.buf, HEAD_LENGTH) != HEAD_LENGTH)
+    if (cpio_sread (super, u.buf, HEAD_LENGTH) != HEAD_LENGTH)
         return STATUS_EOF;
 
     CPIO_POS (super) += HEAD_LENGTH;
@@ -724,7 +810,7 @@ cpio_read_crc_head (struct vfs_class *me, struct vfs_s_super *super)
     }
 
     name = g_malloc (hd.c_namesize);
-    len = mc_read (arch->fd, name, hd.c_namesize);
+    len = cpio_sread (super, name, hd.c_namesize);
 
     if ((len == -1) || ((unsigned long) len < hd.c_namesize))
     {
@@ -781,10 +867,8 @@ cpio_open_archive (struct vfs_s_super *super, const vfs_path_t *vpath,
         switch (status)
         {
         case STATUS_EOF:
-        {
             message (D_ERROR, MSG_ERROR, _ ("Unexpected end of file\n%s"), vfs_path_as_str (vpath));
-            return 0;
-        }
+            break;
         case STATUS_OK:
             continue;
         case STATUS_TRAIL:
@@ -795,6 +879,9 @@ cpio_open_archive (struct vfs_s_super *super, const vfs_path_t *vpath,
         break;
     }
 
+    // the scan is over; cpio_read() works on the descriptor directly
+    MC_PTR_FREE (CPIO_SUPER (super)->rbuf);
+
     return 0;
 }
 
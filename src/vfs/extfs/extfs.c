@@ -80,6 +80,13 @@
 
 #define RECORDSIZE     512
 
+/* saved helper listings live in this subdirectory of the cache directory */
+#define EXTFS_LISTING_DIR   "extfs"
+#define EXTFS_LISTING_MAGIC "mc extfs listing 1"
+/* helper output may depend on more than the archive contents,
+   so even a size/mtime match expires eventually */
+#define EXTFS_LISTING_TTL   (24 * 60 * 60)
+
 #define EXTFS_SUPER(a) ((struct extfs_super_t *) (a))
 
 /*** file scope type declarations ****************************************************************/
@@ -262,8 +269,6 @@ extfs_find_entry_int (struct vfs_s_inode *dir, const char *name, GSList *list, i
             pent = pent->dir != NULL ? pent->dir->ent : NULL;
         else
         {
-            GList *pl;
-
             pent = extfs_resolve_symlinks_int (pent, list);
             if (pent == NULL)
             {
@@ -279,8 +284,7 @@ extfs_find_entry_int (struct vfs_s_inode *dir, const char *name, GSList *list, i
             }
 
             pdir = pent;
-            pl = g_queue_find_custom (pent->ino->subdir, p, vfs_s_entry_compare);
-            pent = pl != NULL ? VFS_ENTRY (pl->data) : NULL;
+            pent = VFS_ENTRY (g_hash_table_lookup (pent->ino->subdir_hash, p));
             if (pent != NULL && q + 1 > name_end)
             {
                 // Hack: I keep the original semanthic unless q+1 would break in the strchr
@@ -444,17 +448,16 @@ extfs_add_file (struct extfs_super_t *archive, const char *file_name)
                 }
             }
 
-            if (pent != NULL)
-            {
-                entry = extfs_entry_new (super->me, p, pent->ino);
-                entry->dir = pent->ino;
-                g_queue_push_tail (pent->ino->subdir, entry);
-            }
-            else
             {
-                entry = extfs_entry_new (super->me, p, super->root);
-                entry->dir = super->root;
-                g_queue_push_tail (super->root->subdir, entry);
+                struct vfs_s_inode *parent_ino;
+
+                parent_ino = pent != NULL ? pent->ino : super->root;
+                entry = extfs_entry_new (super->me, p, parent_ino);
+                entry->dir = parent_ino;
+                g_queue_push_tail (parent_ino->subdir, entry);
+                // keep the lookup hash in sync: the first entry of a name wins
+                if (g_hash_table_lookup (parent_ino->subdir_hash, entry->name) == NULL)
+                    g_hash_table_insert (parent_ino->subdir_hash, entry->name, entry);
             }
 
             if (!S_ISLNK (hstat.st_mode) && (current_link_name != NULL))
@@ -513,17 +516,51 @@ extfs_add_file (struct extfs_super_t *archive, const char *file_name)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Create a superblock with the root inode for the archive @name whose stat is @mystat.
+ */
+static struct extfs_super_t *
+extfs_archive_new (int fstype, const char *name, const vfs_path_t *local_name_vpath,
+                   const struct stat *mystat)
+{
+    static dev_t archive_counter = 0;
+    struct extfs_super_t *current_archive;
+    mode_t mode;
+    struct vfs_s_entry *root_entry;
+
+    current_archive = extfs_super_new (vfs_extfs_ops, name, local_name_vpath, fstype);
+    current_archive->rdev = archive_counter++;
+
+    mode = mystat->st_mode & 07777;
+    if (mode & 0400)
+        mode |= 0100;
+    if (mode & 0040)
+        mode |= 0010;
+    if (mode & 0004)
+        mode |= 0001;
+    mode |= S_IFDIR;
+
+    root_entry = extfs_generate_entry (current_archive, PATH_SEP_STR, NULL, mode);
+    root_entry->ino->st.st_uid = mystat->st_uid;
+    root_entry->ino->st.st_gid = mystat->st_gid;
+    root_entry->ino->st.st_atime = mystat->st_atime;
+    root_entry->ino->st.st_ctime = mystat->st_ctime;
+    root_entry->ino->st.st_mtime = mystat->st_mtime;
+    root_entry->ino->ent = root_entry;
+    VFS_SUPER (current_archive)->root = root_entry->ino;
+
+    return current_archive;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static mc_pipe_t *
 extfs_open_archive (int fstype, const char *name, struct extfs_super_t **pparc, GError **error)
 {
     const extfs_plugin_info_t *info;
-    static dev_t archive_counter = 0;
     mc_pipe_t *result = NULL;
-    mode_t mode;
     char *cmd;
     struct stat mystat;
-    struct extfs_super_t *current_archive;
-    struct vfs_s_entry *root_entry;
     char *tmp = NULL;
     vfs_path_t *local_name_vpath = NULL;
     vfs_path_t *name_vpath;
@@ -571,30 +608,9 @@ extfs_open_archive (int fstype, const char *name, struct extfs_super_t **pparc,
         goto ret;
     }
 
-    current_archive = extfs_super_new (vfs_extfs_ops, name, local_name_vpath, fstype);
-    current_archive->rdev = archive_counter++;
+    *pparc = extfs_archive_new (fstype, name, local_name_vpath, &mystat);
     vfs_path_free (local_name_vpath, TRUE);
 
-    mode = mystat.st_mode & 07777;
-    if (mode & 0400)
-        mode |= 0100;
-    if (mode & 0040)
-        mode |= 0010;
-    if (mode & 0004)
-        mode |= 0001;
-    mode |= S_IFDIR;
-
-    root_entry = extfs_generate_entry (current_archive, PATH_SEP_STR, NULL, mode);
-    root_entry->ino->st.st_uid = mystat.st_uid;
-    root_entry->ino->st.st_gid = mystat.st_gid;
-    root_entry->ino->st.st_atime = mystat.st_atime;
-    root_entry->ino->st.st_ctime = mystat.st_ctime;
-    root_entry->ino->st.st_mtime = mystat.st_mtime;
-    root_entry->ino->ent = root_entry;
-    VFS_SUPER (current_archive)->root = root_entry->ino;
-
-    *pparc = current_archive;
-
 ret:
     vfs_path_free (name_vpath, TRUE);
     return result;
@@ -607,7 +623,7 @@ ret:
  */
 
 static int
-extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, GError **error)
+extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, FILE *listing, GError **error)
 {
     int ret = 0;
     GString *buffer;
@@ -681,6 +697,9 @@ extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, GError **erro
                 continue;
             }
 
+            if (listing != NULL)
+                fprintf (listing, "%s\n", buffer->str);
+
             ret = extfs_add_file (archive, buffer->str);
 
             g_string_free (buffer, TRUE);
@@ -705,6 +724,149 @@ extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, GError **erro
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Name of the saved helper listing of the archive @name in the cache directory.
+ */
+static char *
+extfs_listing_file_path (const char *name)
+{
+    char *checksum, *fname, *path;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, name, -1);
+    checksum[24] = '\0';
+    fname = g_strconcat (checksum, ".listing", (char *) NULL);
+    path = g_build_filename (mc_config_get_cache_path (), EXTFS_LISTING_DIR, fname, (char *) NULL);
+    g_free (fname);
+    g_free (checksum);
+
+    return path;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Whether the listing of the archive @name may be saved and reused, i.e. the
+ * plugin works on a local archive file that can be stat'ed. On success @st
+ * describes that file.
+ */
+static gboolean
+extfs_listing_cacheable (int fstype, const char *name, struct stat *st)
+{
+    const extfs_plugin_info_t *info;
+    vfs_path_t *name_vpath;
+    gboolean ret;
+
+    info = &g_array_index (extfs_plugins, extfs_plugin_info_t, fstype);
+    if (!info->need_archive)
+        return FALSE;
+
+    name_vpath = vfs_path_from_str (name);
+    ret = vfs_file_is_local (name_vpath) && mc_stat (name_vpath, st) == 0;
+    vfs_path_free (name_vpath, TRUE);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Forget the saved listing of @archive: its content is about to change.
+ */
+static void
+extfs_listing_invalidate (const struct extfs_super_t *archive)
+{
+    char *path;
+
+    if (CONST_VFS_SUPER (archive)->name == NULL)
+        return;
+
+    path = extfs_listing_file_path (CONST_VFS_SUPER (archive)->name);
+    unlink (path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Rebuild the archive tree of @name from a saved helper listing instead of
+ * running the helper. The copy is used only when the archive still has the
+ * size and mtime recorded in it and it is younger than EXTFS_LISTING_TTL.
+ * Returns TRUE and fills @pparc on success.
+ */
+static gboolean
+extfs_listing_load (int fstype, const char *name, const struct stat *st,
+                    struct extfs_super_t **pparc)
+{
+    char *path, *content = NULL;
+    gsize length = 0;
+    char *p, *num_end;
+    long long hdr[3], now;
+    int i;
+    struct extfs_super_t *a;
+
+    path = extfs_listing_file_path (name);
+    if (!g_file_get_contents (path, &content, &length, NULL))
+    {
+        g_free (path);
+        return FALSE;
+    }
+    g_free (path);
+
+    if (!g_str_has_prefix (content, EXTFS_LISTING_MAGIC "\n")
+        || memchr (content, '\0', length) != NULL)
+    {
+        g_free (content);
+        return FALSE;
+    }
+
+    p = content + strlen (EXTFS_LISTING_MAGIC "\n");
+
+    for (i = 0; i < 3; i++)
+    {
+        hdr[i] = g_ascii_strtoll (p, &num_end, 10);
+        p = num_end;
+    }
+    p = strchr (p, '\n');
+
+    now = (long long) time (NULL);
+    if (p == NULL || hdr[0] != (long long) st->st_size || hdr[1] != (long long) st->st_mtime
+        || now < hdr[2] || now - hdr[2] > EXTFS_LISTING_TTL)
+    {
+        g_free (content);
+        return FALSE;
+    }
+    p++;
+
+    a = extfs_archive_new (fstype, name, NULL, st);
+
+    while (*p != '\0')
+    {
+        char *nl;
+
+        nl = strchr (p, '\n');
+        if (nl == NULL)
+            break;
+        *nl = '\0';
+
+        if (extfs_add_file (a, p) != 0)
+        {
+            // the saved listing is unusable: fall back to the helper
+            VFS_SUPER (a)->me->free (VFS_SUPER (a));
+            g_free (content);
+            return FALSE;
+        }
+
+        p = nl + 1;
+    }
+
+    g_free (content);
+    *pparc = a;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 extfs_which (struct vfs_class *me, const char *path)
 {
@@ -736,8 +898,15 @@ extfs_open_and_read_archive (int fstype, const char *name, struct extfs_super_t
     int result = -1;
     struct extfs_super_t *a;
     mc_pipe_t *pip;
+    struct stat st;
+    gboolean cacheable;
     GError *error = NULL;
 
+    // a listing saved by an earlier visit makes the helper run unnecessary
+    cacheable = extfs_listing_cacheable (fstype, name, &st);
+    if (cacheable && extfs_listing_load (fstype, name, &st, archive))
+        return 0;
+
     pip = extfs_open_archive (fstype, name, archive, &error);
 
     a = *archive;
@@ -758,7 +927,47 @@ extfs_open_and_read_archive (int fstype, const char *name, struct extfs_super_t
     }
     else
     {
-        result = extfs_read_archive (pip, a, &error);
+        FILE *listing = NULL;
+        char *listing_path = NULL, *tmp_path = NULL;
+
+        if (cacheable)
+        {
+            char *dir_path;
+            int tmp_fd;
+
+            listing_path = extfs_listing_file_path (name);
+            dir_path = g_path_get_dirname (listing_path);
+            g_mkdir_with_parents (dir_path, 0700);
+            g_free (dir_path);
+
+            /* unique per process: two instances listing the same archive must
+               not interleave their helper output in one shared temp file */
+            tmp_path = g_strconcat (listing_path, ".XXXXXX", (char *) NULL);
+            tmp_fd = g_mkstemp (tmp_path);
+            if (tmp_fd != -1)
+            {
+                listing = fdopen (tmp_fd, "w");
+                if (listing == NULL)
+                {
+                    close (tmp_fd);
+                    unlink (tmp_path);
+                }
+            }
+            if (listing != NULL)
+                fprintf (listing, "%s\n%lld %lld %lld\n", EXTFS_LISTING_MAGIC,
+                         (long long) st.st_size, (long long) st.st_mtime, (long long) time (NULL));
+        }
+
+        result = extfs_read_archive (pip, a, listing, &error);
+
+        if (listing != NULL)
+        {
+            // a half-written listing must never be picked up later
+            if (fclose (listing) != 0 || result != 0 || rename (tmp_path, listing_path) != 0)
+                unlink (tmp_path);
+        }
+        g_free (tmp_path);
+        g_free (listing_path);
 
         if (result != 0)
             VFS_SUPER (a)->me->free (VFS_SUPER (a));
@@ -1145,6 +1354,8 @@ extfs_close (void *fh)
     {
         struct stat file_status;
 
+        extfs_listing_invalidate (EXTFS_SUPER (VFS_FILE_HANDLER_SUPER (fh)));
+
         if (extfs_cmd (" copyin ", EXTFS_SUPER (VFS_FILE_HANDLER_SUPER (fh)), file->ino->ent,
                        file->ino->localname))
             errno_code = EIO;
@@ -1375,6 +1586,7 @@ extfs_unlink (const vfs_path_t *vpath)
         VFS_CLASS (vfs_path_get_last_path_vfs (vpath))->verrno = EISDIR;
         goto cleanup;
     }
+    extfs_listing_invalidate (archive);
     if (extfs_cmd (" rm ", archive, entry, ""))
     {
         my_errno = EIO;
@@ -1421,6 +1633,7 @@ extfs_mkdir (const vfs_path_t *vpath, mode_t mode)
         goto cleanup;
     }
 
+    extfs_listing_invalidate (archive);
     if (extfs_cmd (" mkdir ", archive, entry, ""))
     {
         my_errno = EIO;
@@ -1457,6 +1670,7 @@ extfs_rmdir (const vfs_path_t *vpath)
         goto cleanup;
     }
 
+    extfs_listing_invalidate (archive);
     if (extfs_cmd (" rmdir ", archive, entry, ""))
     {
         my_errno = EIO;
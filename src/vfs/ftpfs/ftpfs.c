@@ -1790,6 +1790,7 @@ ftpfs_dir_load (struct vfs_class *me, struct vfs_s_inode *dir, const char *remot
     int sock;
     char lc_buffer[BUF_8K];
     int res;
+    vfs_s_line_reader_t reader;
     gboolean cd_first;
     GSList *dirlist = NULL;
     GSList *entlist;
@@ -1848,7 +1849,8 @@ again:
     }
 
     // read full directory list, then parse it
-    while ((res = vfs_s_get_line_interruptible (me, lc_buffer, sizeof (lc_buffer), sock)) != 0)
+    vfs_s_line_reader_init (&reader, sock);
+    while ((res = vfs_s_read_line_interruptible (me, &reader, lc_buffer, sizeof (lc_buffer))) != 0)
     {
         if (res == EINTR)
         {
@@ -2139,7 +2141,11 @@ ftpfs_send_command (const vfs_path_t *vpath, const char *cmd, int flags)
         return (-1);
     }
     if (flush_directory_cache)
-        vfs_s_invalidate (me, super);
+    {
+        /* only the listing the command changed is stale: mirror-style sessions issue
+           many of these and must not re-read every cached directory after each one */
+        vfs_s_invalidate_dir (me, super, rpath);
+    }
     return 0;
 }
 
@@ -2384,6 +2390,7 @@ ftpfs_fh_close (struct vfs_class *me, vfs_file_handler_t *fh)
     if (fh->handle != -1 && fh->ino->localname == NULL)
     {
         ftp_super_t *ftp = FTP_SUPER (VFS_FILE_HANDLER_SUPER (fh));
+        char *s;
 
         close (fh->handle);
         fh->handle = -1;
@@ -2394,7 +2401,16 @@ ftpfs_fh_close (struct vfs_class *me, vfs_file_handler_t *fh)
         fh->changed = FALSE;
         if (ftpfs_get_reply (me, ftp->sock, NULL, 0) != COMPLETE)
             ERRNOR (EIO, -1);
-        vfs_s_invalidate (me, VFS_FILE_HANDLER_SUPER (fh));
+
+        // only the listing of the directory the file went to is stale
+        s = vfs_s_fullpath (me, fh->ino);
+        if (s != NULL)
+        {
+            vfs_s_invalidate_dir (me, VFS_FILE_HANDLER_SUPER (fh), s);
+            g_free (s);
+        }
+        else
+            vfs_s_invalidate (me, VFS_FILE_HANDLER_SUPER (fh));
     }
 
     return 0;
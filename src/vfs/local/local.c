@@ -422,6 +422,17 @@ local_read (void *data, char *buffer, size_t count)
 
 /* --------------------------------------------------------------------------------------------- */
 
+int
+local_fileno (void *data)
+{
+    if (data == NULL)
+        return (-1);
+
+    return *(int *) data;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 int
 local_close (void *data)
 {
@@ -494,6 +505,7 @@ vfs_init_localfs (void)
     vfs_local_ops->stat = local_stat;
     vfs_local_ops->lstat = local_lstat;
     vfs_local_ops->fstat = local_fstat;
+    vfs_local_ops->fileno = local_fileno;
     vfs_local_ops->chmod = local_chmod;
     vfs_local_ops->chown = local_chown;
 #ifdef ENABLE_EXT2FS_ATTR
@@ -25,6 +25,7 @@ extern void vfs_init_localfs (void);
 extern int local_close (void *data);
 extern ssize_t local_read (void *data, char *buffer, size_t count);
 extern int local_fstat (void *data, struct stat *buf);
+extern int local_fileno (void *data);
 extern int local_errno (struct vfs_class *me);
 extern off_t local_lseek (void *data, off_t offset, int whence);
 
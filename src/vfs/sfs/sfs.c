@@ -39,11 +39,14 @@
 
 #include <config.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <unistd.h>
+#include <utime.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "lib/global.h"
+#include "lib/mcconfig.h"  // mc_config_get_cache_path()
 #include "lib/util.h"
 #include "lib/widget.h"  // D_ERROR, D_NORMAL
 
@@ -57,10 +60,16 @@
 
 /*** global variables ****************************************************************************/
 
+// Total size kept in the persistent cache of unpacked copies, in megabytes
+int sfs_cache_limit = 256;
+
 /*** file scope macro definitions ****************************************************************/
 
 #define MAXFS 32
 
+/* unpacked copies kept across sessions live in this subdirectory of the cache directory */
+#define SFS_CACHE_DIR "sfs"
+
 typedef enum
 {
     F_NONE = 0x0,
@@ -97,8 +106,17 @@ typedef struct cachedfile
 {
     char *name;
     char *cache;
+    gboolean persistent;  // the copy lives in the cache directory: keep it for the next visit
 } cachedfile;
 
+/* a persistent copy as seen by sfs_cache_trim() */
+typedef struct
+{
+    char *path;
+    off_t size;
+    time_t used;  // when the copy was unpacked or last reused
+} sfs_cache_entry_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -249,13 +267,212 @@ sfs_vfmake (const vfs_path_t *vpath, vfs_path_t *cache_vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Name of the persistent copy of @vpath in the cache directory. On success
+ * @st describes the parent archive the copy is made from.
+ * Returns NULL when the parent cannot be stat'ed.
+ */
+static char *
+sfs_cache_file_path (const vfs_path_t *vpath, struct stat *st)
+{
+    vfs_path_t *pname;
+    int ret;
+    char *checksum, *name, *path;
+
+    pname = vfs_path_clone (vpath);
+    vfs_path_remove_element_by_index (pname, -1);
+    ret = mc_stat (pname, st);
+    vfs_path_free (pname, TRUE);
+    if (ret != 0)
+        return NULL;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, vfs_path_as_str (vpath), -1);
+    checksum[24] = '\0';
+    name = g_strconcat (checksum, ".data", (char *) NULL);
+    path = g_build_filename (mc_config_get_cache_path (), SFS_CACHE_DIR, name, (char *) NULL);
+    g_free (name);
+    g_free (checksum);
+
+    return path;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Whether the copy at @cache_path was made from the parent archive described
+ * by @st. The sidecar written by sfs_cache_write_info() holds the size and
+ * mtime the parent had when the copy was unpacked.
+ */
+static gboolean
+sfs_cache_is_valid (const char *cache_path, const struct stat *st)
+{
+    char *info_path, *content = NULL;
+    gboolean ok = FALSE;
+
+    info_path = g_strconcat (cache_path, ".info", (char *) NULL);
+
+    if (g_file_get_contents (info_path, &content, NULL, NULL))
+    {
+        char *p;
+        long long size, mtime;
+
+        size = g_ascii_strtoll (content, &p, 10);
+        mtime = g_ascii_strtoll (p, &p, 10);
+
+        ok = size == (long long) st->st_size && mtime == (long long) st->st_mtime
+            && g_file_test (cache_path, G_FILE_TEST_IS_REGULAR);
+    }
+
+    g_free (content);
+    g_free (info_path);
+
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+sfs_cache_write_info (const char *cache_path, const struct stat *st)
+{
+    char *info_path, *content;
+
+    info_path = g_strconcat (cache_path, ".info", (char *) NULL);
+    content =
+        g_strdup_printf ("%lld %lld\n", (long long) st->st_size, (long long) st->st_mtime);
+    g_file_set_contents (info_path, content, -1, NULL);
+    g_free (content);
+    g_free (info_path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* oldest copies first */
+static int
+sfs_cache_entry_compare (gconstpointer a, gconstpointer b)
+{
+    const sfs_cache_entry_t *ea = *(const sfs_cache_entry_t *const *) a;
+    const sfs_cache_entry_t *eb = *(const sfs_cache_entry_t *const *) b;
+
+    return ea->used < eb->used ? -1 : ea->used > eb->used ? 1 : 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* whether the copy at @cache_path is referenced by the in-memory list */
+static gboolean
+sfs_cache_is_busy (const char *cache_path)
+{
+    GSList *cur;
+
+    for (cur = head; cur != NULL; cur = g_slist_next (cur))
+    {
+        const cachedfile *cf = (const cachedfile *) cur->data;
+
+        if (cf->persistent && strcmp (cf->cache, cache_path) == 0)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Bound the total size of the persistent copies: remove the least recently
+ * used ones (and their sidecars) until the cache fits in sfs_cache_limit
+ * megabytes. Copies referenced by the in-memory list are never removed.
+ * Called after a new copy has been added.
+ */
+static void
+sfs_cache_trim (void)
+{
+    char *cache_dir;
+    GDir *dir;
+    const char *fname;
+    GPtrArray *entries;
+    gint64 total = 0;
+    gint64 limit;
+    guint i;
+
+    limit = (gint64) sfs_cache_limit * 1024 * 1024;
+
+    cache_dir = g_build_filename (mc_config_get_cache_path (), SFS_CACHE_DIR, (char *) NULL);
+    dir = g_dir_open (cache_dir, 0, NULL);
+    if (dir == NULL)
+    {
+        g_free (cache_dir);
+        return;
+    }
+
+    entries = g_ptr_array_new ();
+
+    while ((fname = g_dir_read_name (dir)) != NULL)
+        if (g_str_has_suffix (fname, ".data"))
+        {
+            char *path;
+            struct stat st;
+
+            path = g_build_filename (cache_dir, fname, (char *) NULL);
+            if (stat (path, &st) == 0)
+            {
+                sfs_cache_entry_t *e;
+
+                e = g_new (sfs_cache_entry_t, 1);
+                e->path = path;
+                e->size = st.st_size;
+                e->used = st.st_mtime;
+                g_ptr_array_add (entries, e);
+                total += st.st_size;
+            }
+            else
+                g_free (path);
+        }
+
+    g_dir_close (dir);
+
+    if (total > limit)
+    {
+        g_ptr_array_sort (entries, sfs_cache_entry_compare);
+
+        for (i = 0; i < entries->len && total > limit; i++)
+        {
+            sfs_cache_entry_t *e = g_ptr_array_index (entries, i);
+
+            if (!sfs_cache_is_busy (e->path))
+            {
+                char *info_path;
+
+                unlink (e->path);
+                info_path = g_strconcat (e->path, ".info", (char *) NULL);
+                unlink (info_path);
+                g_free (info_path);
+
+                total -= e->size;
+            }
+        }
+    }
+
+    for (i = 0; i < entries->len; i++)
+    {
+        sfs_cache_entry_t *e = g_ptr_array_index (entries, i);
+
+        g_free (e->path);
+        g_free (e);
+    }
+    g_ptr_array_free (entries, TRUE);
+    g_free (cache_dir);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static const char *
 sfs_redirect (const vfs_path_t *vpath)
 {
     GSList *cur;
     cachedfile *cf;
     vfs_path_t *cache_vpath;
-    int handle;
+    struct stat st;
+    char *cache_path;
 
     cur = g_slist_find_custom (head, vfs_path_as_str (vpath), cachedfile_compare);
 
@@ -266,18 +483,91 @@ sfs_redirect (const vfs_path_t *vpath)
         return cf->cache;
     }
 
-    handle = vfs_mkstemps (&cache_vpath, "sfs", vfs_path_get_last_path_str (vpath));
+    cache_path = sfs_cache_file_path (vpath, &st);
 
-    if (handle == -1)
-        return "/SOMEONE_PLAYING_DIRTY_TMP_TRICKS_ON_US";
+    if (cache_path != NULL && sfs_cache_is_valid (cache_path, &st))
+    {
+        // the expensive unpacking was already done in an earlier visit
+        utime (cache_path, NULL);  // mark as recently used for sfs_cache_trim()
 
-    close (handle);
+        cf = g_new (cachedfile, 1);
+        cf->name = g_strdup (vfs_path_as_str (vpath));
+        cf->cache = cache_path;
+        cf->persistent = TRUE;
+        head = g_slist_prepend (head, cf);
+
+        vfs_stamp_create (vfs_sfs_ops, (cachedfile *) head->data);
+        return cf->cache;
+    }
+
+    if (cache_path != NULL)
+    {
+        /* unpack into the cache directory so that the copy outlives this entry;
+         * the rename below makes a half-written copy invisible */
+        char *dir_path, *tmp_path;
+        int tmp_fd;
+
+        dir_path = g_path_get_dirname (cache_path);
+        g_mkdir_with_parents (dir_path, 0700);
+        g_free (dir_path);
+
+        /* the temp name must be unique per process: two instances unpacking the
+         * same entry concurrently would interleave their filter output in one
+         * shared file and the rename would publish the corrupt copy */
+        tmp_path = g_strconcat (cache_path, ".XXXXXX", (char *) NULL);
+        tmp_fd = g_mkstemp (tmp_path);
+        if (tmp_fd == -1)
+        {
+            g_free (tmp_path);
+            g_free (cache_path);
+            return "/I_MUST_NOT_EXIST";
+        }
+        close (tmp_fd);
+
+        cache_vpath = vfs_path_from_str (tmp_path);
+        g_free (tmp_path);
+
+        if (sfs_vfmake (vpath, cache_vpath) == 0
+            && rename (vfs_path_get_last_path_str (cache_vpath), cache_path) == 0)
+        {
+            sfs_cache_write_info (cache_path, &st);
+            vfs_path_free (cache_vpath, TRUE);
+
+            cf = g_new (cachedfile, 1);
+            cf->name = g_strdup (vfs_path_as_str (vpath));
+            cf->cache = cache_path;
+            cf->persistent = TRUE;
+            head = g_slist_prepend (head, cf);
+
+            vfs_stamp_create (vfs_sfs_ops, (cachedfile *) head->data);
+            sfs_cache_trim ();
+            return cf->cache;
+        }
+
+        mc_unlink (cache_vpath);
+        vfs_path_free (cache_vpath, TRUE);
+        g_free (cache_path);
+        return "/I_MUST_NOT_EXIST";
+    }
+
+    // the parent cannot be stat'ed: fall back to a throw-away temporary copy
+    {
+        int handle;
+
+        handle = vfs_mkstemps (&cache_vpath, "sfs", vfs_path_get_last_path_str (vpath));
+
+        if (handle == -1)
+            return "/SOMEONE_PLAYING_DIRTY_TMP_TRICKS_ON_US";
+
+        close (handle);
+    }
 
     if (sfs_vfmake (vpath, cache_vpath) == 0)
     {
         cf = g_new (cachedfile, 1);
         cf->name = g_strdup (vfs_path_as_str (vpath));
         cf->cache = vfs_path_free (cache_vpath, FALSE);
+        cf->persistent = FALSE;
         head = g_slist_prepend (head, cf);
 
         vfs_stamp_create (vfs_sfs_ops, (cachedfile *) head->data);
@@ -386,7 +676,9 @@ sfs_free (vfsid id)
         vfs_die ("Free of thing which is unknown to me\n");
 
     which = (struct cachedfile *) cur->data;
-    unlink (which->cache);
+    // persistent copies stay in the cache directory for the next visit
+    if (!which->persistent)
+        unlink (which->cache);
     g_free (which->cache);
     g_free (which->name);
     g_free (which);
@@ -581,6 +873,7 @@ vfs_init_sfs (void)
     vfs_sfs_ops->stat = sfs_stat;
     vfs_sfs_ops->lstat = sfs_lstat;
     vfs_sfs_ops->fstat = local_fstat;
+    vfs_sfs_ops->fileno = local_fileno;
     vfs_sfs_ops->chmod = sfs_chmod;
     vfs_sfs_ops->chown = sfs_chown;
     vfs_sfs_ops->utime = sfs_utime;
@@ -9,6 +9,8 @@
 
 /*** global variables defined in .c file *********************************************************/
 
+extern int sfs_cache_limit;
+
 /*** declarations of public functions ************************************************************/
 
 void vfs_init_sfs (void);
@@ -53,6 +53,10 @@
 
 #define SHA1_DIGEST_LENGTH 20
 
+/* seconds between the keepalive packets sent over an idle session,
+   see sftpfs_keepalive() */
+#define SFTP_KEEPALIVE_INTERVAL 30
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -961,9 +965,34 @@ sftpfs_open_connection (struct vfs_s_super *super, GError **mcerror)
     // Since we have not set non-blocking, tell libssh2 we are blocking
     libssh2_session_set_blocking (sftpfs_super->session, 1);
 
+    /* Let the server know we are still there while the connection sits in the stamp list
+       waiting for the VFS timeout; otherwise NAT gateways and the server itself are free
+       to drop the idle TCP session and a revisit within the timeout reconnects cold */
+    libssh2_keepalive_config (sftpfs_super->session, 0, SFTP_KEEPALIVE_INTERVAL);
+
     return 0;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Send a keepalive packet over an idle connection.
+ *
+ * Called periodically from vfs_expire() for every stamped connection. libssh2 rate-limits
+ * the actual traffic to one packet per SFTP_KEEPALIVE_INTERVAL seconds.
+ *
+ * @param super connection data
+ */
+
+void
+sftpfs_keepalive (struct vfs_s_super *super)
+{
+    sftpfs_super_t *sftpfs_super = SFTP_SUPER (super);
+    int seconds_to_next = 0;
+
+    if (sftpfs_super->session != NULL)
+        (void) libssh2_keepalive_send (sftpfs_super->session, &seconds_to_next);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Close connection.
@@ -987,6 +1016,12 @@ sftpfs_close_connection (struct vfs_s_super *super, const char *shutdown_message
         sftpfs_super->sftp_session = NULL;
     }
 
+    if (sftpfs_super->attr_cache != NULL)
+    {
+        g_hash_table_destroy (sftpfs_super->attr_cache);
+        sftpfs_super->attr_cache = NULL;
+    }
+
     if (sftpfs_super->agent != NULL)
     {
         libssh2_agent_disconnect (sftpfs_super->agent);
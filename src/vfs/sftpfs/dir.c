@@ -26,6 +26,8 @@
 
 #include <config.h>
 
+#include <string.h>  // strlen()
+
 #include <libssh2.h>
 #include <libssh2_sftp.h>
 
@@ -44,6 +46,7 @@ typedef struct
 {
     LIBSSH2_SFTP_HANDLE *handle;
     sftpfs_super_t *super;
+    char *path;  // directory name as sent to the server, for the attribute cache
 } sftpfs_dir_data_t;
 
 /*** file scope variables ************************************************************************/
@@ -93,6 +96,7 @@ sftpfs_opendir (const vfs_path_t *vpath, GError **mcerror)
     sftpfs_dir = g_new0 (sftpfs_dir_data_t, 1);
     sftpfs_dir->handle = handle;
     sftpfs_dir->super = sftpfs_super;
+    sftpfs_dir->path = g_strndup (fixfname->str, fixfname->len);
 
     return (void *) sftpfs_dir;
 }
@@ -127,6 +131,21 @@ sftpfs_readdir (void *data, GError **mcerror)
     }
     while (rc == LIBSSH2_ERROR_EAGAIN);
 
+    if (rc > 0 && !DIR_IS_DOT (mem) && !DIR_IS_DOTDOT (mem))
+    {
+        char *fullname;
+
+        /* the reply carries the attributes of the entry: remember them so that
+           the stat calls that follow the listing cost no round trips */
+        fullname = g_strconcat (sftpfs_dir->path,
+                                IS_PATH_SEP (sftpfs_dir->path[strlen (sftpfs_dir->path) - 1])
+                                    ? ""
+                                    : PATH_SEP_STR,
+                                mem, (char *) NULL);
+        sftpfs_attr_cache_store (sftpfs_dir->super, fullname, &attrs);
+        g_free (fullname);
+    }
+
     return (rc != 0 ? vfs_dirent_init (NULL, mem, 0) : NULL);  // FIXME: inode
 }
 
@@ -148,6 +167,7 @@ sftpfs_closedir (void *data, GError **mcerror)
     mc_return_val_if_error (mcerror, -1);
 
     rc = libssh2_sftp_closedir (sftpfs_dir->handle);
+    g_free (sftpfs_dir->path);
     g_free (sftpfs_dir);
     return rc;
 }
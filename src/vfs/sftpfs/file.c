@@ -26,7 +26,8 @@
 
 #include <config.h>
 
-#include <errno.h>  // ENOENT, EACCES
+#include <errno.h>   // ENOENT, EACCES
+#include <string.h>  // memcpy()
 
 #include <libssh2.h>
 #include <libssh2_sftp.h>
@@ -42,6 +43,14 @@
 
 #define SFTP_FILE_HANDLER(a) ((sftpfs_file_handler_t *) a)
 
+/* One request of this size keeps many SFTP packets in flight inside libssh2,
+   hiding the round-trip time that dominates small sequential reads */
+#define SFTP_READAHEAD_SIZE  (256 * 1024)
+
+/* Small writes are collected up to this size before they are sent, so one
+   libssh2 call can pipeline them instead of paying a round trip per chunk */
+#define SFTP_WRITEBACK_SIZE  (256 * 1024)
+
 /*** file scope type declarations ****************************************************************/
 
 typedef struct
@@ -51,6 +60,17 @@ typedef struct
     LIBSSH2_SFTP_HANDLE *handle;
     int flags;
     mode_t mode;
+
+    /* read-ahead buffer: filled by one large pipelined request,
+       drained by the small reads of the callers */
+    char *rbuf;
+    size_t rbuf_len;  // bytes in rbuf
+    size_t rbuf_pos;  // first byte in rbuf not yet handed out
+
+    /* write-back buffer: collects the small writes of the callers,
+       flushed by one large pipelined request */
+    char *wbuf;
+    size_t wbuf_len;  // bytes in wbuf not yet sent
 } sftpfs_file_handler_t;
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -99,6 +119,86 @@ sftpfs_file__handle_error (sftpfs_super_t *super, int sftp_res, GError **mcerror
     return 0;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+sftpfs_drop_readahead (sftpfs_file_handler_t *file)
+{
+    file->rbuf_len = 0;
+    file->rbuf_pos = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Send the collected writes to the server.
+ *
+ * The buffer is emptied even on failure: its contents have no position to be retried at
+ * after an error.
+ *
+ * @param file    the file handler
+ * @param super   connection data
+ * @param mcerror pointer to the error handler
+ * @return 0 on success, negative value otherwise
+ */
+
+static int
+sftpfs_flush_writeback (sftpfs_file_handler_t *file, sftpfs_super_t *super, GError **mcerror)
+{
+    size_t done = 0;
+
+    while (done < file->wbuf_len)
+    {
+        ssize_t rc;
+
+        do
+        {
+            int err;
+
+            rc = libssh2_sftp_write (file->handle, file->wbuf + done, file->wbuf_len - done);
+            if (rc >= 0)
+                break;
+
+            err = sftpfs_file__handle_error (super, (int) rc, mcerror);
+            if (err < 0)
+            {
+                file->wbuf_len = 0;
+                return err;
+            }
+        }
+        while (rc == LIBSSH2_ERROR_EAGAIN);
+
+        done += (size_t) rc;
+    }
+
+    file->wbuf_len = 0;
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static ssize_t
+sftpfs_read_handle (sftpfs_file_handler_t *file, sftpfs_super_t *super, char *buffer, size_t count,
+                    GError **mcerror)
+{
+    ssize_t rc;
+
+    do
+    {
+        int err;
+
+        rc = libssh2_sftp_read (file->handle, buffer, count);
+        if (rc >= 0)
+            break;
+
+        err = sftpfs_file__handle_error (super, (int) rc, mcerror);
+        if (err < 0)
+            return err;
+    }
+    while (rc == LIBSSH2_ERROR_EAGAIN);
+
+    return rc;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -183,6 +283,10 @@ sftpfs_open_file (vfs_file_handler_t *fh, int flags, mode_t mode, GError **mcerr
 
     g_free (name);
 
+    // opening for writing is going to change the attributes
+    if (sftp_open_flags != LIBSSH2_FXF_READ)
+        sftpfs_attr_cache_forget (super, fixfname->str);
+
     file->flags = flags;
     file->mode = mode;
 
@@ -235,6 +339,14 @@ sftpfs_fstat (void *data, struct stat *buf, GError **mcerror)
     if (sftpfs_fh->handle == NULL)
         return -1;
 
+    // the reported size must include the collected writes
+    if (sftpfs_fh->wbuf_len != 0)
+    {
+        res = sftpfs_flush_writeback (sftpfs_fh, sftpfs_super, mcerror);
+        if (res < 0)
+            return res;
+    }
+
     do
     {
         int err;
@@ -284,23 +396,50 @@ sftpfs_read_file (vfs_file_handler_t *fh, char *buffer, size_t count, GError **m
 
     super = SFTP_SUPER (VFS_FILE_HANDLER_SUPER (fh));
 
-    do
+    // collected writes must reach the server before anything is read back
+    if (file->wbuf_len != 0)
     {
-        int err;
+        rc = sftpfs_flush_writeback (file, super, mcerror);
+        if (rc < 0)
+            return rc;
+    }
 
-        rc = libssh2_sftp_read (file->handle, buffer, count);
-        if (rc >= 0)
-            break;
+    if (file->rbuf_pos >= file->rbuf_len)
+    {
+        /* requests of read-ahead size and beyond already keep the pipeline full
+           on their own; hand them through without the extra copy */
+        if (count >= SFTP_READAHEAD_SIZE)
+        {
+            rc = sftpfs_read_handle (file, super, buffer, count, mcerror);
+            if (rc >= 0)
+                fh->pos = (off_t) libssh2_sftp_tell64 (file->handle);
+            return rc;
+        }
 
-        err = sftpfs_file__handle_error (super, (int) rc, mcerror);
-        if (err < 0)
-            return err;
+        if (file->rbuf == NULL)
+            file->rbuf = g_malloc (SFTP_READAHEAD_SIZE);
+
+        rc = sftpfs_read_handle (file, super, file->rbuf, SFTP_READAHEAD_SIZE, mcerror);
+        if (rc <= 0)
+        {
+            if (rc == 0)
+                fh->pos = (off_t) libssh2_sftp_tell64 (file->handle);
+            return rc;
+        }
+
+        file->rbuf_len = (size_t) rc;
+        file->rbuf_pos = 0;
     }
-    while (rc == LIBSSH2_ERROR_EAGAIN);
 
-    fh->pos = (off_t) libssh2_sftp_tell64 (file->handle);
+    count = MIN (count, file->rbuf_len - file->rbuf_pos);
+    memcpy (buffer, file->rbuf + file->rbuf_pos, count);
+    file->rbuf_pos += count;
 
-    return rc;
+    // the handle position is ahead of the data handed out so far
+    fh->pos =
+        (off_t) libssh2_sftp_tell64 (file->handle) - (off_t) (file->rbuf_len - file->rbuf_pos);
+
+    return (ssize_t) count;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -325,23 +464,53 @@ sftpfs_write_file (vfs_file_handler_t *fh, const char *buffer, size_t count, GEr
 
     mc_return_val_if_error (mcerror, -1);
 
-    fh->pos = (off_t) libssh2_sftp_tell64 (file->handle);
+    sftpfs_drop_readahead (file);
 
-    do
+    /* writes of write-back size and beyond keep the pipeline full on their own;
+       hand them through without the extra copy */
+    if (count >= SFTP_WRITEBACK_SIZE)
     {
         int err;
 
-        rc = libssh2_sftp_write (file->handle, buffer, count);
-        if (rc >= 0)
-            break;
+        err = sftpfs_flush_writeback (file, super, mcerror);
+        if (err < 0)
+            return err;
 
-        err = sftpfs_file__handle_error (super, (int) rc, mcerror);
+        fh->pos = (off_t) libssh2_sftp_tell64 (file->handle);
+
+        do
+        {
+            rc = libssh2_sftp_write (file->handle, buffer, count);
+            if (rc >= 0)
+                break;
+
+            err = sftpfs_file__handle_error (super, (int) rc, mcerror);
+            if (err < 0)
+                return err;
+        }
+        while (rc == LIBSSH2_ERROR_EAGAIN);
+
+        return rc;
+    }
+
+    if (file->wbuf == NULL)
+        file->wbuf = g_malloc (SFTP_WRITEBACK_SIZE);
+    else if (file->wbuf_len + count > SFTP_WRITEBACK_SIZE)
+    {
+        int err;
+
+        err = sftpfs_flush_writeback (file, super, mcerror);
         if (err < 0)
             return err;
     }
-    while (rc == LIBSSH2_ERROR_EAGAIN);
 
-    return rc;
+    memcpy (file->wbuf + file->wbuf_len, buffer, count);
+    file->wbuf_len += count;
+
+    // the handle position is behind the data taken over so far
+    fh->pos = (off_t) libssh2_sftp_tell64 (file->handle) + (off_t) file->wbuf_len;
+
+    return (ssize_t) count;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -358,13 +527,24 @@ sftpfs_write_file (vfs_file_handler_t *fh, const char *buffer, size_t count, GEr
 int
 sftpfs_close_file (vfs_file_handler_t *fh, GError **mcerror)
 {
-    int ret;
+    sftpfs_file_handler_t *file = SFTP_FILE_HANDLER (fh);
+    int ret = 0;
 
     mc_return_val_if_error (mcerror, -1);
 
-    ret = libssh2_sftp_close (SFTP_FILE_HANDLER (fh)->handle);
+    // a write that could not be delivered must fail the close, not get lost silently
+    if (file->wbuf_len != 0
+        && sftpfs_flush_writeback (file, SFTP_SUPER (VFS_FILE_HANDLER_SUPER (fh)), mcerror) < 0)
+        ret = -1;
 
-    return ret == 0 ? 0 : -1;
+    if (libssh2_sftp_close (file->handle) != 0)
+        ret = -1;
+
+    MC_PTR_FREE (file->rbuf);
+    MC_PTR_FREE (file->wbuf);
+    sftpfs_drop_readahead (file);
+
+    return ret;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -387,6 +567,12 @@ sftpfs_lseek (vfs_file_handler_t *fh, off_t offset, int whence, GError **mcerror
 
     mc_return_val_if_error (mcerror, 0);
 
+    // buffered data is for the old position
+    sftpfs_drop_readahead (file);
+    if (file->wbuf_len != 0
+        && sftpfs_flush_writeback (file, SFTP_SUPER (VFS_FILE_HANDLER_SUPER (fh)), mcerror) < 0)
+        return 0;
+
     switch (whence)
     {
     case SEEK_SET:
@@ -47,8 +47,18 @@ GString *sftpfs_filename_buffer = NULL;
 
 /*** file scope macro definitions ****************************************************************/
 
+/* How long attributes received from the server stay usable. The cache only has
+   to carry the listing of a directory over the stat calls that follow it */
+#define SFTP_ATTR_CACHE_TTL (10 * G_USEC_PER_SEC)
+
 /*** file scope type declarations ****************************************************************/
 
+typedef struct
+{
+    LIBSSH2_SFTP_ATTRIBUTES attrs;
+    gint64 stored_at;  // g_get_monotonic_time () of the reception
+} sftpfs_attr_cache_entry_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -127,6 +137,9 @@ sftpfs_stat_init (sftpfs_super_t **super, const vfs_path_element_t **path_elemen
 
     fixfname = sftpfs_fix_filename ((*path_element)->path);
 
+    if (sftpfs_attr_cache_lookup (*super, fixfname->str, stat_type, attrs))
+        return 0;
+
     do
     {
         res = libssh2_sftp_stat_ex ((*super)->sftp_session, fixfname->str, fixfname->len, stat_type,
@@ -145,6 +158,11 @@ sftpfs_stat_init (sftpfs_super_t **super, const vfs_path_element_t **path_elemen
     }
     while (res == LIBSSH2_ERROR_EAGAIN);
 
+    /* a STAT result must not be cached: for a symlink it describes the target,
+       and the cache is keyed by the link name */
+    if (res >= 0 && stat_type == LIBSSH2_SFTP_LSTAT)
+        sftpfs_attr_cache_store (*super, fixfname->str, attrs);
+
     return res;
 }
 
@@ -272,6 +290,83 @@ sftpfs_attr_to_stat (const LIBSSH2_SFTP_ATTRIBUTES *attrs, struct stat *s)
         s->st_mode = attrs->permissions;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remember the attributes of @path so that a following lstat () is served
+ * without a round trip. READDIR replies carry the attributes of every entry,
+ * which would otherwise be thrown away and requested again one file at a time.
+ *
+ * @param super extra data for SFTP connection
+ * @param path  file name as sent to the server, see sftpfs_fix_filename()
+ * @param attrs attributes received from the server
+ */
+
+void
+sftpfs_attr_cache_store (sftpfs_super_t *super, const char *path,
+                         const LIBSSH2_SFTP_ATTRIBUTES *attrs)
+{
+    sftpfs_attr_cache_entry_t *entry;
+
+    if (super->attr_cache == NULL)
+        super->attr_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    entry = g_new (sftpfs_attr_cache_entry_t, 1);
+    entry->attrs = *attrs;
+    entry->stored_at = g_get_monotonic_time ();
+
+    g_hash_table_replace (super->attr_cache, g_strdup (path), entry);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Serve a stat request from the attributes remembered for @path, if they are
+ * still young enough. A LIBSSH2_SFTP_STAT request is served only for entries
+ * that are not symlinks: for a symlink it has to describe the target.
+ *
+ * @return TRUE if @attrs were filled
+ */
+
+gboolean
+sftpfs_attr_cache_lookup (sftpfs_super_t *super, const char *path, int stat_type,
+                          LIBSSH2_SFTP_ATTRIBUTES *attrs)
+{
+    sftpfs_attr_cache_entry_t *entry;
+
+    if (super->attr_cache == NULL)
+        return FALSE;
+
+    entry = g_hash_table_lookup (super->attr_cache, path);
+    if (entry == NULL)
+        return FALSE;
+
+    if (g_get_monotonic_time () - entry->stored_at > SFTP_ATTR_CACHE_TTL)
+    {
+        g_hash_table_remove (super->attr_cache, path);
+        return FALSE;
+    }
+
+    if (stat_type != LIBSSH2_SFTP_LSTAT
+        && ((entry->attrs.flags & LIBSSH2_SFTP_ATTR_PERMISSIONS) == 0
+            || LIBSSH2_SFTP_S_ISLNK (entry->attrs.permissions)))
+        return FALSE;
+
+    *attrs = entry->attrs;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Drop the remembered attributes of @path: they are about to change.
+ */
+
+void
+sftpfs_attr_cache_forget (sftpfs_super_t *super, const char *path)
+{
+    if (super->attr_cache != NULL)
+        g_hash_table_remove (super->attr_cache, path);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Getting information about a symbolic link.
@@ -414,6 +509,8 @@ sftpfs_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2, GError **mce
         }
     }
     while (res == LIBSSH2_ERROR_EAGAIN);
+
+    sftpfs_attr_cache_forget (super, tmp_path);
     g_free (tmp_path);
 
     return 0;
@@ -470,6 +567,8 @@ sftpfs_utime (const vfs_path_t *vpath, time_t atime, time_t mtime, GError **mcer
     }
     while (res == LIBSSH2_ERROR_EAGAIN);
 
+    sftpfs_attr_cache_forget (super, fixfname->str);
+
     return res;
 }
 
@@ -522,6 +621,8 @@ sftpfs_chmod (const vfs_path_t *vpath, mode_t mode, GError **mcerror)
     }
     while (res == LIBSSH2_ERROR_EAGAIN);
 
+    sftpfs_attr_cache_forget (super, fixfname->str);
+
     return res;
 }
 
@@ -558,6 +659,8 @@ sftpfs_unlink (const vfs_path_t *vpath, GError **mcerror)
     }
     while (res == LIBSSH2_ERROR_EAGAIN);
 
+    sftpfs_attr_cache_forget (super, fixfname->str);
+
     return res;
 }
 
@@ -607,6 +710,9 @@ sftpfs_rename (const vfs_path_t *vpath1, const vfs_path_t *vpath2, GError **mcer
         }
     }
     while (res == LIBSSH2_ERROR_EAGAIN);
+
+    sftpfs_attr_cache_forget (super, fixfname->str);
+    sftpfs_attr_cache_forget (super, tmp_path);
     g_free (tmp_path);
 
     return 0;
@@ -56,6 +56,9 @@ typedef struct
     int socket_handle;
     const char *ip_address;
     vfs_path_element_t *original_connection_info;
+
+    GHashTable *attr_cache;  /* fixed file name -> attributes already received from the server,
+                                see sftpfs_attr_cache_store() */
 } sftpfs_super_t;
 
 /*** global variables defined in .c file *********************************************************/
@@ -79,6 +82,11 @@ gboolean sftpfs_op_init (sftpfs_super_t **super, const vfs_path_element_t **path
                          const vfs_path_t *vpath, GError **mcerror);
 
 void sftpfs_attr_to_stat (const LIBSSH2_SFTP_ATTRIBUTES *attrs, struct stat *s);
+void sftpfs_attr_cache_store (sftpfs_super_t *super, const char *path,
+                              const LIBSSH2_SFTP_ATTRIBUTES *attrs);
+gboolean sftpfs_attr_cache_lookup (sftpfs_super_t *super, const char *path, int stat_type,
+                                   LIBSSH2_SFTP_ATTRIBUTES *attrs);
+void sftpfs_attr_cache_forget (sftpfs_super_t *super, const char *path);
 int sftpfs_lstat (const vfs_path_t *vpath, struct stat *buf, GError **mcerror);
 int sftpfs_stat (const vfs_path_t *vpath, struct stat *buf, GError **mcerror);
 int sftpfs_readlink (const vfs_path_t *vpath, char *buf, size_t size, GError **mcerror);
@@ -92,6 +100,7 @@ void sftpfs_fill_connection_data_from_config (struct vfs_s_super *super, GError
 int sftpfs_open_connection (struct vfs_s_super *super, GError **mcerror);
 void sftpfs_close_connection (struct vfs_s_super *super, const char *shutdown_message,
                               GError **mcerror);
+void sftpfs_keepalive (struct vfs_s_super *super);
 
 vfs_file_handler_t *sftpfs_fh_new (struct vfs_s_inode *ino, gboolean changed);
 
@@ -668,6 +668,20 @@ sftpfs_cb_fill_names (struct vfs_class *me, fill_names_f func)
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Callback for keepalive VFS function.
+ * Send a keepalive packet over the stamped (idle) connection.
+ *
+ * @param id memory id of VFS
+ */
+
+static void
+sftpfs_cb_keepalive (vfsid id)
+{
+    sftpfs_keepalive (VFS_SUPER (id));
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Callback for checking if connection is equal to existing connection.
@@ -847,6 +861,8 @@ vfs_init_sftpfs (void)
     vfs_sftpfs_ops->rename = sftpfs_cb_rename;
     vfs_sftpfs_ops->ferrno = sftpfs_cb_errno;
 
+    vfs_sftpfs_ops->keepalive = sftpfs_cb_keepalive;
+
     sftpfs_subclass.archive_same = sftpfs_archive_same;
     sftpfs_subclass.new_archive = sftpfs_new_archive;
     sftpfs_subclass.open_archive = sftpfs_open_archive;
@@ -969,6 +969,7 @@ shell_dir_load (struct vfs_class *me, struct vfs_s_inode *dir, const char *remot
     struct vfs_s_entry *ent = NULL;
     char *quoted_path;
     int reply_code;
+    vfs_s_line_reader_t reader;
 
     /*
      * Simple SHELL debug interface :]
@@ -989,12 +990,15 @@ shell_dir_load (struct vfs_class *me, struct vfs_s_inode *dir, const char *remot
 
     ent = vfs_s_generate_entry (me, NULL, dir, 0);
 
+    /* the helper streams the whole listing in one go and terminates it with a reply line,
+       so the lines can be read ahead in large chunks and parsed while the remote still writes */
+    vfs_s_line_reader_init (&reader, SHELL_SUPER (super)->sockr);
+
     while (TRUE)
     {
         int res;
 
-        res =
-            vfs_s_get_line_interruptible (me, buffer, sizeof (buffer), SHELL_SUPER (super)->sockr);
+        res = vfs_s_read_line_interruptible (me, &reader, buffer, sizeof (buffer));
 
         if ((res == 0) || (res == EINTR))
         {
@@ -0,0 +1,302 @@
+/*
+   Virtual File System: GNU Tar file system.
+   Persistent member index.
+
+   Copyright (C) 1995-2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * \file
+ * \brief Source: Virtual File System: GNU Tar file system: persistent member index
+ *
+ * The deferral index built by the archive scan (see tar.c) is saved to the
+ * cache directory and read back when the same archive is entered again with
+ * unchanged size and mtime, so that repeated visits skip the scan pass
+ * entirely.  The copy records raw header offsets, therefore a stale one is
+ * never used: any change of the archive changes its mtime or size.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <string.h>  // strlen()
+#include <unistd.h>  // unlink()
+
+#include "lib/global.h"
+#include "lib/mcconfig.h"  // mc_config_get_cache_path()
+
+#include "tar-internal.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* one file per archive under the cache directory */
+#define TAR_INDEX_DIR   "tarfs"
+#define TAR_INDEX_MAGIC "mc tarfs index 1"
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+tar_index_file_path (const char *archive_name)
+{
+    char *checksum, *name, *path;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, archive_name, -1);
+    checksum[24] = '\0';
+    name = g_strconcat (checksum, ".index", (char *) NULL);
+    path = g_build_filename (mc_config_get_cache_path (), TAR_INDEX_DIR, name, (char *) NULL);
+    g_free (name);
+    g_free (checksum);
+
+    return path;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+tar_index_save_dir (gpointer key, gpointer value, gpointer user_data)
+{
+    const char *dir_name = (const char *) key;
+    const tar_deferred_dir_t *dd = (const tar_deferred_dir_t *) value;
+    FILE *f = (FILE *) user_data;
+    guint i;
+
+    /* directory names are length-prefixed: they may hold any byte but NUL,
+     * including the newline that terminates every other record */
+    fprintf (f, "%zu %u %u\n%s\n", strlen (dir_name), dd->offsets->len, dd->subdirs->len,
+             dir_name);
+
+    for (i = 0; i < dd->offsets->len; i++)
+        fprintf (f, "%lld\n", (long long) g_array_index (dd->offsets, off_t, i));
+
+    for (i = 0; i < dd->subdirs->len; i++)
+    {
+        const char *subdir = (const char *) g_ptr_array_index (dd->subdirs, i);
+
+        fprintf (f, "%zu\n%s\n", strlen (subdir), subdir);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Read a length-prefixed string. @p is left after the terminating newline.
+ * Returns NULL when the record is truncated or malformed.
+ */
+static char *
+tar_index_read_string (const char **p, const char *end)
+{
+    long long len;
+    char *s, *num_end;
+
+    len = g_ascii_strtoll (*p, &num_end, 10);
+    if (num_end == *p || *num_end != '\n' || len < 0)
+        return NULL;
+
+    num_end++;  // skip '\n'
+    if (len >= end - num_end || num_end[len] != '\n' || memchr (num_end, '\0', len) != NULL)
+        return NULL;
+
+    s = g_strndup (num_end, len);
+    *p = num_end + len + 1;
+
+    return s;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Save the deferral index of @archive so that the next visit can skip the
+ * scan pass. Failures are silent: the index is a cache, the archive itself
+ * is authoritative.
+ */
+void
+tar_index_save (struct vfs_s_super *archive)
+{
+    tar_super_t *arch = TAR_SUPER (archive);
+    char *path, *tmp_path, *dir_path;
+    FILE *f;
+
+    path = tar_index_file_path (archive->name);
+    tmp_path = g_strconcat (path, ".tmp", (char *) NULL);
+
+    dir_path = g_path_get_dirname (path);
+    g_mkdir_with_parents (dir_path, 0700);
+    g_free (dir_path);
+
+    f = fopen (tmp_path, "w");
+    if (f != NULL)
+    {
+        gboolean ok;
+
+        fprintf (f, "%s\n", TAR_INDEX_MAGIC);
+        fprintf (f, "%lld %lld %d\n", (long long) arch->st.st_size, (long long) arch->st.st_mtime,
+                 (int) arch->type);
+        fprintf (f, "%u\n", g_hash_table_size (arch->deferred));
+
+        g_hash_table_foreach (arch->deferred, tar_index_save_dir, f);
+
+        ok = fclose (f) == 0;
+        if (ok)
+            ok = rename (tmp_path, path) == 0;
+        if (!ok)
+            unlink (tmp_path);
+    }
+
+    g_free (tmp_path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Restore the deferral index persisted by tar_index_save () into the (empty)
+ * deferral table of @archive. A copy written for a different size or mtime of
+ * the archive is left unused.
+ * Returns TRUE when the table was filled and the scan pass can be skipped.
+ */
+gboolean
+tar_index_load (struct vfs_s_super *archive)
+{
+    tar_super_t *arch = TAR_SUPER (archive);
+    char *path, *content = NULL;
+    gsize length = 0;
+    const char *p, *end;
+    char *num_end;
+    long long hdr[3];
+    long long ndirs, i;
+
+    path = tar_index_file_path (archive->name);
+    if (!g_file_get_contents (path, &content, &length, NULL))
+    {
+        g_free (path);
+        return FALSE;
+    }
+    g_free (path);
+
+    if (!g_str_has_prefix (content, TAR_INDEX_MAGIC "\n")
+        || memchr (content, '\0', length) != NULL)
+        goto fail;
+
+    p = content + strlen (TAR_INDEX_MAGIC "\n");
+    end = content + length;
+
+    for (i = 0; i < 3; i++)
+    {
+        hdr[i] = g_ascii_strtoll (p, &num_end, 10);
+        p = num_end;
+    }
+    while (p < end && *p != '\n')
+        p++;
+    if (p < end)
+        p++;
+
+    if (hdr[0] != (long long) arch->st.st_size || hdr[1] != (long long) arch->st.st_mtime
+        || hdr[2] < TAR_UNKNOWN || hdr[2] > TAR_GNU)
+        goto fail;
+
+    ndirs = g_ascii_strtoll (p, &num_end, 10);
+    if (num_end == p || *num_end != '\n' || ndirs < 0)
+        goto fail;
+    p = num_end + 1;
+
+    for (i = 0; i < ndirs; i++)
+    {
+        char *dir_name;
+        tar_deferred_dir_t *dd;
+        long long name_len, noffsets, nsubdirs, j;
+
+        name_len = g_ascii_strtoll (p, &num_end, 10);
+        if (num_end == p || *num_end != ' ' || name_len < 0)
+            goto fail;
+        p = num_end + 1;
+        noffsets = g_ascii_strtoll (p, &num_end, 10);
+        if (num_end == p || *num_end != ' ' || noffsets < 0)
+            goto fail;
+        p = num_end + 1;
+        nsubdirs = g_ascii_strtoll (p, &num_end, 10);
+        if (num_end == p || *num_end != '\n' || nsubdirs < 0)
+            goto fail;
+        p = num_end + 1;
+
+        if (name_len >= end - p || p[name_len] != '\n')
+            goto fail;
+        dir_name = g_strndup (p, name_len);
+        p += name_len + 1;
+
+        if (g_hash_table_lookup (arch->deferred, dir_name) != NULL)
+        {
+            g_free (dir_name);
+            goto fail;
+        }
+
+        dd = g_new (tar_deferred_dir_t, 1);
+        dd->offsets = g_array_new (FALSE, FALSE, sizeof (off_t));
+        dd->subdirs = g_ptr_array_new_with_free_func (g_free);
+        g_hash_table_insert (arch->deferred, dir_name, dd);
+
+        for (j = 0; j < noffsets; j++)
+        {
+            long long off;
+            off_t off_val;
+
+            off = g_ascii_strtoll (p, &num_end, 10);
+            if (num_end == p || *num_end != '\n' || off < 0)
+                goto fail;
+            p = num_end + 1;
+
+            off_val = (off_t) off;
+            g_array_append_val (dd->offsets, off_val);
+        }
+
+        for (j = 0; j < nsubdirs; j++)
+        {
+            char *subdir;
+
+            subdir = tar_index_read_string (&p, end);
+            if (subdir == NULL)
+                goto fail;
+            g_ptr_array_add (dd->subdirs, subdir);
+        }
+    }
+
+    g_free (content);
+    arch->type = (enum archive_format) hdr[2];
+
+    return TRUE;
+
+fail:
+    g_free (content);
+    g_hash_table_remove_all (arch->deferred);
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
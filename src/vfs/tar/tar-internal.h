@@ -218,6 +218,13 @@ enum archive_format
     TAR_GNU           // almost same as OLDGNU_FORMAT
 };
 
+/* what tar_super_t::deferred holds per directory, see tar_defer_entry() */
+typedef struct
+{
+    GArray *offsets;     // header offsets of the members of the directory
+    GPtrArray *subdirs;  // names of subdirectories seen only in deeper member paths
+} tar_deferred_dir_t;
+
 typedef struct
 {
     struct vfs_s_super base;  // base class
@@ -226,6 +233,11 @@ typedef struct
     struct stat st;
     enum archive_format type;   // type of the archive
     union block *record_start;  // start of record of archive
+
+    GHashTable *deferred;    /* directory name -> tar_deferred_dir_t: members not yet in
+                                the inode tree. NULL when laziness is off */
+    gboolean materializing;  // replaying deferred members: do not defer them again
+    gboolean defer_unsafe;   // a pax global header was seen: members must be read in order
 } tar_super_t;
 
 struct xheader
@@ -319,8 +331,13 @@ gboolean tar_xheader_decode (struct tar_stat_info *st);
 gboolean tar_xheader_read (tar_super_t *archive, struct xheader *xhdr, union block *header,
                            off_t size);
 gboolean tar_xheader_decode_global (struct xheader *xhdr);
+void tar_xheader_forget_global (void);
 void tar_xheader_destroy (struct xheader *xhdr);
 
+/* tar-index.c */
+void tar_index_save (struct vfs_s_super *archive);
+gboolean tar_index_load (struct vfs_s_super *archive);
+
 /*** inline functions ****************************************************************************/
 
 /**
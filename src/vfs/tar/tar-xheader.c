@@ -950,6 +950,18 @@ tar_xheader_decode_global (struct xheader *xhdr)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Drop the overrides collected from global extended headers. Used when an archive
+ * is rescanned from the beginning.
+ */
+void
+tar_xheader_forget_global (void)
+{
+    xheader_list_destroy (&global_header_override_list);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 void
 tar_xheader_destroy (struct xheader *xhdr)
 {
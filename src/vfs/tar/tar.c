@@ -145,6 +145,11 @@ static struct vfs_class *vfs_tarfs_ops = VFS_CLASS (&tarfs_subclass);
 
 static struct timespec start_time;
 
+/* the entry lookup of the generic layer, wrapped by tar_find_entry() */
+static struct vfs_s_entry *(*tar_find_entry_default) (struct vfs_class *me,
+                                                      struct vfs_s_inode *root, const char *path,
+                                                      int follow, int flags) = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -298,6 +303,87 @@ tar_skip_member (tar_super_t *archive, struct vfs_s_inode *inode)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Reposition the archive stream so that the next tar_find_next_block() returns
+ * the block at @offset. @offset must be a block boundary.
+ */
+static void
+tar_rewind (tar_super_t *archive, off_t offset)
+{
+    mc_lseek (archive->fd, offset, SEEK_SET);
+    record_start_block = offset / BLOCKSIZE;
+    // force a read on the next tar_find_next_block()
+    record_end = archive->record_start;
+    current_block = archive->record_start;
+    hit_eof = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Return the record of @dir_name in the deferral table, making it and the
+ * records of all ancestor directories on first use. Each ancestor learns the
+ * name of its child, so that tar_materialize_dir() can grow directory stubs
+ * even when no member lives in the ancestor directly.
+ * Takes ownership of @dir_name.
+ */
+static tar_deferred_dir_t *
+tar_defer_dir (tar_super_t *arch, char *dir_name)
+{
+    tar_deferred_dir_t *dd;
+
+    dd = g_hash_table_lookup (arch->deferred, dir_name);
+    if (dd != NULL)
+    {
+        g_free (dir_name);
+        return dd;
+    }
+
+    dd = g_new (tar_deferred_dir_t, 1);
+    dd->offsets = g_array_new (FALSE, FALSE, sizeof (off_t));
+    dd->subdirs = g_ptr_array_new_with_free_func (g_free);
+    g_hash_table_insert (arch->deferred, dir_name, dd);
+
+    if (*dir_name != '\0')
+    {
+        tar_deferred_dir_t *parent;
+        const char *p;
+        const char *base;
+
+        p = strrchr (dir_name, PATH_SEP);
+        base = p == NULL ? dir_name : p + 1;
+        parent =
+            tar_defer_dir (arch, p == NULL ? g_strdup ("") : g_strndup (dir_name, p - dir_name));
+        g_ptr_array_add (parent->subdirs, g_strdup (base));
+    }
+
+    return dd;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Remember the member described by current_stat_info for later materialization:
+ * file the offset of its first header block under the name of its directory.
+ */
+static void
+tar_defer_entry (struct vfs_s_super *archive, off_t member_start)
+{
+    tar_super_t *arch = TAR_SUPER (archive);
+    const char *file_name = current_stat_info.file_name;
+    const char *p;
+    char *dir_name;
+    tar_deferred_dir_t *dd;
+
+    p = strrchr (file_name, PATH_SEP);
+    dir_name = p == NULL ? g_strdup ("") : g_strndup (file_name, p - file_name);
+
+    dd = tar_defer_dir (arch, dir_name);
+    g_array_append_val (dd->offsets, member_start);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /**
  * Return the number of bytes comprising the space between @pointer through the end
  * of the current buffer of blocks. This space is available for filling with data,
@@ -514,16 +600,64 @@ tar_free_inode (struct vfs_class *me, struct vfs_s_inode *ino)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+tar_deferred_dir_free (gpointer data)
+{
+    tar_deferred_dir_t *dd = (tar_deferred_dir_t *) data;
+
+    g_array_free (dd->offsets, TRUE);
+    g_ptr_array_free (dd->subdirs, TRUE);
+    g_free (dd);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Create the inode for the member described by current_stat_info.
+ * The inode tree is not accessed here: the returned inode is linked into it
+ * by tar_link_entry() after the member data has been consumed.
+ * Returns NULL for hard links whose inode is found at link time.
+ */
+static struct vfs_s_inode *
+tar_create_inode (struct vfs_class *me, struct vfs_s_super *archive, union block *header)
+{
+    struct vfs_s_inode *inode;
+
+    if (header->header.typeflag == LNKTYPE)
+        return NULL;
+
+    inode = vfs_s_new_inode (me, archive, &current_stat_info.stat);
+    // assgin timestamps after decoding of extended headers
+    inode->st.st_mtime = current_stat_info.mtime.tv_sec;
+    inode->st.st_atime = current_stat_info.atime.tv_sec;
+    inode->st.st_ctime = current_stat_info.ctime.tv_sec;
+
+    if (current_stat_info.link_name != NULL && *current_stat_info.link_name != '\0')
+        inode->linkname = g_strdup (current_stat_info.link_name);
+
+    return inode;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Link @inode into the inode tree under the name in current_stat_info.
+ * Looking up the parent directory (or a hard link target) may materialize other
+ * directories and thus overwrite both current_stat_info and the block buffer,
+ * so everything needed from them is copied up front.
+ */
 static read_header
-tar_insert_entry (struct vfs_class *me, struct vfs_s_super *archive, union block *header,
-                  struct vfs_s_inode **inode)
+tar_link_entry (struct vfs_class *me, struct vfs_s_super *archive, char typeflag,
+                struct vfs_s_inode *inode)
 {
     char *p, *q;
-    char *file_name = current_stat_info.file_name;
-    char *link_name = current_stat_info.link_name;
+    char *file_name = g_strdup (current_stat_info.file_name);
+    char *link_name = g_strdup (current_stat_info.link_name);
+    const mode_t mode = current_stat_info.stat.st_mode;
     size_t len;
     struct vfs_s_inode *parent;
     struct vfs_s_entry *entry;
+    read_header status = HEADER_FAILURE;
 
     p = strrchr (file_name, PATH_SEP);
     if (p == NULL)
@@ -540,47 +674,49 @@ tar_insert_entry (struct vfs_class *me, struct vfs_s_super *archive, union block
 
     parent = vfs_s_find_inode (me, archive, q, LINK_NO_FOLLOW, FL_MKDIR);
     if (parent == NULL)
-        return HEADER_FAILURE;
-
-    *inode = NULL;
+        goto done;
 
-    if (header->header.typeflag == LNKTYPE)
+    if (typeflag == LNKTYPE)
     {
-        if (*link_name != '\0')
+        if (link_name != NULL && *link_name != '\0')
         {
             len = strlen (link_name);
             if (IS_PATH_SEP (link_name[len - 1]))
                 link_name[len - 1] = '\0';
 
-            *inode = vfs_s_find_inode (me, archive, link_name, LINK_NO_FOLLOW, FL_NONE);
+            inode = vfs_s_find_inode (me, archive, link_name, LINK_NO_FOLLOW, FL_NONE);
         }
 
-        if (*inode == NULL)
-            return HEADER_FAILURE;
+        if (inode == NULL)
+            goto done;
     }
-    else
+    else if (S_ISDIR (mode))
     {
-        if (S_ISDIR (current_stat_info.stat.st_mode))
+        /* look at the parent directly: going through tar_find_entry() here would
+         * materialize the contents of a directory that is not linked in yet */
+        entry = VFS_ENTRY (g_hash_table_lookup (parent->subdir_hash, p));
+        if (entry != NULL)
         {
-            entry = VFS_SUBCLASS (me)->find_entry (me, parent, p, LINK_NO_FOLLOW, FL_NONE);
-            if (entry != NULL)
-                return HEADER_SUCCESS;
+            // the directory is already in the tree: drop the fresh inode
+            vfs_s_free_inode (me, inode);
+            inode = NULL;
+            status = HEADER_SUCCESS;
+            goto done;
         }
-
-        *inode = vfs_s_new_inode (me, archive, &current_stat_info.stat);
-        // assgin timestamps after decoding of extended headers
-        (*inode)->st.st_mtime = current_stat_info.mtime.tv_sec;
-        (*inode)->st.st_atime = current_stat_info.atime.tv_sec;
-        (*inode)->st.st_ctime = current_stat_info.ctime.tv_sec;
-
-        if (link_name != NULL && *link_name != '\0')
-            (*inode)->linkname = g_strdup (link_name);
     }
 
-    entry = vfs_s_new_entry (me, p, *inode);
+    entry = vfs_s_new_entry (me, p, inode);
     vfs_s_insert_entry (me, parent, entry);
+    inode = NULL;
+    status = HEADER_SUCCESS;
 
-    return HEADER_SUCCESS;
+done:
+    if (status != HEADER_SUCCESS && inode != NULL && typeflag != LNKTYPE)
+        vfs_s_free_inode (me, inode);
+    g_free (file_name);
+    g_free (link_name);
+
+    return status;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -592,6 +728,7 @@ tar_read_header (struct vfs_class *me, struct vfs_s_super *archive)
     union block *header;
     union block *next_long_name = NULL, *next_long_link = NULL;
     read_header status = HEADER_SUCCESS;
+    off_t member_start = -1;
 
     while (TRUE)
     {
@@ -603,6 +740,10 @@ tar_read_header (struct vfs_class *me, struct vfs_s_super *archive)
             goto ret;
         }
 
+        // where the member begins, including long name and extended header blocks
+        if (member_start < 0)
+            member_start = BLOCKSIZE * tar_current_block_ordinal (arch);
+
         status = tar_checksum (header);
         if (status != HEADER_SUCCESS)
             goto ret;
@@ -703,6 +844,9 @@ tar_read_header (struct vfs_class *me, struct vfs_s_super *archive)
                 arch->type = TAR_POSIX;
 
             memset (&xhdr, 0, sizeof (xhdr));
+            /* the decoded overrides apply to the members that follow, so deferred
+             * members must not be replayed out of order any more */
+            arch->defer_unsafe = TRUE;
             tar_xheader_read (arch, &xhdr, header, OFF_FROM_HEADER (header->header.size));
             ok = tar_xheader_decode_global (&xhdr);
             tar_xheader_destroy (&xhdr);
@@ -723,7 +867,6 @@ tar_read_header (struct vfs_class *me, struct vfs_s_super *archive)
         struct posix_header const *h = &header->header;
         char *file_name = NULL;
         char *link_name;
-        struct vfs_s_inode *inode = NULL;
 
         g_free (recent_long_name);
 
@@ -803,25 +946,54 @@ tar_read_header (struct vfs_class *me, struct vfs_s_super *archive)
         // Do this after decoding of all headers occupied with long file/directory name
         canonicalize_pathname (current_stat_info.file_name);
 
-        status = tar_insert_entry (me, archive, header, &inode);
-        if (status != HEADER_SUCCESS)
-        {
-            message (D_ERROR, MSG_ERROR, _ ("Inconsistent tar archive"));
-            goto ret;
-        }
-
         if (recent_long_name == next_long_name)
             recent_long_name = NULL;
 
         if (recent_long_link == next_long_link)
             recent_long_link = NULL;
 
-        if (tar_skip_member (arch, inode))
-            status = HEADER_SUCCESS;
-        else if (hit_eof)
-            status = HEADER_END_OF_FILE;
+        if (arch->deferred != NULL && !arch->materializing)
+        {
+            /* just remember where the member begins; its inode is made in
+             * tar_materialize_dir() when the directory is first visited */
+            tar_defer_entry (archive, member_start);
+
+            if (tar_skip_member (arch, NULL))
+                status = HEADER_SUCCESS;
+            else if (hit_eof)
+                status = HEADER_END_OF_FILE;
+            else
+                status = HEADER_FAILURE;
+        }
         else
-            status = HEADER_FAILURE;
+        {
+            struct vfs_s_inode *inode;
+            const char typeflag = header->header.typeflag;
+
+            /* Create the inode and consume the member data before touching the
+             * inode tree: linking the entry may materialize other directories,
+             * which moves the archive stream (see tar_materialize_dir()) */
+            inode = tar_create_inode (me, archive, header);
+
+            if (tar_skip_member (arch, inode))
+                status = HEADER_SUCCESS;
+            else if (hit_eof)
+                status = HEADER_END_OF_FILE;
+            else
+                status = HEADER_FAILURE;
+
+            if (status == HEADER_FAILURE)
+            {
+                // the member data could not be skipped
+                if (inode != NULL)
+                    vfs_s_free_inode (me, inode);
+            }
+            else if (tar_link_entry (me, archive, typeflag, inode) != HEADER_SUCCESS)
+            {
+                message (D_ERROR, MSG_ERROR, _ ("Inconsistent tar archive"));
+                status = HEADER_FAILURE;
+            }
+        }
     }
 
 ret:
@@ -833,6 +1005,116 @@ ret:
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Create the inodes of all deferred members of @dir_name by replaying their
+ * headers. Replaying a hard link or making a missing parent may recurse into
+ * other directories; taking the member list out of the table first keeps that
+ * recursion finite.
+ */
+static void
+tar_materialize_dir (struct vfs_class *me, struct vfs_s_super *archive, const char *dir_name)
+{
+    tar_super_t *arch = TAR_SUPER (archive);
+    gpointer key = NULL;
+    gpointer value = NULL;
+    tar_deferred_dir_t *dd;
+    struct vfs_s_inode *dir_ino;
+    gboolean save_materializing;
+    size_t i;
+
+    if (!g_hash_table_lookup_extended (arch->deferred, dir_name, &key, &value))
+        return;
+
+    g_hash_table_steal (arch->deferred, dir_name);
+    dd = (tar_deferred_dir_t *) value;
+
+    save_materializing = arch->materializing;
+    arch->materializing = TRUE;
+
+    for (i = 0; i < dd->offsets->len; i++)
+    {
+        tar_rewind (arch, g_array_index (dd->offsets, off_t, i));
+        tar_stat_destroy (&current_stat_info);
+        // a failure was already reported; carry on with the remaining members
+        (void) tar_read_header (me, archive);
+    }
+
+    arch->materializing = save_materializing;
+
+    /* Create stubs for subdirectories known only from deeper member paths, the
+     * way FL_MKDIR would have made them during a full scan. A real directory
+     * member replayed above has already claimed its name in the dedup check. */
+    dir_ino = *dir_name == '\0'
+        ? archive->root
+        : vfs_s_find_inode (me, archive, dir_name, LINK_NO_FOLLOW, FL_NONE);
+    if (dir_ino != NULL)
+        for (i = 0; i < dd->subdirs->len; i++)
+        {
+            const char *stub = (const char *) g_ptr_array_index (dd->subdirs, i);
+
+            if (g_hash_table_lookup (dir_ino->subdir_hash, stub) == NULL)
+            {
+                struct vfs_s_entry *stub_entry;
+
+                stub_entry = vfs_s_generate_entry (me, stub, dir_ino, 0777 | S_IFDIR);
+                vfs_s_insert_entry (me, dir_ino, stub_entry);
+            }
+        }
+
+    tar_deferred_dir_free (dd);
+    g_free (key);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Entry lookup with materialization of deferred directories. Every directory
+ * along @a_path is materialized first; anything the default resolver visits
+ * beyond them (symlink targets, hard link targets) comes back through this
+ * function and is materialized the same way.
+ */
+static struct vfs_s_entry *
+tar_find_entry (struct vfs_class *me, struct vfs_s_inode *root, const char *a_path, int follow,
+                int flags)
+{
+    struct vfs_s_super *archive = root->super;
+    tar_super_t *arch = TAR_SUPER (archive);
+
+    /* Lookups relative to an inner inode happen only while its directory is
+     * already being materialized, so only archive-absolute paths are handled */
+    if (arch->deferred != NULL && root == archive->root)
+    {
+        char *path, *p, *sep;
+
+        path = g_strdup (a_path);
+        // canonicalize as well, but don't remove '../' from path
+        canonicalize_pathname_custom (path, CANON_PATH_ALL & (~CANON_PATH_REMDOUBLEDOTS));
+
+        p = path;
+        while (IS_PATH_SEP (*p))
+            p++;
+
+        tar_materialize_dir (me, archive, "");
+
+        for (sep = p; *sep != '\0'; sep++)
+            if (IS_PATH_SEP (*sep))
+            {
+                *sep = '\0';
+                tar_materialize_dir (me, archive, p);
+                *sep = PATH_SEP;
+            }
+
+        if (*p != '\0')
+            tar_materialize_dir (me, archive, p);
+
+        g_free (path);
+    }
+
+    return tar_find_entry_default (me, root, a_path, follow, flags);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static struct vfs_s_super *
 tar_new_archive (struct vfs_class *me)
 {
@@ -875,6 +1157,12 @@ tar_free_archive (struct vfs_class *me, struct vfs_s_super *archive)
         arch->fd = -1;
     }
 
+    if (arch->deferred != NULL)
+    {
+        g_hash_table_destroy (arch->deferred);
+        arch->deferred = NULL;
+    }
+
     g_free (arch->record_start);
     tar_stat_destroy (&current_stat_info);
 }
@@ -951,17 +1239,12 @@ tar_open_archive_int (struct vfs_class *me, const vfs_path_t *vpath, struct vfs_
  * Returns 0 on success, -1 on error.
  */
 static int
-tar_open_archive (struct vfs_s_super *archive, const vfs_path_t *vpath,
-                  const vfs_path_element_t *vpath_element)
+tar_scan_archive (struct vfs_class *me, struct vfs_s_super *archive, const vfs_path_t *vpath)
 {
     tar_super_t *arch = TAR_SUPER (archive);
     // Initial status at start of archive
     read_header status = HEADER_STILL_UNREAD;
 
-    // Open for reading
-    if (!tar_open_archive_int (vpath_element->class, vpath, archive))
-        return -1;
-
     tar_find_next_block (arch);
 
     while (TRUE)
@@ -970,7 +1253,7 @@ tar_open_archive (struct vfs_s_super *archive, const vfs_path_t *vpath,
 
         prev_status = status;
         tar_stat_destroy (&current_stat_info);
-        status = tar_read_header (vpath_element->class, archive);
+        status = tar_read_header (me, archive);
 
         switch (status)
         {
@@ -985,7 +1268,7 @@ tar_open_archive (struct vfs_s_super *archive, const vfs_path_t *vpath,
             // Record of zeroes
         case HEADER_ZERO_BLOCK:
             tar_set_next_block_after (current_header);
-            (void) tar_read_header (vpath_element->class, archive);
+            (void) tar_read_header (me, archive);
             status = prev_status;
             continue;
 
@@ -1029,6 +1312,58 @@ tar_open_archive (struct vfs_s_super *archive, const vfs_path_t *vpath,
     return 0;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Scan an archive. Member headers are parsed in one streaming pass with the
+ * data blocks sought over; the inodes themselves are created per directory on
+ * first visit (see tar_materialize_dir()).
+ * Returns 0 on success, -1 on error.
+ */
+static int
+tar_open_archive (struct vfs_s_super *archive, const vfs_path_t *vpath,
+                  const vfs_path_element_t *vpath_element)
+{
+    struct vfs_class *me = vpath_element->class;
+    tar_super_t *arch = TAR_SUPER (archive);
+
+    // Open for reading
+    if (!tar_open_archive_int (me, vpath, archive))
+        return -1;
+
+    arch->deferred =
+        g_hash_table_new_full (g_str_hash, g_str_equal, g_free, tar_deferred_dir_free);
+
+    if (!tar_index_load (archive))
+    {
+        if (tar_scan_archive (me, archive, vpath) != 0)
+            return -1;
+
+        if (!arch->defer_unsafe)
+            tar_index_save (archive);
+    }
+
+    if (!arch->defer_unsafe)
+        // the panel lists the archive root right away
+        tar_materialize_dir (me, archive, "");
+    else
+    {
+        /* Global pax headers change the decoding of the members that follow them,
+         * so deferred members cannot be replayed out of order. Drop the index and
+         * rescan the whole archive eagerly; such archives are rare. */
+        g_hash_table_destroy (arch->deferred);
+        arch->deferred = NULL;
+
+        tar_xheader_forget_global ();
+        tar_rewind (arch, 0);
+        tar_stat_destroy (&current_stat_info);
+
+        if (tar_scan_archive (me, archive, vpath) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void *
@@ -1243,6 +1578,32 @@ tar_read (void *fh, char *buffer, size_t count)
     return res;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Expose a plain member as a contiguous range of the archive file, so the copy loop
+ * can move the data from archive to destination inside the kernel.
+ */
+
+static int
+tar_ctl (void *fh, int ctlop, void *arg)
+{
+    vfs_file_handler_t *file = VFS_FILE_HANDLER (fh);
+    vfs_local_range_t *range = (vfs_local_range_t *) arg;
+
+    if (ctlop != VFS_CTL_GET_LOCAL_RANGE)
+        return 0;
+
+    // a sparse member is not stored contiguously
+    if (file->ino->user_data != NULL)
+        return 0;
+
+    range->vfs_fd = TAR_SUPER (VFS_FILE_HANDLER_SUPER (fh))->fd;
+    range->offset = file->ino->data_offset + file->pos;
+    range->len = file->ino->st.st_size - file->pos;
+
+    return 1;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static int
@@ -1266,7 +1627,11 @@ vfs_init_tarfs (void)
     // FIXME: tarfs used own temp files
     vfs_init_subclass (&tarfs_subclass, "tarfs", VFSF_READONLY, "utar");
     vfs_tarfs_ops->read = tar_read;
+    vfs_tarfs_ops->ctl = tar_ctl;
     vfs_tarfs_ops->setctl = NULL;
+    // wrap the default lookup: directories are materialized on first visit
+    tar_find_entry_default = tarfs_subclass.find_entry;
+    tarfs_subclass.find_entry = tar_find_entry;
     tarfs_subclass.archive_check = tar_super_check;
     tarfs_subclass.archive_same = tar_super_same;
     tarfs_subclass.new_archive = tar_new_archive;
@@ -71,6 +71,10 @@
 
 #define undelfs_stat     undelfs_lstat
 
+/* Inode table blocks read per request during the scan; the libext2fs default of 8
+ * makes the load of a big volume a long run of tiny reads */
+#define UNDELFS_SCAN_BUFFER_BLOCKS 256
+
 /*** file scope type declarations ****************************************************************/
 
 struct deleted_info
@@ -244,12 +248,16 @@ undelfs_loaddel (void)
         message (D_ERROR, undelfserr, "%s", _ ("while allocating block buffer"));
         goto free_delarray;
     }
-    retval = ext2fs_open_inode_scan (fs, 0, &scan);
+    retval = ext2fs_open_inode_scan (fs, UNDELFS_SCAN_BUFFER_BLOCKS, &scan);
     if (retval != 0)
     {
         message (D_ERROR, undelfserr, _ ("open_inode_scan: %d"), retval);
         goto free_block_buf;
     }
+#ifdef EXT2_SF_DO_LAZY
+    // groups whose inode table was never initialized cannot hold deleted files
+    ext2fs_inode_scan_flags (scan, EXT2_SF_DO_LAZY, 0);
+#endif
     retval = ext2fs_get_next_inode (scan, &ino, &inode);
     if (retval != 0)
     {
@@ -282,8 +290,10 @@ undelfs_loaddel (void)
         {
             if (num_delarray >= max_delarray)
             {
+                // grow geometrically: linear steps mean quadratic copying on volumes
+                // with hundreds of thousands of deleted files
                 struct deleted_info *delarray_new =
-                    g_try_realloc (delarray, sizeof (struct deleted_info) * (max_delarray + 50));
+                    g_try_realloc (delarray, sizeof (struct deleted_info) * max_delarray * 2);
                 if (!delarray_new)
                 {
                     message (D_ERROR, undelfserr, "%s",
@@ -291,7 +301,7 @@ undelfs_loaddel (void)
                     goto error_out;
                 }
                 delarray = delarray_new;
-                max_delarray += 50;
+                max_delarray *= 2;
             }
 
             delarray[num_delarray].ino = ino;
@@ -45,6 +45,9 @@
 #include <config.h>
 
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>  // PRIuMAX
+#include <sys/stat.h>
 
 #include "lib/global.h"
 
@@ -127,6 +130,105 @@ mcview_continue_search_cmd (WView *view)
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Scan the whole datasource once and report line count, longest line and a byte histogram
+ * broken down by class. Saves a round trip through wc(1) when sizing up a big file.
+ * The scan is interruptible with C-c; for pipes it drains the remaining input first,
+ * just like moving to the bottom does.
+ */
+
+static void
+mcview_stats_cmd (WView *view)
+{
+    uintmax_t histogram[256] = { 0 };
+    uintmax_t lines = 0;
+    uintmax_t printable = 0;
+    uintmax_t whitespace = 0;
+    uintmax_t control = 0;
+    uintmax_t high = 0;
+    off_t scanned = 0;
+    off_t line_start = 0;
+    off_t max_line_len = 0;
+    gboolean interrupted = FALSE;
+    char *text;
+    size_t i;
+
+    tty_enable_interrupt_key ();
+
+    while (TRUE)
+    {
+        const char *data;
+        size_t len;
+
+        if (tty_got_interrupt ())
+        {
+            interrupted = TRUE;
+            break;
+        }
+
+        data = mcview_get_raw_span (view, scanned, &len);
+        if (data == NULL || len == 0)
+            break;
+
+        for (i = 0; i < len; i++)
+        {
+            histogram[(unsigned char) data[i]]++;
+
+            if (data[i] == '\n')
+            {
+                lines++;
+                max_line_len = MAX (max_line_len, scanned + (off_t) i - line_start);
+                line_start = scanned + (off_t) i + 1;
+            }
+        }
+
+        scanned += (off_t) len;
+    }
+
+    tty_disable_interrupt_key ();
+
+    // the last line may lack the terminating newline
+    if (line_start < scanned)
+    {
+        lines++;
+        max_line_len = MAX (max_line_len, scanned - line_start);
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        if (i >= 0x80)
+            high += histogram[i];
+        else if (i >= 0x20 && i != 0x7F)
+            printable += histogram[i];
+        else if (i == '\t' || i == '\n' || i == '\r')
+            whitespace += histogram[i];
+        else
+            control += histogram[i];
+    }
+
+    text = g_strdup_printf ("%s %" PRIuMAX "%s\n"
+                            "%s %" PRIuMAX "\n"
+                            "%s %" PRIuMAX "\n"
+                            "%s %" PRIuMAX "\n"
+                            "%s %" PRIuMAX "\n"
+                            "%s %" PRIuMAX " (NUL: %" PRIuMAX ")\n"
+                            "%s %" PRIuMAX,
+                            _ ("Bytes scanned:"), (uintmax_t) scanned,
+                            interrupted ? _ (" (interrupted)") : "",
+                            _ ("Lines:"), lines,
+                            _ ("Longest line:"), (uintmax_t) max_line_len,
+                            _ ("Printable:"), printable,
+                            _ ("Whitespace:"), whitespace,
+                            _ ("Other control:"), control, histogram[0],
+                            _ ("8-bit bytes:"), high);
+    message (D_NORMAL, _ ("Statistics"), "%s", text);
+    g_free (text);
+
+    view->dirty++;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 mcview_hook (void *v)
 {
@@ -156,6 +258,27 @@ mcview_hook (void *v)
     if (fe == NULL)
         return;
 
+    /* The hook fires on every panel reload, not only on real cursor moves; when the
+       file on display is still the selected one and has not changed on disk, a stat
+       is all it takes to keep it. */
+    if (view->datasource == DS_FILE && view->filename_vpath != NULL
+        && strcmp (vfs_path_as_str (view->filename_vpath), fe->fname->str) == 0)
+    {
+        vfs_path_t *full_vpath;
+        struct stat st;
+        gboolean unchanged;
+
+        // the panel directory is the current one, like when the file was loaded
+        full_vpath = vfs_path_append_new (vfs_get_raw_current_dir (), fe->fname->str, (char *) NULL);
+        unchanged = vfs_path_equal (full_vpath, view->workdir_vpath) && mc_stat (full_vpath, &st) == 0
+            && S_ISREG (st.st_mode) && st.st_mtime == view->ds_file_mtime
+            && st.st_size == view->ds_file_filesize;
+        vfs_path_free (full_vpath, TRUE);
+
+        if (unchanged)
+            return;
+    }
+
     mcview_done (view);
     mcview_init (view);
     mcview_load (view, 0, fe->fname->str, 0, 0, 0);
@@ -167,14 +290,8 @@ mcview_hook (void *v)
 static cb_ret_t
 mcview_handle_editkey (WView *view, int key)
 {
-    struct hexedit_change_node *node;
     int byte_val = -1;
 
-    // Has there been a change at this position?
-    node = view->change_list;
-    while ((node != NULL) && (node->offset != view->hex_cursor))
-        node = node->next;
-
     if (!view->hexview_in_text)
     {
         // Hex editing
@@ -189,9 +306,9 @@ mcview_handle_editkey (WView *view, int key)
         else
             return MSG_NOT_HANDLED;
 
-        if (node != NULL)
-            byte_val = node->value;
-        else
+        // Has there been a change at this position?
+        byte_val = mcview_hexedit_get_byte (view, view->hex_cursor);
+        if (byte_val < 0)
             mcview_get_byte (view, view->hex_cursor, &byte_val);
 
         if (view->hexedit_lownibble)
@@ -210,18 +327,10 @@ mcview_handle_editkey (WView *view, int key)
 
     if ((view->filename_vpath != NULL)
         && (*(vfs_path_get_last_path_str (view->filename_vpath)) != '\0')
-        && (view->change_list == NULL))
+        && !mcview_hexedit_is_modified (view))
         view->locked = lock_file (view->filename_vpath) != 0;
 
-    if (node == NULL)
-    {
-        node = g_new (struct hexedit_change_node, 1);
-        node->offset = view->hex_cursor;
-        node->value = byte_val;
-        mcview_enqueue_change (&view->change_list, node);
-    }
-    else
-        node->value = byte_val;
+    mcview_hexedit_put_byte (view, view->hex_cursor, (byte) byte_val);
 
     view->dirty++;
     mcview_move_right (view, 1);
@@ -493,6 +602,12 @@ mcview_execute_cmd (WView *view, long command)
     case CK_Ruler:
         mcview_display_toggle_ruler (view);
         break;
+    case CK_Stats:
+        mcview_stats_cmd (view);
+        break;
+    case CK_Follow:
+        mcview_follow_toggle (view);
+        break;
     case CK_Bookmark:
         view->dpy_start = view->marks[view->marker];
         view->dpy_paragraph_skip_lines = 0;  // TODO: remember this value in the marker?
@@ -587,7 +702,7 @@ mcview_ok_to_quit (WView *view)
 {
     int r;
 
-    if (view->change_list == NULL)
+    if (!mcview_hexedit_is_modified (view))
         return TRUE;
 
     if (!mc_global.midnight_shutdown)
@@ -185,6 +185,10 @@
  */
 #define MAX_BACKWARDS_WALK_IN_PARAGRAPH (100 * 1000)
 
+/* Unwrap mode: how many paragraphs may remember the parser-formatter state near the viewport's
+ * left edge, so that horizontal scrolling doesn't reformat huge lines from their beginning. */
+#define MAX_HSCROLL_CHECKPOINTS         1024
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -371,6 +375,13 @@ mcview_get_next_maybe_nroff_char (WView *view, mcview_state_machine_t *state, in
     if (!mcview_isprint (view, *c))
         return TRUE;
 
+    /* Every nroff sequence continues with a backspace right here, and '\b' is a
+     * single byte in all supported encodings. Peek at that one byte before
+     * paying for the state machine copy and the speculative parse below:
+     * in plain runs of text it is almost never there. */
+    if (!mcview_get_byte (view, state->offset, &c2) || c2 != '\b')
+        return TRUE;
+
     state_after_nroff = *state;
 
     if (!mcview_get_next_char (view, &state_after_nroff, &c2))
@@ -510,6 +521,54 @@ mcview_next_combining_char_sequence (WView *view, mcview_state_machine_t *state,
     return i;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remember the parser-formatter state at a column within the paragraph starting at "paragraph",
+ * overwriting any earlier checkpoint of that paragraph.
+ */
+
+static void
+mcview_hscroll_cache_store (WView *view, off_t paragraph, const mcview_state_machine_t *state)
+{
+    gint64 *key;
+    gint64 k = paragraph;
+
+    if (view->dpy_hscroll_cache == NULL)
+        view->dpy_hscroll_cache =
+            g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, g_free);
+    else if (g_hash_table_size (view->dpy_hscroll_cache) >= MAX_HSCROLL_CHECKPOINTS
+             && g_hash_table_lookup (view->dpy_hscroll_cache, &k) == NULL)
+        g_hash_table_remove_all (view->dpy_hscroll_cache);
+
+    key = g_new (gint64, 1);
+    *key = paragraph;
+#if GLIB_CHECK_VERSION(2, 68, 0)
+    g_hash_table_replace (view->dpy_hscroll_cache, key, g_memdup2 (state, sizeof (*state)));
+#else
+    g_hash_table_replace (view->dpy_hscroll_cache, key, g_memdup (state, sizeof (*state)));
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * If a checkpoint for the paragraph starting at state->offset exists and lies at or before
+ * dpy_text_column, resume from it instead of the paragraph's beginning.
+ */
+
+static void
+mcview_hscroll_cache_lookup (WView *view, mcview_state_machine_t *state, off_t dpy_text_column)
+{
+    const mcview_state_machine_t *cp;
+    gint64 k = state->offset;
+
+    if (view->dpy_hscroll_cache == NULL)
+        return;
+
+    cp = g_hash_table_lookup (view->dpy_hscroll_cache, &k);
+    if (cp != NULL && cp->unwrapped_column <= dpy_text_column)
+        *state = *cp;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Parse, format and possibly display one visual line of text.
@@ -545,6 +604,9 @@ mcview_display_line (WView *view, mcview_state_machine_t *state, int row, gboole
     int cs[1 + MAX_COMBINING_CHARS];
     char str[(1 + MAX_COMBINING_CHARS) * MB_LEN_MAX + 1];
     int i, j;
+    mcview_state_machine_t checkpoint;
+    off_t checkpoint_key = -1;
+    gboolean checkpoint_stored = FALSE;
 
     if (paragraph_ended != NULL)
         *paragraph_ended = TRUE;
@@ -563,6 +625,17 @@ mcview_display_line (WView *view, mcview_state_machine_t *state, int row, gboole
         return retval;
     }
 
+    if (!view->mode_flags.wrap && dpy_text_column > 0 && state->unwrapped_column == 0)
+    {
+        /* We're at the paragraph's beginning. If an earlier repaint already walked up
+         * to the viewport's left edge, resume from that checkpoint instead of
+         * reformatting the invisible beginning of the paragraph over and over again. */
+        checkpoint_key = state->offset;
+        mcview_hscroll_cache_lookup (view, state, dpy_text_column);
+        col = (int) state->unwrapped_column;
+        checkpoint = *state;
+    }
+
     while (TRUE)
     {
         int charwidth = 0;
@@ -570,10 +643,24 @@ mcview_display_line (WView *view, mcview_state_machine_t *state, int row, gboole
         int n;
         int color;
 
+        if (checkpoint_key >= 0 && !checkpoint_stored)
+        {
+            if ((off_t) col <= dpy_text_column)
+                checkpoint = *state;
+            if ((off_t) col >= dpy_text_column)
+            {
+                checkpoint_stored = TRUE;
+                mcview_hscroll_cache_store (view, checkpoint_key, &checkpoint);
+            }
+        }
+
         state_saved = *state;
         n = mcview_next_combining_char_sequence (view, state, cs, 1 + MAX_COMBINING_CHARS, &color);
         if (n == 0)
         {
+            // remember how far we got even if the paragraph is narrower than the scroll
+            if (checkpoint_key >= 0 && !checkpoint_stored)
+                mcview_hscroll_cache_store (view, checkpoint_key, &checkpoint);
             if (linewidth != NULL)
                 *linewidth = col;
             return (col > 0) ? 1 : 0;
@@ -584,6 +671,9 @@ mcview_display_line (WView *view, mcview_state_machine_t *state, int row, gboole
 
         if (cs[0] == '\n')
         {
+            // remember how far we got even if the paragraph is narrower than the scroll
+            if (checkpoint_key >= 0 && !checkpoint_stored)
+                mcview_hscroll_cache_store (view, checkpoint_key, &checkpoint);
             // New line: reset all formatting state for the next paragraph.
             mcview_state_machine_init (state, state->offset);
             if (linewidth != NULL)
@@ -1013,3 +1103,18 @@ mcview_state_machine_init (mcview_state_machine_t *state, off_t offset)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/** Drop the horizontal scroll checkpoints. Must be called whenever the file's
+ * content or a parsing or formatting property (encoding, nroff mode) changes.
+ */
+
+void
+mcview_hscroll_cache_clear (WView *view)
+{
+    if (view->dpy_hscroll_cache != NULL)
+    {
+        g_hash_table_destroy (view->dpy_hscroll_cache);
+        view->dpy_hscroll_cache = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
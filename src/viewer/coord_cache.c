@@ -49,13 +49,18 @@
 
 #include <config.h>
 
+#include <stdio.h>
 #include <string.h>  // memset()
+#include <sys/stat.h>
+#include <unistd.h>  // unlink()
 #ifdef MC_ENABLE_DEBUGGING_CODE
 #include <inttypes.h>  // uintmax_t
 #endif
 
 #include "lib/global.h"
+#include "lib/mcconfig.h"  // mc_config_get_cache_path()
 #include "lib/tty/tty.h"
+#include "lib/vfs/vfs.h"  // vfs_file_is_local()
 #include "internal.h"
 
 /*** global variables ****************************************************************************/
@@ -67,6 +72,13 @@
 
 #define coord_cache_index(c, i) ((coord_cache_entry_t *) g_ptr_array_index ((c), (i)))
 
+/* persisted copies of the cache, one file per viewed file under the cache directory */
+#define VIEW_CCACHE_DIR         "viewer"
+#define VIEW_CCACHE_MAGIC       "mc viewer ccache 1"
+
+/* don't let a persisted cache grow without bounds (this covers 1 GiB of file) */
+#define VIEW_CCACHE_MAX_ENTRIES (1 << 20)
+
 /*** file scope type declarations ****************************************************************/
 
 typedef gboolean (*cmp_func_t) (const coord_cache_entry_t *a, const coord_cache_entry_t *b);
@@ -160,6 +172,24 @@ mcview_ccache_find (WView *view, const coord_cache_entry_t *coord, cmp_func_t cm
     return base;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/** Path of the persisted cache of a viewed file, named after a hash of its path. */
+
+static char *
+mcview_ccache_file_path (const vfs_path_t *vpath)
+{
+    char *checksum, *name, *path;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, vfs_path_as_str (vpath), -1);
+    checksum[24] = '\0';
+    name = g_strconcat (checksum, ".ccache", (char *) NULL);
+    path = g_build_filename (mc_config_get_cache_path (), VIEW_CCACHE_DIR, name, (char *) NULL);
+    g_free (name);
+    g_free (checksum);
+
+    return path;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -351,8 +381,13 @@ retry:
         {
         case NROFF_START:
         case NROFF_CONTINUATION:
-            nroff_state =
-                mcview_is_nroff_sequence (view, current.cc_offset) ? NROFF_BACKSPACE : NROFF_START;
+            /* The probe costs three byte fetches per scanned byte and changes the
+             * layout only in nroff mode, so don't pay for it elsewhere. The cache
+             * is flushed when the nroff mode is toggled. */
+            if (view->mode_flags.nroff && mcview_is_nroff_sequence (view, current.cc_offset))
+                nroff_state = NROFF_BACKSPACE;
+            else
+                nroff_state = NROFF_START;
             break;
         case NROFF_BACKSPACE:
             nroff_state = NROFF_CONTINUATION;
@@ -390,3 +425,149 @@ retry:
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/** Persist the cache so that reopening the same file does not repeat the scan.
+ * The file records the size, mtime and parse flags the cache was built under;
+ * a copy that does not match them exactly is ignored on load.
+ */
+
+void
+mcview_ccache_save (WView *view)
+{
+    struct stat st;
+    char *path, *tmp_path, *dir_path;
+    FILE *f;
+
+    if (view->coord_cache == NULL || view->coord_cache->len < 2 || view->filename_vpath == NULL
+        || !vfs_file_is_local (view->filename_vpath))
+        return;
+
+    if (mc_stat (view->filename_vpath, &st) != 0 || !S_ISREG (st.st_mode))
+        return;
+
+    path = mcview_ccache_file_path (view->filename_vpath);
+    tmp_path = g_strconcat (path, ".tmp", (char *) NULL);
+
+    dir_path = g_path_get_dirname (path);
+    g_mkdir_with_parents (dir_path, 0700);
+    g_free (dir_path);
+
+    f = fopen (tmp_path, "w");
+    if (f != NULL)
+    {
+        const size_t n = MIN ((size_t) view->coord_cache->len, (size_t) VIEW_CCACHE_MAX_ENTRIES);
+        size_t i;
+        gboolean ok;
+
+        fprintf (f, "%s\n", VIEW_CCACHE_MAGIC);
+        fprintf (f, "%lld %lld %d %d\n", (long long) st.st_size, (long long) st.st_mtime,
+                 view->mode_flags.nroff ? 1 : 0, view->utf8 ? 1 : 0);
+
+        for (i = 0; i < n; i++)
+        {
+            const coord_cache_entry_t *e = coord_cache_index (view->coord_cache, i);
+
+            fprintf (f, "%lld %lld %lld %lld\n", (long long) e->cc_offset, (long long) e->cc_line,
+                     (long long) e->cc_column, (long long) e->cc_nroff_column);
+        }
+
+        ok = fclose (f) == 0;
+        if (ok)
+            ok = rename (tmp_path, path) == 0;
+        if (!ok)
+            unlink (tmp_path);
+    }
+
+    g_free (tmp_path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Restore a cache persisted by mcview_ccache_save (). A copy written for
+ * different file content or different parse flags is left unused.
+ */
+
+void
+mcview_ccache_load (WView *view)
+{
+    struct stat st;
+    char *path, *content = NULL;
+    const char *p;
+    char *end;
+    long long hdr[4];
+    off_t prev_offset = -1;
+    GPtrArray *cache;
+    int i;
+
+    if (view->coord_cache != NULL || view->filename_vpath == NULL
+        || !vfs_file_is_local (view->filename_vpath))
+        return;
+
+    if (mc_stat (view->filename_vpath, &st) != 0 || !S_ISREG (st.st_mode))
+        return;
+
+    path = mcview_ccache_file_path (view->filename_vpath);
+    if (!g_file_get_contents (path, &content, NULL, NULL))
+    {
+        g_free (path);
+        return;
+    }
+    g_free (path);
+
+    if (!g_str_has_prefix (content, VIEW_CCACHE_MAGIC "\n"))
+    {
+        g_free (content);
+        return;
+    }
+
+    p = content + strlen (VIEW_CCACHE_MAGIC "\n");
+    for (i = 0; i < 4; i++)
+    {
+        hdr[i] = g_ascii_strtoll (p, &end, 10);
+        p = end;
+    }
+
+    if (hdr[0] != (long long) st.st_size || hdr[1] != (long long) st.st_mtime
+        || hdr[2] != (view->mode_flags.nroff ? 1 : 0) || hdr[3] != (view->utf8 ? 1 : 0))
+    {
+        g_free (content);
+        return;
+    }
+
+    cache = g_ptr_array_new_full (CACHE_CAPACITY_DELTA, g_free);
+
+    while (TRUE)
+    {
+        coord_cache_entry_t entry;
+
+        entry.cc_offset = (off_t) g_ascii_strtoll (p, &end, 10);
+        if (end == p)
+            break;
+        p = end;
+        entry.cc_line = (off_t) g_ascii_strtoll (p, &end, 10);
+        p = end;
+        entry.cc_column = (off_t) g_ascii_strtoll (p, &end, 10);
+        p = end;
+        entry.cc_nroff_column = (off_t) g_ascii_strtoll (p, &end, 10);
+        p = end;
+
+        // the lookup relies on strictly growing offsets; treat anything else as corruption
+        if (entry.cc_offset <= prev_offset)
+        {
+            g_ptr_array_free (cache, TRUE);
+            g_free (content);
+            return;
+        }
+
+        prev_offset = entry.cc_offset;
+        mcview_ccache_add_entry (cache, &entry);
+    }
+
+    g_free (content);
+
+    if (cache->len == 0)
+        g_ptr_array_free (cache, TRUE);
+    else
+        view->coord_cache = cache;
+}
+
+/* --------------------------------------------------------------------------------------------- */
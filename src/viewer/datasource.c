@@ -54,6 +54,12 @@
 
 #include <config.h>
 
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "lib/global.h"
 #include "lib/vfs/vfs.h"
 #include "lib/util.h"
@@ -65,16 +71,185 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Size of the read window for files that are not mmap'ed (i.e. VFS-backed ones).
+ * A sequential scan such as a search pays one (possibly network) round trip per
+ * window, so keep it large enough for the latency to amortize. */
+#define VIEW_FILE_WINDOW ((size_t) (64 * 1024))
+
+/* Number of recently closed mappings kept alive for reuse; the quick view panel
+ * scrubs back and forth over the files of one directory, so a handful is enough. */
+#define VIEW_MMAP_CACHE_SIZE 8
+
 /*** file scope type declarations ****************************************************************/
 
+/* A parked mapping of a recently viewed file, ready to be reattached. */
+typedef struct
+{
+    char *path;     // local path the mapping was created for, NULL = empty slot
+    off_t size;     // st_size at map time; also the length of the mapping
+    time_t mtime;   // st_mtime at map time
+    byte *map;      // the still-live read-only mapping
+    guint64 stamp;  // recency; the lowest one is recycled first
+} view_mmap_cache_entry_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
+/* LRU of mappings of recently viewed files, keyed by path+size+mtime. Closing a
+   datasource parks its mapping here instead of unmapping it, so re-viewing one of the
+   last few files (quick view following the panel cursor) reattaches the old mapping
+   instead of doing open()/mmap() again. A file that changed no longer matches its key
+   and the stale mapping ages out. */
+static view_mmap_cache_entry_t view_mmap_cache[VIEW_MMAP_CACHE_SIZE];
+static guint64 view_mmap_cache_stamp = 0;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+view_mmap_cache_drop (view_mmap_cache_entry_t *e)
+{
+    munmap ((void *) e->map, e->size);
+    MC_PTR_FREE (e->path);
+    memset (e, 0, sizeof (*e));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Take a parked mapping of the given file out of the cache, or return NULL. */
+
+static byte *
+view_mmap_cache_take (const char *path, off_t size, time_t mtime)
+{
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS (view_mmap_cache); i++)
+    {
+        view_mmap_cache_entry_t *e = &view_mmap_cache[i];
+
+        if (e->path != NULL && e->size == size && e->mtime == mtime
+            && strcmp (e->path, path) == 0)
+        {
+            byte *map = e->map;
+
+            MC_PTR_FREE (e->path);
+            memset (e, 0, sizeof (*e));
+            return map;
+        }
+    }
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Park a mapping for later reuse; takes ownership of @path and @map. */
+
+static void
+view_mmap_cache_put (char *path, off_t size, time_t mtime, byte *map)
+{
+    view_mmap_cache_entry_t *victim = &view_mmap_cache[0];
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS (view_mmap_cache); i++)
+    {
+        view_mmap_cache_entry_t *e = &view_mmap_cache[i];
+
+        // an older copy of the same file must not linger next to the new one
+        if (e->path != NULL && strcmp (e->path, path) == 0)
+            view_mmap_cache_drop (e);
+
+        if (e->path == NULL)
+            victim = e;
+        else if (victim->path != NULL && e->stamp < victim->stamp)
+            victim = e;
+    }
+
+    if (victim->path != NULL)
+        view_mmap_cache_drop (victim);
+
+    victim->path = path;
+    victim->size = size;
+    victim->mtime = mtime;
+    victim->map = map;
+    victim->stamp = ++view_mmap_cache_stamp;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mcview_file_unmap (WView *view)
+{
+    if (view->ds_file_mmap != NULL)
+    {
+        if (view->ds_file_map_path != NULL)
+            view_mmap_cache_put (view->ds_file_map_path, view->ds_file_mmap_size,
+                                 view->ds_file_mtime, view->ds_file_mmap);
+        else
+            munmap ((void *) view->ds_file_mmap, view->ds_file_mmap_size);
+        view->ds_file_map_path = NULL;  // ownership went to the cache
+        view->ds_file_mmap = NULL;
+        view->ds_file_mmap_size = 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Map a local regular file read-only so that mcview_get_byte () becomes a
+ * plain memory access.  Bytes appended to the file after this point lie
+ * beyond the mapping and are still served through the read window.
+ *
+ * @param view  viewer object
+ * @param vpath path of the viewed file
+ */
+
+static void
+mcview_file_try_mmap (WView *view, const vfs_path_t *vpath)
+{
+    struct stat st;
+    const char *path;
+    void *p;
+    int fd;
+
+    if (vpath == NULL || !vfs_file_is_local (vpath))
+        return;
+
+    path = vfs_path_get_last_path_str (vpath);
+    fd = open (path, O_RDONLY | O_BINARY);
+    if (fd == -1)
+        return;
+
+    if (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode) || st.st_size == 0)
+    {
+        close (fd);
+        return;
+    }
+
+    p = (void *) view_mmap_cache_take (path, st.st_size, st.st_mtime);
+    if (p != NULL)
+        close (fd);
+    else
+    {
+        p = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping keeps the file referenced
+        close (fd);
+        if (p == MAP_FAILED)
+            return;
+
+#ifdef MADV_SEQUENTIAL
+        // viewing is mostly linear; ask the kernel for aggressive readahead
+        madvise (p, st.st_size, MADV_SEQUENTIAL);
+#endif
+    }
+
+    view->ds_file_mmap = (byte *) p;
+    view->ds_file_mmap_size = st.st_size;
+    view->ds_file_map_path = g_strdup (path);
+    view->ds_file_mtime = st.st_mtime;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 mcview_set_datasource_stdio_pipe (WView *view, mc_pipe_t *p)
 {
@@ -138,12 +313,72 @@ mcview_get_ptr_file (WView *view, off_t byte_index)
 {
     g_assert (view->datasource == DS_FILE);
 
+    if (view->ds_file_mmap != NULL && byte_index >= 0 && byte_index < view->ds_file_mmap_size)
+        return (char *) (view->ds_file_mmap + byte_index);
+
     mcview_file_load_data (view, byte_index);
     if (mcview_already_loaded (view->ds_file_offset, byte_index, view->ds_file_datalen))
         return (char *) (view->ds_file_data + (byte_index - view->ds_file_offset));
     return NULL;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Return a pointer to the longest contiguous run of raw bytes starting at the given
+ * offset that the datasource can serve without another fetch, and its length.
+ * Callers scanning for line breaks can then walk whole spans with memchr () and the
+ * like instead of fetching the bytes one by one.
+ *
+ * @param view       viewer object
+ * @param byte_index offset of the first wanted byte
+ * @param len        filled with the number of readable bytes behind the result
+ *
+ * @return pointer to the byte at byte_index, or NULL if it cannot be read
+ */
+
+char *
+mcview_get_raw_span (WView *view, off_t byte_index, size_t *len)
+{
+    *len = 0;
+
+    if (byte_index < 0)
+        return NULL;
+
+    switch (view->datasource)
+    {
+    case DS_STDIO_PIPE:
+    case DS_VFS_PIPE:
+        return mcview_get_span_growing_buffer (view, byte_index, len);
+
+    case DS_FILE:
+        if (byte_index >= view->ds_file_filesize)
+            return NULL;
+        if (view->ds_file_mmap != NULL && byte_index < view->ds_file_mmap_size)
+        {
+            // the file may have been truncated since it was mapped
+            const off_t mapped = MIN (view->ds_file_mmap_size, view->ds_file_filesize);
+
+            *len = (size_t) (mapped - byte_index);
+            return (char *) (view->ds_file_mmap + byte_index);
+        }
+        mcview_file_load_data (view, byte_index);
+        if (!mcview_already_loaded (view->ds_file_offset, byte_index, view->ds_file_datalen))
+            return NULL;
+        *len = (size_t) (view->ds_file_offset + (off_t) view->ds_file_datalen - byte_index);
+        return (char *) (view->ds_file_data + (byte_index - view->ds_file_offset));
+
+    case DS_STRING:
+        if (byte_index >= (off_t) view->ds_string_len)
+            return NULL;
+        *len = view->ds_string_len - (size_t) byte_index;
+        return (char *) (view->ds_string_data + byte_index);
+
+    case DS_NONE:
+    default:
+        return NULL;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 /* Invalid UTF-8 is reported as negative integers (one for each byte),
@@ -275,6 +510,13 @@ mcview_set_byte (WView *view, off_t offset, byte b)
     g_assert (offset < mcview_get_filesize (view));
     g_assert (view->datasource == DS_FILE);
 
+    /* a private mapping may mix pages from before and after the change --
+     * drop it and go back to plain reads */
+    mcview_file_unmap (view);
+
+    // the changed content invalidates the remembered scroll positions
+    mcview_hscroll_cache_clear (view);
+
     view->ds_file_datalen = 0;  // just force reloading
 }
 
@@ -332,6 +574,9 @@ error:
 void
 mcview_close_datasource (WView *view)
 {
+    // the watch belongs to the current file, whatever replaces it starts unfollowed
+    mcview_follow_stop (view);
+
     switch (view->datasource)
     {
     case DS_NONE:
@@ -353,6 +598,7 @@ mcview_close_datasource (WView *view)
         (void) mc_close (view->ds_file_fd);
         view->ds_file_fd = -1;
         MC_PTR_FREE (view->ds_file_data);
+        mcview_file_unmap (view);
         break;
     case DS_STRING:
         MC_PTR_FREE (view->ds_string_data);
@@ -366,15 +612,21 @@ mcview_close_datasource (WView *view)
 /* --------------------------------------------------------------------------------------------- */
 
 void
-mcview_set_datasource_file (WView *view, int fd, const struct stat *st)
+mcview_set_datasource_file (WView *view, int fd, const struct stat *st, const vfs_path_t *vpath)
 {
     view->datasource = DS_FILE;
     view->ds_file_fd = fd;
     view->ds_file_filesize = st->st_size;
     view->ds_file_offset = 0;
-    view->ds_file_data = g_malloc (4096);
+    view->ds_file_data = g_malloc (VIEW_FILE_WINDOW);
     view->ds_file_datalen = 0;
-    view->ds_file_datasize = 4096;
+    view->ds_file_datasize = VIEW_FILE_WINDOW;
+    view->ds_file_mmap = NULL;
+    view->ds_file_mmap_size = 0;
+    view->ds_file_map_path = NULL;
+    view->ds_file_mtime = st->st_mtime;
+
+    mcview_file_try_mmap (view, vpath);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -170,7 +170,9 @@ mcview_display_status (WView *view)
             size_trunc_len (buffer, BUF_TRUNC_LEN, mcview_get_filesize (view), 0,
                             panels_options.kilobyte_si);
             tty_printf ("%9" PRIuMAX "/%s%s %s", (uintmax_t) view->dpy_end, buffer,
-                        mcview_may_still_grow (view) ? "+" : " ",
+                        view->follow_mode                ? "F"
+                            : mcview_may_still_grow (view) ? "+"
+                                                           : " ",
                         mc_global.source_codepage >= 0 ? get_codepage_id (mc_global.source_codepage)
                                                        : "");
         }
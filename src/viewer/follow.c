@@ -0,0 +1,180 @@
+/*
+   Internal file viewer for the Midnight Commander
+   Tail-follow mode: inotify-driven incremental display of a growing file
+
+   Copyright (C) 2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include "lib/global.h"
+#include "lib/tty/key.h"  // add_select_channel(), delete_select_channel()
+#include "lib/vfs/vfs.h"
+#include "lib/widget.h"  // message()
+
+#include "internal.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef __linux__
+
+/** Re-stat the file and display whatever was appended since the last look.
+ *
+ * Growth is incremental by construction: everything below the old size stays
+ * valid, only the block cache entry that was cut short at the old EOF is
+ * dropped, and the coordinate cache keeps extending lazily as new lines are
+ * displayed. Truncation invalidates cached offsets, so those caches are reset.
+ */
+
+static void
+mcview_follow_apply (WView *view)
+{
+    struct stat st;
+    off_t old_size;
+
+    if (view->datasource != DS_FILE || mc_fstat (view->ds_file_fd, &st) == -1)
+        return;
+
+    old_size = view->ds_file_filesize;
+    if (st.st_size == old_size)
+        return;
+
+    view->ds_file_filesize = st.st_size;
+    // the cached block around the old EOF was a short read; refetch it
+    view->ds_file_datalen = 0;
+
+    if (st.st_size < old_size)
+    {
+        // truncated: line/column positions past the new end are stale
+        if (view->coord_cache != NULL)
+            g_ptr_array_set_size (view->coord_cache, 0);
+        mcview_hscroll_cache_clear (view);
+    }
+
+    mcview_moveto_bottom (view);
+    view->dirty++;
+    mcview_update (view);
+    mc_refresh ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** select() loop callback: the watched file was modified. */
+
+static int
+mcview_follow_callback (int fd, void *info)
+{
+    WView *view = (WView *) info;
+    char buf[4096] __attribute__ ((aligned (__alignof__ (struct inotify_event))));
+
+    if (fd != view->follow_fd)
+        return 0;
+
+    // drain the queue; any event means "look at the file again"
+    while (read (fd, buf, sizeof (buf)) > 0)
+        ;
+
+    mcview_follow_apply (view);
+    return 0;
+}
+
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mcview_follow_toggle (WView *view)
+{
+#ifdef __linux__
+    int fd;
+
+    if (view->follow_mode)
+    {
+        mcview_follow_stop (view);
+        view->dirty++;
+        mcview_update (view);
+        return;
+    }
+
+    if (view->datasource != DS_FILE || view->filename_vpath == NULL
+        || !vfs_file_is_local (view->filename_vpath))
+    {
+        message (D_ERROR, MSG_ERROR, "%s", _ ("Follow mode requires a local regular file"));
+        return;
+    }
+
+    fd = inotify_init1 (IN_NONBLOCK);
+    if (fd < 0)
+        return;
+
+    if (inotify_add_watch (fd, vfs_path_as_str (view->filename_vpath),
+                           IN_MODIFY | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF)
+        < 0)
+    {
+        close (fd);
+        return;
+    }
+
+    view->follow_fd = fd;
+    view->follow_mode = TRUE;
+    add_select_channel (fd, mcview_follow_callback, view);
+
+    // catch up with anything written before the watch existed and jump to the tail
+    mcview_follow_apply (view);
+    mcview_moveto_bottom (view);
+    view->dirty++;
+    mcview_update (view);
+#else
+    (void) view;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mcview_follow_stop (WView *view)
+{
+#ifdef __linux__
+    if (!view->follow_mode)
+        return;
+
+    delete_select_channel (view->follow_fd);
+    close (view->follow_fd);
+#endif
+    view->follow_fd = -1;
+    view->follow_mode = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -37,15 +37,20 @@
 #include <errno.h>
 
 #include "lib/global.h"
+#include "lib/memstat.h"
 #include "lib/vfs/vfs.h"
 #include "lib/util.h"
-#include "lib/widget.h"  // D_NORMAL
+#include "lib/tty/tty.h"  // tty_enable_interrupt_key()
+#include "lib/widget.h"   // D_NORMAL
 
 #include "internal.h"
 
 /* Block size for reading files in parts */
 #define VIEW_PAGE_SIZE ((size_t) 8192)
 
+/* Redraw the screen after this many bytes have been appended in one go */
+#define VIEW_GROWBUF_UPDATE ((off_t) (64 * VIEW_PAGE_SIZE))
+
 /*** global variables ****************************************************************************/
 
 /*** file scope macro definitions ****************************************************************/
@@ -56,6 +61,14 @@
 
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
+/** Element destroy function of growbuf_blockptr, accounted against the viewer subsystem. */
+
+static void
+mcview_growbuf_free_page (gpointer page)
+{
+    mc_memstat_free (MC_MEMSTAT_VIEWER, VIEW_PAGE_SIZE);
+    g_free (page);
+}
 
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
@@ -65,9 +78,10 @@ void
 mcview_growbuf_init (WView *view)
 {
     view->growbuf_in_use = TRUE;
-    view->growbuf_blockptr = g_ptr_array_new_with_free_func (g_free);
+    view->growbuf_blockptr = g_ptr_array_new_with_free_func (mcview_growbuf_free_page);
     view->growbuf_lastindex = VIEW_PAGE_SIZE;
     view->growbuf_finished = FALSE;
+    view->growbuf_reading = FALSE;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -118,31 +132,55 @@ mcview_growbuf_filesize (WView *view)
 /** Copies the output from the pipe to the growing buffer, until either
  * the end-of-pipe is reached or the interval [0..ofs) of the growing
  * buffer is completely filled.
+ *
+ * A long fill blocks on the producer, so the display is refreshed as the
+ * data arrives and the user can interrupt the wait with C-c; whatever has
+ * not been read yet is fetched on demand later.
  */
 
 void
 mcview_growbuf_read_until (WView *view, off_t ofs)
 {
     gboolean short_read = FALSE;
+    off_t next_update;
 
     g_assert (view->growbuf_in_use);
 
-    if (view->growbuf_finished)
+    if (view->growbuf_finished || view->growbuf_reading)
         return;
 
+    next_update = mcview_growbuf_filesize (view) + VIEW_GROWBUF_UPDATE;
+
+    /* the redraws below come back here through mcview_get_byte();
+     * the growbuf_reading flag makes those nested calls no-ops */
+    view->growbuf_reading = TRUE;
+    tty_enable_interrupt_key ();
+
     while (mcview_growbuf_filesize (view) < ofs || short_read)
     {
         ssize_t nread = 0;
         byte *p;
         size_t bytesfree;
 
+        if (tty_got_interrupt ())
+            break;
+
+        if (mcview_growbuf_filesize (view) >= next_update)
+        {
+            // show what has arrived so far
+            next_update += VIEW_GROWBUF_UPDATE;
+            mcview_display (view);
+            mc_refresh ();
+        }
+
         if (view->growbuf_lastindex == VIEW_PAGE_SIZE)
         {
             // Append a new block to the growing buffer
             byte *newblock = g_try_malloc (VIEW_PAGE_SIZE);
             if (newblock == NULL)
-                return;
+                goto done;
 
+            mc_memstat_alloc (MC_MEMSTAT_VIEWER, VIEW_PAGE_SIZE);
             g_ptr_array_add (view->growbuf_blockptr, newblock);
             view->growbuf_lastindex = 0;
         }
@@ -170,7 +208,7 @@ mcview_growbuf_read_until (WView *view, off_t ofs)
                 mcview_show_error (view, NULL, error->message);
                 g_error_free (error);
                 mcview_growbuf_done (view);
-                return;
+                goto done;
             }
 
             if (view->pipe_first_err_msg && sp->err.len > 0)
@@ -192,7 +230,7 @@ mcview_growbuf_read_until (WView *view, off_t ofs)
                  *       mcview_close_datasource -> mcview_growbuf_done
                  */
                 if (view->ds_stdio_pipe == NULL)
-                    return;
+                    goto done;
             }
 
             if (sp->out.len > 0)
@@ -216,7 +254,7 @@ mcview_growbuf_read_until (WView *view, off_t ofs)
                 mcview_growbuf_done (view);
 
                 mcview_display (view);
-                return;
+                goto done;
             }
         }
         else
@@ -231,12 +269,16 @@ mcview_growbuf_read_until (WView *view, off_t ofs)
             if (nread <= 0)
             {
                 mcview_growbuf_done (view);
-                return;
+                goto done;
             }
         }
         short_read = ((size_t) nread < bytesfree);
         view->growbuf_lastindex += nread;
     }
+
+done:
+    tty_disable_interrupt_key ();
+    view->growbuf_reading = FALSE;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -291,3 +333,31 @@ mcview_get_ptr_growing_buffer (WView *view, off_t byte_index)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/** Like mcview_get_ptr_growing_buffer(), but also tells how many bytes are
+ * readable behind the returned pointer, i.e. up to the end of the page.
+ */
+
+char *
+mcview_get_span_growing_buffer (WView *view, off_t byte_index, size_t *len)
+{
+    off_t pageno, pageindex;
+    char *p;
+
+    *len = 0;
+
+    p = mcview_get_ptr_growing_buffer (view, byte_index);
+    if (p == NULL)
+        return NULL;
+
+    pageno = byte_index / VIEW_PAGE_SIZE;
+    pageindex = byte_index % VIEW_PAGE_SIZE;
+
+    if (pageno < (off_t) view->growbuf_blockptr->len - 1)
+        *len = VIEW_PAGE_SIZE - (size_t) pageindex;
+    else
+        *len = view->growbuf_lastindex - (size_t) pageindex;
+
+    return p;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -37,6 +37,7 @@
 
 #include <errno.h>
 #include <inttypes.h>  // uintmax_t
+#include <string.h>    // memcpy()
 
 #include "lib/global.h"
 #include "lib/tty/tty.h"
@@ -71,22 +72,95 @@ static const char hex_char[] = "0123456789ABCDEF";
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+hexedit_run_free (gpointer data)
+{
+    hexedit_run_t *run = (hexedit_run_t *) data;
+
+    g_byte_array_free (run->data, TRUE);
+    g_free (run);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Binary search over the sorted run array.
+ *
+ * @return the run covering @offset, or NULL with *pos set to the index where
+ *         such a run would have to be inserted
+ */
+
+static hexedit_run_t *
+hexedit_run_lookup (const WView *view, off_t offset, guint *pos)
+{
+    guint lo = 0;
+    guint hi = view->hexedit_changes != NULL ? view->hexedit_changes->len : 0;
+
+    while (lo < hi)
+    {
+        const guint mid = lo + (hi - lo) / 2;
+        hexedit_run_t *run = g_ptr_array_index (view->hexedit_changes, mid);
+
+        if (offset < run->offset)
+            hi = mid;
+        else if (offset >= run->offset + (off_t) run->data->len)
+            lo = mid + 1;
+        else
+        {
+            *pos = mid;
+            return run;
+        }
+    }
+
+    *pos = lo;
+    return NULL;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /** Determine the state of the current byte.
  *
  * @param view viewer object
  * @param from offset
- * @param curr current node
+ * @param changed whether a pending edit covers the byte
  */
 
 static mark_t
-mcview_hex_calculate_boldflag (WView *view, off_t from, struct hexedit_change_node *curr,
-                               gboolean force_changed)
+mcview_hex_calculate_boldflag (WView *view, off_t from, gboolean changed, gboolean force_changed)
 {
-    return (from == view->hex_cursor)                               ? MARK_CURSOR
-        : ((curr != NULL && from == curr->offset) || force_changed) ? MARK_CHANGED
-        : (view->search_start <= from && from < view->search_end)   ? MARK_SELECTED
-                                                                    : MARK_NORMAL;
+    return (from == view->hex_cursor)                             ? MARK_CURSOR
+        : (changed || force_changed)                              ? MARK_CHANGED
+        : (view->search_start <= from && from < view->search_end) ? MARK_SELECTED
+                                                                  : MARK_NORMAL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Copy up to size bytes starting at offset from the datasource into buf.
+ * The data is pulled in contiguous spans, so a screenful costs a few
+ * datasource round trips instead of one per byte.
+ *
+ * @return the number of bytes actually available
+ */
+
+static size_t
+mcview_hex_fetch (WView *view, off_t offset, byte *buf, size_t size)
+{
+    size_t got = 0;
+
+    while (got < size)
+    {
+        const char *data;
+        size_t len;
+
+        data = mcview_get_raw_span (view, offset + (off_t) got, &len);
+        if (data == NULL || len == 0)
+            break;
+
+        len = MIN (len, size - got);
+        memcpy (buf + got, data, len);
+        got += len;
+    }
+
+    return got;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -110,11 +184,14 @@ mcview_display_hex (WView *view)
     off_t from;
     mark_t boldflag_byte = MARK_NORMAL;
     mark_t boldflag_char = MARK_NORMAL;
-    struct hexedit_change_node *curr = view->change_list;
     int cont_bytes = 0;             // number of continuation bytes remanining from current UTF-8
     gboolean cjk_right = FALSE;     // whether the second byte of a CJK is to be processed
     gboolean utf8_changed = FALSE;  // whether any of the bytes in the UTF-8 were changed
 
+    byte *fetch_buf;   // The displayed bytes, fetched from the datasource in one go
+    off_t fetch_start;
+    off_t fetch_end;   // Offset of the first byte behind fetch_buf
+
     char hex_buff[10];  // A temporary buffer for sprintf and mvwaddstr
 
     text_start = 8 + 13 * ngroups;
@@ -142,10 +219,20 @@ mcview_display_hex (WView *view)
         }
     }
 
-    while (curr != NULL && (curr->offset < from))
-        curr = curr->next;
+    /* Fetch everything the screen can show at once, plus a little slack for
+     * the UTF-8 lookahead behind the last line. */
+    {
+        const size_t want = (size_t) (r->lines - row) * view->bytes_per_line + MB_LEN_MAX;
+
+        fetch_start = from;
+        fetch_buf = g_malloc (want);
+        fetch_end = fetch_start + (off_t) mcview_hex_fetch (view, fetch_start, fetch_buf, want);
+
+        // substitute the pending edits in one pass
+        mcview_hexedit_overlay (view, fetch_start, fetch_buf, (size_t) (fetch_end - fetch_start));
+    }
 
-    for (; mcview_get_byte (view, from, NULL) && row < r->lines; row++)
+    for (; from < fetch_end && row < r->lines; row++)
     {
         int col = 0;
         int bytes;  // Number of bytes already printed on the line
@@ -170,8 +257,6 @@ mcview_display_hex (WView *view)
 
             if (view->utf8)
             {
-                struct hexedit_change_node *corr = curr;
-
                 if (cont_bytes != 0)
                 {
                     // UTF-8 continuation bytes, print a space (with proper attributes)...
@@ -188,26 +273,20 @@ mcview_display_hex (WView *view)
                 {
                     int j;
                     gchar utf8buf[MB_LEN_MAX + 1];
-                    int res;
                     int first_changed = -1;
 
                     for (j = 0; j < MB_LEN_MAX; j++)
                     {
-                        if (mcview_get_byte (view, from + j, &res))
-                            utf8buf[j] = res;
+                        if (from + j < fetch_end)
+                            utf8buf[j] = fetch_buf[from + j - fetch_start];
                         else
                         {
                             utf8buf[j] = '\0';
                             break;
                         }
-                        if (curr != NULL && from + j == curr->offset)
-                        {
-                            utf8buf[j] = curr->value;
-                            if (first_changed == -1)
-                                first_changed = j;
-                        }
-                        if (curr != NULL && from + j >= curr->offset)
-                            curr = curr->next;
+                        // the fetch buffer already carries the pending values
+                        if (first_changed == -1 && mcview_hexedit_get_byte (view, from + j) >= 0)
+                            first_changed = j;
                     }
                     utf8buf[MB_LEN_MAX] = '\0';
 
@@ -226,21 +305,18 @@ mcview_display_hex (WView *view)
                     }
 
                     utf8_changed = (first_changed >= 0 && first_changed <= cont_bytes);
-                    curr = corr;
                 }
             }
 
             /* For negative rows, the only thing we care about is overflowing
              * UTF-8 continuation bytes which were handled above. */
             if (row < 0)
-            {
-                if (curr != NULL && from == curr->offset)
-                    curr = curr->next;
                 continue;
-            }
 
-            if (!mcview_get_byte (view, from, &c))
+            if (from >= fetch_end)
                 break;
+            // the overlaid fetch buffer already carries the pending value
+            c = fetch_buf[from - fetch_start];
 
             // Save the cursor position for mcview_place_cursor()
             if (from == view->hex_cursor && !view->hexview_in_text)
@@ -250,14 +326,11 @@ mcview_display_hex (WView *view)
             }
 
             // Determine the state of the current byte
-            boldflag_byte = mcview_hex_calculate_boldflag (view, from, curr, FALSE);
-            boldflag_char = mcview_hex_calculate_boldflag (view, from, curr, utf8_changed);
-
-            // Determine the value of the current byte
-            if (curr != NULL && from == curr->offset)
             {
-                c = curr->value;
-                curr = curr->next;
+                const gboolean changed = mcview_hexedit_get_byte (view, from) >= 0;
+
+                boldflag_byte = mcview_hex_calculate_boldflag (view, from, changed, FALSE);
+                boldflag_char = mcview_hex_calculate_boldflag (view, from, changed, utf8_changed);
             }
 
             // Select the color for the hex number
@@ -354,6 +427,8 @@ mcview_display_hex (WView *view)
         }
     }
 
+    g_free (fetch_buf);
+
     // Be polite to the other functions
     tty_setcolor (VIEW_NORMAL_COLOR);
 
@@ -368,37 +443,46 @@ mcview_hexedit_save_changes (WView *view)
 {
     int answer = 0;
 
-    if (view->change_list == NULL)
+    if (!mcview_hexedit_is_modified (view))
         return TRUE;
 
     while (answer == 0)
     {
         int fp;
         char *text;
-        struct hexedit_change_node *curr, *next;
 
         g_assert (view->filename_vpath != NULL);
 
         fp = mc_open (view->filename_vpath, O_WRONLY);
         if (fp != -1)
         {
-            for (curr = view->change_list; curr != NULL; curr = next)
+            // one seek and one write per coalesced run of edited bytes
+            while (view->hexedit_changes->len != 0)
             {
-                next = curr->next;
+                hexedit_run_t *run = g_ptr_array_index (view->hexedit_changes, 0);
+                size_t written = 0;
 
-                if (mc_lseek (fp, curr->offset, SEEK_SET) == -1
-                    || mc_write (fp, &(curr->value), 1) != 1)
+                if (mc_lseek (fp, run->offset, SEEK_SET) == -1)
                     goto save_error;
 
-                // delete the saved item from the change list
-                view->change_list = next;
+                while (written < run->data->len)
+                {
+                    ssize_t n;
+
+                    n = mc_write (fp, run->data->data + written, run->data->len - written);
+                    if (n <= 0)
+                        goto save_error;
+                    written += (size_t) n;
+                }
+
+                /* the run is on disk: drop it and invalidate the cached data
+                 * around it (a retry after a partial failure rewrites the
+                 * whole run, which is harmless) */
+                mcview_set_byte (view, run->offset, run->data->data[0]);
                 view->dirty++;
-                mcview_set_byte (view, curr->offset, curr->value);
-                g_free (curr);
+                g_ptr_array_remove_index (view->hexedit_changes, 0);
             }
 
-            view->change_list = NULL;
-
             if (view->locked)
                 view->locked = unlock_file (view->filename_vpath) != 0;
 
@@ -438,14 +522,11 @@ mcview_toggle_hexedit_mode (WView *view)
 void
 mcview_hexedit_free_change_list (WView *view)
 {
-    struct hexedit_change_node *curr, *next;
-
-    for (curr = view->change_list; curr != NULL; curr = next)
+    if (view->hexedit_changes != NULL)
     {
-        next = curr->next;
-        g_free (curr);
+        g_ptr_array_free (view->hexedit_changes, TRUE);
+        view->hexedit_changes = NULL;
     }
-    view->change_list = NULL;
 
     if (view->locked)
         view->locked = unlock_file (view->filename_vpath) != 0;
@@ -454,20 +535,118 @@ mcview_hexedit_free_change_list (WView *view)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * The pending value of a byte, or (-1) if the byte has not been edited.
+ */
+
+int
+mcview_hexedit_get_byte (const WView *view, off_t offset)
+{
+    const hexedit_run_t *run;
+    guint pos;
+
+    if (view->hexedit_changes == NULL)
+        return -1;
+
+    run = hexedit_run_lookup (view, offset, &pos);
+    return run != NULL ? run->data->data[offset - run->offset] : -1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Record an overwrite of a single byte. Adjacent edits coalesce into runs, so
+ * typing across a block or filling a range stays O(log runs) per byte and the
+ * save path can write whole runs at once.
+ */
 
 void
-mcview_enqueue_change (struct hexedit_change_node **head, struct hexedit_change_node *node)
+mcview_hexedit_put_byte (WView *view, off_t offset, byte value)
 {
-    /* chnode always either points to the head of the list or
-     * to one of the ->next fields in the list. The value at
-     * this location will be overwritten with the new node.   */
-    struct hexedit_change_node **chnode = head;
+    hexedit_run_t *run;
+    hexedit_run_t *neighbour;
+    guint pos;
 
-    while (*chnode != NULL && (*chnode)->offset < node->offset)
-        chnode = &((*chnode)->next);
+    if (view->hexedit_changes == NULL)
+        view->hexedit_changes = g_ptr_array_new_with_free_func (hexedit_run_free);
+
+    run = hexedit_run_lookup (view, offset, &pos);
+    if (run != NULL)
+    {
+        run->data->data[offset - run->offset] = value;
+        return;
+    }
 
-    node->next = *chnode;
-    *chnode = node;
+    // extend the preceding run if the byte is right behind it
+    if (pos > 0)
+    {
+        neighbour = g_ptr_array_index (view->hexedit_changes, pos - 1);
+        if (offset == neighbour->offset + (off_t) neighbour->data->len)
+        {
+            g_byte_array_append (neighbour->data, &value, 1);
+
+            // the gap to the following run may just have closed
+            if (pos < view->hexedit_changes->len)
+            {
+                run = g_ptr_array_index (view->hexedit_changes, pos);
+                if (run->offset == neighbour->offset + (off_t) neighbour->data->len)
+                {
+                    g_byte_array_append (neighbour->data, run->data->data, run->data->len);
+                    g_ptr_array_remove_index (view->hexedit_changes, pos);
+                }
+            }
+            return;
+        }
+    }
+
+    // or prepend to the following run
+    if (pos < view->hexedit_changes->len)
+    {
+        neighbour = g_ptr_array_index (view->hexedit_changes, pos);
+        if (offset + 1 == neighbour->offset)
+        {
+            g_byte_array_prepend (neighbour->data, &value, 1);
+            neighbour->offset--;
+            return;
+        }
+    }
+
+    run = g_new (hexedit_run_t, 1);
+    run->offset = offset;
+    run->data = g_byte_array_new ();
+    g_byte_array_append (run->data, &value, 1);
+    g_ptr_array_insert (view->hexedit_changes, pos, run);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Substitute the pending values into @buf, which holds the datasource bytes
+ * for [offset, offset + len).
+ */
+
+void
+mcview_hexedit_overlay (const WView *view, off_t offset, byte *buf, size_t len)
+{
+    guint pos;
+
+    if (view->hexedit_changes == NULL || len == 0)
+        return;
+
+    (void) hexedit_run_lookup (view, offset, &pos);
+    if (pos > 0)
+        pos--;  // the preceding run may reach into the window
+
+    for (; pos < view->hexedit_changes->len; pos++)
+    {
+        const hexedit_run_t *run = g_ptr_array_index (view->hexedit_changes, pos);
+        const off_t from = MAX (run->offset, offset);
+        const off_t to = MIN (run->offset + (off_t) run->data->len, offset + (off_t) len);
+
+        if (run->offset >= offset + (off_t) len)
+            break;
+        if (from < to)
+            memcpy (buf + (from - offset), run->data->data + (from - run->offset),
+                    (size_t) (to - from));
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -52,13 +52,12 @@ typedef enum
 
 /*** structures declarations (and typedefs of structures)*****************************************/
 
-/* A node for building a change list on change_list */
-struct hexedit_change_node
+/* A run of contiguous pending hex-edit overwrites (see hex.c) */
+typedef struct
 {
-    struct hexedit_change_node *next;
-    off_t offset;
-    byte value;
-};
+    off_t offset;      // first byte covered by the run
+    GByteArray *data;  // pending values for [offset, offset + data->len)
+} hexedit_run_t;
 
 /* A cache entry for mapping offsets into line/column pairs and vice versa.
  * cc_offset, cc_line, and cc_column are the 0-based values of the offset,
@@ -112,6 +111,10 @@ struct WView
     byte *ds_file_data;       // Currently loaded data
     size_t ds_file_datalen;   // Number of valid bytes in file_data
     size_t ds_file_datasize;  // Number of allocated bytes in file_data
+    byte *ds_file_mmap;       // Read-only mapping of a local file, or NULL
+    off_t ds_file_mmap_size;  // Number of mapped bytes
+    char *ds_file_map_path;   // Local path the mapping was made for (mmap reuse cache)
+    time_t ds_file_mtime;     // st_mtime at open time; the quick view reload check
 
     // string data source
     byte *ds_string_data;  // The characters of the string
@@ -123,6 +126,12 @@ struct WView
     size_t growbuf_lastindex;     /* Number of bytes in the last page of the
                                      growing buffer */
     gboolean growbuf_finished;    // TRUE when all data has been read.
+    gboolean growbuf_reading;     /* TRUE while the buffer is being filled;
+                                     breaks the redraw -> fill recursion */
+
+    // Tail-follow mode (see follow.c)
+    gboolean follow_mode;  // Auto-scroll as the file grows
+    int follow_fd;         // inotify descriptor, or -1
 
     mcview_mode_flags_t mode_flags;
 
@@ -151,9 +160,12 @@ struct WView
     gboolean dpy_wrap_dirty;  // dpy_state_top needs to be recomputed
     off_t dpy_text_column;    /* Number of skipped columns in non-wrap
                                * text mode */
+    GHashTable *dpy_hscroll_cache;  /* Unwrap mode: paragraph offset -> parser-formatter
+                                     * state near the viewport's left edge, so horizontal
+                                     * scrolling in huge lines is incremental */
     int cursor_col;           // Cursor column
     int cursor_row;           // Cursor row
-    struct hexedit_change_node *change_list;  // Linked list of changes
+    GPtrArray *hexedit_changes;  // Sorted coalesced runs of pending edits (hexedit_run_t)
     WRect status_area;                        // Where the status line is displayed
     WRect ruler_area;                         // Where the ruler is displayed
     WRect data_area;                          // Where the data is displayed
@@ -224,6 +236,7 @@ cb_ret_t mcview_dialog_callback (Widget *w, Widget *sender, widget_msg_t msg, in
 /* ascii.c: */
 void mcview_display_text (WView *view);
 void mcview_state_machine_init (mcview_state_machine_t *, off_t);
+void mcview_hscroll_cache_clear (WView *view);
 void mcview_ascii_move_down (WView *view, off_t lines);
 void mcview_ascii_move_up (WView *view, off_t lines);
 void mcview_ascii_moveto_bol (WView *view);
@@ -234,6 +247,8 @@ void mcview_ccache_dump (WView *view);
 #endif
 
 void mcview_ccache_lookup (WView *view, coord_cache_entry_t *coord, enum ccache_type lookup_what);
+void mcview_ccache_save (WView *view);
+void mcview_ccache_load (WView *view);
 
 /* datasource.c: */
 void mcview_set_datasource_none (WView *view);
@@ -241,13 +256,15 @@ off_t mcview_get_filesize (WView *view);
 void mcview_update_filesize (WView *view);
 char *mcview_get_ptr_file (WView *view, off_t byte_index);
 char *mcview_get_ptr_string (WView *view, off_t byte_index);
+char *mcview_get_raw_span (WView *view, off_t byte_index, size_t *len);
 gboolean mcview_get_utf (WView *view, off_t byte_index, int *ch, int *ch_len);
 gboolean mcview_get_byte_string (WView *view, off_t byte_index, int *retval);
 gboolean mcview_get_byte_none (WView *view, off_t byte_index, int *retval);
 void mcview_set_byte (WView *view, off_t offset, byte b);
 void mcview_file_load_data (WView *view, off_t byte_index);
 void mcview_close_datasource (WView *view);
-void mcview_set_datasource_file (WView *view, int fd, const struct stat *st);
+void mcview_set_datasource_file (WView *view, int fd, const struct stat *st,
+                                 const vfs_path_t *vpath);
 gboolean mcview_load_command_output (WView *view, const char *command);
 void mcview_set_datasource_vfs_pipe (WView *view, int fd);
 void mcview_set_datasource_string (WView *view, const char *s);
@@ -265,6 +282,10 @@ void mcview_display_toggle_ruler (WView *view);
 void mcview_display_clean (WView *view);
 void mcview_display_ruler (WView *view);
 
+/* follow.c: */
+void mcview_follow_toggle (WView *view);
+void mcview_follow_stop (WView *view);
+
 /* growbuf.c: */
 void mcview_growbuf_init (WView *view);
 void mcview_growbuf_done (WView *view);
@@ -273,13 +294,16 @@ off_t mcview_growbuf_filesize (WView *view);
 void mcview_growbuf_read_until (WView *view, off_t ofs);
 gboolean mcview_get_byte_growing_buffer (WView *view, off_t byte_index, int *retval);
 char *mcview_get_ptr_growing_buffer (WView *view, off_t byte_index);
+char *mcview_get_span_growing_buffer (WView *view, off_t byte_index, size_t *len);
 
 /* hex.c: */
 void mcview_display_hex (WView *view);
 gboolean mcview_hexedit_save_changes (WView *view);
 void mcview_toggle_hexedit_mode (WView *view);
 void mcview_hexedit_free_change_list (WView *view);
-void mcview_enqueue_change (struct hexedit_change_node **head, struct hexedit_change_node *node);
+int mcview_hexedit_get_byte (const WView *view, off_t offset);
+void mcview_hexedit_put_byte (WView *view, off_t offset, byte value);
+void mcview_hexedit_overlay (const WView *view, off_t offset, byte *buf, size_t len);
 
 /* lib.c: */
 void mcview_toggle_magic_mode (WView *view);
@@ -359,6 +383,14 @@ mcview_may_still_grow (WView *view)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static inline gboolean
+mcview_hexedit_is_modified (const WView *view)
+{
+    return (view->hexedit_changes != NULL && view->hexedit_changes->len != 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /* returns TRUE if the idx lies in the half-open interval
  * [offset; offset + size), FALSE otherwise.
  */
@@ -375,6 +407,14 @@ mcview_get_byte_file (WView *view, off_t byte_index, int *retval)
 {
     g_assert (view->datasource == DS_FILE);
 
+    // bytes under the mapping cost a dereference; the rest goes through read(2) windows
+    if (view->ds_file_mmap != NULL && byte_index >= 0 && byte_index < view->ds_file_mmap_size)
+    {
+        if (retval)
+            *retval = view->ds_file_mmap[byte_index];
+        return TRUE;
+    }
+
     mcview_file_load_data (view, byte_index);
     if (mcview_already_loaded (view->ds_file_offset, byte_index, view->ds_file_datalen))
     {
@@ -35,7 +35,7 @@
 
 #include <config.h>
 
-#include <string.h>  // memset()
+#include <string.h>  // memset(), memchr()
 #include <sys/types.h>
 
 #include "lib/global.h"
@@ -115,6 +115,14 @@ mcview_toggle_nroff_mode (WView *view)
     view->dpy_wrap_dirty = TRUE;
     view->dpy_bbar_dirty = TRUE;
     view->dirty++;
+
+    // the cached nroff columns depend on whether nroff sequences are interpreted
+    if (view->coord_cache != NULL)
+    {
+        g_ptr_array_free (view->coord_cache, TRUE);
+        view->coord_cache = NULL;
+    }
+    mcview_hscroll_cache_clear (view);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -164,17 +172,21 @@ mcview_init (WView *view)
     view->locked = FALSE;
     view->coord_cache = NULL;
 
+    view->follow_mode = FALSE;
+    view->follow_fd = -1;
+
     view->dpy_start = 0;
     view->dpy_paragraph_skip_lines = 0;
     mcview_state_machine_init (&view->dpy_state_top, 0);
     view->dpy_wrap_dirty = FALSE;
     view->force_max = -1;
     view->dpy_text_column = 0;
+    view->dpy_hscroll_cache = NULL;
     view->dpy_end = 0;
     view->hex_cursor = 0;
     view->cursor_col = 0;
     view->cursor_row = 0;
-    view->change_list = NULL;
+    view->hexedit_changes = NULL;
 
     // {status,ruler,data}_area are left uninitialized
 
@@ -206,6 +218,7 @@ mcview_done (WView *view)
         save_file_position (view->filename_vpath, -1, 0,
                             view->mode_flags.hex ? view->hex_cursor : view->dpy_start,
                             view->saved_bookmarks);
+        mcview_ccache_save (view);
         view->saved_bookmarks = NULL;
     }
 
@@ -229,6 +242,8 @@ mcview_done (WView *view)
         view->coord_cache = NULL;
     }
 
+    mcview_hscroll_cache_clear (view);
+
     if (view->converter == INVALID_CONV)
         view->converter = str_cnv_from_term;
 
@@ -276,6 +291,7 @@ mcview_set_codeset (WView *view)
         }
         view->utf8 = (gboolean) str_isutf8 (cp_id);
         view->dpy_wrap_dirty = TRUE;
+        mcview_hscroll_cache_clear (view);
     }
 }
 
@@ -345,31 +361,48 @@ mcview_bol (WView *view, off_t current, off_t limit)
 /* --------------------------------------------------------------------------------------------- */
 /** returns index of last char on line + width EOL
  * mcview_eol of the current line == mcview_bol next line
+ *
+ * The line terminator is looked for in whole spans of raw bytes instead of
+ * fetching them one by one: this is the workhorse behind skipping over the
+ * lines that don't make it onto the screen.
  */
 
 off_t
 mcview_eol (WView *view, off_t current)
 {
     int c;
-    int prev_ch = 0;
 
     if (current < 0)
         return 0;
 
-    for (; mcview_get_byte (view, current, &c); current++)
+    while (TRUE)
     {
-        if (c == '\n')
+        const char *data;
+        const char *nl;
+        const char *cr;
+        size_t len;
+
+        data = mcview_get_raw_span (view, current, &len);
+        if (data == NULL || len == 0)
+            return current;
+
+        nl = memchr (data, '\n', len);
+        cr = memchr (data, '\r', nl != NULL ? (size_t) (nl - data) : len);
+
+        if (cr != NULL)
         {
-            current++;
-            break;
+            // a bare CR ends the line; a CR LF pair is swallowed as a whole
+            current += cr - data + 1;
+            if (mcview_get_byte (view, current, &c) && c == '\n')
+                current++;
+            return current;
         }
-        if (prev_ch == '\r')
-            break;
 
-        prev_ch = c;
-    }
+        if (nl != NULL)
+            return current + (nl - data) + 1;
 
-    return current;
+        current += (off_t) len;
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -383,7 +416,7 @@ mcview_get_title (const WDialog *h, const ssize_t width)
     const char *view_filename;
 
     view = (const WView *) widget_find_by_type (CONST_WIDGET (h), mcview_callback);
-    modified = view->hexedit_mode && (view->change_list != NULL) ? "(*) " : "    ";
+    modified = view->hexedit_mode && mcview_hexedit_is_modified (view) ? "(*) " : "    ";
     view_filename = vfs_path_as_str (view->filename_vpath);
 
     const ssize_t width1 = width - 4;
@@ -370,6 +370,8 @@ mcview_load (WView *view, const char *command, const char *file, int start_line,
         }
         else
         {
+            const vfs_path_t *map_vpath = vpath;
+
             if (view->mode_flags.magic)
             {
                 int type;
@@ -378,10 +380,31 @@ mcview_load (WView *view, const char *command, const char *file, int start_line,
 
                 if (type != COMPRESSION_NONE)
                 {
+                    const char *filter;
                     char *tmp_filename;
                     vfs_path_t *vpath1;
                     int fd1;
 
+                    /* Stream a local compressed file through the filter into the growing
+                       buffer: the first screenful is shown after one pipe read, while the
+                       decompress_extension() route below first materializes the whole
+                       decompressed file in a temporary copy. */
+                    filter = decompress_command (type);
+                    if (filter != NULL && vfs_file_is_local (vpath))
+                    {
+                        char *quoted_name;
+                        char *cmd;
+
+                        mc_close (fd);
+
+                        quoted_name = name_quote (file, FALSE);
+                        cmd = g_strdup_printf ("%s < %s", filter, quoted_name);
+                        g_free (quoted_name);
+                        retval = mcview_load_command_output (view, cmd);
+                        g_free (cmd);
+                        goto finish;
+                    }
+
                     tmp_filename = g_strconcat (file, decompress_extension (type), (char *) NULL);
                     vpath1 = vfs_path_from_str (tmp_filename);
                     g_free (tmp_filename);
@@ -398,11 +421,13 @@ mcview_load (WView *view, const char *command, const char *file, int start_line,
                         mc_close (fd);
                         fd = fd1;
                         mc_fstat (fd, &st);
+                        // the data now comes from the decompression filter, not from the file
+                        map_vpath = NULL;
                     }
                 }
             }
 
-            mcview_set_datasource_file (view, fd, &st);
+            mcview_set_datasource_file (view, fd, &st, map_vpath);
         }
         retval = TRUE;
     }
@@ -424,6 +449,9 @@ finish:
         long line, col;
         off_t new_offset, max_offset;
 
+        // pick up the line index built the last time the file was viewed
+        mcview_ccache_load (view);
+
         load_file_position (view->filename_vpath, &line, &col, &new_offset, &view->saved_bookmarks);
         max_offset = mcview_get_filesize (view) - 1;
         if (max_offset < 0)
@@ -448,7 +476,7 @@ finish:
     view->search_end = search_end;
     view->hexedit_lownibble = FALSE;
     view->hexview_in_text = FALSE;
-    view->change_list = NULL;
+    view->hexedit_changes = NULL;
     vfs_path_free (vpath, TRUE);
     return retval;
 }
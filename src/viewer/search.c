@@ -56,6 +56,9 @@ mcview_search_options_t mcview_search_options = {
 
 /*** file scope macro definitions ****************************************************************/
 
+// bytes handed to one mc_search_run_partial () slice of a forward search
+#define MCVIEW_SEARCH_CHUNK (1 << 20)
+
 /*** file scope type declarations ****************************************************************/
 
 typedef struct
@@ -206,7 +209,31 @@ mcview_find (mcview_search_status_msg_t *ssm, off_t search_start, off_t search_e
     view->search_nroff_seq->index = search_start;
     mcview_nroff_seq_info (view->search_nroff_seq);
 
-    return mc_search_run (view->search, (void *) ssm, search_start, search_end, len);
+    /* Search in bounded slices so huge files keep the UI responsive: between
+       the slices the status message can repaint and a pending abort is
+       honored even when the update callback inside the engine is starved. */
+    while (TRUE)
+    {
+        gboolean ok;
+
+        ok = mc_search_run_partial (view->search, (void *) ssm, &search_start, search_end,
+                                    MCVIEW_SEARCH_CHUNK, len);
+        if (ok || view->search->error != MC_SEARCH_E_CONTINUE)
+            return ok;
+
+        if (view->search->update_fn != NULL
+            && view->search->update_fn (ssm, search_start) == MC_SEARCH_CB_ABORT)
+        {
+            mc_search_set_error (view->search, MC_SEARCH_E_ABORT, NULL);
+            return FALSE;
+        }
+
+        // the next slice starts on a fresh line: re-seed the nroff state
+        view->search_numNeedSkipChar = 0;
+        search_cb_char_curr_index = -1;
+        view->search_nroff_seq->index = search_start;
+        mcview_nroff_seq_info (view->search_nroff_seq);
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
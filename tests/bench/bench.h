@@ -0,0 +1,79 @@
+/*
+   Small shared helpers for the microbenchmark programs in tests/bench.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MC_BENCH_H
+#define MC_BENCH_H
+
+#include <stdio.h>
+
+#include <glib.h>
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+/*** inline functions ****************************************************************************/
+
+/**
+ * Read a benchmark size parameter from the environment.
+ *
+ * @param env_name name of the environment variable
+ * @param def default when the variable is unset or empty
+ *
+ * @return parsed value or default
+ */
+static inline gsize
+bench_size_arg (const char *env_name, gsize def)
+{
+    const char *s = g_getenv (env_name);
+
+    if (s == NULL || *s == '\0')
+        return def;
+
+    return (gsize) g_ascii_strtoull (s, NULL, 10);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Print one result line: total wall time and per-operation cost.
+ *
+ * @param name short label of the measured operation
+ * @param elapsed_us wall time in microseconds
+ * @param ops number of operations performed in that time
+ */
+static inline void
+bench_report (const char *name, gint64 elapsed_us, gsize ops)
+{
+    printf ("%-44s %10.1f ms  %12.1f ns/op  (%" G_GSIZE_FORMAT " ops)\n", name,
+            elapsed_us / 1000.0, ops == 0 ? 0.0 : elapsed_us * 1000.0 / (double) ops, ops);
+    fflush (stdout);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#endif
@@ -0,0 +1,220 @@
+/*
+   Microbenchmark: dir_list_load() and dir_list_sort() over synthetic trees.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/strutil.h"
+#include "lib/vfs/vfs.h"
+#include "src/vfs/local/local.h"
+
+#include "src/filemanager/dir.h"
+
+#include "bench.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* Entry counts exercised by default. One million entries takes minutes just to
+ * create on most file systems, so that size is opt-in: BENCH_ENTRIES=1000000
+ * replaces the default list with a single run of the given size. */
+static const gsize default_sizes[] = { 10000, 100000 };
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Create a temporary directory holding @count empty files with a mix of plain,
+ * suffixed and versioned names, so that every comparator has real work to do.
+ */
+static char *
+make_synthetic_tree (gsize count)
+{
+    char *dname;
+    gsize i;
+
+    dname = g_build_filename (g_get_tmp_dir (), "mc-bench-XXXXXX", (char *) NULL);
+    if (g_mkdtemp (dname) == NULL)
+    {
+        perror ("g_mkdtemp");
+        exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        char name[BUF_SMALL];
+        char *path;
+        int fd;
+
+        switch (i % 4)
+        {
+        case 0:
+            g_snprintf (name, sizeof (name), "source-%07" G_GSIZE_FORMAT ".c", i);
+            break;
+        case 1:
+            g_snprintf (name, sizeof (name), "notes-%07" G_GSIZE_FORMAT ".txt", i);
+            break;
+        case 2:
+            g_snprintf (name, sizeof (name), "pkg-1.%" G_GSIZE_FORMAT ".%" G_GSIZE_FORMAT ".tar.gz",
+                        i % 30, i);
+            break;
+        default:
+            g_snprintf (name, sizeof (name), "plain-%07" G_GSIZE_FORMAT, i);
+            break;
+        }
+
+        path = g_build_filename (dname, name, (char *) NULL);
+        fd = open (path, O_CREAT | O_WRONLY, 0644);
+        if (fd >= 0)
+            close (fd);
+        g_free (path);
+    }
+
+    return dname;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+remove_synthetic_tree (const char *dname)
+{
+    GDir *dir;
+
+    dir = g_dir_open (dname, 0, NULL);
+    if (dir != NULL)
+    {
+        const char *entry;
+
+        while ((entry = g_dir_read_name (dir)) != NULL)
+        {
+            char *path;
+
+            path = g_build_filename (dname, entry, (char *) NULL);
+            unlink (path);
+            g_free (path);
+        }
+        g_dir_close (dir);
+    }
+
+    rmdir (dname);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_one_size (gsize count)
+{
+    static const struct
+    {
+        const char *name;
+        int (*cmp) (file_entry_t *, file_entry_t *);
+    } comparators[] = {
+        { "sort_name", sort_name },
+        { "sort_ext", sort_ext },
+        { "sort_vers", sort_vers },
+        { "sort_size", sort_size },
+        { "sort_time", sort_time },
+    };
+
+    char *dname;
+    vfs_path_t *vpath;
+    dir_list list;
+    dir_sort_options_t sort_op = {
+        .reverse = FALSE,
+        .case_sensitive = TRUE,
+        .exec_first = FALSE,
+    };
+    char label[BUF_SMALL];
+    gint64 t0;
+    gsize i;
+
+    printf ("-- %" G_GSIZE_FORMAT " entries --\n", count);
+
+    dname = make_synthetic_tree (count);
+    vpath = vfs_path_from_str (dname);
+    dir_list_init (&list);
+
+    t0 = g_get_monotonic_time ();
+    dir_list_load (&list, vpath, (GCompareFunc) unsorted, &sort_op, NULL);
+    g_snprintf (label, sizeof (label), "dir_list_load/%" G_GSIZE_FORMAT, count);
+    bench_report (label, g_get_monotonic_time () - t0, (gsize) list.len);
+
+    for (i = 0; i < G_N_ELEMENTS (comparators); i++)
+    {
+        t0 = g_get_monotonic_time ();
+        dir_list_sort (&list, (GCompareFunc) comparators[i].cmp, &sort_op);
+        g_snprintf (label, sizeof (label), "dir_list_sort/%s/%" G_GSIZE_FORMAT,
+                    comparators[i].name, count);
+        bench_report (label, g_get_monotonic_time () - t0, (gsize) list.len);
+    }
+
+    dir_list_free_list (&list);
+    vfs_path_free (vpath, TRUE);
+    remove_synthetic_tree (dname);
+    g_free (dname);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    gsize override;
+
+    str_init_strings (NULL);
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    override = bench_size_arg ("BENCH_ENTRIES", 0);
+    if (override != 0)
+        bench_one_size (override);
+    else
+    {
+        gsize i;
+
+        for (i = 0; i < G_N_ELEMENTS (default_sizes); i++)
+            bench_one_size (default_sizes[i]);
+    }
+
+    vfs_shut ();
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
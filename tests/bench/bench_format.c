@@ -0,0 +1,142 @@
+/*
+   Microbenchmark: terminal string formatting used by the panel paint path.
+
+   A full panel repaint cannot run without the tty and widget layers, so this
+   program measures the CPU-bound part of it: str_term_form(),
+   str_fit_to_term() and str_term_trim() over file-name-like strings, which is
+   where display_mini_info() and repaint_file() spend their cycles.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/global.h"
+#include "lib/strutil.h"
+
+#include "bench.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static GPtrArray *
+make_names (gsize count)
+{
+    GPtrArray *names;
+    gsize i;
+
+    names = g_ptr_array_new_full (count, g_free);
+
+    for (i = 0; i < count; i++)
+        switch (i % 4)
+        {
+        case 0:
+            g_ptr_array_add (names,
+                             g_strdup_printf ("source-%07" G_GSIZE_FORMAT ".c", i));
+            break;
+        case 1:
+            // multibyte names: accents and double-width CJK go through the slow paths
+            g_ptr_array_add (names,
+                             g_strdup_printf ("r\xc3\xa9sum\xc3\xa9-%" G_GSIZE_FORMAT
+                                              "-\xe6\x96\x87\xe6\xa1\xa3.txt", i));
+            break;
+        case 2:
+            g_ptr_array_add (names,
+                             g_strdup_printf ("a-rather-long-file-name-that-will-be-truncated-"
+                                              "%07" G_GSIZE_FORMAT ".tar.gz", i));
+            break;
+        default:
+            g_ptr_array_add (names, g_strdup_printf ("plain-%07" G_GSIZE_FORMAT, i));
+            break;
+        }
+
+    return names;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+run_fit (GPtrArray *names, int width, align_crt_t just_mode, const char *label)
+{
+    gint64 t0;
+    gsize i;
+    // keep the calls from being optimized away
+    volatile size_t sink = 0;
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < names->len; i++)
+        sink += strlen (str_fit_to_term (g_ptr_array_index (names, i), width, just_mode));
+    bench_report (label, g_get_monotonic_time () - t0, names->len);
+    (void) sink;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    GPtrArray *names;
+    gint64 t0;
+    gsize i, count;
+    volatile size_t sink = 0;
+
+    str_init_strings (NULL);
+
+    count = bench_size_arg ("BENCH_NAMES", 200000);
+    names = make_names (count);
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < names->len; i++)
+        sink += strlen (str_term_form (g_ptr_array_index (names, i)));
+    bench_report ("str_term_form", g_get_monotonic_time () - t0, names->len);
+
+    run_fit (names, 17, J_LEFT_FIT, "str_fit_to_term/17/J_LEFT_FIT");
+    run_fit (names, 40, J_LEFT_FIT, "str_fit_to_term/40/J_LEFT_FIT");
+    run_fit (names, 17, J_RIGHT, "str_fit_to_term/17/J_RIGHT");
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < names->len; i++)
+        sink += strlen (str_term_trim (g_ptr_array_index (names, i), 17));
+    bench_report ("str_term_trim/17", g_get_monotonic_time () - t0, names->len);
+    (void) sink;
+
+    g_ptr_array_free (names, TRUE);
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,136 @@
+/*
+   Microbenchmark: mc_search_run() over a generated file-name corpus.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/global.h"
+#include "lib/search.h"
+#include "lib/strutil.h"
+
+#include "bench.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static GPtrArray *
+make_corpus (gsize count)
+{
+    GPtrArray *names;
+    gsize i;
+
+    names = g_ptr_array_new_full (count, g_free);
+
+    for (i = 0; i < count; i++)
+        switch (i % 4)
+        {
+        case 0:
+            g_ptr_array_add (names, g_strdup_printf ("source-%07" G_GSIZE_FORMAT ".c", i));
+            break;
+        case 1:
+            g_ptr_array_add (names, g_strdup_printf ("notes-%07" G_GSIZE_FORMAT ".txt", i));
+            break;
+        case 2:
+            g_ptr_array_add (names,
+                             g_strdup_printf ("pkg-1.%" G_GSIZE_FORMAT ".%" G_GSIZE_FORMAT
+                                              ".tar.gz", i % 30, i));
+            break;
+        default:
+            g_ptr_array_add (names, g_strdup_printf ("plain-%07" G_GSIZE_FORMAT, i));
+            break;
+        }
+
+    return names;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+run_pattern (GPtrArray *names, mc_search_type_t type, const char *pattern, const char *label)
+{
+    mc_search_t *search;
+    gint64 t0;
+    gsize i, matched = 0;
+    char full_label[BUF_SMALL];
+
+    search = mc_search_new (pattern, NULL);
+    search->search_type = type;
+    search->is_entire_line = (type == MC_SEARCH_T_GLOB);
+    search->is_case_sensitive = TRUE;
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < names->len; i++)
+    {
+        const char *name = g_ptr_array_index (names, i);
+
+        if (mc_search_run (search, name, 0, strlen (name), NULL))
+            matched++;
+    }
+
+    g_snprintf (full_label, sizeof (full_label), "mc_search_run/%s", label);
+    bench_report (full_label, g_get_monotonic_time () - t0, names->len);
+    printf ("%46s %" G_GSIZE_FORMAT " matches\n", "", matched);
+
+    mc_search_free (search);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    GPtrArray *names;
+    gsize count;
+
+    str_init_strings (NULL);
+
+    count = bench_size_arg ("BENCH_NAMES", 200000);
+    names = make_corpus (count);
+
+    run_pattern (names, MC_SEARCH_T_NORMAL, "0000042", "normal/literal");
+    run_pattern (names, MC_SEARCH_T_GLOB, "*.tar.gz", "glob/suffix");
+    run_pattern (names, MC_SEARCH_T_REGEX, "pkg-1\\.[0-9]+\\.[0-9]*7\\.tar\\.gz",
+                 "regex/versioned");
+
+    g_ptr_array_free (names, TRUE);
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
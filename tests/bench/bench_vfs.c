@@ -0,0 +1,536 @@
+/*
+   Microbenchmark: VFS layer driven through a latency-injecting backend.
+
+   Registers "benchfs", a VFS class that forwards to the local file system but
+   sleeps for a configurable time before every operation and caps read
+   bandwidth, imitating a remote backend.  Scenario drivers then replay the
+   operation mix of a panel load, a copy source and a content search through
+   the ordinary mc_* wrappers and report a latency histogram per operation
+   kind, so that changes to the VFS midlayer can be measured without a real
+   network.
+
+   Tunables (environment): BENCH_VFS_LATENCY_US (default 200),
+   BENCH_VFS_BANDWIDTH_KBPS (default 0 = unlimited), BENCH_VFS_FILES
+   (default 1000).
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/search.h"
+#include "lib/strutil.h"
+#include "lib/vfs/vfs.h"
+#include "src/vfs/local/local.h"
+
+#include "src/filemanager/dir.h"
+
+#include "bench.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define BENCH_HIST_BUCKETS 24
+
+/*** file scope type declarations ****************************************************************/
+
+typedef enum
+{
+    BENCH_OP_OPEN = 0,
+    BENCH_OP_READ,
+    BENCH_OP_STAT,
+    BENCH_OP_READDIR,
+    BENCH_OP_MAX
+} bench_op_t;
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+static struct vfs_class benchfs_class;
+
+static gint64 benchfs_latency_us = 200;
+static gint64 benchfs_bandwidth_kbps = 0;
+
+static const char *const op_names[BENCH_OP_MAX] = { "open", "read", "stat", "readdir" };
+
+/* histogram of operation duration, log2 microsecond buckets */
+static gsize op_hist[BENCH_OP_MAX][BENCH_HIST_BUCKETS];
+static gsize op_count[BENCH_OP_MAX];
+static gint64 op_total_us[BENCH_OP_MAX];
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+op_record (bench_op_t op, gint64 t0)
+{
+    const gint64 elapsed = g_get_monotonic_time () - t0;
+    int bucket = 0;
+    gint64 us;
+
+    for (us = elapsed; us > 1 && bucket < BENCH_HIST_BUCKETS - 1; us >>= 1)
+        bucket++;
+
+    op_hist[op][bucket]++;
+    op_count[op]++;
+    op_total_us[op] += elapsed;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+op_report_and_reset (void)
+{
+    int op;
+
+    for (op = 0; op < BENCH_OP_MAX; op++)
+    {
+        int bucket;
+
+        if (op_count[op] == 0)
+            continue;
+
+        printf ("    %-8s %8" G_GSIZE_FORMAT " ops  avg %8.1f us  |", op_names[op], op_count[op],
+                (double) op_total_us[op] / (double) op_count[op]);
+        for (bucket = 0; bucket < BENCH_HIST_BUCKETS; bucket++)
+            if (op_hist[op][bucket] != 0)
+                printf (" <=%" G_GINT64_FORMAT "us:%" G_GSIZE_FORMAT, G_GINT64_CONSTANT (1) << bucket,
+                        op_hist[op][bucket]);
+        printf ("\n");
+    }
+
+    memset (op_hist, 0, sizeof (op_hist));
+    memset (op_count, 0, sizeof (op_count));
+    memset (op_total_us, 0, sizeof (op_total_us));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * The last path element of "/bench://tmp/dir" is "tmp/dir"; glue the root
+ * separator back on to get the real location.
+ */
+static char *
+benchfs_real_path (const vfs_path_t *vpath)
+{
+    const char *path;
+
+    path = vfs_path_get_last_path_str (vpath);
+    return IS_PATH_SEP (*path) ? g_strdup (path) : g_strconcat (PATH_SEP_STR, path, (char *) NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void *
+benchfs_open (const vfs_path_t *vpath, int flags, mode_t mode)
+{
+    const gint64 t0 = g_get_monotonic_time ();
+    char *path;
+    int fd;
+    int *info = NULL;
+
+    g_usleep (benchfs_latency_us);
+
+    path = benchfs_real_path (vpath);
+    fd = open (path, NO_LINEAR (flags), mode);
+    g_free (path);
+
+    if (fd != -1)
+    {
+        info = g_new (int, 1);
+        *info = fd;
+    }
+
+    op_record (BENCH_OP_OPEN, t0);
+    return info;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static ssize_t
+benchfs_read (void *data, char *buffer, size_t count)
+{
+    const gint64 t0 = g_get_monotonic_time ();
+    ssize_t ret;
+
+    g_usleep (benchfs_latency_us);
+
+    ret = local_read (data, buffer, count);
+
+    // model a bandwidth-limited link: sleep for the transfer time of the chunk
+    if (ret > 0 && benchfs_bandwidth_kbps > 0)
+        g_usleep ((gint64) ret * 1000 / benchfs_bandwidth_kbps);
+
+    op_record (BENCH_OP_READ, t0);
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void *
+benchfs_opendir (const vfs_path_t *vpath)
+{
+    char *path;
+    DIR *dir;
+    DIR **info = NULL;
+
+    g_usleep (benchfs_latency_us);
+
+    path = benchfs_real_path (vpath);
+    dir = opendir (path);
+    g_free (path);
+
+    if (dir != NULL)
+    {
+        info = g_new (DIR *, 1);
+        *info = dir;
+    }
+
+    return info;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static struct vfs_dirent *
+benchfs_readdir (void *data)
+{
+    const gint64 t0 = g_get_monotonic_time ();
+    struct dirent *d;
+
+    g_usleep (benchfs_latency_us);
+
+    d = readdir (*(DIR **) data);
+
+    op_record (BENCH_OP_READDIR, t0);
+    return (d != NULL ? vfs_dirent_init (NULL, d->d_name, d->d_ino) : NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+benchfs_closedir (void *data)
+{
+    int ret;
+
+    ret = closedir (*(DIR **) data);
+    g_free (data);
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+benchfs_stat (const vfs_path_t *vpath, struct stat *buf)
+{
+    const gint64 t0 = g_get_monotonic_time ();
+    char *path;
+    int ret;
+
+    g_usleep (benchfs_latency_us);
+
+    path = benchfs_real_path (vpath);
+    ret = stat (path, buf);
+    g_free (path);
+
+    op_record (BENCH_OP_STAT, t0);
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+benchfs_lstat (const vfs_path_t *vpath, struct stat *buf)
+{
+    const gint64 t0 = g_get_monotonic_time ();
+    char *path;
+    int ret;
+
+    g_usleep (benchfs_latency_us);
+
+    path = benchfs_real_path (vpath);
+    ret = lstat (path, buf);
+    g_free (path);
+
+    op_record (BENCH_OP_STAT, t0);
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+benchfs_init (void)
+{
+    benchfs_latency_us = (gint64) bench_size_arg ("BENCH_VFS_LATENCY_US", 200);
+    benchfs_bandwidth_kbps = (gint64) bench_size_arg ("BENCH_VFS_BANDWIDTH_KBPS", 0);
+
+    vfs_init_class (&benchfs_class, "benchfs", VFSF_UNKNOWN, "bench");
+    benchfs_class.open = benchfs_open;
+    benchfs_class.close = local_close;
+    benchfs_class.read = benchfs_read;
+    benchfs_class.opendir = benchfs_opendir;
+    benchfs_class.readdir = benchfs_readdir;
+    benchfs_class.closedir = benchfs_closedir;
+    benchfs_class.stat = benchfs_stat;
+    benchfs_class.lstat = benchfs_lstat;
+    benchfs_class.fstat = local_fstat;
+    benchfs_class.ferrno = local_errno;
+    benchfs_class.lseek = local_lseek;
+    vfs_register_class (&benchfs_class);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create @count files in a temporary directory; the first @data_files of them
+ * get @data_size bytes of content for the copy and search scenarios.
+ */
+static char *
+make_corpus_tree (gsize count, gsize data_files, gsize data_size)
+{
+    char *dname;
+    char *blob;
+    gsize i;
+
+    dname = g_build_filename (g_get_tmp_dir (), "mc-bench-vfs-XXXXXX", (char *) NULL);
+    if (g_mkdtemp (dname) == NULL)
+    {
+        perror ("g_mkdtemp");
+        exit (EXIT_FAILURE);
+    }
+
+    blob = g_malloc (data_size);
+    for (i = 0; i < data_size; i++)
+        blob[i] = (char) ('a' + i % 23);
+    // plant a needle near the end of every data file
+    if (data_size > 16)
+        memcpy (blob + data_size - 16, "BENCH-NEEDLE-42", 15);
+
+    for (i = 0; i < count; i++)
+    {
+        char *path;
+        int fd;
+
+        path = g_strdup_printf ("%s%cfile-%07" G_GSIZE_FORMAT ".dat", dname, PATH_SEP, i);
+        fd = open (path, O_CREAT | O_WRONLY, 0644);
+        if (fd >= 0)
+        {
+            if (i < data_files)
+            {
+                ssize_t written = write (fd, blob, data_size);
+                (void) written;
+            }
+            close (fd);
+        }
+        g_free (path);
+    }
+
+    g_free (blob);
+    return dname;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+remove_corpus_tree (const char *dname)
+{
+    GDir *dir;
+
+    dir = g_dir_open (dname, 0, NULL);
+    if (dir != NULL)
+    {
+        const char *entry;
+
+        while ((entry = g_dir_read_name (dir)) != NULL)
+        {
+            char *path;
+
+            path = g_build_filename (dname, entry, (char *) NULL);
+            unlink (path);
+            g_free (path);
+        }
+        g_dir_close (dir);
+    }
+
+    rmdir (dname);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Panel load: one opendir/readdir sweep plus an lstat per entry. */
+static void
+scenario_panel_load (const char *bench_dir, gsize count)
+{
+    vfs_path_t *vpath;
+    dir_list list;
+    dir_sort_options_t sort_op = {
+        .reverse = FALSE,
+        .case_sensitive = TRUE,
+        .exec_first = FALSE,
+    };
+    gint64 t0;
+
+    (void) count;
+
+    vpath = vfs_path_from_str (bench_dir);
+    dir_list_init (&list);
+
+    t0 = g_get_monotonic_time ();
+    dir_list_load (&list, vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+    bench_report ("scenario/panel_load", g_get_monotonic_time () - t0, (gsize) list.len);
+    op_report_and_reset ();
+
+    dir_list_free_list (&list);
+    vfs_path_free (vpath, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Copy source: sequential whole-file reads, the read half of file_copy. */
+static void
+scenario_copy_source (const char *bench_dir, gsize data_files)
+{
+    char buffer[BUF_8K];
+    gint64 t0;
+    gsize i, bytes = 0;
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < data_files; i++)
+    {
+        char *fname;
+        vfs_path_t *vpath;
+        int fd;
+
+        fname = g_strdup_printf ("%s%cfile-%07" G_GSIZE_FORMAT ".dat", bench_dir, PATH_SEP, i);
+        vpath = vfs_path_from_str (fname);
+        g_free (fname);
+        fd = mc_open (vpath, O_RDONLY);
+        if (fd >= 0)
+        {
+            ssize_t n;
+
+            while ((n = mc_read (fd, buffer, sizeof (buffer))) > 0)
+                bytes += (gsize) n;
+            mc_close (fd);
+        }
+        vfs_path_free (vpath, TRUE);
+    }
+
+    bench_report ("scenario/copy_source", g_get_monotonic_time () - t0, bytes);
+    op_report_and_reset ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Content search: read every data file and scan it, as "Find file" does. */
+static void
+scenario_search (const char *bench_dir, gsize data_files, gsize data_size)
+{
+    mc_search_t *search;
+    char *buffer;
+    gint64 t0;
+    gsize i, hits = 0;
+
+    search = mc_search_new ("BENCH-NEEDLE-42", NULL);
+    search->search_type = MC_SEARCH_T_NORMAL;
+    search->is_case_sensitive = TRUE;
+
+    buffer = g_malloc (data_size);
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < data_files; i++)
+    {
+        char *fname;
+        vfs_path_t *vpath;
+        int fd;
+
+        fname = g_strdup_printf ("%s%cfile-%07" G_GSIZE_FORMAT ".dat", bench_dir, PATH_SEP, i);
+        vpath = vfs_path_from_str (fname);
+        g_free (fname);
+        fd = mc_open (vpath, O_RDONLY);
+        if (fd >= 0)
+        {
+            ssize_t n;
+
+            n = mc_read (fd, buffer, data_size);
+            if (n > 0 && mc_search_run (search, buffer, 0, n, NULL))
+                hits++;
+            mc_close (fd);
+        }
+        vfs_path_free (vpath, TRUE);
+    }
+
+    bench_report ("scenario/search", g_get_monotonic_time () - t0, data_files);
+    printf ("%46s %" G_GSIZE_FORMAT " hits\n", "", hits);
+    op_report_and_reset ();
+
+    g_free (buffer);
+    mc_search_free (search);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    const gsize data_size = 64 * 1024;
+    gsize count, data_files;
+    char *dname;
+    char *bench_dir;
+
+    str_init_strings (NULL);
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+    benchfs_init ();
+
+    count = bench_size_arg ("BENCH_VFS_FILES", 1000);
+    data_files = MIN (count, 100);
+
+    dname = make_corpus_tree (count, data_files, data_size);
+    // route everything through benchfs: /bench://tmp/...
+    bench_dir = g_strdup_printf ("%sbench:%s%s", PATH_SEP_STR, PATH_SEP_STR, dname);
+
+    printf ("benchfs: latency %" G_GINT64_FORMAT " us/op, bandwidth %s\n", benchfs_latency_us,
+            benchfs_bandwidth_kbps > 0 ? "limited" : "unlimited");
+
+    scenario_panel_load (bench_dir, count);
+    scenario_copy_source (bench_dir, data_files);
+    scenario_search (bench_dir, data_files, data_size);
+
+    remove_corpus_tree (dname);
+    g_free (bench_dir);
+    g_free (dname);
+
+    vfs_shut ();
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,149 @@
+/*
+   libmc - checks for the simple glob fast path
+
+   Copyright (C) 2011-2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search/glob"
+
+#include "tests/mctest.h"
+
+#include "glob.c"  // for testing static functions
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_glob_simple_search_ds") */
+static const struct test_glob_simple_search_ds
+{
+    const char *haystack;
+    const char *pattern;
+    gboolean case_sensitive;
+    gboolean expected_found;
+} test_glob_simple_search_ds[] = {
+    {
+        // 0. suffix form
+        "main.o",
+        "*.o",
+        TRUE,
+        TRUE,
+    },
+    {
+        // 1. suffix miss
+        "main.c",
+        "*.o",
+        TRUE,
+        FALSE,
+    },
+    {
+        // 2. prefix form
+        "core.12345",
+        "core*",
+        TRUE,
+        TRUE,
+    },
+    {
+        // 3. exact form
+        "Makefile",
+        "Makefile",
+        TRUE,
+        TRUE,
+    },
+    {
+        // 4. exact form must match the whole name
+        "GNUmakefile",
+        "Makefile",
+        TRUE,
+        FALSE,
+    },
+    {
+        // 5. contains form, case insensitive
+        "GNUmakefile",
+        "*makef*",
+        FALSE,
+        TRUE,
+    },
+    {
+        // 6. a single star matches everything
+        "whatever",
+        "*",
+        TRUE,
+        TRUE,
+    },
+    {
+        // 7. stars only: the body strips to nothing and must still match everything
+        "whatever",
+        "**",
+        FALSE,
+        TRUE,
+    },
+    {
+        // 8. stars only against an empty name
+        "",
+        "**",
+        TRUE,
+        TRUE,
+    },
+    {
+        // 9. character class: not simple, handled by the regex path
+        "main.o",
+        "*.[co]",
+        TRUE,
+        TRUE,
+    },
+};
+
+/* @Test(dataSource = "test_glob_simple_search_ds") */
+START_PARAMETRIZED_TEST (test_glob_simple_search, test_glob_simple_search_ds)
+{
+    // given
+    mc_search_t *s;
+    gboolean found;
+
+    s = mc_search_new (data->pattern, NULL);
+    s->search_type = MC_SEARCH_T_GLOB;
+    s->is_entire_line = TRUE;
+    s->is_case_sensitive = data->case_sensitive;
+
+    // when: the panel filter convention -- strlen () as the inclusive end
+    found = mc_search_run (s, data->haystack, 0, strlen (data->haystack), NULL);
+
+    // then
+    ck_assert_int_eq (found, data->expected_found);
+
+    mc_search_free (s);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_glob_simple_search, test_glob_simple_search_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -34,54 +34,83 @@ static const struct test_hex_translate_to_regex_ds
     const char *input_value;
     const char *expected_result;
     mc_search_hex_parse_error_t expected_error;
+    /* pattern bytes collected for the literal matcher; NULL when the pattern
+       is not a plain byte sequence */
+    const char *expected_literal;
+    gsize expected_literal_len;
+    gboolean expected_has_letters;
 } test_hex_translate_to_regex_ds[] = {
     {
         // Simplest case
         "12 34",
         "\\x12\\x34",
         MC_SEARCH_HEX_E_OK,
+        "\x12\x34",
+        2,
+        FALSE,
     },
     {
         // Prefixes (0x, 0X)
         "0x12 0X34",
         "\\x12\\x34",
         MC_SEARCH_HEX_E_OK,
+        "\x12\x34",
+        2,
+        FALSE,
     },
     {
         // Prefix "0" doesn't signify octal! Numbers are always interpreted in hex.
         "012",
         "\\x12",
         MC_SEARCH_HEX_E_OK,
+        "\x12",
+        1,
+        FALSE,
     },
     {
         // Extra whitespace
         "  12  34  ",
         "\\x12\\x34",
         MC_SEARCH_HEX_E_OK,
+        "\x12\x34",
+        2,
+        FALSE,
     },
     {
         // Min/max values
         "0 ff",
         "\\x00\\xFF",
         MC_SEARCH_HEX_E_OK,
+        "\x00\xFF",
+        2,
+        FALSE,
     },
     {
         // Error: Number out of range
         "100",
         NULL,
         MC_SEARCH_HEX_E_NUM_OUT_OF_RANGE,
+        NULL,
+        0,
+        FALSE,
     },
     {
         // Error: Number out of range (negative)
         "-1",
         NULL,
         MC_SEARCH_HEX_E_NUM_OUT_OF_RANGE,
+        NULL,
+        0,
+        FALSE,
     },
     {
         // Error: Invalid characters
         "1 z 2",
         NULL,
         MC_SEARCH_HEX_E_INVALID_CHARACTER,
+        NULL,
+        0,
+        FALSE,
     },
     /*
      * Quotes.
@@ -90,55 +119,90 @@ static const struct test_hex_translate_to_regex_ds
         " \"abc\" ",
         "abc",
         MC_SEARCH_HEX_E_OK,
+        "abc",
+        3,
+        TRUE,
     },
     {
         // Preserve upper/lower case
         "\"aBc\"",
         "aBc",
         MC_SEARCH_HEX_E_OK,
+        "aBc",
+        3,
+        TRUE,
     },
     {
         " 12\"abc\"34 ",
-        "\\x12abc\\x34",
+        "\\x12"
+        "abc"
+        "\\x34",
         MC_SEARCH_HEX_E_OK,
+        "\x12"
+        "abc"
+        "\x34",
+        5,
+        TRUE,
     },
     {
         "\"a\"\"b\"",
         "ab",
         MC_SEARCH_HEX_E_OK,
+        "ab",
+        2,
+        TRUE,
     },
     // Empty quotes
     {
         "\"\"",
         "",
         MC_SEARCH_HEX_E_OK,
+        NULL,
+        0,
+        FALSE,
     },
     {
         "12 \"\"",
         "\\x12",
         MC_SEARCH_HEX_E_OK,
+        "\x12",
+        1,
+        FALSE,
     },
     // Error: Unmatched quotes
     {
         "\"a",
         NULL,
         MC_SEARCH_HEX_E_UNMATCHED_QUOTES,
+        NULL,
+        0,
+        FALSE,
     },
     {
         "\"",
         NULL,
         MC_SEARCH_HEX_E_UNMATCHED_QUOTES,
+        NULL,
+        0,
+        FALSE,
     },
     // Escaped quotes
     {
         "\"a\\\"b\"",
         "a\"b",
         MC_SEARCH_HEX_E_OK,
+        "a\"b",
+        3,
+        TRUE,
     },
     {
+        // the backslash keeps its regex meaning, so no literal is collected
         "\"a\\\\b\"",
         "a\\b",
         MC_SEARCH_HEX_E_OK,
+        NULL,
+        0,
+        FALSE,
     },
 };
 
@@ -146,13 +210,15 @@ static const struct test_hex_translate_to_regex_ds
 START_PARAMETRIZED_TEST (test_hex_translate_to_regex, test_hex_translate_to_regex_ds)
 {
     GString *tmp, *dest_str;
+    GString *literal = NULL;
+    gboolean has_letters = FALSE;
     mc_search_hex_parse_error_t error = MC_SEARCH_HEX_E_OK;
 
     // given
     tmp = g_string_new (data->input_value);
 
     // when
-    dest_str = mc_search__hex_translate_to_regex (tmp, &error, NULL);
+    dest_str = mc_search__hex_translate_to_regex (tmp, &literal, &has_letters, &error, NULL);
 
     g_string_free (tmp, TRUE);
 
@@ -161,9 +227,114 @@ START_PARAMETRIZED_TEST (test_hex_translate_to_regex, test_hex_translate_to_rege
     {
         mctest_assert_str_eq (dest_str->str, data->expected_result);
         g_string_free (dest_str, TRUE);
+
+        if (data->expected_literal == NULL)
+            ck_assert_ptr_null (literal);
+        else
+        {
+            ck_assert_ptr_nonnull (literal);
+            ck_assert_uint_eq (literal->len, data->expected_literal_len);
+            ck_assert_int_eq (memcmp (literal->str, data->expected_literal, literal->len), 0);
+            ck_assert_int_eq (has_letters, data->expected_has_letters);
+        }
+
+        if (literal != NULL)
+            g_string_free (literal, TRUE);
     }
     else
+    {
         ck_assert_int_eq (error, data->expected_error);
+        ck_assert_ptr_null (literal);
+    }
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_hex_literal_search_ds") */
+static const struct test_hex_literal_search_ds
+{
+    const char *haystack;
+    gsize haystack_len;
+    const char *pattern;
+    gboolean expected_found;
+    off_t expected_offset;
+    gsize expected_len;
+} test_hex_literal_search_ds[] = {
+    {
+        // 0. bytes around an embedded NUL: raw data is scanned as-is
+        "ab\x00"
+        "cd\xFF",
+        6,
+        "00 63",
+        TRUE,
+        2,
+        2,
+    },
+    {
+        // 1. hit at the very end
+        "ab\x00"
+        "cd\xFF",
+        6,
+        "ff",
+        TRUE,
+        5,
+        1,
+    },
+    {
+        // 2. quoted string form
+        "ab\x00"
+        "cd\xFF",
+        6,
+        "\"cd\"",
+        TRUE,
+        3,
+        2,
+    },
+    {
+        // 3. no hit
+        "ab\x00"
+        "cd\xFF",
+        6,
+        "de ad",
+        FALSE,
+        0,
+        0,
+    },
+    {
+        // 4. false start on the leading byte
+        "aaab",
+        4,
+        "61 61 62",
+        TRUE,
+        1,
+        3,
+    },
+};
+
+/* @Test(dataSource = "test_hex_literal_search_ds") */
+START_PARAMETRIZED_TEST (test_hex_literal_search, test_hex_literal_search_ds)
+{
+    // given
+    mc_search_t *s;
+    gboolean found;
+    gsize found_len = 0;
+
+    s = mc_search_new (data->pattern, NULL);
+    s->search_type = MC_SEARCH_T_HEX;
+
+    // when
+    found = mc_search_run (s, data->haystack, 0, (off_t) data->haystack_len - 1, &found_len);
+
+    // then
+    ck_assert_int_eq (found, data->expected_found);
+    if (data->expected_found)
+    {
+        ck_assert_int_eq ((int) s->normal_offset, (int) data->expected_offset);
+        ck_assert_int_eq ((int) found_len, (int) data->expected_len);
+    }
+
+    mc_search_free (s);
 }
 END_PARAMETRIZED_TEST
 
@@ -179,6 +350,7 @@ main (void)
     // Add new tests here: ***************
     mctest_add_parameterized_test (tc_core, test_hex_translate_to_regex,
                                    test_hex_translate_to_regex_ds);
+    mctest_add_parameterized_test (tc_core, test_hex_literal_search, test_hex_literal_search_ds);
     // ***********************************
 
     return mctest_run_all (tc_core);
@@ -0,0 +1,159 @@
+/*
+   libmc - checks for the literal fast path of the normal search
+
+   Copyright (C) 2011-2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search/normal"
+
+#include "tests/mctest.h"
+
+#include "normal.c"  // for testing static functions
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_normal_literal_search_ds") */
+static const struct test_normal_literal_search_ds
+{
+    const char *haystack;
+    const char *pattern;
+    gboolean case_sensitive;
+    gboolean expected_found;
+    off_t expected_offset;
+    gsize expected_len;
+} test_normal_literal_search_ds[] = {
+    {
+        // 0. simple hit
+        "abcdefgh",
+        "cde",
+        TRUE,
+        TRUE,
+        2,
+        3,
+    },
+    {
+        // 1. no hit
+        "abcdefgh",
+        "xyz",
+        TRUE,
+        FALSE,
+        0,
+        0,
+    },
+    {
+        // 2. case sensitive miss
+        "abCDEfgh",
+        "cde",
+        TRUE,
+        FALSE,
+        0,
+        0,
+    },
+    {
+        // 3. case insensitive hit
+        "abCDEfgh",
+        "cde",
+        FALSE,
+        TRUE,
+        2,
+        3,
+    },
+    {
+        // 4. hit at the very beginning
+        "needle in a haystack",
+        "needle",
+        TRUE,
+        TRUE,
+        0,
+        6,
+    },
+    {
+        // 5. hit at the very end
+        "a haystack with a needle",
+        "needle",
+        TRUE,
+        TRUE,
+        18,
+        6,
+    },
+    {
+        // 6. pattern spans a newline boundary: lines are searched separately
+        "one\ntwo",
+        "ne\ntw",
+        TRUE,
+        FALSE,
+        0,
+        0,
+    },
+    {
+        // 7. hit on the second line
+        "one\ntwo",
+        "two",
+        TRUE,
+        TRUE,
+        4,
+        3,
+    },
+};
+
+/* @Test(dataSource = "test_normal_literal_search_ds") */
+START_PARAMETRIZED_TEST (test_normal_literal_search, test_normal_literal_search_ds)
+{
+    // given
+    mc_search_t *s;
+    gboolean found;
+    gsize found_len = 0;
+
+    s = mc_search_new (data->pattern, NULL);
+    s->search_type = MC_SEARCH_T_NORMAL;
+    s->is_case_sensitive = data->case_sensitive;
+
+    // when
+    found = mc_search_run (s, data->haystack, 0, strlen (data->haystack), &found_len);
+
+    // then
+    ck_assert_int_eq (found, data->expected_found);
+    if (data->expected_found)
+    {
+        ck_assert_int_eq ((int) s->normal_offset, (int) data->expected_offset);
+        ck_assert_int_eq ((int) found_len, (int) data->expected_len);
+    }
+
+    mc_search_free (s);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_normal_literal_search,
+                                   test_normal_literal_search_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,174 @@
+/*
+   libmc - checks for the prefilter literal extraction from regex patterns
+
+   Copyright (C) 2011-2025
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search/regex"
+
+#include "tests/mctest.h"
+
+#include "regex.c"  // for testing static functions
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_regex_extract_prefilter_ds") */
+static const struct test_regex_extract_prefilter_ds
+{
+    const char *pattern;
+    gboolean fold_case;
+    const char *expected_result;  // NULL: no prefilter must be extracted
+} test_regex_extract_prefilter_ds[] = {
+    {
+        // 0. plain literal
+        "timeout",
+        FALSE,
+        "timeout",
+    },
+    {
+        // 1. the longest mandatory run wins
+        "err.*connection",
+        FALSE,
+        "connection",
+    },
+    {
+        // 2. '*' makes the preceding character optional
+        "abc*def",
+        FALSE,
+        "def",
+    },
+    {
+        // 3. '+' keeps the preceding character mandatory
+        "abc+def",
+        FALSE,
+        "abc",
+    },
+    {
+        // 4. alternation: nothing is mandatory
+        "foo|bar",
+        FALSE,
+        NULL,
+    },
+    {
+        // 5. groups may be optional as a whole: give up
+        "a(bcd)?e",
+        FALSE,
+        NULL,
+    },
+    {
+        // 6. character classes are barriers
+        "fatal[0-9]error",
+        FALSE,
+        "fatal",
+    },
+    {
+        // 7. counted repetition drops the preceding character
+        "abcd{2,3}ef",
+        FALSE,
+        "abc",
+    },
+    {
+        // 8. escapes are barriers
+        "foo\\.barbaz",
+        FALSE,
+        "barbaz",
+    },
+    {
+        // 9. too short after the quantifiers cut it down
+        "ab?.*cd?",
+        FALSE,
+        NULL,
+    },
+    {
+        // 10. case insensitive searches get a lowercased literal
+        "TimeOut",
+        TRUE,
+        "timeout",
+    },
+    {
+        // 11. '*' drops the whole preceding multibyte character, not one byte
+        "\xC3\xA9*abc",
+        FALSE,
+        "abc",
+    },
+    {
+        // 12. same for '?' in the middle of a run
+        "def\xC3\xA9?ghi",
+        FALSE,
+        "def",
+    },
+    {
+        // 13. same for counted repetition
+        "\xC3\xA9{2,3}jkl",
+        FALSE,
+        "jkl",
+    },
+    {
+        // 14. a mandatory multibyte character stays in the literal
+        "x\xC3\xA9y.*ab",
+        FALSE,
+        "x\xC3\xA9y",
+    },
+};
+
+/* @Test(dataSource = "test_regex_extract_prefilter_ds") */
+START_PARAMETRIZED_TEST (test_regex_extract_prefilter, test_regex_extract_prefilter_ds)
+{
+    // given
+    GString *pattern;
+    GString *actual_result;
+
+    pattern = g_string_new (data->pattern);
+
+    // when
+    actual_result = mc_search__regex_extract_prefilter (pattern, data->fold_case);
+
+    // then
+    if (data->expected_result == NULL)
+        ck_assert_ptr_eq (actual_result, NULL);
+    else
+    {
+        ck_assert_ptr_ne (actual_result, NULL);
+        mctest_assert_str_eq (actual_result->str, data->expected_result);
+    }
+
+    if (actual_result != NULL)
+        g_string_free (actual_result, TRUE);
+    g_string_free (pattern, TRUE);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_regex_extract_prefilter,
+                                   test_regex_extract_prefilter_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
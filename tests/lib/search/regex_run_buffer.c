@@ -0,0 +1,133 @@
+/*
+   libmc - checks the regex search over a contiguous multi-line buffer
+
+   Copyright (C) 2011-2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search/regex"
+
+#include "tests/mctest.h"
+
+#include "lib/search.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_regex_run_buffer_ds") */
+static const struct test_regex_run_buffer_ds
+{
+    const char *buffer;
+    gsize buffer_len;  // 0 means strlen (buffer)
+    const char *pattern;
+    gboolean expected_found;
+    off_t expected_offset;
+} test_regex_run_buffer_ds[] = {
+    {
+        // 0. hit on the first line
+        "alpha\nbeta",
+        0,
+        "alpha",
+        TRUE,
+        0,
+    },
+    {
+        // 1. hit on the second line: the walker must not stop after line one
+        "alpha\nbeta",
+        0,
+        "beta",
+        TRUE,
+        6,
+    },
+    {
+        // 2. anchored hit on the third line
+        "one\ntwo\nthree",
+        0,
+        "^three$",
+        TRUE,
+        8,
+    },
+    {
+        // 3. metacharacters match within one line only
+        "one\ntwo\nthree",
+        0,
+        "t.o",
+        TRUE,
+        4,
+    },
+    {
+        // 4. no hit at all
+        "alpha\nbeta",
+        0,
+        "gamma",
+        FALSE,
+        0,
+    },
+    {
+        // 5. a NUL byte stops the walk: nothing past it can match
+        "alpha\0beta",
+        10,
+        "beta",
+        FALSE,
+        0,
+    },
+};
+
+/* @Test(dataSource = "test_regex_run_buffer_ds") */
+START_PARAMETRIZED_TEST (test_regex_run_buffer, test_regex_run_buffer_ds)
+{
+    // given
+    mc_search_t *s;
+    gboolean found;
+    gsize buffer_len;
+    gsize found_len = 0;
+
+    buffer_len = data->buffer_len != 0 ? data->buffer_len : strlen (data->buffer);
+
+    s = mc_search_new (data->pattern, NULL);
+    s->search_type = MC_SEARCH_T_REGEX;
+    s->is_case_sensitive = TRUE;
+
+    // when
+    found = mc_search_run (s, data->buffer, 0, buffer_len, &found_len);
+
+    // then
+    ck_assert_int_eq (found, data->expected_found);
+    if (data->expected_found)
+        ck_assert_int_eq ((int) s->normal_offset, (int) data->expected_offset);
+
+    mc_search_free (s);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_regex_run_buffer, test_regex_run_buffer_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
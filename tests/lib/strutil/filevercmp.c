@@ -42,7 +42,8 @@ sign (int n)
 
 /*
  * Return filevercmp (a, a), checking that a similar result is gotten after replacing all '\1's
- * with '\0's and calling filenvercmp with the embedded '\0's.
+ * with '\0's and calling filenvercmp with the embedded '\0's, and also when the suffix
+ * boundaries are precomputed with filevercmp_prefixlen().
  */
 static int
 test_filevercmp (char const *a, char const *b)
@@ -69,6 +70,10 @@ test_filevercmp (char const *a, char const *b)
     nresult = filenvercmp (buffer, alen, buffer + alen, blen);
     ck_assert_int_eq (sign (nresult), sign (result));
 
+    nresult = filenvercmp_prefix (buffer, alen, filevercmp_prefixlen (buffer, alen),
+                                  buffer + alen, blen, filevercmp_prefixlen (buffer + alen, blen));
+    ck_assert_int_eq (sign (nresult), sign (result));
+
     return result;
 }
 
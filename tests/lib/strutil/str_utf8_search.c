@@ -0,0 +1,177 @@
+/*
+   lib/strutil - tests for lib/strutil/strutilutf8.c:str_utf8_search_first
+   and str_utf8_search_last functions
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib/strutil"
+
+#include "tests/mctest.h"
+
+#include "strutilutf8.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("str_utf8_search_test_ds") */
+static const struct str_utf8_search_test_struct
+{
+    const char *text;
+    const char *search;
+    gboolean case_sen;
+    gboolean find_last;
+    int expected_offset;  // byte offset into text; -1 for no match
+} str_utf8_search_test_ds[] = {
+    {
+        // ASCII, case sensitive, first
+        "Makefile.am",
+        "file",
+        TRUE,
+        FALSE,
+        4,
+    },
+    {
+        // ASCII, case sensitive miss
+        "Makefile.am",
+        "File",
+        TRUE,
+        FALSE,
+        -1,
+    },
+    {
+        // ASCII, caseless, first
+        "Makefile.am",
+        "FILE",
+        FALSE,
+        FALSE,
+        4,
+    },
+    {
+        // ASCII, case sensitive, last of several
+        "abcabc",
+        "abc",
+        TRUE,
+        TRUE,
+        3,
+    },
+    {
+        // ASCII, caseless, last of several
+        "AbcaBc",
+        "ABC",
+        FALSE,
+        TRUE,
+        3,
+    },
+    {
+        // ASCII, needle longer than text
+        "ab",
+        "abc",
+        TRUE,
+        FALSE,
+        -1,
+    },
+    {
+        // ASCII, match at the very start
+        "config.h",
+        "conf",
+        TRUE,
+        FALSE,
+        0,
+    },
+    {
+        // non-ASCII, case sensitive, first
+        "\xc3\xa4"
+        "bc \xc3\xa4"
+        "bc",
+        "\xc3\xa4"
+        "bc",
+        TRUE,
+        FALSE,
+        0,
+    },
+    {
+        // non-ASCII, case sensitive, last
+        "\xc3\xa4"
+        "bc \xc3\xa4"
+        "bc",
+        "\xc3\xa4"
+        "bc",
+        TRUE,
+        TRUE,
+        5,
+    },
+    {
+        // non-ASCII, caseless
+        "\xc3\x84"
+        "BC",
+        "\xc3\xa4"
+        "bc",
+        FALSE,
+        FALSE,
+        0,
+    },
+};
+
+/* @Test(dataSource = "str_utf8_search_test_ds") */
+START_PARAMETRIZED_TEST (str_utf8_search_test, str_utf8_search_test_ds)
+{
+    /* given */
+    char *needle;
+    const char *actual_result;
+
+    /* the engine hands needles to the search functions through
+     * str_utf8_create_search_needle (); do the same here */
+    needle = str_utf8_create_search_needle (data->search, data->case_sen);
+
+    /* when */
+    if (data->find_last)
+        actual_result = str_utf8_search_last (data->text, needle, data->case_sen);
+    else
+        actual_result = str_utf8_search_first (data->text, needle, data->case_sen);
+
+    /* then */
+    if (data->expected_offset < 0)
+        ck_assert_ptr_null (actual_result);
+    else
+    {
+        ck_assert_ptr_nonnull (actual_result);
+        ck_assert_int_eq ((int) (actual_result - data->text), data->expected_offset);
+    }
+
+    str_utf8_release_search_needle (needle, data->case_sen);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, str_utf8_search_test, str_utf8_search_test_ds);
+    /* *********************************** */
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
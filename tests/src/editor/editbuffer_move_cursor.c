@@ -0,0 +1,137 @@
+/*
+   src/editor - tests for edit_buffer_move_cursor() function
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include "lib/vfs/vfs.h"  // vfs_path_t
+#include "lib/widget.h"
+
+#include "src/editor/editbuffer.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* long enough to span several editor buffer pages (64 KiB each) */
+#define TEST_SIZE 200000
+#define TEST_LINE_LEN 97
+
+static edit_buffer_t buf;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+test_byte_at (off_t i)
+{
+    return (i % TEST_LINE_LEN == TEST_LINE_LEN - 1) ? '\n' : 'a' + (int) (i % 26);
+}
+
+/* number of newlines in [0; k) of the test pattern */
+static long
+test_lines_below (off_t k)
+{
+    return (long) (k / TEST_LINE_LEN);
+}
+
+static void
+my_setup (void)
+{
+    off_t i;
+
+    edit_buffer_init (&buf, 0);
+
+    for (i = 0; i < TEST_SIZE; i++)
+        edit_buffer_insert (&buf, test_byte_at (i));
+}
+
+static void
+my_teardown (void)
+{
+    edit_buffer_clean (&buf);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_edit_buffer_move_cursor)
+{
+    // given
+    /* targets probe page boundaries in both directions and both extremes */
+    static const off_t targets[] = {
+        0, TEST_SIZE, 1, TEST_SIZE - 1, 65536, 65537, 65535, 131072, 100, 199999, 0, TEST_SIZE,
+    };
+    size_t t;
+    off_t i;
+
+    ck_assert_int_eq ((int) (buf.curs1), TEST_SIZE);
+    ck_assert_int_eq ((int) (buf.curs2), 0);
+
+    for (t = 0; t < G_N_ELEMENTS (targets); t++)
+    {
+        off_t from, to;
+        long lines, expected_lines;
+
+        // when
+        from = buf.curs1;
+        to = targets[t];
+        lines = edit_buffer_move_cursor (&buf, to - from);
+
+        // then
+        expected_lines = test_lines_below (MAX (from, to)) - test_lines_below (MIN (from, to));
+
+        ck_assert_int_eq ((int) (buf.curs1), (int) to);
+        ck_assert_int_eq ((int) (buf.curs2), (int) (TEST_SIZE - to));
+        ck_assert_int_eq ((int) lines, (int) expected_lines);
+    }
+
+    // the buffer content must survive all the moves unchanged
+    for (i = 0; i < TEST_SIZE; i++)
+        if (edit_buffer_get_byte (&buf, i) != test_byte_at (i))
+            ck_abort_msg ("byte %ld was damaged", (long) i);
+
+    // a move beyond the buffer ends stops at the nearest end
+    (void) edit_buffer_move_cursor (&buf, TEST_SIZE * 2);
+    ck_assert_int_eq ((int) (buf.curs1), TEST_SIZE);
+    (void) edit_buffer_move_cursor (&buf, -TEST_SIZE * 2);
+    ck_assert_int_eq ((int) (buf.curs1), 0);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, my_setup, my_teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_edit_buffer_move_cursor);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */